@@ -24,6 +24,7 @@
 #include "z-form.h"
 #include "z-rand.h"
 #include "z-term.h"
+#include "z-pack.h"
 
 /*
  * Include the high-level includes.
@@ -0,0 +1,772 @@
+/* File: bench.c */
+
+/*
+ * Benchmarks for headless games (the "--bench" option)
+ *
+ * A benchmark is a headless game with a fixed seed, a starting depth,
+ * a fixed number of game turns, and a script of commands (a digit walks
+ * that way) which is played over and over in place of the random ones.
+ * Some benchmarks also set up their level (a swarm of monsters, a field
+ * of burning oil, ...) or do something every turn.  The player is kept alive, so
+ * that every run of a benchmark lasts as long, and (with the same seed
+ * and the same build) does the same things.
+ *
+ * A "kernel" benchmark instead times one part of the game (line of
+ * sight, the flow, a projection, ...) over and over on the first level,
+ * and then stops.  Each sample is one timed batch of calls, and the
+ * "turns" of its line are the samples (see "bench_kernels()").
+ *
+ * At the end, one line is appended to "kamband_bench.csv" (and printed)
+ * with the name and seed of the benchmark, the game turns and levels it
+ * ran, how long it took, the turns run a second, the 50th, 90th and
+ * 99th percentile and the worst of the time between two game turns (in
+ * microseconds, so level generation counts), the peak resident set
+ * size, and a checksum of where the game ended up, which should only
+ * change if the game itself changed.
+ */
+
+#include "angband.h"
+
+
+#include <sys/time.h>
+
+#ifdef SET_UID
+#include <sys/resource.h>
+#endif /* SET_UID */
+
+
+/*
+ * A benchmark
+ */
+typedef struct bench_type bench_type;
+
+struct bench_type
+{
+	cptr name;
+
+	s16b depth;		/* Starting depth */
+	s32b turns;		/* Game turns to run */
+
+	cptr script;		/* Commands, played over and over */
+
+	void (*level)(void);	/* Set up each new level, or NULL */
+	void (*every)(void);	/* Do something every turn, or NULL */
+
+	void (*kernel)(int);	/* Kernel to time (with "arg"), or NULL */
+	int arg;
+};
+
+
+static void bench_regenerate(void);
+static void bench_swarm(void);
+static void bench_oil(void);
+static void bench_maze(void);
+static void bench_wild(void);
+static void bench_churn(void);
+static void bench_k_los(int arg);
+static void bench_k_projectable(int arg);
+static void bench_k_view(int arg);
+static void bench_k_flow(int arg);
+static void bench_k_project(int arg);
+static void bench_k_moves(int arg);
+static void bench_k_cave_gen(int arg);
+
+
+/*
+ * The benchmarks
+ */
+static bench_type bench_info[] =
+{
+	{ "level_gen_1", 1, 2000, ",", NULL, bench_regenerate, NULL, 0 },
+	{ "level_gen_30", 30, 2000, ",", NULL, bench_regenerate, NULL, 0 },
+	{ "level_gen_60", 60, 2000, ",", NULL, bench_regenerate, NULL, 0 },
+	{ "level_gen_99", 99, 2000, ",", NULL, bench_regenerate, NULL, 0 },
+	{ "swarm", 30, 5000, ",,,,s", bench_swarm, NULL, NULL, 0 },
+	{ "oil_field", 10, 5000, ",,,,s", bench_oil, NULL, NULL, 0 },
+	{ "shifting_maze", 10, 10000, "12346789", bench_maze, NULL, NULL, 0 },
+	{ "wilderness_walk", 0, 20000, "6666666669333333666666663", NULL, bench_wild, NULL, 0 },
+	{ "level_churn", 20, 5000, "12346789", NULL, bench_churn, NULL, 0 },
+	{ "kern_los", 30, 2000, ",", NULL, NULL, bench_k_los, 0 },
+	{ "kern_projectable", 30, 2000, ",", NULL, NULL, bench_k_projectable, 0 },
+	{ "kern_view", 30, 2000, ",", NULL, NULL, bench_k_view, 0 },
+	{ "kern_flow", 30, 2000, ",", NULL, NULL, bench_k_flow, 0 },
+	{ "kern_project_r1", 30, 2000, ",", NULL, NULL, bench_k_project, 1 },
+	{ "kern_project_r3", 30, 2000, ",", NULL, NULL, bench_k_project, 3 },
+	{ "kern_project_r6", 30, 2000, ",", NULL, NULL, bench_k_project, 6 },
+	{ "kern_moves", 30, 2000, ",", NULL, NULL, bench_k_moves, 0 },
+	{ "kern_cave_gen", 30, 20, ",", NULL, NULL, bench_k_cave_gen, 0 },
+	{ NULL, 0, 0, NULL, NULL, NULL, NULL, 0 }
+};
+
+
+/*
+ * The benchmark being run
+ */
+static bench_type *bench_ptr = NULL;
+
+/*
+ * The next command of the script, and the game turn of the last one
+ */
+static cptr bench_next;
+static s32b bench_cmd_turn = -1;
+
+/*
+ * When the benchmark started, and when the last game turn ended
+ */
+static struct timeval bench_began;
+static struct timeval bench_last;
+
+/*
+ * The time between each game turn and the one before it
+ */
+static u32b *bench_lat = NULL;
+static s32b bench_lat_n = 0;
+static s32b bench_lat_max = 0;
+
+/*
+ * Levels started
+ */
+static s32b bench_levels = 0;
+
+/*
+ * Something to keep of what the kernels found (for the check)
+ */
+static u32b bench_kernel_sum = 0;
+
+
+/*
+ * Microseconds from "a" to "b"
+ */
+static u32b bench_usec(struct timeval *a, struct timeval *b)
+{
+	return ((u32b)(b->tv_sec - a->tv_sec) * 1000000UL +
+	        (u32b)(b->tv_usec - a->tv_usec));
+}
+
+
+/*
+ * Make a new level at the same depth, every few turns
+ */
+static void bench_regenerate(void)
+{
+	if (turn % 20) return;
+
+	p_ptr->leaving = TRUE;
+}
+
+
+/*
+ * Fill the level with awake monsters
+ */
+static void bench_swarm(void)
+{
+	int i;
+
+	/* Only the first level */
+	if (bench_levels > 1) return;
+
+	for (i = 0; (i < 20000) && (m_cnt < BENCH_SWARM); i++)
+	{
+		(void)alloc_monster(0, FALSE);
+	}
+}
+
+
+/*
+ * Cover the floor around the player with oil, and set fire to it
+ */
+static void bench_oil(void)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+	int y, x;
+
+	for (y = py - BENCH_OIL_RAD; y <= py + BENCH_OIL_RAD; y++)
+	{
+		for (x = px - 2 * BENCH_OIL_RAD; x <= px + 2 * BENCH_OIL_RAD; x++)
+		{
+			if (!in_bounds(y, x)) continue;
+			if (cave_feat[y][x] != FEAT_FLOOR) continue;
+
+			/* Leave room to stand */
+			if (distance(y, x, py, px) < 3) continue;
+
+			cave_set_feat(y, x, FEAT_OIL);
+		}
+	}
+
+	/* Light it at the edges */
+	for (x = px - 2 * BENCH_OIL_RAD; x <= px + 2 * BENCH_OIL_RAD; x += 4)
+	{
+		for (y = py - BENCH_OIL_RAD; y <= py + BENCH_OIL_RAD; y += 2 * BENCH_OIL_RAD)
+		{
+			if (!in_bounds(y, x)) continue;
+			if (cave_feat[y][x] != FEAT_OIL) continue;
+
+			cave_set_feat(y, x, FEAT_OIL_BURNING);
+			cave[y][x].fuel = 20;
+		}
+	}
+}
+
+
+/*
+ * Scatter shifting walls over the floor around the player
+ */
+static void bench_maze(void)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+	int y, x;
+
+	for (y = py - BENCH_MAZE_RAD; y <= py + BENCH_MAZE_RAD; y++)
+	{
+		for (x = px - 2 * BENCH_MAZE_RAD; x <= px + 2 * BENCH_MAZE_RAD; x++)
+		{
+			if (!in_bounds_fully(y, x)) continue;
+			if (!cave_naked_bold(y, x)) continue;
+			if ((y == py) && (x == px)) continue;
+
+			/* One grid in three */
+			if ((y + 2 * x) % 3) continue;
+
+			cave_set_feat(y, x, FEAT_WALL_EXTRA);
+			active_wall_add(y, x);
+		}
+	}
+}
+
+
+/*
+ * Every few turns, jump to the east edge of the wilderness, so that the
+ * walk east goes on to the next part of it
+ */
+static void bench_wild(void)
+{
+	if (turn % 100) return;
+
+	if (p_ptr->inside_special != SPECIAL_WILD) return;
+
+	teleport_player_to(p_ptr->py, DUNGEON_WID - 2);
+}
+
+
+/*
+ * Leave the level, and come back to it, every few turns (as if the
+ * player went in and out of a shop)
+ */
+static void bench_churn(void)
+{
+	if (turn % 50) return;
+
+	if (save_dungeon(MAX_DEPTH)) return;
+
+	p_ptr->load_dungeon = MAX_DEPTH + 1;
+	p_ptr->leaving = TRUE;
+}
+
+
+/*
+ * Grids to look between, near the player (see "bench_k_pick()")
+ */
+static s16b bench_gy[BENCH_KERNEL_CALLS][2];
+static s16b bench_gx[BENCH_KERNEL_CALLS][2];
+
+
+/*
+ * Pick pairs of grids within sight range of the player, before a sample
+ * starts, so that the random numbers are not timed
+ */
+static void bench_k_pick(void)
+{
+	int i, j;
+
+	for (i = 0; i < BENCH_KERNEL_CALLS; i++)
+	{
+		for (j = 0; j < 2; j++)
+		{
+			int y = p_ptr->py + rand_spread(0, MAX_SIGHT);
+			int x = p_ptr->px + rand_spread(0, MAX_SIGHT);
+
+			if (!in_bounds(y, x))
+			{
+				y = p_ptr->py;
+				x = p_ptr->px;
+			}
+
+			bench_gy[i][j] = y;
+			bench_gx[i][j] = x;
+		}
+	}
+}
+
+
+/*
+ * Line of sight between the pairs
+ */
+static void bench_k_los(int arg)
+{
+	int i, n = 0;
+
+	(void)arg;
+
+	for (i = 0; i < BENCH_KERNEL_CALLS; i++)
+	{
+		if (los(bench_gy[i][0], bench_gx[i][0], bench_gy[i][1], bench_gx[i][1])) n++;
+	}
+
+	bench_kernel_sum += n;
+}
+
+
+/*
+ * Projection paths between the pairs
+ */
+static void bench_k_projectable(int arg)
+{
+	int i, n = 0;
+
+	(void)arg;
+
+	for (i = 0; i < BENCH_KERNEL_CALLS; i++)
+	{
+		if (projectable(bench_gy[i][0], bench_gx[i][0], bench_gy[i][1], bench_gx[i][1])) n++;
+	}
+
+	bench_kernel_sum += n;
+}
+
+
+/*
+ * The view from where the player stands (as if a nearby wall changed)
+ */
+static void bench_k_view(int arg)
+{
+	(void)arg;
+
+	view_note_change(p_ptr->py, p_ptr->px);
+	update_view();
+
+	bench_kernel_sum += view_n;
+}
+
+
+/*
+ * The flow from where the player stands (as if a nearby grid changed)
+ */
+static void bench_k_flow(int arg)
+{
+	(void)arg;
+
+	/* Whatever the character's options say */
+	flow_by_sound = TRUE;
+
+	flow_invalidate(p_ptr->py, p_ptr->px);
+	update_flow();
+}
+
+
+/*
+ * A harmless ball of radius "arg" at the first grid of each of a few
+ * pairs (it still hits the grids, objects and monsters there)
+ */
+static void bench_k_project(int arg)
+{
+	int i;
+
+	for (i = 0; i < BENCH_KERNEL_CALLS / 100; i++)
+	{
+		if (project(-1, arg, bench_gy[i][0], bench_gx[i][0], 0, GF_MISSILE,
+		            PROJECT_GRID | PROJECT_ITEM | PROJECT_KILL))
+		{
+			bench_kernel_sum++;
+		}
+	}
+}
+
+
+/*
+ * The moves of every monster on the level
+ */
+static void bench_k_moves(int arg)
+{
+	int i, mm[5];
+
+	(void)arg;
+
+	for (i = 1; i < m_max; i++)
+	{
+		if (!m_list[i].r_idx) continue;
+
+		get_moves(i, mm);
+		bench_kernel_sum += mm[0];
+	}
+}
+
+
+/*
+ * A new level at the same depth
+ */
+static void bench_k_cave_gen(int arg)
+{
+	(void)arg;
+
+	generate_cave();
+
+	bench_kernel_sum += m_cnt;
+}
+
+
+/*
+ * Move the player to the nearest empty floor grid
+ */
+static void bench_k_floor(void)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+	int d, y, x;
+
+	if (cave_feat[py][px] == FEAT_FLOOR) return;
+
+	for (d = 1; d < 10; d++)
+	{
+		for (y = py - d; y <= py + d; y++)
+		{
+			for (x = px - d; x <= px + d; x++)
+			{
+				if (!in_bounds(y, x)) continue;
+				if (!cave_naked_bold(y, x)) continue;
+				if (cave_feat[y][x] != FEAT_FLOOR) continue;
+
+				monster_swap(py, px, y, x);
+				return;
+			}
+		}
+	}
+}
+
+
+/*
+ * Open up the level around the player into a flat field of pillars, so that
+ * every kernel sees the same kind of map, with long sight lines and a
+ * flow which fills its whole window
+ */
+static void bench_k_arena(void)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+	int y, x;
+
+	for (y = py - BENCH_ARENA_RAD; y <= py + BENCH_ARENA_RAD; y++)
+	{
+		for (x = px - 2 * BENCH_ARENA_RAD; x <= px + 2 * BENCH_ARENA_RAD; x++)
+		{
+			if (!in_bounds_fully(y, x)) continue;
+
+			/* Level ground */
+			set_elevation(y, x, ELEV_GROUND);
+
+			if (cave_perma_bold(y, x)) continue;
+			if (cave_m_idx[y][x] || cave_o_idx[y][x]) continue;
+
+			/* A pillar every few grids, floor elsewhere */
+			if (!(y % 4) && !(x % 6))
+				cave_set_feat(y, x, FEAT_WALL_EXTRA);
+			else
+				cave_set_feat(y, x, FEAT_FLOOR);
+		}
+	}
+}
+
+
+/*
+ * Time the kernel of the benchmark on the first level, in place of
+ * playing, and stop at the end of the game turn
+ */
+static void bench_kernels(void)
+{
+	struct timeval a, b;
+
+	/* A synthetic map */
+	bench_k_arena();
+
+	/* Step off the stairs (the flow ignores a player on them) */
+	bench_k_floor();
+
+	bench_lat_n = 0;
+
+	while (bench_lat_n < bench_ptr->turns)
+	{
+		bench_k_pick();
+
+		gettimeofday(&a, NULL);
+		(*bench_ptr->kernel)(bench_ptr->arg);
+		gettimeofday(&b, NULL);
+
+		bench_lat[bench_lat_n++] = bench_usec(&a, &b);
+	}
+
+	/* Stop */
+	arg_headless_turns = turn;
+}
+
+
+/*
+ * Sort helper for the percentiles
+ */
+static int bench_cmp(const void *a, const void *b)
+{
+	u32b x = *(const u32b*)a;
+	u32b y = *(const u32b*)b;
+
+	return ((x < y) ? -1 : (x > y) ? 1 : 0);
+}
+
+
+/*
+ * Get a percentile of the (sorted) times
+ */
+static u32b bench_pct(int pct)
+{
+	s32b i;
+
+	if (!bench_lat_n) return (0);
+
+	i = (bench_lat_n * pct + 99) / 100 - 1;
+	if (i < 0) i = 0;
+
+	return (bench_lat[i]);
+}
+
+
+/*
+ * Append the results to "kamband_bench.csv", and print them
+ */
+static void bench_report(void)
+{
+	struct timeval now;
+	u32b usec;
+	long rss = get_current_rss_kb();
+	u32b check = 5381;
+	char buf[1024];
+	FILE *fff;
+	int y, x;
+
+	if (!bench_ptr) return;
+
+	gettimeofday(&now, NULL);
+	usec = bench_usec(&bench_began, &now);
+
+#ifdef SET_UID
+	{
+		struct rusage usage;
+
+		/* The peak, not the current size */
+		if ((getrusage(RUSAGE_SELF, &usage) == 0) && (usage.ru_maxrss > rss))
+		{
+			rss = usage.ru_maxrss;
+		}
+	}
+#endif /* SET_UID */
+
+	/* Where the game ended up */
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		for (x = 0; x < DUNGEON_WID; x++)
+		{
+			check = check * 33 + cave_feat[y][x];
+			check = check * 33 + (byte)(cave_m_idx[y][x] > 0);
+		}
+	}
+
+	check = check * 33 + p_ptr->py;
+	check = check * 33 + p_ptr->px;
+	check = check * 33 + p_ptr->depth;
+	check = check * 33 + m_cnt;
+	if (bench_ptr->kernel) check = check * 33 + bench_kernel_sum;
+
+	qsort(bench_lat, bench_lat_n, sizeof(u32b), bench_cmp);
+
+	sprintf(buf, "%s,%lu,%ld,%ld,%ld.%03ld,%ld,%lu,%lu,%lu,%lu,%ld,%08lx",
+	        bench_ptr->name, (unsigned long)arg_seed, (long)bench_lat_n,
+	        (long)bench_levels, (long)(usec / 1000000UL),
+	        (long)((usec / 1000UL) % 1000UL),
+	        (long)(usec ? ((double)bench_lat_n * 1000000.0 / usec) : 0),
+	        (unsigned long)bench_pct(50), (unsigned long)bench_pct(90),
+	        (unsigned long)bench_pct(99), (unsigned long)bench_pct(100),
+	        rss, (unsigned long)check);
+
+	/* Only once */
+	bench_ptr = NULL;
+
+	printf("%s\n", buf);
+
+	fff = fopen("kamband_bench.csv", "a");
+	if (!fff) return;
+
+	/* A new file needs a header */
+	fseek(fff, 0, SEEK_END);
+	if (ftell(fff) == 0)
+	{
+		fprintf(fff, "scenario,seed,turns,levels,seconds,turns_per_sec,p50_us,p90_us,p99_us,max_us,peak_rss_kb,check\n");
+	}
+
+	fprintf(fff, "%s\n", buf);
+	fclose(fff);
+}
+
+
+/*
+ * Choose the benchmark "name" (before the game starts).
+ *
+ * Return FALSE if there is no such benchmark.
+ */
+bool bench_init(cptr name)
+{
+	bench_type *b_ptr;
+
+	for (b_ptr = bench_info; b_ptr->name; b_ptr++)
+	{
+		if (streq(b_ptr->name, name)) break;
+	}
+
+	if (!b_ptr->name) return (FALSE);
+
+	bench_ptr = b_ptr;
+	bench_next = b_ptr->script;
+
+	/* A headless game, with a fixed seed */
+	arg_headless = TRUE;
+	if (!arg_seed) arg_seed = 1;
+
+	/* The length of the run (the game starts at turn 1) */
+	if (arg_headless_turns <= 0) arg_headless_turns = 1 + b_ptr->turns;
+
+	bench_lat_max = arg_headless_turns;
+	C_MAKE(bench_lat, bench_lat_max, u32b);
+
+	return (TRUE);
+}
+
+
+/*
+ * List the benchmarks
+ */
+void bench_list(void)
+{
+	bench_type *b_ptr;
+
+	for (b_ptr = bench_info; b_ptr->name; b_ptr++)
+	{
+		printf("  %-16s depth %d, %ld turns\n", b_ptr->name,
+		       b_ptr->depth, (long)b_ptr->turns);
+	}
+}
+
+
+/*
+ * The new character is ready -- put it where the benchmark starts
+ */
+void bench_birth(void)
+{
+	if (!bench_ptr) return;
+
+	p_ptr->depth = bench_ptr->depth;
+	if (p_ptr->max_depth < p_ptr->depth) p_ptr->max_depth = p_ptr->depth;
+
+	gettimeofday(&bench_began, NULL);
+	bench_last = bench_began;
+
+	/* Report at the end, however the game ends */
+	atexit(bench_report);
+}
+
+
+/*
+ * A new level is ready
+ */
+void bench_level(void)
+{
+	if (!bench_ptr) return;
+
+	bench_levels++;
+
+	if (bench_ptr->level) (*bench_ptr->level)();
+
+	/* Kernels only run on the first level */
+	if (bench_ptr->kernel && (bench_levels == 1)) bench_kernels();
+}
+
+
+/*
+ * A game turn is over
+ */
+void bench_turn(void)
+{
+	struct timeval now;
+
+	if (!bench_ptr) return;
+
+	gettimeofday(&now, NULL);
+
+	/* Kernels keep their own times */
+	if (!bench_ptr->kernel && (bench_lat_n < bench_lat_max))
+	{
+		bench_lat[bench_lat_n++] = bench_usec(&bench_last, &now);
+	}
+
+	bench_last = now;
+
+	/* Keep the player alive */
+	p_ptr->chp = p_ptr->mhp;
+	p_ptr->chp_frac = 0;
+	if (p_ptr->food < PY_FOOD_ALERT) p_ptr->food = PY_FOOD_FULL - 1;
+
+	if (bench_ptr->every) (*bench_ptr->every)();
+}
+
+
+/*
+ * Play the next command of the script (a digit walks that way), or hold
+ * still if the last one took no time (walked into a wall, say), so that
+ * game time always passes.
+ *
+ * Return FALSE if there is no benchmark.
+ */
+bool bench_command(void)
+{
+	char ch;
+
+	if (!bench_ptr) return (FALSE);
+
+	if (!*bench_next) bench_next = bench_ptr->script;
+
+	ch = *bench_next++;
+
+	/* The last command took no time */
+	if (turn == bench_cmd_turn) ch = ',';
+
+	bench_cmd_turn = turn;
+
+	if (isdigit((unsigned char)ch))
+	{
+		p_ptr->command_cmd = ';';
+		p_ptr->command_dir = D2I(ch);
+	}
+	else
+	{
+		p_ptr->command_cmd = ch;
+		p_ptr->command_dir = 0;
+	}
+
+	return (TRUE);
+}
+
+
+/*
+ * Is a benchmark running?
+ */
+bool bench_running(void)
+{
+	return (bench_ptr != NULL);
+}
@@ -736,6 +736,18 @@ static s32b auto_round;
  */
 static s32b last_round;
 
+/*
+ * When the rolling started, and when the display was last updated
+ */
+static u32b roll_began;
+static u32b roll_drawn;
+
+/*
+ * The stream the rolls are drawn from (seeded from the game's numbers
+ * once, so that a long autoroll draws only one of those)
+ */
+static rand_stream roll_stream;
+
 
 
 /*
@@ -1039,6 +1051,9 @@ static void get_extra(void)
 
 	spell_num = 0;
 
+	/* A new spell list */
+	forget_dynamic_spell_costs();
+
 	/* Initialize spells. */
 	if (cp_ptr->uses_magic && cp_ptr->spell_book != SV_SPELLBOOK_NONE)
 	{
@@ -1620,6 +1635,11 @@ static void player_wipe(void)
 	/* Hack -- no ghosts */
 	r_info[MAX_R_IDX - 1].max_num = 0;
 
+	/* Every unique is legal again */
+	mon_alloc_epoch++;
+
+	/* Nothing is scheduled */
+	event_wipe();
 }
 
 
@@ -1847,9 +1867,9 @@ s16b select_town_layout(bool arenap)
 /*
  * Helper function for 'player_birth()'
  *
- * The delay may be reduced, but is recommended to keep players
- * from continuously rolling up characters, which can be VERY
- * expensive CPU wise.  And it cuts down on player stupidity.
+ * The auto-roller rolls as fast as it can, and only updates the display
+ * (and looks for a key) every AUTOROLL_MSEC, so that the rolls are not
+ * held up by the drawing.
  */
 static bool player_birth_aux()
 {
@@ -1857,7 +1877,6 @@ static bool player_birth_aux()
 
 	int mode = 0;
 
-	bool flag = FALSE;
 	bool prev = FALSE;
 
 	cptr str;
@@ -2221,6 +2240,13 @@ static bool player_birth_aux()
 
 			/* Label count */
 			put_str("Round:", 9, 61);
+			put_str("Rate :", 10, 61);
+
+			/* Note the time */
+			roll_began = roll_drawn = msec_clock();
+
+			/* Seed the rolls */
+			Rand_stream_seed(&roll_stream, (u32b)rand_int(0x7FFFFFFFL));
 		}
 
 		/* Otherwise just get a character */
@@ -2234,9 +2260,12 @@ static bool player_birth_aux()
 		while (autoroll)
 		{
 			bool accept = TRUE;
+			u32b now;
 
 			/* Get a new character */
+			Rand_stream = &roll_stream;
 			get_stats();
+			Rand_stream = NULL;
 
 			/* Advance the round */
 			auto_round++;
@@ -2265,25 +2294,25 @@ static bool player_birth_aux()
 			if (accept)
 				break;
 
-			/* Take note every 25 rolls */
-			flag = (!(auto_round % 25L));
-
 			/* Update display occasionally */
-			if (flag || (auto_round < last_round + 100))
+			now = msec_clock();
+			if (now - roll_drawn >= AUTOROLL_MSEC)
 			{
+				roll_drawn = now;
+
 				/* Dump data */
 				birth_put_stats();
 
 				/* Dump round */
 				put_str(format("%6ld", auto_round), 9, 73);
 
+				/* Dump rolls per second */
+				put_str(format("%6ld/s", (long)((auto_round - last_round) *
+					1000.0 / (now - roll_began))), 10, 71);
+
 				/* Make sure they see everything */
 				Term_fresh();
 
-				/* Delay 1/10 second */
-				if (flag)
-					Term_xtra(TERM_XTRA_DELAY, 100);
-
 				/* Do not wait for a key */
 				inkey_scan = TRUE;
 
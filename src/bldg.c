@@ -1444,7 +1444,6 @@ static void race_legends(void)
 static void mass_rest(void)
 {
 	int dawnval;
-	int n;
 
 	dawnval = ((turn % (10L * TOWN_DAWN)));
 
@@ -1462,7 +1461,13 @@ static void mass_rest(void)
 		}
 		else
 		{
+			s32b old_turn = turn;
+
 			turn = ((turn / 50000) + 1) * 50000;
+
+			/* Recall and the like wait for the player to wake */
+			event_skip(old_turn);
+
 			p_ptr->chp = p_ptr->mhp;
 			set_blind(0);
 			set_confused(0);
@@ -1470,12 +1475,8 @@ static void mass_rest(void)
 			mprint(MSG_TEMP, "You awake refreshed for the new day.");
 			msg_print(NULL);
 
-			/* Maintain each shop (except home) */
-			for (n = 0; n < MAX_STORES - 1; n++)
-			{
-				/* Maintain */
-				store_maint(n);
-			}
+			/* Maintain each shop (except home) when next entered */
+			store_maint_owe();
 
 			/* Select new bounties. */
 			select_bounties();
@@ -2357,6 +2358,8 @@ void do_cmd_bldg(void)
 		return;
 	}
 
+	fuzz_hit(FUZZ_STORE);
+
 	if (which < 7)
 	{
 		bldg_command(which, FALSE);
@@ -2407,6 +2410,8 @@ void do_cmd_quest(void)
 		p_ptr->inside_special = SPECIAL_QUEST;
 		p_ptr->depth = 1;
 
+		fuzz_hit(FUZZ_QUEST);
+
 		p_ptr->leaving = TRUE;
 	}
 }
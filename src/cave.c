@@ -38,6 +38,63 @@ int distance(int y1, int x1, int y2, int x2)
 }
 
 
+/*
+ * The line of sight cache.
+ *
+ * Monsters ask "los()" and "projectable()" the same questions over and
+ * over (every monster, every turn, about the player), so the answers are
+ * remembered until the terrain changes.  Every entry is stamped with the
+ * "terrain_epoch" it was computed under; bumping the epoch forgets every
+ * entry at once.
+ */
+static sight_cache sight_cache_table[SIGHT_CACHE_SIZE];
+
+
+/*
+ * Note that the terrain has changed, forgetting every cached ray
+ */
+void sight_cache_wipe(void)
+{
+	terrain_epoch++;
+
+	/* Hack -- never reuse the "empty" stamp */
+	if (!terrain_epoch) terrain_epoch++;
+}
+
+
+/*
+ * Find the cache entry for the ray from (y1,x1) to (y2,x2), emptying
+ * it first if it holds another ray or stale results.
+ */
+static sight_cache *sight_cache_entry(int y1, int x1, int y2, int x2)
+{
+	sight_cache *c_ptr;
+	u32b h;
+
+	/* Hash the ray */
+	h = ((u32b)y1 * 73856093UL) ^ ((u32b)x1 * 19349663UL) ^
+	    ((u32b)y2 * 83492791UL) ^ ((u32b)x2 * 2654435761UL);
+	h ^= (h >> 16);
+
+	c_ptr = &sight_cache_table[h & (SIGHT_CACHE_SIZE - 1)];
+
+	/* Claim the entry */
+	if ((c_ptr->epoch != terrain_epoch) ||
+	    (c_ptr->y1 != y1) || (c_ptr->x1 != x1) ||
+	    (c_ptr->y2 != y2) || (c_ptr->x2 != x2))
+	{
+		c_ptr->y1 = y1;
+		c_ptr->x1 = x1;
+		c_ptr->y2 = y2;
+		c_ptr->x2 = x2;
+		c_ptr->epoch = terrain_epoch;
+		c_ptr->flags = 0;
+	}
+
+	return (c_ptr);
+}
+
+
 /*
  * A simple, fast, integer-based line-of-sight algorithm.  By Joseph Hall,
  * 4116 Brewster Drive, Raleigh NC 27606.  Email to jnh@ecemwl.ncsu.edu.
@@ -73,7 +130,7 @@ int distance(int y1, int x1, int y2, int x2)
  *
  * Use the "update_view()" function to determine player line-of-sight.
  */
-bool los(int y1, int x1, int y2, int x2)
+static bool los_aux(int y1, int x1, int y2, int x2)
 {
 	/* Delta */
 	int dx, dy;
@@ -318,6 +375,142 @@ bool is_safe_teleport_dest(int y, int x)
 	return TRUE;
 }
 
+
+/*
+ * The number of floor grids in each block (BLOCK_HGT by BLOCK_WID) of
+ * the map, so that "pick_floor_grid()" can pass over solid rock
+ */
+static s16b floor_block_n[MON_BUCKET_ROWS][MON_BUCKET_COLS];
+
+
+/*
+ * Count the floor grids of every block
+ */
+static void build_floor_blocks(void)
+{
+	int y, x;
+
+	(void)C_WIPE(&floor_block_n[0][0], MON_BUCKET_ROWS * MON_BUCKET_COLS, s16b);
+
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		for (x = 0; x < DUNGEON_WID; x++)
+		{
+			if (cave_floor_bold(y, x))
+				floor_block_n[y / BLOCK_HGT][x / BLOCK_WID]++;
+		}
+	}
+}
+
+
+/*
+ * The grid "y,x" may have become (or stopped being) a floor grid
+ */
+void floor_note_change(int y, int x, bool was_floor)
+{
+	bool is_floor = cave_floor_bold(y, x);
+
+	if (is_floor == was_floor) return;
+
+	floor_block_n[y / BLOCK_HGT][x / BLOCK_WID] += (is_floor ? 1 : -1);
+}
+
+
+/*
+ * Look at the floor grids between "min" and "max" grids from "cy,cx"
+ * which "okay()" accepts, and return the "n"th of them (counting from
+ * zero), or the number of them if there are not so many.
+ */
+static int floor_grid_scan(int cy, int cx, int min, int max,
+	bool (*okay)(int y, int x), int n, int *yp, int *xp)
+{
+	int by, bx, by1, bx1, by2, bx2;
+	int count = 0;
+
+	by1 = MAX(cy - max, 1) / BLOCK_HGT;
+	bx1 = MAX(cx - max, 1) / BLOCK_WID;
+	by2 = MIN(cy + max, DUNGEON_HGT - 2) / BLOCK_HGT;
+	bx2 = MIN(cx + max, DUNGEON_WID - 2) / BLOCK_WID;
+
+	for (by = by1; by <= by2; by++)
+	{
+		for (bx = bx1; bx <= bx2; bx++)
+		{
+			int y1 = by * BLOCK_HGT, y2 = y1 + BLOCK_HGT - 1;
+			int x1 = bx * BLOCK_WID, x2 = x1 + BLOCK_WID - 1;
+			int y, x;
+
+			/* Solid rock */
+			if (!floor_block_n[by][bx]) continue;
+
+			/* The whole block is too far away */
+			if (distance(cy, cx, MAX(y1, MIN(cy, y2)),
+			             MAX(x1, MIN(cx, x2))) > max)
+				continue;
+
+			/* The whole block is too close */
+			if (distance(cy, cx, (cy - y1 > y2 - cy) ? y1 : y2,
+			             (cx - x1 > x2 - cx) ? x1 : x2) < min)
+				continue;
+
+			y1 = MAX(y1, 1);
+			x1 = MAX(x1, 1);
+			y2 = MIN(y2, DUNGEON_HGT - 2);
+			x2 = MIN(x2, DUNGEON_WID - 2);
+
+			for (y = y1; y <= y2; y++)
+			{
+				for (x = x1; x <= x2; x++)
+				{
+					int d;
+
+					if (!cave_floor_bold(y, x)) continue;
+
+					d = distance(cy, cx, y, x);
+					if ((d < min) || (d > max)) continue;
+
+					if (!(*okay)(y, x)) continue;
+
+					/* Found it */
+					if (count == n)
+					{
+						(*yp) = y;
+						(*xp) = x;
+					}
+
+					count++;
+				}
+			}
+		}
+	}
+
+	return (count);
+}
+
+
+/*
+ * Pick one of the floor grids between "min" and "max" grids from "cy,cx"
+ * which "okay()" accepts, each as likely as the others.
+ *
+ * This is what picking random grids until one is accepted would give,
+ * without the endless tries when there are few such grids (or none).
+ *
+ * Returns FALSE if there are none.
+ */
+bool pick_floor_grid(int cy, int cx, int min, int max,
+	bool (*okay)(int y, int x), int *yp, int *xp)
+{
+	int n = floor_grid_scan(cy, cx, min, max, okay, -1, yp, xp);
+
+	/* Nowhere */
+	if (!n) return (FALSE);
+
+	/* Pick one */
+	(void)floor_grid_scan(cy, cx, min, max, okay, rand_int(n), yp, xp);
+
+	return (TRUE);
+}
+
 /*
  * Can the player "see" the given grid?
  *
@@ -474,6 +667,25 @@ bool cave_valid_bold(int y, int x)
 
 
 
+/*
+ * The state of the generator used for hallucinations and multi-hued
+ * monsters.  These are only drawn when the grid is on screen (and there
+ * is a screen), so they must not draw on the game's random numbers, or
+ * the size of the terminal (or "--fast") would change how a game goes.
+ */
+static u32b image_seed = 1L;
+
+/*
+ * A random number from 0 to "m" - 1, for the display only
+ */
+static int image_rand(int m)
+{
+	image_seed = image_seed * 1103515245L + 12345L;
+
+	return ((int)((image_seed >> 16) % m));
+}
+
+
 /*
  * Hack -- Legal monster codes
  */
@@ -488,10 +700,10 @@ static void image_monster(byte * ap, char *cp)
 	int n = strlen(image_monster_hack);
 
 	/* Random symbol from set above */
-	(*cp) = (image_monster_hack[rand_int(n)]);
+	(*cp) = (image_monster_hack[image_rand(n)]);
 
 	/* Random color */
-	(*ap) = randint(15);
+	(*ap) = 1 + image_rand(15);
 }
 
 
@@ -508,10 +720,10 @@ static void image_object(byte * ap, char *cp)
 	int n = strlen(image_object_hack);
 
 	/* Random symbol from set above */
-	(*cp) = (image_object_hack[rand_int(n)]);
+	(*cp) = (image_object_hack[image_rand(n)]);
 
 	/* Random color */
-	(*ap) = randint(15);
+	(*ap) = 1 + image_rand(15);
 }
 
 
@@ -521,7 +733,7 @@ static void image_object(byte * ap, char *cp)
 static void image_random(byte * ap, char *cp)
 {
 	/* Normally, assume monsters */
-	if (rand_int(100) < 75)
+	if (image_rand(100) < 75)
 	{
 		image_monster(ap, cp);
 	}
@@ -540,7 +752,7 @@ static void image_random(byte * ap, char *cp)
  */
 void get_guard_display(int m_idx, byte *ap, char *cp)
 {
-    monster_guard_data *guard = m_guard[m_idx];
+    monster_guard_data *guard = get_guard_data(m_idx);
 
     if (guard == NULL) return;
 
@@ -560,129 +772,87 @@ void get_guard_display(int m_idx, byte *ap, char *cp)
 }
 
 /*
- * Extract the attr/char to display at the given (legal) map location
- *
- * Basically, we "paint" the chosen attr/char in several passes, starting
- * with any known "terrain features" (defaulting to darkness), then adding
- * any known "objects", then adding any known "monsters", and then adding
- * the player if needed.  This is not the fastest method but since most of
- * the calls to this function are made for grids with no objects, monsters,
- * or players, it should be fast enough.
- *
- * Note that the "zero" entry in the feature/object/monster arrays are
- * used to provide "special" attr/char codes, with "monster zero" being
- * used for the player attr/char, "object zero" being used for the "stack"
- * attr/char, and "feature zero" being used for the "nothing" attr/char,
- * though this function makes use of only "feature zero".  XXX XXX XXX
- *
- * Note that monsters can have some "special" flags, including "ATTR_MULTI",
- * which means their color changes, and "ATTR_CLEAR", which means they take
- * the color of whatever is under them, and "CHAR_CLEAR", which means that
- * they take the symbol of whatever is under them.  Technically, the flag
- * "CHAR_MULTI" is supposed to indicate that a monster looks strange when
- * examined, but this flag is currently ignored.  All of these flags are
- * ignored if the "avoid_other" option is set, since checking for these
- * conditions is expensive and annoying on some systems.
+ * Memory of the terrain part of "map_info()" for each grid.
  *
- * Currently, we do nothing with multi-hued objects, because there are
- * not any.  If there were, they would have to set "shimmer_objects"
- * when they were created, and then new "shimmer" code in "dungeon.c"
- * would have to be created handle the "shimmer" effect, and the code
- * in "cave.c" would have to be updated to create the shimmer effect.
- *
- * Note the effects of hallucination.  Objects always appear as random
- * "objects", monsters as random "monsters", and normal grids occasionally
- * appear as random "monsters" or "objects", but note that these random
- * "monsters" and "objects" are really just "colored ascii symbols".
- *
- * Note that "floors" and "invisible traps" (and "zero" features) are
- * drawn as "floors" using a special check for optimization purposes,
- * and these are the only features which get drawn using the special
- * lighting effects activated by "view_special_lite".
- *
- * Note the use of the "mimic" field in the "terrain feature" processing,
- * which allows any feature to "pretend" to be another feature.  This is
- * used to "hide" secret doors, and to make all "doors" appear the same,
- * and all "walls" appear the same, and "hidden" treasure stay hidden.
- * It is possible to use this field to make a feature "look" like a floor,
- * but the "special lighting effects" for floors will not be used.
- *
- * Note the use of the new "terrain feature" information.  Note that the
- * assumption that all interesting "objects" and "terrain features" are
- * memorized allows extremely optimized processing below.  Note the use
- * of separate flags on objects to mark them as memorized allows a grid
- * to have memorized "terrain" without granting knowledge of any object
- * which may appear in that grid.
- *
- * Note the efficient code used to determine if a "floor" grid is
- * "memorized" or "viewable" by the player, where the test for the
- * grid being "viewable" is based on the facts that (1) the grid
- * must be "lit" (torch-lit or perma-lit), (2) the grid must be in
- * line of sight, and (3) the player must not be blind, and uses the
- * assumption that all torch-lit grids are in line of sight.
- *
- * Note that floors (and invisible traps) are the only grids which are
- * not memorized when seen, so only these grids need to check to see if
- * the grid is "viewable" to the player (if it is not memorized).  Since
- * most non-memorized grids are in fact walls, this induces *massive*
- * efficiency, at the cost of *forcing* the memorization of non-floor
- * grids when they are first seen.  Note that "invisible traps" are
- * always treated exactly like "floors", which prevents "cheating".
- *
- * Note the "special lighting effects" which can be activated for floor
- * grids using the "view_special_lite" option (for "white" floor grids),
- * causing certain grids to be displayed using special colors.  If the
- * player is "blind", we will use "dark gray", else if the grid is lit
- * by the torch, and the "view_yellow_lite" option is set, we will use
- * "yellow", else if the grid is "dark", we will use "dark gray", else
- * if the grid is not "viewable", and the "view_bright_lite" option is
- * set, and the we will use "slate" (gray).  We will use "white" for all
- * other cases, in particular, for illuminated viewable floor grids.
- *
- * Note the "special lighting effects" which can be activated for wall
- * grids using the "view_granite_lite" option (for "white" wall grids),
- * causing certain grids to be displayed using special colors.  If the
- * player is "blind", we will use "dark gray", else if the grid is lit
- * by the torch, and the "view_yellow_lite" option is set, we will use
- * "yellow", else if the "view_bright_lite" option is set, and the grid
- * is not "viewable", or is "dark", or is glowing, but not when viewed
- * from the player's current location, we will use "slate" (gray).  We
- * will use "white" for all other cases, in particular, for correctly
- * illuminated viewable wall grids.
- *
- * Note that, when "view_granite_lite" is set, we use an inline version
- * of the "player_can_see_bold()" function to check the "viewability" of
- * grids when the "view_bright_lite" option is set, and we do NOT use
- * any special colors for "dark" wall grids, since this would allow the
- * player to notice the walls of illuminated rooms from a hallway that
- * happened to run beside the room.
- *
- * Note that bizarre things must be done when the "attr" and/or "char"
- * codes have the "high-bit" set, since these values are used to encode
- * various "special" pictures in some versions, and certain situations,
- * such as "multi-hued" or "clear" monsters, cause the attr/char codes
- * to be "scrambled" in various ways.
- *
- * Note that eventually we may use the "&" symbol for embedded treasure,
- * and use the "*" symbol to indicate multiple objects, though this will
- * have to wait for Angband 2.8.2 or later.  Currently, we simply use
- * the attr/char of the first "marked" object in the stack.  If we did
- * use some special symbol, it could be stored in "f_info[0]".
+ * An entry is good while its stamp matches the current epoch and its key
+ * (see "map_terrain_key()") matches the grid.  Everything on top of the
+ * terrain (objects, monsters, the player, hallucination) is always done
+ * afresh, since it changes all the time and is cheap to check.
+ */
+static u32b map_glyph_key[DUNGEON_HGT][DUNGEON_WID];
+static u32b map_glyph_stamp[DUNGEON_HGT][DUNGEON_WID];
+static byte map_glyph_a[DUNGEON_HGT][DUNGEON_WID];
+static char map_glyph_c[DUNGEON_HGT][DUNGEON_WID];
+
+/*
+ * The current epoch
+ */
+static u32b map_glyph_epoch = 1;
+
+
+/*
+ * Forget the remembered terrain of a grid (its elevation or cover changed)
+ */
+void map_info_forget(int y, int x)
+{
+	map_glyph_stamp[y][x] = 0;
+}
+
+
+/*
+ * Forget the remembered terrain of every grid (new level, new visuals)
+ */
+void map_info_forget_all(void)
+{
+	map_glyph_epoch++;
+}
+
+
+/*
+ * Sum up everything, apart from elevation and cover, that decides how
+ * the terrain of a grid looks
+ */
+static u32b map_terrain_key(int y, int x)
+{
+	u16b info = cave_info[y][x];
+	u32b key = cave_feat[y][x];
+
+	if (info & (CAVE_MARK)) key |= (1L << 8);
+	if (info & (CAVE_GLOW)) key |= (1L << 9);
+	if (info & (CAVE_LITE)) key |= (1L << 10);
+	if (info & (CAVE_VIEW)) key |= (1L << 11);
+
+	/* Vision Suppression in Dark Sectors */
+	if ((cave_sector[y][x] == SECTOR_DARK) && !vision_pulse &&
+	    (distance(y, x, p_ptr->py, p_ptr->px) > 1)) key |= (1L << 12);
+
+	if (p_ptr->blind) key |= (1L << 13);
+	if (vision_pulse) key |= (1L << 14);
+	if (view_special_lite) key |= (1L << 15);
+	if (view_granite_lite) key |= (1L << 16);
+	if (view_yellow_lite) key |= (1L << 17);
+	if (view_bright_lite) key |= (1L << 18);
+
+	return (key);
+}
+
+
+/*
+ * Extract the attr/char of the terrain of a grid (see "map_info()").
  *
- * Note the assumption that doing "x_ptr = &x_info[x]" plus a few of
- * "x_ptr->xxx", is quicker than "x_info[x].xxx", if this is incorrect
- * then a whole lot of code should be changed...  XXX XXX XXX
+ * Returns FALSE if the result depends on more than "map_terrain_key()"
+ * and the elevation and cover of the grid, so it must not be remembered.
  */
-void map_info(int y, int x, byte * ap, char *cp)
+static bool map_terrain(int y, int x, byte *ap, char *cp)
 {
 	feature_type *f_ptr;
 
-	object_type *o_ptr;
-
 	int feat;
 
 	byte a;
-	char c;
+
+	/* Assume the look only depends on the key */
+	bool keep = TRUE;
 
 	/* Feature code */
 	feat = cave_feat[y][x];
@@ -856,6 +1026,9 @@ void map_info(int y, int x, byte * ap, char *cp)
 							/* Use "gray" */
 							a = TERM_SLATE;
 						}
+
+						/* This depends on a neighbour */
+						keep = FALSE;
 					}
 				}
 			}
@@ -887,18 +1060,168 @@ void map_info(int y, int x, byte * ap, char *cp)
 		}
 	}
 
-	/* Hack -- rare random hallucination, except on outer dungeon walls */
-	if (p_ptr->image && (!rand_int(256)) &&
-		(cave_feat[y][x] < FEAT_PERM_SOLID))
-	{
-		/* Hallucinate */
-		image_random(ap, cp);
-	}
+	return (keep);
+}
 
 
-	/* Objects */
-	for (o_ptr = cave_o_idx[y][x]; o_ptr != NULL; o_ptr = o_ptr->next)
-	{
+/*
+ * Extract the attr/char to display at the given (legal) map location
+ *
+ * Basically, we "paint" the chosen attr/char in several passes, starting
+ * with any known "terrain features" (defaulting to darkness), then adding
+ * any known "objects", then adding any known "monsters", and then adding
+ * the player if needed.  This is not the fastest method but since most of
+ * the calls to this function are made for grids with no objects, monsters,
+ * or players, it should be fast enough.
+ *
+ * Note that the "zero" entry in the feature/object/monster arrays are
+ * used to provide "special" attr/char codes, with "monster zero" being
+ * used for the player attr/char, "object zero" being used for the "stack"
+ * attr/char, and "feature zero" being used for the "nothing" attr/char,
+ * though this function makes use of only "feature zero".  XXX XXX XXX
+ *
+ * Note that monsters can have some "special" flags, including "ATTR_MULTI",
+ * which means their color changes, and "ATTR_CLEAR", which means they take
+ * the color of whatever is under them, and "CHAR_CLEAR", which means that
+ * they take the symbol of whatever is under them.  Technically, the flag
+ * "CHAR_MULTI" is supposed to indicate that a monster looks strange when
+ * examined, but this flag is currently ignored.  All of these flags are
+ * ignored if the "avoid_other" option is set, since checking for these
+ * conditions is expensive and annoying on some systems.
+ *
+ * Currently, we do nothing with multi-hued objects, because there are
+ * not any.  If there were, they would have to set "shimmer_objects"
+ * when they were created, and then new "shimmer" code in "dungeon.c"
+ * would have to be created handle the "shimmer" effect, and the code
+ * in "cave.c" would have to be updated to create the shimmer effect.
+ *
+ * Note the effects of hallucination.  Objects always appear as random
+ * "objects", monsters as random "monsters", and normal grids occasionally
+ * appear as random "monsters" or "objects", but note that these random
+ * "monsters" and "objects" are really just "colored ascii symbols".
+ *
+ * Note that "floors" and "invisible traps" (and "zero" features) are
+ * drawn as "floors" using a special check for optimization purposes,
+ * and these are the only features which get drawn using the special
+ * lighting effects activated by "view_special_lite".
+ *
+ * Note the use of the "mimic" field in the "terrain feature" processing,
+ * which allows any feature to "pretend" to be another feature.  This is
+ * used to "hide" secret doors, and to make all "doors" appear the same,
+ * and all "walls" appear the same, and "hidden" treasure stay hidden.
+ * It is possible to use this field to make a feature "look" like a floor,
+ * but the "special lighting effects" for floors will not be used.
+ *
+ * Note the use of the new "terrain feature" information.  Note that the
+ * assumption that all interesting "objects" and "terrain features" are
+ * memorized allows extremely optimized processing below.  Note the use
+ * of separate flags on objects to mark them as memorized allows a grid
+ * to have memorized "terrain" without granting knowledge of any object
+ * which may appear in that grid.
+ *
+ * Note the efficient code used to determine if a "floor" grid is
+ * "memorized" or "viewable" by the player, where the test for the
+ * grid being "viewable" is based on the facts that (1) the grid
+ * must be "lit" (torch-lit or perma-lit), (2) the grid must be in
+ * line of sight, and (3) the player must not be blind, and uses the
+ * assumption that all torch-lit grids are in line of sight.
+ *
+ * Note that floors (and invisible traps) are the only grids which are
+ * not memorized when seen, so only these grids need to check to see if
+ * the grid is "viewable" to the player (if it is not memorized).  Since
+ * most non-memorized grids are in fact walls, this induces *massive*
+ * efficiency, at the cost of *forcing* the memorization of non-floor
+ * grids when they are first seen.  Note that "invisible traps" are
+ * always treated exactly like "floors", which prevents "cheating".
+ *
+ * Note the "special lighting effects" which can be activated for floor
+ * grids using the "view_special_lite" option (for "white" floor grids),
+ * causing certain grids to be displayed using special colors.  If the
+ * player is "blind", we will use "dark gray", else if the grid is lit
+ * by the torch, and the "view_yellow_lite" option is set, we will use
+ * "yellow", else if the grid is "dark", we will use "dark gray", else
+ * if the grid is not "viewable", and the "view_bright_lite" option is
+ * set, and the we will use "slate" (gray).  We will use "white" for all
+ * other cases, in particular, for illuminated viewable floor grids.
+ *
+ * Note the "special lighting effects" which can be activated for wall
+ * grids using the "view_granite_lite" option (for "white" wall grids),
+ * causing certain grids to be displayed using special colors.  If the
+ * player is "blind", we will use "dark gray", else if the grid is lit
+ * by the torch, and the "view_yellow_lite" option is set, we will use
+ * "yellow", else if the "view_bright_lite" option is set, and the grid
+ * is not "viewable", or is "dark", or is glowing, but not when viewed
+ * from the player's current location, we will use "slate" (gray).  We
+ * will use "white" for all other cases, in particular, for correctly
+ * illuminated viewable wall grids.
+ *
+ * Note that, when "view_granite_lite" is set, we use an inline version
+ * of the "player_can_see_bold()" function to check the "viewability" of
+ * grids when the "view_bright_lite" option is set, and we do NOT use
+ * any special colors for "dark" wall grids, since this would allow the
+ * player to notice the walls of illuminated rooms from a hallway that
+ * happened to run beside the room.
+ *
+ * Note that bizarre things must be done when the "attr" and/or "char"
+ * codes have the "high-bit" set, since these values are used to encode
+ * various "special" pictures in some versions, and certain situations,
+ * such as "multi-hued" or "clear" monsters, cause the attr/char codes
+ * to be "scrambled" in various ways.
+ *
+ * Note that eventually we may use the "&" symbol for embedded treasure,
+ * and use the "*" symbol to indicate multiple objects, though this will
+ * have to wait for Angband 2.8.2 or later.  Currently, we simply use
+ * the attr/char of the first "marked" object in the stack.  If we did
+ * use some special symbol, it could be stored in "f_info[0]".
+ *
+ * Note the assumption that doing "x_ptr = &x_info[x]" plus a few of
+ * "x_ptr->xxx", is quicker than "x_info[x].xxx", if this is incorrect
+ * then a whole lot of code should be changed...  XXX XXX XXX
+ */
+void map_info(int y, int x, byte * ap, char *cp)
+{
+	object_type *o_ptr;
+
+	byte a;
+	char c;
+
+	u32b key = map_terrain_key(y, x);
+
+	/* Reuse the remembered terrain */
+	if ((map_glyph_stamp[y][x] == map_glyph_epoch) &&
+	    (map_glyph_key[y][x] == key))
+	{
+		(*ap) = map_glyph_a[y][x];
+		(*cp) = map_glyph_c[y][x];
+	}
+
+	/* Work it out, and remember it if possible */
+	else if (map_terrain(y, x, ap, cp))
+	{
+		map_glyph_a[y][x] = (*ap);
+		map_glyph_c[y][x] = (*cp);
+		map_glyph_key[y][x] = key;
+		map_glyph_stamp[y][x] = map_glyph_epoch;
+	}
+
+	/* Not worth remembering */
+	else
+	{
+		map_glyph_stamp[y][x] = 0;
+	}
+
+	/* Hack -- rare random hallucination, except on outer dungeon walls */
+	if (p_ptr->image && (!image_rand(256)) &&
+		(cave_feat[y][x] < FEAT_PERM_SOLID))
+	{
+		/* Hallucinate */
+		image_random(ap, cp);
+	}
+
+
+	/* Objects */
+	for (o_ptr = cave_o_idx[y][x]; o_ptr != NULL; o_ptr = o_ptr->next)
+	{
 
 		/* Memorized objects */
 		if (o_ptr->marked)
@@ -967,7 +1290,7 @@ void map_info(int y, int x, byte * ap, char *cp)
 				(*cp) = c;
 
 				/* Multi-hued attr */
-				(*ap) = randint(15);
+				(*ap) = 1 + image_rand(15);
 			}
 
 			/* Normal monster (not "clear" in any way) */
@@ -1151,6 +1474,48 @@ void print_rel(char c, byte a, int y, int x)
 }
 
 
+/*
+ * Show an attr/char pair over the given map location for the next "life"
+ * refreshes, as a cosmetic glyph which never becomes part of the map
+ * (see "Term_fx()")
+ */
+void print_fx(char c, byte a, int y, int x, int life)
+{
+	unsigned ky, kx;
+
+	/* Location relative to panel */
+	ky = (unsigned) (y - p_ptr->wy);
+	kx = (unsigned) (x - p_ptr->wx);
+
+	/* Verify location */
+	if (ky >= (unsigned) (SCREEN_HGT)) return;
+	if (kx >= (unsigned) (SCREEN_WID)) return;
+
+	/* Show it, if it is in the window */
+	(void)Term_fx(kx + COL_MAP, ky + ROW_MAP, a, c, life);
+}
+
+
+
+
+
+/*
+ * Cache of what "display_map()" shows for each grid, so that flipping
+ * or zooming the map does not call "map_info()" for the whole dungeon
+ * every time.  An entry is good while its stamp matches the current
+ * one.  "note_spot()" and "lite_spot()" forget single grids, while
+ * "prt_map()" and the passing of game time forget everything.
+ */
+static u32b map_cache_gen[DUNGEON_HGT][DUNGEON_WID];
+static byte map_cache_a[DUNGEON_HGT][DUNGEON_WID];
+static char map_cache_c[DUNGEON_HGT][DUNGEON_WID];
+static byte map_cache_p[DUNGEON_HGT][DUNGEON_WID];
+
+/*
+ * The current stamp, and the game turn it belongs to
+ */
+static u32b map_cache_stamp = 1;
+static s32b map_cache_turn = -1;
 
 
 /*
@@ -1197,6 +1562,8 @@ void note_spot(int y, int x)
 {
 	object_type *o_ptr;
 
+	/* Forget the map view of the grid */
+	map_cache_gen[y][x] = 0;
 
 	/* Blind players see nothing */
 	if (p_ptr->blind)
@@ -1304,6 +1671,17 @@ void lite_spot(int y, int x)
 	unsigned ky, kx;
 	unsigned vy, vx;
 
+	/* Forget the map view of the grid */
+	map_cache_gen[y][x] = 0;
+
+	/* Tell the observer (see "observe.c") */
+	if (observe_on)
+		observe_note_spot(y, x);
+
+	/* Nobody is watching (see "--fast") */
+	if (arg_fast)
+		return;
+
 	/* Location relative to panel */
 	ky = (unsigned) (y - p_ptr->wy);
 
@@ -1358,6 +1736,13 @@ void prt_map(void)
 	int vy, vx;
 	int ty, tx;
 
+	/* Forget the whole map view */
+	map_cache_stamp++;
+
+	/* Nobody is watching (see "--fast") */
+	if (arg_fast)
+		return;
+
 	/* Assume screen */
 	ty = ROW_MAP + SCREEN_HGT;
 	tx = COL_MAP + SCREEN_WID;
@@ -1383,6 +1768,74 @@ void prt_map(void)
 }
 
 
+/*
+ * The panel has moved by "dy" rows and "dx" columns: move what the screen
+ * shows of the map along with it, and draw only the rows and columns
+ * which have come into view
+ *
+ * This assumes the screen shows the map as it was (the normal state of
+ * things, since every change to a grid is drawn as it happens), so the
+ * caller must not use it when a redraw of the map is pending.  Returns
+ * FALSE when the whole map must be drawn after all.
+ */
+bool prt_map_scroll(int dy, int dx)
+{
+	byte a;
+	char c;
+
+	int y, x;
+	int vy, vx;
+	int ty, tx;
+
+	/* Nobody is watching, or the map is not on the screen */
+	if (arg_fast || character_icky)
+		return (FALSE);
+
+	/* Nothing to move */
+	if (!dy && !dx)
+		return (TRUE);
+
+	/* Assume screen */
+	ty = ROW_MAP + SCREEN_HGT;
+	tx = COL_MAP + SCREEN_WID;
+
+	/* Take account of reduced windows */
+	if (ty > Term->hgt)
+		ty = Term->hgt;
+	if (tx > Term->wid)
+		tx = Term->wid;
+
+	/* Move the map (this fails if nothing of it stays in view) */
+	if (Term_scroll(COL_MAP, ROW_MAP, tx - COL_MAP, ty - ROW_MAP, -dx, -dy))
+		return (FALSE);
+
+	/* Draw the rows which came into view, and the new columns of the others */
+	for (y = p_ptr->wy, vy = ROW_MAP; vy < ty; vy++, y++)
+	{
+		bool row = (dy > 0) ? (vy >= ty - dy) : (vy < ROW_MAP - dy);
+
+		/* Nothing new in this row */
+		if (!row && !dx)
+			continue;
+
+		for (x = p_ptr->wx, vx = COL_MAP; vx < tx; vx++, x++)
+		{
+			/* Skip the grids which were on the screen already */
+			if (!row && ((dx > 0) ? (vx < tx - dx) : (vx >= COL_MAP - dx)))
+				continue;
+
+			/* Determine what is there */
+			map_info(y, x, &a, &c);
+
+			/* Hack -- Queue it */
+			Term_queue_char(vx, vy, a, c);
+		}
+	}
+
+	return (TRUE);
+}
+
+
 
 
 
@@ -1526,6 +1979,13 @@ void display_map(int scale)
 	view_special_lite = FALSE;
 	view_granite_lite = FALSE;
 
+	/* Forget the whole map view once time has passed */
+	if (map_cache_turn != turn)
+	{
+		map_cache_stamp++;
+		map_cache_turn = turn;
+	}
+
 
 	/* Clear the chars and attributes */
 	for (y = 0; y < map_h; ++y)
@@ -1561,28 +2021,44 @@ void display_map(int scale)
 			x = (i - rect_sx) / (scale / 5);
 			y = (j - rect_sy) / (scale / 5);
 
-			map_info(j, i, &ta, &tc);
-
-			tp = priority(ta, tc);
-
-			/* Hack -- Always show the Travelling Merchant */
-			if (cave_m_idx[j][i] > 0)
+			/* Use the cached view (hallucination changes every time) */
+			if ((map_cache_gen[j][i] == map_cache_stamp) && !p_ptr->image)
+			{
+				ta = map_cache_a[j][i];
+				tc = map_cache_c[j][i];
+				tp = map_cache_p[j][i];
+			}
+			else
 			{
-				monster_type *m_ptr = &m_list[cave_m_idx[j][i]];
+				map_info(j, i, &ta, &tc);
 
-				if (m_ptr->r_idx == R_IDX_MERCHANT)
+				tp = priority(ta, tc);
+
+				/* Hack -- Always show the Travelling Merchant */
+				if (cave_m_idx[j][i] > 0)
 				{
-					monster_race *r_ptr = &r_info[m_ptr->r_idx];
+					monster_type *m_ptr = &m_list[cave_m_idx[j][i]];
+
+					if (m_ptr->r_idx == R_IDX_MERCHANT)
+					{
+						monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
-					/* Use char */
-					tc = r_ptr->x_char;
+						/* Use char */
+						tc = r_ptr->x_char;
 
-					/* Use attr */
-					ta = r_ptr->x_attr;
+						/* Use attr */
+						ta = r_ptr->x_attr;
 
-					/* High priority */
-					tp = 30;
+						/* High priority */
+						tp = 30;
+					}
 				}
+
+				/* Remember it */
+				map_cache_a[j][i] = ta;
+				map_cache_c[j][i] = tc;
+				map_cache_p[j][i] = tp;
+				map_cache_gen[j][i] = map_cache_stamp;
 			}
 
 			if (mp[y][x] < tp)
@@ -1931,30 +2407,100 @@ void forget_lite(void)
 
 static void update_dark_sector_visibility(void);
 
+
 /*
- * Update the "CAVE_LITE" grids, redrawing as needed.
+ * The origin and radius of the current "lite", and the view it was
+ * computed with (see "update_lite()")
  */
-void update_lite(void)
-{
-	int py = p_ptr->py;
-	int px = p_ptr->px;
+static int lite_py = -1;
+static int lite_px = -1;
+static int lite_r = -1;
+static u32b lite_view = 0;
 
-	int r = p_ptr->cur_lite;
+/*
+ * Views computed so far (see "update_view()")
+ */
+static u32b view_count = 0;
 
-	int i, y, x;
+/*
+ * Whether the "view" is stale (see "update_view()")
+ */
+static bool view_dirty;
 
-	/* Limit torch radius in SECTOR_DARK to 1 */
-	if (cave_sector[py][px] == SECTOR_DARK) {
-		if (r > 1) r = 1;
-	}
 
+/*
+ * The grids beyond the "central" ones (above) lit by a light of
+ * radius 3 to 5, as offsets from the player, in the order of a scan
+ * of the maximal box.
+ */
+static s16b lite_tmpl_n[6];
+static s16b lite_tmpl_dy[6][11 * 11];
+static s16b lite_tmpl_dx[6][11 * 11];
+static bool lite_tmpl_init = FALSE;
 
-	/*** Special case ***/
 
-	/* Hack -- Player has no lite */
-	if (r <= 0)
-	{
-		/* Forget the old lite */
+/*
+ * Build the light templates
+ */
+static void lite_tmpl_prepare(void)
+{
+	int r, dy, dx;
+
+	for (r = 3; r <= 5; r++)
+	{
+		int n = 0;
+
+		for (dy = -r; dy <= r; dy++)
+		{
+			for (dx = -r; dx <= r; dx++)
+			{
+				int ay = ABS(dy), ax = ABS(dx);
+
+				/* Skip the "central" grids */
+				if ((ay <= 2) && (ax <= 2))
+					continue;
+
+				/* Hack -- approximate the distance */
+				if (((ay > ax) ? (ay + (ax >> 1)) : (ax + (ay >> 1))) > r)
+					continue;
+
+				lite_tmpl_dy[r][n] = dy;
+				lite_tmpl_dx[r][n] = dx;
+				n++;
+			}
+		}
+
+		lite_tmpl_n[r] = n;
+	}
+
+	lite_tmpl_init = TRUE;
+}
+
+
+/*
+ * Update the "CAVE_LITE" grids, redrawing as needed.
+ */
+void update_lite(void)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+
+	int r = p_ptr->cur_lite;
+
+	int i, y, x;
+
+	/* Limit torch radius in SECTOR_DARK to 1 */
+	if (cave_sector[py][px] == SECTOR_DARK) {
+		if (r > 1) r = 1;
+	}
+
+
+	/*** Special case ***/
+
+	/* Hack -- Player has no lite */
+	if (r <= 0)
+	{
+		/* Forget the old lite */
 		forget_lite();
 
 		/* Draw the player */
@@ -1965,6 +2511,25 @@ void update_lite(void)
 	}
 
 
+	/*** Nothing has changed ***/
+
+	/* Same place, same light, and the same view */
+	if (lite_n && (lite_py == py) && (lite_px == px) && (lite_r == r) &&
+	    !view_dirty && (lite_view == view_count))
+	{
+		/* Apply vision restrictions for SECTOR_DARK */
+		update_dark_sector_visibility();
+
+		return;
+	}
+
+	/* Remember the new lite */
+	lite_py = py;
+	lite_px = px;
+	lite_r = r;
+	lite_view = view_count;
+
+
 	/*** Save the old "lite" grids for later ***/
 
 	/* Clear them all */
@@ -2049,12 +2614,13 @@ void update_lite(void)
 	/* Radius 3+ -- artifact radius */
 	if (r >= 3)
 	{
-		int y1, y2, x1, x2;
-
 		/* Paranoia */
 		if (r > 5)
 			r = 5;
 
+		/* Build the templates */
+		if (!lite_tmpl_init) lite_tmpl_prepare();
+
 		/* South-East of the player */
 		if (cave_floor_bold_los(py + 1, px + 1))
 		{
@@ -2079,53 +2645,20 @@ void update_lite(void)
 			cave_lite_hack(py - 2, px - 2);
 		}
 
-		/* Maximal north */
-		y1 = py - r;
-		if (y1 < 0)
-			y1 = 0;
-
-		/* Maximal south */
-		y2 = py + r;
-		if (y2 > DUNGEON_HGT - 1)
-			y2 = DUNGEON_HGT - 1;
-
-		/* Maximal west */
-		x1 = px - r;
-		if (x1 < 0)
-			x1 = 0;
-
-		/* Maximal east */
-		x2 = px + r;
-		if (x2 > DUNGEON_WID - 1)
-			x2 = DUNGEON_WID - 1;
-
-		/* Scan the maximal box */
-		for (y = y1; y <= y2; y++)
+		/* Scan the grids within the radius */
+		for (i = 0; i < lite_tmpl_n[r]; i++)
 		{
-			for (x = x1; x <= x2; x++)
-			{
-				int d;
-
-				int dy = (py > y) ? (py - y) : (y - py);
-				int dx = (px > x) ? (px - x) : (x - px);
-
-				/* Skip the "central" grids (above) */
-				if ((dy <= 2) && (dx <= 2))
-					continue;
+			y = py + lite_tmpl_dy[r][i];
+			x = px + lite_tmpl_dx[r][i];
 
-				/* Hack -- approximate the distance */
-				d = (dy > dx) ? (dy + (dx >> 1)) : (dx + (dy >> 1));
-
-				/* Skip distant grids */
-				if (d > r)
-					continue;
+			if (!in_bounds(y, x))
+				continue;
 
-				/* Viewable grids get "torch lit" */
-				if (cave_info[y][x] & (CAVE_VIEW))
-				{
-					/* This grid is "torch lit" */
-					cave_lite_hack(y, x);
-				}
+			/* Viewable grids get "torch lit" */
+			if (cave_info[y][x] & (CAVE_VIEW))
+			{
+				/* This grid is "torch lit" */
+				cave_lite_hack(y, x);
 			}
 		}
 	}
@@ -2342,6 +2875,16 @@ void update_lite(void)
 
 
 
+/*
+ * The origin and radius of the current "view", and whether any grid
+ * which could affect it has changed since it was computed.
+ */
+static int view_py = -1;
+static int view_px = -1;
+static int view_full = -1;
+static bool view_dirty = TRUE;
+
+
 /*
  * Forget the "CAVE_VIEW" grids, redrawing as needed
  */
@@ -2368,6 +2911,9 @@ void forget_view(void)
 
 	/* None left */
 	view_n = 0;
+
+	/* Recompute the view next time */
+	view_dirty = TRUE;
 }
 
 
@@ -2504,6 +3050,66 @@ static bool update_view_aux(int y, int x, int y1, int x1, int y2, int x2)
 #define DX2 (DUNGEON_WID-1)
 
 
+/*
+ * Precomputed lengths of each "strip" in the octagon used by
+ * "update_view()", for the normal and reduced view radius.
+ *
+ * Entry [r][n] is the maximal distance travelled along strip "n".
+ */
+static byte view_strip_len[2][MAX_SIGHT + 1];
+static bool view_strip_init = FALSE;
+
+
+/*
+ * Fill in the strip length tables
+ */
+static void view_strip_prepare(void)
+{
+	int r, n, z, full, over;
+
+	for (r = 0; r < 2; r++)
+	{
+		/* Reduced view (10/15) or normal view (20/30) */
+		full = (r ? MAX_SIGHT / 2 : MAX_SIGHT);
+		over = (r ? MAX_SIGHT * 3 / 4 : MAX_SIGHT * 3 / 2);
+
+		view_strip_len[r][0] = 0;
+
+		for (n = 1; n <= MAX_SIGHT; n++)
+		{
+			/* Acquire the "bounds" of the maximal circle */
+			z = over - n - n;
+			if (z > full - n)
+				z = full - n;
+			while ((z + n + (n >> 1)) > full)
+				z--;
+
+			view_strip_len[r][n] = (z > 0) ? z : 0;
+		}
+	}
+
+	view_strip_init = TRUE;
+}
+
+
+/*
+ * Note that the grid (y,x) has changed in a way which might affect
+ * the "view" (a wall or door was created or destroyed, or the ground
+ * was raised or lowered).
+ */
+void view_note_change(int y, int x)
+{
+	/* Already stale */
+	if (view_dirty) return;
+
+	/* Ignore grids too far away to matter */
+	if (ABS(y - view_py) > MAX_SIGHT + 1) return;
+	if (ABS(x - view_px) > MAX_SIGHT + 1) return;
+
+	view_dirty = TRUE;
+}
+
+
 /*
  * Update the "CAVE_VIEW" grids, redrawing as needed
  */
@@ -2514,22 +3120,28 @@ static bool update_view_aux(int y, int x, int y1, int x1, int y2, int x2)
 static void update_dark_sector_visibility(void) {
     int py = p_ptr->py;
     int px = p_ptr->px;
+    int i, y, x;
+    dark_sector *ds_ptr;
 
-    /* If the player is in the dark maze, forget all dark maze tiles that are out of sight */
-    if (cave_sector[py][px] == SECTOR_DARK) {
-        for (int y = 0; y < DUNGEON_HGT; y++) {
-            for (int x = 0; x < DUNGEON_WID; x++) {
-                if (cave_sector[y][x] == SECTOR_DARK) {
-                    /* If tile is outside the 3x3 (distance > 1) */
-                    if (distance(py, px, y, x) > 1) {
-                        /* Check if the mark is actually set, so we can clear and redraw */
-                        if (cave_info[y][x] & (CAVE_MARK | CAVE_LITE | CAVE_VIEW)) {
-                            cave_info[y][x] &= ~(CAVE_MARK | CAVE_LITE | CAVE_VIEW); /* Hide from map */
-                            lite_spot(y, x); /* Redraw the spot to hide it immediately */
-                        }
-                    }
-                }
-            }
+    /* Only the dark maze the player is standing in is affected */
+    i = dark_sector_find(py, px);
+    if (i < 0) return;
+
+    ds_ptr = &dark_sectors[i];
+
+    /* Forget all dark maze tiles in this sector that are out of sight */
+    for (y = ds_ptr->y1; y <= ds_ptr->y2; y++) {
+        for (x = ds_ptr->x1; x <= ds_ptr->x2; x++) {
+            /* Skip tiles which are not marked at all */
+            if (!(cave_info[y][x] & (CAVE_MARK | CAVE_LITE | CAVE_VIEW))) continue;
+
+            if (cave_sector[y][x] != SECTOR_DARK) continue;
+
+            /* Skip tiles inside the 3x3 (distance <= 1) */
+            if ((ABS(y - py) <= 1) && (ABS(x - px) <= 1)) continue;
+
+            cave_info[y][x] &= ~(CAVE_MARK | CAVE_LITE | CAVE_VIEW); /* Hide from map */
+            lite_spot(y, x); /* Redraw the spot to hide it immediately */
         }
     }
 }
@@ -2545,9 +3157,14 @@ void update_view(void)
 
 	int full, over;
 
+	byte *strip_len;
+
 
 	/*** Initialize ***/
 
+	/* Build the strip tables */
+	if (!view_strip_init) view_strip_prepare();
+
 	/* Optimize */
 	if (view_reduce_view && !p_ptr->depth)
 	{
@@ -2556,6 +3173,9 @@ void update_view(void)
 
 		/* Octagon factor (15) */
 		over = MAX_SIGHT * 3 / 4;
+
+		/* Strip lengths */
+		strip_len = view_strip_len[1];
 	}
 
 	/* Normal */
@@ -2566,8 +3186,48 @@ void update_view(void)
 
 		/* Octagon factor (30) */
 		over = MAX_SIGHT * 3 / 2;
+
+		/* Strip lengths */
+		strip_len = view_strip_len[0];
+	}
+
+
+	/*** Step -1 -- Nothing has changed ***/
+
+	/* The player has not moved, and no nearby wall has changed */
+	if (!view_dirty && view_n && (view_py == py) && (view_px == px) &&
+	    (view_full == full))
+	{
+		/* Update/Redraw all perma-lit wall grids */
+		for (n = 0; n < view_n; n++)
+		{
+			y = view_y[n];
+			x = view_x[n];
+
+			if ((cave_info[y][x] & (CAVE_GLOW)) &&
+			    !cave_floor_bold_los(y, x))
+			{
+				/* Note */
+				note_spot(y, x);
+
+				/* Redraw */
+				lite_spot(y, x);
+			}
+		}
+
+		/* Apply vision restrictions for SECTOR_DARK */
+		update_dark_sector_visibility();
+
+		return;
 	}
 
+	/* Remember the new view */
+	view_py = py;
+	view_px = px;
+	view_full = full;
+	view_dirty = FALSE;
+	view_count++;
+
 
 	/*** Step 0 -- Begin ***/
 
@@ -2709,11 +3369,7 @@ void update_view(void)
 
 
 		/* Acquire the "bounds" of the maximal circle */
-		z = over - n - n;
-		if (z > full - n)
-			z = full - n;
-		while ((z + n + (n >> 1)) > full)
-			z--;
+		z = strip_len[n];
 
 
 		/* Access the four diagonal grids */
@@ -3042,6 +3698,39 @@ void update_view(void)
 static int flow_n = 0;
 
 
+#ifdef MONSTER_FLOW
+
+/*
+ * The flow queue.  Every grid is queued at most once per flow, and only
+ * grids closer than MONSTER_FLOW_DEPTH steps to the player are queued,
+ * so a plain (non-circular) queue of this size can never overflow.
+ */
+#define FLOW_QUEUE_MAX \
+	((2 * MONSTER_FLOW_DEPTH + 1) * (2 * MONSTER_FLOW_DEPTH + 1))
+
+static s16b flow_queue_y[FLOW_QUEUE_MAX];
+static s16b flow_queue_x[FLOW_QUEUE_MAX];
+static int flow_head = 0;
+static int flow_tail = 0;
+
+/*
+ * Origin of the current flow, and whether it must be recomputed
+ */
+static int flow_py = -1;
+static int flow_px = -1;
+static bool flow_dirty = TRUE;
+
+/*
+ * Bounding box of every grid stamped since the last time-stamp rotation
+ */
+static int flow_y1 = DUNGEON_HGT;
+static int flow_x1 = DUNGEON_WID;
+static int flow_y2 = -1;
+static int flow_x2 = -1;
+
+#endif /* MONSTER_FLOW */
+
+
 /*
  * Hack -- forget the "flow" information
  */
@@ -3050,14 +3739,29 @@ void forget_flow(void)
 
 #ifdef MONSTER_FLOW
 
+	int y, x;
+
+	/* The next update must start from scratch */
+	flow_dirty = TRUE;
 
 	/* Nothing to forget */
 	if (!flow_n)
 		return;
 
-	/* Check the entire dungeon */
-	memset(cave_cost, 0, sizeof(cave_cost));
-	memset(cave_when, 0, sizeof(cave_when));
+	/* Check every grid which has been stamped */
+	for (y = flow_y1; y <= flow_y2; y++)
+	{
+		for (x = flow_x1; x <= flow_x2; x++)
+		{
+			cave_flow[y][x].cost = 0;
+			cave_flow[y][x].when = 0;
+		}
+	}
+
+	/* Nothing is stamped */
+	flow_y1 = DUNGEON_HGT;
+	flow_x1 = DUNGEON_WID;
+	flow_y2 = flow_x2 = -1;
 
 	/* Start over */
 	flow_n = 0;
@@ -3067,25 +3771,46 @@ void forget_flow(void)
 }
 
 
-#ifdef MONSTER_FLOW
-
 /*
- * Hack -- Allow us to treat the "seen" array as a queue
+ * Note that a grid which may affect the flow has changed.
+ *
+ * Only grids the last flow could have reached (or bordered) matter,
+ * so edits far from the player do not force a new flow.
  */
-static int flow_head = 0;
-static int flow_tail = 0;
+void flow_invalidate(int y, int x)
+{
+	/* The shared flow fields may cover this grid too */
+	flow_fields_note_change(y, x);
+
+	/* And it may be a way across the side of a sector */
+	sector_note_change(y, x);
+
+#ifdef MONSTER_FLOW
+
+	/* Already dirty */
+	if (flow_dirty) return;
+
+	/* Too far away to matter */
+	if (ABS(y - flow_py) > MONSTER_FLOW_DEPTH + 1) return;
+	if (ABS(x - flow_px) > MONSTER_FLOW_DEPTH + 1) return;
+
+	/* Recompute on the next update */
+	flow_dirty = TRUE;
+
+#endif
+
+}
 
 
+#ifdef MONSTER_FLOW
+
 /*
  * Take note of a reachable grid.  Assume grid is legal.
  */
 static void update_flow_aux(int y, int x, int n)
 {
-	int old_head = flow_head;
-
-
 	/* Ignore "pre-stamped" entries */
-	if (cave_when[y][x] == flow_n)
+	if (cave_flow[y][x].when == flow_n)
 		return;
 
 	/* Ignore "walls" and "rubble" */
@@ -3093,31 +3818,42 @@ static void update_flow_aux(int y, int x, int n)
 		return;
 
 	/* Save the time-stamp */
-	cave_when[y][x] = flow_n;
+	cave_flow[y][x].when = flow_n;
 
 	/* Save the flow cost */
-	cave_cost[y][x] = n;
+	cave_flow[y][x].cost = n;
 
 	/* Hack -- limit flow depth */
 	if (n == MONSTER_FLOW_DEPTH)
 		return;
 
-	/* Enqueue that entry */
-	temp_y[flow_head] = y;
-	temp_x[flow_head] = x;
-
-	/* Advance the queue */
-	if (++flow_head == TEMP_MAX)
-		flow_head = 0;
+	/* Paranoia -- queue is full */
+	if (flow_head >= FLOW_QUEUE_MAX)
+		return;
 
-	/* Hack -- notice overflow by forgetting new entry */
-	if (flow_head == flow_tail)
-		flow_head = old_head;
+	/* Enqueue that entry */
+	flow_queue_y[flow_head] = y;
+	flow_queue_x[flow_head] = x;
+	flow_head++;
 }
 
 #endif
 
 
+/*
+ * The direction (an index into "ddy_ddd[]") from a grid to the one at
+ * the given offset (plus one), and the direction back
+ */
+static byte elev_dir[3][3] =
+{
+	{ 7, 1, 6 },
+	{ 3, 8, 2 },
+	{ 5, 0, 4 }
+};
+
+static byte elev_back[8] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+
+
 /*
  * Hack -- fill in the "cost" field of every grid that the player
  * can "reach" with the number of steps needed to reach that grid.
@@ -3126,10 +3862,14 @@ static void update_flow_aux(int y, int x, int n)
  * In addition, mark the "when" of the grids that can reach
  * the player with the incremented value of "flow_n".
  *
- * Hack -- use the "seen" array as a "circular queue".
- *
  * We do not need a priority queue because the cost from grid
  * to grid is always "one" and we process them in order.
+ *
+ * The flow only covers grids within MONSTER_FLOW_DEPTH of the player,
+ * so it is only recomputed when the player has moved, or when a grid
+ * inside that window has been changed (see "flow_invalidate()").  The
+ * periodic time-stamp rotation only visits the grids which have been
+ * stamped since the last rotation.
  */
 void update_flow(void)
 {
@@ -3145,21 +3885,21 @@ void update_flow(void)
 	if (!flow_by_sound)
 		return;
 
-	/* Paranoia -- make sure the array is empty */
-	if (temp_n)
+	/* Nothing has changed since the last flow */
+	if (!flow_dirty && flow_n && (py == flow_py) && (px == flow_px))
 		return;
 
 	/* Cycle the old entries (once per 128 updates) */
 	if (flow_n == 255)
 	{
 		/* Rotate the time-stamps */
-		for (y = 0; y < DUNGEON_HGT; y++)
+		for (y = flow_y1; y <= flow_y2; y++)
 		{
-			for (x = 0; x < DUNGEON_WID; x++)
+			for (x = flow_x1; x <= flow_x2; x++)
 			{
 				int w;
-				w = cave_when[y][x];
-				cave_when[y][x] = (w > 128) ? (w - 128) : 0;
+				w = cave_flow[y][x].when;
+				cave_flow[y][x].when = (w > 128) ? (w - 128) : 0;
 			}
 		}
 
@@ -3170,6 +3910,17 @@ void update_flow(void)
 	/* Start a new flow (never use "zero") */
 	flow_n++;
 
+	/* Remember the origin */
+	flow_py = py;
+	flow_px = px;
+	flow_dirty = FALSE;
+
+	/* Grow the stamped region */
+	flow_y1 = MIN(flow_y1, MAX(py - MONSTER_FLOW_DEPTH, 0));
+	flow_x1 = MIN(flow_x1, MAX(px - MONSTER_FLOW_DEPTH, 0));
+	flow_y2 = MAX(flow_y2, MIN(py + MONSTER_FLOW_DEPTH, DUNGEON_HGT - 1));
+	flow_x2 = MAX(flow_x2, MIN(px + MONSTER_FLOW_DEPTH, DUNGEON_WID - 1));
+
 
 	/* Reset the "queue" */
 	flow_head = flow_tail = 0;
@@ -3178,15 +3929,12 @@ void update_flow(void)
 	update_flow_aux(py, px, 0);
 
 	/* Now process the queue */
-	while (flow_head != flow_tail)
+	while (flow_tail < flow_head)
 	{
 		/* Extract the next entry */
-		y = temp_y[flow_tail];
-		x = temp_x[flow_tail];
-
-		/* Forget that entry */
-		if (++flow_tail == TEMP_MAX)
-			flow_tail = 0;
+		y = flow_queue_y[flow_tail];
+		x = flow_queue_x[flow_tail];
+		flow_tail++;
 
 		/* Add the "children" */
 		for (d = 0; d < 8; d++)
@@ -3195,25 +3943,16 @@ void update_flow(void)
 			int nx = x + ddx_ddd[d];
 
 			/* Check elevation: Monster at ny,nx must be able to move to y,x
-			   (downstream) to use this flow */
-			if (!elev_allows_move(ny, nx, y, x, FALSE)) continue;
-
-			/* Pathfinding restriction: Treat steep cliffs as walls (no jumping) */
-			if (get_elevation(ny, nx) > get_elevation(y, x)) {
-				int diff = get_elevation(ny, nx) - get_elevation(y, x);
-				if (diff >= 2) {
-					int feat = cave_feat[y][x];
-					/* Only allow if there is a valid way down */
-					if (feat != FEAT_RAMP && feat != FEAT_STAIRS &&
-						feat != FEAT_LADDER && feat != FEAT_ROPE &&
-						feat != FEAT_JUMP_POINT) {
-						continue;
-					}
-				}
+			   (downstream) to use this flow, without jumping off a steep
+			   cliff (see "elev_pass_grid()") */
+			if (cave_info[ny][nx] & (CAVE_SLOPE))
+			{
+				if (!(cave_info[ny][nx] & (CAVE_PASS))) elev_pass_grid(ny, nx);
+				if (!(cave_flow[ny][nx].pass & (1 << elev_back[d]))) continue;
 			}
 
 			/* Add that child if "legal" */
-			update_flow_aux(ny, nx, cave_cost[y][x] + 1);
+			update_flow_aux(ny, nx, cave_flow[y][x].cost + 1);
 		}
 	}
 
@@ -3336,10 +4075,10 @@ void wiz_lite(void)
 	}
 
 	/* Scan all normal grids */
-	for (y = 1; y < DUNGEON_HGT - 1; y++)
+	for (y = 1; y < cave_hgt - 1; y++)
 	{
 		/* Scan all normal grids */
-		for (x = 1; x < DUNGEON_WID - 1; x++)
+		for (x = 1; x < cave_wid - 1; x++)
 		{
 			/* Process all non-walls */
 			if (cave_feat[y][x] < FEAT_SECRET)
@@ -3379,24 +4118,43 @@ void wiz_lite(void)
 }
 
 
+/*
+ * Set "flags" in the "cave_info" of every grid of the level.
+ *
+ * The map is one block, so this is a single pass over its rows in use,
+ * with none of the row and column arithmetic of a grid by grid loop.
+ */
+void cave_info_set_all(u16b flags)
+{
+	u16b *info = &cave_info[0][0];
+	u16b *stop = info + cave_hgt * DUNGEON_WID;
+
+	while (info < stop) *info++ |= flags;
+}
+
+
+/*
+ * Clear "flags" in the "cave_info" of every grid (see above).
+ */
+void cave_info_clear_all(u16b flags)
+{
+	u16b *info = &cave_info[0][0];
+	u16b *stop = info + cave_hgt * DUNGEON_WID;
+	u16b mask = (u16b)~flags;
+
+	while (info < stop) *info++ &= mask;
+}
+
+
 /*
  * Forget the dungeon map (ala "Thinking of Maud...").
  */
 void wiz_dark(void)
 {
-	int y, x;
-
 	object_type *o_ptr;
 
 	/* Forget every grid */
-	for (y = 0; y < DUNGEON_HGT; y++)
-	{
-		for (x = 0; x < DUNGEON_WID; x++)
-		{
-			/* Process the grid */
-			cave_info[y][x] &= ~(CAVE_MARK);
-		}
-	}
+	cave_info_clear_all(CAVE_MARK);
 
 	/* Forget all objects */
 	for (o_ptr = o_list; o_ptr != NULL; o_ptr = o_ptr->next_global)
@@ -3437,55 +4195,601 @@ void wiz_dark(void)
 /*
  * Change the "feat" flag for a grid, and notice/redraw the grid
  */
-void cave_set_feat(int y, int x, int feat)
+/*
+ * Does a grid of feature "feat" give off light?
+ */
+static bool feat_gives_light(int feat)
 {
-	/* Change the feature */
-	cave_feat[y][x] = feat;
-
-	/* Notice */
-	note_spot(y, x);
-
-	/* Redraw */
-	lite_spot(y, x);
+	return ((feat == FEAT_OIL_BURNING) || (feat == FEAT_SHAL_LAVA) ||
+	        (feat == FEAT_DEEP_LAVA));
 }
 
 
-
 /*
- * Calculate "incremental motion". Used by project() and shoot().
- * Assumes that (*y,*x) lies on the path from (y1,x1) to (y2,x2).
+ * Add ("d" is 1) or take away ("d" is -1) the light of a burning grid
+ * at (y, x), which lights the grids next to it.
+ *
+ * The light field "cave_light[][]" counts the burning grids lighting
+ * each grid.  A grid which becomes lit that way is marked "CAVE_GLOW"
+ * (and "CAVE_SHINE", so that only that glow goes away with the light),
+ * so the rest of the game sees it as any other lit grid.
  */
-void mmove2(int *y, int *x, int y1, int x1, int y2, int x2)
+static void light_source(int y, int x, int d)
 {
-	int dy, dx, dist, shift;
+	int yy, xx;
 
-	/* Extract the distance travelled */
-	dy = (*y < y1) ? y1 - *y : *y - y1;
-	dx = (*x < x1) ? x1 - *x : *x - x1;
+	for (yy = y - 1; yy <= y + 1; yy++)
+	{
+		for (xx = x - 1; xx <= x + 1; xx++)
+		{
+			int old;
 
-	/* Number of steps */
-	dist = (dy > dx) ? dy : dx;
+			if (!in_bounds(yy, xx)) continue;
 
-	/* We are calculating the next location */
-	dist++;
+			old = cave_light[yy][xx];
 
+			/* Paranoia */
+			if ((d < 0) && !old) continue;
 
-	/* Calculate the total distance along each axis */
-	dy = (y2 < y1) ? (y1 - y2) : (y2 - y1);
-	dx = (x2 < x1) ? (x1 - x2) : (x2 - x1);
+			cave_light[yy][xx] = old + d;
 
-	/* Paranoia -- Hack -- no motion */
-	if (!dy && !dx)
-		return;
+			/* Lit now */
+			if (!old)
+			{
+				if (cave_info[yy][xx] & (CAVE_GLOW)) continue;
 
+				cave_info[yy][xx] |= (CAVE_GLOW | CAVE_SHINE);
+			}
 
-	/* Move mostly vertically */
-	if (dy > dx)
-	{
+			/* Dark now */
+			else if (!cave_light[yy][xx] && (cave_info[yy][xx] & (CAVE_SHINE)))
+			{
+				cave_info[yy][xx] &= ~(CAVE_GLOW | CAVE_SHINE);
+			}
 
-#if 0
+			/* No change */
+			else continue;
 
-		int k;
+			/* Show the change */
+			if (character_dungeon)
+			{
+				note_spot(yy, xx);
+				lite_spot(yy, xx);
+
+				/* Monsters there may become visible (or not) */
+				if (cave_info[yy][xx] & (CAVE_VIEW)) p_ptr->update |= (PU_MONSTERS);
+			}
+		}
+	}
+}
+
+
+void cave_set_feat(int y, int x, int feat)
+{
+	bool old_floor = cave_floor_bold(y, x);
+	bool old_los = cave_floor_bold_los(y, x);
+	bool old_light = feat_gives_light(cave_feat[y][x]);
+
+	/* Count the traps which monsters must look out for */
+	if (cave_feat[y][x] == FEAT_TRAP_MAGNETISM) magnet_trap_n--;
+	if (cave_feat[y][x] == FEAT_TRAP_GRAVITY) gravity_trap_n--;
+	if (feat == FEAT_TRAP_MAGNETISM) magnet_trap_n++;
+	if (feat == FEAT_TRAP_GRAVITY) gravity_trap_n++;
+
+	/* Change the feature */
+	cave_feat[y][x] = feat;
+
+	/* Count the floor grids */
+	floor_note_change(y, x, old_floor);
+
+	/* The ways on and off this grid may have changed */
+	if (character_dungeon && (cave_info[y][x] & (CAVE_SLOPE)))
+		elev_pass_note(y, x);
+
+	/* Forget cached rays if this grid now blocks differently */
+	if ((cave_floor_bold(y, x) != old_floor) ||
+	    (cave_floor_bold_los(y, x) != old_los))
+	{
+		sight_cache_wipe();
+	}
+
+	/* Burning grids must be visited by process_environment() */
+	if (feat == FEAT_OIL_BURNING) env_active_add(y, x);
+
+	/* Notable grids are listed for targeting */
+	if (feat_notable(feat)) note_grid_add(y, x);
+
+	/* Rolling boulders must be moved by process_boulders() */
+	if ((feat >= FEAT_BOULDER_N) && (feat <= FEAT_BOULDER_W)) boulder_add(y, x);
+
+	/* Burning grids light the grids next to them */
+	if (feat_gives_light(feat) != old_light) light_source(y, x, old_light ? -1 : 1);
+
+	/* The monster flow may have to route around this grid */
+	if (character_dungeon)
+	{
+		flow_invalidate(y, x);
+		view_note_change(y, x);
+	}
+
+	/* A destroyed shifting wall stops moving */
+	if (feat != FEAT_WALL_EXTRA) cave_info[y][x] &= ~(CAVE_ACTIVE);
+
+	/* Notice */
+	note_spot(y, x);
+
+	/* Redraw */
+	lite_spot(y, x);
+}
+
+
+
+/*
+ * Add a grid to the "environment-active" list, if it is not there yet.
+ *
+ * The list holds every grid which process_environment() must visit,
+ * so that the cost of a world tick scales with the number of burning
+ * grids, and not with the area of the map.  Grids are only removed
+ * from the list by process_environment() itself, once they go out.
+ */
+void env_active_add(int y, int x)
+{
+	/* Already listed */
+	if (cave_info[y][x] & (CAVE_ENV)) return;
+
+	/* Paranoia -- list is full */
+	if (env_active_n >= ENV_ACTIVE_MAX) return;
+
+	/* Mark and list the grid */
+	cave_info[y][x] |= (CAVE_ENV);
+	env_active_y[env_active_n] = y;
+	env_active_x[env_active_n] = x;
+	env_active_n++;
+}
+
+
+/*
+ * Is "feat" worth looking at (see "target_set_accept()")?
+ */
+bool feat_notable(int feat)
+{
+	/* Glyphs, doors, stairs, shafts, rubble, and veins with treasure */
+	if ((feat == FEAT_GLYPH) || (feat == FEAT_OPEN) || (feat == FEAT_BROKEN) ||
+	    (feat == FEAT_LESS) || (feat == FEAT_MORE) || (feat == FEAT_SHAFT) ||
+	    (feat == FEAT_RUBBLE) || (feat == FEAT_MAGMA_K) ||
+	    (feat == FEAT_QUARTZ_K))
+	{
+		return (TRUE);
+	}
+
+	/* Shops */
+	if (((feat >= FEAT_SHOP_HEAD) && (feat <= FEAT_SHOP_TAIL)) ||
+	    (feat == FEAT_STORE_EXIT)) return (TRUE);
+
+	/* Buildings -KMW- */
+	if ((feat >= FEAT_BLDG_HEAD) && (feat <= FEAT_BLDG_TAIL)) return (TRUE);
+
+	/* Traps */
+	if ((feat >= FEAT_TRAP_HEAD) && (feat <= FEAT_TRAP_TAIL)) return (TRUE);
+
+	/* Doors */
+	if ((feat >= FEAT_DOOR_HEAD) && (feat <= FEAT_DOOR_TAIL)) return (TRUE);
+
+	/* Altars */
+	if ((feat >= FEAT_ALTAR_HEAD) && (feat <= FEAT_ALTAR_TAIL)) return (TRUE);
+
+	/* Nope */
+	return (FALSE);
+}
+
+
+/*
+ * Add a grid to the notable-feature list, if it is not there yet.
+ *
+ * The list holds every grid whose feature "target_set_prepare()" would
+ * stop at, so that looking around does not scan the whole panel.  Grids
+ * whose feature has since become dull are only removed from the list by
+ * "target_set_prepare()" itself.
+ */
+void note_grid_add(int y, int x)
+{
+	/* Already listed */
+	if (cave_info[y][x] & (CAVE_NOTE)) return;
+
+	/* Paranoia -- list is full */
+	if (note_grid_n >= NOTE_GRID_MAX) return;
+
+	/* Mark and list the grid */
+	cave_info[y][x] |= (CAVE_NOTE);
+	note_grid_y[note_grid_n] = y;
+	note_grid_x[note_grid_n] = x;
+	note_grid_n++;
+}
+
+
+/*
+ * Register a shifting maze wall with process_active_terrain().
+ *
+ * Every grid marked with "CAVE_ACTIVE" appears in the active wall list
+ * exactly once, and the wall keeps its entry as it moves around.
+ */
+void active_wall_add(int y, int x)
+{
+	/* Already registered */
+	if (cave_info[y][x] & (CAVE_ACTIVE)) return;
+
+	/* Paranoia -- list is full, leave the wall static */
+	if (active_wall_n >= ACTIVE_WALL_MAX) return;
+
+	/* Mark and list the wall */
+	cave_info[y][x] |= (CAVE_ACTIVE);
+	active_wall_y[active_wall_n] = y;
+	active_wall_x[active_wall_n] = x;
+	active_wall_n++;
+}
+
+
+/*
+ * Add a rolling boulder to the boulder list, if it is not there yet.
+ *
+ * The list holds every grid which process_boulders() must move, so that
+ * it does not sweep the map.  A boulder keeps its entry as it rolls, and
+ * entries are only removed by process_boulders() itself, once the grid
+ * is no longer a rolling boulder.
+ */
+void boulder_add(int y, int x)
+{
+	int i;
+
+	/* Already listed (the list is short) */
+	for (i = 0; i < boulder_n; i++)
+	{
+		if ((boulder_y[i] == y) && (boulder_x[i] == x)) return;
+	}
+
+	/* Paranoia -- list is full, leave the boulder still */
+	if (boulder_n >= BOULDER_MAX) return;
+
+	boulder_y[boulder_n] = y;
+	boulder_x[boulder_n] = x;
+	boulder_n++;
+}
+
+
+/*
+ * Rebuild the active wall list by scanning the map for "CAVE_ACTIVE".
+ *
+ * Only needed for savefiles which predate the stored list.
+ */
+void rebuild_active_walls(void)
+{
+	int y, x;
+
+	/* Forget the old list */
+	active_wall_n = 0;
+
+	/* Scan the map */
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		for (x = 0; x < DUNGEON_WID; x++)
+		{
+			if (!(cave_info[y][x] & (CAVE_ACTIVE))) continue;
+
+			/* Re-register shifting walls, forget anything else */
+			cave_info[y][x] &= ~(CAVE_ACTIVE);
+			if (cave_feat[y][x] == FEAT_WALL_EXTRA) active_wall_add(y, x);
+		}
+	}
+}
+
+
+/*
+ * Register a dark maze sector, given its bounding box.
+ */
+void dark_sector_add(int y1, int x1, int y2, int x2)
+{
+	dark_sector *ds_ptr;
+
+	/* Paranoia -- table is full */
+	if (dark_sector_n >= DARK_SECTOR_MAX) return;
+
+	/* Clip to the dungeon */
+	if (y1 < 0) y1 = 0;
+	if (x1 < 0) x1 = 0;
+	if (y2 > DUNGEON_HGT - 1) y2 = DUNGEON_HGT - 1;
+	if (x2 > DUNGEON_WID - 1) x2 = DUNGEON_WID - 1;
+
+	/* Save the box */
+	ds_ptr = &dark_sectors[dark_sector_n++];
+	ds_ptr->y1 = y1;
+	ds_ptr->x1 = x1;
+	ds_ptr->y2 = y2;
+	ds_ptr->x2 = x2;
+}
+
+
+/*
+ * Find the dark maze sector containing a grid, or -1 if none.
+ */
+int dark_sector_find(int y, int x)
+{
+	int i;
+
+	/* Not a dark grid */
+	if (cave_sector[y][x] != SECTOR_DARK) return (-1);
+
+	/* Scan the (short) sector table */
+	for (i = 0; i < dark_sector_n; i++)
+	{
+		dark_sector *ds_ptr = &dark_sectors[i];
+
+		if ((y >= ds_ptr->y1) && (y <= ds_ptr->y2) &&
+		    (x >= ds_ptr->x1) && (x <= ds_ptr->x2)) return (i);
+	}
+
+	/* Nothing */
+	return (-1);
+}
+
+
+/*
+ * Rebuild the dark sector table from "cave_sector".
+ *
+ * Sectors are laid out on a grid of 2x2 blocks, so each group of
+ * blocks containing a dark grid becomes one sector.  Used for levels
+ * read from a savefile.
+ */
+void rebuild_dark_sectors(void)
+{
+	int gy, gx, y, x;
+	int hgt = BLOCK_HGT * 2;
+	int wid = BLOCK_WID * 2;
+
+	/* Forget the old table */
+	dark_sector_n = 0;
+
+	/* Scan the sector groups */
+	for (gy = 0; gy < DUNGEON_HGT; gy += hgt)
+	{
+		for (gx = 0; gx < DUNGEON_WID; gx += wid)
+		{
+			bool dark = FALSE;
+
+			/* Look for a dark grid */
+			for (y = gy; !dark && (y < gy + hgt) && (y < DUNGEON_HGT); y++)
+			{
+				for (x = gx; (x < gx + wid) && (x < DUNGEON_WID); x++)
+				{
+					if (cave_sector[y][x] == SECTOR_DARK)
+					{
+						dark = TRUE;
+						break;
+					}
+				}
+			}
+
+			/* Register the group */
+			if (dark) dark_sector_add(gy, gx, gy + hgt - 1, gx + wid - 1);
+		}
+	}
+}
+
+
+/*
+ * Rebuild the per-level grid indexes from the cave arrays.
+ *
+ * This must be called once a level has been generated or read from
+ * a savefile, since neither path goes through cave_set_feat() for
+ * every grid.
+ */
+void rebuild_level_indexes(void)
+{
+	int y, x;
+
+	/* Forget the old flows */
+	forget_flow();
+	wipe_flow_fields();
+	wipe_scent();
+	build_sector_graph();
+
+	/* Recompute the view */
+	view_dirty = TRUE;
+
+	/* Forget the old rays */
+	sight_cache_wipe();
+
+	/* Relink the monsters into the bucket grid */
+	rebuild_monster_buckets();
+
+	/* Count the floor grids */
+	build_floor_blocks();
+
+	/* Forget the old environment-active list */
+	env_active_n = 0;
+
+	/* Forget the old trap counts */
+	magnet_trap_n = gravity_trap_n = 0;
+
+	/* Forget the old notable-feature list */
+	note_grid_n = 0;
+
+	/* Forget the old boulder list */
+	boulder_n = 0;
+
+	/* Forget the old sanctum doors */
+	sanctum_door_n = 0;
+	sanctum_door_full = FALSE;
+
+	/* Forget stale membership */
+	cave_info_clear_all(CAVE_ENV | CAVE_NOTE | CAVE_SLOPE | CAVE_PASS);
+
+	/* Forget the old light field */
+	C_WIPE(&cave_light[0][0], cave_hgt * DUNGEON_WID, byte);
+
+	for (y = 0; y < cave_hgt; y++)
+	{
+		for (x = 0; x < cave_wid; x++)
+		{
+			if (cave_info[y][x] & (CAVE_SHINE))
+				cave_info[y][x] &= ~(CAVE_GLOW | CAVE_SHINE);
+		}
+	}
+
+	/* Scan the map */
+	for (y = 0; y < cave_hgt; y++)
+	{
+		for (x = 0; x < cave_wid; x++)
+		{
+			/* List burning grids */
+			if (cave_feat[y][x] == FEAT_OIL_BURNING) env_active_add(y, x);
+
+			/* List notable grids */
+			if (feat_notable(cave_feat[y][x])) note_grid_add(y, x);
+
+			/* List rolling boulders */
+			if ((cave_feat[y][x] >= FEAT_BOULDER_N) &&
+			    (cave_feat[y][x] <= FEAT_BOULDER_W))
+			{
+				boulder_add(y, x);
+			}
+
+			/* List sanctum doors */
+			if (cave_feat[y][x] == FEAT_SANCTUM_DOOR) sanctum_door_add(y, x);
+
+			/* Mark the edges between heights */
+			if (cave_flow[y][x].elev != ELEV_GROUND) elev_slope_mark(y, x);
+
+			/* Light the grids next to them */
+			if (feat_gives_light(cave_feat[y][x])) light_source(y, x, 1);
+
+			/* Count magnetism and gravity traps */
+			if (cave_feat[y][x] == FEAT_TRAP_MAGNETISM) magnet_trap_n++;
+			if (cave_feat[y][x] == FEAT_TRAP_GRAVITY) gravity_trap_n++;
+		}
+	}
+}
+
+
+/*
+ * Make a new (empty) game, to be switched to with "game_switch()"
+ */
+game_type *game_make(void)
+{
+	game_type *g_ptr;
+
+	MAKE(g_ptr, game_type);
+
+	g_ptr->obj_max = 1;
+	g_ptr->mon_max = 1;
+	g_ptr->guard_max = 1;
+
+	g_ptr->hgt = DUNGEON_HGT;
+	g_ptr->wid = DUNGEON_WID;
+
+	return (g_ptr);
+}
+
+
+/*
+ * Free a game made by "game_make()" (which must not be the current one)
+ */
+void game_kill(game_type *g_ptr)
+{
+	if (g_ptr == game_ptr) return;
+
+	KILL(g_ptr, game_type);
+}
+
+
+/*
+ * Make "g_ptr" the current game, and return the one it replaces.
+ *
+ * The per-level indexes (flows, rays, monster buckets, and so on) only
+ * follow one game, so they are rebuilt for the new one.
+ */
+game_type *game_switch(game_type *g_ptr)
+{
+	game_type *old = game_ptr;
+
+	if (g_ptr == old) return (old);
+
+	game_ptr = g_ptr;
+
+	rebuild_level_indexes();
+
+	/* Count the recharging objects again */
+	object_charging_n = 1;
+
+	return (old);
+}
+
+
+/*
+ * The paths of "mmove2()", for every target within MAX_RANGE along both
+ * axes: how far along the minor axis the path is after "dist" steps along
+ * the major one, as "path_shift[major][minor][dist]" (see "init_paths()").
+ */
+static byte path_shift[MAX_RANGE + 1][MAX_RANGE + 1][PATH_STEPS];
+
+
+/*
+ * Work out the paths of "mmove2()" (at startup)
+ */
+void init_paths(void)
+{
+	int major, minor, dist;
+
+	for (major = 1; major <= MAX_RANGE; major++)
+	{
+		for (minor = 0; minor <= major; minor++)
+		{
+			for (dist = 0; dist < PATH_STEPS; dist++)
+			{
+				path_shift[major][minor][dist] =
+					(byte)((dist * minor + (major - 1) / 2) / major);
+			}
+		}
+	}
+}
+
+
+/*
+ * Calculate "incremental motion". Used by project() and shoot().
+ * Assumes that (*y,*x) lies on the path from (y1,x1) to (y2,x2).
+ *
+ * The first steps to a nearby target are looked up, not worked out.
+ */
+void mmove2(int *y, int *x, int y1, int x1, int y2, int x2)
+{
+	int dy, dx, dist, shift;
+
+	/* Extract the distance travelled */
+	dy = (*y < y1) ? y1 - *y : *y - y1;
+	dx = (*x < x1) ? x1 - *x : *x - x1;
+
+	/* Number of steps */
+	dist = (dy > dx) ? dy : dx;
+
+	/* We are calculating the next location */
+	dist++;
+
+
+	/* Calculate the total distance along each axis */
+	dy = (y2 < y1) ? (y1 - y2) : (y2 - y1);
+	dx = (x2 < x1) ? (x1 - x2) : (x2 - x1);
+
+	/* Paranoia -- Hack -- no motion */
+	if (!dy && !dx)
+		return;
+
+
+	/* Move mostly vertically */
+	if (dy > dx)
+	{
+
+#if 0
+
+		int k;
 
 		/* Starting shift factor */
 		shift = dy >> 1;
@@ -3508,7 +4812,10 @@ void mmove2(int *y, int *x, int y1, int x1, int y2, int x2)
 #endif
 
 		/* Extract a shift factor */
-		shift = (dist * dx + (dy - 1) / 2) / dy;
+		if ((dy <= MAX_RANGE) && (dist < PATH_STEPS))
+			shift = path_shift[dy][dx][dist];
+		else
+			shift = (dist * dx + (dy - 1) / 2) / dy;
 
 		/* Sometimes move along the minor axis */
 		(*x) = (x2 < x1) ? (x1 - shift) : (x1 + shift);
@@ -3546,7 +4853,10 @@ void mmove2(int *y, int *x, int y1, int x1, int y2, int x2)
 #endif
 
 		/* Extract a shift factor */
-		shift = (dist * dy + (dx - 1) / 2) / dx;
+		if ((dx <= MAX_RANGE) && (dist < PATH_STEPS))
+			shift = path_shift[dx][dy][dist];
+		else
+			shift = (dist * dy + (dx - 1) / 2) / dx;
 
 		/* Sometimes move along the minor axis */
 		(*y) = (y2 < y1) ? (y1 - shift) : (y1 + shift);
@@ -3563,7 +4873,7 @@ void mmove2(int *y, int *x, int y1, int x1, int y2, int x2)
  *
  * This is slightly (but significantly) different from "los(y1,x1,y2,x2)".
  */
-bool projectable(int y1, int x1, int y2, int x2)
+static bool projectable_aux(int y1, int x1, int y2, int x2)
 {
 	int dist, y, x;
 
@@ -3596,6 +4906,56 @@ bool projectable(int y1, int x1, int y2, int x2)
 }
 
 
+/*
+ * Determine if a line of sight can be traced from (y1,x1) to (y2,x2),
+ * using the cache where possible.  See "los_aux()" above.
+ */
+bool los(int y1, int x1, int y2, int x2)
+{
+	sight_cache *c_ptr = sight_cache_entry(y1, x1, y2, x2);
+
+	/* Hit */
+	if (c_ptr->flags & (SIGHT_LOS_KNOWN))
+	{
+		sight_cache_hits++;
+		return ((c_ptr->flags & (SIGHT_LOS)) ? TRUE : FALSE);
+	}
+
+	/* Miss */
+	sight_cache_misses++;
+
+	c_ptr->flags |= (SIGHT_LOS_KNOWN);
+	if (los_aux(y1, x1, y2, x2)) c_ptr->flags |= (SIGHT_LOS);
+
+	return ((c_ptr->flags & (SIGHT_LOS)) ? TRUE : FALSE);
+}
+
+
+/*
+ * Determine if a bolt spell cast from (y1,x1) to (y2,x2) will arrive,
+ * using the cache where possible.  See "projectable_aux()" above.
+ */
+bool projectable(int y1, int x1, int y2, int x2)
+{
+	sight_cache *c_ptr = sight_cache_entry(y1, x1, y2, x2);
+
+	/* Hit */
+	if (c_ptr->flags & (SIGHT_PROJ_KNOWN))
+	{
+		sight_cache_hits++;
+		return ((c_ptr->flags & (SIGHT_PROJ)) ? TRUE : FALSE);
+	}
+
+	/* Miss */
+	sight_cache_misses++;
+
+	c_ptr->flags |= (SIGHT_PROJ_KNOWN);
+	if (projectable_aux(y1, x1, y2, x2)) c_ptr->flags |= (SIGHT_PROJ);
+
+	return ((c_ptr->flags & (SIGHT_PROJ)) ? TRUE : FALSE);
+}
+
+
 /*
  * Modified ``projectable'' function that checks so that no monsters
  * of a certain pet status are harmed.
@@ -3738,14 +5098,18 @@ void object_kind_track(int k_idx)
  *
  * The first arg indicates a major disturbance, which affects search.
  *
- * The second arg is currently unused, but could induce output flush.
+ * The second arg gives the reason (DISTURB_*, zero for "other").
  *
  * All disturbance cancels repeated commands, resting, and running.
+ * This happens at once, so that a run never takes another step, but
+ * the redraws it requests are only made by the next handle_stuff(),
+ * so several disturbances in one game turn cost a single redraw.
+ * The reasons of all the disturbances which stopped something this
+ * game turn are gathered in "disturb_why".
  */
-void disturb(int stop_search, int unused_flag)
+void disturb(int stop_search, int why)
 {
-	/* Unused */
-	unused_flag = unused_flag;
+	bool stopped = FALSE;
 
 	/* Cancel auto-commands */
 	/* p_ptr->command_new = 0; */
@@ -3755,6 +5119,7 @@ void disturb(int stop_search, int unused_flag)
 	{
 		/* Cancel */
 		p_ptr->command_rep = 0;
+		stopped = TRUE;
 
 		/* Redraw the state (later) */
 		p_ptr->redraw |= (PR_STATE);
@@ -3765,6 +5130,7 @@ void disturb(int stop_search, int unused_flag)
 	{
 		/* Cancel */
 		p_ptr->resting = 0;
+		stopped = TRUE;
 
 		/* Redraw the state (later) */
 		p_ptr->redraw |= (PR_STATE);
@@ -3778,6 +5144,7 @@ void disturb(int stop_search, int unused_flag)
 	{
 		/* Cancel */
 		p_ptr->running = 0;
+		stopped = TRUE;
 
 		/* Recenter the panel when running stops */
 		if (center_player && !center_running)
@@ -3787,6 +5154,16 @@ void disturb(int stop_search, int unused_flag)
 		p_ptr->update |= (PU_TORCH);
 	}
 
+	/* Remember why, merging with the rest of this game turn */
+	if (stopped || (disturb_turn == turn))
+	{
+		/* A new game turn */
+		if (disturb_turn != turn) disturb_why = 0;
+
+		disturb_why |= (why ? why : DISTURB_OTHER);
+		disturb_turn = turn;
+	}
+
 	/* Cancel searching if requested */
 	if (stop_search && p_ptr->searching)
 	{
@@ -3810,13 +5187,154 @@ void disturb(int stop_search, int unused_flag)
  * Provides tactical height advantages and disadvantages
  */
 
+static bool elev_allows_move_aux(int sy, int sx, int dy, int dx, bool flying);
+
+
+/*
+ * Work out which steps off "y,x" can be taken.
+ *
+ * A bit of "cave_elev_walk" is set if "elev_allows_move()" lets a walker
+ * step that way, and a bit of "cave_flow[][].pass" if the monster flow
+ * may follow it as well (the flow does not jump off steep cliffs).
+ *
+ * Grids of the same height can always reach each other, so only grids
+ * marked CAVE_SLOPE (next to a grid of another height) are looked at,
+ * the first time they are asked about after the ground around them has
+ * changed (they are then marked CAVE_PASS).
+ */
+void elev_pass_grid(int y, int x)
+{
+	int d;
+	byte walk = 0, flow = 0;
+
+	for (d = 0; d < 8; d++)
+	{
+		int ny = y + ddy_ddd[d];
+		int nx = x + ddx_ddd[d];
+		int feat;
+
+		if (!in_bounds(ny, nx)) continue;
+
+		if (!elev_allows_move_aux(y, x, ny, nx, FALSE)) continue;
+
+		walk |= (1 << d);
+
+		/* No way down a steep cliff */
+		feat = cave_feat[ny][nx];
+		if ((cave_flow[y][x].elev - cave_flow[ny][nx].elev >= 2) &&
+		    (feat != FEAT_RAMP) && (feat != FEAT_STAIRS) &&
+		    (feat != FEAT_LADDER) && (feat != FEAT_ROPE) &&
+		    (feat != FEAT_JUMP_POINT))
+		{
+			continue;
+		}
+
+		flow |= (1 << d);
+	}
+
+	cave_elev_walk[y][x] = walk;
+	cave_flow[y][x].pass = flow;
+
+	cave_info[y][x] |= (CAVE_PASS);
+}
+
+
+/*
+ * Note whether "y,x" is next to a grid of another height, and forget
+ * the steps off it
+ */
+static void elev_slope_grid(int y, int x)
+{
+	int d;
+
+	cave_info[y][x] &= ~(CAVE_SLOPE | CAVE_PASS);
+
+	for (d = 0; d < 8; d++)
+	{
+		int ny = y + ddy_ddd[d];
+		int nx = x + ddx_ddd[d];
+
+		if (!in_bounds(ny, nx)) continue;
+
+		if (cave_flow[y][x].elev != cave_flow[ny][nx].elev)
+		{
+			cave_info[y][x] |= (CAVE_SLOPE);
+			return;
+		}
+	}
+}
+
+
+/*
+ * The elevation of "y,x" has changed
+ */
+static void elev_pass_moved(int y, int x)
+{
+	int d;
+
+	elev_slope_grid(y, x);
+
+	for (d = 0; d < 8; d++)
+	{
+		int ny = y + ddy_ddd[d];
+		int nx = x + ddx_ddd[d];
+
+		if (in_bounds(ny, nx)) elev_slope_grid(ny, nx);
+	}
+}
+
+
+/*
+ * The feature of "y,x" (a CAVE_SLOPE grid) has changed, so forget the
+ * steps onto and off it
+ */
+void elev_pass_note(int y, int x)
+{
+	int d;
+
+	cave_info[y][x] &= ~(CAVE_PASS);
+
+	for (d = 0; d < 8; d++)
+	{
+		int ny = y + ddy_ddd[d];
+		int nx = x + ddx_ddd[d];
+
+		if (in_bounds(ny, nx)) cave_info[ny][nx] &= ~(CAVE_PASS);
+	}
+}
+
+
+/*
+ * Mark the grids around "y,x" (which is not on the ground) with CAVE_SLOPE
+ * if they are of another height (see "rebuild_level_indexes()", which
+ * has cleared the marks)
+ */
+void elev_slope_mark(int y, int x)
+{
+	int d;
+
+	for (d = 0; d < 8; d++)
+	{
+		int ny = y + ddy_ddd[d];
+		int nx = x + ddx_ddd[d];
+
+		if (!in_bounds(ny, nx)) continue;
+
+		if (cave_flow[y][x].elev == cave_flow[ny][nx].elev) continue;
+
+		cave_info[y][x] |= (CAVE_SLOPE);
+		cave_info[ny][nx] |= (CAVE_SLOPE);
+	}
+}
+
+
 /*
  * Get effective elevation at a grid
  */
 int get_elevation(int y, int x)
 {
     if (!in_bounds(y, x)) return ELEV_GROUND;
-    return cave_elev[y][x];
+    return cave_flow[y][x].elev;
 }
 
 /*
@@ -3827,7 +5345,20 @@ void set_elevation(int y, int x, int elev)
     if (!in_bounds(y, x)) return;
     if (elev > ELEV_MAX) elev = ELEV_MAX;
     if (elev < ELEV_MIN) elev = ELEV_MIN;
-    cave_elev[y][x] = elev;
+    /* Forget cached rays if the ground moved */
+    if (cave_flow[y][x].elev != elev) sight_cache_wipe();
+
+    cave_flow[y][x].elev = elev;
+
+    /* The grid may look different */
+    map_info_forget(y, x);
+
+    /* The monster flow may have to route around this grid */
+    if (character_dungeon) {
+        flow_invalidate(y, x);
+        view_note_change(y, x);
+        elev_pass_moved(y, x);
+    }
 }
 
 /*
@@ -3836,9 +5367,9 @@ void set_elevation(int y, int x, int elev)
 void init_elevation(void)
 {
     int y, x;
-    for (y = 0; y < DUNGEON_HGT; y++) {
-        for (x = 0; x < DUNGEON_WID; x++) {
-            cave_elev[y][x] = ELEV_GROUND;
+    for (y = 0; y < cave_hgt; y++) {
+        for (x = 0; x < cave_wid; x++) {
+            cave_flow[y][x].elev = ELEV_GROUND;
         }
     }
 }
@@ -3963,8 +5494,38 @@ int elev_movement_cost(int sy, int sx, int dy, int dx)
 
 /*
  * Check if movement is allowed (cliffs block from below)
+ *
+ * Steps to a neighbouring grid are looked up (see "elev_pass_grid()"):
+ * flying only helps on the way up, and every step up is allowed then.
  */
 bool elev_allows_move(int sy, int sx, int dy, int dx, bool flying)
+{
+	int ry = dy - sy;
+	int rx = dx - sx;
+
+	/* Level ground */
+	if (get_elevation(sy, sx) == get_elevation(dy, dx)) return (TRUE);
+
+	/* Look up the step (but not while the level is being made) */
+	if (character_dungeon && (ABS(ry) <= 1) && (ABS(rx) <= 1) &&
+	    in_bounds(sy, sx) && in_bounds(dy, dx))
+	{
+		if (!(cave_info[sy][sx] & (CAVE_PASS))) elev_pass_grid(sy, sx);
+
+		if (cave_elev_walk[sy][sx] & (1 << elev_dir[ry + 1][rx + 1]))
+			return (TRUE);
+
+		return (flying && (cave_flow[dy][dx].elev > cave_flow[sy][sx].elev));
+	}
+
+	return (elev_allows_move_aux(sy, sx, dy, dx, flying));
+}
+
+
+/*
+ * Check if movement is allowed, the long way
+ */
+static bool elev_allows_move_aux(int sy, int sx, int dy, int dx, bool flying)
 {
     int src_elev = get_elevation(sy, sx);
     int dst_elev = get_elevation(dy, dx);
@@ -129,8 +129,6 @@ s16b critical_norm(int weight, int plus, int dam, int weap_tval,
 	int i, k, tx, ty;
 	char m_name[80];
 
-	monster_desc(m_name, m_ptr, 0);
-
 	/* Extract "blow" power */
 	i = (weight + ((p_ptr->to_h + plus) * 5) + (p_ptr->lev * 3));
 
@@ -141,6 +139,9 @@ s16b critical_norm(int weight, int plus, int dam, int weap_tval,
 	{
 		k = weight + randint(650);
 
+		/* Only blunt weapons say what they did to it */
+		if (weap_tval == TV_HAFTED) monster_desc(m_name, m_ptr, 0);
+
 		if (k < 400)
 		{
 			mprint(MSG_BONUS, "It was a good hit!");
@@ -2510,6 +2511,117 @@ void move_player(int dir, int jumping)
 }
 
 
+/*
+ * What the runner makes of each feature (see "run_feat_prepare()")
+ */
+#define RUN_NOTICE	0	/* Interesting, stop */
+#define RUN_IGNORE	1	/* Not interesting */
+#define RUN_DOOR	2	/* An open door (see "run_ignore_doors") */
+#define RUN_STAIR	3	/* A staircase (see "run_ignore_stairs") */
+#define RUN_KIND	0x03
+#define RUN_WALL	0x04	/* A wall, if known */
+
+static byte run_feat[256];
+static bool run_feat_ready = FALSE;
+
+
+/*
+ * Sort the features once, so that each step of a run looks them up
+ * instead of working them out again
+ */
+static void run_feat_prepare(void)
+{
+	int f;
+
+	if (run_feat_ready) return;
+
+	for (f = 0; f < 256; f++)
+	{
+		byte k = RUN_NOTICE;
+
+		switch (f)
+		{
+				/* Floors */
+			case FEAT_FLOOR:
+
+				/* Invis traps */
+			case FEAT_INVIS:
+
+				/* Secret doors */
+			case FEAT_SECRET:
+
+				/* Normal veins */
+			case FEAT_MAGMA:
+			case FEAT_QUARTZ:
+
+				/* Hidden treasure */
+			case FEAT_MAGMA_H:
+			case FEAT_QUARTZ_H:
+
+				/* Walls */
+			case FEAT_WALL_EXTRA:
+			case FEAT_WALL_INNER:
+			case FEAT_WALL_OUTER:
+			case FEAT_WALL_SOLID:
+			case FEAT_PERM_EXTRA:
+			case FEAT_PERM_INNER:
+			case FEAT_PERM_OUTER:
+			case FEAT_PERM_SOLID:
+				/* water, lava, & trees -KMW- */
+			case FEAT_DEEP_WATER:
+			case FEAT_SHAL_WATER:
+			case FEAT_DEEP_LAVA:
+			case FEAT_SHAL_LAVA:
+			case FEAT_TREES:
+			case FEAT_MOUNTAIN:
+				/* quest features -KMW- */
+			case FEAT_QUEST_ENTER:
+			case FEAT_QUEST_EXIT:
+
+				/* Chaos Fog */
+			case FEAT_CHAOS_FOG:
+			case FEAT_FOG:
+			case FEAT_GRASS:
+			case FEAT_SWAMP:
+			case FEAT_MUD:
+			case FEAT_SHRUB:
+			case FEAT_ROCKY_HILL:
+			{
+				k = RUN_IGNORE;
+				break;
+			}
+
+				/* Open doors */
+			case FEAT_OPEN:
+			case FEAT_BROKEN:
+			{
+				k = RUN_DOOR;
+				break;
+			}
+
+				/* Stairs */
+			case FEAT_LESS:
+			case FEAT_MORE:
+			{
+				k = RUN_STAIR;
+				break;
+			}
+		}
+
+		/* Walls (not water, and nothing past the grass) */
+		if ((f >= FEAT_SECRET) && (f != FEAT_SHAL_WATER) &&
+		    (f != FEAT_DEEP_WATER) && (f < FEAT_GRASS))
+		{
+			k |= RUN_WALL;
+		}
+
+		run_feat[f] = k;
+	}
+
+	run_feat_ready = TRUE;
+}
+
+
 /*
  * Hack -- Check for a "known wall" (see below)
  */
@@ -2524,9 +2636,7 @@ static int see_wall(int dir, int y, int x)
 		return (FALSE);
 
 	/* Non-wall grids are not known walls */
-	if (cave_feat[y][x] < FEAT_SECRET || cave_feat[y][x] == FEAT_SHAL_WATER
-		|| cave_feat[y][x] == FEAT_DEEP_WATER ||
-		cave_feat[y][x] >= FEAT_GRASS) return (FALSE);
+	if (!(run_feat[cave_feat[y][x]] & (RUN_WALL))) return (FALSE);
 
 	/* Unknown walls are not known walls */
 	if (!(cave_info[y][x] & (CAVE_MARK)))
@@ -2907,89 +3017,12 @@ static bool run_test(void)
 		/* Check memorized grids */
 		if (cave_info[row][col] & (CAVE_MARK))
 		{
-			bool notice = TRUE;
-
-			/* Examine the terrain */
-			switch (cave_feat[row][col])
-			{
-					/* Floors */
-				case FEAT_FLOOR:
-
-					/* Invis traps */
-				case FEAT_INVIS:
-
-					/* Secret doors */
-				case FEAT_SECRET:
-
-					/* Normal veins */
-				case FEAT_MAGMA:
-				case FEAT_QUARTZ:
-
-					/* Hidden treasure */
-				case FEAT_MAGMA_H:
-				case FEAT_QUARTZ_H:
-
-					/* Walls */
-				case FEAT_WALL_EXTRA:
-				case FEAT_WALL_INNER:
-				case FEAT_WALL_OUTER:
-				case FEAT_WALL_SOLID:
-				case FEAT_PERM_EXTRA:
-				case FEAT_PERM_INNER:
-				case FEAT_PERM_OUTER:
-				case FEAT_PERM_SOLID:
-					/* water, lava, & trees -KMW- */
-				case FEAT_DEEP_WATER:
-				case FEAT_SHAL_WATER:
-				case FEAT_DEEP_LAVA:
-				case FEAT_SHAL_LAVA:
-				case FEAT_TREES:
-				case FEAT_MOUNTAIN:
-					/* quest features -KMW- */
-				case FEAT_QUEST_ENTER:
-				case FEAT_QUEST_EXIT:
-
-					/* Chaos Fog */
-				case FEAT_CHAOS_FOG:
-				case FEAT_FOG:
-				case FEAT_GRASS:
-				case FEAT_SWAMP:
-				case FEAT_MUD:
-				case FEAT_SHRUB:
-				case FEAT_ROCKY_HILL:
-				{
+			int k = (run_feat[cave_feat[row][col]] & (RUN_KIND));
 
-					/* Ignore */
-					notice = FALSE;
-
-					/* Done */
-					break;
-				}
-
-					/* Open doors */
-				case FEAT_OPEN:
-				case FEAT_BROKEN:
-				{
-					/* Option -- ignore */
-					if (run_ignore_doors)
-						notice = FALSE;
-
-					/* Done */
-					break;
-				}
-
-					/* Stairs */
-				case FEAT_LESS:
-				case FEAT_MORE:
-				{
-					/* Option -- ignore */
-					if (run_ignore_stairs)
-						notice = FALSE;
-
-					/* Done */
-					break;
-				}
-			}
+			/* Option -- ignore doors and stairs */
+			bool notice = ((k == RUN_NOTICE) ||
+			               ((k == RUN_DOOR) && !run_ignore_doors) ||
+			               ((k == RUN_STAIR) && !run_ignore_stairs));
 
 			/* Interesting feature */
 			if (notice)
@@ -3229,6 +3262,9 @@ static bool run_test(void)
  */
 void run_step(int dir)
 {
+	/* Sort the features (once) */
+	run_feat_prepare();
+
 	/* Start run */
 	if (dir)
 	{
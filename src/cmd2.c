@@ -2620,6 +2620,140 @@ void do_cmd_rest(void)
 
 
 
+/*
+ * The grids a missile flew through (see "missile_flight()")
+ */
+static s16b missile_path_y[MAX_MISSILE_PATH];
+static s16b missile_path_x[MAX_MISSILE_PATH];
+
+
+/*
+ * Work out the whole flight of a missile from the player towards (ty,tx),
+ * for at most "tdis" grids, before anything is shown or hit
+ *
+ * The missile stops at the target, at a wall, at a monster (in its grid,
+ * which is then the last one), or on cover, which it rolls to hit as it
+ * comes to it.  The grids are left in "missile_path_y/x[]", and the number
+ * of them is returned; "*cy,*cx" is the grid of the cover it hit, or -1.
+ */
+static int missile_flight(int ty, int tx, int tdis, int *cy, int *cx)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+
+	int y = py, x = px, ny, nx;
+	int n = 0;
+
+	*cy = *cx = -1;
+
+	/* Travel until stopped */
+	while ((n <= tdis) && (n < MAX_MISSILE_PATH))
+	{
+		int cover;
+
+		/* Hack -- Stop at the target */
+		if ((y == ty) && (x == tx))
+			break;
+
+		/* Calculate the new location (see "project()") */
+		ny = y;
+		nx = x;
+		mmove2(&ny, &nx, py, px, ty, tx);
+
+		/* Stopped by walls/doors */
+		if (!cave_floor_bold(ny, nx))
+			break;
+
+		/* Check for cover collision */
+		cover = get_cover_at(ny, nx);
+
+		if (cover != COVER_NONE)
+		{
+			int chance = 0;
+
+			switch (cover)
+			{
+				case COVER_LIGHT: chance = 25; break;
+				case COVER_MEDIUM: chance = 40; break;
+				case COVER_HEAVY: chance = 60; break;
+				case COVER_TOTAL: chance = 90; break;
+			}
+
+			if (rand_int(100) < chance)
+			{
+				*cy = ny;
+				*cx = nx;
+				break;
+			}
+		}
+
+		/* Save the new location */
+		y = ny;
+		x = nx;
+
+		missile_path_y[n] = y;
+		missile_path_x[n] = x;
+		n++;
+
+		/* Stopped by a monster */
+		if (cave_m_idx[y][x] > 0)
+			break;
+	}
+
+	return (n);
+}
+
+
+/*
+ * Show the flight of a missile (the first "n" grids of "missile_path")
+ *
+ * With no delay (see "delay_factor"), the missile is only glimpsed in the
+ * last grid the player sees it in, as a cosmetic glyph which goes with the
+ * next refresh, so a volley costs no time at all.
+ */
+static void missile_show(int n, byte a, char c)
+{
+	int msec = op_ptr->delay_factor * op_ptr->delay_factor;
+	int i;
+
+	/* Nobody is watching (see "--fast") */
+	if (arg_fast)
+		return;
+
+	for (i = 0; i < n; i++)
+	{
+		int y = missile_path_y[i];
+		int x = missile_path_x[i];
+
+		/* The player can see the (on screen) missile */
+		if (panel_contains(y, x) && player_can_see_bold(y, x))
+		{
+			/* Glimpse it, later */
+			if (!msec)
+			{
+				print_fx(c, a, y, x, 1);
+				continue;
+			}
+
+			/* Draw, Hilite, Fresh, Pause, Erase */
+			print_rel(c, a, y, x);
+			move_cursor_relative(y, x);
+			Term_fresh();
+			Term_xtra(TERM_XTRA_DELAY, msec);
+			lite_spot(y, x);
+			Term_fresh();
+		}
+
+		/* The player cannot see the missile */
+		else if (msec)
+		{
+			/* Pause anyway, for consistancy */
+			Term_xtra(TERM_XTRA_DELAY, msec);
+		}
+	}
+}
+
+
 /*
  * Fire an object from the pack or floor.
  *
@@ -2654,7 +2788,7 @@ void do_cmd_fire(void)
 	int px = p_ptr->px;
 
 	int dir;
-	int y, x, ny, nx, ty, tx;
+	int y, x, ty, tx, cy, cx;
 	int tdam, tdis, thits, tmul;
 	int bonus, chance;
 	int cur_dis, visible;
@@ -2669,7 +2803,6 @@ void do_cmd_fire(void)
 
 	char o_name[80];
 
-	int msec = op_ptr->delay_factor * op_ptr->delay_factor;
 
 	/* Inside arena */
 	if (p_ptr->inside_special == SPECIAL_ARENA)
@@ -2778,200 +2911,153 @@ void do_cmd_fire(void)
 	handle_stuff();
 
 
-	/* Travel until stopped */
-	for (cur_dis = 0; cur_dis <= tdis;)
-	{
-		/* Hack -- Stop at the target */
-		if ((y == ty) && (x == tx))
-			break;
-
-		/* Calculate the new location (see "project()") */
-		ny = y;
-		nx = x;
-		mmove2(&ny, &nx, py, px, ty, tx);
-
-		/* Stopped by walls/doors */
-		if (!cave_floor_bold(ny, nx))
-			break;
-
-        /* Check for cover collision */
-        {
-            int cover = get_cover_at(ny, nx);
-            if (cover != COVER_NONE) {
-                int chance = 0;
-                switch(cover) {
-                    case COVER_LIGHT: chance = 25; break;
-                    case COVER_MEDIUM: chance = 40; break;
-                    case COVER_HEAVY: chance = 60; break;
-                    case COVER_TOTAL: chance = 90; break;
-                }
-                if (rand_int(100) < chance) {
-                    msg_print("Your shot hits the cover!");
-                    damage_cover(ny, nx, tdam);
-                    break;
-                }
-            }
-        }
+	/* Work out the flight */
+	cur_dis = missile_flight(ty, tx, tdis, &cy, &cx);
 
-		/* Advance the distance */
-		cur_dis++;
+	/* Show it */
+	missile_show(cur_dis, missile_attr, missile_char);
 
-		/* Save the new location */
-		x = nx;
-		y = ny;
+	/* Stopped by cover */
+	if (cy >= 0)
+	{
+		msg_print("Your shot hits the cover!");
+		damage_cover(cy, cx, tdam);
+	}
 
+	/* Where it ended */
+	if (cur_dis)
+	{
+		y = missile_path_y[cur_dis - 1];
+		x = missile_path_x[cur_dis - 1];
+	}
 
-		/* The player can see the (on screen) missile */
-		if (panel_contains(y, x) && player_can_see_bold(y, x))
-		{
-			/* Draw, Hilite, Fresh, Pause, Erase */
-			print_rel(missile_char, missile_attr, y, x);
-			move_cursor_relative(y, x);
-			Term_fresh();
-			Term_xtra(TERM_XTRA_DELAY, msec);
-			lite_spot(y, x);
-			Term_fresh();
-		}
+	/* Handle monster */
+	if (cur_dis && (cave_m_idx[y][x] > 0))
+	{
+		monster_type *m_ptr = &m_list[cave_m_idx[y][x]];
+		monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
-		/* The player cannot see the missile */
-		else
-		{
-			/* Pause anyway, for consistancy */
-			Term_xtra(TERM_XTRA_DELAY, msec);
-		}
+		/* Check the visibility */
+		visible = m_ptr->ml;
 
+		/* Note the collision */
+		hit_body = TRUE;
 
-		/* Handle monster */
-		if (cave_m_idx[y][x] > 0)
+		/* Did we hit it (penalize range) */
+		/* Elevation to hit */
+		if (test_hit_fire(chance - cur_dis + calc_elev_to_hit_bonus(y, x), r_ptr->ac, m_ptr->ml))
 		{
-			monster_type *m_ptr = &m_list[cave_m_idx[y][x]];
-			monster_race *r_ptr = &r_info[m_ptr->r_idx];
+			bool fear = FALSE;
 
-			/* Check the visibility */
-			visible = m_ptr->ml;
+			/* Assume a default death */
+			cptr note_dies = " dies.";
 
-			/* Note the collision */
-			hit_body = TRUE;
-
-			/* Did we hit it (penalize range) */
-			/* Elevation to hit */
-			if (test_hit_fire(chance - cur_dis + calc_elev_to_hit_bonus(y, x), r_ptr->ac, m_ptr->ml))
+			/* Some monsters get "destroyed" */
+			if ((r_ptr->flags3 & (RF3_DEMON)) ||
+				(r_ptr->flags3 & (RF3_UNDEAD)) ||
+				(r_ptr->flags2 & (RF2_STUPID)) ||
+				(strchr("Evg", r_ptr->d_char)))
 			{
-				bool fear = FALSE;
-
-				/* Assume a default death */
-				cptr note_dies = " dies.";
-
-				/* Some monsters get "destroyed" */
-				if ((r_ptr->flags3 & (RF3_DEMON)) ||
-					(r_ptr->flags3 & (RF3_UNDEAD)) ||
-					(r_ptr->flags2 & (RF2_STUPID)) ||
-					(strchr("Evg", r_ptr->d_char)))
-				{
-					/* Special note at death */
-					note_dies = " is destroyed.";
-				}
+				/* Special note at death */
+				note_dies = " is destroyed.";
+			}
 
 
-				/* Handle unseen monster */
-				if (!visible)
-				{
-					/* Invisible monster */
-					msg_format("The %s finds a mark.", o_name);
-				}
+			/* Handle unseen monster */
+			if (!visible)
+			{
+				/* Invisible monster */
+				msg_format("The %s finds a mark.", o_name);
+			}
 
-				/* Handle visible monster */
-				else
-				{
-					char m_name[80];
+			/* Handle visible monster */
+			else
+			{
+				char m_name[80];
 
-					/* Get "the monster" or "it" */
-					monster_desc(m_name, m_ptr, 0);
+				/* Get "the monster" or "it" */
+				monster_desc(m_name, m_ptr, 0);
 
-					/* Message */
-					msg_format("The %s hits %s.", o_name, m_name);
+				/* Message */
+				msg_format("The %s hits %s.", o_name, m_name);
 
-					/* Hack -- Track this monster race */
-					if (m_ptr->ml)
-						monster_race_track(m_ptr->r_idx);
+				/* Hack -- Track this monster race */
+				if (m_ptr->ml)
+					monster_race_track(m_ptr->r_idx);
 
-					/* Hack -- Track this monster */
-					if (m_ptr->ml)
-						health_track(cave_m_idx[y][x]);
-				}
+				/* Hack -- Track this monster */
+				if (m_ptr->ml)
+					health_track(cave_m_idx[y][x]);
+			}
 
-				/* Apply special damage XXX XXX XXX */
-				tdam = tot_dam_aux(o_ptr, tdam, m_ptr);
-				tdam = critical_shot(o_ptr->weight, o_ptr->to_h, tdam);
-
-                /* Cover Absorption (Target in cover) */
-                {
-                    int cover = get_cover_at(y, x);
-                    if (cover != COVER_NONE) {
-                        int absorb_percent = 0;
-                        switch(cover) {
-                            case COVER_LIGHT: absorb_percent = COVER_ABSORB_LIGHT; break;
-                            case COVER_MEDIUM: absorb_percent = COVER_ABSORB_MEDIUM; break;
-                            case COVER_HEAVY: absorb_percent = COVER_ABSORB_HEAVY; break;
-                            case COVER_TOTAL: absorb_percent = COVER_ABSORB_TOTAL; break;
-                        }
-                        int absorb = (tdam * absorb_percent) / 100;
-                        if (absorb > 0) {
-                            damage_cover(y, x, absorb);
-                            tdam -= absorb;
-                            msg_print("The cover absorbs some damage.");
-                        }
+			/* Apply special damage XXX XXX XXX */
+			tdam = tot_dam_aux(o_ptr, tdam, m_ptr);
+			tdam = critical_shot(o_ptr->weight, o_ptr->to_h, tdam);
+
+            /* Cover Absorption (Target in cover) */
+            {
+                int cover = get_cover_at(y, x);
+                if (cover != COVER_NONE) {
+                    int absorb_percent = 0;
+                    switch(cover) {
+                        case COVER_LIGHT: absorb_percent = COVER_ABSORB_LIGHT; break;
+                        case COVER_MEDIUM: absorb_percent = COVER_ABSORB_MEDIUM; break;
+                        case COVER_HEAVY: absorb_percent = COVER_ABSORB_HEAVY; break;
+                        case COVER_TOTAL: absorb_percent = COVER_ABSORB_TOTAL; break;
+                    }
+                    int absorb = (tdam * absorb_percent) / 100;
+                    if (absorb > 0) {
+                        damage_cover(y, x, absorb);
+                        tdam -= absorb;
+                        msg_print("The cover absorbs some damage.");
                     }
                 }
+            }
 
-				/* No negative damage */
-				if (tdam < 0)
-					tdam = 0;
+			/* No negative damage */
+			if (tdam < 0)
+				tdam = 0;
 
-				/* Complex message */
-				if (p_ptr->wizard)
-				{
-					msg_format("You do %d (out of %d) damage.", tdam,
-						m_ptr->hp);
-				}
+			/* Complex message */
+			if (p_ptr->wizard)
+			{
+				msg_format("You do %d (out of %d) damage.", tdam,
+					m_ptr->hp);
+			}
 
-				/* Hit the monster, check for death */
-				if (mon_take_hit(cave_m_idx[y][x], tdam, &fear, note_dies,
-						TRUE, FALSE))
-				{
-					/* Dead monster */
-				}
+			/* Hit the monster, check for death */
+			if (mon_take_hit(cave_m_idx[y][x], tdam, &fear, note_dies,
+					TRUE, FALSE))
+			{
+				/* Dead monster */
+			}
 
-				/* No death */
-				else
-				{
-					/* Message */
-					message_pain(cave_m_idx[y][x], tdam);
+			/* No death */
+			else
+			{
+				/* Message */
+				message_pain(cave_m_idx[y][x], tdam);
 
-					/* Take note */
-					if (fear && m_ptr->ml)
-					{
-						char m_name[80];
+				/* Take note */
+				if (fear && m_ptr->ml)
+				{
+					char m_name[80];
 
-						/* Sound */
-						sound(SOUND_FLEE);
+					/* Sound */
+					sound(SOUND_FLEE);
 
-						/* Get the monster name (or "it") */
-						monster_desc(m_name, m_ptr, 0);
+					/* Get the monster name (or "it") */
+					monster_desc(m_name, m_ptr, 0);
 
-						/* Message */
-						msg_format("%^s flees in terror!", m_name);
-					}
+					/* Message */
+					msg_format("%^s flees in terror!", m_name);
+				}
 
-					if (m_ptr->is_pet)
-					{
-						hostile_monsters(cave_m_idx[y][x]);
-					}
+				if (m_ptr->is_pet)
+				{
+					hostile_monsters(cave_m_idx[y][x]);
 				}
 			}
-
-			/* Stop looking */
-			break;
 		}
 	}
 
@@ -3009,7 +3095,7 @@ void do_cmd_throw(void)
 	int px = p_ptr->px;
 
 	int dir;
-	int y, x, ny, nx, ty, tx;
+	int y, x, ty, tx, cy, cx;
 	int chance, tdam, tdis;
 	int mul, div;
 	int cur_dis, visible;
@@ -3023,7 +3109,6 @@ void do_cmd_throw(void)
 
 	char o_name[80];
 
-	int msec = op_ptr->delay_factor * op_ptr->delay_factor;
 
 	/* Some objects are very easy to throw -- namely potions/flasks */
 	bool easy = FALSE;
@@ -3136,206 +3221,155 @@ void do_cmd_throw(void)
 	handle_stuff();
 
 
-	/* Travel until stopped */
-	for (cur_dis = 0; cur_dis <= tdis;)
-	{
-		/* Hack -- Stop at the target */
-		if ((y == ty) && (x == tx))
-			break;
+	/* Work out the flight */
+	cur_dis = missile_flight(ty, tx, tdis, &cy, &cx);
 
-		/* Calculate the new location (see "project()") */
-		ny = y;
-		nx = x;
-		mmove2(&ny, &nx, py, px, ty, tx);
-
-		/* Stopped by walls/doors */
-		if (!cave_floor_bold(ny, nx))
-			break;
-
-        /* Check for cover collision */
-        {
-            int cover = get_cover_at(ny, nx);
-            if (cover != COVER_NONE) {
-                int chance = 0;
-                switch(cover) {
-                    case COVER_LIGHT: chance = 25; break;
-                    case COVER_MEDIUM: chance = 40; break;
-                    case COVER_HEAVY: chance = 60; break;
-                    case COVER_TOTAL: chance = 90; break;
-                }
-                if (rand_int(100) < chance) {
-                    msg_print("Your throw hits the cover!");
-                    damage_cover(ny, nx, tdam);
-                    break;
-                }
-            }
-        }
+	/* Show it */
+	missile_show(cur_dis, missile_attr, missile_char);
 
-		/* Advance the distance */
-		cur_dis++;
+	/* Stopped by cover */
+	if (cy >= 0)
+	{
+		msg_print("Your throw hits the cover!");
+		damage_cover(cy, cx, tdam);
+	}
 
-		/* Save the new location */
-		x = nx;
-		y = ny;
+	/* Where it ended */
+	if (cur_dis)
+	{
+		y = missile_path_y[cur_dis - 1];
+		x = missile_path_x[cur_dis - 1];
+	}
 
+	/* Handle monster (``easy'' missiles don't do any damage) */
+	if (cur_dis && (cave_m_idx[y][x] > 0) && !easy)
+	{
 
-		/* The player can see the (on screen) missile */
-		if (panel_contains(y, x) && player_can_see_bold(y, x))
-		{
-			/* Draw, Hilite, Fresh, Pause, Erase */
-			print_rel(missile_char, missile_attr, y, x);
-			move_cursor_relative(y, x);
-			Term_fresh();
-			Term_xtra(TERM_XTRA_DELAY, msec);
-			lite_spot(y, x);
-			Term_fresh();
-		}
+		monster_type *m_ptr = &m_list[cave_m_idx[y][x]];
+		monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
-		/* The player cannot see the missile */
-		else
-		{
-			/* Pause anyway, for consistancy */
-			Term_xtra(TERM_XTRA_DELAY, msec);
-		}
+		/* Check the visibility */
+		visible = m_ptr->ml;
 
+		/* Note the collision */
+		hit_body = TRUE;
 
-		/* Handle monster */
-		if (cave_m_idx[y][x] > 0)
+		/* Did we hit it (penalize range) */
+		/* Elevation to hit */
+		if (test_hit_fire(chance - cur_dis + calc_elev_to_hit_bonus(y, x), r_ptr->ac, m_ptr->ml))
 		{
+			bool fear = FALSE;
 
-			monster_type *m_ptr = &m_list[cave_m_idx[y][x]];
-			monster_race *r_ptr = &r_info[m_ptr->r_idx];
-
-			/* ``Easy'' missiles don't do any damage. */
-			if (easy)
-				break;
-
-			/* Check the visibility */
-			visible = m_ptr->ml;
-
-			/* Note the collision */
-			hit_body = TRUE;
+			/* Assume a default death */
+			cptr note_dies = " dies.";
 
-			/* Did we hit it (penalize range) */
-			/* Elevation to hit */
-			if (test_hit_fire(chance - cur_dis + calc_elev_to_hit_bonus(y, x), r_ptr->ac, m_ptr->ml))
+			/* Some monsters get "destroyed" */
+			if ((r_ptr->flags3 & (RF3_DEMON)) ||
+				(r_ptr->flags3 & (RF3_UNDEAD)) ||
+				(r_ptr->flags2 & (RF2_STUPID)) ||
+				(strchr("Evg", r_ptr->d_char)))
 			{
-				bool fear = FALSE;
-
-				/* Assume a default death */
-				cptr note_dies = " dies.";
-
-				/* Some monsters get "destroyed" */
-				if ((r_ptr->flags3 & (RF3_DEMON)) ||
-					(r_ptr->flags3 & (RF3_UNDEAD)) ||
-					(r_ptr->flags2 & (RF2_STUPID)) ||
-					(strchr("Evg", r_ptr->d_char)))
-				{
-					/* Special note at death */
-					note_dies = " is destroyed.";
-				}
+				/* Special note at death */
+				note_dies = " is destroyed.";
+			}
 
 
-				/* Handle unseen monster */
-				if (!visible)
-				{
-					/* Invisible monster */
-					msg_format("The %s finds a mark.", o_name);
-				}
+			/* Handle unseen monster */
+			if (!visible)
+			{
+				/* Invisible monster */
+				msg_format("The %s finds a mark.", o_name);
+			}
 
-				/* Handle visible monster */
-				else
-				{
-					char m_name[80];
+			/* Handle visible monster */
+			else
+			{
+				char m_name[80];
 
-					/* Get "the monster" or "it" */
-					monster_desc(m_name, m_ptr, 0);
+				/* Get "the monster" or "it" */
+				monster_desc(m_name, m_ptr, 0);
 
-					/* Message */
-					msg_format("The %s hits %s.", o_name, m_name);
+				/* Message */
+				msg_format("The %s hits %s.", o_name, m_name);
 
-					/* Hack -- Track this monster race */
-					if (m_ptr->ml)
-						monster_race_track(m_ptr->r_idx);
+				/* Hack -- Track this monster race */
+				if (m_ptr->ml)
+					monster_race_track(m_ptr->r_idx);
 
-					/* Hack -- Track this monster */
-					if (m_ptr->ml)
-						health_track(cave_m_idx[y][x]);
-				}
+				/* Hack -- Track this monster */
+				if (m_ptr->ml)
+					health_track(cave_m_idx[y][x]);
+			}
 
-				/* Apply special damage XXX XXX XXX */
-				tdam = tot_dam_aux(o_ptr, tdam, m_ptr);
-				tdam = critical_shot(o_ptr->weight, o_ptr->to_h, tdam);
-
-                /* Cover Absorption */
-                {
-                    int cover = get_cover_at(y, x);
-                    if (cover != COVER_NONE) {
-                        int absorb_percent = 0;
-                        switch(cover) {
-                            case COVER_LIGHT: absorb_percent = COVER_ABSORB_LIGHT; break;
-                            case COVER_MEDIUM: absorb_percent = COVER_ABSORB_MEDIUM; break;
-                            case COVER_HEAVY: absorb_percent = COVER_ABSORB_HEAVY; break;
-                            case COVER_TOTAL: absorb_percent = COVER_ABSORB_TOTAL; break;
-                        }
-                        int absorb = (tdam * absorb_percent) / 100;
-                        if (absorb > 0) {
-                            damage_cover(y, x, absorb);
-                            tdam -= absorb;
-                            msg_print("The cover absorbs some damage.");
-                        }
+			/* Apply special damage XXX XXX XXX */
+			tdam = tot_dam_aux(o_ptr, tdam, m_ptr);
+			tdam = critical_shot(o_ptr->weight, o_ptr->to_h, tdam);
+
+            /* Cover Absorption */
+            {
+                int cover = get_cover_at(y, x);
+                if (cover != COVER_NONE) {
+                    int absorb_percent = 0;
+                    switch(cover) {
+                        case COVER_LIGHT: absorb_percent = COVER_ABSORB_LIGHT; break;
+                        case COVER_MEDIUM: absorb_percent = COVER_ABSORB_MEDIUM; break;
+                        case COVER_HEAVY: absorb_percent = COVER_ABSORB_HEAVY; break;
+                        case COVER_TOTAL: absorb_percent = COVER_ABSORB_TOTAL; break;
+                    }
+                    int absorb = (tdam * absorb_percent) / 100;
+                    if (absorb > 0) {
+                        damage_cover(y, x, absorb);
+                        tdam -= absorb;
+                        msg_print("The cover absorbs some damage.");
                     }
                 }
+            }
 
-				/* No negative damage */
-				if (tdam < 0)
-					tdam = 0;
+			/* No negative damage */
+			if (tdam < 0)
+				tdam = 0;
 
-				/* Complex message */
-				if (p_ptr->wizard)
-				{
-					msg_format("You do %d (out of %d) damage.", tdam,
-						m_ptr->hp);
-				}
+			/* Complex message */
+			if (p_ptr->wizard)
+			{
+				msg_format("You do %d (out of %d) damage.", tdam,
+					m_ptr->hp);
+			}
 
-				/* Hit the monster, check for death */
-				if (mon_take_hit(cave_m_idx[y][x], tdam, &fear, note_dies,
-						TRUE, FALSE))
-				{
-					/* Dead monster */
-				}
+			/* Hit the monster, check for death */
+			if (mon_take_hit(cave_m_idx[y][x], tdam, &fear, note_dies,
+					TRUE, FALSE))
+			{
+				/* Dead monster */
+			}
 
-				/* No death */
-				else
-				{
-					/* Message */
-					message_pain(cave_m_idx[y][x], tdam);
+			/* No death */
+			else
+			{
+				/* Message */
+				message_pain(cave_m_idx[y][x], tdam);
 
-					/* Take note */
-					if (fear && m_ptr->ml)
-					{
-						char m_name[80];
+				/* Take note */
+				if (fear && m_ptr->ml)
+				{
+					char m_name[80];
 
-						/* Sound */
-						sound(SOUND_FLEE);
+					/* Sound */
+					sound(SOUND_FLEE);
 
-						/* Get the monster name (or "it") */
-						monster_desc(m_name, m_ptr, 0);
+					/* Get the monster name (or "it") */
+					monster_desc(m_name, m_ptr, 0);
 
-						/* Message */
-						msg_format("%^s flees in terror!", m_name);
-					}
+					/* Message */
+					msg_format("%^s flees in terror!", m_name);
+				}
 
 
-					if (m_ptr->is_pet)
-					{
-						hostile_monsters(cave_m_idx[y][x]);
-					}
+				if (m_ptr->is_pet)
+				{
+					hostile_monsters(cave_m_idx[y][x]);
 				}
 			}
-
-			/* Stop looking */
-			break;
 		}
 	}
 
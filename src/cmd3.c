@@ -459,8 +459,8 @@ void do_cmd_drop(void)
 		if (near_scholar) {
 			msg_print("You hand the tome to the Scholar.");
 			msg_print("The Scholar says: 'Ah, fascinating! Give me some time to decipher this.'");
-			tome_decipher_turns = 1000;
-			tome_decipher_idx = o_ptr->pval;
+			event_cancel(EVENT_DECIPHER);
+			(void)event_post(EVENT_DECIPHER, event_ticks(1000), o_ptr->pval);
 
 			/* Remove from inventory */
 			remove_object(o_ptr);
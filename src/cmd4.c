@@ -2322,6 +2322,9 @@ void do_cmd_visuals(void)
 					f_info[f].z_char = (byte) (cc + 1);
 				if (i == 'C')
 					f_info[f].z_char = (byte) (cc - 1);
+
+				/* The map must look different now */
+				map_info_forget_all();
 			}
 		}
 
@@ -3647,6 +3650,94 @@ static int collect_monsters(int grp_cur, int mon_idx[], int mode)
 }
 
 
+/*
+ * The known races of every group, each list ending in a zero, and where
+ * each list starts and how long it is.
+ *
+ * The lists only change with the lore, which cannot change while the menu
+ * is open, so they are made once as it opens (in one pass over the races),
+ * instead of each time a group is looked at.
+ */
+static int know_mon_idx[MAX_R_IDX + 100];
+static int know_grp_start[100];
+static int know_grp_num[100];
+
+
+/*
+ * Make the lists of the known races of every group.
+ */
+static void index_monsters(void)
+{
+	int i, grp, n = 0, grp_unique = -1;
+	int char_grp[256];
+	int race_grp[MAX_R_IDX];
+
+	/* Note the group of each symbol */
+	for (i = 0; i < 256; i++) char_grp[i] = -1;
+
+	for (grp = 0; monster_group_text[grp] != NULL; grp++)
+	{
+		char *s = monster_group_char[grp];
+
+		know_grp_num[grp] = 0;
+
+		/* XXX Hack -- The "Uniques" group */
+		if (s == (char *) -1L)
+		{
+			grp_unique = grp;
+			continue;
+		}
+
+		for (; *s; s++)
+		{
+			if (char_grp[(byte)*s] < 0) char_grp[(byte)*s] = grp;
+		}
+	}
+
+	/* Count the known races of each group (skip ghost) */
+	for (i = 0; i < MAX_R_IDX - 1; i++)
+	{
+		monster_race *r_ptr = &r_info[i];
+
+		bool unique = (r_ptr->flags1 & RF1_UNIQUE) != 0;
+		bool dead = unique && (r_ptr->max_num == 0);
+
+		race_grp[i] = -1;
+
+		/* Skip empty race */
+		if (!r_ptr->name) continue;
+
+		/* Require "known" race */
+		if (!(cheat_know || dead || r_ptr->r_sights)) continue;
+
+		race_grp[i] = unique ? grp_unique : char_grp[(byte)r_ptr->d_char];
+
+		if (race_grp[i] >= 0) know_grp_num[race_grp[i]]++;
+	}
+
+	/* Make room for each list (and its zero) */
+	for (grp = 0; monster_group_text[grp] != NULL; grp++)
+	{
+		know_grp_start[grp] = n;
+		n += know_grp_num[grp];
+		know_mon_idx[n++] = 0;
+
+		/* Filled in below */
+		know_grp_num[grp] = 0;
+	}
+
+	/* Fill in the lists, in order */
+	for (i = 0; i < MAX_R_IDX - 1; i++)
+	{
+		grp = race_grp[i];
+
+		if (grp < 0) continue;
+
+		know_mon_idx[know_grp_start[grp] + know_grp_num[grp]++] = i;
+	}
+}
+
+
 /*
  * Display the monster groups.
  */
@@ -3682,7 +3773,7 @@ static void display_monster_list(int col, int row, int per_page, int mon_idx[],
 	int i;
 
 	/* Display lines until done */
-	for (i = 0; i < per_page && mon_idx[i]; i++)
+	for (i = 0; i < per_page && mon_idx[mon_top + i]; i++)
 	{
 		/* Get the race index */
 		int r_idx = mon_idx[mon_top + i];
@@ -3719,7 +3810,6 @@ static bool find_monster(int grp_cnt, int grp_idx[], int *grp_cur, int *mon_cur,
 {
 	int i, j;
 	int grp_s, grp_e, loop = 2;
-	int mon_idx[MAX_R_IDX];
 
 	/* Limits of search */
 	grp_s = (*grp_cur);
@@ -3734,7 +3824,8 @@ static bool find_monster(int grp_cnt, int grp_idx[], int *grp_cur, int *mon_cur,
 			int mon_s, mon_e;
 
 			/* Get monsters in this group */
-			int mon_cnt = collect_monsters(grp_idx[i], mon_idx, 0x00);
+			int *mon_idx = &know_mon_idx[know_grp_start[grp_idx[i]]];
+			int mon_cnt = know_grp_num[grp_idx[i]];
 
 			/* Limits of search */
 			mon_s = 0;
@@ -3803,13 +3894,20 @@ static bool find_monster(int grp_cnt, int grp_idx[], int *grp_cur, int *mon_cur,
 
 /*
  * Sanity check: Make sure every monster is in a single group.
+ *
+ * The groups and the races never change, so once is enough.
  */
 static void knowledge_monsters_sanity(void)
 {
+	static bool checked = FALSE;
+
 	int i, j, r_idx;
 	bool exists[MAX_R_IDX];
 	int mon_idx[MAX_R_IDX];
 
+	if (checked) return;
+	checked = TRUE;
+
 	/* Assume each race isn't in a group */
 	for (i = 1; i < MAX_R_IDX; i++)
 	{
@@ -3861,7 +3959,7 @@ void do_cmd_knowledge_monsters(void)
 	int grp_cur, grp_top;
 	int mon_old, mon_cur, mon_top;
 	int grp_cnt, grp_idx[100];
-	int mon_cnt, mon_idx[MAX_R_IDX];
+	int mon_cnt, *mon_idx;
 	int column = 0;
 	bool flag;
 	bool redraw;
@@ -3872,6 +3970,9 @@ void do_cmd_knowledge_monsters(void)
 	/* Sanity check */
 	knowledge_monsters_sanity();
 
+	/* Sort the known races into their groups */
+	index_monsters();
+
 	max = 0;
 	grp_cnt = 0;
 
@@ -3888,7 +3989,7 @@ void do_cmd_knowledge_monsters(void)
 		}
 
 		/* See if any monsters are known */
-		if (collect_monsters(i, mon_idx, 0x01))
+		if (know_grp_num[i])
 		{
 			/* Build a list of groups with known monsters */
 			grp_idx[grp_cnt++] = i;
@@ -3898,6 +3999,13 @@ void do_cmd_knowledge_monsters(void)
 	/* Terminate the list */
 	grp_idx[grp_cnt] = -1;
 
+	/* Nothing to show */
+	if (!grp_cnt)
+	{
+		msg_print("You know of no monsters.");
+		return;
+	}
+
 	per_page = screen_y - 9;
 
 	grp_cur = grp_top = 0;
@@ -3950,7 +4058,8 @@ void do_cmd_knowledge_monsters(void)
 		display_group_list(0, 6, max, per_page, grp_idx, grp_cur, grp_top);
 
 		/* Get a list of monsters in the current group */
-		mon_cnt = collect_monsters(grp_idx[grp_cur], mon_idx, 0x00);
+		mon_idx = &know_mon_idx[know_grp_start[grp_idx[grp_cur]]];
+		mon_cnt = know_grp_num[grp_idx[grp_cur]];
 
 		/* Display a list of monsters in the current group */
 		display_monster_list(max + 3, 6, per_page, mon_idx, mon_cur, mon_top);
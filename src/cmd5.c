@@ -55,6 +55,9 @@ void remove_spells(int *index, int i_num)
 		new_num--;
 	}
 
+	/* The dynamic spells may have moved */
+	forget_dynamic_spell_costs();
+
 	/* Fill in all the empty spots. */
 	for (i = 0; i < spell_num; i++)
 	{
@@ -1030,6 +1033,8 @@ bool cause_spell_effect(spell * s_ptr)
 	int ty = 0, tx = 0;
 	bool cast = FALSE;
 
+	fuzz_hit(FUZZ_SPELL);
+
 	while (pnode)
 	{
 		/* Hack -- Fix Telekinetic Toss type */
@@ -1643,31 +1648,68 @@ void remove_powers(byte class)
 	}
 }
 
+/*
+ * The depth and the number of spells the dynamic costs were last worked
+ * out for, and the spells which have them
+ */
+static s16b dynamic_cost_depth = -1;
+static u16b dynamic_cost_num = 0;
+static byte dynamic_cost_idx[MAX_SPELLS];
+static int dynamic_cost_n = 0;
+
+
+/*
+ * The spell list has changed, so find the dynamic spells again
+ */
+void forget_dynamic_spell_costs(void)
+{
+	dynamic_cost_depth = -1;
+}
+
+
 /*
  * Update the mana cost of dynamic spells.
+ *
+ * This only does anything when the depth or the spell list has changed
+ * (a new spell is always added at the end).
  */
 void update_dynamic_spell_costs(void)
 {
-	int i;
+	int i, mana;
 
-	for (i = 0; i < spell_num; i++)
+	if ((dynamic_cost_depth == p_ptr->depth) && (dynamic_cost_num == spell_num))
+		return;
+
+	/* Find the dynamic spells again */
+	if ((dynamic_cost_depth < 0) || (dynamic_cost_num != spell_num))
 	{
-		proj_node *pnode = spells[i].proj_list;
+		dynamic_cost_n = 0;
 
-		while (pnode)
+		for (i = 0; i < spell_num; i++)
 		{
-			if (pnode->attack_kind == GF_MAKE_PET_SCALING)
+			proj_node *pnode;
+
+			for (pnode = spells[i].proj_list; pnode; pnode = pnode->next)
 			{
-				int mana = p_ptr->depth;
+				if (pnode->attack_kind == GF_MAKE_PET_SCALING)
+				{
+					dynamic_cost_idx[dynamic_cost_n++] = i;
+					break;
+				}
+			}
+		}
+	}
 
-				if (mana < 1) mana = 1;
-				if (mana > 255) mana = 255;
+	dynamic_cost_depth = p_ptr->depth;
+	dynamic_cost_num = spell_num;
 
-				spells[i].mana = (byte)mana;
-				break;
-			}
+	mana = p_ptr->depth;
 
-			pnode = pnode->next;
-		}
+	if (mana < 1) mana = 1;
+	if (mana > 255) mana = 255;
+
+	for (i = 0; i < dynamic_cost_n; i++)
+	{
+		spells[dynamic_cost_idx[i]].mana = (byte)mana;
 	}
 }
@@ -902,6 +902,7 @@ object_type *item_effect(cptr name, cptr act, bool obvious,
 	{
 		experimental_use();
 		o_ptr->timeout = rand_int(100) + 100;
+		object_charging_n++;
 		p_ptr->window |= (PW_INVEN | PW_EQUIP);
 		return o_ptr;
 	}
@@ -917,6 +918,8 @@ object_type *item_effect(cptr name, cptr act, bool obvious,
 		if (o_ptr->timeout < 1)
 			o_ptr->timeout = 1;
 
+		object_charging_n++;
+
 		/* Window stuff */
 		p_ptr->window |= (PW_INVEN | PW_EQUIP);
 
@@ -934,6 +937,7 @@ object_type *item_effect(cptr name, cptr act, bool obvious,
 		success = cause_spell_effect(&activations[a_ptr->activation]);
 		o_ptr->timeout =
 			rand_int(a_ptr->timeout_rand) + a_ptr->timeout_static;
+		object_charging_n++;
 
 	}
 	else
@@ -941,6 +945,7 @@ object_type *item_effect(cptr name, cptr act, bool obvious,
 		success = cause_spell_effect(&activations[k_ptr->activation]);
 		o_ptr->timeout =
 			rand_int(k_ptr->timeout_rand) + k_ptr->timeout_static;
+		object_charging_n++;
 	}
 
 	/* Combine / Reorder the pack (later) */
@@ -1007,32 +1012,128 @@ static bool item_tester_hook_ingr(object_type * o_ptr)
  */
 #define MAX_RECIPE_PAGES (MAX_RECIPES / 12 + 1)
 
+/*
+ * Size of the table of recipes by ingredients (a power of two)
+ */
+#define RECIPE_HASH_SIZE 256
+
 
 /*
- * Collect the first recipe in each page.
+ * The recipe (or -1) for each hashed set of ingredients, probed in turn
  */
-int make_recipe_pages(int pages[MAX_RECIPE_PAGES], int per_page)
+static s16b recipe_hash[RECIPE_HASH_SIZE];
+
+/*
+ * The known recipes, in order, as of "recipe_known_recall[]"
+ */
+static s16b recipe_known[MAX_RECIPES];
+static int recipe_known_num = 0;
+static byte recipe_known_recall[MAX_RECIPES];
+static bool recipe_known_okay = FALSE;
+
+
+/*
+ * Hash a set of ingredients
+ */
+static int recipe_hash_index(u32b ingrs)
 {
-	int i = 0, k, page_cnt;
+	return ((int)(((ingrs * 2654435761UL) & 0xFFFFFFFFUL) >> 24) &
+		(RECIPE_HASH_SIZE - 1));
+}
 
-	/* Default to no pages */
-	page_cnt = 0;
 
-	/* Check each recipe */
+/*
+ * Index the recipes by their ingredients.
+ *
+ * The table stops at the first recipe without ingredients, and the
+ * first of several recipes with the same ingredients is the one used.
+ */
+void recipe_init(void)
+{
+	int i, h;
+
+	for (h = 0; h < RECIPE_HASH_SIZE; h++) recipe_hash[h] = -1;
+
+	for (i = 0; i < MAX_RECIPES; i++)
+	{
+		u32b ingrs = recipe_info[i].ingrs;
+
+		if (!ingrs) break;
+
+		for (h = recipe_hash_index(ingrs); recipe_hash[h] >= 0;
+			h = (h + 1) & (RECIPE_HASH_SIZE - 1))
+		{
+			if (recipe_info[recipe_hash[h]].ingrs == ingrs) break;
+		}
+
+		if (recipe_hash[h] < 0) recipe_hash[h] = i;
+	}
+}
+
+
+/*
+ * Find the recipe (or -1) made from exactly the ingredients "mask"
+ */
+static int recipe_find(u32b mask)
+{
+	int h;
+
+	for (h = recipe_hash_index(mask); recipe_hash[h] >= 0;
+		h = (h + 1) & (RECIPE_HASH_SIZE - 1))
+	{
+		if (recipe_info[recipe_hash[h]].ingrs == mask)
+			return (recipe_hash[h]);
+	}
+
+	return (-1);
+}
+
+
+/*
+ * List the known recipes, unless "recipe_recall[]" is as it was
+ */
+static void recipe_known_update(void)
+{
+	int k;
+
+	if (recipe_known_okay &&
+		!memcmp(recipe_known_recall, recipe_recall, MAX_RECIPES))
+	{
+		return;
+	}
+
+	recipe_known_num = 0;
+
 	for (k = 0; k < MAX_RECIPES; k++)
 	{
 		/* Require known recipe */
 		if (!recipe_recall[k]) continue;
 
-		/* This object is first in a page */
-		if (!(i % per_page))
-		{
-			/* Remember the first object in this page */
-			pages[page_cnt++] = k;
-		}
+		recipe_known[recipe_known_num++] = k;
+	}
+
+	(void)C_COPY(recipe_known_recall, recipe_recall, MAX_RECIPES, byte);
+	recipe_known_okay = TRUE;
+}
+
+
+/*
+ * Collect the first recipe in each page (as an index of the list of
+ * known recipes).
+ */
+int make_recipe_pages(int pages[MAX_RECIPE_PAGES], int per_page)
+{
+	int i, page_cnt;
+
+	/* Default to no pages */
+	page_cnt = 0;
+
+	recipe_known_update();
 
-		/* Count recipes */
-		++i;
+	/* Each page starts with one of the known recipes */
+	for (i = 0; i < recipe_known_num; i += per_page)
+	{
+		pages[page_cnt++] = i;
 	}
 
 	/* Terminate */
@@ -1082,13 +1183,18 @@ int show_recipe_page(int pages[MAX_RECIPE_PAGES], int page_cnt,
 		ingrs_all |= (1L << o_ptr->sval);
 	}
 
+	recipe_known_update();
+
+	/* No known recipes */
+	if (pages[page_cur] < 0) return (0);
+
 	/* Check each recipe on this page */
-	for (k = pages[page_cur]; k < MAX_RECIPES; k++)
+	for (i = pages[page_cur]; i < recipe_known_num; i++)
 	{
 		byte a = TERM_WHITE;
+		int j;
 
-		/* Require known recipe */
-		if (!recipe_recall[k]) continue;
+		k = recipe_known[i];
 
 		/* Get the ingredients */
 		ingrs = recipe_info[k].ingrs;
@@ -1119,20 +1225,20 @@ int show_recipe_page(int pages[MAX_RECIPE_PAGES], int page_cnt,
 		x = 45;
 
 		/* Check each possible ingredient */
-		for (i = 0; i < 16; i++)
+		for (j = 0; j < 16; j++)
 		{
 			/* This ingredient is in the recipe */
-			if (ingrs & (1L << i))
+			if (ingrs & (1L << j))
 			{
 				byte a = TERM_WHITE;
-				cptr s = ingr_short_names[i];
+				cptr s = ingr_short_names[j];
 
 				/* The ingredient was mixed */
-				if (mask & (1L << i))
+				if (mask & (1L << j))
 					a = TERM_L_GREEN;
 
 				/* This ingredient is available */
-				else if (ingrs_all & (1L << i))
+				else if (ingrs_all & (1L << j))
 					a = TERM_L_BLUE;
 
 				/* Display ingredient */
@@ -1159,22 +1265,15 @@ int show_recipe_page(int pages[MAX_RECIPE_PAGES], int page_cnt,
 static void do_cmd_brew_stuff_aux(u32b mask, int boost)
 {
 	int i, level;
-	u32b ingrs;
 	bool made_ok;
 
 
 	made_ok = FALSE;
 
-	for (i = 0; i < MAX_RECIPES; i++)
-	{
-		ingrs = recipe_info[i].ingrs;
-
-		if (ingrs == 0)
-			break;
-
-		if (mask != ingrs)
-			continue;
+	i = recipe_find(mask);
 
+	if (i >= 0)
+	{
 		level = (k_info[recipe_info[i].result_kind].level / 2) + boost;
 
 		/* All items should be possible */
@@ -1579,25 +1678,19 @@ void do_cmd_sacrifice(void)
 void do_cmd_cli(void)
 {
 	char buff[80];
-	int i;
+	cli_comm *cli_ptr;
 
 	strcpy(buff, "");
 
 	if (!get_string_cli("Command: ", buff, 30))
 		return;
 
-	for (i = 0; i < MAX_COMMANDS && cli_info[i].comm1; i++)
+	cli_ptr = cli_find(buff);
+
+	if (cli_ptr)
 	{
-		if (!strcmp(buff, cli_info[i].comm1))
-		{
-			cli_info[i].func();
-			return;
-		}
-		else if (cli_info[i].comm2 && !strcmp(buff, cli_info[i].comm2))
-		{
-			cli_info[i].func();
-			return;
-		}
+		cli_ptr->func();
+		return;
 	}
 
 	mformat(MSG_TEMP, "No such command: %s", buff);
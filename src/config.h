@@ -398,6 +398,77 @@
 # define SAVEFILE_USE_UID
 #endif
 
+/*
+ * OPTION: Memory budget (in bytes) for recently left levels, which are
+ * only written to disk once they no longer fit (see "save_dungeon()").
+ * Set it to zero to always use the disk.
+ */
+#define LEVEL_CACHE_BUDGET	(4L * 1024L * 1024L)
+
+
+/*
+ * OPTION: The most times a second the screen is refreshed while the game
+ * runs on by itself (running, resting, repeated commands).  See the
+ * "fresh_limited()" function.
+ */
+#define FRESH_MAX_FPS	30
+
+/*
+ * OPTION: The most times a second each kind of subwindow (inventory,
+ * character, recall, ...) is redrawn.  See "window_stuff()".
+ */
+#define WINDOW_MAX_FPS	10
+
+
+/*
+ * OPTION: How often, in milliseconds, the metrics of a headless game are
+ * written out, and (by default) how often their memory use is sampled.
+ * See "metrics.c".
+ */
+#define METRIC_FLUSH_MSEC	5000
+#define METRIC_RSS_MSEC		1000
+
+
+/*
+ * OPTION: On Unix machines, parse the template files (in "lib/edit")
+ * at the same time, one forked copy of the game per file, so that their
+ * binary image files are rebuilt quickly after the data changes.
+ */
+#ifdef SET_UID
+# define FORK_TEMPLATES
+#endif
+
+
+/*
+ * OPTION: On Unix machines, map the binary image files ("*.raw") into
+ * memory and use their tables in place instead of reading them into
+ * freshly allocated arrays.  Only the pages which are used get loaded,
+ * and only the pages which are changed get copied.
+ */
+#ifdef SET_UID
+# define MAP_RAW_FILES
+#endif
+
+
+/*
+ * OPTION: On Unix machines, keep the lines of the last few help files
+ * shown in memory, and show them again from there for as long as the
+ * file keeps its size and modification time.
+ */
+#ifdef SET_UID
+# define CACHE_HELP_FILES
+#endif
+
+
+/*
+ * OPTION: On Unix machines, write savefiles from a forked copy of the
+ * game, so that play goes on while the file is written (the copy is a
+ * free snapshot of the whole game state).
+ */
+#ifdef SET_UID
+# define SAVE_BACKGROUND
+#endif
+
 
 /*
  * OPTION: Check the "time" against "lib/file/hours.txt"
@@ -454,6 +525,13 @@
 #define DEFAULT_X11_FONT_RECALL		DEFAULT_X11_FONT
 #define DEFAULT_X11_FONT_CHOICE		DEFAULT_X11_FONT
 
+/*
+ * OPTION: Let the "-b" option of "main-x11.c" (draw into client-side
+ * framebuffers) use the MIT-SHM extension when the X server is local.
+ * Requires linking with "-lXext".
+ */
+/* #define USE_XSHM */
+
 
 
 /*
@@ -0,0 +1,386 @@
+/* File: connect.c */
+
+/*
+ * Connected components for the level generator
+ *
+ * A union-find over the grids of a rectangular window, which lets the
+ * generator label every region of a sector in one pass instead of
+ * flood-filling it over and over.  Regions can be grown one grid at a
+ * time (after carving a bridge) without relabelling anything, and the
+ * shortest bridge between the "first" region and all the others can be
+ * found from the region borders alone.
+ *
+ * Only one window is labelled at a time.
+ */
+
+#include "angband.h"
+
+
+/*
+ * The current window
+ */
+static int conn_y1, conn_x1;
+static int conn_hgt, conn_wid;
+static int conn_mode;
+
+/*
+ * The union-find forest (one node per grid of the window).  A node
+ * which is not part of any region is its own parent with size zero.
+ */
+static s16b conn_parent[CONNECT_MAX_GRIDS];
+static s16b conn_size[CONNECT_MAX_GRIDS];
+
+/*
+ * Number of separate regions in the window
+ */
+static int conn_count;
+
+/*
+ * Scratch lists of border grids (see "connect_bridge()")
+ */
+static s16b conn_border_a[CONNECT_MAX_GRIDS];
+static s16b conn_border_b[CONNECT_MAX_GRIDS];
+
+/*
+ * First entry of each row in "conn_border_b[]"
+ */
+static s16b conn_row_b[CONNECT_MAX_GRIDS + 1];
+
+
+/*
+ * Index of a grid inside the window
+ */
+#define CONN_IDX(Y, X) \
+    (((Y) - conn_y1) * conn_wid + ((X) - conn_x1))
+
+/*
+ * Is (y, x) inside the window?
+ */
+#define CONN_INSIDE(Y, X) \
+    (((Y) >= conn_y1) && ((Y) < conn_y1 + conn_hgt) && \
+     ((X) >= conn_x1) && ((X) < conn_x1 + conn_wid))
+
+
+/*
+ * Find the root of a node, compressing the path
+ */
+static int connect_root(int i)
+{
+    int r = i;
+
+    while (conn_parent[r] != r) r = conn_parent[r];
+
+    while (conn_parent[i] != r) {
+        int next = conn_parent[i];
+        conn_parent[i] = r;
+        i = next;
+    }
+
+    return (r);
+}
+
+
+/*
+ * Merge the regions of two nodes
+ */
+static void connect_union(int a, int b)
+{
+    a = connect_root(a);
+    b = connect_root(b);
+
+    if (a == b) return;
+
+    /* Hang the smaller tree under the larger */
+    if (conn_size[a] < conn_size[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+
+    conn_parent[b] = a;
+    conn_size[a] += conn_size[b];
+
+    conn_count--;
+}
+
+
+/*
+ * Does a grid belong to some region?
+ */
+static bool connect_member(int y, int x)
+{
+    switch (conn_mode) {
+        case CONNECT_FLOOR:
+            return (cave_floor_bold(y, x));
+
+        case CONNECT_ELEV:
+        {
+            int elev = get_elevation(y, x);
+            return ((elev == ELEV_HIGH) || (elev == ELEV_LOW));
+        }
+
+        case CONNECT_WALK:
+            return (cave_floor_bold(y, x));
+    }
+
+    return (FALSE);
+}
+
+
+/*
+ * Are two neighbouring member grids part of the same region?
+ */
+static bool connect_joined(int y1, int x1, int y2, int x2)
+{
+    switch (conn_mode) {
+        case CONNECT_FLOOR:
+            return ((y1 == y2) || (x1 == x2));
+
+        case CONNECT_ELEV:
+            return (get_elevation(y1, x1) == get_elevation(y2, x2));
+
+        case CONNECT_WALK:
+            return (elev_allows_move(y1, x1, y2, x2, FALSE) &&
+                    elev_allows_move(y2, x2, y1, x1, FALSE));
+    }
+
+    return (FALSE);
+}
+
+
+/*
+ * Add a member grid to the forest and join it to its neighbours
+ */
+static void connect_insert(int y, int x)
+{
+    int i = CONN_IDX(y, x);
+    int d;
+
+    /* Already a member */
+    if (conn_size[connect_root(i)]) return;
+
+    conn_parent[i] = i;
+    conn_size[i] = 1;
+    conn_count++;
+
+    for (d = 0; d < 8; d++) {
+        int ny = y + ddy_ddd[d];
+        int nx = x + ddx_ddd[d];
+        int j;
+
+        if (!CONN_INSIDE(ny, nx)) continue;
+
+        j = CONN_IDX(ny, nx);
+
+        /* Not a member (yet) */
+        if (!conn_size[connect_root(j)]) continue;
+
+        if (!connect_joined(y, x, ny, nx)) continue;
+
+        connect_union(i, j);
+    }
+}
+
+
+/*
+ * Label every region of the window (y1,x1)-(y2,x2).
+ *
+ * CONNECT_FLOOR joins floor grids orthogonally, CONNECT_ELEV joins
+ * raised or sunken grids of the same height in all eight directions,
+ * and CONNECT_WALK joins floor grids a monster could walk between in
+ * either direction.
+ *
+ * Returns the number of regions found.
+ */
+int connect_label(int y1, int x1, int y2, int x2, int mode)
+{
+    int y, x, i;
+
+    /* Clip to the dungeon */
+    if (y1 < 0) y1 = 0;
+    if (x1 < 0) x1 = 0;
+    if (y2 > DUNGEON_HGT - 1) y2 = DUNGEON_HGT - 1;
+    if (x2 > DUNGEON_WID - 1) x2 = DUNGEON_WID - 1;
+
+    conn_y1 = y1;
+    conn_x1 = x1;
+    conn_hgt = y2 - y1 + 1;
+    conn_wid = x2 - x1 + 1;
+    conn_mode = mode;
+
+    /* Clip to the forest */
+    while (conn_hgt * conn_wid > CONNECT_MAX_GRIDS) conn_hgt--;
+
+    /* No regions yet */
+    for (i = 0; i < conn_hgt * conn_wid; i++) {
+        conn_parent[i] = i;
+        conn_size[i] = 0;
+    }
+
+    conn_count = 0;
+
+    /* Add every member grid */
+    for (y = conn_y1; y < conn_y1 + conn_hgt; y++) {
+        for (x = conn_x1; x < conn_x1 + conn_wid; x++) {
+            if (connect_member(y, x)) connect_insert(y, x);
+        }
+    }
+
+    return (conn_count);
+}
+
+
+/*
+ * Note that (y,x) has just become a member grid (a bridge was carved),
+ * merging it into the neighbouring regions.
+ *
+ * Returns the new number of regions.
+ */
+int connect_add(int y, int x)
+{
+    if (CONN_INSIDE(y, x) && connect_member(y, x)) connect_insert(y, x);
+
+    return (conn_count);
+}
+
+
+/*
+ * Get the region of a grid, or -1 if the grid is not a member.
+ *
+ * Two grids are in the same region if and only if they have the same
+ * region number.
+ */
+int connect_region(int y, int x)
+{
+    int r;
+
+    if (!CONN_INSIDE(y, x)) return (-1);
+
+    r = connect_root(CONN_IDX(y, x));
+
+    if (!conn_size[r]) return (-1);
+
+    return (r);
+}
+
+
+/*
+ * Get the number of grids in the region of a grid
+ */
+int connect_region_size(int y, int x)
+{
+    int r = connect_region(y, x);
+
+    if (r < 0) return (0);
+
+    return (conn_size[r]);
+}
+
+
+/*
+ * Find the shortest straight bridge between the "first" region (the one
+ * holding the first member grid in row order) and any other region.
+ *
+ * The closest pair of grids between two sets of grids always lies on
+ * their borders (a grid with a neighbour in its own set on the way to
+ * the other set cannot be the closest), so only border grids need to be
+ * compared.  Ties go to the first pair in row order, as if every pair
+ * of grids had been compared.
+ *
+ * Returns FALSE if the window holds fewer than two regions.
+ */
+bool connect_bridge(int *ay, int *ax, int *by, int *bx)
+{
+    int na = 0, nb = 0;
+    int first = -1;
+    int i, j, y, x, d;
+    long best = 0x7FFFFFFFL;
+
+    if (conn_count < 2) return (FALSE);
+
+    /* Collect the border grids */
+    for (y = conn_y1; y < conn_y1 + conn_hgt; y++) {
+        for (x = conn_x1; x < conn_x1 + conn_wid; x++) {
+            int r = connect_region(y, x);
+            bool in_a, border = FALSE;
+
+            if (r < 0) continue;
+
+            /* The first region */
+            if (first < 0) first = r;
+
+            in_a = (r == first);
+
+            /* Look for a neighbour outside this set */
+            for (d = 0; d < 4; d++) {
+                int ny = y + ddy_ddd[d];
+                int nx = x + ddx_ddd[d];
+                int nr;
+
+                if (!CONN_INSIDE(ny, nx)) continue;
+
+                nr = connect_region(ny, nx);
+
+                if (in_a ? (nr != first) : ((nr < 0) || (nr == first))) {
+                    border = TRUE;
+                    break;
+                }
+            }
+
+            if (!border) continue;
+
+            if (in_a) conn_border_a[na++] = CONN_IDX(y, x);
+            else conn_border_b[nb++] = CONN_IDX(y, x);
+        }
+    }
+
+    /* Index the borders of the other regions by row */
+    for (i = 0, j = 0; i <= conn_hgt; i++) {
+        while ((j < nb) && (conn_border_b[j] / conn_wid < i)) j++;
+        conn_row_b[i] = j;
+    }
+
+    /* Compare the borders */
+    for (i = 0; i < na; i++) {
+        int y1 = conn_border_a[i] / conn_wid;
+        int x1 = conn_border_a[i] % conn_wid;
+        long best_a = 0x7FFFFFFFL;
+        int best_j = -1;
+
+        /* Search outwards from the row of "a" until no row can be closer */
+        for (d = 0; d < conn_hgt; d++) {
+            int side;
+
+            if ((long)d * d > best_a) break;
+
+            for (side = 0; side < 2; side++) {
+                int r = side ? (y1 + d) : (y1 - d);
+
+                if ((side == 1) && (d == 0)) continue;
+                if ((r < 0) || (r >= conn_hgt)) continue;
+
+                for (j = conn_row_b[r]; j < conn_row_b[r + 1]; j++) {
+                    int dy = y1 - r;
+                    int dx = x1 - conn_border_b[j] % conn_wid;
+                    long dist = (long)dy * dy + (long)dx * dx;
+
+                    /* Ties go to the first grid in row order */
+                    if ((dist < best_a) || ((dist == best_a) && (j < best_j))) {
+                        best_a = dist;
+                        best_j = j;
+                    }
+                }
+            }
+        }
+
+        if (best_a < best) {
+            best = best_a;
+            *ay = conn_y1 + y1;
+            *ax = conn_x1 + x1;
+            *by = conn_y1 + conn_border_b[best_j] / conn_wid;
+            *bx = conn_x1 + conn_border_b[best_j] % conn_wid;
+        }
+    }
+
+    return (best != 0x7FFFFFFFL);
+}
@@ -7,21 +7,167 @@
 
 #include "angband.h"
 
+/*
+ * The destructible cover is kept in a small table (see "cave_cover"),
+ * hashed by grid, with linear probing.  A slot with a "grid" of zero is
+ * empty; otherwise "grid" is the grid number (y * DUNGEON_WID + x) plus
+ * one.  No more than COVER_FULL slots are used, so a probe always ends.
+ */
+
+
+/*
+ * The slot to look at first for grid "g"
+ */
+static int cover_hash(s32b g)
+{
+    return (int)((((u32b)g) * 2654435761UL) >> 16) & (COVER_SLOTS - 1);
+}
+
+
+/*
+ * The slot of the cover at a location, or -1 if there is none
+ */
+static int cover_slot(int y, int x)
+{
+    s32b g = y * DUNGEON_WID + x + 1;
+    int i = cover_hash(g);
+
+    while (cave_cover[i].grid)
+    {
+        if (cave_cover[i].grid == g) return (i);
+
+        i = (i + 1) & (COVER_SLOTS - 1);
+    }
+
+    return (-1);
+}
+
+
+/*
+ * The cover at a location, or NULL if there is none
+ */
+static cover_data *cover_find(int y, int x)
+{
+    int i = cover_slot(y, x);
+
+    if (i < 0) return (NULL);
+
+    return (&cave_cover[i]);
+}
+
+
+/*
+ * Add (or replace) the cover at a location
+ *
+ * Returns NULL if the table is full.
+ */
+static cover_data *cover_add(int y, int x)
+{
+    s32b g = y * DUNGEON_WID + x + 1;
+    int i = cover_hash(g);
+
+    while (cave_cover[i].grid)
+    {
+        if (cave_cover[i].grid == g) return (&cave_cover[i]);
+
+        i = (i + 1) & (COVER_SLOTS - 1);
+    }
+
+    /* Full */
+    if (cave_cover_n >= COVER_FULL) return (NULL);
+
+    cave_cover_n++;
+
+    WIPE(&cave_cover[i], cover_data);
+    cave_cover[i].grid = g;
+
+    return (&cave_cover[i]);
+}
+
+
+/*
+ * Remove the cover at a location (if any)
+ */
+static void cover_remove(int y, int x)
+{
+    int i = cover_slot(y, x);
+    int j;
+
+    if (i < 0) return;
+
+    cave_cover_n--;
+
+    /* Move back any later cover which would no longer be found */
+    for (j = (i + 1) & (COVER_SLOTS - 1); cave_cover[j].grid;
+         j = (j + 1) & (COVER_SLOTS - 1))
+    {
+        int k = cover_hash(cave_cover[j].grid);
+
+        /* Its first slot lies (cyclically) in (i, j] */
+        if (((j > i) && (k > i) && (k <= j)) ||
+            ((j < i) && ((k > i) || (k <= j)))) continue;
+
+        COPY(&cave_cover[i], &cave_cover[j], cover_data);
+        i = j;
+    }
+
+    cave_cover[i].grid = 0;
+}
+
+
 /*
  * Initialize cover system
  */
 void init_cover_system(void)
 {
-    int y, x;
-    for (y = 0; y < DUNGEON_HGT; y++) {
-        for (x = 0; x < DUNGEON_WID; x++) {
-            if (cave_cover[y][x]) {
-                KILL(cave_cover[y][x], cover_data);
-            }
-        }
-    }
+    C_WIPE(cave_cover, COVER_SLOTS, cover_data);
+    cave_cover_n = 0;
 }
 
+
+/*
+ * Number of cover records (for the savefile)
+ */
+int cover_count(void)
+{
+    return (cave_cover_n);
+}
+
+
+/*
+ * The cover record in slot "i" (for the savefile), or NULL if empty
+ */
+cover_data *cover_at_slot(int i)
+{
+    if (!cave_cover[i].grid) return (NULL);
+
+    return (&cave_cover[i]);
+}
+
+
+/*
+ * Restore a cover record (from the savefile), without touching the grid
+ *
+ * Returns FALSE if the location is invalid or the table is full.
+ */
+bool cover_restore(int y, int x, int cover_type, int durability, int max_durability, int feat)
+{
+    cover_data *cv_ptr;
+
+    if (!in_bounds(y, x)) return (FALSE);
+
+    cv_ptr = cover_add(y, x);
+    if (!cv_ptr) return (FALSE);
+
+    cv_ptr->durability = durability;
+    cv_ptr->max_durability = max_durability;
+    cv_ptr->cover_type = cover_type;
+    cv_ptr->terrain_feat = feat;
+
+    return (TRUE);
+}
+
+
 /*
  * Create cover at location
  */
@@ -29,15 +175,11 @@ void create_cover_at(int y, int x, int cover_type, int durability, int feat)
 {
     if (!in_bounds(y, x)) return;
 
-    if (cave_cover[y][x] != NULL) {
-        KILL(cave_cover[y][x], cover_data);
-    }
+    /* The grid may look different */
+    map_info_forget(y, x);
 
-    MAKE(cave_cover[y][x], cover_data);
-    cave_cover[y][x]->durability = durability;
-    cave_cover[y][x]->max_durability = durability;
-    cave_cover[y][x]->cover_type = cover_type;
-    cave_cover[y][x]->terrain_feat = feat;
+    /* Note the cover (if there is too much, the feature alone will do) */
+    (void)cover_restore(y, x, cover_type, durability, durability, feat);
 
     cave_set_feat(y, x, feat);
 }
@@ -49,9 +191,10 @@ void destroy_cover(int y, int x)
 {
     if (!in_bounds(y, x)) return;
 
-    if (cave_cover[y][x] != NULL) {
-        KILL(cave_cover[y][x], cover_data);
-    }
+    /* The grid may look different */
+    map_info_forget(y, x);
+
+    cover_remove(y, x);
 
     msg_print("The cover is destroyed!");
     cave_set_feat(y, x, FEAT_FLOOR);
@@ -62,14 +205,16 @@ void destroy_cover(int y, int x)
  */
 int get_cover_at(int y, int x)
 {
+    cover_data *cv_ptr;
     int feat;
 
     if (!in_bounds(y, x)) return COVER_NONE;
 
-    /* Check for destructible cover first */
-    if (cave_cover[y][x] != NULL) {
-        if (cave_cover[y][x]->durability > 0) {
-            return cave_cover[y][x]->cover_type;
+    /* Check for destructible cover first (if there is any) */
+    cv_ptr = (cave_cover_n ? cover_find(y, x) : NULL);
+    if (cv_ptr != NULL) {
+        if (cv_ptr->durability > 0) {
+            return cv_ptr->cover_type;
         }
         /* Cover destroyed */
         return COVER_NONE;
@@ -139,16 +284,16 @@ int get_cover_vs_direction(int ty, int tx, int ay, int ax)
 
         if (!in_bounds(y, x)) continue;
 
-        int cover = get_cover_at(y, x);
+        int feat = cave_feat[y][x];
 
         /* Fog only helps if you're IN it, not behind it */
-        if (cave_feat[y][x] == FEAT_FOG ||
-            cave_feat[y][x] == FEAT_FOG_DENSE ||
-            cave_feat[y][x] == FEAT_SMOKE) {
+        if (feat == FEAT_FOG || feat == FEAT_FOG_DENSE || feat == FEAT_SMOKE) {
             /* Fog doesn't block line of sight for cover, just provides concealment */
             continue;
         }
 
+        int cover = get_cover_at(y, x);
+
         if (cover > best_cover) {
             best_cover = cover;
         }
@@ -243,10 +388,15 @@ static bool is_attack_blocked_by_cover(int ty, int tx, int ay, int ax)
  */
 void damage_cover(int y, int x, int damage)
 {
+    cover_data *cv_ptr;
+
     if (!in_bounds(y, x)) return;
 
     int feat = cave_feat[y][x];
 
+    /* The grid may look different */
+    map_info_forget(y, x);
+
     /* Special: Barrels explode! */
     if (feat == FEAT_BARREL) {
         msg_print("The barrel explodes!");
@@ -259,12 +409,13 @@ void damage_cover(int y, int x, int damage)
     }
 
     /* Check for destructible cover data */
-    if (cave_cover[y][x] != NULL) {
-        cave_cover[y][x]->durability -= damage;
+    cv_ptr = cover_find(y, x);
+    if (cv_ptr != NULL) {
+        cv_ptr->durability -= damage;
 
-        if (cave_cover[y][x]->durability <= 0) {
+        if (cv_ptr->durability <= 0) {
             destroy_cover(y, x);
-        } else if (cave_cover[y][x]->durability < cave_cover[y][x]->max_durability / 4) {
+        } else if (cv_ptr->durability < cv_ptr->max_durability / 4) {
             /* Cover nearly destroyed */
             /* Only print if player can see */
             if (player_has_los_bold(y, x))
@@ -286,11 +437,8 @@ void damage_cover(int y, int x, int damage)
 
     /* Crates break easily */
     if (feat == FEAT_CRATE) {
-        MAKE(cave_cover[y][x], cover_data);
-        cave_cover[y][x]->durability = 20;
-        cave_cover[y][x]->max_durability = 20;
-        cave_cover[y][x]->cover_type = COVER_LIGHT;
-        cave_cover[y][x]->terrain_feat = FEAT_CRATE;
+        /* Too much cover -- the crate is left alone */
+        if (!cover_restore(y, x, COVER_LIGHT, 20, 20, FEAT_CRATE)) return;
 
         damage_cover(y, x, damage); /* Apply damage */
     }
@@ -47,7 +47,24 @@
 
 #define KAM_VERSION_MAJOR 2
 #define KAM_VERSION_MINOR 1
-#define KAM_VERSION_PATCH 10
+#define KAM_VERSION_PATCH 14
+
+/*
+ * Savefile grid layers (see "wr_dungeon()")
+ *
+ * Each layer is written as one packed chunk.  The layout is flagged by
+ * a zero byte where the older layout had its first run-length count.
+ */
+#define GRID_LAYER_VERSION	1
+
+#define GRID_LAYER_INFO_LO	1	/* Low byte of cave_info */
+#define GRID_LAYER_INFO_HI	2	/* High byte of cave_info */
+#define GRID_LAYER_ELEV		3	/* Elevation */
+#define GRID_LAYER_FUEL_LO	4	/* Low byte of fire fuel */
+#define GRID_LAYER_FUEL_HI	5	/* High byte of fire fuel */
+#define GRID_LAYER_FEAT		6	/* cave_feat */
+#define GRID_LAYER_SECTOR	7	/* cave_sector */
+#define GRID_LAYER_MAX		7
 
 /*
  * Sector Types
@@ -183,7 +200,8 @@
 
 #define MAX_COMMANDS 100
 
-#define MAX_PROJECT_GRIDS  DUNGEON_WID*DUNGEON_HGT
+#define MAX_PROJECT_GRIDS  (DUNGEON_WID*DUNGEON_HGT)
+#define PROJECT_GRIDS_MIN  256	/* First size of the list of projected grids */
 
 /*
  * Total number of stores (see "store.c", etc)
@@ -231,6 +249,23 @@
 #define MAX_O_IDX		1024	/* Max size for "o_list[]" */
 #define MAX_M_IDX		2048	/* Max size for "m_list[]" */
 
+/*
+ * Objects made at a time (see "object_alloc()")
+ */
+#define OBJECT_SLAB		256
+
+/*
+ * Awake monsters further than this from the player (and out of their
+ * detection range) only get the cheap "dormant" turn (see "melee2.c")
+ */
+#define MONSTER_DORMANT_DIST	100
+
+/*
+ * The monster bucket grid (see "monster2.c") has one bucket per block
+ */
+#define MON_BUCKET_ROWS	((DUNGEON_HGT + BLOCK_HGT - 1) / BLOCK_HGT)
+#define MON_BUCKET_COLS	((DUNGEON_WID + BLOCK_WID - 1) / BLOCK_WID)
+
 
 /*
  * Maximum number of quests. Note, however, that a quest is just
@@ -286,6 +321,59 @@
  */
 #define TEMP_MAX		4096
 
+/*
+ * Ranges this short are finished by "ang_sort()" with an insertion sort
+ */
+#define ANG_SORT_SHORT		12
+
+/*
+ * Maximum size of the "environment-active" grid list (see "cave.c")
+ * Every grid on the map may be burning at once, so we are as large
+ * as the map itself.
+ */
+#define ENV_ACTIVE_MAX		(DUNGEON_HGT * DUNGEON_WID)
+
+/*
+ * Maximum size of the notable-feature grid list (see "cave.c")
+ */
+#define NOTE_GRID_MAX		(DUNGEON_HGT * DUNGEON_WID)
+
+/*
+ * Maximum number of scheduled events (see "event.c")
+ */
+#define EVENT_MAX		32
+
+/*
+ * Kinds of scheduled events
+ */
+#define EVENT_RECALL	1	/* Word of recall activates */
+#define EVENT_DECIPHER	2	/* The Scholar finishes a tome (data: lore) */
+
+/*
+ * Maximum number of shifting maze walls per level (see "dungeon.c")
+ * A shifting maze sector holds at most a few hundred walls, and there
+ * are never more than a handful of such sectors on a level.
+ */
+#define ACTIVE_WALL_MAX		8192
+
+/*
+ * Maximum number of dark maze sectors per level (see "cave.c")
+ * There are only about four hundred 2x2 block sectors on a level.
+ */
+#define DARK_SECTOR_MAX		512
+
+/*
+ * Maximum number of rolling boulders per level (see "dungeon.c")
+ * Only a trap sets a boulder rolling, and it rolls until it hits something.
+ */
+#define BOULDER_MAX		256
+
+/*
+ * Maximum number of sanctum doors per level (see "sanctum.c")
+ * Each sanctum vault has one, and a level rarely has more than one vault.
+ */
+#define SANCTUM_DOOR_MAX	16
+
 
 /*
  * OPTION: Maximum number of macros (see "io.c")
@@ -299,18 +387,23 @@
  */
 #define QUARK_MAX		512
 
+/*
+ * Slots in the hash table of "quarks" (a power of two, above QUARK_MAX)
+ */
+#define QUARK_HASH		1024
+
 /*
  * OPTION: Maximum number of messages to remember (see "io.c")
  * Default: assume maximal memorization of 2048 total messages
+ * (this must be a power of two)
  */
 #define MESSAGE_MAX	2048
 
 /*
- * OPTION: Maximum space for the message text buffer (see "io.c")
- * Default: assume that each of the 2048 messages is repeated an
- * average of three times, and has an average length of 48
+ * OPTION: Maximum length of a remembered message, plus one (see "io.c")
+ * Default: what the savefile has always kept
  */
-#define MESSAGE_BUF	32768
+#define MESSAGE_LEN	128
 
 
 /*
@@ -329,6 +422,7 @@
  */
 #define STORE_SHUFFLE		25 /* 1/Chance (per day) of an owner changing */
 #define STORE_TURNS		1000 /* Number of turns between turnovers */
+#define STORE_MAINT_MAX		10 /* Most turnovers made up on entering a shop */
 
 
 /*
@@ -339,12 +433,204 @@
 /*
  * Monster patrol and guard system
  */
+#define MAX_GUARDS              512     /* Max size for guard data */
 #define PATROL_MAX_WAYPOINTS    8       /* Max points in patrol route */
 #define PATROL_RADIUS           6       /* Default patrol radius */
 #define GUARD_ALERT_RADIUS      12      /* Distance to alert other guards */
 #define GUARD_CHASE_TIMEOUT     100     /* Turns before returning to post */
 #define PATROL_REST_TURNS       20      /* Rest at waypoint before moving */
 
+/*
+ * Flow field service (see "flow.c")
+ */
+#define FLOW_FIELD_MAX          64      /* Cached fields per level */
+#define FLOW_FIELD_DEPTH        32      /* Max steps covered by a field */
+#define FLOW_FIELD_SIZE         (2 * FLOW_FIELD_DEPTH + 1) /* Window side */
+#define FLOW_COST_NONE          255     /* Grid cannot reach the source */
+
+/*
+ * Scent trail of the player (see "flow.c")
+ */
+#define SCENT_MAX               256     /* Steps remembered */
+#define SCENT_HASH              1024    /* Slots of the grid index (a power of two) */
+#define SCENT_FRESH             1000    /* Game turns before a step goes cold */
+
+/*
+ * Sector routes (see "flow.c"), over sectors of BLOCK_HGT by BLOCK_WID
+ */
+#define SECTOR_ROWS     ((DUNGEON_HGT + BLOCK_HGT - 1) / BLOCK_HGT)
+#define SECTOR_COLS     ((DUNGEON_WID + BLOCK_WID - 1) / BLOCK_WID)
+#define SECTOR_ROUTE_MAX        16      /* Cached routes per level */
+#define SECTOR_NONE             255     /* Sector cannot reach the goal */
+
+/*
+ * Metrics of headless games (see "metrics.c")
+ */
+#define METRIC_MAX_EVENTS       64      /* Kinds of event */
+#define METRIC_BUCKETS          32      /* Buckets of each histogram */
+
+/*
+ * Hot-path timers (see "metric_start()")
+ */
+#define METRIC_T_PROCESS_WORLD          0
+#define METRIC_T_PROCESS_ENVIRONMENT    1
+#define METRIC_T_PROCESS_ACTIVE_TERRAIN 2
+#define METRIC_T_PROCESS_DREAD          3
+#define METRIC_T_PROCESS_MONSTERS       4
+#define METRIC_T_UPDATE_VIEW            5
+#define METRIC_T_UPDATE_LITE            6
+#define METRIC_T_UPDATE_FLOW            7
+#define METRIC_T_UPDATE_MONSTERS        8
+#define METRIC_T_PROJECT                9
+#define METRIC_T_HANDLE_STUFF           10
+#define METRIC_T_GET_MOVES              11
+#define METRIC_T_GET_MOVES_TARGET       12
+#define METRIC_T_GET_MOVES_ROUTE        13
+#define METRIC_T_PROCESS_TERRAIN        14
+#define METRIC_TIMERS                   15
+
+/*
+ * Headless benchmarks (see "bench.c")
+ */
+#define BENCH_SWARM             1900    /* Monsters in the swarm */
+#define BENCH_OIL_RAD           10      /* Half height of the oil field */
+#define BENCH_MAZE_RAD          10      /* Half height of the maze */
+#define BENCH_KERNEL_CALLS      1000    /* Calls to time per kernel sample */
+#define BENCH_ARENA_RAD         40      /* Half height of the kernel map */
+
+/*
+ * Guided fuzzing (see "fuzz.c")
+ */
+#define FUZZ_WALK               0       /* Walking about */
+#define FUZZ_SPELL              1       /* Spells ("cause_spell_effect()") */
+#define FUZZ_PROJECT            2       /* Projections ("project()") */
+#define FUZZ_ITEM               3       /* Using items */
+#define FUZZ_STORE              4       /* Stores and buildings */
+#define FUZZ_QUEST              5       /* Quests */
+#define FUZZ_SANCTUM            6       /* The sanctum puzzles */
+#define FUZZ_PATROL             7       /* Guards alerted */
+#define FUZZ_STAIRS             8       /* New levels */
+#define FUZZ_PATHS              9
+#define FUZZ_BOOST              8       /* Boost for a path not reached enough */
+#define FUZZ_PATIENCE           20      /* Tries for each time it is reached */
+#define FUZZ_SLOW_MSEC          50      /* A game turn this long is noted */
+
+/*
+ * The sampling profiler (see "prof.c")
+ */
+#define PROF_USEC               1000    /* Processor time between samples */
+#define PROF_DEPTH              8       /* Timers kept in a sample */
+#define PROF_RING               4096    /* Samples not yet added up */
+#define PROF_STACKS             512     /* Different stacks kept */
+
+/*
+ * Keystroke journals (see "journal.c")
+ */
+#define JOURNAL_CHECK           256     /* Answers between two checks */
+
+/*
+ * Memory tags (see "VIRT_TAG()" in "z-virt.h")
+ */
+#define MEM_OTHER               0       /* Not tagged */
+#define MEM_INIT                1       /* Game data, read at startup */
+#define MEM_OBJECT              2       /* Objects ("object_alloc()") */
+#define MEM_QUARK               3       /* Quarks */
+#define MEM_LEVEL               4       /* Cached levels */
+#define MEM_SCRATCH             5       /* The level generator's arena */
+#define MEM_TAGS                6
+
+/*
+ * The memory census (see "memory_census()")
+ */
+#define CENSUS_PARTS            9       /* Parts counted */
+#define CENSUS_PRESSURE         90      /* Percent of a pool which is "full" */
+
+/*
+ * Script hooks (see "lua.c")
+ */
+#define SCRIPT_ON_TURN          0       /* Every game turn */
+#define SCRIPT_ON_LEVEL_GEN     1       /* A new level is ready */
+#define SCRIPT_ON_MONSTER_DEATH 2       /* A monster has died */
+#define SCRIPT_HOOKS            3
+#define SCRIPT_STEPS            100000  /* Lines and calls one call may run */
+#define SCRIPT_STRIKES          3       /* Failed calls before a hook is dropped */
+
+/*
+ * The observer of a headless game (see "observe.c")
+ */
+#define OBSERVE_LAYOUT          1       /* Bumped when "observe_type" changes */
+#define OBSERVE_MONSTERS        256     /* Most visible monsters it lists */
+#define OBSERVE_ITEMS           64      /* Most objects of the pack it lists */
+#define OBS_KNOWN               0x01    /* The player remembers the grid */
+#define OBS_PASS                0x02    /* ... and it can be walked through */
+
+/*
+ * Soak tests (see "soak.c")
+ */
+#define SOAK_TURNS              10000   /* Game turns, unless "--turns" */
+#define SOAK_HANG_MSEC          60000   /* A game this still is hung */
+#define SOAK_POLL_MSEC          100     /* How often to look at the games */
+
+/*
+ * The auto-roller (see "player_birth_aux()")
+ */
+#define AUTOROLL_MSEC           100     /* Time between two updates of the display */
+
+/*
+ * Number of cellular automaton passes over the caverns
+ */
+#define CAVERN_SMOOTH_ITERS     2
+
+/*
+ * Pending rectangles of the plasma fractal (three per level of halving,
+ * which is plenty for any rectangle that fits in the dungeon)
+ */
+#define PLASMA_STACK_MAX        64
+
+/*
+ * Number of wilderness tiles whose raw heights are kept in memory
+ * (each takes about 200k)
+ */
+#define WILD_CACHE_MAX          9
+
+/*
+ * Number of recently left levels kept in memory (see "save_dungeon()")
+ */
+#define LEVEL_CACHE_MAX         8
+
+/*
+ * Flags of a decoded vault grid (see "build_vault()")
+ */
+#define VAULT_GRID_USED         0x01    /* Part of the vault */
+#define VAULT_GRID_ICKY         0x02    /* Gets CAVE_ICKY */
+#define VAULT_GRID_SPECIAL      0x04    /* Needs more than a fixed feature */
+
+/*
+ * Restrictions of a cached allocation table (see "alloc_cache")
+ */
+#define ALLOC_CACHE_UNFAIR      0x01    /* Unfair monsters allowed */
+#define ALLOC_CACHE_OOD         0x02    /* Depth monsters allowed out of depth */
+#define ALLOC_CACHE_EVIL        0x04    /* Player is evil */
+#define ALLOC_CACHE_WILD        0x08    /* Player is in the wilderness */
+#define ALLOC_CACHE_CHEST       0x10    /* A chest is being opened */
+
+/*
+ * Connected component labelling (see "connect.c")
+ */
+#define CONNECT_MAX_GRIDS       4096    /* Largest window (64x64) */
+#define CONNECT_FLOOR           0       /* Floors, joined orthogonally */
+#define CONNECT_ELEV            1       /* Hills or pits of equal height */
+#define CONNECT_WALK            2       /* Floors a monster can walk across */
+
+/*
+ * Line of sight cache (see "los()" and "projectable()")
+ */
+#define SIGHT_CACHE_SIZE        4096    /* Cached rays (power of two) */
+#define SIGHT_LOS_KNOWN         0x01    /* "los()" result is cached */
+#define SIGHT_LOS               0x02    /* "los()" returned TRUE */
+#define SIGHT_PROJ_KNOWN        0x04    /* "projectable()" result is cached */
+#define SIGHT_PROJ              0x08    /* "projectable()" returned TRUE */
+
 /* Guard states */
 #define GUARD_STATE_PATROL      0       /* Normal patrol */
 #define GUARD_STATE_ALERT       1       /* Heard something, investigating */
@@ -370,6 +656,7 @@
 #define GUARD_POST_HIGHGROUND   5       /* Occupying elevation/cover advantage */
 
 #define TOWN_DAWN			10000 /* Number of turns from dawn to dawn XXX */
+#define AUTOSAVE_FREQ		5000 /* Game turns between automatic saves */
 #define BREAK_GLYPH		550	/* Rune of protection resistance */
 #define BTH_PLUS_ADJ		3 /* Adjust BTH per plus-to-hit */
 #define MON_MULT_ADJ		8 /* High value slows multiplication */
@@ -405,6 +692,8 @@
  */
 #define MAX_SIGHT		20 /* Maximum view distance */
 #define MAX_RANGE		18 /* Maximum range (spells, etc) */
+#define MAX_MISSILE_PATH	128 /* Maximum flight of a missile */
+#define PATH_STEPS		(MAX_RANGE + 2) /* Steps of each path in the table */
 
 
 
@@ -447,6 +736,13 @@
  */
 #define MAX_REPRO			100
 
+/*
+ * No block of the monster bucket grid may hold more than this many of
+ * them, or fewer if the block is out of the player's sight.
+ */
+#define MAX_REPRO_BLOCK		24
+#define MAX_REPRO_FAR		8
+
 
 /*
  * Player constants
@@ -1074,6 +1370,12 @@
 
 #define COVER_MAX       4
 
+/*
+ * Slots for destructible cover (a power of two), and how many may be used
+ */
+#define COVER_SLOTS     1024
+#define COVER_FULL      768
+
 /*
  * Cover direction flags (for directional cover)
  */
@@ -1475,6 +1777,20 @@
 #define STUFF_MAX         29
 
 
+/*
+ * What damages a material ("materials[].hates").
+ */
+#define HATES_ACID      0x0001
+#define HATES_ELEC      0x0002
+#define HATES_FIRE      0x0004
+#define HATES_COLD      0x0008
+#define HATES_PLASMA    0x0010
+#define HATES_METEOR    0x0020
+#define HATES_SHARDS    0x0040
+#define HATES_SOUND     0x0080
+#define HATES_IMPACT    0x0100
+
+
 /*
  * Fate types.
  */
@@ -2395,6 +2711,8 @@
 #define RBM_PROJECT     26
 #define RBM_EXPLODE     27
 
+#define RBM_MAX         28
+
 /*
  * New monster blow effects
  */
@@ -2428,6 +2746,8 @@
 #define RBE_EXP_80		28
 #define RBE_INSANITY            29
 
+#define RBE_MAX                 30
+
 
 /*** Function flags ***/
 
@@ -2530,6 +2850,11 @@
 #define ODESC_GOLD 0x01	/* Do not show gold */
 #define ODESC_SLOT 0x02	/* Do not show slot */
 
+/*
+ * Object names remembered by "object_desc()"
+ */
+#define OBJECT_DESC_CACHE	64
+
 
 /*
  * Bit flags for the "get_item" function
@@ -2578,6 +2903,15 @@
 /* xxx (many) */
 
 
+/*
+ * Reasons for "disturb()" (see "disturb_why")
+ */
+#define DISTURB_OTHER	0x0001	/* Anything else */
+#define DISTURB_MONSTER	0x0002	/* A monster moved, appeared or acted */
+#define DISTURB_DAMAGE	0x0004	/* The player was hurt */
+#define DISTURB_STATUS	0x0008	/* A timed effect changed */
+
+
 /*
  * Bit flags for the "p_ptr->redraw" variable
  */
@@ -2652,6 +2986,11 @@
 #define CAVE_TEMP	0x40 /* temp flag */
 #define CAVE_XTRA	0x80 /* misc flag */
 #define CAVE_ACTIVE	0x0100 /* Tile has dynamic behavior/scripts */
+#define CAVE_ENV	0x0200 /* Grid is in the environment-active list */
+#define CAVE_SHINE	0x0400 /* "CAVE_GLOW" comes from the light field */
+#define CAVE_NOTE	0x0800 /* Grid is in the notable-feature list */
+#define CAVE_SLOPE	0x1000 /* Grid is next to a grid of another height */
+#define CAVE_PASS	0x2000 /* The steps off the grid are worked out */
 
 
 
@@ -2924,6 +3263,24 @@
 #define MFLAG_STRUGGLING  0x4000 /* Monster is struggling in current environment */
 #define MFLAG_RETALIATE   0x8000 /* Dumb monster retaliating */
 
+/*
+ * Terrain effects on monsters (see "mon_terrain()")
+ */
+#define MTERR_OIL		0x0001	/* Slips on oil */
+#define MTERR_BRAMBLE	0x0002	/* Cut by brambles */
+#define MTERR_SWAMP		0x0004	/* Stuck in a swamp */
+#define MTERR_DROWN		0x0008	/* Drowns in deep water */
+#define MTERR_WADE		0x0010	/* Slowed by deep water */
+#define MTERR_ICE		0x0020	/* Slips on ice */
+#define MTERR_LAVA		0x0040	/* Burned by deep lava */
+#define MTERR_DRY		0x0100	/* Suffocates out of water */
+#define MTERR_DOUSE		0x0200	/* Extinguished by water or ice */
+#define MTERR_MELT		0x0400	/* Melted by lava */
+#define MTERR_ACCESS	0x8000	/* Grid links elevations (feature only) */
+
+#define MTERR_MOVE		0x00FF	/* Effects for mon_process_terrain() */
+#define MTERR_ENV		0x0F00	/* Effects for the environment check */
+
 
 /*
  * New monster race bit flags
@@ -3320,7 +3677,7 @@
 #define OPT_center_running              84
 #define OPT_hidden_pet_messages         85
 #define OPT_almost_center_player        86
-#define OPT_87                          87
+#define OPT_autosave_game               87
 #define OPT_88                          88
 #define OPT_89                          89
 #define OPT_MAX                         90
@@ -3416,6 +3773,7 @@
 #define center_running                  op_ptr->opt[OPT_center_running]
 #define hidden_pet_messages             op_ptr->opt[OPT_hidden_pet_messages]
 #define almost_center_player            op_ptr->opt[OPT_almost_center_player]
+#define autosave_game                   op_ptr->opt[OPT_autosave_game]
 
 /*** Macro Definitions ***/
 
@@ -3710,8 +4068,6 @@ extern int PlayerUID;
 # define QUARK_MAX	128
 # undef MESSAGE_MAX
 # define MESSAGE_MAX	128
-# undef MESSAGE_BUF
-# define MESSAGE_BUF	4096
 #endif
 /* Force rebuild for dungeon size */
 #define MON_ALLOC_HIDE    0x1000
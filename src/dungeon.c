@@ -110,6 +110,9 @@ static cptr value_check_aux2(object_type * o_ptr)
  *   Class 4 = Ranger  --> slow and light
  *   Class 5 = Paladin --> slow but heavy
  *   Class 6 = Illusionist --> slow and light -KMW-
+ *
+ * The pack is only looked at while "inven_unsensed" says something in it
+ * may still give a feeling (the chance is rolled every time regardless).
  */
 static void sense_inventory(void)
 {
@@ -235,6 +238,14 @@ static void sense_inventory(void)
 	}
 
 
+	/* Nothing left to sense */
+	if (!inven_unsensed)
+		return;
+
+	/* Assume nothing is left after this */
+	inven_unsensed = FALSE;
+
+
 	/*** Sense everything ***/
 
 	/* Check everything */
@@ -288,9 +299,12 @@ static void sense_inventory(void)
 		/* Check for a feeling */
 		feel = (heavy ? value_check_aux1(o_ptr) : value_check_aux2(o_ptr));
 
-		/* Skip non-feelings */
+		/* Skip non-feelings (but try them again later) */
 		if (!feel)
+		{
+			inven_unsensed = TRUE;
 			continue;
+		}
 
 		/* Stop everything */
 		if (disturb_minor)
@@ -440,37 +454,36 @@ static void regen_monsters(void)
 	{
 		/* Check the i'th monster */
 		monster_type *m_ptr = &m_list[i];
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+
+		/* Only wounded monsters (dead ones have no hit points at all) */
+		if (m_ptr->hp >= m_ptr->maxhp)
+			continue;
 
 		/* Skip dead monsters */
 		if (!m_ptr->r_idx)
 			continue;
 
-		/* Allow regeneration (if needed) */
-		if (m_ptr->hp < m_ptr->maxhp)
-		{
-			/* Hack -- Base regeneration */
-			frac = m_ptr->maxhp / 100;
+		/* Hack -- Base regeneration */
+		frac = m_ptr->maxhp / 100;
 
-			/* Hack -- Minimal regeneration rate */
-			if (!frac)
-				frac = 1;
+		/* Hack -- Minimal regeneration rate */
+		if (!frac)
+			frac = 1;
 
-			/* Hack -- Some monsters regenerate quickly */
-			if (r_ptr->flags2 & (RF2_REGENERATE))
-				frac *= 2;
+		/* Hack -- Some monsters regenerate quickly */
+		if (r_info[m_ptr->r_idx].flags2 & (RF2_REGENERATE))
+			frac *= 2;
 
-			/* Hack -- Regenerate */
-			m_ptr->hp += frac;
+		/* Hack -- Regenerate */
+		m_ptr->hp += frac;
 
-			/* Do not over-regenerate */
-			if (m_ptr->hp > m_ptr->maxhp)
-				m_ptr->hp = m_ptr->maxhp;
+		/* Do not over-regenerate */
+		if (m_ptr->hp > m_ptr->maxhp)
+			m_ptr->hp = m_ptr->maxhp;
 
-			/* Redraw (later) if needed */
-			if (p_ptr->health_who == i)
-				p_ptr->redraw |= (PR_HEALTH);
-		}
+		/* Redraw (later) if needed */
+		if (p_ptr->health_who == i)
+			p_ptr->redraw |= (PR_HEALTH);
 	}
 }
 
@@ -560,9 +573,14 @@ static void process_crushing_room(void)
 
 /*
  * Process Rolling Boulders
+ *
+ * Only the grids of the boulder list (see "boulder_add()") are visited.
+ * They are taken in the order of a scan of the map, each boulder rolls
+ * once, and those which stop rolling are dropped from the list.
  */
 static void process_boulders(void)
 {
+	int i, k, n;
 	int y, x;
 	int dy = 0, dx = 0;
 	int ny, nx;
@@ -570,91 +588,123 @@ static void process_boulders(void)
 	int feat;
 	char m_name[80];
 
-	/* Clear CAVE_TEMP on boulders */
-	for (y = 0; y < DUNGEON_HGT; y++) {
-		for (x = 0; x < DUNGEON_WID; x++) {
-			if (cave_feat[y][x] >= FEAT_BOULDER_N && cave_feat[y][x] <= FEAT_BOULDER_W) {
-				cave_info[y][x] &= ~CAVE_TEMP;
-			}
+	/* Nothing rolling */
+	if (!boulder_n) return;
+
+	/* Sort the boulders by row, and then by column */
+	for (i = 1; i < boulder_n; i++)
+	{
+		y = boulder_y[i];
+		x = boulder_x[i];
+
+		for (k = i; k > 0; k--)
+		{
+			if ((boulder_y[k - 1] < y) ||
+			    ((boulder_y[k - 1] == y) && (boulder_x[k - 1] < x)))
+				break;
+
+			boulder_y[k] = boulder_y[k - 1];
+			boulder_x[k] = boulder_x[k - 1];
 		}
+
+		boulder_y[k] = y;
+		boulder_x[k] = x;
 	}
 
-	for (y = 0; y < DUNGEON_HGT; y++) {
-		for (x = 0; x < DUNGEON_WID; x++) {
-			feat = cave_feat[y][x];
-			if (feat >= FEAT_BOULDER_N && feat <= FEAT_BOULDER_W) {
-				if (!(cave_info[y][x] & CAVE_TEMP)) {
-					dy = 0; dx = 0;
+	/* Only roll the boulders which were rolling at the start */
+	n = boulder_n;
 
-					if (feat == FEAT_BOULDER_N) dy = -1;
-					else if (feat == FEAT_BOULDER_S) dy = 1;
-					else if (feat == FEAT_BOULDER_E) dx = 1;
-					else if (feat == FEAT_BOULDER_W) dx = -1;
+	for (i = 0; i < n; i++)
+	{
+		y = boulder_y[i];
+		x = boulder_x[i];
+		feat = cave_feat[y][x];
 
-					ny = y + dy;
-					nx = x + dx;
+		/* No longer rolling */
+		if (!((feat >= FEAT_BOULDER_N) && (feat <= FEAT_BOULDER_W))) continue;
 
-					if (!in_bounds(ny, nx)) {
-						cave_set_feat(y, x, FEAT_RUBBLE);
-						continue;
-					}
+		dy = 0; dx = 0;
 
-					/* Collision with Player */
-					if (ny == p_ptr->py && nx == p_ptr->px) {
-						mprint(MSG_DEADLY, "The boulder slams into you!");
-						take_hit(damroll(10, 10), "a rolling boulder");
-
-						/* Push player */
-						pny = ny + dy;
-						pnx = nx + dx;
-
-						if (in_bounds(pny, pnx) && cave_floor_bold(pny, pnx) && cave_m_idx[pny][pnx] == 0) {
-							mprint(MSG_URGENT, "You are pushed back!");
-							monster_swap(ny, nx, pny, pnx);
-						} else {
-							mprint(MSG_DEADLY, "You are crushed against the wall!");
-							take_hit(damroll(20, 10), "a rolling boulder");
-							cave_set_feat(y, x, FEAT_RUBBLE);
-							continue;
-						}
-					}
+		if (feat == FEAT_BOULDER_N) dy = -1;
+		else if (feat == FEAT_BOULDER_S) dy = 1;
+		else if (feat == FEAT_BOULDER_E) dx = 1;
+		else if (feat == FEAT_BOULDER_W) dx = -1;
 
-					/* Collision with Monster */
-					if (cave_m_idx[ny][nx] > 0) {
-						int m_idx = cave_m_idx[ny][nx];
-						bool fear = FALSE;
-						monster_desc(m_name, &m_list[m_idx], 0);
-						msg_format("%^s is flattened.", m_name);
-						mon_take_hit(m_idx, 500, &fear, " is flattened.", FALSE, FALSE);
-
-						if (cave_m_idx[ny][nx] > 0) {
-							cave_set_feat(y, x, FEAT_RUBBLE);
-							if (player_can_see_bold(y, x))
-								msg_print("The boulder crashes into the monster and shatters!");
-							continue;
-						}
-					}
+		ny = y + dy;
+		nx = x + dx;
 
-					/* Collision with Wall/Obstacle */
-					if (!cave_floor_bold(ny, nx)) {
-						cave_set_feat(y, x, FEAT_RUBBLE);
-						if (player_can_see_bold(y, x))
-							msg_print("The boulder shatters against the wall!");
-						continue;
-					}
+		if (!in_bounds(ny, nx)) {
+			cave_set_feat(y, x, FEAT_RUBBLE);
+			continue;
+		}
 
-					/* Move Boulder */
-					cave_set_feat(y, x, FEAT_FLOOR);
-					cave_set_feat(ny, nx, feat);
-					cave_info[ny][nx] |= CAVE_TEMP;
-					note_spot(y, x);
-					note_spot(ny, nx);
-					lite_spot(y, x);
-					lite_spot(ny, nx);
-				}
+		/* Collision with Player */
+		if (ny == p_ptr->py && nx == p_ptr->px) {
+			mprint(MSG_DEADLY, "The boulder slams into you!");
+			take_hit(damroll(10, 10), "a rolling boulder");
+
+			/* Push player */
+			pny = ny + dy;
+			pnx = nx + dx;
+
+			if (in_bounds(pny, pnx) && cave_floor_bold(pny, pnx) && cave_m_idx[pny][pnx] == 0) {
+				mprint(MSG_URGENT, "You are pushed back!");
+				monster_swap(ny, nx, pny, pnx);
+			} else {
+				mprint(MSG_DEADLY, "You are crushed against the wall!");
+				take_hit(damroll(20, 10), "a rolling boulder");
+				cave_set_feat(y, x, FEAT_RUBBLE);
+				continue;
+			}
+		}
+
+		/* Collision with Monster */
+		if (cave_m_idx[ny][nx] > 0) {
+			int m_idx = cave_m_idx[ny][nx];
+			bool fear = FALSE;
+			monster_desc(m_name, &m_list[m_idx], 0);
+			msg_format("%^s is flattened.", m_name);
+			mon_take_hit(m_idx, 500, &fear, " is flattened.", FALSE, FALSE);
+
+			if (cave_m_idx[ny][nx] > 0) {
+				cave_set_feat(y, x, FEAT_RUBBLE);
+				if (player_can_see_bold(y, x))
+					msg_print("The boulder crashes into the monster and shatters!");
+				continue;
 			}
 		}
+
+		/* Collision with Wall/Obstacle */
+		if (!cave_floor_bold(ny, nx)) {
+			cave_set_feat(y, x, FEAT_RUBBLE);
+			if (player_can_see_bold(y, x))
+				msg_print("The boulder shatters against the wall!");
+			continue;
+		}
+
+		/* Move Boulder (keeping its entry) */
+		cave_set_feat(y, x, FEAT_FLOOR);
+		boulder_y[i] = ny;
+		boulder_x[i] = nx;
+		cave_set_feat(ny, nx, feat);
+		note_spot(y, x);
+		note_spot(ny, nx);
+		lite_spot(y, x);
+		lite_spot(ny, nx);
 	}
+
+	/* Drop the boulders which stopped rolling */
+	for (k = 0, i = 0; i < boulder_n; i++)
+	{
+		feat = cave_feat[boulder_y[i]][boulder_x[i]];
+
+		if (!((feat >= FEAT_BOULDER_N) && (feat <= FEAT_BOULDER_W))) continue;
+
+		boulder_y[k] = boulder_y[i];
+		boulder_x[k] = boulder_x[i];
+		k++;
+	}
+	boulder_n = k;
 }
 
 /*
@@ -669,6 +719,13 @@ static void check_monster_environment(int m_idx, int y, int x)
 	int damage = 0;
 	cptr desc = "environmental stress";
 
+	/* Quick check -- at home here */
+	if (!(mon_terrain(m_ptr, feat) & MTERR_ENV))
+	{
+		m_ptr->mflag &= ~(MFLAG_STRUGGLING);
+		return;
+	}
+
 	/* 1. Aquatic Check */
 	if (r_ptr->flags2 & RF2_AQUATIC)
 	{
@@ -809,152 +866,212 @@ static void check_player_environment(void)
 	}
 }
 
+/*
+ * Apply the terrain hazards of a grid to whoever stands on it.
+ */
+static void process_grid_hazards(int y, int x)
+{
+	int feat = cave_feat[y][x];
+	int m_idx = cave_m_idx[y][x];
+
+	if (m_idx != 0) {
+		if (m_idx < 0) { /* Player */
+			if (!p_ptr->flying) {
+				if (feat == FEAT_ACID && !p_ptr->immune_acid) {
+					int dam = damroll(2, 2) + p_ptr->depth / 5;
+					acid_dam(dam, "a pool of acid");
+				}
+				else if (feat == FEAT_OIL) {
+					if (randint(2) == 1) {
+						mprint(MSG_WARNING, "You slip on the oil.");
+						set_stun(p_ptr->stun + rand_range(1, 10));
+					}
+				}
+				else if (feat == FEAT_OIL_BURNING && !p_ptr->immune_fire) {
+					int dam = damroll(2, 2) + p_ptr->depth / 5;
+					fire_dam(dam, "burning oil");
+				}
+			}
+		} else { /* Monster */
+			monster_type *m_ptr = &m_list[m_idx];
+			monster_race *r_ptr = &r_info[m_ptr->r_idx];
+			bool fly = (r_ptr->flags2 & RF2_FLY) ? TRUE : FALSE;
+
+			/* Check Environmental Integrity */
+			check_monster_environment(m_idx, y, x);
+
+			if (!fly) {
+				if (feat == FEAT_ACID && !(r_ptr->flags3 & RF3_IM_ACID)) {
+					bool fear = FALSE;
+					int dam = damroll(2, 2) + p_ptr->depth / 5;
+					mon_take_hit(m_idx, dam, &fear, " melts.", FALSE, FALSE);
+				}
+				else if (feat == FEAT_OIL) {
+					if (randint(2) == 1) {
+						if (m_ptr->ml && m_ptr->is_pet) {
+							char m_name[80];
+							monster_desc(m_name, m_ptr, 0);
+							msg_format("%^s slips on the oil.", m_name);
+						}
+						/* Add slip stun effect */
+						m_ptr->stunned += rand_range(1, 10);
+					}
+				}
+				else if (feat == FEAT_OIL_BURNING) {
+					bool fear = FALSE;
+					int dam = damroll(2, 2) + p_ptr->depth / 5;
+					cptr note = " burns.";
+
+					/* Immunity */
+					if ((r_ptr->flags4 & RF4_BR_FIRE) || (r_ptr->flags3 & RF3_IM_FIRE)) {
+						dam = 0;
+						note = " is unaffected.";
+					}
+					/* Vulnerability */
+					else if ((r_ptr->flags3 & RF3_HURT_FIRE) ||
+							 (r_ptr->d_char == 'M' && (r_ptr->flags3 & RF3_UNDEAD)) || /* Mummy */
+							 (r_ptr->d_char == 'I') || /* Insect */
+							 (strchr("j,m", r_ptr->d_char))) /* Plant/Jelly/Mold/Mushroom */
+					{
+						dam = dam * 3 / 2;
+						note = " is consumed by the hungry flames!";
+					}
+					/* Resistance/Inert */
+					else if ((r_ptr->flags2 & RF2_REGENERATE) || (r_ptr->d_char == 'g')) {
+						dam = dam / 4;
+						note = NULL; /* Let message_pain handle "glows dull red" if alive */
+					}
+
+					/* Mark as on fire */
+					m_ptr->mflag |= MFLAG_ON_FIRE;
+
+					mon_take_hit(m_idx, dam, &fear, note, FALSE, FALSE);
+				}
+			}
+		}
+	}
+}
+
 /*
  * Process environment (Burning Oil, Acid, etc.)
+ *
+ * Only grids in the "environment-active" list can burn, so we walk that
+ * list instead of the whole map.  Grids which catch fire during this tick
+ * are appended past "n" and are not processed until the next tick, which
+ * replaces the old "CAVE_TEMP" marking of new fires.  Hazards to entities
+ * are then applied by walking the player and the monster list.
  */
 static void process_environment(void)
 {
-	int y, x, i;
+	int y, x, i, j;
+	s32b k, n;
 	int ddy_burning[8] = {1, -1, 0, 0, 1, 1, -1, -1};
 	int ddx_burning[8] = {0, 0, 1, -1, 1, -1, 1, -1};
 
-	/* Pass 1: Clear CAVE_TEMP for burning oil */
-	for (y = 0; y < DUNGEON_HGT; y++) {
-		for (x = 0; x < DUNGEON_WID; x++) {
-			if (cave_feat[y][x] == FEAT_OIL_BURNING) {
-				cave_info[y][x] &= ~CAVE_TEMP;
-			}
-		}
-	}
+	/* Only process the grids which were burning at the start of the tick */
+	n = env_active_n;
 
-	/* Pass 2: Process environment */
-	for (y = 0; y < DUNGEON_HGT; y++) {
-		for (x = 0; x < DUNGEON_WID; x++) {
-			int feat = cave_feat[y][x];
-			int m_idx = cave_m_idx[y][x];
-
-			/* Burning Oil Logic */
-			if (feat == FEAT_OIL_BURNING) {
-				if (!(cave_info[y][x] & CAVE_TEMP)) {
-					/* Decay */
-					if (cave[y][x].fuel > 0) cave[y][x].fuel--;
-
-					/* Spread */
-					if (cave[y][x].fuel > 5) {
-						for (i = 0; i < 8; i++) {
-							int ny = y + ddy_burning[i];
-							int nx = x + ddx_burning[i];
-							if (in_bounds(ny, nx) && cave_feat[ny][nx] == FEAT_OIL) {
-								cave_set_feat(ny, nx, FEAT_OIL_BURNING);
-								cave[ny][nx].fuel = cave[y][x].fuel - 1;
-								cave_info[ny][nx] |= CAVE_TEMP; /* Mark as new */
-								note_spot(ny, nx);
-								lite_spot(ny, nx);
-							}
-						}
-					} else if (cave[y][x].fuel == 0) {
-						/* Extinguish */
-						cave_set_feat(y, x, FEAT_FLOOR);
-						note_spot(y, x);
-						lite_spot(y, x);
-						feat = FEAT_FLOOR; /* Update local var */
-					}
-				}
-			}
+	/* Process burning grids, compacting the list as we go */
+	for (k = 0, i = 0; i < n; i++)
+	{
+		y = env_active_y[i];
+		x = env_active_x[i];
 
-			/* Entity Interaction (Player or Monster) */
-			if (m_idx != 0) {
-				if (m_idx < 0) { /* Player */
-					if (!p_ptr->flying) {
-						if (feat == FEAT_ACID && !p_ptr->immune_acid) {
-							int dam = damroll(2, 2) + p_ptr->depth / 5;
-							acid_dam(dam, "a pool of acid");
-						}
-						else if (feat == FEAT_OIL) {
-							if (randint(2) == 1) {
-								mprint(MSG_WARNING, "You slip on the oil.");
-								set_stun(p_ptr->stun + rand_range(1, 10));
-							}
-						}
-						else if (feat == FEAT_OIL_BURNING && !p_ptr->immune_fire) {
-							int dam = damroll(2, 2) + p_ptr->depth / 5;
-							fire_dam(dam, "burning oil");
-						}
-					}
-				} else { /* Monster */
-					monster_type *m_ptr = &m_list[m_idx];
-					monster_race *r_ptr = &r_info[m_ptr->r_idx];
-					bool fly = (r_ptr->flags2 & RF2_FLY) ? TRUE : FALSE;
-
-                    /* Check Environmental Integrity */
-                    check_monster_environment(m_idx, y, x);
-
-					if (!fly) {
-						if (feat == FEAT_ACID && !(r_ptr->flags3 & RF3_IM_ACID)) {
-							bool fear = FALSE;
-							int dam = damroll(2, 2) + p_ptr->depth / 5;
-							mon_take_hit(m_idx, dam, &fear, " melts.", FALSE, FALSE);
-						}
-						else if (feat == FEAT_OIL) {
-							if (randint(2) == 1) {
-								if (m_ptr->ml && m_ptr->is_pet) {
-									char m_name[80];
-									monster_desc(m_name, m_ptr, 0);
-									msg_format("%^s slips on the oil.", m_name);
-								}
-								/* Add slip stun effect */
-								m_ptr->stunned += rand_range(1, 10);
-							}
-						}
-						else if (feat == FEAT_OIL_BURNING) {
-							bool fear = FALSE;
-							int dam = damroll(2, 2) + p_ptr->depth / 5;
-							cptr note = " burns.";
-
-							/* Immunity */
-							if ((r_ptr->flags4 & RF4_BR_FIRE) || (r_ptr->flags3 & RF3_IM_FIRE)) {
-								dam = 0;
-								note = " is unaffected.";
-							}
-							/* Vulnerability */
-							else if ((r_ptr->flags3 & RF3_HURT_FIRE) ||
-									 (r_ptr->d_char == 'M' && (r_ptr->flags3 & RF3_UNDEAD)) || /* Mummy */
-									 (r_ptr->d_char == 'I') || /* Insect */
-									 (strchr("j,m", r_ptr->d_char))) /* Plant/Jelly/Mold/Mushroom */
-							{
-								dam = dam * 3 / 2;
-								note = " is consumed by the hungry flames!";
-							}
-							/* Resistance/Inert */
-							else if ((r_ptr->flags2 & RF2_REGENERATE) || (r_ptr->d_char == 'g')) {
-								dam = dam / 4;
-								note = NULL; /* Let message_pain handle "glows dull red" if alive */
-							}
-
-							/* Mark as on fire */
-							m_ptr->mflag |= MFLAG_ON_FIRE;
-
-							mon_take_hit(m_idx, dam, &fear, note, FALSE, FALSE);
-						}
+		/* Hack -- clear any "new fire" marks left by the projection code */
+		cave_info[y][x] &= ~(CAVE_TEMP);
+
+		/* Burning Oil Logic */
+		if (cave_feat[y][x] == FEAT_OIL_BURNING)
+		{
+			/* Decay */
+			if (cave[y][x].fuel > 0) cave[y][x].fuel--;
+
+			/* Spread */
+			if (cave[y][x].fuel > 5)
+			{
+				for (j = 0; j < 8; j++)
+				{
+					int ny = y + ddy_burning[j];
+					int nx = x + ddx_burning[j];
+					if (in_bounds(ny, nx) && cave_feat[ny][nx] == FEAT_OIL)
+					{
+						cave_set_feat(ny, nx, FEAT_OIL_BURNING);
+						cave[ny][nx].fuel = cave[y][x].fuel - 1;
+						note_spot(ny, nx);
+						lite_spot(ny, nx);
 					}
 				}
 			}
+			else if (cave[y][x].fuel == 0)
+			{
+				/* Extinguish */
+				cave_set_feat(y, x, FEAT_FLOOR);
+				note_spot(y, x);
+				lite_spot(y, x);
+			}
+		}
+
+		/* Keep grids which are still burning */
+		if (cave_feat[y][x] == FEAT_OIL_BURNING)
+		{
+			env_active_y[k] = y;
+			env_active_x[k] = x;
+			k++;
+		}
+
+		/* Drop the rest */
+		else
+		{
+			cave_info[y][x] &= ~(CAVE_ENV);
 		}
 	}
 
-    /* Check Player Environment */
-    check_player_environment();
+	/* Move the grids which caught fire this tick down */
+	for (i = n; i < env_active_n; i++, k++)
+	{
+		env_active_y[k] = env_active_y[i];
+		env_active_x[k] = env_active_x[i];
+	}
+	env_active_n = k;
+
+	/* Hazards for the player */
+	process_grid_hazards(p_ptr->py, p_ptr->px);
+
+	/* Hazards for the monsters */
+	for (i = 1; i < m_max; i++)
+	{
+		monster_type *m_ptr = &m_list[i];
+
+		/* Skip dead monsters */
+		if (!m_ptr->r_idx) continue;
+
+		process_grid_hazards(m_ptr->fy, m_ptr->fx);
+	}
+
+	/* Check Player Environment */
+	check_player_environment();
 }
 
 /*
  * Rearrange Dark Sectors
+ *
+ * Only the dark maze the player is standing in shifts, since the others
+ * cannot be seen anyway.
  */
 static void rearrange_dark_sectors(void)
 {
-	int y, x;
-	/* Iterate over dungeon */
-	for (y = 1; y < DUNGEON_HGT - 1; y++) {
-		for (x = 1; x < DUNGEON_WID - 1; x++) {
+	int y, x, i;
+	dark_sector *ds_ptr;
+
+	/* Find the sector around the player */
+	i = dark_sector_find(p_ptr->py, p_ptr->px);
+	if (i < 0) return;
+
+	ds_ptr = &dark_sectors[i];
+
+	/* Iterate over the sector */
+	for (y = MAX(ds_ptr->y1, 1); y <= MIN(ds_ptr->y2, DUNGEON_HGT - 2); y++) {
+		for (x = MAX(ds_ptr->x1, 1); x <= MIN(ds_ptr->x2, DUNGEON_WID - 2); x++) {
 			if (cave_sector[y][x] == SECTOR_DARK) {
 				/* Skip visible grids */
 				if (cave_info[y][x] & CAVE_VIEW) continue;
@@ -977,13 +1094,11 @@ static void rearrange_dark_sectors(void)
 	}
 
 	/* Check player pinning */
-	if (cave_sector[p_ptr->py][p_ptr->px] == SECTOR_DARK) {
-		if (cave_feat[p_ptr->py][p_ptr->px] == FEAT_WALL_EXTRA) {
-			msg_print("The rock around you groans and thirsts for your light.");
-            /* Pin the player */
-            if (!p_ptr->paralyzed) {
-                set_paralyzed(50);
-            }
+	if (cave_feat[p_ptr->py][p_ptr->px] == FEAT_WALL_EXTRA) {
+		msg_print("The rock around you groans and thirsts for your light.");
+		/* Pin the player */
+		if (!p_ptr->paralyzed) {
+			set_paralyzed(50);
 		}
 	}
 }
@@ -998,51 +1113,184 @@ static int get_sector_type(int y, int x)
 }
 
 
-/* Process all active tiles on the level */
+/*
+ * Process all active tiles on the level
+ *
+ * Only the walls in the active wall list can move, so the cost of a tick
+ * is proportional to the number of shifting walls.  A wall keeps its list
+ * entry as it moves, and walls which have been destroyed are dropped.
+ */
 static void process_active_terrain(void) {
-    int y, x;
+    int i, k;
     bool wall_moved = FALSE;
 
-    /* On a 400x400 map, we iterate only when needed */
-    for (y = 1; y < DUNGEON_HGT - 1; y++) {
-        for (x = 1; x < DUNGEON_WID - 1; x++) {
-            if (!(cave_info[y][x] & CAVE_ACTIVE)) continue;
+    for (k = 0, i = 0; i < active_wall_n; i++) {
+        int y = active_wall_y[i];
+        int x = active_wall_x[i];
 
-            int feat = cave_feat[y][x];
-
-            /* SHIFTING MAZE BEHAVIOR */
-            if (feat == FEAT_WALL_EXTRA) {
-                int dir = ddd[rand_int(8)];
-                int ny = y + ddy[dir];
-                int nx = x + ddx[dir];
-
-                /* Swap with adjacent floor only */
-                if (in_bounds(ny, nx) && cave_feat[ny][nx] == FEAT_FLOOR) {
-                    /* Swap Feature */
-                    cave_feat[ny][nx] = FEAT_WALL_EXTRA;
-                    cave_feat[y][x] = FEAT_FLOOR;
-
-                    /* Swap Flags */
-                    cave_info[ny][nx] |= CAVE_ACTIVE;
-                    cave_info[y][x] &= ~CAVE_ACTIVE;
-
-                    /* Visual Update */
-                    lite_spot(y, x);
-                    lite_spot(ny, nx);
+        /* Forget walls which no longer exist */
+        if (!(cave_info[y][x] & CAVE_ACTIVE) ||
+            (cave_feat[y][x] != FEAT_WALL_EXTRA)) {
+            cave_info[y][x] &= ~CAVE_ACTIVE;
+            continue;
+        }
 
-                    if (distance(y, x, p_ptr->py, p_ptr->px) < 25) {
-                        wall_moved = TRUE;
-                    }
+        /* SHIFTING MAZE BEHAVIOR */
+        if (y > 0 && y < DUNGEON_HGT - 1 && x > 0 && x < DUNGEON_WID - 1) {
+            int dir = ddd[rand_int(8)];
+            int ny = y + ddy[dir];
+            int nx = x + ddx[dir];
+
+            /* Swap with adjacent (unclaimed) floor only */
+            if (in_bounds(ny, nx) && cave_feat[ny][nx] == FEAT_FLOOR &&
+                !(cave_info[ny][nx] & CAVE_ACTIVE)) {
+                /* Swap Feature */
+                cave_feat[ny][nx] = FEAT_WALL_EXTRA;
+                cave_feat[y][x] = FEAT_FLOOR;
+                floor_note_change(ny, nx, TRUE);
+                floor_note_change(y, x, FALSE);
+                if (cave_info[ny][nx] & (CAVE_SLOPE)) elev_pass_note(ny, nx);
+                if (cave_info[y][x] & (CAVE_SLOPE)) elev_pass_note(y, x);
+
+                /* Swap Flags */
+                cave_info[ny][nx] |= CAVE_ACTIVE;
+                cave_info[y][x] &= ~CAVE_ACTIVE;
+
+                /* The monster flow must route around the wall */
+                flow_invalidate(y, x);
+                flow_invalidate(ny, nx);
+                view_note_change(y, x);
+                view_note_change(ny, nx);
+                sight_cache_wipe();
+
+                /* Visual Update */
+                lite_spot(y, x);
+                lite_spot(ny, nx);
+
+                if (distance(y, x, p_ptr->py, p_ptr->px) < 25) {
+                    wall_moved = TRUE;
                 }
+
+                /* The wall takes its entry along */
+                y = ny;
+                x = nx;
             }
         }
+
+        /* Keep the wall */
+        active_wall_y[k] = y;
+        active_wall_x[k] = x;
+        k++;
     }
 
+    active_wall_n = k;
+
     if (wall_moved && rand_int(100) < 5) {
         msg_print("You hear the grinding of stone nearby...");
     }
 }
 
+/*
+ * Word of recall activates
+ */
+static void recall_activate(void)
+{
+	/* Disturbing! */
+	disturb(0, 0);
+
+	/* Ghosts don't WoR */
+
+	if (p_ptr->prace == RACE_GHOST && !p_ptr->prace_info)
+	{
+		msg_print("You feel a terrible sense of loss.");
+		return;
+	}
+
+	/* Determine the level */
+	if (p_ptr->depth && 
+	    p_ptr->inside_special != SPECIAL_WILD)
+	{
+		prepare_recall_ambush();
+		mprint(MSG_BONUS, "You feel yourself yanked upwards!");
+		p_ptr->inside_special = SPECIAL_WILD;
+		p_ptr->leaving = TRUE;
+
+		/* HACK -- Teleport to the town */
+		p_ptr->wild_x = 0;
+		p_ptr->wild_y = 0;
+		p_ptr->wilderness_depth = 0;
+		p_ptr->px = 0;
+		p_ptr->py = 0;
+	}
+	else
+	{
+		mprint(MSG_BONUS, "You feel yourself yanked downwards!");
+
+		dungeon_save_wilderness_location();
+
+		/* New depth */
+		p_ptr->depth = p_ptr->max_depth;
+
+		if (p_ptr->depth < 1)
+			p_ptr->depth = 1;
+
+		p_ptr->inside_special = 0;
+
+		/* Leaving */
+		p_ptr->leaving = TRUE;
+	}
+
+	/* Sound */
+	sound(SOUND_TPLEVEL);
+}
+
+
+/*
+ * The Scholar has deciphered a tome
+ */
+static void decipher_finish(int idx)
+{
+	msg_print("Your tome has been completed!");
+
+	if (idx >= 0 && idx < MAX_LORE)
+	{
+		lore_known |= (1L << idx);
+		msg_format("You decipher the ancient text: %s", lore_text[idx]);
+	}
+	else
+	{
+		msg_print("The tome contained gibberish.");
+	}
+}
+
+
+/*
+ * Handle the scheduled events which are due (see "event.c")
+ */
+static void process_events(void)
+{
+	event_type ev;
+
+	while (event_due(&ev))
+	{
+		switch (ev.kind)
+		{
+			case EVENT_RECALL:
+			{
+				recall_activate();
+				break;
+			}
+
+			case EVENT_DECIPHER:
+			{
+				decipher_finish(ev.data);
+				break;
+			}
+		}
+	}
+}
+
+
 /*
  * Handle certain things once every 10 game turns
  */
@@ -1058,12 +1306,18 @@ static void process_world(void)
 
 
 	/* Every turn */
+	metric_start(METRIC_T_PROCESS_DREAD);
 	process_dread();
+	metric_stop(METRIC_T_PROCESS_DREAD);
+	metric_start(METRIC_T_PROCESS_TERRAIN);
 	process_breathing_walls();
+	metric_stop(METRIC_T_PROCESS_TERRAIN);
 
     /* Shifting Maze Timer */
     if (turn % 10 == 0) {
+        metric_start(METRIC_T_PROCESS_ACTIVE_TERRAIN);
         process_active_terrain();
+        metric_stop(METRIC_T_PROCESS_ACTIVE_TERRAIN);
     }
 
     /* Pulse */
@@ -1079,9 +1333,12 @@ static void process_world(void)
             p_ptr->update |= (PU_VIEW | PU_LITE | PU_MONSTERS);
             p_ptr->redraw |= (PR_MAP);
             handle_stuff();
-            Term_fresh();
 
-            usleep(150000); /* 150ms flash */
+            /* Show the flash, unless busy running or resting */
+            if (!p_ptr->running && !p_ptr->resting && !p_ptr->command_rep) {
+                Term_fresh();
+                Term_xtra(TERM_XTRA_DELAY, 150); /* 150ms flash */
+            }
 
             vision_pulse = FALSE;
             p_ptr->update |= (PU_VIEW | PU_LITE | PU_MONSTERS);
@@ -1093,7 +1350,9 @@ static void process_world(void)
     shift_timer++;
     if (shift_timer >= 50) {
         shift_timer = 0;
+        metric_start(METRIC_T_PROCESS_TERRAIN);
         rearrange_dark_sectors();
+        metric_stop(METRIC_T_PROCESS_TERRAIN);
     }
 
 	/* Every 10 game turns */
@@ -1123,30 +1382,19 @@ static void process_world(void)
 
 	/* Delayed Contraction: walls move every 2 player turns (20 game turns) */
 	if ((turn % 20) == 0)
+	{
+		metric_start(METRIC_T_PROCESS_TERRAIN);
 		process_crushing_room();
-
-	/* Tome Decipher Timer */
-	if (tome_decipher_turns > 0) {
-		tome_decipher_turns--;
-		if (tome_decipher_turns == 0) {
-			msg_print("Your tome has been completed!");
-
-			if (tome_decipher_idx >= 0 && tome_decipher_idx < MAX_LORE)
-			{
-				lore_known |= (1L << tome_decipher_idx);
-				msg_format("You decipher the ancient text: %s", lore_text[tome_decipher_idx]);
-			}
-			else
-			{
-				msg_print("The tome contained gibberish.");
-			}
-
-			tome_decipher_idx = 0;
-		}
+		metric_stop(METRIC_T_PROCESS_TERRAIN);
 	}
 
+	metric_start(METRIC_T_PROCESS_TERRAIN);
 	process_boulders();
+	metric_stop(METRIC_T_PROCESS_TERRAIN);
+
+	metric_start(METRIC_T_PROCESS_ENVIRONMENT);
 	process_environment();
+	metric_stop(METRIC_T_PROCESS_ENVIRONMENT);
 
 	update_dynamic_spell_costs();
 
@@ -1213,20 +1461,15 @@ static void process_world(void)
 				/* Message */
 				msg_print("The sun has risen.");
 
+				/* Assume lit (and wiz-lite if appropriate) */
+				cave_info_set_all(wiz_lite_town ? (CAVE_GLOW | CAVE_MARK) :
+				                  (CAVE_GLOW));
+
 				/* Hack -- Scan the town */
 				for (y = 0; y < DUNGEON_HGT; y++)
 				{
 					for (x = 0; x < DUNGEON_WID; x++)
 					{
-						/* Assume lit */
-						cave_info[y][x] |= (CAVE_GLOW);
-
-						/* Wiz-lite if appropriate. */
-						if (wiz_lite_town)
-						{
-							cave_info[y][x] |= CAVE_MARK;
-						}
-
 						/* Memorize */
 						note_spot(y, x);
 					}
@@ -1301,18 +1544,12 @@ static void process_world(void)
 		/* Update the stores once a day (while in dungeon) */
 		if (!(turn % (10L * STORE_TURNS)))
 		{
-			int n;
-
 			/* Message */
 			if (cheat_xtra)
 				msg_print("Updating Shops...");
 
-			/* Maintain each shop (except home) */
-			for (n = 0; n < MAX_STORES - 1; n++)
-			{
-				/* Maintain */
-				store_maint(n);
-			}
+			/* Maintain each shop (except home) when next entered */
+			store_maint_owe();
 
 			/* Select new bounties. */
 			select_bounties();
@@ -1530,6 +1767,9 @@ static void process_world(void)
 
 	/*** Timeout Various Things ***/
 
+	/* Hack -- effects running out together share one update */
+	hold_stuff = TRUE;
+
 	/* Hack -- Hallucinating */
 	if (p_ptr->image)
 	{
@@ -1672,8 +1912,12 @@ static void process_world(void)
 
 	if (p_ptr->anti_magic > 0) p_ptr->anti_magic--;
 
+	/* Handle the effects which ran out */
+	hold_stuff = FALSE;
+	handle_stuff();
+
 	/* Gravity Pull */
-	if (TRUE)
+	if (gravity_trap_n)
 	{
 		int dy, dx, gy = 0, gx = 0;
 		int min_dist = 999;
@@ -1888,45 +2132,52 @@ static void process_world(void)
 
 	/*** Process Objects ***/
 
-	/* Process objects, dungeon and home. */
-	o_ptr = o_list;
-
-	for (o_ptr = o_list, j = 0; j < 2; o_ptr = store[7].stock, j++)
+	/* Process objects, dungeon and home (only if there is something to do) */
+	if (object_charging_n || !(turn % 10000))
 	{
-		object_type *o_nxt;
+		/* Count them again */
+		object_charging_n = 0;
 
-		while (o_ptr)
+		for (o_ptr = o_list, j = 0; j < 2; o_ptr = store[7].stock, j++)
 		{
-			o_nxt = o_ptr->next_global;
+			object_type *o_nxt;
 
-			/* Skip dead objects */
-			if (!o_ptr->k_idx)
+			while (o_ptr)
 			{
-				o_ptr = o_nxt;
-				continue;
-			}
+				o_nxt = o_ptr->next_global;
 
-			/* Recharge activatable objects */
-			if (o_ptr->timeout > 0)
-			{
-				/* Recharge */
-				o_ptr->timeout--;
+				/* Skip dead objects */
+				if (!o_ptr->k_idx)
+				{
+					o_ptr = o_nxt;
+					continue;
+				}
 
-				/* Notice changes */
-				if (!o_ptr->timeout && (o_ptr->stack == STACK_INVEN))
+				/* Recharge activatable objects */
+				if (o_ptr->timeout > 0)
 				{
-					/* Window stuff */
-					p_ptr->window |= (PW_EQUIP);
+					/* Recharge */
+					o_ptr->timeout--;
+
+					/* Notice changes */
+					if (!o_ptr->timeout && (o_ptr->stack == STACK_INVEN))
+					{
+						/* Window stuff */
+						p_ptr->window |= (PW_EQUIP);
+					}
+
+					/* Still recharging */
+					if (o_ptr->timeout) object_charging_n++;
 				}
-			}
 
-			/* Corpses decompose. (Slowly.) */
-			if (!(turn % 10000) && (o_ptr->stuff == STUFF_FLESH))
-			{
-				object_take_hit(o_ptr, 1, "rotted away");
-			}
+				/* Corpses decompose. (Slowly.) */
+				if (!(turn % 10000) && (o_ptr->stuff == STUFF_FLESH))
+				{
+					object_take_hit(o_ptr, 1, "rotted away");
+				}
 
-			o_ptr = o_nxt;
+				o_ptr = o_nxt;
+			}
 		}
 	}
 
@@ -1939,64 +2190,8 @@ static void process_world(void)
 		teleport_player(40);
 	}
 
-	/* Delayed Word-of-Recall */
-	if (p_ptr->word_recall)
-	{
-		/* Count down towards recall */
-		p_ptr->word_recall--;
-
-		/* Activate the recall */
-		if (!p_ptr->word_recall)
-		{
-			/* Disturbing! */
-			disturb(0, 0);
-
-			/* Ghosts don't WoR */
-
-			if (p_ptr->prace == RACE_GHOST && !p_ptr->prace_info)
-			{
-				msg_print("You feel a terrible sense of loss.");
-				return;
-			}
-
-			/* Determine the level */
-			if (p_ptr->depth && 
-			    p_ptr->inside_special != SPECIAL_WILD)
-			{
-				prepare_recall_ambush();
-				mprint(MSG_BONUS, "You feel yourself yanked upwards!");
-				p_ptr->inside_special = SPECIAL_WILD;
-				p_ptr->leaving = TRUE;
-
-				/* HACK -- Teleport to the town */
-				p_ptr->wild_x = 0;
-				p_ptr->wild_y = 0;
-				p_ptr->wilderness_depth = 0;
-				p_ptr->px = 0;
-				p_ptr->py = 0;
-			}
-			else
-			{
-				mprint(MSG_BONUS, "You feel yourself yanked downwards!");
-
-				dungeon_save_wilderness_location();
-
-				/* New depth */
-				p_ptr->depth = p_ptr->max_depth;
-
-				if (p_ptr->depth < 1)
-					p_ptr->depth = 1;
-
-				p_ptr->inside_special = 0;
-
-				/* Leaving */
-				p_ptr->leaving = TRUE;
-			}
-
-			/* Sound */
-			sound(SOUND_TPLEVEL);
-		}
-	}
+	/* Scheduled events (word of recall, ...) */
+	process_events();
 }
 
 
@@ -2918,7 +3113,7 @@ static void process_player(void)
 				(p_ptr->perma_blind ? 1 : !p_ptr->blind) &&
 				!p_ptr->confused && !p_ptr->poisoned && !p_ptr->afraid &&
 				!p_ptr->stun && !p_ptr->cut && !p_ptr->slow &&
-				!p_ptr->paralyzed && !p_ptr->image && !p_ptr->word_recall
+				!p_ptr->paralyzed && !p_ptr->image && !event_when(EVENT_RECALL)
 				&& p_ptr->immov_cntr == 0)
 			{
 				disturb(0, 0);
@@ -2979,7 +3174,7 @@ static void process_player(void)
 
 		/* Refresh (optional) */
 		if (fresh_before)
-			Term_fresh();
+			fresh_limited();
 
 
 		/* Hack -- cancel "lurking browse mode" */
@@ -3007,8 +3202,9 @@ static void process_player(void)
 				/* Reduce rest count */
 				p_ptr->resting--;
 
-				/* Redraw the state */
-				p_ptr->redraw |= (PR_STATE);
+				/* Redraw the state (long rests show hundreds) */
+				if ((p_ptr->resting < 1000) || (p_ptr->resting % 100 == 99))
+					p_ptr->redraw |= (PR_STATE);
 			}
 
 			/* Take a turn */
@@ -3274,6 +3470,14 @@ static void dungeon(void)
 	disturb(1, 0);
 
 
+	/* Benchmarks may change the level */
+	bench_level();
+	fuzz_level();
+
+	/* Let the script look at the level */
+	script_on_level_gen();
+
+
 	/* Track maximum player level */
 	if (p_ptr->max_lev < p_ptr->lev)
 	{
@@ -3349,6 +3553,9 @@ static void dungeon(void)
 	/* Redraw dungeon */
 	p_ptr->redraw |= (PR_WIPE | PR_BASIC | PR_EXTRA);
 
+	/* Forget the look of the old level */
+	map_info_forget_all();
+
 	/* Redraw map */
 	p_ptr->redraw |= (PR_MAP);
 
@@ -3429,8 +3636,8 @@ static void dungeon(void)
 		if (m_cnt + 32 > MAX_M_IDX)
 			compact_monsters(64);
 
-		/* Hack -- Compress the monster list occasionally */
-		if (m_cnt + 32 < m_max)
+		/* Hack -- Compress the monster list when mostly holes */
+		if (2 * m_cnt + 32 < m_max)
 			compact_monsters(0);
 
 		/* Process the player */
@@ -3457,15 +3664,20 @@ static void dungeon(void)
 
 		/* Optional fresh */
 		if (fresh_after)
-			Term_fresh();
+			fresh_limited();
 
 		/* Handle "leaving" */
 		if (p_ptr->leaving)
 			break;
 
 
+		/* Place the monsters which followed the player here */
+		process_pursuit();
+
 		/* Process all of the monsters */
+		metric_start(METRIC_T_PROCESS_MONSTERS);
 		process_monsters();
+		metric_stop(METRIC_T_PROCESS_MONSTERS);
 
 		/* Notice stuff */
 		if (p_ptr->notice)
@@ -3488,15 +3700,27 @@ static void dungeon(void)
 
 		/* Optional fresh */
 		if (fresh_after)
-			Term_fresh();
+			fresh_limited();
 
 		/* Handle "leaving" */
 		if (p_ptr->leaving)
 			break;
 
 
+		/* Report on a background save, or start an automatic one */
+		if (!save_background_check(FALSE) && autosave_game &&
+			!(turn % AUTOSAVE_FREQ) && !p_ptr->is_dead)
+		{
+			do_cmd_autosave();
+		}
+
 		/* Process the world */
+		metric_start(METRIC_T_PROCESS_WORLD);
 		process_world();
+		metric_stop(METRIC_T_PROCESS_WORLD);
+
+		/* Let the script look at the turn */
+		script_on_turn();
 
 		/* Notice stuff */
 		if (p_ptr->notice)
@@ -3519,7 +3743,7 @@ static void dungeon(void)
 
 		/* Optional fresh */
 		if (fresh_after)
-			Term_fresh();
+			fresh_limited();
 
 		/* Handle "leaving" */
 		if (p_ptr->leaving)
@@ -3529,6 +3753,9 @@ static void dungeon(void)
 		/* Count game turns */
 		turn++;
 
+		/* Add up the profiler's samples */
+		prof_turn();
+
 		if (arg_headless)
 		{
 			static struct timeval last_turn_time;
@@ -3545,9 +3772,14 @@ static void dungeon(void)
 				gettimeofday(&tv_end, NULL);
 				long duration = (tv_end.tv_sec - last_turn_time.tv_sec) * 1000 + (tv_end.tv_usec - last_turn_time.tv_usec) / 1000;
 				log_metric("turn", duration);
+				metric_turn();
+				fuzz_turn(duration);
 				last_turn_time = tv_end;
 			}
 
+			bench_turn();
+			soak_turn();
+
 			if (arg_headless_turns > 0 && turn >= arg_headless_turns)
 			{
 				p_ptr->is_dead = TRUE;
@@ -3555,6 +3787,31 @@ static void dungeon(void)
 			}
 		}
 	}
+
+	/* Report the caches and monster tiers for this level */
+	if (arg_headless)
+	{
+		log_metric("sight_cache_hits", (long)sight_cache_hits);
+		log_metric("sight_cache_misses", (long)sight_cache_misses);
+
+		log_metric("alloc_cache_hits", (long)alloc_cache_hits);
+		log_metric("alloc_cache_misses", (long)alloc_cache_misses);
+
+		log_metric("monster_full_us", (long)mon_tier_full_us);
+		log_metric("monster_full_turns", (long)mon_tier_full_n);
+		log_metric("monster_dormant_us", (long)mon_tier_dormant_us);
+		log_metric("monster_dormant_turns", (long)mon_tier_dormant_n);
+
+		/* And the memory */
+		metric_memory();
+	}
+
+	sight_cache_hits = sight_cache_misses = 0;
+
+	alloc_cache_hits = alloc_cache_misses = 0;
+
+	mon_tier_full_us = mon_tier_full_n = 0;
+	mon_tier_dormant_us = mon_tier_dormant_n = 0;
 }
 
 
@@ -3712,6 +3969,16 @@ void play_game(bool new_game)
 		Rand_state_init(seed);
 	}
 
+	/* Hack -- a fixed seed */
+	if (arg_seed)
+	{
+		Rand_quick = FALSE;
+		Rand_state_init(arg_seed);
+	}
+
+	/* Note the seed in the journal (or take it from there) */
+	journal_seed();
+
 	/* Roll new character */
 	if (new_game)
 	{
@@ -3740,6 +4007,10 @@ void play_game(bool new_game)
 		/* Hack -- enter the world */
 		turn = 1;
 
+		/* Benchmarks start at their own depth */
+		bench_birth();
+		fuzz_birth();
+
 		/* Read the default options */
 		process_pref_file("birth.prf");
 	}
@@ -3914,14 +4185,14 @@ void play_game(bool new_game)
 				(void) set_food(PY_FOOD_MAX - 1);
 
 				/* Hack -- cancel recall */
-				if (p_ptr->word_recall)
+				if (event_when(EVENT_RECALL))
 				{
 					/* Message */
 					msg_print("A tension leaves the air around you...");
 					msg_print(NULL);
 
 					/* Hack -- Prevent recall */
-					p_ptr->word_recall = 0;
+					event_cancel(EVENT_RECALL);
 				}
 
 				/* Note cause of death XXX XXX XXX */
@@ -3998,14 +4269,14 @@ void play_game(bool new_game)
 				(void) set_food(PY_FOOD_MAX - 1);
 
 				/* Hack -- cancel recall */
-				if (p_ptr->word_recall)
+				if (event_when(EVENT_RECALL))
 				{
 					/* Message */
 					msg_print("A tension leaves the air around you...");
 					msg_print(NULL);
 
 					/* Hack -- Prevent recall */
-					p_ptr->word_recall = 0;
+					event_cancel(EVENT_RECALL);
 				}
 
 				/* Note cause of death XXX XXX XXX */
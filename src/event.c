@@ -0,0 +1,255 @@
+/* File: event.c */
+
+/*
+ * Scheduled events
+ *
+ * Things which happen a fixed time after they are set up (the end of a
+ * word of recall, the Scholar finishing a tome) are kept in a small
+ * heap, ordered by the game turn they are due on, instead of counters
+ * which "process_world()" would count down every ten game turns.  The
+ * world only has to look at the top of the heap (see "event_due()").
+ *
+ * Events are due on "world ticks", the game turns which are multiples
+ * of ten, like the counters they replace.  The heap is saved with the
+ * character, as absolute game turns.
+ */
+
+#include "angband.h"
+
+
+/*
+ * The heap ("event_heap[0]" is due first)
+ */
+static event_type event_heap[EVENT_MAX];
+static int event_num = 0;
+
+
+/*
+ * Is event "i" due before event "j"?
+ *
+ * Events due on the same turn keep the order they were posted in.
+ */
+static bool event_before(int i, int j)
+{
+	if (event_heap[i].turn != event_heap[j].turn)
+		return (event_heap[i].turn < event_heap[j].turn);
+
+	return (event_heap[i].seq < event_heap[j].seq);
+}
+
+
+/*
+ * Swap two events
+ */
+static void event_swap(int i, int j)
+{
+	event_type tmp = event_heap[i];
+
+	event_heap[i] = event_heap[j];
+	event_heap[j] = tmp;
+}
+
+
+/*
+ * Move event "i" up the heap, to where it belongs
+ */
+static void event_sift_up(int i)
+{
+	while (i > 0)
+	{
+		int p = (i - 1) / 2;
+
+		if (!event_before(i, p)) break;
+
+		event_swap(i, p);
+		i = p;
+	}
+}
+
+
+/*
+ * Move event "i" down the heap, to where it belongs
+ */
+static void event_sift_down(int i)
+{
+	while (TRUE)
+	{
+		int c = 2 * i + 1;
+
+		if (c >= event_num) break;
+
+		/* The earlier child */
+		if ((c + 1 < event_num) && event_before(c + 1, c)) c++;
+
+		if (!event_before(c, i)) break;
+
+		event_swap(i, c);
+		i = c;
+	}
+}
+
+
+/*
+ * Remove event "i" from the heap
+ */
+static void event_remove(int i)
+{
+	event_num--;
+
+	if (i == event_num) return;
+
+	event_heap[i] = event_heap[event_num];
+
+	event_sift_down(i);
+	event_sift_up(i);
+}
+
+
+/*
+ * Forget every event (for a new character)
+ */
+void event_wipe(void)
+{
+	event_num = 0;
+}
+
+
+/*
+ * The game turn of the "n"th world tick from now
+ *
+ * A counter set to "n" during a game turn ran out on the world tick of
+ * that turn (if it was one) or the next, plus "n - 1" more.  The world
+ * ticks after the player and the monsters have moved.
+ */
+s32b event_ticks(int n)
+{
+	return (((turn + 9) / 10) * 10 + (s32b)(n - 1) * 10);
+}
+
+
+/*
+ * The game turn jumped ahead from "old_turn" (a night at the inn), which
+ * the counters of old did not count, so put off every event by as much,
+ * in world ticks
+ *
+ * An event keeps as many world ticks to go as it had, so the order of
+ * the heap does not change.
+ */
+void event_skip(s32b old_turn)
+{
+	s32b was = ((old_turn + 9) / 10) * 10;
+	s32b now = ((turn + 9) / 10) * 10;
+	int i;
+
+	for (i = 0; i < event_num; i++)
+	{
+		/* Overdue events stay due */
+		if (event_heap[i].turn < was) continue;
+
+		event_heap[i].turn += now - was;
+	}
+}
+
+
+/*
+ * Schedule an event of kind "kind" for game turn "when"
+ *
+ * Returns FALSE if the heap is full.
+ */
+bool event_post(int kind, s32b when, s16b data)
+{
+	static u32b seq = 0;
+
+	event_type *e_ptr;
+
+	/* Paranoia */
+	if (event_num >= EVENT_MAX) return (FALSE);
+
+	e_ptr = &event_heap[event_num];
+
+	e_ptr->turn = when;
+	e_ptr->seq = seq++;
+	e_ptr->kind = kind;
+	e_ptr->data = data;
+
+	event_sift_up(event_num++);
+
+	return (TRUE);
+}
+
+
+/*
+ * Forget every event of kind "kind"
+ */
+void event_cancel(int kind)
+{
+	int i = 0;
+
+	while (i < event_num)
+	{
+		if (event_heap[i].kind == kind)
+		{
+			event_remove(i);
+
+			/* Look at the event moved here */
+			i = 0;
+			continue;
+		}
+
+		i++;
+	}
+}
+
+
+/*
+ * The game turn the first event of kind "kind" is due on, or 0 if none
+ */
+s32b event_when(int kind)
+{
+	int i;
+	s32b when = 0;
+
+	for (i = 0; i < event_num; i++)
+	{
+		if (event_heap[i].kind != kind) continue;
+
+		if (!when || (event_heap[i].turn < when)) when = event_heap[i].turn;
+	}
+
+	return (when);
+}
+
+
+/*
+ * Take the first event off the heap, if it is due by now
+ */
+bool event_due(event_type *e_ptr)
+{
+	if (!event_num) return (FALSE);
+
+	if (event_heap[0].turn > turn) return (FALSE);
+
+	*e_ptr = event_heap[0];
+
+	event_remove(0);
+
+	return (TRUE);
+}
+
+
+/*
+ * The number of events waiting (for the savefile)
+ */
+int event_count(void)
+{
+	return (event_num);
+}
+
+
+/*
+ * Access the "i"th waiting event (for the savefile)
+ */
+event_type *event_at(int i)
+{
+	return (&event_heap[i]);
+}
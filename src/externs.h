@@ -95,6 +95,11 @@ extern bool arg_fiddle;
 extern bool arg_wizard;
 extern bool arg_headless;
 extern int arg_headless_turns;
+extern bool arg_fast;
+extern bool arg_startup_profile;
+extern bool arg_metrics_binary;
+extern int arg_metrics_rss_msec;
+extern u32b arg_seed;
 extern bool arg_sound;
 extern bool arg_graphics;
 extern bool arg_force_original;
@@ -116,10 +121,13 @@ extern s16b monster_level;
 extern s32b turn;
 extern s32b old_turn;
 extern s32b old_resting_turn;
+extern u16b disturb_why;
+extern s32b disturb_turn;
 extern bool use_sound;
 extern bool use_graphics;
 extern s16b signal_count;
 extern bool msg_flag;
+extern bool hold_stuff;
 extern bool inkey_base;
 extern bool inkey_xtra;
 extern bool inkey_scan;
@@ -132,10 +140,6 @@ extern bool repair_mflag_born;
 extern bool repair_mflag_nice;
 extern bool repair_mflag_show;
 extern bool repair_mflag_mark;
-extern s16b o_max;
-extern s16b o_cnt;
-extern s16b m_max;
-extern s16b m_cnt;
 extern s16b m_pet_num;
 extern s16b m_generators;
 extern s16b screen_x;
@@ -153,9 +157,7 @@ extern bool crushing_active;
 extern int crushing_cy;
 extern int crushing_cx;
 extern int crushing_dist;
-extern s16b tome_decipher_turns;
 extern u32b lore_known;
-extern s16b tome_decipher_idx;
 extern int player_uid;
 extern int player_euid;
 extern int player_egid;
@@ -169,26 +171,50 @@ extern s16b view_x[VIEW_MAX];
 extern s16b temp_n;
 extern s16b temp_y[TEMP_MAX];
 extern s16b temp_x[TEMP_MAX];
+extern s32b env_active_n;
+extern s16b env_active_y[ENV_ACTIVE_MAX];
+extern s16b env_active_x[ENV_ACTIVE_MAX];
+extern s32b note_grid_n;
+extern s16b note_grid_y[NOTE_GRID_MAX];
+extern s16b note_grid_x[NOTE_GRID_MAX];
+extern s16b active_wall_n;
+extern s16b active_wall_y[ACTIVE_WALL_MAX];
+extern s16b active_wall_x[ACTIVE_WALL_MAX];
+extern s16b boulder_n;
+extern s16b boulder_y[BOULDER_MAX];
+extern s16b boulder_x[BOULDER_MAX];
+extern s16b sanctum_door_n;
+extern s16b sanctum_door_y[SANCTUM_DOOR_MAX];
+extern s16b sanctum_door_x[SANCTUM_DOOR_MAX];
+extern bool sanctum_door_full;
+extern s16b dark_sector_n;
+extern dark_sector dark_sectors[DARK_SECTOR_MAX];
+extern u32b terrain_epoch;
+extern s32b magnet_trap_n;
+extern s32b gravity_trap_n;
+extern s32b object_charging_n;
+extern u32b mon_tier_full_us;
+extern u32b mon_tier_full_n;
+extern u32b mon_tier_dormant_us;
+extern u32b mon_tier_dormant_n;
+extern u32b sight_cache_hits;
+extern u32b sight_cache_misses;
+extern u32b mon_alloc_epoch;
+extern u32b alloc_cache_hits;
+extern u32b alloc_cache_misses;
 extern s16b macro__num;
 extern cptr *macro__pat;
 extern cptr *macro__act;
 extern bool *macro__cmd;
 extern s16b quark__num;
 extern cptr *quark__str;
-extern u16b message__next;
-extern u16b message__last;
-extern u16b message__head;
-extern u16b message__tail;
-extern u16b *message__ptr;
-extern byte *message__pty;
-extern char *message__buf;
+extern u32b message__count;
+extern u32b message__stamp;
+extern message_type *message__list;
 extern term *angband_term[8];
 extern char angband_term_name[8][16];
 extern byte angband_color_table[256][4];
 extern char angband_sound_name[SOUND_MAX][16];
-extern object_type *o_list;
-extern monster_type m_list[MAX_M_IDX];
-extern monster_guard_data *m_guard[MAX_M_IDX];
 extern generator gen_list[MAX_GENERATORS];
 extern byte recipe_recall[MAX_RECIPES];
 extern byte quest_status[MAX_QUESTS];
@@ -205,6 +231,7 @@ extern u16b activation_num;
 extern random_artifact random_artifacts[MAX_RANDARTS];
 extern store_type *store;
 extern object_type *inventory;
+extern bool inven_unsensed;
 extern object_type *equipment[EQUIP_MAX];
 extern s16b alloc_kind_size;
 extern alloc_entry *alloc_kind_table;
@@ -275,18 +302,39 @@ extern bool hack_punish_theft;
 extern byte object_desc_mode;
 extern bool store_combine_flag;
 
-extern s16b cave_cost[DUNGEON_HGT][DUNGEON_WID];
-extern s16b cave_when[DUNGEON_HGT][DUNGEON_WID];
-extern cave_type cave[DUNGEON_HGT][DUNGEON_WID];
-extern s16b cave_elev[DUNGEON_HGT][DUNGEON_WID];
-extern u16b cave_info[DUNGEON_HGT][DUNGEON_WID];
-extern byte cave_sector[DUNGEON_HGT][DUNGEON_WID];
-extern byte cave_feat[DUNGEON_HGT][DUNGEON_WID];
-extern cover_data *cave_cover[DUNGEON_HGT][DUNGEON_WID];
-extern object_type *cave_o_idx[DUNGEON_HGT][DUNGEON_WID];
-extern s16b cave_m_idx[DUNGEON_HGT][DUNGEON_WID];
+extern game_type *game_ptr;
+
+/*
+ * The parts of the current game, under their old names
+ */
+#define o_max		(game_ptr->obj_max)
+#define o_cnt		(game_ptr->obj_cnt)
+#define m_max		(game_ptr->mon_max)
+#define m_cnt		(game_ptr->mon_cnt)
+#define cave_hgt	(game_ptr->hgt)
+#define cave_wid	(game_ptr->wid)
+#define o_list		(game_ptr->objects)
+#define m_list		(game_ptr->monsters)
+#define m_free		(game_ptr->mon_free)
+#define m_free_n	(game_ptr->mon_free_num)
+#define m_gen		(game_ptr->mon_gen)
+#define m_guard_list	(game_ptr->guards)
+#define m_guard_max	(game_ptr->guard_max)
+#define m_guard_idx	(game_ptr->guard_idx)
+#define cave_flow	(game_ptr->flow)
+#define cave		(game_ptr->grid)
+#define cave_info	(game_ptr->info)
+#define cave_sector	(game_ptr->sector)
+#define cave_feat	(game_ptr->feat)
+#define cave_light	(game_ptr->light)
+#define cave_elev_walk	(game_ptr->elev_walk)
+#define cave_cover	(game_ptr->cover)
+#define cave_cover_n	(game_ptr->cover_num)
+#define cave_o_idx	(game_ptr->o_idx)
+#define cave_m_idx	(game_ptr->m_idx)
 extern byte unstable_scroll_map[15];
 extern cptr unstable_scroll_names[15];
+extern cptr mem_tag_names[MEM_TAGS];
 
 
 /*
@@ -298,6 +346,9 @@ extern void player_birth(void);
 
 /* cover.c */
 extern void init_cover_system(void);
+extern int cover_count(void);
+extern cover_data *cover_at_slot(int i);
+extern bool cover_restore(int y, int x, int cover_type, int durability, int max_durability, int feat);
 extern int get_cover_at(int y, int x);
 extern int get_cover_vs_direction(int ty, int tx, int ay, int ax);
 extern bool attack_through_cover(int ay, int ax, int ty, int tx, int *damage, int *cover_damage);
@@ -309,28 +360,54 @@ extern void populate_cover_features(void);
 
 /* cave.c */
 extern int distance(int y1, int x1, int y2, int x2);
+extern void sight_cache_wipe(void);
 extern bool los(int y1, int x1, int y2, int x2);
 extern bool player_can_see_bold(int y, int x);
 extern bool no_lite(void);
 extern bool cave_valid_bold(int y, int x);
+extern void map_info_forget(int y, int x);
+extern void map_info_forget_all(void);
 extern void map_info(int y, int x, byte * ap, char *cp);
 extern void move_cursor_relative(int y, int x);
 extern void print_rel(char c, byte a, int y, int x);
+extern void print_fx(char c, byte a, int y, int x, int life);
 extern void note_spot(int y, int x);
 extern void lite_spot(int y, int x);
 extern void prt_map(void);
+extern bool prt_map_scroll(int dy, int dx);
 extern void display_map(int scale);
 extern void do_cmd_view_map(void);
 extern void forget_lite(void);
 extern void update_lite(void);
 extern void forget_view(void);
+extern void view_note_change(int y, int x);
 extern void update_view(void);
 extern void forget_flow(void);
+extern void flow_invalidate(int y, int x);
 extern void update_flow(void);
 extern void map_area(void);
 extern void wiz_lite(void);
+extern void cave_info_set_all(u16b flags);
+extern void cave_info_clear_all(u16b flags);
 extern void wiz_dark(void);
 extern void cave_set_feat(int y, int x, int feat);
+extern void env_active_add(int y, int x);
+extern void floor_note_change(int y, int x, bool was_floor);
+extern bool pick_floor_grid(int cy, int cx, int min, int max,
+	bool (*okay)(int y, int x), int *yp, int *xp);
+extern bool feat_notable(int feat);
+extern void note_grid_add(int y, int x);
+extern void active_wall_add(int y, int x);
+extern void boulder_add(int y, int x);
+extern void rebuild_active_walls(void);
+extern void dark_sector_add(int y1, int x1, int y2, int x2);
+extern int dark_sector_find(int y, int x);
+extern void rebuild_dark_sectors(void);
+extern void rebuild_level_indexes(void);
+extern game_type *game_make(void);
+extern void game_kill(game_type *g_ptr);
+extern game_type *game_switch(game_type *g_ptr);
+extern void init_paths(void);
 extern void mmove2(int *y, int *x, int y1, int x1, int y2, int x2);
 extern bool projectable(int y1, int x1, int y2, int x2);
 extern bool target_clear(monster_type * m_ptr, int x2, int y2);
@@ -339,12 +416,15 @@ extern void scatter(int *yp, int *xp, int y, int x, int d, int m);
 extern void health_track(int m_idx);
 extern void monster_race_track(int r_idx);
 extern void object_kind_track(int k_idx);
-extern void disturb(int stop_search, int unused_flag);
+extern void disturb(int stop_search, int why);
 
 /* Elevation functions */
 extern int get_elevation(int y, int x);
 extern void set_elevation(int y, int x, int elev);
 extern void init_elevation(void);
+extern void elev_pass_grid(int y, int x);
+extern void elev_pass_note(int y, int x);
+extern void elev_slope_mark(int y, int x);
 extern int elevation_diff(int y1, int x1, int y2, int x2);
 extern bool has_high_ground(int ay, int ax, int ty, int tx);
 extern int elev_to_hit_mod(int ay, int ax, int ty, int tx);
@@ -464,6 +544,7 @@ extern void remove_mutation(void);
 
 extern void add_powers(byte class);
 extern void remove_powers(byte class);
+extern void forget_dynamic_spell_costs(void);
 extern void update_dynamic_spell_costs(void);
 
 extern void add_psionic_spark_spell(void);
@@ -482,6 +563,7 @@ extern void do_cmd_aim_wand(void);
 extern void do_cmd_zap_rod(void);
 extern void do_cmd_activate(void);
 
+extern void recipe_init(void);
 extern void do_cmd_brew_stuff(void);
 extern void do_cmd_sacrifice(void);
 
@@ -499,6 +581,17 @@ extern void trigger_unstable_effect(int effect_id, bool stabilized);
 extern object_type *item_effect(cptr, cptr, bool, bool, int,
 	bool(hook) (object_type *), s16b);
 
+/* event.c */
+extern void event_wipe(void);
+extern s32b event_ticks(int n);
+extern void event_skip(s32b old_turn);
+extern bool event_post(int kind, s32b when, s16b data);
+extern void event_cancel(int kind);
+extern s32b event_when(int kind);
+extern bool event_due(event_type *e_ptr);
+extern int event_count(void);
+extern event_type *event_at(int i);
+
 /* dungeon.c */
 extern void dungeon_save_wilderness_location(void);
 extern void play_game(bool new_game);
@@ -521,6 +614,7 @@ extern void process_player_name(bool sf);
 extern void get_name(void);
 extern void do_cmd_suicide(void);
 extern void do_cmd_save_game(void);
+extern void do_cmd_autosave(void);
 extern long total_points(void);
 extern void display_scores(int from, int to);
 extern void open_highscore(void);
@@ -546,6 +640,7 @@ extern s16b get_num_lines_old(char *fname);
 /* generate.c */
 extern void generate_cave(void);
 extern void wilderness_gen(void); /* -KMW- */
+extern bool wild_prefetch(void);
 extern void place_dungeon_merchant(int y, int x);
 
 /* init1.c */
@@ -565,6 +660,7 @@ extern void init_angband(void);
 extern bool is_sanctum_wall(int y, int x);
 extern void build_sanctum_vault(int y, int x);
 extern void reset_puzzle_state(void);
+extern void sanctum_door_add(int y, int x);
 extern void interaction_rune(int y, int x);
 extern void interaction_lever(int y, int x);
 extern void interaction_plate(int y, int x);
@@ -587,19 +683,27 @@ extern void screen_roff(int r_idx, int remember);
 extern void display_roff(int r_idx);
 
 /* monster2.c */
+extern void rebuild_monster_buckets(void);
+extern int monster_near(int y, int x, int rad, s16b *who, int max);
+extern bool monster_may_multiply(int m_idx);
 extern void delete_monster_idx(int i);
 extern void maintain_pet_limit(void);
 extern void delete_monster(int y, int x);
 extern void compact_monsters(int size);
 extern void wipe_m_list(void);
 extern s16b m_pop(void);
+extern u32b m_handle(int m_idx);
+extern int m_handle_idx(u32b h);
 extern errr get_mon_num_prep(void);
+extern int alloc_cache_find(alloc_cache *c_ptr, long value);
 extern s16b get_mon_num(int level);
 extern void monster_desc(char *desc, monster_type * m_ptr, int mode);
 extern void lore_do_probe(int m_idx);
 extern void lore_treasure(int m_idx, int num_item, int num_gold);
 extern void update_mon(int m_idx, bool full);
 extern void update_monsters(bool full);
+extern void mon_terrain_init(void);
+extern u16b mon_terrain(monster_type *m_ptr, int feat);
 extern bool monster_check_cliff_move(int m_idx, int ny, int nx);
 extern void monster_swap(int y1, int x1, int y2, int x2);
 extern void mon_process_terrain(int m_idx, int y, int x);
@@ -607,6 +711,7 @@ extern s16b player_place(int y, int x);
 extern s16b monster_place(int y, int x, monster_type * n_ptr);
 extern bool place_monster_aux(int y, int x, int r_idx, int flags);
 extern bool place_monster(int y, int x, int flags);
+extern int alloc_monster_flags(int flags);
 extern bool alloc_monster(int dis, int flags);
 extern bool summon_specific(int y1, int x1, int lev, int type);
 extern bool summon_specific_friendly(int y1, int x1, int lev, int type);
@@ -659,6 +764,10 @@ extern bool insert_to_stack(object_type * o_ptr, object_type ** stack);
 extern void insert_to_global_list(object_type * o_ptr,
 	object_type ** stack, byte world);
 extern object_type *new_object(void);
+extern object_type *object_alloc(void);
+extern void object_free(object_type *o_ptr);
+extern void object_pool_stats(s32b *live, s32b *slabs);
+extern void object_pool_notes(bool *used);
 extern bool floor_carry(int y, int x, object_type * o_ptr);
 extern bool inven_carry(object_type * o_ptr);
 extern bool monster_inven_carry(monster_type * m_ptr, object_type * o_ptr);
@@ -709,10 +818,14 @@ extern void link_insert_glob(object_type *a, object_type *b, object_type *c);
 extern void link_remove_glob(object_type *a);
 
 /* save.c */
+extern bool save_background_check(bool wait);
+extern bool save_player_background(bool *background, bool quiet);
 extern bool save_player(void);
 extern bool load_player(void);
 extern bool load_dungeon(s16b tag);
 extern bool save_dungeon(s16b tag);
+extern void level_cache_flush(void);
+extern bool level_cache_take(s16b tag, byte **data, u32b *len, u32b *size);
 
 /* spells1.c */
 extern s16b poly_r_idx(int r_idx);
@@ -723,6 +836,7 @@ extern void teleport_player_directed(int rad, int dir);
 extern void teleport_player_to(int ny, int nx);
 extern void teleport_player_level(void);
 extern void take_hit(int dam, cptr kb_str);
+extern void init_gf_info(void);
 extern void take_sanity_hit(int dam, cptr kb_str);
 
 extern bool hates_acid(object_type * o_ptr);
@@ -736,6 +850,7 @@ extern bool hates_sound(object_type * o_ptr);
 extern bool hates_impact(object_type * o_ptr);
 
 extern void inven_damage(bool (*func)(object_type*), int dam, cptr verb);
+extern void inven_damage_hates(u16b hates, int dam, cptr verb);
 extern void acid_dam(int dam, cptr kb_str);
 extern void elec_dam(int dam, cptr kb_str);
 extern void fire_dam(int dam, cptr kb_str);
@@ -846,6 +961,8 @@ extern bool store_buy_item(object_type * o_ptr, store_type * st_ptr);
 extern bool store_sell_item(object_type * o_ptr, store_type * st_ptr);
 extern void store_shuffle(int which);
 extern void store_maint(int which);
+extern void store_maint_owe(void);
+extern void store_catch_up(int which);
 extern void store_init(int which);
 extern s32b object_store_value(object_type * o_ptr);
 extern void store_combine(store_type *st_ptr);
@@ -884,15 +1001,23 @@ extern void ascii_to_text(char *buf, cptr str);
 extern sint macro_find_exact(cptr pat);
 extern errr macro_add(cptr pat, cptr act);
 extern errr macro_init(void);
+extern errr cli_init(void);
+extern cli_comm *cli_find(cptr name);
 extern void flush(void);
 extern char inkey(void);
+extern void fresh_limited(void);
+extern u32b msec_clock(void);
 extern void bell(void);
 extern void sound(int val);
 extern s16b quark_add(cptr str);
 extern cptr quark_str(s16b i);
+extern void quark_collect(void);
 extern s16b message_num(void);
 extern cptr message_str(s16b age);
+extern cptr message_text(s16b age);
+extern s16b message_count(s16b age);
 extern byte message_prior(s16b age);
+extern void message_add_count(cptr str, byte prior, s16b n);
 extern void message_add(cptr str, byte prior);
 extern void msg_print(cptr msg);
 extern void mprint(byte p, cptr msg);
@@ -917,7 +1042,6 @@ extern bool get_com(cptr prompt, char *command);
 extern s16b get_quantity(cptr prompt, int max);
 extern void pause_line(int row);
 extern void request_command(bool shopping);
-extern void log_metric(const char *event_type, long duration_ms);
 extern char get_fuzz_command(void);
 extern bool is_a_vowel(int ch);
 
@@ -928,6 +1052,7 @@ extern void notice_stuff(void);
 extern void update_stuff(void);
 extern void redraw_stuff(void);
 extern void window_stuff(void);
+extern void window_stuff_flush(void);
 extern void handle_stuff(void);
 
 /* xtra2.c */
@@ -966,7 +1091,7 @@ extern bool mon_take_hit(int m_idx, int dam, bool * fear, cptr note,
 	bool give_exp, bool hit_by_pet);
 extern void verify_panel(void);
 extern cptr look_mon_desc(int m_idx);
-extern void ang_sort_aux(vptr u, vptr v, int p, int q);
+extern void ang_sort_aux(vptr u, vptr v, int p, int q, int depth);
 extern void ang_sort(vptr u, vptr v, int n);
 extern sint motion_dir(int y1, int x1, int y2, int x2);
 extern sint target_dir(char ch);
@@ -997,14 +1122,104 @@ extern void fate_effect(int fate_given, int fate_gotten);
 extern void strike_it_lucky(void);
 
 
+/* connect.c */
+extern int connect_label(int y1, int x1, int y2, int x2, int mode);
+extern int connect_add(int y, int x);
+extern int connect_region(int y, int x);
+extern int connect_region_size(int y, int x);
+extern bool connect_bridge(int *ay, int *ax, int *by, int *bx);
+
+/* bench.c */
+extern bool bench_init(cptr name);
+extern void bench_list(void);
+extern void bench_birth(void);
+extern void bench_level(void);
+extern void bench_turn(void);
+extern bool bench_command(void);
+extern bool bench_running(void);
+
+/* observe.c */
+extern bool observe_on;
+extern void observe_note_spot(int y, int x);
+extern void observe_note_map(void);
+extern const observe_type *observe_get(void);
+extern void observe_start(observe_hook_type hook);
+extern bool observe_command(void);
+extern bool observe_wanderer(const observe_type *o_ptr, char *cmd, int *dir);
+
+/* fuzz.c */
+extern void fuzz_init(long slow_msec);
+extern void fuzz_birth(void);
+extern void fuzz_hit(int path);
+extern void fuzz_project(int typ);
+extern bool fuzz_running(void);
+extern void fuzz_level(void);
+extern void fuzz_turn(long msec);
+extern bool fuzz_command(void);
+
+/* prof.c */
+extern void prof_start(s32b every);
+extern u32b prof_stop(void);
+extern void prof_stop_quietly(void);
+extern bool prof_running(void);
+extern u32b prof_lost_samples(void);
+extern void prof_push(int t);
+extern void prof_pop(void);
+extern void prof_turn(void);
+
+/* journal.c */
+extern void journal_record(void);
+extern void journal_play(cptr path);
+extern void journal_seed(void);
+extern errr journal_inkey(char *ch, bool wait, bool take);
+
+/* wizard1.c */
+extern void spoil_all(void);
+
+/* soak.c */
+extern void soak_run(int games, int jobs);
+extern void soak_turn(void);
+
+/* metrics.c */
+extern long get_current_rss_kb(void);
+extern void log_metric(const char *event_type, long duration_ms);
+extern void metric_start(int t);
+extern void metric_stop(int t);
+extern void metric_turn(void);
+extern void metric_stage(cptr name);
+extern void metric_prefix(cptr prefix);
+extern cptr metric_timer_name(int t);
+extern void metric_path(char *buf, size_t max, cptr name);
+extern int memory_census(census_type *c_ptr);
+extern void metric_memory(void);
+
+/* flow.c */
+extern void wipe_flow_fields(void);
+extern void flow_fields_note_change(int y, int x);
+extern int flow_field_get(int y, int x);
+extern int flow_field_cost(int f, int y, int x);
+extern bool flow_field_step(int f, int y, int x, int *ny, int *nx);
+extern void wipe_scent(void);
+extern void scent_stamp(int y, int x);
+extern bool scent_track(int y, int x, int *ty, int *tx);
+extern void build_sector_graph(void);
+extern void sector_note_change(int y, int x);
+extern bool sector_step(int y, int x, int gy, int gx, int *ny, int *nx);
+
 /* lua.c */
 
 extern errr init_lua(void);
+extern void script_on_turn(void);
+extern void script_on_level_gen(void);
+extern void script_on_monster_death(int m_idx);
+extern long script_memory(void);
 
 /* patrol.c */
 extern void init_patrol_system(void);
+extern monster_guard_data *get_guard_data(int m_idx);
 extern monster_guard_data *alloc_guard_data(int m_idx);
 extern void free_guard_data(int m_idx);
+extern void move_guard_data(int i1, int i2);
 extern void setup_monster_patrol(int m_idx, int type);
 extern void setup_guard_post(int m_idx, int post_type, int y, int x);
 extern void setup_squad_patrol(int *m_idx_list, int num_monsters, int center_y, int center_x);
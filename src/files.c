@@ -322,6 +322,7 @@ errr process_pref_file_aux(char *buf)
 				f_ptr->z_attr = n1;
 			if (n2)
 				f_ptr->z_char = n2;
+			map_info_forget_all();
 			return (0);
 		}
 	}
@@ -2007,87 +2008,64 @@ void display_player(int mode)
 
 
 /*
- * Hack -- Dump a character description file
- *
- * XXX XXX XXX Allow the "full" flag to dump additional info,
- * and trigger its usage from various places in the code.
+ * Write rows "y1" to "y2" - 1 of the screen (79 columns) to "fff"
  */
-errr file_character(cptr name)
+static void file_character_screen(FILE *fff, int y1, int y2)
 {
-	int i, x, y;
+	int x, y;
 
 	byte a;
 	char c;
 
+	char buf[80];
+
+	for (y = y1; y < y2; y++)
+	{
+		/* Dump each row */
+		for (x = 0; x < 79; x++)
+		{
+			/* Get the attr/char */
+			(void) (Term_what(x, y, &a, &c));
+
+			/* Dump it */
+			buf[x] = c;
+		}
+
+		/* Terminate */
+		buf[x] = '\0';
+
+		/* End the row */
+		fputs(buf, fff);
+		putc('\n', fff);
+	}
+}
+
+
+/*
+ * Write a character dump to the open file "fff"
+ *
+ * This asks nothing, so it may be used wherever the file comes from,
+ * but it draws the character sheet on the screen, and leaves it there.
+ */
+static void file_character_aux(FILE *fff)
+{
+	int i;
+
 #if 0
 	cptr other = "(";
 #endif
 
 	cptr paren = ")";
 
-	int fd = -1;
-
-	FILE *fff = NULL;
-
 	store_type *st_ptr = &store[7];
 
 	char o_name[80];
 
-	char buf[1024];
-
 	object_type *o_ptr;
 
 	bool equip_p = FALSE;
 
 
-	/* Drop priv's */
-	safe_setuid_drop();
-
-	/* Build the filename */
-	path_build(buf, 1024, ANGBAND_DIR_USER, name);
-
-	/* File type is "TEXT" */
-	FILE_TYPE(FILE_TYPE_TEXT);
-
-	/* Check for existing file */
-	fd = fd_open(buf, O_RDONLY);
-
-	/* Existing file */
-	if (fd >= 0)
-	{
-		char out_val[160];
-
-		/* Close the file */
-		fd_close(fd);
-
-		/* Build query */
-		sprintf(out_val, "Replace existing file %s? ", buf);
-
-		/* Ask */
-		if (get_check(out_val))
-			fd = -1;
-	}
-
-	/* Open the non-existing file */
-	if (fd < 0)
-		fff = my_fopen(buf, "w");
-
-	/* Grab priv's */
-	safe_setuid_grab();
-
-
-	/* Invalid file */
-	if (!fff)
-	{
-		/* Message */
-		msg_format("Character dump failed!");
-		msg_print(NULL);
-
-		/* Error */
-		return (-1);
-	}
-
-
 	/* Begin dump */
 	fprintf(fff, "  [Kamband %d.%d Character Dump]\n\n", KAM_VERSION_MAJOR,
 		KAM_VERSION_MINOR);
@@ -2097,47 +2075,13 @@ errr file_character(cptr name)
 	display_player(0);
 
 	/* Dump part of the screen */
-	for (y = 2; y < 22; y++)
-	{
-		/* Dump each row */
-		for (x = 0; x < 79; x++)
-		{
-			/* Get the attr/char */
-			(void) (Term_what(x, y, &a, &c));
-
-			/* Dump it */
-			buf[x] = c;
-		}
-
-		/* Terminate */
-		buf[x] = '\0';
-
-		/* End the row */
-		fprintf(fff, "%s\n", buf);
-	}
+	file_character_screen(fff, 2, 22);
 
 	/* Display history */
 	display_player(1);
 
 	/* Dump part of the screen */
-	for (y = 15; y < 20; y++)
-	{
-		/* Dump each row */
-		for (x = 0; x < 79; x++)
-		{
-			/* Get the attr/char */
-			(void) (Term_what(x, y, &a, &c));
-
-			/* Dump it */
-			buf[x] = c;
-		}
-
-		/* Terminate */
-		buf[x] = '\0';
-
-		/* End the row */
-		fprintf(fff, "%s\n", buf);
-	}
+	file_character_screen(fff, 15, 20);
 
 	fprintf(fff, "\n\n");
 
@@ -2145,24 +2089,7 @@ errr file_character(cptr name)
 	display_player(2);
 
 	/* Dump part of the screen */
-	for (y = 2; y < 22; y++)
-	{
-		/* Dump each row */
-		for (x = 0; x < 79; x++)
-		{
-			/* Get the attr/char */
-			(void) (Term_what(x, y, &a, &c));
-
-			/* Dump it */
-			buf[x] = c;
-		}
-
-		/* Terminate */
-		buf[x] = '\0';
-
-		/* End the row */
-		fprintf(fff, "%s\n", buf);
-	}
+	file_character_screen(fff, 2, 22);
 
 	/* Skip some lines */
 	fprintf(fff, "\n\n");
@@ -2363,6 +2290,84 @@ errr file_character(cptr name)
 		fprintf(fff, "\n\n");
 	}
 
+}
+
+
+
+
+
+/*
+ * Hack -- Dump a character description file
+ *
+ * XXX XXX XXX Allow the "full" flag to dump additional info,
+ * and trigger its usage from various places in the code.
+ */
+errr file_character(cptr name)
+{
+	int fd = -1;
+
+	FILE *fff = NULL;
+
+	char buf[1024];
+
+	/* A headless game (fuzzed, say) types random names, so keep its dumps
+	 * out of "user" */
+	bool headless_dump = (arg_headless && (name[0] != '/')) ? TRUE : FALSE;
+
+
+	/* Drop priv's */
+	safe_setuid_drop();
+
+	/* Build the filename */
+	if (headless_dump)
+		metric_path(buf, 1024, "kamband_dump.txt");
+	else
+		path_build(buf, 1024, ANGBAND_DIR_USER, name);
+
+	/* File type is "TEXT" */
+	FILE_TYPE(FILE_TYPE_TEXT);
+
+	/* Check for existing file (a headless game just writes over it) */
+	fd = headless_dump ? -1 : fd_open(buf, O_RDONLY);
+
+	/* Existing file */
+	if (fd >= 0)
+	{
+		char out_val[160];
+
+		/* Close the file */
+		fd_close(fd);
+
+		/* Build query */
+		sprintf(out_val, "Replace existing file %s? ", buf);
+
+		/* Ask */
+		if (get_check(out_val))
+			fd = -1;
+	}
+
+	/* Open the non-existing file */
+	if (fd < 0)
+		fff = my_fopen(buf, "w");
+
+	/* Grab priv's */
+	safe_setuid_grab();
+
+
+	/* Invalid file */
+	if (!fff)
+	{
+		/* Message */
+		msg_format("Character dump failed!");
+		msg_print(NULL);
+
+		/* Error */
+		return (-1);
+	}
+
+	/* Dump the character */
+	file_character_aux(fff);
+
 	/* Close it */
 	my_fclose(fff);
 
@@ -2372,6 +2377,254 @@ errr file_character(cptr name)
 
 
 
+/*
+ * Number of help files kept in memory (see "CACHE_HELP_FILES")
+ */
+#define TEXT_CACHE_MAX 4
+
+
+/*
+ * The "real" lines of a file shown by "show_file()", as "my_fgets()"
+ * reads them, and the menu of the file.
+ */
+typedef struct text_file text_file;
+
+struct text_file
+{
+	char path[1024];	/* The file */
+
+#ifdef CACHE_HELP_FILES
+	time_t mtime;		/* Its modification time, when read */
+	off_t size;		/* Its size, when read */
+#endif
+
+	u32b used;		/* Last use (zero when not cached) */
+	int busy;		/* Number of "show_file()" calls showing it */
+
+	bool menu;		/* This screen has sub-screens */
+	char hook[10][32];	/* Sub-menu information */
+
+	char *text;		/* The lines, one after another */
+	u32b text_len;
+	u32b text_max;
+
+	u32b *line;		/* The start of each line in "text" */
+	int line_num;
+	int line_max;
+};
+
+
+#ifdef CACHE_HELP_FILES
+
+/*
+ * The help files shown lately
+ */
+static text_file *text_cache[TEXT_CACHE_MAX];
+static u32b text_cache_clock = 0;
+
+#endif /* CACHE_HELP_FILES */
+
+
+/*
+ * Forget the lines of "t_ptr"
+ */
+static void text_file_free(text_file *t_ptr)
+{
+	if (t_ptr->text) C_KILL(t_ptr->text, t_ptr->text_max, char);
+	if (t_ptr->line) C_KILL(t_ptr->line, t_ptr->line_max, u32b);
+
+	KILL(t_ptr, text_file);
+}
+
+
+/*
+ * Read every line of "fff" into "t_ptr", noting the menu items
+ */
+static void text_file_read(text_file *t_ptr, FILE *fff)
+{
+	char buf[1024];
+	int i;
+
+	t_ptr->menu = FALSE;
+
+	/* Wipe the hooks */
+	for (i = 0; i < 10; i++)
+		t_ptr->hook[i][0] = '\0';
+
+	t_ptr->text_len = 0;
+	t_ptr->line_num = 0;
+
+	/* Pre-Parse the file */
+	while (TRUE)
+	{
+		u32b len;
+
+		/* Read a line or stop */
+		if (my_fgets(fff, buf, 1024))
+			break;
+
+		/* XXX Parse "menu" items */
+		if (prefix(buf, "***** "))
+		{
+			char b1 = '[', b2 = ']';
+
+			/* Notice "menu" requests */
+			if ((buf[6] == b1) && isdigit(buf[7]) && (buf[8] == b2) &&
+				(buf[9] == ' '))
+			{
+				/* This is a menu file */
+				t_ptr->menu = TRUE;
+
+				/* Extract the menu item */
+				i = buf[7] - '0';
+
+				/* Extract the menu item */
+				strcpy(t_ptr->hook[i], buf + 10);
+			}
+
+			/* Skip this */
+			continue;
+		}
+
+		len = strlen(buf) + 1;
+
+		/* Make room for the text */
+		if (t_ptr->text_len + len > t_ptr->text_max)
+		{
+			char *old = t_ptr->text;
+			u32b max = t_ptr->text_max;
+
+			while (t_ptr->text_len + len > t_ptr->text_max)
+				t_ptr->text_max *= 2;
+
+			C_MAKE(t_ptr->text, t_ptr->text_max, char);
+			C_COPY(t_ptr->text, old, t_ptr->text_len, char);
+			C_KILL(old, max, char);
+		}
+
+		/* Make room for the line */
+		if (t_ptr->line_num == t_ptr->line_max)
+		{
+			u32b *old = t_ptr->line;
+
+			C_MAKE(t_ptr->line, t_ptr->line_max * 2, u32b);
+			C_COPY(t_ptr->line, old, t_ptr->line_max, u32b);
+			C_KILL(old, t_ptr->line_max, u32b);
+			t_ptr->line_max *= 2;
+		}
+
+		/* Count the "real" lines */
+		t_ptr->line[t_ptr->line_num++] = t_ptr->text_len;
+
+		C_COPY(t_ptr->text + t_ptr->text_len, buf, len, char);
+		t_ptr->text_len += len;
+	}
+}
+
+
+/*
+ * Get the lines of the file "path", opened as "fff", reading them unless
+ * they are cached (and "cache" allows it).  The file is closed.
+ */
+static text_file *text_file_get(cptr path, FILE *fff, bool cache)
+{
+	text_file *t_ptr;
+
+#ifdef CACHE_HELP_FILES
+
+	struct stat st;
+	int i, oldest = -1;
+
+	/* Look for the file */
+	if (cache && !fstat(fileno(fff), &st))
+	{
+		for (i = 0; i < TEXT_CACHE_MAX; i++)
+		{
+			t_ptr = text_cache[i];
+
+			if (!t_ptr)
+			{
+				if (oldest < 0) oldest = i;
+				continue;
+			}
+
+			if (streq(t_ptr->path, path) && (t_ptr->mtime == st.st_mtime) &&
+				(t_ptr->size == st.st_size))
+			{
+				my_fclose(fff);
+
+				t_ptr->used = ++text_cache_clock;
+				t_ptr->busy++;
+
+				return (t_ptr);
+			}
+
+			/* Never drop a file still shown */
+			if (t_ptr->busy) continue;
+
+			if ((oldest < 0) || (text_cache[oldest] &&
+				(t_ptr->used < text_cache[oldest]->used)))
+			{
+				oldest = i;
+			}
+		}
+	}
+
+	/* Nowhere to keep it */
+	else
+	{
+		cache = FALSE;
+	}
+
+#endif /* CACHE_HELP_FILES */
+
+	MAKE(t_ptr, text_file);
+
+	strcpy(t_ptr->path, path);
+
+	t_ptr->text_max = 4096;
+	C_MAKE(t_ptr->text, t_ptr->text_max, char);
+	t_ptr->line_max = 256;
+	C_MAKE(t_ptr->line, t_ptr->line_max, u32b);
+
+	text_file_read(t_ptr, fff);
+
+	my_fclose(fff);
+
+	t_ptr->busy = 1;
+
+#ifdef CACHE_HELP_FILES
+
+	/* Keep it, instead of the least recently used file */
+	if (cache && (oldest >= 0))
+	{
+		t_ptr->mtime = st.st_mtime;
+		t_ptr->size = st.st_size;
+		t_ptr->used = ++text_cache_clock;
+
+		if (text_cache[oldest]) text_file_free(text_cache[oldest]);
+
+		text_cache[oldest] = t_ptr;
+	}
+
+#endif /* CACHE_HELP_FILES */
+
+	return (t_ptr);
+}
+
+
+/*
+ * Stop showing the lines of "t_ptr" (see "text_file_get()")
+ */
+static void text_file_done(text_file *t_ptr)
+{
+	t_ptr->busy--;
+
+	/* Forget a file which was not kept */
+	if (!t_ptr->used) text_file_free(t_ptr);
+}
+
+
 /*
  * Recursive file perusal.
  *
@@ -2380,7 +2633,7 @@ errr file_character(cptr name)
  * Process various special text in the input file, including
  * the "menu" structures used by the "help file" system.
  *
- * XXX XXX XXX Consider using a temporary file.
+ * The file is read once (see "text_file_get()"), and shown from memory.
  *
  * XXX XXX XXX Allow the user to "save" the current file.
  */
@@ -2397,12 +2650,15 @@ bool show_file(cptr name, cptr what, int line, int mode)
 	/* Backup value for "line" */
 	int back = 0;
 
-	/* This screen has sub-screens */
-	bool menu = FALSE;
+	/* The file might be kept (see "CACHE_HELP_FILES") */
+	bool cache = TRUE;
 
 	/* Current help file */
 	FILE *fff = NULL;
 
+	/* Its lines */
+	text_file *t_ptr;
+
 	/* Find this string (if any) */
 	cptr find = NULL;
 
@@ -2418,12 +2674,6 @@ bool show_file(cptr name, cptr what, int line, int mode)
 	/* Path buffer */
 	char path[1024];
 
-	/* General buffer */
-	char buf[1024];
-
-	/* Sub-menu information */
-	char hook[10][32];
-
 
 	/* Wipe finder */
 	strcpy(finder, "");
@@ -2434,10 +2684,6 @@ bool show_file(cptr name, cptr what, int line, int mode)
 	/* Wipe caption */
 	strcpy(caption, "");
 
-	/* Wipe the hooks */
-	for (i = 0; i < 10; i++)
-		hook[i][0] = '\0';
-
 
 	/* Hack XXX XXX XXX */
 	if (what)
@@ -2450,6 +2696,9 @@ bool show_file(cptr name, cptr what, int line, int mode)
 
 		/* Open */
 		fff = my_fopen(path, "r");
+
+		/* Dumps and temporary files are not kept */
+		cache = FALSE;
 	}
 
 	/* Look in "help" */
@@ -2463,6 +2712,8 @@ bool show_file(cptr name, cptr what, int line, int mode)
 
 		/* Open the file */
 		fff = my_fopen(path, "r");
+
+		cache = TRUE;
 	}
 
 	/* Look in "info" */
@@ -2490,42 +2741,11 @@ bool show_file(cptr name, cptr what, int line, int mode)
 	}
 
 
-	/* Pre-Parse the file */
-	while (TRUE)
-	{
-		/* Read a line or stop */
-		if (my_fgets(fff, buf, 1024))
-			break;
-
-		/* XXX Parse "menu" items */
-		if (prefix(buf, "***** "))
-		{
-			char b1 = '[', b2 = ']';
-
-			/* Notice "menu" requests */
-			if ((buf[6] == b1) && isdigit(buf[7]) && (buf[8] == b2) &&
-				(buf[9] == ' '))
-			{
-				/* This is a menu file */
-				menu = TRUE;
-
-				/* Extract the menu item */
-				k = buf[7] - '0';
-
-				/* Extract the menu item */
-				strcpy(hook[k], buf + 10);
-			}
-
-			/* Skip this */
-			continue;
-		}
-
-		/* Count the "real" lines */
-		next++;
-	}
+	/* Read the file (closing it) */
+	t_ptr = text_file_get(path, fff, cache);
 
 	/* Save the number of "real" lines */
-	size = next;
+	size = t_ptr->line_num;
 
 
 
@@ -2541,56 +2761,33 @@ bool show_file(cptr name, cptr what, int line, int mode)
 			line = 0;
 
 
-		/* Re-open the file if needed */
-		if (next > line)
+		/* Hack -- keep searching */
+		if (find)
 		{
-			/* Close it */
-			my_fclose(fff);
-
-			/* Hack -- Re-Open the file */
-			fff = my_fopen(path, "r");
-
-			/* Oops */
-			if (!fff)
-				return (FALSE);
+			for (next = line; next < size; next++)
+			{
+				if (strstr(t_ptr->text + t_ptr->line[next], find)) break;
+			}
 
-			/* File has been restarted */
-			next = 0;
-		}
+			/* Hack -- failed search */
+			if (next == size)
+			{
+				bell();
+				line = back;
+				find = NULL;
+				continue;
+			}
 
-		/* Skip lines if needed */
-		for (; next < line; next++)
-		{
-			/* Skip a line */
-			if (my_fgets(fff, buf, 1024))
-				break;
+			/* Hack -- stop searching */
+			line = next;
+			find = NULL;
 		}
 
 
 		/* Dump the next screenful of lines of the file */
-		for (i = 0; i < screen_y - 4;)
+		for (i = 0; (i < screen_y - 4) && (line + i < size); i++)
 		{
-			/* Hack -- track the "first" line */
-			if (!i)
-				line = next;
-
-			/* Get a line of the file or stop */
-			if (my_fgets(fff, buf, 1024))
-				break;
-
-			/* Hack -- skip "special" lines */
-			if (prefix(buf, "***** "))
-				continue;
-
-			/* Count the "real" lines */
-			next++;
-
-			/* Hack -- keep searching */
-			if (find && !i && !strstr(buf, find))
-				continue;
-
-			/* Hack -- stop searching */
-			find = NULL;
+			cptr buf = t_ptr->text + t_ptr->line[line + i];
 
 			/* Dump the line */
 			Term_putstr(0, i + 2, -1, TERM_WHITE, buf);
@@ -2613,18 +2810,6 @@ bool show_file(cptr name, cptr what, int line, int mode)
 					str += len;
 				}
 			}
-
-			/* Count the printed lines */
-			i++;
-		}
-
-		/* Hack -- failed search */
-		if (find)
-		{
-			bell();
-			line = back;
-			find = NULL;
-			continue;
 		}
 
 
@@ -2634,12 +2819,11 @@ bool show_file(cptr name, cptr what, int line, int mode)
 
 
 		/* Prompt -- menu screen */
-		if (menu)
+		if (t_ptr->menu)
 		{
 			/* Wait for it */
 			prt("[Press a Number, or ESC to exit.]", screen_y - 1, 0);
 		}
-
 		/* Prompt -- small files */
 		else if (size <= screen_y - 4)
 		{
@@ -2733,10 +2917,10 @@ bool show_file(cptr name, cptr what, int line, int mode)
 		}
 
 		/* Recurse on numbers */
-		if (menu && isdigit(k) && hook[k - '0'][0])
+		if (t_ptr->menu && isdigit(k) && t_ptr->hook[k - '0'][0])
 		{
 			/* Recurse on that file */
-			if (!show_file(hook[k - '0'], NULL, 0, mode))
+			if (!show_file(t_ptr->hook[k - '0'], NULL, 0, mode))
 				k = ESCAPE;
 		}
 
@@ -2745,8 +2929,8 @@ bool show_file(cptr name, cptr what, int line, int mode)
 			break;
 	}
 
-	/* Close the file */
-	my_fclose(fff);
+	/* Done with the lines */
+	text_file_done(t_ptr);
 
 	/* Escape */
 	if (k == ESCAPE)
@@ -2991,6 +3175,8 @@ void do_cmd_suicide(void)
  */
 void do_cmd_save_game(void)
 {
+	bool background;
+
 	/* Disturb the player */
 	disturb(1, 0);
 
@@ -3012,16 +3198,21 @@ void do_cmd_save_game(void)
 	/* Forbid suspend */
 	signals_ignore_tstp();
 
-	/* Save the player */
-	if (save_player())
+	/* Save the player, in the background if possible */
+	if (!save_player_background(&background, FALSE))
 	{
-		prt("Saving game... done.", 0, 0);
+		prt("Saving game... failed!", 0, 0);
+	}
+
+	/* Still being written */
+	else if (background)
+	{
+		prt("Saving game... (in the background)", 0, 0);
 	}
 
-	/* Save failed (oops) */
 	else
 	{
-		prt("Saving game... failed!", 0, 0);
+		prt("Saving game... done.", 0, 0);
 	}
 
 	/* Allow suspend again */
@@ -3035,6 +3226,40 @@ void do_cmd_save_game(void)
 }
 
 
+/*
+ * Save the game without any fuss, as the "autosave_game" option asks.
+ *
+ * The copy is written in the background where the system allows it, so
+ * this costs little more than a fork, and nothing is said unless the
+ * save fails.
+ */
+void do_cmd_autosave(void)
+{
+	bool background;
+
+	/* Handle stuff */
+	handle_stuff();
+
+	/* The player is not dead */
+	strcpy(p_ptr->died_from, "(saved)");
+
+	/* Forbid suspend */
+	signals_ignore_tstp();
+
+	/* Save the player */
+	if (!save_player_background(&background, TRUE))
+	{
+		msg_print("Autosave failed!");
+	}
+
+	/* Allow suspend again */
+	signals_handle_tstp();
+
+	/* Note that the player is not dead */
+	strcpy(p_ptr->died_from, "(alive and well)");
+}
+
+
 
 /*
  * Hack -- Calculates the total number of points earned
@@ -3106,6 +3331,11 @@ static void center_string(char *buf, cptr str)
  * then we will only use the name and level on which death occured.
  *
  * Should probably attempt some form of locking...
+ *
+ * Nothing reads "lib/bone" (see the player ghost notes in "monster2.c"),
+ * so this is not even called.  If ghosts come back, keep one file with
+ * a record per depth rather than a file per depth, so that placing a
+ * ghost is one seek instead of a directory search.
  */
 static void make_bones(void)
 {
@@ -3554,27 +3784,32 @@ static errr highscore_read(high_score * score)
 
 
 /*
- * Write one score to the highscore file
+ * Write "n" scores to the highscore file
  */
-static int highscore_write(high_score * score)
+static int highscore_write(high_score * score, int n)
 {
-	/* Write the record, note failure */
-	return (fd_write(highscore_fd, (char *) (score), sizeof(high_score)));
+	/* Write the records, note failure */
+	return (fd_write(highscore_fd, (char *) (score), n * sizeof(high_score)));
 }
 
 
-
+/*
+ * The highscore file, as last read, best first
+ */
+static high_score highscore_table[MAX_HISCORES];
 
 /*
- * Just determine where a new score *would* be placed
- * Return the location (0 is best) or -1 on failure
+ * Scores in the table
  */
-static int highscore_where(high_score * score)
-{
-	int i;
+static int highscore_num = 0;
 
-	high_score the_score;
 
+/*
+ * Read the whole highscore file into the table
+ * Return the number of scores, or -1 on failure
+ */
+static int highscore_load(void)
+{
 	/* Paranoia -- it may not have opened */
 	if (highscore_fd < 0)
 		return (-1);
@@ -3583,17 +3818,47 @@ static int highscore_where(high_score * score)
 	if (highscore_seek(0))
 		return (-1);
 
-	/* Read until we get to a higher score */
-	for (i = 0; i < MAX_HISCORES; i++)
+	/* Read until the end */
+	for (highscore_num = 0; highscore_num < MAX_HISCORES; highscore_num++)
+	{
+		if (highscore_read(&highscore_table[highscore_num]))
+			break;
+	}
+
+	return (highscore_num);
+}
+
+
+
+
+/*
+ * Just determine where a new score *would* be placed
+ * Return the location (0 is best) or -1 on failure
+ */
+static int highscore_where(high_score * score)
+{
+	int lo, hi;
+
+	/* Read the scores */
+	if (highscore_load() < 0)
+		return (-1);
+
+	/* Find the first lower score (the table is in order) */
+	for (lo = 0, hi = highscore_num; lo < hi; )
 	{
-		if (highscore_read(&the_score))
-			return (i);
-		if (strcmp(the_score.pts, score->pts) < 0)
-			return (i);
+		int mid = (lo + hi) / 2;
+
+		if (strcmp(highscore_table[mid].pts, score->pts) < 0)
+			hi = mid;
+		else
+			lo = mid + 1;
 	}
 
 	/* The "last" entry is always usable */
-	return (MAX_HISCORES - 1);
+	if (lo >= MAX_HISCORES)
+		return (MAX_HISCORES - 1);
+
+	return (lo);
 }
 
 
@@ -3603,44 +3868,31 @@ static int highscore_where(high_score * score)
  */
 static int highscore_add(high_score * score)
 {
-	int i, slot;
-	bool done = FALSE;
+	int i, slot, n;
 
-	high_score the_score, tmpscore;
 
-
-	/* Paranoia -- it may not have opened */
-	if (highscore_fd < 0)
-		return (-1);
-
-	/* Determine where the score should go */
+	/* Determine where the score should go (this reads the file) */
 	slot = highscore_where(score);
 
 	/* Hack -- Not on the list */
 	if (slot < 0)
 		return (-1);
 
-	/* Hack -- prepare to dump the new score */
-	the_score = (*score);
+	/* One more score, unless the last one falls off */
+	n = MIN(highscore_num + 1, MAX_HISCORES);
 
-	/* Slide all the scores down one */
-	for (i = slot; !done && (i < MAX_HISCORES); i++)
-	{
-		/* Read the old guy, note errors */
-		if (highscore_seek(i))
-			return (-1);
-		if (highscore_read(&tmpscore))
-			done = TRUE;
+	/* Slide the lower scores down one */
+	for (i = n - 1; i > slot; i--)
+		highscore_table[i] = highscore_table[i - 1];
 
-		/* Back up and dump the score we were holding */
-		if (highscore_seek(i))
-			return (-1);
-		if (highscore_write(&the_score))
-			return (-1);
+	highscore_table[slot] = (*score);
+	highscore_num = n;
 
-		/* Hack -- Save the old score, for the next pass */
-		the_score = tmpscore;
-	}
+	/* Write them all back at once */
+	if (highscore_seek(slot))
+		return (-1);
+	if (highscore_write(&highscore_table[slot], n - slot))
+		return (-1);
 
 	/* Return location used */
 	return (slot);
@@ -3682,17 +3934,11 @@ static void display_scores_aux(int from, int to, int note,
 		to = MAX_HISCORES;
 
 
-	/* Seek to the beginning */
-	if (highscore_seek(0))
+	/* Read (and count) the high scores */
+	i = highscore_load();
+	if (i < 0)
 		return;
 
-	/* Hack -- Count the high scores */
-	for (i = 0; i < MAX_HISCORES; i++)
-	{
-		if (highscore_read(&the_score))
-			break;
-	}
-
 	/* Hack -- allow "fake" entry to be last */
 	if ((note == i) && score)
 		i++;
@@ -3742,14 +3988,14 @@ static void display_scores_aux(int from, int to, int note,
 				j--;
 			}
 
-			/* Read a normal record */
+			/* Take a normal record */
 			else
 			{
-				/* Read the proper record */
-				if (highscore_seek(j))
-					break;
-				if (highscore_read(&the_score))
+				/* Past the end */
+				if (j >= highscore_num)
 					break;
+
+				the_score = highscore_table[j];
 			}
 
 			/* Extract the race/class */
@@ -4345,6 +4591,9 @@ void close_game(void)
 		/* Save the game */
 		do_cmd_save_game();
 
+		/* Make sure it is written before leaving */
+		(void)save_background_check(TRUE);
+
 		/* Prompt for scores XXX XXX XXX */
 		prt("Press Return (or Escape).", 0, 40);
 
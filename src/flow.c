@@ -0,0 +1,668 @@
+/* File: flow.c */
+
+/*
+ * Flow field service for Kamband
+ * Shared, cached distance maps towards arbitrary points (guard posts,
+ * alert points, stairs) so that monsters can path around walls without
+ * each of them running its own search.
+ *
+ * The "sound" flow rooted at the player still lives in cave_flow[] (see
+ * "update_flow()" in cave.c); this module handles every other source.
+ * Each field covers a window of FLOW_FIELD_DEPTH grids around its source,
+ * is built lazily the first time it is asked for, and is rebuilt only
+ * when a grid inside its window has changed.
+ *
+ * The module also keeps the scent trail of the player: a ring of the
+ * last SCENT_MAX grids the player stepped into, with the game turn of
+ * each step, and a small index from grids to steps, so that a tracking
+ * monster can ask for the freshest scent next to it without a search.
+ *
+ * Flow fields only reach FLOW_FIELD_DEPTH steps, so journeys across the
+ * level go by sectors of BLOCK_HGT by BLOCK_WID grids.  Each side shared
+ * by two sectors has one "portal" (a pair of open grids across it, if
+ * any), a route is a search over the sectors from the goal outwards, and
+ * a monster follows the flow field rooted at the portal into the next
+ * sector on the route, until the goal is one sector away.  Routes are
+ * shared by goal sector and rebuilt only when a portal changes.
+ */
+
+#include "angband.h"
+
+
+/*
+ * The table of flow fields
+ */
+static flow_field flow_fields[FLOW_FIELD_MAX];
+
+/*
+ * Use counter, for least-recently-used replacement
+ */
+static u32b flow_field_clock = 0;
+
+/*
+ * The search queue (each grid of a window is queued at most once)
+ */
+static s16b flow_field_qy[FLOW_FIELD_SIZE * FLOW_FIELD_SIZE];
+static s16b flow_field_qx[FLOW_FIELD_SIZE * FLOW_FIELD_SIZE];
+
+
+/*
+ * One step of the scent trail
+ */
+typedef struct scent_type scent_type;
+
+struct scent_type
+{
+    s16b y, x;         /* Grid */
+    s32b when;         /* Game turn of the step */
+};
+
+/*
+ * The scent trail (a ring, overwriting the oldest step)
+ */
+static scent_type scent_ring[SCENT_MAX];
+static int scent_next = 0;
+
+/*
+ * The latest step into each grid (plus one), by hash of the grid.
+ *
+ * Two grids may share a slot, in which case the older one is forgotten.
+ */
+static s16b scent_slot[SCENT_HASH];
+
+#define SCENT_HASH_IDX(Y, X) \
+    (((Y) * DUNGEON_WID + (X)) & (SCENT_HASH - 1))
+
+
+/*
+ * A route to a goal sector
+ */
+typedef struct sector_route sector_route;
+
+struct sector_route
+{
+    u32b used;         /* Use counter, or zero for an unused slot */
+    bool dirty;        /* A portal has changed since it was built */
+    s16b goal;         /* Goal sector */
+
+    byte next[SECTOR_ROWS * SECTOR_COLS];   /* Way to go (or SECTOR_NONE) */
+};
+
+/*
+ * The portals across the east and south sides of each sector, as the
+ * offset along the side (or -1 for a side with no way across)
+ */
+static s16b sector_east[SECTOR_ROWS][SECTOR_COLS];
+static s16b sector_south[SECTOR_ROWS][SECTOR_COLS];
+
+/*
+ * The table of routes, and its use counter
+ */
+static sector_route sector_routes[SECTOR_ROUTE_MAX];
+static u32b sector_clock = 0;
+
+/*
+ * The ways out of a sector (north, east, south, west), and the way back
+ */
+static const int sector_dy[4] = { -1, 0, 1, 0 };
+static const int sector_dx[4] = { 0, 1, 0, -1 };
+
+/*
+ * The search queue
+ */
+static s16b sector_queue[SECTOR_ROWS * SECTOR_COLS];
+
+
+/*
+ * Is (y, x) inside the window of a field?
+ */
+static bool flow_field_contains(flow_field *f_ptr, int y, int x)
+{
+    if (y < f_ptr->src_y - FLOW_FIELD_DEPTH) return FALSE;
+    if (y > f_ptr->src_y + FLOW_FIELD_DEPTH) return FALSE;
+    if (x < f_ptr->src_x - FLOW_FIELD_DEPTH) return FALSE;
+    if (x > f_ptr->src_x + FLOW_FIELD_DEPTH) return FALSE;
+    return TRUE;
+}
+
+
+/*
+ * Access the cost of a grid inside the window of a field
+ */
+#define FLOW_FIELD_COST(F, Y, X) \
+    ((F)->cost[(Y) - (F)->src_y + FLOW_FIELD_DEPTH] \
+              [(X) - (F)->src_x + FLOW_FIELD_DEPTH])
+
+
+/*
+ * Build a field by breadth-first search from its source.
+ *
+ * The passability rules match update_flow(): walls and rubble block,
+ * and a monster must be able to step downstream along the elevation.
+ */
+static void flow_field_build(flow_field *f_ptr)
+{
+    int head = 0, tail = 0;
+    int y, x, d;
+
+    /* Nothing is reachable yet */
+    memset(f_ptr->cost, FLOW_COST_NONE, sizeof(f_ptr->cost));
+
+    /* Start at the source */
+    FLOW_FIELD_COST(f_ptr, f_ptr->src_y, f_ptr->src_x) = 0;
+    flow_field_qy[head] = f_ptr->src_y;
+    flow_field_qx[head] = f_ptr->src_x;
+    head++;
+
+    /* Process the queue */
+    while (tail < head) {
+        int n;
+
+        y = flow_field_qy[tail];
+        x = flow_field_qx[tail];
+        tail++;
+
+        n = FLOW_FIELD_COST(f_ptr, y, x) + 1;
+
+        /* Hack -- limit flow depth */
+        if (n > FLOW_FIELD_DEPTH) continue;
+
+        for (d = 0; d < 8; d++) {
+            int ny = y + ddy_ddd[d];
+            int nx = x + ddx_ddd[d];
+
+            if (!in_bounds(ny, nx)) continue;
+            if (!flow_field_contains(f_ptr, ny, nx)) continue;
+
+            /* Already reached */
+            if (FLOW_FIELD_COST(f_ptr, ny, nx) != FLOW_COST_NONE) continue;
+
+            /* Ignore "walls" and "rubble" */
+            if (cave_feat[ny][nx] >= FEAT_RUBBLE) continue;
+
+            /* A monster at (ny, nx) must be able to step to (y, x) */
+            if (!elev_allows_move(ny, nx, y, x, FALSE)) continue;
+
+            FLOW_FIELD_COST(f_ptr, ny, nx) = n;
+            flow_field_qy[head] = ny;
+            flow_field_qx[head] = nx;
+            head++;
+        }
+    }
+
+    /* The field is up to date */
+    f_ptr->dirty = FALSE;
+}
+
+
+/*
+ * Forget every flow field (on level change)
+ */
+void wipe_flow_fields(void)
+{
+    int i;
+
+    for (i = 0; i < FLOW_FIELD_MAX; i++) {
+        flow_fields[i].used = 0;
+        flow_fields[i].dirty = TRUE;
+    }
+
+    flow_field_clock = 0;
+}
+
+
+/*
+ * Note that a grid has changed, invalidating every field which covers it
+ */
+void flow_fields_note_change(int y, int x)
+{
+    int i;
+
+    for (i = 0; i < FLOW_FIELD_MAX; i++) {
+        flow_field *f_ptr = &flow_fields[i];
+
+        if (!f_ptr->used) continue;
+        if (f_ptr->dirty) continue;
+
+        if (flow_field_contains(f_ptr, y, x)) f_ptr->dirty = TRUE;
+    }
+}
+
+
+/*
+ * Get the flow field leading to (y, x), building it if needed.
+ *
+ * Fields are shared by source, so every monster heading for the same
+ * guard post or alert point uses the same field.  The least recently
+ * used field is recycled when the table is full.
+ */
+int flow_field_get(int y, int x)
+{
+    int i, oldest = 0;
+    flow_field *f_ptr;
+
+    if (!in_bounds(y, x)) return (-1);
+
+    flow_field_clock++;
+
+    /* Look for an existing field */
+    for (i = 0; i < FLOW_FIELD_MAX; i++) {
+        f_ptr = &flow_fields[i];
+
+        if (f_ptr->used && (f_ptr->src_y == y) && (f_ptr->src_x == x)) {
+            /* Rebuild lazily */
+            if (f_ptr->dirty) flow_field_build(f_ptr);
+
+            f_ptr->used = flow_field_clock;
+            return (i);
+        }
+
+        /* Remember the least recently used slot */
+        if (f_ptr->used < flow_fields[oldest].used) oldest = i;
+    }
+
+    /* Recycle a slot */
+    f_ptr = &flow_fields[oldest];
+    f_ptr->src_y = y;
+    f_ptr->src_x = x;
+    f_ptr->used = flow_field_clock;
+    flow_field_build(f_ptr);
+
+    return (oldest);
+}
+
+
+/*
+ * Get the number of steps from (y, x) to the source of a field,
+ * or FLOW_COST_NONE if the source cannot be reached from there.
+ */
+int flow_field_cost(int f, int y, int x)
+{
+    flow_field *f_ptr;
+
+    if ((f < 0) || (f >= FLOW_FIELD_MAX)) return (FLOW_COST_NONE);
+
+    f_ptr = &flow_fields[f];
+
+    if (!flow_field_contains(f_ptr, y, x)) return (FLOW_COST_NONE);
+
+    return (FLOW_FIELD_COST(f_ptr, y, x));
+}
+
+
+/*
+ * Find the best step from (y, x) towards the source of a field.
+ *
+ * Only grids a monster could walk into right now are considered, so
+ * the caller can hand the result straight to monster_swap().  Returns
+ * FALSE if no neighbour is closer to the source.
+ */
+bool flow_field_step(int f, int y, int x, int *ny, int *nx)
+{
+    int d, best;
+
+    best = flow_field_cost(f, y, x);
+
+    /* Not inside the field */
+    if (best == FLOW_COST_NONE) return (FALSE);
+
+    /* Check nearby grids, diagonals first */
+    for (d = 7; d >= 0; d--) {
+        int ty = y + ddy_ddd[d];
+        int tx = x + ddx_ddd[d];
+        int c = flow_field_cost(f, ty, tx);
+
+        if (c >= best) continue;
+        if (!cave_floor_bold(ty, tx)) continue;
+        if (cave_m_idx[ty][tx] != 0) continue;
+
+        best = c;
+        *ny = ty;
+        *nx = tx;
+    }
+
+    /* Did we find a step? */
+    return (best < flow_field_cost(f, y, x));
+}
+
+
+/*
+ * Forget the scent trail (on level change)
+ */
+void wipe_scent(void)
+{
+    C_WIPE(scent_ring, SCENT_MAX, scent_type);
+    C_WIPE(scent_slot, SCENT_HASH, s16b);
+    scent_next = 0;
+}
+
+
+/*
+ * Note that the player has stepped into (y, x)
+ */
+void scent_stamp(int y, int x)
+{
+    scent_type *s_ptr = &scent_ring[scent_next];
+
+    s_ptr->y = y;
+    s_ptr->x = x;
+    s_ptr->when = turn;
+
+    scent_slot[SCENT_HASH_IDX(y, x)] = scent_next + 1;
+
+    if (++scent_next >= SCENT_MAX) scent_next = 0;
+}
+
+
+/*
+ * Get the game turn the player last stepped into (y, x), or zero if
+ * the scent there is gone (or cold).
+ */
+static s32b scent_when(int y, int x)
+{
+    scent_type *s_ptr;
+    int s;
+
+    if (!in_bounds(y, x)) return (0);
+
+    s = scent_slot[SCENT_HASH_IDX(y, x)];
+    if (!s) return (0);
+
+    s_ptr = &scent_ring[s - 1];
+
+    /* The step has been overwritten by a later one elsewhere */
+    if ((s_ptr->y != y) || (s_ptr->x != x)) return (0);
+
+    /* Gone cold */
+    if (turn - s_ptr->when > SCENT_FRESH) return (0);
+
+    return (s_ptr->when);
+}
+
+
+/*
+ * Find the neighbour of (y, x) with the freshest scent, if it is fresher
+ * than the scent at (y, x) itself.
+ *
+ * Returns FALSE if the trail goes no further from here.
+ */
+bool scent_track(int y, int x, int *ty, int *tx)
+{
+    s32b when, best;
+    int d;
+
+    best = scent_when(y, x);
+    when = best;
+
+    /* Check nearby grids, diagonals first */
+    for (d = 7; d >= 0; d--) {
+        int ny = y + ddy_ddd[d];
+        int nx = x + ddx_ddd[d];
+        s32b w = scent_when(ny, nx);
+
+        if (w <= best) continue;
+
+        best = w;
+        *ty = ny;
+        *tx = nx;
+    }
+
+    return (best > when);
+}
+
+
+/*
+ * Can a monster cross between (y1, x1) and (y2, x2) either way?
+ */
+static bool sector_open(int y1, int x1, int y2, int x2)
+{
+    if (!in_bounds(y1, x1) || !in_bounds(y2, x2)) return FALSE;
+
+    /* Ignore "walls" and "rubble" */
+    if (cave_feat[y1][x1] >= FEAT_RUBBLE) return FALSE;
+    if (cave_feat[y2][x2] >= FEAT_RUBBLE) return FALSE;
+
+    return (elev_allows_move(y1, x1, y2, x2, FALSE) &&
+            elev_allows_move(y2, x2, y1, x1, FALSE));
+}
+
+
+/*
+ * Find the portal across one side of a sector, the open pair nearest
+ * the middle of the side (south if "south", else east)
+ */
+static s16b sector_find_portal(int sy, int sx, bool south)
+{
+    int len = south ? BLOCK_WID : BLOCK_HGT;
+    int y0 = sy * BLOCK_HGT, x0 = sx * BLOCK_WID;
+    int i;
+
+    for (i = 0; i < len; i++) {
+        /* Middle first, then outwards */
+        int k = len / 2 + ((i & 1) ? -(i + 1) / 2 : i / 2);
+
+        if (south) {
+            if (sector_open(y0 + BLOCK_HGT - 1, x0 + k, y0 + BLOCK_HGT, x0 + k)) return (k);
+        } else {
+            if (sector_open(y0 + k, x0 + BLOCK_WID - 1, y0 + k, x0 + BLOCK_WID)) return (k);
+        }
+    }
+
+    return (-1);
+}
+
+
+/*
+ * Forget every route, and find every portal (once the level is ready)
+ */
+void build_sector_graph(void)
+{
+    int sy, sx, i;
+
+    for (sy = 0; sy < SECTOR_ROWS; sy++) {
+        for (sx = 0; sx < SECTOR_COLS; sx++) {
+            sector_east[sy][sx] = sector_find_portal(sy, sx, FALSE);
+            sector_south[sy][sx] = sector_find_portal(sy, sx, TRUE);
+        }
+    }
+
+    for (i = 0; i < SECTOR_ROUTE_MAX; i++) sector_routes[i].used = 0;
+
+    sector_clock = 0;
+}
+
+
+/*
+ * Note that a grid has changed, finding the portals it borders again
+ * (and invalidating every route, if one of them has changed)
+ */
+void sector_note_change(int y, int x)
+{
+    int sy = y / BLOCK_HGT, sx = x / BLOCK_WID;
+    int my = y % BLOCK_HGT, mx = x % BLOCK_WID;
+    bool changed = FALSE;
+    s16b k;
+    int i;
+
+    if (!in_bounds(y, x)) return;
+
+    /* The east side of this sector, or of the one to the west */
+    if ((mx == BLOCK_WID - 1) || ((mx == 0) && (sx > 0))) {
+        int ex = (mx == 0) ? sx - 1 : sx;
+
+        k = sector_find_portal(sy, ex, FALSE);
+        if (k != sector_east[sy][ex]) changed = TRUE;
+        sector_east[sy][ex] = k;
+    }
+
+    /* The south side of this sector, or of the one to the north */
+    if ((my == BLOCK_HGT - 1) || ((my == 0) && (sy > 0))) {
+        int ey = (my == 0) ? sy - 1 : sy;
+
+        k = sector_find_portal(ey, sx, TRUE);
+        if (k != sector_south[ey][sx]) changed = TRUE;
+        sector_south[ey][sx] = k;
+    }
+
+    if (!changed) return;
+
+    for (i = 0; i < SECTOR_ROUTE_MAX; i++) sector_routes[i].dirty = TRUE;
+}
+
+
+/*
+ * Get the portal from sector (sy, sx) in the way "d", as the grid just
+ * across it.  Returns FALSE if there is none.
+ */
+static bool sector_portal(int sy, int sx, int d, int *py, int *px)
+{
+    int y0 = sy * BLOCK_HGT, x0 = sx * BLOCK_WID;
+    s16b k;
+
+    switch (d) {
+        case 0:
+            if (sy <= 0) return FALSE;
+            k = sector_south[sy - 1][sx];
+            *py = y0 - 1;
+            *px = x0 + k;
+            break;
+
+        case 1:
+            if (sx + 1 >= SECTOR_COLS) return FALSE;
+            k = sector_east[sy][sx];
+            *py = y0 + k;
+            *px = x0 + BLOCK_WID;
+            break;
+
+        case 2:
+            if (sy + 1 >= SECTOR_ROWS) return FALSE;
+            k = sector_south[sy][sx];
+            *py = y0 + BLOCK_HGT;
+            *px = x0 + k;
+            break;
+
+        default:
+            if (sx <= 0) return FALSE;
+            k = sector_east[sy][sx - 1];
+            *py = y0 + k;
+            *px = x0 - 1;
+            break;
+    }
+
+    return (k >= 0);
+}
+
+
+/*
+ * Build a route by breadth-first search from its goal sector
+ */
+static void sector_route_build(sector_route *r_ptr)
+{
+    int head = 0, tail = 0;
+    int d;
+
+    memset(r_ptr->next, SECTOR_NONE, sizeof(r_ptr->next));
+
+    /* At the goal, there is nowhere else to go */
+    r_ptr->next[r_ptr->goal] = 4;
+    sector_queue[head++] = r_ptr->goal;
+
+    while (tail < head) {
+        int s = sector_queue[tail++];
+        int sy = s / SECTOR_COLS, sx = s % SECTOR_COLS;
+
+        for (d = 0; d < 4; d++) {
+            int ny = sy + sector_dy[d], nx = sx + sector_dx[d];
+            int n, py, px;
+
+            /* No way across */
+            if (!sector_portal(sy, sx, d, &py, &px)) continue;
+
+            n = ny * SECTOR_COLS + nx;
+
+            /* Already reached */
+            if (r_ptr->next[n] != SECTOR_NONE) continue;
+
+            /* Come back the other way */
+            r_ptr->next[n] = (d + 2) % 4;
+            sector_queue[head++] = n;
+        }
+    }
+
+    r_ptr->dirty = FALSE;
+}
+
+
+/*
+ * Get the route to sector "goal", building it if needed.
+ *
+ * As with flow fields, the least recently used route is recycled when
+ * the table is full.
+ */
+static sector_route *sector_route_get(int goal)
+{
+    int i, oldest = 0;
+    sector_route *r_ptr;
+
+    sector_clock++;
+
+    for (i = 0; i < SECTOR_ROUTE_MAX; i++) {
+        r_ptr = &sector_routes[i];
+
+        if (r_ptr->used && (r_ptr->goal == goal)) {
+            if (r_ptr->dirty) sector_route_build(r_ptr);
+
+            r_ptr->used = sector_clock;
+            return (r_ptr);
+        }
+
+        if (r_ptr->used < sector_routes[oldest].used) oldest = i;
+    }
+
+    r_ptr = &sector_routes[oldest];
+    r_ptr->goal = goal;
+    r_ptr->used = sector_clock;
+    sector_route_build(r_ptr);
+
+    return (r_ptr);
+}
+
+
+/*
+ * Find the best step from (y, x) towards (gy, gx), however far it is.
+ *
+ * Near the goal (inside the window of the flow field rooted there), this
+ * is the step along that field; further away (or if the field does not
+ * reach), it is the step along the flow field rooted at the portal into
+ * the next sector on the route.  As with "flow_field_step()", the step is into a grid a
+ * monster could walk into right now.  Returns FALSE if there is none.
+ */
+bool sector_step(int y, int x, int gy, int gx, int *ny, int *nx)
+{
+    int sy = y / BLOCK_HGT, sx = x / BLOCK_WID;
+    int gsy = gy / BLOCK_HGT, gsx = gx / BLOCK_WID;
+    sector_route *r_ptr;
+    int d, py, px;
+
+    if (!in_bounds(y, x) || !in_bounds(gy, gx)) return FALSE;
+
+    /* Near enough for one field */
+    if ((ABS(y - gy) <= FLOW_FIELD_DEPTH) && (ABS(x - gx) <= FLOW_FIELD_DEPTH) &&
+        flow_field_step(flow_field_get(gy, gx), y, x, ny, nx)) {
+        return TRUE;
+    }
+
+    /* Already next to the goal sector */
+    if ((ABS(sy - gsy) + ABS(sx - gsx)) <= 1) return FALSE;
+
+    r_ptr = sector_route_get(gsy * SECTOR_COLS + gsx);
+    d = r_ptr->next[sy * SECTOR_COLS + sx];
+
+    /* No way there */
+    if (d == SECTOR_NONE) return FALSE;
+
+    /* Paranoia */
+    if (!sector_portal(sy, sx, d, &py, &px)) return FALSE;
+
+    return (flow_field_step(flow_field_get(py, px), y, x, ny, nx));
+}
@@ -0,0 +1,397 @@
+/* File: fuzz.c */
+
+/*
+ * Guided fuzzing of headless games (the "--fuzz" option)
+ *
+ * A headless game normally picks its commands from a handful of keys
+ * (see "get_fuzz_command()").  With "--fuzz" it picks from a table of
+ * commands instead, each aimed at some part of the game (a "path"):
+ * walking, spells, projections, using items, stores, quests, the
+ * sanctum puzzles, guard patrols, and stairs.  The game counts each time
+ * it reaches a path (as "fuzz_hit()" is called where the path is, or as
+ * the command takes game time), and the commands aimed at a path which
+ * has been reached less than its share of the time are picked FUZZ_BOOST
+ * times as often, for as long as they keep reaching it now and then (no
+ * more than FUZZ_PATIENCE tries for each time).  Whatever the answers
+ * to the prompts are, they are the random ones of "inkey()".
+ *
+ * The player is kept alive (as in the benchmarks).  A command which took
+ * no game time (no potions to drink, no store here) costs nothing but the
+ * pick, since the game asks for another one at once.
+ *
+ * A game turn which took FUZZ_SLOW_MSEC (or "--fuzz-slow <msec>") or
+ * more is noted in "kamband_fuzz_slow.csv", with the seed, the game turn,
+ * the depth, and the last command.  Since the fuzzing picks its commands
+ * with the game's own random numbers, the same build with "--fuzz --seed
+ * <seed> --turns <turn>" plays the same game up to that turn.
+ *
+ * At the end, "kamband_fuzz.csv" has a line for each command (its key,
+ * path, tries, how often it took game time, and how often each path was
+ * reached while it was the last command), a line with the totals, and a
+ * line with how often each kind of projection ("GF_*") was made.
+ */
+
+#include "angband.h"
+
+
+/*
+ * A command
+ */
+typedef struct fuzz_type fuzz_type;
+
+struct fuzz_type
+{
+	char key;		/* Command (a digit walks that way) */
+	byte path;		/* What it is aimed at */
+	byte weight;		/* How often to pick it */
+
+	u32b tries;		/* Times picked */
+	u32b acted;		/* Times it took game time */
+	u32b hits[FUZZ_PATHS];	/* Paths reached while it was the last command */
+};
+
+
+/*
+ * The commands
+ */
+static fuzz_type fuzz_info[] =
+{
+	{ '1', FUZZ_WALK, 8 },
+	{ '2', FUZZ_WALK, 8 },
+	{ '3', FUZZ_WALK, 8 },
+	{ '4', FUZZ_WALK, 8 },
+	{ '6', FUZZ_WALK, 8 },
+	{ '7', FUZZ_WALK, 8 },
+	{ '8', FUZZ_WALK, 8 },
+	{ '9', FUZZ_WALK, 8 },
+	{ 's', FUZZ_WALK, 2 },
+	{ 'R', FUZZ_WALK, 1 },
+	{ '+', FUZZ_SANCTUM, 2 },
+	{ ',', FUZZ_PATROL, 2 },
+	{ 'm', FUZZ_SPELL, 3 },
+	{ 'p', FUZZ_SPELL, 2 },
+	{ 'G', FUZZ_SPELL, 1 },
+	{ 'a', FUZZ_PROJECT, 2 },
+	{ 'u', FUZZ_PROJECT, 2 },
+	{ 'z', FUZZ_PROJECT, 2 },
+	{ 'v', FUZZ_PROJECT, 2 },
+	{ 'f', FUZZ_PROJECT, 2 },
+	{ 'A', FUZZ_PROJECT, 1 },
+	{ 'q', FUZZ_ITEM, 2 },
+	{ 'r', FUZZ_ITEM, 2 },
+	{ 'E', FUZZ_ITEM, 1 },
+	{ 'w', FUZZ_ITEM, 1 },
+	{ '_', FUZZ_STORE, 1 },
+	{ ']', FUZZ_STORE, 1 },
+	{ '[', FUZZ_QUEST, 1 },
+	{ '<', FUZZ_STAIRS, 1 },
+	{ '>', FUZZ_STAIRS, 1 },
+	{ ESCAPE, FUZZ_WALK, 1 },
+	{ 0, 0, 0 }
+};
+
+
+/*
+ * The paths, and whether "fuzz_hit()" is called where they are (if not,
+ * a command aimed at one reaches it by taking game time)
+ */
+static cptr fuzz_path_name[FUZZ_PATHS] =
+{
+	"walk", "spell", "project", "item", "store", "quest", "sanctum",
+	"patrol", "stairs"
+};
+
+static bool fuzz_path_hooked[FUZZ_PATHS] =
+{
+	FALSE, TRUE, TRUE, FALSE, TRUE, TRUE, TRUE, TRUE, TRUE
+};
+
+
+/*
+ * Fuzzing
+ */
+static bool fuzz_on = FALSE;
+
+/*
+ * How slow a game turn must be to be noted (msec)
+ */
+static long fuzz_slow = FUZZ_SLOW_MSEC;
+
+/*
+ * The last command, and the game turn it was given
+ */
+static fuzz_type *fuzz_last = NULL;
+static s32b fuzz_cmd_turn = -1;
+
+/*
+ * Times each path was picked, and reached, and all the times any was
+ */
+static u32b fuzz_tries[FUZZ_PATHS];
+static u32b fuzz_hits[FUZZ_PATHS];
+static u32b fuzz_hits_total = 0L;
+
+/*
+ * Projections made of each type
+ */
+static u32b fuzz_gf[256];
+
+/*
+ * Where the slow turns go
+ */
+static FILE *fuzz_slow_fff = NULL;
+
+
+/*
+ * The name of the key of "f_ptr"
+ */
+static cptr fuzz_key(fuzz_type *f_ptr)
+{
+	static char buf[2];
+
+	if (!f_ptr) return ("");
+	if (f_ptr->key == ESCAPE) return ("ESC");
+	if (f_ptr->key == ',') return ("hold");
+
+	buf[0] = f_ptr->key;
+	buf[1] = '\0';
+
+	return (buf);
+}
+
+
+/*
+ * Open one of the files (with the prefix of the metrics, if any)
+ */
+static FILE *fuzz_open(cptr name)
+{
+	char path[1024];
+
+	metric_path(path, sizeof(path), name);
+
+	return (fopen(path, "w"));
+}
+
+
+/*
+ * Write out the counts
+ */
+static void fuzz_report(void)
+{
+	fuzz_type *f_ptr;
+	FILE *fff;
+	int i;
+
+	if (fuzz_slow_fff)
+	{
+		fclose(fuzz_slow_fff);
+		fuzz_slow_fff = NULL;
+	}
+
+	fff = fuzz_open("kamband_fuzz.csv");
+	if (!fff) return;
+
+	fprintf(fff, "command,path,tries,acted");
+	for (i = 0; i < FUZZ_PATHS; i++) fprintf(fff, ",%s", fuzz_path_name[i]);
+	fprintf(fff, "\n");
+
+	for (f_ptr = fuzz_info; f_ptr->key; f_ptr++)
+	{
+		fprintf(fff, "%s,%s,%lu,%lu", fuzz_key(f_ptr), fuzz_path_name[f_ptr->path],
+		        (unsigned long)f_ptr->tries, (unsigned long)f_ptr->acted);
+
+		for (i = 0; i < FUZZ_PATHS; i++)
+		{
+			fprintf(fff, ",%lu", (unsigned long)f_ptr->hits[i]);
+		}
+
+		fprintf(fff, "\n");
+	}
+
+	fprintf(fff, "total,,,");
+	for (i = 0; i < FUZZ_PATHS; i++)
+	{
+		fprintf(fff, ",%lu", (unsigned long)fuzz_hits[i]);
+	}
+	fprintf(fff, "\n");
+
+	fprintf(fff, "gf");
+	for (i = 0; i < 256; i++)
+	{
+		if (fuzz_gf[i]) fprintf(fff, ",%d:%lu", i, (unsigned long)fuzz_gf[i]);
+	}
+	fprintf(fff, "\n");
+
+	fclose(fff);
+}
+
+
+/*
+ * Start fuzzing (before the game starts)
+ */
+void fuzz_init(long slow_msec)
+{
+	fuzz_on = TRUE;
+
+	if (slow_msec > 0) fuzz_slow = slow_msec;
+
+	/* A headless game, with a fixed seed */
+	arg_headless = TRUE;
+	if (!arg_seed) arg_seed = 1;
+}
+
+
+/*
+ * The new character is ready
+ */
+void fuzz_birth(void)
+{
+	if (!fuzz_on) return;
+
+	fuzz_slow_fff = fuzz_open("kamband_fuzz_slow.csv");
+	if (fuzz_slow_fff)
+	{
+		fprintf(fuzz_slow_fff, "seed,turn,depth,command,msec\n");
+	}
+
+	/* Report at the end, however the game ends */
+	atexit(fuzz_report);
+}
+
+
+/*
+ * Note that the game reached "path"
+ */
+void fuzz_hit(int path)
+{
+	if (!fuzz_on) return;
+
+	fuzz_hits[path]++;
+	fuzz_hits_total++;
+
+	if (fuzz_last) fuzz_last->hits[path]++;
+}
+
+
+/*
+ * Note a projection of type "typ"
+ */
+void fuzz_project(int typ)
+{
+	if (!fuzz_on) return;
+
+	fuzz_gf[typ & 0xFF]++;
+
+	fuzz_hit(FUZZ_PROJECT);
+}
+
+
+/*
+ * Is the game being fuzzed?
+ */
+bool fuzz_running(void)
+{
+	return (fuzz_on);
+}
+
+
+/*
+ * A new level is ready
+ */
+void fuzz_level(void)
+{
+	/* Not the first one */
+	if (fuzz_last) fuzz_hit(FUZZ_STAIRS);
+}
+
+
+/*
+ * A game turn is over, having taken "msec"
+ */
+void fuzz_turn(long msec)
+{
+	if (!fuzz_on) return;
+
+	/* Keep the player alive */
+	p_ptr->chp = p_ptr->mhp;
+	p_ptr->chp_frac = 0;
+	if (p_ptr->food < PY_FOOD_ALERT) p_ptr->food = PY_FOOD_FULL - 1;
+
+	/* Note slow turns */
+	if ((msec >= fuzz_slow) && fuzz_slow_fff)
+	{
+		fprintf(fuzz_slow_fff, "%lu,%ld,%d,%s,%ld\n",
+		        (unsigned long)arg_seed, (long)turn, (int)p_ptr->depth,
+		        fuzz_key(fuzz_last), msec);
+		fflush(fuzz_slow_fff);
+	}
+}
+
+
+/*
+ * How often to pick "f_ptr" now
+ */
+static int fuzz_weight(fuzz_type *f_ptr)
+{
+	u32b hits = fuzz_hits[f_ptr->path];
+	u32b tries = fuzz_tries[f_ptr->path];
+
+	/* Reached less than its share, and still worth trying */
+	if ((hits * FUZZ_PATHS <= fuzz_hits_total) &&
+	    (tries < FUZZ_PATIENCE * (hits + 1)))
+	{
+		return (f_ptr->weight * FUZZ_BOOST);
+	}
+
+	return (f_ptr->weight);
+}
+
+
+/*
+ * Pick the next command.
+ *
+ * Return FALSE if not fuzzing.
+ */
+bool fuzz_command(void)
+{
+	fuzz_type *f_ptr;
+	int total = 0, k;
+
+	if (!fuzz_on) return (FALSE);
+
+	/* The last command took game time */
+	if (fuzz_last && (turn != fuzz_cmd_turn))
+	{
+		fuzz_last->acted++;
+
+		if (!fuzz_path_hooked[fuzz_last->path]) fuzz_hit(fuzz_last->path);
+	}
+
+	for (f_ptr = fuzz_info; f_ptr->key; f_ptr++) total += fuzz_weight(f_ptr);
+
+	k = rand_int(total);
+
+	for (f_ptr = fuzz_info; f_ptr->key; f_ptr++)
+	{
+		k -= fuzz_weight(f_ptr);
+		if (k < 0) break;
+	}
+
+	f_ptr->tries++;
+	fuzz_tries[f_ptr->path]++;
+
+	fuzz_last = f_ptr;
+	fuzz_cmd_turn = turn;
+
+	if (isdigit((unsigned char)f_ptr->key))
+	{
+		p_ptr->command_cmd = ';';
+		p_ptr->command_dir = D2I(f_ptr->key);
+	}
+	else
+	{
+		p_ptr->command_cmd = f_ptr->key;
+		p_ptr->command_dir = 0;
+	}
+
+	return (TRUE);
+}
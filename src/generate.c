@@ -46,13 +46,16 @@ static void universal_stamp(int y0, int x0, stamp_type s)
         {
             int y = y0 + dy;
             int x = x0 + dx;
+            int dist;
 
             if (!in_bounds(y, x)) continue;
 
+            dist = distance(y0, x0, y, x);
+
             /* 1. Shape Check */
             if (s.circular)
             {
-                if (distance(y0, x0, y, x) > s.radius) continue;
+                if (dist > s.radius) continue;
             }
 
             /* 2. Collision Check: Don't stomp on existing non-floor features unless allowed */
@@ -61,7 +64,6 @@ static void universal_stamp(int y0, int x0, stamp_type s)
 
             /* 3. The Organic Math: Probability + Noise */
             /* We reduce the chance of spawning as we get further from the center */
-            int dist = distance(y0, x0, y, x);
             int falloff = (s.radius - dist) * 10;
             int noise = rand_int(s.roughness + 1);
 
@@ -222,6 +224,8 @@ static void universal_stamp(int y0, int x0, stamp_type s)
 #define ALLOC_SET_CORR		1 /* Hallway */
 #define ALLOC_SET_ROOM		2 /* Room */
 #define ALLOC_SET_BOTH		3 /* Anywhere */
+#define ALLOC_SET_WATER		4 /* Shallow or deep water */
+#define ALLOC_SET_FLOOR		5 /* Bare floor */
 
 /*
  * Hack -- Dungeon allocation "types"
@@ -230,6 +234,8 @@ static void universal_stamp(int y0, int x0, stamp_type s)
 #define ALLOC_TYP_TRAP		3 /* Trap */
 #define ALLOC_TYP_OBJECT	4 /* Object */
 #define ALLOC_TYP_ALTAR         5 /* Altar */
+#define ALLOC_TYP_GOOD		6 /* Good object */
+#define ALLOC_TYP_GOLD		7 /* Small gold pile */
 
 
 /*
@@ -238,6 +244,12 @@ static void universal_stamp(int y0, int x0, stamp_type s)
 #define MAX_ROOMS_ROW	(DUNGEON_HGT / BLOCK_HGT)
 #define MAX_ROOMS_COL	(DUNGEON_WID / BLOCK_WID)
 
+/*
+ * Number of stair "sectors" (2x2 blocks) along each axis
+ */
+#define STAIR_SECT_ROWS	((MAX_ROOMS_ROW + 1) / 2)
+#define STAIR_SECT_COLS	((MAX_ROOMS_COL + 1) / 2)
+
 
 /*
  * Bounds on some arrays used in the "dun_data" structure.
@@ -328,6 +340,11 @@ struct dun_data
  */
 static dun_data *dun;
 
+/*
+ * Scratch space of the generator, all given back when a level is done
+ */
+static virt_arena gen_arena = { NULL, MEM_SCRATCH };
+
 /* Extern for sanctum */
 extern void build_sanctum_vault(int y, int x);
 
@@ -400,6 +417,150 @@ static void rand_dir(int *rdir, int *cdir)
 }
 
 
+/*
+ * Floor candidates for stairs and the player, sorted by stair sector.
+ *
+ * Every "naked" floor grid of the level is listed once, together with
+ * its "next_to_walls()" count, and the grids of sector "i" are found at
+ * stair_cand[stair_sect_first[i]] up to stair_sect_first[i + 1].  The
+ * lists are built the first time they are needed on each level, and a
+ * grid is checked again when it is picked, since placing stairs and
+ * monsters uses up grids.
+ */
+static coord stair_cand[DUNGEON_HGT * DUNGEON_WID];
+static byte stair_cand_walls[DUNGEON_HGT * DUNGEON_WID];
+static int stair_sect_first[STAIR_SECT_ROWS * STAIR_SECT_COLS + 1];
+static bool stair_cand_ready = FALSE;
+
+static int next_to_walls(int y, int x);
+
+
+/*
+ * Get the stair sector of a grid, or -1 if it lies in no sector
+ */
+static int stair_sect(int y, int x)
+{
+	int by = y / BLOCK_HGT;
+	int bx = x / BLOCK_WID;
+
+	if ((by >= MAX_ROOMS_ROW) || (bx >= MAX_ROOMS_COL))
+		return (-1);
+
+	return ((by / 2) * STAIR_SECT_COLS + (bx / 2));
+}
+
+
+/*
+ * Build the stair candidate lists of the current level
+ */
+static void stair_cand_build(void)
+{
+	int y, x, i, n;
+
+	/* Count the candidates of each sector */
+	for (i = 0; i <= STAIR_SECT_ROWS * STAIR_SECT_COLS; i++)
+		stair_sect_first[i] = 0;
+
+	for (y = 1; y < DUNGEON_HGT - 1; y++)
+	{
+		for (x = 1; x < DUNGEON_WID - 1; x++)
+		{
+			i = stair_sect(y, x);
+
+			if (i < 0) continue;
+			if (!cave_naked_bold(y, x)) continue;
+
+			stair_sect_first[i + 1]++;
+		}
+	}
+
+	/* Find the start of each sector */
+	for (i = 0; i < STAIR_SECT_ROWS * STAIR_SECT_COLS; i++)
+		stair_sect_first[i + 1] += stair_sect_first[i];
+
+	/* Fill in the sectors, using the starts as cursors */
+	for (y = 1; y < DUNGEON_HGT - 1; y++)
+	{
+		for (x = 1; x < DUNGEON_WID - 1; x++)
+		{
+			i = stair_sect(y, x);
+
+			if (i < 0) continue;
+			if (!cave_naked_bold(y, x)) continue;
+
+			n = stair_sect_first[i]++;
+
+			stair_cand[n].y = y;
+			stair_cand[n].x = x;
+			stair_cand_walls[n] = next_to_walls(y, x);
+		}
+	}
+
+	/* Undo the cursors */
+	for (i = STAIR_SECT_ROWS * STAIR_SECT_COLS; i > 0; i--)
+		stair_sect_first[i] = stair_sect_first[i - 1];
+
+	stair_sect_first[0] = 0;
+
+	stair_cand_ready = TRUE;
+}
+
+
+/*
+ * Is a candidate still usable?
+ *
+ * It must still be "naked", be next to at least "walls" walls, and have
+ * every cave_info flag in "need" and none of those in "forbid".
+ */
+static bool stair_cand_okay(int i, int walls, u16b need, u16b forbid)
+{
+	int y = stair_cand[i].y;
+	int x = stair_cand[i].x;
+
+	if (stair_cand_walls[i] < walls) return (FALSE);
+	if ((cave_info[y][x] & need) != need) return (FALSE);
+	if (cave_info[y][x] & forbid) return (FALSE);
+
+	return (cave_naked_bold(y, x));
+}
+
+
+/*
+ * Pick a random usable candidate between "first" and "last" (exclusive).
+ * The lists must have been built.
+ *
+ * Returns FALSE if there is none.
+ */
+static bool stair_cand_pick(int first, int last, int walls, u16b need,
+	u16b forbid, int *y, int *x)
+{
+	int i, k, n = 0;
+
+	/* Count the usable candidates */
+	for (i = first; i < last; i++)
+	{
+		if (stair_cand_okay(i, walls, need, forbid)) n++;
+	}
+
+	if (!n) return (FALSE);
+
+	/* Take one of them */
+	k = rand_int(n);
+
+	for (i = first; i < last; i++)
+	{
+		if (!stair_cand_okay(i, walls, need, forbid)) continue;
+
+		if (k-- == 0) break;
+	}
+
+	(*y) = stair_cand[i].y;
+	(*x) = stair_cand[i].x;
+
+	return (TRUE);
+}
+
+
 /*
  * Returns random co-ordinates for player/monster/object
  */
@@ -437,6 +598,16 @@ static void new_player_spot(void)
 		return;
 	}
 
+	/* Prefer a "naked" floor grid, refusing anti-teleport grids */
+	if (!stair_cand_ready) stair_cand_build();
+
+	if (stair_cand_pick(0, stair_sect_first[STAIR_SECT_ROWS * STAIR_SECT_COLS],
+		0, 0, CAVE_ICKY, &y, &x))
+	{
+		player_place(y, x);
+		return;
+	}
+
 	/* Place the player */
 	while (1)
 	{
@@ -706,18 +877,18 @@ static void place_random_door(int y, int x)
 
 
 /*
- * Places some staircases near walls
+ * Places one staircase in every stair sector, next to at least "walls"
+ * walls (and inside a room if "force_room" is set)
  */
 static void alloc_stairs(int feat, int num, int walls, bool force_room)
 {
-	int y, x, j, sy, sx;
-	int row_rooms = DUNGEON_HGT / BLOCK_HGT;
-	int col_rooms = DUNGEON_WID / BLOCK_WID;
+	int y, x, i;
 
-	/* The walls and num parameters are mostly unused in the sector-based version */
-	(void)walls;
+	/* The num parameter is unused in the sector-based version */
 	(void)num;
 
+	if (!stair_cand_ready) stair_cand_build();
+
     if (p_ptr->inside_special == SPECIAL_DREAM) {
         /* Only place one exit */
         if (feat == FEAT_LESS) return; /* No up stairs */
@@ -727,112 +898,224 @@ static void alloc_stairs(int feat, int num, int walls, bool force_room)
         }
 
         /* Place one randomly and exit */
-        for (j = 0; j < 3000; j++) {
-            y = rand_int(DUNGEON_HGT);
-            x = rand_int(DUNGEON_WID);
-            if (!cave_naked_bold(y, x)) continue;
+        if (stair_cand_pick(0, stair_sect_first[STAIR_SECT_ROWS * STAIR_SECT_COLS],
+                            0, 0, 0, &y, &x)) {
             cave_feat[y][x] = feat;
             cave_info[y][x] |= CAVE_GLOW;
-            return;
         }
         return;
     }
 
 	/* Allocate exactly 1 stair per 2x2 block sector */
-	for (sy = 0; sy < row_rooms; sy += 2)
+	for (i = 0; i < STAIR_SECT_ROWS * STAIR_SECT_COLS; i++)
 	{
-		for (sx = 0; sx < col_rooms; sx += 2)
+		/* Skip sectors without room for stairs */
+		if (!stair_cand_pick(stair_sect_first[i], stair_sect_first[i + 1],
+			walls, (force_room ? CAVE_ROOM : 0), 0, &y, &x))
+			continue;
+
+		/* Town -- must go down */
+		if (!p_ptr->depth)
+		{
+		  if (p_ptr->inside_special == SPECIAL_WILD) {
+		    cave_feat[y][x] = FEAT_SHAFT;
+		  } else {
+		    cave_feat[y][x] = FEAT_MORE;
+		  }
+		}
+		/* Quest -- must go up */
+		else if (p_ptr->inside_special == SPECIAL_QUEST ||
+			(p_ptr->depth >= MAX_DEPTH - 1))
+		{
+			cave_feat[y][x] = FEAT_LESS;
+		}
+		/* Requested type */
+		else
 		{
-			int y1 = sy * BLOCK_HGT;
-			int x1 = sx * BLOCK_WID;
-			int y2 = y1 + (2 * BLOCK_HGT) - 1;
-			int x2 = x1 + (2 * BLOCK_WID) - 1;
+			cave_feat[y][x] = feat;
+		}
+
+		/* Make stairs visible from afar */
+		cave_info[y][x] |= CAVE_GLOW;
+	}
+}
 
-			/* Boundary check just in case */
-			if (y2 >= DUNGEON_HGT) y2 = DUNGEON_HGT - 1;
-			if (x2 >= DUNGEON_WID) x2 = DUNGEON_WID - 1;
 
-			for (j = 0; j < 200; j++)
-			{
-				y = rand_range(y1, y2);
-				x = rand_range(x1, x2);
 
-				if (!cave_naked_bold(y, x))
-					continue;
 
-				if (force_room && !(cave_info[y][x] & CAVE_ROOM))
-					continue;
+/*
+ * Candidate grids for the batch placers.
+ *
+ * Instead of retrying random grids until one happens to be legal, each
+ * placer collects every legal grid of its window once and then draws
+ * from that list without replacement.  Since placing one thing can use
+ * up nearby grids (monster groups, dropped objects), a grid is checked
+ * again when it is drawn.  Only one list is in use at a time.
+ */
+static coord alloc_cand[DUNGEON_HGT * DUNGEON_WID];
+static int alloc_cand_num = 0;
+static bool alloc_cand_clean = FALSE;
+
+
+/*
+ * Is a grid still usable by the current candidate list?
+ */
+static bool alloc_cand_okay(int y, int x)
+{
+	if (alloc_cand_clean) return (cave_clean_bold(y, x));
+
+	return (cave_naked_bold(y, x));
+}
+
+
+/*
+ * Collect the candidate grids of the window (y1,x1)-(y2,x2), using an
+ * allocation "place".  The grids must be "naked", or merely "clean" if
+ * requested.
+ *
+ * Returns the number of candidates.
+ */
+static int alloc_cand_build(int y1, int x1, int y2, int x2, int set,
+	bool clean)
+{
+	int y, x;
+
+	/* Clip to the dungeon */
+	if (y1 < 0) y1 = 0;
+	if (x1 < 0) x1 = 0;
+	if (y2 > DUNGEON_HGT - 1) y2 = DUNGEON_HGT - 1;
+	if (x2 > DUNGEON_WID - 1) x2 = DUNGEON_WID - 1;
+
+	alloc_cand_num = 0;
+	alloc_cand_clean = clean;
+
+	for (y = y1; y <= y2; y++)
+	{
+		for (x = x1; x <= x2; x++)
+		{
+			bool room;
+
+			if (!alloc_cand_okay(y, x))
+				continue;
 
-				/* Town -- must go down */
-				if (!p_ptr->depth)
+			/* Check for "room" */
+			room = (cave_info[y][x] & (CAVE_ROOM)) ? TRUE : FALSE;
+
+			switch (set)
+			{
+				/* Require corridor */
+				case ALLOC_SET_CORR:
 				{
-				  if (p_ptr->inside_special == SPECIAL_WILD) {
-				    cave_feat[y][x] = FEAT_SHAFT;
-				  } else {
-				    cave_feat[y][x] = FEAT_MORE;
-				  }
+					if (room) continue;
+					break;
 				}
-				/* Quest -- must go up */
-				else if (p_ptr->inside_special == SPECIAL_QUEST ||
-					(p_ptr->depth >= MAX_DEPTH - 1))
+
+				/* Require room */
+				case ALLOC_SET_ROOM:
 				{
-					cave_feat[y][x] = FEAT_LESS;
+					if (!room) continue;
+					break;
 				}
-				/* Requested type */
-				else
+
+				/* Require water */
+				case ALLOC_SET_WATER:
 				{
-					cave_feat[y][x] = feat;
+					if ((cave_feat[y][x] != FEAT_SHAL_WATER) &&
+						(cave_feat[y][x] != FEAT_DEEP_WATER))
+						continue;
+					break;
 				}
 
-				/* Make stairs visible from afar */
-				cave_info[y][x] |= CAVE_GLOW;
-
-				break;
+				/* Require bare floor */
+				case ALLOC_SET_FLOOR:
+				{
+					if (cave_feat[y][x] != FEAT_FLOOR) continue;
+					break;
+				}
 			}
+
+			alloc_cand[alloc_cand_num].y = y;
+			alloc_cand[alloc_cand_num].x = x;
+			alloc_cand_num++;
 		}
 	}
+
+	return (alloc_cand_num);
 }
 
 
+/*
+ * Draw a random grid from the candidate list.
+ *
+ * Returns FALSE once no usable candidate is left.
+ */
+static bool alloc_cand_pick(int *y, int *x)
+{
+	while (alloc_cand_num > 0)
+	{
+		int i = rand_int(alloc_cand_num);
+		int ty = alloc_cand[i].y;
+		int tx = alloc_cand[i].x;
+
+		/* Remove it from the list */
+		alloc_cand[i] = alloc_cand[--alloc_cand_num];
+
+		/* Used up since the list was built */
+		if (!alloc_cand_okay(ty, tx))
+			continue;
+
+		(*y) = ty;
+		(*x) = tx;
+
+		return (TRUE);
+	}
+
+	return (FALSE);
+}
 
 
 /*
- * Allocates some objects (using "place" and "type")
+ * Allocate some monsters anywhere in the dungeon, using "flags"
  */
-static void alloc_object(int set, int typ, int num)
+static void alloc_monsters(int flags, int num)
 {
-	int y, x, k;
+	int y, x;
+	int set = (flags & MON_ALLOC_AQUATIC) ? ALLOC_SET_WATER : ALLOC_SET_BOTH;
 
-	/* Place some objects */
-	for (k = 0; k < num; k++)
+	alloc_cand_build(0, 0, DUNGEON_HGT - 1, DUNGEON_WID - 1, set, FALSE);
+
+	for (; num > 0; num--)
 	{
-		/* Pick a "legal" spot */
-		while (TRUE)
-		{
-			bool room;
+		/* Leave room for the rest of generation (see "alloc_monster()") */
+		if (m_max >= MAX_M_IDX - 100)
+			break;
 
-			/* Location */
-			y = rand_int(DUNGEON_HGT);
-			x = rand_int(DUNGEON_WID);
+		if (!alloc_cand_pick(&y, &x))
+			break;
 
-			/* Require "naked" floor grid */
-			if (!cave_naked_bold(y, x))
-				continue;
+		/* Attempt to place the monster, allow groups */
+		place_monster(y, x, alloc_monster_flags(flags));
+	}
+}
 
-			/* Check for "room" */
-			room = (cave_info[y][x] & (CAVE_ROOM)) ? TRUE : FALSE;
 
-			/* Require corridor? */
-			if ((set == ALLOC_SET_CORR) && room)
-				continue;
+static void place_gold_small(int y, int x);
 
-			/* Require room? */
-			if ((set == ALLOC_SET_ROOM) && !room)
-				continue;
+/*
+ * Allocates some objects (using "place" and "type")
+ */
+static void alloc_object(int set, int typ, int num)
+{
+	int y, x;
 
-			/* Accept it */
+	alloc_cand_build(0, 0, DUNGEON_HGT - 1, DUNGEON_WID - 1, set, FALSE);
+
+	/* Place some objects */
+	for (; num > 0; num--)
+	{
+		/* Pick a "legal" spot */
+		if (!alloc_cand_pick(&y, &x))
 			break;
-		}
 
 		/* Place something */
 		switch (typ)
@@ -860,6 +1143,18 @@ static void alloc_object(int set, int typ, int num)
 				place_altar(y, x);
 				break;
 			}
+
+			case ALLOC_TYP_GOOD:
+			{
+				place_object(y, x, TRUE, FALSE);
+				break;
+			}
+
+			case ALLOC_TYP_GOLD:
+			{
+				place_gold_small(y, x);
+				break;
+			}
 		}
 	}
 }
@@ -985,15 +1280,21 @@ static void build_streamer2(int feat, int killwall)
 					placed_island = TRUE;
 				}
 
-				for (int dy = -current_blob_radius; dy <= current_blob_radius; dy++)
+				/* Clip the blob to the dungeon once */
+				int dy_min = MAX(-current_blob_radius, -y);
+				int dy_max = MIN(current_blob_radius, DUNGEON_HGT - 1 - y);
+				int dx_min = MAX(-current_blob_radius, -x);
+				int dx_max = MIN(current_blob_radius, DUNGEON_WID - 1 - x);
+
+				for (int dy = dy_min; dy <= dy_max; dy++)
 				{
-					for (int dx = -current_blob_radius; dx <= current_blob_radius; dx++)
+					for (int dx = dx_min; dx <= dx_max; dx++)
 					{
 						int cy = y + dy;
 						int cx = x + dx;
 
 						/* Do not mess up vaults */
-						if (in_bounds(cy, cx) && !(cave_info[cy][cx] & CAVE_ICKY))
+						if (!(cave_info[cy][cx] & CAVE_ICKY))
 						{
 							bool valid = TRUE;
 
@@ -1004,7 +1305,7 @@ static void build_streamer2(int feat, int killwall)
 							}
 
 							/* Streams cannot cut through True Dark Mazes */
-						if (valid && in_bounds(cy, cx) && cave_sector[cy][cx] == SECTOR_DARK)
+						if (valid && cave_sector[cy][cx] == SECTOR_DARK)
 							{
 							valid = FALSE;
 								{
@@ -1064,17 +1365,19 @@ static void build_streamer2(int feat, int killwall)
 	{ /* create pool */
 		poolsize = 5 + randint(10);
 		mid = poolsize / 2;
+
+		/* Clip the pool to the dungeon once */
+		int i_max = MIN(poolsize, DUNGEON_HGT - y);
+		int j_max = MIN(poolsize, DUNGEON_WID - x);
+
 		/* One grid per density */
-		for (i = 0; i < poolsize; i++)
+		for (i = 0; i < i_max; i++)
 		{
-			for (j = 0; j < poolsize; j++)
+			for (j = 0; j < j_max; j++)
 			{
 				tx = x + j;
 				ty = y + i;
 
-				if (!in_bounds(ty, tx))
-					continue;
-
 				if (i < mid)
 				{
 					if (j < mid)
@@ -1122,6 +1425,7 @@ static void build_streamer2(int feat, int killwall)
 static void destroy_level(void)
 {
 	int y1, x1, y, x, k, t, n;
+	int y_min, y_max, x_min, x_max;
 
 	object_type *o_ptr;
 	object_type *o_nxt;
@@ -1138,15 +1442,16 @@ static void destroy_level(void)
 		x1 = rand_range(5, DUNGEON_WID - 1 - 5);
 		y1 = rand_range(5, DUNGEON_HGT - 1 - 5);
 
-		/* Big area of affect */
-		for (y = (y1 - 15); y <= (y1 + 15); y++)
+		/* Big area of affect, clipped to the legal grids */
+		y_min = MAX(y1 - 15, 1);
+		y_max = MIN(y1 + 15, DUNGEON_HGT - 2);
+		x_min = MAX(x1 - 15, 1);
+		x_max = MIN(x1 + 15, DUNGEON_WID - 2);
+
+		for (y = y_min; y <= y_max; y++)
 		{
-			for (x = (x1 - 15); x <= (x1 + 15); x++)
+			for (x = x_min; x <= x_max; x++)
 			{
-				/* Skip illegal grids */
-				if (!in_bounds_fully(y, x))
-					continue;
-
 				/* Extract the distance */
 				k = distance(y1, x1, y, x);
 
@@ -1221,81 +1526,40 @@ static void destroy_level(void)
  */
 static void vault_objects(int y, int x, int num)
 {
-	int i, j, k;
+	int j, k;
+
+	/* Require "clean" floor space */
+	alloc_cand_build(y - 2, x - 3, y + 2, x + 3, ALLOC_SET_BOTH, TRUE);
 
 	/* Attempt to place 'num' objects */
 	for (; num > 0; --num)
 	{
-		/* Try up to 11 spots looking for empty space */
-		for (i = 0; i < 11; ++i)
-		{
-			/* Pick a random location */
-			while (1)
-			{
-				j = rand_spread(y, 2);
-				k = rand_spread(x, 3);
-				if (!in_bounds(j, k))
-					continue;
-				break;
-			}
-
-			/* Require "clean" floor space */
-			if (!cave_clean_bold(j, k))
-				continue;
-
-			/* Place an item */
-			place_object(j, k, FALSE, FALSE);
-
-			/* Placement accomplished */
+		if (!alloc_cand_pick(&j, &k))
 			break;
-		}
+
+		/* Place an item */
+		place_object(j, k, FALSE, FALSE);
 	}
 }
 
 
 /*
- * Place a trap with a given displacement of point
+ * Place some traps with a given displacement of given location
  */
-static void vault_trap_aux(int y, int x, int yd, int xd)
+static void vault_traps(int y, int x, int yd, int xd, int num)
 {
-	int count, y1, x1;
+	int y1, x1;
 
-	/* Place traps */
-	for (count = 0; count <= 5; count++)
+	/* Require "naked" floor grids */
+	alloc_cand_build(y - yd, x - xd, y + yd, x + xd, ALLOC_SET_BOTH, FALSE);
+
+	for (; num > 0; --num)
 	{
-		/* Get a location */
-		while (1)
-		{
-			y1 = rand_spread(y, yd);
-			x1 = rand_spread(x, xd);
-			if (!in_bounds(y1, x1))
-				continue;
+		if (!alloc_cand_pick(&y1, &x1))
 			break;
-		}
-
-		/* Require "naked" floor grids */
-		if (!cave_naked_bold(y1, x1))
-			continue;
 
 		/* Place the trap */
 		place_trap(y1, x1);
-
-		/* Done */
-		break;
-	}
-}
-
-
-/*
- * Place some traps with a given displacement of given location
- */
-static void vault_traps(int y, int x, int yd, int xd, int num)
-{
-	int i;
-
-	for (i = 0; i < num; i++)
-	{
-		vault_trap_aux(y, x, yd, xd);
 	}
 }
 
@@ -1360,41 +1624,35 @@ static void populate_guard_posts(int y1, int x1, int y2, int x2)
     int num_guards = 1 + rand_int(3);
     int i;
 
+    alloc_cand_build(y1, x1, y2 - 1, x2 - 1, ALLOC_SET_BOTH, FALSE);
+
     for (i = 0; i < num_guards; i++) {
         int y, x;
-        int tries = 0;
+        int type = GUARD_POST_ROOM;
 
-        while (tries++ < 100) {
-            y = y1 + rand_int(y2 - y1);
-            x = x1 + rand_int(x2 - x1);
+        if (!alloc_cand_pick(&y, &x)) break;
 
-            if (!cave_floor_bold(y, x)) continue;
+        /* Prefer high value locations */
+        if (rand_int(100) < 50) {
+            /* Guard doorways */
+            int dy, dx;
+            for (dy = -1; dy <= 1; dy++) {
+                for (dx = -1; dx <= 1; dx++) {
+                    if (cave_feat[y+dy][x+dx] >= FEAT_DOOR_HEAD &&
+                        cave_feat[y+dy][x+dx] <= FEAT_DOOR_TAIL + 7) {
+                        type = GUARD_POST_DOOR;
+                    }
+                }
+            }
+        }
 
-            /* Prefer high value locations */
-            if (rand_int(100) < 50) {
-                /* Guard doorways */
-                int dy, dx;
-                for (dy = -1; dy <= 1; dy++) {
-                    for (dx = -1; dx <= 1; dx++) {
-                        if (cave_feat[y+dy][x+dx] >= FEAT_DOOR_HEAD &&
-                            cave_feat[y+dy][x+dx] <= FEAT_DOOR_TAIL + 7) {
-                            place_guard(y, x, 0, GUARD_POST_DOOR);
-                            return;
-                        }
-                    }
-                }
-            }
-
-            /* Guard high ground */
-            if (get_elevation(y, x) > ELEV_GROUND && rand_int(100) < 60) {
-                place_guard(y, x, 0, GUARD_POST_HIGHGROUND);
-                return;
-            }
-
-            /* Regular guard post */
-            place_guard(y, x, 0, GUARD_POST_ROOM);
-            return;
+        /* Guard high ground */
+        if ((type == GUARD_POST_ROOM) &&
+            get_elevation(y, x) > ELEV_GROUND && rand_int(100) < 60) {
+            type = GUARD_POST_HIGHGROUND;
         }
+
+        place_guard(y, x, 0, type);
     }
 }
 
@@ -2449,457 +2707,446 @@ static bool hook_vault_object(int k_idx)
 }
 
 /*
- * Hack -- fill in "vault" rooms
- * Added parameter for quest type -KMW-
- * Modified to read extended vault information -KMW-
+ * Decoded vaults, by "v_info" index
  */
-static void build_vault(int yval, int xval, vault_type* v_ptr) {
-	int xmax = v_ptr->wid;
-	int ymax = v_ptr->hgt;
-	cptr data = v_text + v_ptr->text;
-	cptr mdata = vm_text + v_ptr->m_text;
-	cptr t = data;
-	cptr t2 = mdata;
+static vault_raster *vault_rasters = NULL;
+
+
+/*
+ * The fixed feature of a vault feature glyph
+ */
+static byte vault_glyph_feat(char datum, bool town_symb)
+{
+	/* Shop, 0-7 */
+	if (isdigit(datum) && datum < '8') return (FEAT_SHOP_HEAD + (datum - '0'));
+
+	/* Building, a-z */
+	if (islower(datum)) return (FEAT_BLDG_HEAD + (datum - 'a'));
+
+	/* Analyze the grid */
+	switch (datum)
+	{
+		case '%': return (FEAT_WALL_OUTER);
+		case '#': return (FEAT_WALL_INNER);
+		case ':': return (FEAT_RUBBLE);
+		case '&': return (FEAT_MAGMA);
+		case '$': return (FEAT_QUARTZ);
+		case 'X': return (FEAT_PERM_INNER);
+		case 'Q': return (FEAT_QUEST_ENTER);
+		case 'E': return (FEAT_QUEST_EXIT);
+		case '<': return (FEAT_LESS);
+		case '>': return (FEAT_MORE);
+		case 'A': return (FEAT_GRASS);
+		case 'B': return (FEAT_SWAMP);
+		case 'C': return (FEAT_MUD);
+		case 'H': return (FEAT_SHRUB);
+		case 'I': return (FEAT_ROCKY_HILL);
+		case 'V': return (FEAT_SHAL_WATER);
+		case 'W': return (FEAT_DEEP_WATER);
+		case 'J': return (FEAT_FOG);
+		case 'K': return (FEAT_SHAL_LAVA);
+		case 'L': return (FEAT_DEEP_LAVA);
+		case 'F': return (FEAT_CHAOS_FOG);
+		case ';': return (FEAT_GLYPH);
+		case 'Y': return (FEAT_TREES);
+		case '+': return (FEAT_SECRET);
+		case 'M': return (FEAT_MOUNTAIN);
+		case 'S': return (FEAT_STORE_EXIT);
+		case 'U': return (FEAT_SHAFT);
+
+		/* Unlocked doors in the town. */
+		case 'D': if (town_symb) return (FEAT_DOOR_HEAD);
+	}
 
-	int dx, dy, x, y, i, j;
+	/* Lay down a floor */
+	return (FEAT_FLOOR);
+}
 
 
+/*
+ * Decode the run-length encoded text of a vault, once.
+ *
+ * Every grid gets its fixed feature, and the few glyphs which need the
+ * RNG or place something (altars, traps, generators, random doors) are
+ * flagged, so that "build_vault()" only has to copy the rest.  The
+ * monster/object layer becomes a list of its non-blank grids.
+ */
+static vault_raster *vault_get_raster(vault_type *v_ptr)
+{
+	vault_raster *r_ptr;
+	int size = v_ptr->hgt * v_ptr->wid;
 	bool town_symb = (v_ptr->typ == 10 || v_ptr->typ == 11 ||
 			  v_ptr->typ == 12);
-
 	bool wild_symb = (v_ptr->typ == 13);
-
+	cptr t;
 	char datum;
 	byte number;
+	int i, n;
 
-	int mode = MON_ALLOC_SLEEP;
+	if (!vault_rasters) C_MAKE(vault_rasters, MAX_V_IDX, vault_raster);
 
-	i = 0;
-	j = 0;
+	r_ptr = &vault_rasters[v_ptr - v_info];
 
-	/* Flag quest monsters as such. */
-	if (v_ptr->typ == 99)
-	{
-		mode |= MON_ALLOC_QUEST;
-	}
+	/* Already decoded */
+	if (r_ptr->feat) return (r_ptr);
 
-	/* Vaults are different even in persistent dungeons. */
-	if (seed_dungeon)
-	{
-		Rand_quick = FALSE;
-	}
+	C_MAKE(r_ptr->feat, size, byte);
+	C_MAKE(r_ptr->info, size, byte);
+	C_MAKE(r_ptr->glyph, size, char);
 
-	/* Get the first chunk of data. */
+	/* Decode the features */
+	t = v_text + v_ptr->text;
 	datum = t[0];
 	number = t[1];
 
-	/* Place dungeon features. */
-	for (dy = 0; dy < ymax; dy++) {
-	  for (dx = 0; dx < xmax; dx++) {
-
-	    /* Extract the location */
-	    x = xval - (xmax / 2) + dx;
-	    y = yval - (ymax / 2) + dy;
-
-
-	    /* Place some dungeon features. */
-	    if (datum != ' ' && datum != '-') {
-
-	      /* Lay down a floor */
-	      cave_feat[y][x] = FEAT_FLOOR;
-
-	      /* Part of a vault */
-	      cave_info[y][x] |= (CAVE_ROOM);
-
-	      if (!town_symb && !wild_symb) {
-		cave_info[y][x] |= (CAVE_ICKY);
-	      }
-
-	      /* Shop, 0-7 */
-	      if (isdigit(datum) && datum < '8') {
-		int feat = FEAT_SHOP_HEAD + (datum - '0');
-
-		cave_feat[y][x] = feat;
-	      }
-
-	      /* Building, a-z */
-	      if (islower(datum)) {
-		int feat = FEAT_BLDG_HEAD + (datum - 'a');
-
-		cave_feat[y][x] = feat;
-	      }
-
-	      /* Analyze the grid */
-	      switch (datum) {
-
-		/* Granite wall (outer) */
-	      case '%':
-		cave_feat[y][x] = FEAT_WALL_OUTER;
-		break;
-
-		/* Granite wall (inner) */
-	      case '#':
-		cave_feat[y][x] = FEAT_WALL_INNER;
-		break;
-
-		/* Rubble. */
-	      case ':':
-		cave_feat[y][x] = FEAT_RUBBLE;
-		break;
-
-		/* Magma. */
-	      case '&':
-		cave_feat[y][x] = FEAT_MAGMA;
-		break;
-
-		/* Quartz. */
-	      case '$':
-		cave_feat[y][x] = FEAT_QUARTZ;
-		break;
-
-		/* Permanent wall (inner) */
-	      case 'X':
-		cave_feat[y][x] = FEAT_PERM_INNER;
-		break;
-
-		/* Quest Entrance */
-	      case 'Q':
-		cave_feat[y][x] = FEAT_QUEST_ENTER;
-		break;
+	for (i = 0; i < size; i++)
+	{
+		r_ptr->glyph[i] = datum;
 
-		/* Quest Exit -KMW- */
-	      case 'E':
-		cave_feat[y][x] = FEAT_QUEST_EXIT;
-		break;
+		if (datum != ' ' && datum != '-')
+		{
+			r_ptr->info[i] = VAULT_GRID_USED;
+			r_ptr->feat[i] = vault_glyph_feat(datum, town_symb);
 
-		/* Stairs up (exit without completing) -KMW- */
-	      case '<':
-		cave_feat[y][x] = FEAT_LESS;
-		break;
+			/* Glyphs of warding are always permanent */
+			if ((!town_symb && !wild_symb) || (datum == ';'))
+				r_ptr->info[i] |= VAULT_GRID_ICKY;
 
-		/* Stairs down */
-	      case '>':
-		cave_feat[y][x] = FEAT_MORE;
-		break;
+			if (strchr("O*^G", datum) || (datum == 'D' && !town_symb))
+				r_ptr->info[i] |= VAULT_GRID_SPECIAL;
+		}
 
-		/* Random altar. */
-	      case 'O':
-		place_altar(y, x);
-		break;
+		/* End of a run. */
+		if (!--number)
+		{
+			t += 2;
 
-		/* Grass. */
-	      case 'A':
-		cave_feat[y][x] = FEAT_GRASS;
-		break;
+			datum = t[0];
+			number = t[1];
+		}
+	}
 
-		/* Swamp. */
-	      case 'B':
-		cave_feat[y][x] = FEAT_SWAMP;
-		break;
+	/* Count the monsters and objects */
+	for (n = 0; n < 2; n++)
+	{
+		int k = 0;
 
-		/* Mud. */
-	      case 'C':
-		cave_feat[y][x] = FEAT_MUD;
-		break;
+		t = vm_text + v_ptr->m_text;
+		datum = t[0];
+		number = t[1];
 
-		/* Shrub. */
-	      case 'H':
-		cave_feat[y][x] = FEAT_SHRUB;
-		break;
+		for (i = 0; i < size; i++)
+		{
+			if (datum != ' ' && datum != '-')
+			{
+				if (n)
+				{
+					r_ptr->place_grid[k] = i;
+					r_ptr->place_glyph[k] = datum;
+				}
 
-		/* Rocky hill */
-	      case 'I':
-		cave_feat[y][x] = FEAT_ROCKY_HILL;
-		break;
+				k++;
+			}
 
-		/* Water (shallow) -KMW- */
-	      case 'V':
-		cave_feat[y][x] = FEAT_SHAL_WATER;
-		break;
+			/* End of a run. */
+			if (!--number)
+			{
+				t += 2;
 
-		/* Water (deep) -KMW- */
-	      case 'W':
-		cave_feat[y][x] = FEAT_DEEP_WATER;
-		break;
+				datum = t[0];
+				number = t[1];
+			}
+		}
 
-		/* Fog. */
-	      case 'J':
-		cave_feat[y][x] = FEAT_FOG;
-		break;
+		/* Make room on the first pass */
+		if (!n)
+		{
+			r_ptr->place_num = k;
+			C_MAKE(r_ptr->place_grid, MAX(k, 1), s16b);
+			C_MAKE(r_ptr->place_glyph, MAX(k, 1), char);
+		}
+	}
 
-		/* Lava (shallow) -KMW- */
-	      case 'K':
-		cave_feat[y][x] = FEAT_SHAL_LAVA;
-		break;
+	return (r_ptr);
+}
 
-		/* Lava (deep) -KMW- */
-	      case 'L':
-		cave_feat[y][x] = FEAT_DEEP_LAVA;
-		break;
 
-		/* Chaos fog */
-	      case 'F':
-		cave_feat[y][x] = FEAT_CHAOS_FOG;
-		break;
+/*
+ * Place the monsters and objects of a vault whose features are in place
+ */
+static void build_vault_residents(int yval, int xval, vault_type *v_ptr)
+{
+	int xmax = v_ptr->wid;
+	int ymax = v_ptr->hgt;
+	vault_raster *r_ptr = vault_get_raster(v_ptr);
 
-		/* Glyph of warding */
-	      case ';':
-		/* Always permanent */
-		cave_info[y][x] |= (CAVE_ICKY);
-		cave_feat[y][x] = FEAT_GLYPH;
-		break;
+	int dx, dy, x, y, k;
 
-		/* Trees */
-	      case 'Y':
-		cave_feat[y][x] = FEAT_TREES;
-		break;
+	bool town_symb = (v_ptr->typ == 10 || v_ptr->typ == 11 ||
+			  v_ptr->typ == 12);
 
-		/* Treasure/trap */
-	      case '*':
-		if (rand_int(100) < 50) {
-		  place_trap(y, x);
-		}
-		break;
+	char datum;
 
-		/* Secret doors */
-	      case '+':
-		place_secret_door(y, x);
-		break;
+	int mode = MON_ALLOC_SLEEP;
 
-		/* Regular doors */
-	      case 'D':
-		/* Unlocked doors in the town. */
-		if (town_symb)
-		  cave_feat[y][x] = FEAT_DOOR_HEAD;
-		else
-		  cave_feat[y][x] = FEAT_DOOR_HEAD + randint(4);
-		break;
+	/* Flag quest monsters as such. */
+	if (v_ptr->typ == 99)
+	{
+		mode |= MON_ALLOC_QUEST;
+	}
 
-		/* Trap */
-	      case '^':
-		place_trap(y, x);
-		break;
+	/* Vaults are different even in persistent dungeons. */
+	if (seed_dungeon)
+	{
+		Rand_quick = FALSE;
+	}
 
-		/* Generator */
-	      case 'G':
-		if (v_ptr->mon[0]) {
-		  create_generator(v_ptr->mon[0], y, x);
-		}
-		break;
+	for (k = 0; k < r_ptr->place_num; k++) {
 
-	      case 'M':
-		cave_feat[y][x] = FEAT_MOUNTAIN;
-		break;
+	  datum = r_ptr->place_glyph[k];
 
-		/* Store exit. */
-	      case 'S':
-		cave_feat[y][x] = FEAT_STORE_EXIT;
-		break;
+	  /* Extract the location */
+	  dy = r_ptr->place_grid[k] / xmax;
+	  dx = r_ptr->place_grid[k] % xmax;
 
-		/* Shaft. */
-	      case 'U':
-		cave_feat[y][x] = FEAT_SHAFT;
-		break;
-	      }
-	    }
+	  x = xval - (xmax / 2) + dx;
+	  y = yval - (ymax / 2) + dy;
 
 
-	    /* Advance. */
-	    number--;
+	    /* Monsters, 0-9 */
+	    if (isdigit(datum)) {
+	      int i = v_ptr->mon[(datum - '0')];
 
-	    /* End of a run. */
-	    if (!number) {
-	      t += 2;
+	      /* What a disgusting hack -- allow unfair monsters in */
+	      /* vaults and such. */
+	      bool um_opt = unfair_monsters;
 
-	      datum = t[0];
-	      number = t[1];
+	      unfair_monsters = TRUE;
+	      place_monster_aux(y, x, i, mode);
+	      unfair_monsters = um_opt;
 	    }
-	  }
-	}
 
+	    /* Monsters, a-z, A-Z */
+	    if (isalpha(datum)) {
+	      s16b r_idx;
 
-	/* Get the first chunk of data. */
-	datum = t2[0];
-	number = t2[1];
+	      hook_vault_monster_param = datum;
+	      get_mon_num_hook = hook_vault_monster;
+	      get_mon_num_prep();
 
-	/* Place dungeon monsters and objects. */
-	for (dy = 0; dy < ymax; dy++) {
-	  for (dx = 0; dx < xmax; dx++) {
-
-
-	    /* Extract the location */
-	    x = xval - (xmax / 2) + dx;
-	    y = yval - (ymax / 2) + dy;
-
-
-	    /* 
-	     * Place some monsters/objects. 
-	     */
-	    if (datum != ' ' && datum != '-') {
-
-	      /* Monsters, 0-9 */
-	      if (isdigit(datum)) {
-		int i = v_ptr->mon[(datum - '0')];
+	      r_idx = get_mon_num(p_ptr->depth);
 
+	      if (r_idx) {
 		/* What a disgusting hack -- allow unfair monsters in */
 		/* vaults and such. */
 		bool um_opt = unfair_monsters;
 
 		unfair_monsters = TRUE;
-		place_monster_aux(y, x, i, mode);
+		place_monster_aux(y, x, r_idx, mode);
 		unfair_monsters = um_opt;
 	      }
 
-	      /* Monsters, a-z, A-Z */
-	      if (isalpha(datum)) {
-		s16b r_idx;
+	      get_mon_num_hook = NULL;
+	      get_mon_num_prep();
+	    }
+
+	    /* Place the object with that picture. */
+	    if (strchr("!\"$(),~'/=?[\\]_{|}", datum)) {
+	      s16b k_idx;
 
-		hook_vault_monster_param = datum;
-		get_mon_num_hook = hook_vault_monster;
-		get_mon_num_prep();
+	      hook_vault_object_param = datum;
+	      get_obj_num_hook = hook_vault_object;
+	      get_obj_num_prep();
 
-		r_idx = get_mon_num(p_ptr->depth);
+	      k_idx = get_obj_num(p_ptr->depth);
 
-		if (r_idx) {
-		  /* What a disgusting hack -- allow unfair monsters in */
-		  /* vaults and such. */
-		  bool um_opt = unfair_monsters;
+	      if (k_idx) {
+		object_type *o_ptr = new_object();
 
-		  unfair_monsters = TRUE;
-		  place_monster_aux(y, x, r_idx, mode);
-		  unfair_monsters = um_opt;
-		}
+		object_prep(o_ptr, k_idx);
+		apply_magic(o_ptr, p_ptr->depth, TRUE, FALSE, FALSE);
 
-		get_mon_num_hook = NULL;
-		get_mon_num_prep();
+		floor_carry(y, x, o_ptr);
 	      }
 
-	      /* Place the object with that picture. */
-	      if (strchr("!\"$(),~'/=?[\\]_{|}", datum)) {
-		s16b k_idx;
+	      get_obj_num_hook = NULL;
+	      get_obj_num_prep();
+	    }
 
-		hook_vault_object_param = datum;
-		get_obj_num_hook = hook_vault_object;
-		get_obj_num_prep();
+	    switch (datum) {
+	      /* Treasure/trap */
+	    case '*':
+	      if (rand_int(100) < 50) {
+		place_object(y, x, FALSE, FALSE);
+	      }
+	      break;
 
-		k_idx = get_obj_num(p_ptr->depth);
+	      /* Treasure -KMW- (Was: 'T') */
+	    case '.':
+	      if (rand_int(100) < 75) {
+		place_object(y, x, FALSE, FALSE);
 
-		if (k_idx) {
-		  object_type *o_ptr = new_object();
+	      } else if (rand_int(100) < 80) {
+		place_object(y, x, TRUE, FALSE);
 
-		  object_prep(o_ptr, k_idx);
-		  apply_magic(o_ptr, p_ptr->depth, TRUE, FALSE, FALSE);
+	      } else {
+		place_object(y, x, TRUE, TRUE);
+	      }
+	      break;
+
+	      /* [Arena] Monster */
+	    case '&':
+	      if (town_symb) {
+		place_monster_aux(y, x, 
+				  arena_monsters[p_ptr->which_arena]
+				  [p_ptr->arena_number[p_ptr->which_arena]],
+				  MON_ALLOC_ARENA | MON_ALLOC_JUST_ONE);
+	      } else {
+		monster_level = p_ptr->depth + 5;
+		place_monster(y, x, mode);
+		monster_level = p_ptr->depth;
+	      }
+	      break;
+
+	      /* Meaner monster (Was: '@') */
+	    case ';':
+	      monster_level = p_ptr->depth + 11;
+	      place_monster(y, x, mode);
+	      monster_level = p_ptr->depth;
+	      break;
+
+	      /* Meaner monster, plus treasure (Was: '9') */
+	    case '#':
+	      monster_level = p_ptr->depth + 9;
+	      place_monster(y, x, mode);
+	      monster_level = p_ptr->depth;
+	      object_level = p_ptr->depth + 7;
+	      place_object(y, x, TRUE, FALSE);
+	      object_level = p_ptr->depth;
+	      break;
+
+	      /* Nasty monster and treasure (Was: '8') */
+	    case '^':
+	      monster_level = p_ptr->depth + 40;
+	      place_monster(y, x, mode);
+	      monster_level = p_ptr->depth;
+	      object_level = p_ptr->depth + 20;
+	      place_object(y, x, TRUE, TRUE);
+	      object_level = p_ptr->depth;
+	      break;
+
+	      /* Monster and/or object (Was: ',') */
+	    case ':':
+	      if (rand_int(100) < 50) {
+		monster_level = p_ptr->depth + 3;
+		place_monster(y, x, mode);
+		monster_level = p_ptr->depth;
+	      }
 
-		  floor_carry(y, x, o_ptr);
-		}
+	      if (rand_int(100) < 50) {
+		object_level = p_ptr->depth + 7;
+		place_object(y, x, FALSE, FALSE);
+		object_level = p_ptr->depth;
+	      }
+	      break;
 
-		get_obj_num_hook = NULL;
-		get_obj_num_prep();
+	      /* Player position for quests (Was: 'P') */
+	    case '@':
+	      if (p_ptr->inside_special != SPECIAL_WILD ||
+		  hook_vault_place_player) {
+		player_place(y, x);
 	      }
 
-	      switch (datum) {
-		/* Treasure/trap */
-	      case '*':
-		if (rand_int(100) < 50) {
-		  place_object(y, x, FALSE, FALSE);
-		}
-		break;
+	      break;
+	    }
+	}
 
-		/* Treasure -KMW- (Was: 'T') */
-	      case '.':
-		if (rand_int(100) < 75) {
-		  place_object(y, x, FALSE, FALSE);
+	if (seed_dungeon)
+	{
+		Rand_quick = TRUE;
+	}
+}
 
-		} else if (rand_int(100) < 80) {
-		  place_object(y, x, TRUE, FALSE);
 
-		} else {
-		  place_object(y, x, TRUE, TRUE);
-		}
-		break;
+/*
+ * Hack -- fill in "vault" rooms
+ * Added parameter for quest type -KMW-
+ * Modified to read extended vault information -KMW-
+ */
+static void build_vault(int yval, int xval, vault_type* v_ptr) {
+	int xmax = v_ptr->wid;
+	int ymax = v_ptr->hgt;
+	vault_raster *r_ptr = vault_get_raster(v_ptr);
 
-		/* [Arena] Monster */
-	      case '&':
-		if (town_symb) {
-		  place_monster_aux(y, x, 
-				    arena_monsters[p_ptr->which_arena]
-				    [p_ptr->arena_number[p_ptr->which_arena]],
-				    MON_ALLOC_ARENA | MON_ALLOC_JUST_ONE);
-		} else {
-		  monster_level = p_ptr->depth + 5;
-		  place_monster(y, x, mode);
-		  monster_level = p_ptr->depth;
-		}
-		break;
+	int dx, dy, x, y, i;
 
-		/* Meaner monster (Was: '@') */
-	      case ';':
-		monster_level = p_ptr->depth + 11;
-		place_monster(y, x, mode);
-		monster_level = p_ptr->depth;
-		break;
+	/* Vaults are different even in persistent dungeons. */
+	if (seed_dungeon)
+	{
+		Rand_quick = FALSE;
+	}
 
-		/* Meaner monster, plus treasure (Was: '9') */
-	      case '#':
-		monster_level = p_ptr->depth + 9;
-		place_monster(y, x, mode);
-		monster_level = p_ptr->depth;
-		object_level = p_ptr->depth + 7;
-		place_object(y, x, TRUE, FALSE);
-		object_level = p_ptr->depth;
-		break;
+	/* Place dungeon features. */
+	for (dy = 0, i = 0; dy < ymax; dy++) {
+	  for (dx = 0; dx < xmax; dx++, i++) {
 
-		/* Nasty monster and treasure (Was: '8') */
-	      case '^':
-		monster_level = p_ptr->depth + 40;
-		place_monster(y, x, mode);
-		monster_level = p_ptr->depth;
-		object_level = p_ptr->depth + 20;
-		place_object(y, x, TRUE, TRUE);
-		object_level = p_ptr->depth;
-		break;
+	    /* Not part of the vault */
+	    if (!(r_ptr->info[i] & VAULT_GRID_USED)) continue;
 
-		/* Monster and/or object (Was: ',') */
-	      case ':':
-		if (rand_int(100) < 50) {
-		  monster_level = p_ptr->depth + 3;
-		  place_monster(y, x, mode);
-		  monster_level = p_ptr->depth;
-		}
-		
-		if (rand_int(100) < 50) {
-		  object_level = p_ptr->depth + 7;
-		  place_object(y, x, FALSE, FALSE);
-		  object_level = p_ptr->depth;
-		}
-		break;
+	    /* Extract the location */
+	    x = xval - (xmax / 2) + dx;
+	    y = yval - (ymax / 2) + dy;
 
-		/* Player position for quests (Was: 'P') */
-	      case '@':
-		if (p_ptr->inside_special != SPECIAL_WILD ||
-		    hook_vault_place_player) {
-		  player_place(y, x);
-		}
+	    cave_feat[y][x] = r_ptr->feat[i];
 
-		break;
-	      }
+	    /* Part of a vault */
+	    cave_info[y][x] |= (CAVE_ROOM);
+
+	    if (r_ptr->info[i] & VAULT_GRID_ICKY) {
+	      cave_info[y][x] |= (CAVE_ICKY);
 	    }
 
+	    if (!(r_ptr->info[i] & VAULT_GRID_SPECIAL)) continue;
 
-	    /* Advance. */
-	    number--;
+	    /* Analyze the grid */
+	    switch (r_ptr->glyph[i]) {
 
-	    /* End of a run. */
-	    if (!number) {
-	      t2 += 2;
+	      /* Random altar. */
+	    case 'O':
+	      place_altar(y, x);
+	      break;
 
-	      datum = t2[0];
-	      number = t2[1];
+	      /* Treasure/trap */
+	    case '*':
+	      if (rand_int(100) < 50) {
+		place_trap(y, x);
+	      }
+	      break;
+
+	      /* Regular doors */
+	    case 'D':
+	      cave_feat[y][x] = FEAT_DOOR_HEAD + randint(4);
+	      break;
+
+	      /* Trap */
+	    case '^':
+	      place_trap(y, x);
+	      break;
+
+	      /* Generator */
+	    case 'G':
+	      if (v_ptr->mon[0]) {
+		create_generator(v_ptr->mon[0], y, x);
+	      }
+	      break;
 	    }
-
 	  }
 	}
 
+
+	/* Place dungeon monsters and objects. */
+	build_vault_residents(yval, xval, v_ptr);
+
 	if (seed_dungeon)
 	{
 		Rand_quick = TRUE;
@@ -3003,26 +3250,135 @@ static void build_type9(int yval, int xval)
 			break;
 	}
 
-	/* Message */
-	if (cheat_room)
-		msg_format("Themed Vault %d", vindex);
+	/* Message */
+	if (cheat_room)
+		msg_format("Themed Vault %d", vindex);
+
+	/* Boost the rating */
+	rating += v_ptr->rat;
+
+	/* (Sometimes) Cause a special feeling */
+	if ((p_ptr->depth <= 50) ||
+		(randint((p_ptr->depth - 40) * (p_ptr->depth - 40) + 1) < 400))
+	{
+		good_item_flag = TRUE;
+	}
+
+	/* Hack -- Build the vault */
+	build_vault(yval, xval, v_ptr);
+}
+
+
+
+/*
+ * Queue a grid of the tunnel being planned, once
+ *
+ * A tunnel often crosses itself before it is carved, so the grids
+ * queued are marked with "CAVE_TEMP", and the bound on "dun->tunn"
+ * counts grids rather than steps.
+ */
+static void tunnel_grid(int y, int x)
+{
+	/* Already queued */
+	if (cave_info[y][x] & (CAVE_TEMP)) return;
+
+	/* No room */
+	if (dun->tunn_n >= TUNN_MAX) return;
+
+	cave_info[y][x] |= (CAVE_TEMP);
+
+	dun->tunn[dun->tunn_n].y = y;
+	dun->tunn[dun->tunn_n].x = x;
+	dun->tunn_n++;
+}
+
+
+/*
+ * Queue a room wall pierced by the tunnel being planned, once
+ */
+static void tunnel_wall(int y, int x)
+{
+	/* Already queued */
+	if (cave_info[y][x] & (CAVE_TEMP)) return;
+
+	/* No room */
+	if (dun->wall_n >= WALL_MAX) return;
+
+	cave_info[y][x] |= (CAVE_TEMP);
+
+	dun->wall[dun->wall_n].y = y;
+	dun->wall[dun->wall_n].x = x;
+	dun->wall_n++;
+}
+
+
+/*
+ * Forget the tunnel being planned, without carving it
+ */
+static void tunnel_forget(void)
+{
+	int i;
+
+	for (i = 0; i < dun->tunn_n; i++)
+	{
+		cave_info[dun->tunn[i].y][dun->tunn[i].x] &= ~(CAVE_TEMP);
+	}
+
+	for (i = 0; i < dun->wall_n; i++)
+	{
+		cave_info[dun->wall[i].y][dun->wall[i].x] &= ~(CAVE_TEMP);
+	}
+
+	dun->tunn_n = 0;
+	dun->wall_n = 0;
+}
+
+
+/*
+ * Carve the tunnel which was planned, in one pass
+ */
+static void tunnel_carve(void)
+{
+	int i, y, x;
+
+	/* Turn the tunnel into corridor */
+	for (i = 0; i < dun->tunn_n; i++)
+	{
+		/* Access the grid */
+		y = dun->tunn[i].y;
+		x = dun->tunn[i].x;
+
+		/* Clear previous contents, add a floor */
+		cave_feat[y][x] = FEAT_FLOOR;
+
+		/* Forget the mark */
+		cave_info[y][x] &= ~(CAVE_TEMP);
+	}
+
+
+	/* Apply the piercings that we found */
+	for (i = 0; i < dun->wall_n; i++)
+	{
+		/* Access the grid */
+		y = dun->wall[i].y;
+		x = dun->wall[i].x;
+
+		/* Convert to floor grid */
+		cave_feat[y][x] = FEAT_FLOOR;
 
-	/* Boost the rating */
-	rating += v_ptr->rat;
+		/* Forget the mark */
+		cave_info[y][x] &= ~(CAVE_TEMP);
 
-	/* (Sometimes) Cause a special feeling */
-	if ((p_ptr->depth <= 50) ||
-		(randint((p_ptr->depth - 40) * (p_ptr->depth - 40) + 1) < 400))
-	{
-		good_item_flag = TRUE;
+		/* Occasional doorway */
+		if (rand_int(100) < DUN_TUN_PEN)
+		{
+			/* Place a random door */
+			place_random_door(y, x);
+		}
 	}
-
-	/* Hack -- Build the vault */
-	build_vault(yval, xval, v_ptr);
 }
 
 
-
 /*
  * Constructs a tunnel using a drunken walker algorithm
  */
@@ -3098,12 +3454,7 @@ static void build_tunnel_winding(int row1, int col1, int row2, int col2)
             /* Simplified: just mark as wall piercing */
 
 			/* Save the wall location */
-			if (dun->wall_n < WALL_MAX)
-			{
-				dun->wall[dun->wall_n].y = y;
-				dun->wall[dun->wall_n].x = x;
-				dun->wall_n++;
-			}
+			tunnel_wall(y, x);
 
             /* We don't implement the complex solid wall conversion here for simplicity,
                or we should? The original code does it to prevent silly doors.
@@ -3120,12 +3471,7 @@ static void build_tunnel_winding(int row1, int col1, int row2, int col2)
 		{
 			if (dun->tunn_n >= TUNN_MAX - 1) break;
 
-			if (dun->tunn_n < TUNN_MAX)
-			{
-				dun->tunn[dun->tunn_n].y = y;
-				dun->tunn[dun->tunn_n].x = x;
-				dun->tunn_n++;
-			}
+			tunnel_grid(y, x);
 			door_flag = FALSE;
 		}
 		/* Handle corridor intersections */
@@ -3146,21 +3492,13 @@ static void build_tunnel_winding(int row1, int col1, int row2, int col2)
 
     /* Fallback if failed to reach target */
     if (loop >= loop_max) {
+        tunnel_forget();
         build_tunnel(row1, col1, row2, col2);
         return;
     }
 
 	/* Apply changes */
-	int i;
-	for (i = 0; i < dun->tunn_n; i++)
-	{
-		cave_feat[dun->tunn[i].y][dun->tunn[i].x] = FEAT_FLOOR;
-	}
-	for (i = 0; i < dun->wall_n; i++)
-	{
-		cave_feat[dun->wall[i].y][dun->wall[i].x] = FEAT_FLOOR;
-		if (rand_int(100) < DUN_TUN_PEN) place_random_door(dun->wall[i].y, dun->wall[i].x);
-	}
+	tunnel_carve();
 }
 
 /*
@@ -3199,7 +3537,7 @@ static void build_tunnel_winding(int row1, int col1, int row2, int col2)
  */
 static void build_tunnel(int row1, int col1, int row2, int col2)
 {
-	int i, y, x;
+	int y, x;
 	int tmp_row, tmp_col;
 	int row_dir, col_dir;
 	int start_row, start_col;
@@ -3299,12 +3637,7 @@ static void build_tunnel(int row1, int col1, int row2, int col2)
 			col1 = tmp_col;
 
 			/* Save the wall location */
-			if (dun->wall_n < WALL_MAX)
-			{
-				dun->wall[dun->wall_n].y = row1;
-				dun->wall[dun->wall_n].x = col1;
-				dun->wall_n++;
-			}
+			tunnel_wall(row1, col1);
 
 			/* Forbid re-entry near this piercing */
 			for (y = row1 - 1; y <= row1 + 1; y++)
@@ -3337,12 +3670,7 @@ static void build_tunnel(int row1, int col1, int row2, int col2)
 			col1 = tmp_col;
 
 			/* Save the tunnel location */
-			if (dun->tunn_n < TUNN_MAX)
-			{
-				dun->tunn[dun->tunn_n].y = row1;
-				dun->tunn[dun->tunn_n].x = col1;
-				dun->tunn_n++;
-			}
+			tunnel_grid(row1, col1);
 
 			/* Allow door in next grid */
 			door_flag = FALSE;
@@ -3391,35 +3719,8 @@ static void build_tunnel(int row1, int col1, int row2, int col2)
 	}
 
 
-	/* Turn the tunnel into corridor */
-	for (i = 0; i < dun->tunn_n; i++)
-	{
-		/* Access the grid */
-		y = dun->tunn[i].y;
-		x = dun->tunn[i].x;
-
-		/* Clear previous contents, add a floor */
-		cave_feat[y][x] = FEAT_FLOOR;
-	}
-
-
-	/* Apply the piercings that we found */
-	for (i = 0; i < dun->wall_n; i++)
-	{
-		/* Access the grid */
-		y = dun->wall[i].y;
-		x = dun->wall[i].x;
-
-		/* Convert to floor grid */
-		cave_feat[y][x] = FEAT_FLOOR;
-
-		/* Occasional doorway */
-		if (rand_int(100) < DUN_TUN_PEN)
-		{
-			/* Place a random door */
-			place_random_door(y, x);
-		}
-	}
+	/* Carve it */
+	tunnel_carve();
 }
 
 
@@ -3834,6 +4135,7 @@ static void build_type18(int yval, int xval)
         int m_idx = place_monster_aux(my, mx, 0, MON_ALLOC_SLEEP | MON_ALLOC_HIDE);
         if (m_idx > 0) {
             monster_guard_data *guard = alloc_guard_data(m_idx);
+            if (!guard) continue;
             guard->guard_state = GUARD_STATE_SLEEP;
             guard->patrol_type = PATROL_TYPE_STATIONARY;
             guard->home_y = my;
@@ -3979,8 +4281,8 @@ static bool room_build(int y0, int x0, int typ)
  * Helper for plasma generation.
  */
 
-static void perturb_point_mid(int x1, int x2, int x3, int x4, int xmid,
-	int ymid, int rough, int depth_max)
+static void perturb_point_mid(byte (*grid)[DUNGEON_WID], int x1, int x2,
+	int x3, int x4, int xmid, int ymid, int rough, int depth_max)
 {
 	/* Average the four corners & perturb it a bit. */
 	/* tmp is a random int +/- rough */
@@ -4000,12 +4302,12 @@ static void perturb_point_mid(int x1, int x2, int x3, int x4, int xmid,
 		avg = depth_max;
 
 	/* Set the new value. */
-	cave_feat[ymid][xmid] = avg;
+	grid[ymid][xmid] = avg;
 }
 
 
-static void perturb_point_end(int x1, int x2, int x3, int xmid, int ymid,
-	int rough, int depth_max)
+static void perturb_point_end(byte (*grid)[DUNGEON_WID], int x1, int x2,
+	int x3, int xmid, int ymid, int rough, int depth_max)
 {
 	/* Average the three corners & perturb it a bit. */
 	/* tmp is a random int +/- rough */
@@ -4025,13 +4327,13 @@ static void perturb_point_end(int x1, int x2, int x3, int xmid, int ymid,
 		avg = depth_max;
 
 	/* Set the new value. */
-	cave_feat[ymid][xmid] = avg;
+	grid[ymid][xmid] = avg;
 }
 
 
 /*
- * A generic function to generate the plasma fractal.
- * Note that it uses ``cave_feat'' as temporary storage.
+ * A generic function to generate the plasma fractal in "grid".
+ * Note that it is usually ``cave_feat'', used as temporary storage.
  * The values in ``cave_feat'' after this function
  * are NOT actual features; They are raw heights which
  * need to be converted to features.
@@ -4044,50 +4346,80 @@ static void perturb_point_end(int x1, int x2, int x3, int xmid, int ymid,
  *
  * A, B, C, and D are given; the other five we calculate by
  * averaging the neighbors and adding a random offset.
+ *
+ * The quadrants are handled depth first from an explicit stack, in the
+ * same order the old recursive version used, so a given seed still
+ * produces the same fractal (wilderness tiles depend on this).
  */
 
-static void plasma_recursive(int x1, int y1, int x2, int y2, int depth_max,
-	int rough)
+static void plasma_fractal(byte (*grid)[DUNGEON_WID], int x1, int y1,
+	int x2, int y2, int depth_max, int rough)
 {
-
-	/* Find middle */
-	int xmid = (x2 - x1) / 2 + x1;
-	int ymid = (y2 - y1) / 2 + y1;
-
-	/* Are we done? */
-	if (x1 + 1 == x2)
-	{
-		return;
+	s16b stack[PLASMA_STACK_MAX][4];
+	int n = 0;
+
+	/* Start with the whole rectangle */
+	stack[n][0] = x1;
+	stack[n][1] = y1;
+	stack[n][2] = x2;
+	stack[n][3] = y2;
+	n++;
+
+	while (n)
+	{
+		int xmid, ymid;
+
+		/* Take the next rectangle */
+		n--;
+		x1 = stack[n][0];
+		y1 = stack[n][1];
+		x2 = stack[n][2];
+		y2 = stack[n][3];
+
+		/* Are we done? */
+		if (x1 + 1 == x2) continue;
+
+		/* Find middle */
+		xmid = (x2 - x1) / 2 + x1;
+		ymid = (y2 - y1) / 2 + y1;
+
+		/* Calculate M */
+		perturb_point_mid(grid, grid[y1][x1], grid[y2][x1],
+			grid[y1][x2], grid[y2][x2], xmid, ymid, rough, depth_max);
+
+		/* Calculate U */
+		perturb_point_end(grid, grid[y1][x1], grid[y1][x2],
+			grid[ymid][xmid], xmid, y1, rough, depth_max);
+
+		/* Calculate R */
+		perturb_point_end(grid, grid[y1][x2], grid[y2][x2],
+			grid[ymid][xmid], x2, ymid, rough, depth_max);
+
+		/* Calculate B */
+		perturb_point_end(grid, grid[y2][x2], grid[y2][x1],
+			grid[ymid][xmid], xmid, y2, rough, depth_max);
+
+		/* Calculate L */
+		perturb_point_end(grid, grid[y2][x1], grid[y1][x1],
+			grid[ymid][xmid], x1, ymid, rough, depth_max);
+
+		/* Paranoia -- the stack cannot overflow */
+		if (n + 4 > PLASMA_STACK_MAX) continue;
+
+		/* Queue the four quadrants, the first one on top */
+		stack[n][0] = xmid; stack[n][1] = ymid;
+		stack[n][2] = x2; stack[n][3] = y2;
+		n++;
+		stack[n][0] = x1; stack[n][1] = ymid;
+		stack[n][2] = xmid; stack[n][3] = y2;
+		n++;
+		stack[n][0] = xmid; stack[n][1] = y1;
+		stack[n][2] = x2; stack[n][3] = ymid;
+		n++;
+		stack[n][0] = x1; stack[n][1] = y1;
+		stack[n][2] = xmid; stack[n][3] = ymid;
+		n++;
 	}
-
-	/* Calculate M */
-	perturb_point_mid(cave_feat[y1][x1], cave_feat[y2][x1],
-		cave_feat[y1][x2], cave_feat[y2][x2], xmid, ymid, rough,
-		depth_max);
-
-	/* Calculate U */
-	perturb_point_end(cave_feat[y1][x1], cave_feat[y1][x2],
-		cave_feat[ymid][xmid], xmid, y1, rough, depth_max);
-
-	/* Calculate R */
-	perturb_point_end(cave_feat[y1][x2], cave_feat[y2][x2],
-		cave_feat[ymid][xmid], x2, ymid, rough, depth_max);
-
-	/* Calculate B */
-	perturb_point_end(cave_feat[y2][x2], cave_feat[y2][x1],
-		cave_feat[ymid][xmid], xmid, y2, rough, depth_max);
-
-	/* Calculate L */
-	perturb_point_end(cave_feat[y2][x1], cave_feat[y1][x1],
-		cave_feat[ymid][xmid], x1, ymid, rough, depth_max);
-
-
-	/* Recurse the four quadrants */
-	plasma_recursive(x1, y1, xmid, ymid, depth_max, rough);
-	plasma_recursive(xmid, y1, x2, ymid, depth_max, rough);
-	plasma_recursive(x1, ymid, xmid, y2, depth_max, rough);
-	plasma_recursive(xmid, ymid, x2, y2, depth_max, rough);
-
 }
 
 
@@ -4230,9 +4562,9 @@ static void lite_up_town(bool daytime)
 {
 	int x, y, f, flg;
 
-	for (y = 0; y < DUNGEON_HGT; y++)
+	for (y = 0; y < cave_hgt; y++)
 	{
-		for (x = 0; x < DUNGEON_WID; x++)
+		for (x = 0; x < cave_wid; x++)
 		{
 			/* Interesting grids */
 			if (daytime || !cave_boring_bold(y, x))
@@ -4256,9 +4588,9 @@ static void lite_up_town(bool daytime)
 		flg |= CAVE_MARK;
 
 	/* Now add light in appropriate places */
-	for (y = 1; y < DUNGEON_HGT - 1; y++)
+	for (y = 1; y < cave_hgt - 1; y++)
 	{
-		for (x = 1; x < DUNGEON_WID - 1; x++)
+		for (x = 1; x < cave_wid - 1; x++)
 		{
 			/* If this is a shop, light it and surrounding squares */
 			f = cave_feat[y][x];
@@ -4285,16 +4617,292 @@ static void lite_up_town(bool daytime)
  * Generate a terrain level using ``plasma'' fractals.
  *
  */
+/*
+ * Cache of raw wilderness heights.
+ *
+ * The recently visited tiles keep their heights, so walking back and
+ * forth over a border does not rerun the plasma fractal.  While the game
+ * waits for a key, the tiles next to the current one are added too (see
+ * "wild_prefetch()"), so that crossing a border seldom has to build the
+ * heights at all.  Stairs, depth and vaults depend on how the tile was
+ * entered and are still generated afresh every time.
+ */
+static wild_tile *wild_cache[WILD_CACHE_MAX];
+static u32b wild_cache_clock = 0;
+
+/*
+ * Seeds of the corners and of the heights of a tile.  No real rationale
+ * behind these.  Anyone know a good hashing function for pairs of
+ * numbers?  The corners are shared with the neighbouring tiles, so the
+ * wilderness is fairly "tileable".
+ */
+#define HASH_CORNERS(X, Y) (((X) - (Y)) ^ (((X) + seed_wild) & (Y)))
+#define HASH_LEVEL(X, Y)   (((Y) - (X)) ^ ((Y) & ((X) + seed_wild)))
+
+/*
+ * Make the raw heights of tile "wx", "wy" in "w_ptr"
+ *
+ * Each part is drawn from its own stream, seeded from the tile, so the
+ * heights are the same whenever (and if ever) they are made, and making
+ * them draws nothing from the game's generator.
+ */
+static void wild_tile_build(wild_tile *w_ptr, int wx, int wy)
+{
+  byte (*grid)[DUNGEON_WID] = w_ptr->height;
+  rand_stream *stream_prev = Rand_stream;
+  rand_stream rs;
+  int y, x;
+
+  /* Terrain types, one for each height */
+  int table_size = 22;
+
+  /* The fractal does not reach every grid */
+  int level_bg = 11;
+
+  /* The roughness of the level */
+  int roughness = 1;
+
+  w_ptr->wild_x = wx;
+  w_ptr->wild_y = wy;
+  w_ptr->seed = seed_wild;
+
+  for (y = 1; y < DUNGEON_HGT - 1; y++) {
+    for (x = 1; x < DUNGEON_WID - 1; x++) {
+      grid[y][x] = level_bg;
+    }
+  }
+
+  Rand_stream = &rs;
+
+  Rand_stream_seed(&rs, HASH_CORNERS(wx, wy));
+  grid[1][1] = rand_int(table_size);
+
+  Rand_stream_seed(&rs, HASH_CORNERS(wx, wy + 1));
+  grid[DUNGEON_HGT - 2][1] = rand_int(table_size);
+
+  Rand_stream_seed(&rs, HASH_CORNERS(wx + 1, wy));
+  grid[1][DUNGEON_WID - 2] = rand_int(table_size);
+
+  Rand_stream_seed(&rs, HASH_CORNERS(wx + 1, wy + 1));
+  grid[DUNGEON_HGT - 2][DUNGEON_WID - 2] = rand_int(table_size);
+
+  Rand_stream_seed(&rs, HASH_LEVEL(wx, wy));
+
+  /* grid, x1, y1, x2, y2, num_depths, roughness */
+  plasma_fractal(grid, 1, 1, DUNGEON_WID - 2, DUNGEON_HGT - 2,
+		 table_size - 1, roughness);
+
+  Rand_stream = stream_prev;
+}
+
+/*
+ * Find the heights of tile "wx", "wy", if cached
+ */
+static wild_tile *wild_cache_find(int wx, int wy)
+{
+  int i;
+
+  for (i = 0; i < WILD_CACHE_MAX; i++) {
+    wild_tile *w_ptr = wild_cache[i];
+
+    if (!w_ptr || !w_ptr->used) continue;
+    if (w_ptr->wild_x != wx) continue;
+    if (w_ptr->wild_y != wy) continue;
+    if (w_ptr->seed != seed_wild) continue;
+
+    return (w_ptr);
+  }
+
+  return (NULL);
+}
+
+/*
+ * Get the heights of tile "wx", "wy", making them in the least recently
+ * used slot if they are not cached
+ */
+static wild_tile *wild_cache_get(int wx, int wy)
+{
+  int i, oldest = 0;
+  wild_tile *w_ptr = wild_cache_find(wx, wy);
+
+  if (!w_ptr) {
+    for (i = 0; i < WILD_CACHE_MAX; i++) {
+      /* Use a free slot */
+      if (!wild_cache[i]) {
+	oldest = i;
+	break;
+      }
+
+      if (wild_cache[i]->used < wild_cache[oldest]->used) oldest = i;
+    }
+
+    if (!wild_cache[oldest]) MAKE(wild_cache[oldest], wild_tile);
+
+    w_ptr = wild_cache[oldest];
+
+    wild_tile_build(w_ptr, wx, wy);
+  }
+
+  w_ptr->used = ++wild_cache_clock;
+
+  return (w_ptr);
+}
+
+/*
+ * Make the heights of one tile next to the current one, the one across
+ * the nearest border first, if it is not cached yet.
+ *
+ * Called while the game waits for a key.  Returns TRUE if it did
+ * anything (and may be called again).
+ */
+bool wild_prefetch(void)
+{
+  int dist[4], i, j, best;
+  static const int dx[4] = { 0, 0, -1, 1 };
+  static const int dy[4] = { -1, 1, 0, 0 };
+
+  if (!character_dungeon || p_ptr->leaving) return (FALSE);
+  if (p_ptr->inside_special != SPECIAL_WILD) return (FALSE);
+
+  /* Distance to each border (see "terrain_gen()") */
+  dist[0] = p_ptr->py;
+  dist[1] = DUNGEON_HGT - 1 - p_ptr->py;
+  dist[2] = p_ptr->px;
+  dist[3] = DUNGEON_WID - 1 - p_ptr->px;
+
+  for (j = 0; j < 4; j++) {
+    best = -1;
+
+    /* The nearest border not yet done */
+    for (i = 0; i < 4; i++) {
+      if (dist[i] < 0) continue;
+      if ((best < 0) || (dist[i] < dist[best])) best = i;
+    }
+
+    dist[best] = -1;
+
+    if (wild_cache_find(p_ptr->wild_x + dx[best],
+			p_ptr->wild_y + dy[best])) continue;
+
+    (void)wild_cache_get(p_ptr->wild_x + dx[best], p_ptr->wild_y + dy[best]);
+
+    return (TRUE);
+  }
+
+  return (FALSE);
+}
+
+
+/*
+ * Restore a town level kept by "town_layout_save()", if it is the one
+ * built from vault "vault" with "seed"
+ *
+ * The light is left to the caller.
+ */
+static bool town_layout_load(town_layout *t_ptr, s16b vault, u32b seed)
+{
+  int y, x;
+
+  if (!t_ptr) return (FALSE);
+  if (t_ptr->seed != seed) return (FALSE);
+  if (t_ptr->town != vault) return (FALSE);
+
+  for (y = 0; y < cave_hgt; y++) {
+    C_COPY(cave_feat[y], t_ptr->feat[y], cave_wid, byte);
+
+    for (x = 0; x < cave_wid; x++) {
+      cave_info[y][x] |= t_ptr->info[y][x];
+    }
+  }
+
+  return (TRUE);
+}
+
+/*
+ * Keep the town level just built from vault "vault" (centred on "vy",
+ * "vx") with "seed" in "*tp"
+ *
+ * A vault with random features (altars or traps) is never kept, since
+ * the copy would fix them.  Generators are kept anyway, and are fine,
+ * since "create_generator()" does nothing for a grid it already knows.
+ */
+static void town_layout_save(town_layout **tp, s16b vault, u32b seed,
+			     int vy, int vx)
+{
+  vault_type *v_ptr = &v_info[vault];
+  vault_raster *r_ptr = vault_get_raster(v_ptr);
+  town_layout *t_ptr;
+  int i, y, x;
+
+  for (i = 0; i < v_ptr->hgt * v_ptr->wid; i++) {
+    if (!(r_ptr->info[i] & VAULT_GRID_SPECIAL)) continue;
+    if (r_ptr->glyph[i] != 'G') return;
+  }
+
+  if (!*tp) MAKE(*tp, town_layout);
+
+  t_ptr = *tp;
+
+  t_ptr->seed = seed;
+  t_ptr->town = vault;
+  t_ptr->vy = vy;
+  t_ptr->vx = vx;
+
+  for (y = 0; y < cave_hgt; y++) {
+    C_COPY(t_ptr->feat[y], cave_feat[y], cave_wid, byte);
+
+    for (x = 0; x < cave_wid; x++) {
+      t_ptr->info[y][x] = cave_info[y][x] & (CAVE_ROOM | CAVE_ICKY);
+    }
+  }
+}
+
+
+/*
+ * The town as it was first built
+ *
+ * Coming back to the town (on foot, by recall or by the stairs) copies
+ * its features back, instead of mapping the heights, rolling the stairs
+ * and building the town vault again.  Only the light and the residents
+ * are made afresh.
+ */
+static town_layout *town_cache = NULL;
+
+/*
+ * Restore the layout of the town, if cached, lit for "daytime"
+ */
+static bool town_cache_load(bool daytime)
+{
+  int y, x;
+
+  if (!town_layout_load(town_cache, p_ptr->which_town, seed_wild))
+    return (FALSE);
+
+  /* All grids are lit (but not the border, as in "terrain_gen()") */
+  if (daytime) {
+    for (y = 1; y < DUNGEON_HGT - 1; y++) {
+      for (x = 1; x < DUNGEON_WID - 1; x++) {
+	cave_info[y][x] |= (CAVE_GLOW);
+
+	if (wiz_lite_town) {
+	  cave_info[y][x] |= (CAVE_MARK);
+	}
+      }
+    }
+  }
+
+  return (TRUE);
+}
+
+
 static void terrain_gen(void) {
 
   int i, k;
   int x, y;
   int depth;
   int table_type = 0;
-  int table_size;
-  int roughness;
-  int level_bg;
   int scroll = 0;
+  bool town, cached;
   bool quick_prev = Rand_quick;
   u32b value_prev = Rand_value;
 
@@ -4338,17 +4946,18 @@ static void terrain_gen(void) {
     }
   }
 
+  /* The town tile, at depth zero (see "Pick a new depth" below) */
+  town = (p_ptr->wild_x == 0 && p_ptr->wild_y == 0 &&
+	  (scroll || p_ptr->wilderness_depth == 0));
+
+  /* The town looks as it did last time */
+  cached = (town && town_cache_load(daytime));
 
 
-  /* Initialize the four corners.
-   * The corners are generated as permanent separately from the 
-   * contents. This means that the wilderness is fairly "tileable".
-   *
-   * Again, the contents of the code below were taken arbitrarily,
-   * I've no clear idea how predictable such a hashing function would be.
-   */
 
-  /* Set some generation parameters. */
+  /* The heights, with the four corners generated as permanent
+   * separately from the contents (see "wild_tile_build()").
+   */
 
   /* Table of terrain types, one for each depth. */
   /*
@@ -4357,110 +4966,83 @@ static void terrain_gen(void) {
    * }
    */
 
-  table_size = 22;
-  level_bg = 11;
-
-  /* The roughness of the level. */
-  roughness = 1;
-
-  Rand_quick = TRUE;
-
-#define HASH_CORNERS(X, Y) (((X) - (Y)) ^ (((X) + seed_wild) & (Y)))
-#define HASH_LEVEL(X, Y)   (((Y) - (X)) ^ ((Y) & ((X) + seed_wild)))
-  
-  Rand_value = HASH_CORNERS(p_ptr->wild_x, p_ptr->wild_y);
-  cave_feat[1][1] = rand_int(table_size);
-
-  Rand_value = HASH_CORNERS(p_ptr->wild_x, p_ptr->wild_y + 1);
-  cave_feat[DUNGEON_HGT - 2][1] = rand_int(table_size);
-
-  Rand_value = HASH_CORNERS(p_ptr->wild_x + 1, p_ptr->wild_y);
-  cave_feat[1][DUNGEON_WID - 2] = rand_int(table_size);
-
-  Rand_value = HASH_CORNERS(p_ptr->wild_x + 1, p_ptr->wild_y + 1);
-  cave_feat[DUNGEON_HGT - 2][DUNGEON_WID - 2] = rand_int(table_size);
-
-
-  /* Terrain levels are always ``permanent''. 
-   * Note the random bit shuffling to make a unique seed.
-   * There's no real rationale behind this. Anyone know a good hashing
-   * function for pairs of numbers? */
   Rand_quick = TRUE;
-  Rand_value = HASH_LEVEL(p_ptr->wild_x, p_ptr->wild_y);
 
-	/* Clear the rest of the level and sector map. */
-	for (y = 0; y < DUNGEON_HGT; y++) {
-		for (x = 0; x < DUNGEON_WID; x++) {
-			cave_sector[y][x] = SECTOR_RUINS;
-			if (y >= 2 && y < DUNGEON_HGT - 2 && x >= 2 && x < DUNGEON_WID - 2) {
+  if (!cached) {
+    wild_tile *w_ptr = wild_cache_get(p_ptr->wild_x, p_ptr->wild_y);
 
-      /* Create level background */
-      cave_feat[y][x] = level_bg;
-			}
+    /* Terrain levels are always ``permanent''. */
+    for (y = 1; y < DUNGEON_HGT - 1; y++) {
+      C_COPY(&cave_feat[y][1], &w_ptr->height[y][1], DUNGEON_WID - 2, byte);
     }
   }
 
-  /* x1, y1, x2, y2, num_depths, roughness */
+  /* Clear the sector map. */
+  for (y = 0; y < DUNGEON_HGT; y++) {
+    for (x = 0; x < DUNGEON_WID; x++) {
+      cave_sector[y][x] = SECTOR_RUINS;
+    }
+  }
 
-  plasma_recursive(1, 1, DUNGEON_WID - 2, DUNGEON_HGT - 2,
-		   table_size - 1, roughness);
 
 
+  if (!cached) {
 
-  /* Light all the grids.
-   * HACK -- Assume that the starting town is known to the player
-   * if "wiz_lite_town" is set.
-   */
+    /* Light all the grids.
+     * HACK -- Assume that the starting town is known to the player
+     * if "wiz_lite_town" is set.
+     */
 
-  for (y = 1; y < DUNGEON_HGT - 1; y++) {
-    for (x = 1; x < DUNGEON_WID - 1; x++) {
+    for (y = 1; y < DUNGEON_HGT - 1; y++) {
+      for (x = 1; x < DUNGEON_WID - 1; x++) {
 
-      cave_feat[y][x] = terrain_table[table_type][cave_feat[y][x]];
+        cave_feat[y][x] = terrain_table[table_type][cave_feat[y][x]];
 
-      /* All grids are lit. */
-      if (daytime) {
-	cave_info[y][x] |= (CAVE_GLOW);
+        /* All grids are lit. */
+        if (daytime) {
+	  cave_info[y][x] |= (CAVE_GLOW);
 
-	if (wiz_lite_town && p_ptr->wild_x == 0 && p_ptr->wild_y == 0) {
-	  cave_info[y][x] |= (CAVE_MARK);
-	}
-      }
+	  if (wiz_lite_town && p_ptr->wild_x == 0 && p_ptr->wild_y == 0) {
+	    cave_info[y][x] |= (CAVE_MARK);
+	  }
+        }
 
-      /* Nasty hack to allow pseudo-rooms */
-      if (cave_floor_bold(y, x)) {
-	cave_info[y][x] |= (CAVE_ROOM);
+        /* Nasty hack to allow pseudo-rooms */
+        if (cave_floor_bold(y, x)) {
+	  cave_info[y][x] |= (CAVE_ROOM);
+        }
       }
     }
-  }
 
 
-  /* Special boundary walls -- Top */
-  for (x = 0; x < DUNGEON_WID; x++) {
-    y = 0;
-    cave_feat[y][x] = FEAT_UNSEEN;
-  }
+    /* Special boundary walls -- Top */
+    for (x = 0; x < DUNGEON_WID; x++) {
+      y = 0;
+      cave_feat[y][x] = FEAT_UNSEEN;
+    }
 
-  /* Special boundary walls -- Bottom */
-  for (x = 0; x < DUNGEON_WID; x++) {
-    y = DUNGEON_HGT - 1;
-    cave_feat[y][x] = FEAT_UNSEEN;
-  }
+    /* Special boundary walls -- Bottom */
+    for (x = 0; x < DUNGEON_WID; x++) {
+      y = DUNGEON_HGT - 1;
+      cave_feat[y][x] = FEAT_UNSEEN;
+    }
 
-  /* Special boundary walls -- Left */
-  for (y = 0; y < DUNGEON_HGT; y++) {
-    x = 0;
-    cave_feat[y][x] = FEAT_UNSEEN;
-  }
+    /* Special boundary walls -- Left */
+    for (y = 0; y < DUNGEON_HGT; y++) {
+      x = 0;
+      cave_feat[y][x] = FEAT_UNSEEN;
+    }
 
-  /* Special boundary walls -- Right */
-  for (y = 0; y < DUNGEON_HGT; y++) {
-    x = DUNGEON_WID - 1;
-    cave_feat[y][x] = FEAT_UNSEEN;
-  }
+    /* Special boundary walls -- Right */
+    for (y = 0; y < DUNGEON_HGT; y++) {
+      x = DUNGEON_WID - 1;
+      cave_feat[y][x] = FEAT_UNSEEN;
+    }
 
-  /* Place a stairway down, sometimes. */
-  if (rand_int(100) < DUN_WILD_STAIRS) {
-    alloc_stairs(FEAT_SHAFT, 1, 0, FALSE);
+    /* Place a stairway down, sometimes. */
+    if (rand_int(100) < DUN_WILD_STAIRS) {
+      alloc_stairs(FEAT_SHAFT, 1, 0, FALSE);
+    }
   }
 
 
@@ -4526,6 +5108,16 @@ static void terrain_gen(void) {
       /* Boost the rating */
       rating += v_ptr->rat;
 
+      /* The town vault is still in place, only its residents are new */
+      if (cached) {
+	Rand_quick = FALSE;
+
+	build_vault_residents(town_cache->vy, town_cache->vx, v_ptr);
+
+	number--;
+	continue;
+      }
+
       vy = rand_range((v_ptr->hgt / 2) + 1,
 		      DUNGEON_HGT - (v_ptr->hgt / 2) - 1);
       vx = rand_range((v_ptr->wid / 2) + 1,
@@ -4536,6 +5128,9 @@ static void terrain_gen(void) {
 
       build_vault(vy, vx, v_ptr);
 
+      /* Keep the town as it is now, before anyone moves in */
+      if (town) town_layout_save(&town_cache, vindex, seed_wild, vy, vx);
+
       number--;
     }
   }
@@ -4606,18 +5201,14 @@ static void terrain_gen(void) {
   /* Put some monsters in the dungeon */
   /* But not in the town! */
   if (p_ptr->depth > 0 || p_ptr->wild_x != 0 || p_ptr->wild_y != 0) {
-    for (i = i + k; i > 0; i--) {
-      alloc_monster(0, 0);
-    }
+    alloc_monsters(0, i + k);
 
     /* Put some water dwellers.
      * Yes, that's right -- this code assumes that all aquatic
      * monsters are nocturnal. */
     i = MIN_M_ALLOC_WILD_NIGHT + randint(4);
 
-    for (i = i + k; i > 0; i--) {
-      alloc_monster(0, MON_ALLOC_AQUATIC);
-    }
+    alloc_monsters(MON_ALLOC_AQUATIC, i + k);
   }
 
   /* Put some objects in rooms */
@@ -4773,75 +5364,57 @@ static void place_traps_near_chests(int chance)
 static void ensure_elevation_access(int y1, int x1, int y2, int x2)
 {
     int y, x, dy, dx;
-    int visited[24][24];
-    for (y = 0; y < 24; y++) {
-        for (x = 0; x < 24; x++) {
-            visited[y][x] = 0;
-        }
-    }
+    byte seen[CONNECT_MAX_GRIDS];
+
+    /* Label every hill and pit of the sector at once */
+    if (!connect_label(y1, x1, y2, x2, CONNECT_ELEV)) return;
+
+    (void)C_WIPE(seen, CONNECT_MAX_GRIDS, byte);
 
     for (y = y1; y <= y2; y++) {
         for (x = x1; x <= x2; x++) {
-            int target_elev;
+            int target_elev, region;
             if (!in_bounds(y, x)) continue;
 
+            region = connect_region(y, x);
+            if (region < 0 || seen[region]) continue;
+
             target_elev = get_elevation(y, x);
-            if ((target_elev == ELEV_HIGH || target_elev == ELEV_LOW) && !visited[y - y1][x - x1]) {
+            {
                 int edge_feat = (target_elev == ELEV_HIGH) ? FEAT_CLIFF_UP : FEAT_CLIFF_DOWN;
 
                 /* New connected component found. We will collect all edge tiles for this component. */
                 int edge_y[576];
                 int edge_x[576];
                 int edge_count = 0;
-
-                int q_y[576];
-                int q_x[576];
-                int head = 0, tail = 0;
-                int comp_size = 0;
-
-                q_y[tail] = y;
-                q_x[tail] = x;
-                tail++;
-                visited[y - y1][x - x1] = 1;
-
-                while (head < tail) {
-                    int cy = q_y[head];
-                    int cx = q_x[head];
-                    head++;
-                    comp_size++;
-
-                    /* Check if this tile is an edge tile: has edge_feat and adjacent to ELEV_GROUND */
-                    if (cave_feat[cy][cx] == edge_feat) {
-                        bool adjacent_to_ground = FALSE;
-                        for (dy = -1; dy <= 1; dy++) {
-                            for (dx = -1; dx <= 1; dx++) {
-                                int ny = cy + dy, nx = cx + dx;
-                                if (in_bounds(ny, nx) && get_elevation(ny, nx) == ELEV_GROUND) {
-                                    adjacent_to_ground = TRUE;
-                                    break;
+                int comp_size = connect_region_size(y, x);
+                int ey, ex;
+
+                seen[region] = 1;
+
+                for (ey = y; ey <= y2; ey++) {
+                    for (ex = x1; ex <= x2; ex++) {
+                        int cy = ey, cx = ex;
+
+                        if (connect_region(cy, cx) != region) continue;
+
+                        /* Check if this tile is an edge tile: has edge_feat and adjacent to ELEV_GROUND */
+                        if (cave_feat[cy][cx] == edge_feat) {
+                            bool adjacent_to_ground = FALSE;
+                            for (dy = -1; dy <= 1; dy++) {
+                                for (dx = -1; dx <= 1; dx++) {
+                                    int ny = cy + dy, nx = cx + dx;
+                                    if (in_bounds(ny, nx) && get_elevation(ny, nx) == ELEV_GROUND) {
+                                        adjacent_to_ground = TRUE;
+                                        break;
+                                    }
                                 }
+                                if (adjacent_to_ground) break;
                             }
-                            if (adjacent_to_ground) break;
-                        }
-                        if (adjacent_to_ground) {
-                            edge_y[edge_count] = cy;
-                            edge_x[edge_count] = cx;
-                            edge_count++;
-                        }
-                    }
-
-                    /* Expand to neighbors (8-way connected) */
-                    for (dy = -1; dy <= 1; dy++) {
-                        for (dx = -1; dx <= 1; dx++) {
-                            if (dy == 0 && dx == 0) continue;
-                            int ny = cy + dy, nx = cx + dx;
-                            if (in_bounds(ny, nx) && ny >= y1 && ny <= y2 && nx >= x1 && nx <= x2) {
-                                if (get_elevation(ny, nx) == target_elev && !visited[ny - y1][nx - x1]) {
-                                    visited[ny - y1][nx - x1] = 1;
-                                    q_y[tail] = ny;
-                                    q_x[tail] = nx;
-                                    tail++;
-                                }
+                            if (adjacent_to_ground && edge_count < 576) {
+                                edge_y[edge_count] = cy;
+                                edge_x[edge_count] = cx;
+                                edge_count++;
                             }
                         }
                     }
@@ -5185,7 +5758,7 @@ static void build_sector_cavern(int y0, int x0)
 	cave_feat[y2][x2] = rand_int(100);
 
 	/* Generate Plasma */
-	plasma_recursive(x1, y1, x2, y2, 100, 1);
+	plasma_fractal(cave_feat, x1, y1, x2, y2, 100, 1);
 
 	/* Threshold */
 	for (y = y1; y <= y2; y++)
@@ -5233,96 +5806,29 @@ static void build_sector_cavern(int y0, int x0)
 
 static void ensure_connectivity(int y1, int x1, int y2, int x2)
 {
-	int h = y2 - y1 + 1;
-	int w = x2 - x1 + 1;
-	int comp[33][33];
-	int y, x;
-	int comp_count = 0;
-	int qy[1100], qx[1100];
-	int qh, qt;
 	int loop_safe = 0;
 
+	/* Label the floor regions once */
+	if (connect_label(y1, x1, y2, x2, CONNECT_FLOOR) <= 1) return;
+
 	/* Loop until fully connected */
 	while (loop_safe++ < 30)
 	{
-		/* Reset comp map */
-		for (y = 0; y < h; y++)
-			for (x = 0; x < w; x++)
-				comp[y][x] = 0;
-
-		comp_count = 0;
-
-		/* Find components */
-		for (y = 0; y < h; y++) {
-			for (x = 0; x < w; x++) {
-				int gy = y1 + y;
-				int gx = x1 + x;
-
-				if (cave_floor_bold(gy, gx) && comp[y][x] == 0) {
-					comp_count++;
-					qh = qt = 0;
-					qy[qt] = y; qx[qt] = x; qt++;
-					comp[y][x] = comp_count;
-
-					while (qh != qt) {
-						int cy = qy[qh]; int cx = qx[qh]; qh++;
-						int d;
-						for (d = 0; d < 4; d++) {
-							int ny = cy + ddy_ddd[d];
-							int nx = cx + ddx_ddd[d];
-							if (ny >= 0 && ny < h && nx >= 0 && nx < w) {
-								if (cave_floor_bold(y1+ny, x1+nx) && comp[ny][nx] == 0) {
-									comp[ny][nx] = comp_count;
-									if (qt < 1099) {
-										qy[qt] = ny; qx[qt] = nx; qt++;
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
+		int py1, px1, py2, px2;
+		int cy, cx;
 
-		if (comp_count <= 1) break;
+		/* Find the shortest bridge from the first region to another */
+		if (!connect_bridge(&py1, &px1, &py2, &px2)) break;
 
-		/* Connect Component 1 to nearest other component */
-		{
-			int min_dist = 9999;
-			int py1 = -1, px1 = -1, py2 = -1, px2 = -1;
-			int yy, xx;
-
-			for (y = 0; y < h; y++) {
-				for (x = 0; x < w; x++) {
-					if (comp[y][x] == 1) {
-						for (yy = 0; yy < h; yy++) {
-							for (xx = 0; xx < w; xx++) {
-								if (comp[yy][xx] > 1) {
-									int dist = (y-yy)*(y-yy) + (x-xx)*(x-xx);
-									if (dist < min_dist) {
-										min_dist = dist;
-										py1 = y; px1 = x;
-										py2 = yy; px2 = xx;
-									}
-								}
-							}
-						}
-					}
-				}
-			}
+		/* Build Bridge */
+		cy = py1, cx = px1;
+		while (cy != py2 || cx != px2) {
+			if (cy < py2) cy++; else if (cy > py2) cy--;
+			if (cx < px2) cx++; else if (cx > px2) cx--;
+			cave_feat[cy][cx] = FEAT_FLOOR;
 
-			if (py1 != -1) {
-				/* Build Bridge */
-				int cy = py1, cx = px1;
-				while (cy != py2 || cx != px2) {
-					if (cy < py2) cy++; else if (cy > py2) cy--;
-					if (cx < px2) cx++; else if (cx > px2) cx--;
-					cave_feat[y1+cy][x1+cx] = FEAT_FLOOR;
-				}
-			} else {
-				/* Failed to find connection? Should not happen. */
-				break;
-			}
+			/* Merge the new floor into its neighbours */
+			connect_add(cy, cx);
 		}
 	}
 }
@@ -5482,19 +5988,18 @@ static void build_sector_shifting_maze(int y0, int x0)
         int ty = rand_range(y1 + 3, y2 - 3);
         int tx = rand_range(x1 + 3, x2 - 3);
         universal_stamp(ty, tx, wall_stamp);
-
-        /* NEW: Mark the sector's stamped walls as active */
-        for (y = y1; y <= y2; y++) {
-            for (x = x1; x <= x2; x++) {
-                if (cave_feat[y][x] == FEAT_WALL_EXTRA) {
-                    cave_info[y][x] |= CAVE_ACTIVE;
-                }
-            }
-        }
     }
 
     ensure_connectivity(y1, x1, y2, x2);
 
+    /* Register the walls which survived as shifting walls */
+    for (y = y1; y <= y2; y++) {
+        for (x = x1; x <= x2; x++) {
+            if (!in_bounds(y, x)) continue;
+            if (cave_feat[y][x] == FEAT_WALL_EXTRA) active_wall_add(y, x);
+        }
+    }
+
     /* Place the High-Value Object at the center */
     if (cave_floor_bold(cy, cx)) {
         object_level += 15; /* Significant boost for this rare sector */
@@ -5574,6 +6079,9 @@ static void build_sector_dark(int y0, int x0)
         }
     }
 
+    /* Register the sector for the visibility and rearrangement passes */
+    dark_sector_add(y1, x1, y2, x2);
+
     /* 2. Carve Maze using recursive backtracker */
     /* Starting point: y1+1, x1+1 */
     cave_feat[y1+1][x1+1] = FEAT_FLOOR;
@@ -5805,45 +6313,48 @@ void populate_cover_features(void)
 static void scatter_ambient_detail(void)
 {
     int y, x, i;
+    int density;
+
+    /* Target empty floor tiles.
+     * FIX: We removed the check for !(cave_info[y][x] & CAVE_ROOM)
+     * so that fractal hills and cavern floors get detailed too.
+     */
+    density = alloc_cand_build(0, 0, DUNGEON_HGT - 1, DUNGEON_WID - 1,
+                               ALLOC_SET_FLOOR, FALSE);
+
     /* Increase density for a more lived-in feel */
-    int density = (DUNGEON_HGT * DUNGEON_WID) / 200;
+    density /= 200;
 
     for (i = 0; i < density; i++)
     {
-        y = rand_int(DUNGEON_HGT);
-        x = rand_int(DUNGEON_WID);
-
-        /* Target empty floor tiles.
-         * FIX: We removed the check for !(cave_info[y][x] & CAVE_ROOM)
-         * so that fractal hills and cavern floors get detailed too.
-         */
-        if (cave_naked_bold(y, x) && cave_feat[y][x] == FEAT_FLOOR)
-        {
-            int roll = rand_int(100);
+        int roll;
 
-            if (roll < 3) {
-                /* An old, abandoned campsite */
-                cave_feat[y][x] = FEAT_RUBBLE;
-                /* Campfires/Embers glow in the dark! */
-                cave_info[y][x] |= (CAVE_GLOW | CAVE_MARK);
-            }
-            else if (roll < 10) {
-                /* Patches of moss or grass */
-                cave_feat[y][x] = FEAT_GRASS;
-            }
-            else if (roll < 13) {
-                /* A lone, mysterious pillar */
-                cave_feat[y][x] = FEAT_STONE_PILLAR;
-            }
-            else if (roll < 16) {
-                /* Natural glowing crystals - helps break up the "black void" */
-                cave_feat[y][x] = FEAT_GLOWING_TILE;
-                cave_info[y][x] |= (CAVE_GLOW | CAVE_MARK);
-            }
-            else if (roll < 20) {
-                /* A puddle of water */
-                cave_feat[y][x] = FEAT_SHAL_WATER;
-            }
+        if (!alloc_cand_pick(&y, &x)) break;
+
+        roll = rand_int(100);
+
+        if (roll < 3) {
+            /* An old, abandoned campsite */
+            cave_feat[y][x] = FEAT_RUBBLE;
+            /* Campfires/Embers glow in the dark! */
+            cave_info[y][x] |= (CAVE_GLOW | CAVE_MARK);
+        }
+        else if (roll < 10) {
+            /* Patches of moss or grass */
+            cave_feat[y][x] = FEAT_GRASS;
+        }
+        else if (roll < 13) {
+            /* A lone, mysterious pillar */
+            cave_feat[y][x] = FEAT_STONE_PILLAR;
+        }
+        else if (roll < 16) {
+            /* Natural glowing crystals - helps break up the "black void" */
+            cave_feat[y][x] = FEAT_GLOWING_TILE;
+            cave_info[y][x] |= (CAVE_GLOW | CAVE_MARK);
+        }
+        else if (roll < 20) {
+            /* A puddle of water */
+            cave_feat[y][x] = FEAT_SHAL_WATER;
         }
     }
 }
@@ -6012,12 +6523,84 @@ static void jitter_sector_boundaries(void)
  * Analyzes wall/floor neighbors and toggles them if they are overwhelmingly
  * one or the other. Softens the "boxiness" of cavern sectors.
  */
+/*
+ * Packed grid bitsets for "smooth_caverns()", one bit per grid.
+ */
+#define CAVE_BITS_WORDS	((DUNGEON_WID + 31) / 32)
+
+typedef u32b cave_bits[DUNGEON_HGT][CAVE_BITS_WORDS];
+
+#define CAVE_BIT_ON(B, Y, X) \
+	((B)[Y][(X) >> 5] & (1UL << ((X) & 31)))
+
+#define CAVE_BIT_SET(B, Y, X) \
+	((B)[Y][(X) >> 5] |= (1UL << ((X) & 31)))
+
+
+/*
+ * Add one bit-plane to a bit-sliced counter (s[0] is the lowest bit)
+ */
+#define CAVE_BITS_ADD(S, A) \
+	do { \
+		u32b c0_ = (S)[0] & (A); \
+		u32b c1_; \
+		(S)[0] ^= (A); \
+		c1_ = (S)[1] & c0_; \
+		(S)[1] ^= c0_; \
+		c0_ = (S)[2] & c1_; \
+		(S)[2] ^= c1_; \
+		(S)[3] |= c0_; \
+	} while (0)
+
+
+/*
+ * Find the grids of row "y" with at least five of their eight
+ * neighbours set in "src", 32 grids at a time.
+ */
+static void cave_bits_five(cave_bits src, int y, u32b *out)
+{
+	int i, r;
+
+	for (i = 0; i < CAVE_BITS_WORDS; i++)
+	{
+		u32b s[4] = { 0, 0, 0, 0 };
+
+		for (r = y - 1; r <= y + 1; r++)
+		{
+			u32b w = src[r][i];
+			u32b prev = (i > 0) ? src[r][i - 1] : 0;
+			u32b next = (i < CAVE_BITS_WORDS - 1) ? src[r][i + 1] : 0;
+
+			/* Western neighbours */
+			CAVE_BITS_ADD(s, (w << 1) | (prev >> 31));
+
+			/* Eastern neighbours */
+			CAVE_BITS_ADD(s, (w >> 1) | (next << 31));
+
+			/* Northern and southern neighbours */
+			if (r != y) CAVE_BITS_ADD(s, w);
+		}
+
+		/* Five or more */
+		out[i] = s[3] | (s[2] & (s[1] | s[0]));
+	}
+}
+
+
+/*
+ * Smooth the caverns with a cellular automaton.
+ *
+ * A (non-permanent) wall with five or more floor neighbours becomes
+ * floor, and a floor with five or more wall neighbours becomes wall.
+ * Only plain floors and granite walls ever change, so the automaton runs
+ * on packed bitsets and "cave_feat" is only written once at the end.
+ */
 static void smooth_caverns(void)
 {
-	int i, y, x;
-	int dir;
+	int i, y, x, k;
 	bool has_cavern = FALSE;
-	byte temp_feat[DUNGEON_HGT][DUNGEON_WID];
+
+	static cave_bits cavern, floor, soft, wall, to_floor, to_wall;
 
 	/* Early exit if no SECTOR_CAVERN exists */
 	for (y = 1; y < DUNGEON_HGT - 1; y++) {
@@ -6031,60 +6614,90 @@ static void smooth_caverns(void)
 	}
 	if (!has_cavern) return;
 
-	/* Run for 2 iterations */
-	for (i = 0; i < 2; i++)
+	/* Encode the interior of the map */
+	(void)C_WIPE(cavern, 1, cave_bits);
+	(void)C_WIPE(floor, 1, cave_bits);
+	(void)C_WIPE(soft, 1, cave_bits);
+	(void)C_WIPE(wall, 1, cave_bits);
+	(void)C_WIPE(to_floor, 1, cave_bits);
+	(void)C_WIPE(to_wall, 1, cave_bits);
+
+	for (y = 1; y < DUNGEON_HGT - 1; y++)
+	{
+		for (x = 1; x < DUNGEON_WID - 1; x++)
+		{
+			int feat = cave_feat[y][x];
+
+			if (cave_sector[y][x] == SECTOR_CAVERN) CAVE_BIT_SET(cavern, y, x);
+
+			if (feat == FEAT_FLOOR) CAVE_BIT_SET(floor, y, x);
+
+			/* Granite may turn into floor */
+			if (feat >= FEAT_WALL_EXTRA && feat <= FEAT_WALL_SOLID)
+				CAVE_BIT_SET(soft, y, x);
+
+			/* Permanent walls count as walls too */
+			if (feat >= FEAT_WALL_EXTRA && feat <= FEAT_PERM_SOLID)
+				CAVE_BIT_SET(wall, y, x);
+		}
+	}
+
+	/* Run the automaton */
+	for (i = 0; i < CAVERN_SMOOTH_ITERS; i++)
 	{
-		/* Copy current state to temp array to allow simultaneous updates */
+		static cave_bits next_floor, next_wall;
+
 		for (y = 1; y < DUNGEON_HGT - 1; y++)
 		{
-			for (x = 1; x < DUNGEON_WID - 1; x++)
+			u32b many_floor[CAVE_BITS_WORDS];
+			u32b many_wall[CAVE_BITS_WORDS];
+
+			cave_bits_five(floor, y, many_floor);
+			cave_bits_five(wall, y, many_wall);
+
+			for (k = 0; k < CAVE_BITS_WORDS; k++)
 			{
-				temp_feat[y][x] = cave_feat[y][x];
+				u32b f = cavern[y][k] & soft[y][k] & many_floor[k];
+				u32b w = cavern[y][k] & floor[y][k] & many_wall[k];
+
+				/* Remember the last change of every grid */
+				to_floor[y][k] = (to_floor[y][k] & ~w) | f;
+				to_wall[y][k] = (to_wall[y][k] & ~f) | w;
+
+				/* Granite and floor swap places */
+				next_floor[y][k] = (floor[y][k] & ~w) | f;
+				next_wall[y][k] = (wall[y][k] & ~f) | w;
 			}
 		}
 
+		/* Update every grid at once */
 		for (y = 1; y < DUNGEON_HGT - 1; y++)
 		{
-			for (x = 1; x < DUNGEON_WID - 1; x++)
+			for (k = 0; k < CAVE_BITS_WORDS; k++)
 			{
-				/* Only apply to SECTOR_CAVERN to maintain other sector structures */
-				if (cave_sector[y][x] != SECTOR_CAVERN) continue;
-
-				/* Do not overwrite permanent features or stairs/doors */
-				if (cave_feat[y][x] >= FEAT_PERM_EXTRA || cave_feat[y][x] == FEAT_LESS || cave_feat[y][x] == FEAT_MORE || (cave_feat[y][x] >= FEAT_DOOR_HEAD && cave_feat[y][x] <= FEAT_DOOR_TAIL)) continue;
+				floor[y][k] = next_floor[y][k];
+				wall[y][k] = next_wall[y][k];
 
-				int floor_count = 0;
-				int wall_count = 0;
-
-				for (dir = 0; dir < 8; dir++)
-				{
-					int ny = y + ddy_ddd[dir];
-					int nx = x + ddx_ddd[dir];
-					if (ny > 0 && ny < DUNGEON_HGT - 1 && nx > 0 && nx < DUNGEON_WID - 1)
-					{
-						if (temp_feat[ny][nx] == FEAT_FLOOR)
-						{
-							floor_count++;
-						}
-						else if (temp_feat[ny][nx] >= FEAT_WALL_EXTRA && temp_feat[ny][nx] <= FEAT_PERM_SOLID)
-						{
-							wall_count++;
-						}
-					}
-				}
+				/* New walls are granite */
+				soft[y][k] = (soft[y][k] & ~to_floor[y][k]) | to_wall[y][k];
+			}
+		}
+	}
 
-				/* If wall has 5+ floor neighbors, turn to floor */
-				if (temp_feat[y][x] >= FEAT_WALL_EXTRA && temp_feat[y][x] <= FEAT_WALL_SOLID && floor_count >= 5)
-				{
-					cave_feat[y][x] = FEAT_FLOOR;
-					cave_info[y][x] |= CAVE_ROOM; /* Treat as room/open area */
-				}
-				/* If floor has 5+ wall neighbors, turn to wall */
-				else if (temp_feat[y][x] == FEAT_FLOOR && wall_count >= 5)
-				{
-					cave_feat[y][x] = FEAT_WALL_INNER;
-					cave_info[y][x] &= ~CAVE_ROOM;
-				}
+	/* Decode the changes */
+	for (y = 1; y < DUNGEON_HGT - 1; y++)
+	{
+		for (x = 1; x < DUNGEON_WID - 1; x++)
+		{
+			if (CAVE_BIT_ON(to_floor, y, x))
+			{
+				cave_feat[y][x] = FEAT_FLOOR;
+				cave_info[y][x] |= CAVE_ROOM; /* Treat as room/open area */
+			}
+			else if (CAVE_BIT_ON(to_wall, y, x))
+			{
+				cave_feat[y][x] = FEAT_WALL_INNER;
+				cave_info[y][x] &= ~CAVE_ROOM;
 			}
 		}
 	}
@@ -6110,7 +6723,8 @@ static void generate_special_terrain(int special_type)
                 }
             }
         }
-        byte *temp_feat = malloc(DUNGEON_HGT * DUNGEON_WID);
+        byte *temp_feat;
+        C_ARENA_MAKE(&gen_arena, temp_feat, DUNGEON_HGT * DUNGEON_WID, byte);
         for (iters = 0; iters < 4; iters++) {
             for (y = 1; y < DUNGEON_HGT - 1; y++) {
                 for (x = 1; x < DUNGEON_WID - 1; x++) {
@@ -6138,7 +6752,6 @@ static void generate_special_terrain(int special_type)
                 }
             }
         }
-        free(temp_feat);
         for (i = 0; i < 300; i++) {
             y = rand_range(1, DUNGEON_HGT - 2);
             x = rand_range(1, DUNGEON_WID - 2);
@@ -6319,6 +6932,13 @@ static void cave_gen(dun_data *dun_body)
 	/* Global data */
 	dun = dun_body;
 
+	/* Time each stage (see "metric_stage()") */
+	metric_stage("gen_init_us");
+
+	/* No rooms yet (the room table is filled before the sectors) */
+	dun->cent_n = 0;
+	dun->crowded = FALSE;
+
 	/* Allow open levels. */
 
 	if (allow_open_levels)
@@ -6413,6 +7033,8 @@ static void cave_gen(dun_data *dun_body)
 
 
     int special_level = 0;
+
+    metric_stage("gen_rooms_us");
     if (rand_int(100) < 10) special_level = rand_int(3) + 1;
     if (special_level > 0) {
         generate_special_terrain(special_level);
@@ -6584,6 +7206,8 @@ static void cave_gen(dun_data *dun_body)
 	}
 
 
+	metric_stage("gen_sectors_us");
+
 	/* Destroy the level if necessary */
 	if (destroyed)
 		destroy_level();
@@ -6727,6 +7351,8 @@ static void cave_gen(dun_data *dun_body)
 	/* Cellular Automata cave smoothing pass */
 	smooth_caverns();
 
+	metric_stage("gen_tunnels_us");
+
 	/* Hack -- Scramble the room order */
 	for (i = 0; i < dun->cent_n; i++)
 	{
@@ -6794,6 +7420,7 @@ static void cave_gen(dun_data *dun_body)
 
 
     } /* End of else block for special_level */
+    metric_stage("gen_streamers_us");
     if (special_level == 0) {
 	/* Hack -- Add some magma streamers */
 
@@ -6853,6 +7480,7 @@ static void cave_gen(dun_data *dun_body)
 	}
 
     } /* End if special_level == 0 for streamers */
+    metric_stage("gen_stairs_us");
     if (special_level == 0) {
 	/* Place 1 down stairs per sector (approx 420 total) */
 	alloc_stairs(FEAT_MORE, 420, 0, (level_bg == FEAT_FOG || level_bg == FEAT_CHAOS_FOG));
@@ -6920,58 +7548,29 @@ static void cave_gen(dun_data *dun_body)
 		k = 2;
 
 
+	metric_stage("gen_monsters_us");
+
 	/* Pick a base number of monsters */
 	i = (MIN_M_ALLOC_LEVEL + randint(8)) * 4;
 
 	if (!dun->crowded) i += 100;
 
-	/* Put some monsters in the dungeon */
-	for (i = i + k; i > 0; i--)
+	/* Hack -- flooded levels get fishy inhabitants. */
+	if (level_bg == FEAT_SHAL_WATER)
 	{
-		/* Hack -- flooded levels get fishy inhabitants. */
-		if (level_bg == FEAT_SHAL_WATER)
-		{
-			alloc_monster(0, MON_ALLOC_SLEEP | MON_ALLOC_AQUATIC);
-		}
-
-		alloc_monster(0, MON_ALLOC_SLEEP);
+		alloc_monsters(MON_ALLOC_SLEEP | MON_ALLOC_AQUATIC, i + k);
 	}
 
+	/* Put some monsters in the dungeon */
+	alloc_monsters(MON_ALLOC_SLEEP, i + k);
+
+	metric_stage("gen_objects_us");
+
 	/* Place some good items */
-	for (i = 0; i < 6; i++)
-	{
-		int y, x;
-		int d = 0;
-		while (d < 1000)
-		{
-			d++;
-			y = rand_int(DUNGEON_HGT);
-			x = rand_int(DUNGEON_WID);
-			if (cave_naked_bold(y, x))
-			{
-				place_object(y, x, TRUE, FALSE);
-				break;
-			}
-		}
-	}
+	alloc_object(ALLOC_SET_BOTH, ALLOC_TYP_GOOD, 6);
 
 	/* Place some small gold piles */
-	for (i = 0; i < 100; i++)
-	{
-		int y, x;
-		int d = 0;
-		while (d < 200)
-		{
-			d++;
-			y = rand_int(DUNGEON_HGT);
-			x = rand_int(DUNGEON_WID);
-			if (cave_naked_bold(y, x))
-			{
-				place_gold_small(y, x);
-				break;
-			}
-		}
-	}
+	alloc_object(ALLOC_SET_BOTH, ALLOC_TYP_GOLD, 100);
 
 	/* Place some traps in the dungeon */
 	{
@@ -7012,6 +7611,8 @@ static void cave_gen(dun_data *dun_body)
 	alloc_object(ALLOC_SET_BOTH, ALLOC_TYP_OBJECT, randnor(DUN_AMT_ITEM,
 			3));
 
+	metric_stage("gen_features_us");
+
 	/* Populate with new features */
 	populate_features();
     populate_cover_features();
@@ -7035,10 +7636,58 @@ static void cave_gen(dun_data *dun_body)
 		}
 	}
 
+	/* Done */
+	metric_stage(NULL);
+
 	dun = NULL;
 }
 
 
+/*
+ * Turn the part of the map used by the last level back into blank rock,
+ * and let the next level use all of it.
+ *
+ * The grids outside "cave_hgt" by "cave_wid" are always blank rock, so
+ * a small level (a shop or the arena) only costs its own size to clear,
+ * and every scan of the whole level may stop at its edges.
+ */
+static void blank_level(void)
+{
+	int y, x;
+
+	for (y = 0; y < cave_hgt; y++)
+	{
+		memset(cave_info[y], 0, cave_wid * sizeof(cave_info[y][0]));
+		memset(cave_o_idx[y], 0, cave_wid * sizeof(cave_o_idx[y][0]));
+		memset(cave_m_idx[y], 0, cave_wid * sizeof(cave_m_idx[y][0]));
+		memset(cave_feat[y], FEAT_PERM_SOLID, cave_wid);
+		memset(cave_light[y], 0, cave_wid);
+
+#ifdef MONSTER_FLOW
+		for (x = 0; x < cave_wid; x++)
+		{
+			cave_flow[y][x].cost = 0;
+			cave_flow[y][x].when = 0;
+		}
+#endif /* MONSTER_FLOW */
+	}
+
+	/* The generators use the whole map unless they say otherwise */
+	cave_hgt = DUNGEON_HGT;
+	cave_wid = DUNGEON_WID;
+}
+
+
+/*
+ * Use only the top left "hgt" by "wid" grids of the (blank) map.
+ */
+static void level_size(int hgt, int wid)
+{
+	cave_hgt = MIN(hgt, DUNGEON_HGT);
+	cave_wid = MIN(wid, DUNGEON_WID);
+}
+
+
 /*
  * Generate a shop.
  *
@@ -7064,17 +7713,11 @@ static void store_gen(void)
 		daytime = FALSE;
 	}
 
-	/* Start with rock */
-	for (y = 0; y < DUNGEON_HGT; y++)
-	{
-		for (x = 0; x < DUNGEON_WID; x++)
-		{
-			cave_feat[y][x] = FEAT_PERM_SOLID;
-		}
-	}
-
 	v_ptr = &v_info[st_ptr->vault];
 
+	/* The shop, and a border of (blank) rock */
+	level_size(v_ptr->hgt + 4, v_ptr->wid + 4);
+
 	y = (v_ptr->hgt / 2) + 2;
 	x = (v_ptr->wid / 2) + 2;
 
@@ -7130,8 +7773,17 @@ static void store_gen(void)
 
 
 
+/*
+ * The arena as it was first built (see "town_layout_save()")
+ */
+static town_layout *arena_cache = NULL;
+
+
 /*
  * Town logic flow for generation of arena -KMW-
+ *
+ * The arena is built once, and every fight after that copies it back
+ * and only places the fighters.
  */
 static void arena_gen(void)
 {
@@ -7150,17 +7802,26 @@ static void arena_gen(void)
 		daytime = FALSE;
 	}
 
-	/* Start with rock */
-	for (y = 0; y < DUNGEON_HGT; y++)
+	v_ptr = &v_info[p_ptr->which_arena_layout];
+
+	y = (v_ptr->hgt / 2) + 2;
+	x = (v_ptr->wid / 2) + 2;
+
+	/* The arena, and a border of (blank) rock */
+	level_size(v_ptr->hgt + 4, v_ptr->wid + 4);
+
+	/* The arena as it was last time, with new fighters */
+	if (town_layout_load(arena_cache, p_ptr->which_arena_layout, 0))
 	{
-		for (x = 0; x < DUNGEON_WID; x++)
-		{
-			cave_feat[y][x] = FEAT_PERM_SOLID;
-		}
+		build_vault_residents(y, x, v_ptr);
 	}
+	else
+	{
+		build_vault(y, x, v_ptr);
 
-	v_ptr = &v_info[p_ptr->which_arena_layout];
-	build_vault((v_ptr->hgt / 2) + 2, (v_ptr->wid / 2) + 2, v_ptr);
+		/* Keep it for the next fight */
+		town_layout_save(&arena_cache, p_ptr->which_arena_layout, 0, y, x);
+	}
 
 	/* Create the sun. */
 	lite_up_town(daytime);
@@ -7232,22 +7893,8 @@ static void quest_gen(void)
 
 	if (v_ptr->gen_info != 1)
 	{
-		for (y = 0; y < DUNGEON_HGT; y++)
-		{
-			for (x = 0; x < DUNGEON_WID; x++)
-			{
-
-				if (v_ptr->gen_info == 2)
-				{
-					cave_feat[y][x] = FEAT_FOG;
-				}
-				else
-				{
-					cave_feat[y][x] = FEAT_PERM_SOLID;
-				}
-			}
-		}
-
+		memset(cave_feat, (v_ptr->gen_info == 2) ? FEAT_FOG : FEAT_PERM_SOLID,
+		       sizeof(cave_feat));
 	}
 	else if (v_ptr->gen_info == 1)
 	{
@@ -7342,6 +7989,7 @@ void generate_cave(void)
 	int w, h;
 	const char *msg = "Generating level... please wait.";
 	dun_data *dun_body;
+	virt_mark scratch;
 
 	/* Clear the screen and alert the player */
 	Term_clear();
@@ -7363,8 +8011,9 @@ void generate_cave(void)
 		Rand_value = seed_dungeon + p_ptr->depth;
 	}
 
-	dun_body = malloc(sizeof(dun_data));
-	if (!dun_body) return;
+	/* Nothing is known about the level yet (special levels skip parts) */
+	scratch = virt_arena_mark(&gen_arena);
+	ARENA_MAKE(&gen_arena, dun_body, dun_data);
 
 	/* Generate */
 	for (num = 0; num < 5; num++)
@@ -7378,15 +8027,13 @@ void generate_cave(void)
 		/* XXX XXX XXX XXX */
 		o_max = 1;
 		m_max = 1;
+		m_free_n = 0;
 
 		/* Start with a blank cave */
-		memset(cave_info, 0, sizeof(cave_info));
-		memset(cave_o_idx, 0, sizeof(cave_o_idx));
-		memset(cave_m_idx, 0, sizeof(cave_m_idx));
-#ifdef MONSTER_FLOW
-		memset(cave_cost, 0, sizeof(cave_cost));
-		memset(cave_when, 0, sizeof(cave_when));
-#endif /* MONSTER_FLOW */
+		blank_level();
+		active_wall_n = 0;
+		dark_sector_n = 0;
+		stair_cand_ready = FALSE;
 
 
 		/* Hack -- illegal panel */
@@ -7640,6 +8287,9 @@ void generate_cave(void)
 
 	}
 
+	/* Build the per-level grid indexes */
+	rebuild_level_indexes();
+
 	/* The dungeon is ready */
 	character_dungeon = TRUE;
 
@@ -7680,9 +8330,8 @@ void generate_cave(void)
 	execute_staircase_pursuit();
 	execute_recall_ambush();
 
-	if (dun_body) {
-		free(dun_body);
-	}
+	/* Forget the scratch space */
+	virt_arena_release(&gen_arena, scratch);
 }
 
 /*
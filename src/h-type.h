@@ -96,6 +96,9 @@ typedef int errr;
 /* An unsigned byte of memory */
 typedef unsigned char byte;
 
+/* A signed byte of memory */
+typedef signed char s8b;
+
 /* Note that a bool is smaller than a full "int" */
 /* Simple True/False type */
 typedef char bool;
@@ -1407,40 +1407,116 @@ errr init_f_info_txt(FILE * fp, char *buf)
 
 
 /*
- * Grab one flag in an object_kind from a textual string
+ * Object flag tables, in the order they are searched
  */
-static errr grab_one_kind_flag(object_kind * k_ptr, cptr what)
+static cptr *k_info_flags[3] =
 {
-	int i;
+	k_info_flags1, k_info_flags2, k_info_flags3
+};
 
-	/* Check flags1 */
-	for (i = 0; i < 32; i++)
+/*
+ * Monster flag tables ("basic" and "spell" flags)
+ */
+static cptr *r_info_basic_flags[4] =
+{
+	r_info_flags1, r_info_flags2, r_info_flags3, r_info_flags7
+};
+
+static cptr *r_info_spell_flags[3] =
+{
+	r_info_flags4, r_info_flags5, r_info_flags6
+};
+
+/*
+ * Sorted indexes of the flag tables above (built when first needed)
+ */
+static flag_name k_info_flag_index[3 * 32];
+static flag_name r_info_basic_index[4 * 32];
+static flag_name r_info_spell_index[3 * 32];
+
+
+/*
+ * Build a sorted index of the names in "num" flag tables of 32 flags each.
+ *
+ * Equal names keep the order of the tables, so a search finds the same
+ * flag as scanning the tables one by one would.
+ */
+static void flag_index_build(flag_name *index, cptr **tables, int num)
+{
+	int i, j, n = 0;
+
+	for (i = 0; i < num; i++)
 	{
-		if (streq(what, k_info_flags1[i]))
+		for (j = 0; j < 32; j++)
 		{
-			k_ptr->flags1 |= (1L << i);
-			return (0);
+			flag_name entry;
+			int k;
+
+			entry.name = tables[i][j];
+			entry.set = i;
+			entry.bit = j;
+
+			/* Insertion sort (this is only done once) */
+			for (k = n; (k > 0) && (strcmp(index[k - 1].name, entry.name) > 0);
+				k--)
+			{
+				index[k] = index[k - 1];
+			}
+
+			index[k] = entry;
+			n++;
 		}
 	}
+}
 
-	/* Check flags2 */
-	for (i = 0; i < 32; i++)
+
+/*
+ * Find a flag name in an index of "num" flag tables, building the index
+ * if needed.  Returns NULL if there is no such flag.
+ */
+static flag_name *flag_index_find(flag_name *index, cptr **tables, int num,
+	cptr what)
+{
+	int lo = 0, hi = num * 32;
+
+	/* Build the index */
+	if (!index[0].name) flag_index_build(index, tables, num);
+
+	/* Find the first entry not before "what" */
+	while (lo < hi)
 	{
-		if (streq(what, k_info_flags2[i]))
-		{
-			k_ptr->flags2 |= (1L << i);
-			return (0);
-		}
+		int mid = (lo + hi) / 2;
+
+		if (strcmp(index[mid].name, what) < 0) lo = mid + 1;
+		else hi = mid;
 	}
 
-	/* Check flags3 */
-	for (i = 0; i < 32; i++)
+	/* Not found */
+	if ((lo == num * 32) || !streq(index[lo].name, what)) return (NULL);
+
+	return (&index[lo]);
+}
+
+
+/*
+ * Grab one flag in an object_kind from a textual string
+ */
+static errr grab_one_kind_flag(object_kind * k_ptr, cptr what)
+{
+	u32b *flags[3];
+	flag_name *f_ptr;
+
+	flags[0] = &k_ptr->flags1;
+	flags[1] = &k_ptr->flags2;
+	flags[2] = &k_ptr->flags3;
+
+	/* Check the flags */
+	f_ptr = flag_index_find(k_info_flag_index, k_info_flags, 3, what);
+
+	if (f_ptr)
 	{
-		if (streq(what, k_info_flags3[i]))
-		{
-			k_ptr->flags3 |= (1L << i);
-			return (0);
-		}
+		(*flags[f_ptr->set]) |= (1L << f_ptr->bit);
+		return (0);
 	}
 
 	/* Oops */
@@ -1811,36 +1887,20 @@ errr init_k_info_txt(FILE * fp, char *buf)
  */
 static errr grab_one_artifact_flag(artifact_type * a_ptr, cptr what)
 {
-	int i;
+	u32b *flags[3];
+	flag_name *f_ptr;
 
-	/* Check flags1 */
-	for (i = 0; i < 32; i++)
-	{
-		if (streq(what, k_info_flags1[i]))
-		{
-			a_ptr->flags1 |= (1L << i);
-			return (0);
-		}
-	}
+	flags[0] = &a_ptr->flags1;
+	flags[1] = &a_ptr->flags2;
+	flags[2] = &a_ptr->flags3;
 
-	/* Check flags2 */
-	for (i = 0; i < 32; i++)
-	{
-		if (streq(what, k_info_flags2[i]))
-		{
-			a_ptr->flags2 |= (1L << i);
-			return (0);
-		}
-	}
+	/* Check the flags */
+	f_ptr = flag_index_find(k_info_flag_index, k_info_flags, 3, what);
 
-	/* Check flags3 */
-	for (i = 0; i < 32; i++)
+	if (f_ptr)
 	{
-		if (streq(what, k_info_flags3[i]))
-		{
-			a_ptr->flags3 |= (1L << i);
-			return (0);
-		}
+		(*flags[f_ptr->set]) |= (1L << f_ptr->bit);
+		return (0);
 	}
 
 	/* Oops */
@@ -2130,45 +2190,29 @@ errr init_a_info_txt(FILE * fp, char *buf)
 static bool grab_one_ego_item_flag(ego_item_type * e_ptr, cptr what,
 	bool rand)
 {
-	int i;
+	u32b *flags[3];
+	flag_name *f_ptr;
 
-	/* Check flags1 */
-	for (i = 0; i < 32; i++)
+	if (rand)
 	{
-		if (streq(what, k_info_flags1[i]))
-		{
-			if (rand)
-				e_ptr->maybe_flags1 |= (1L << i);
-			else
-				e_ptr->flags1 |= (1L << i);
-			return (0);
-		}
+		flags[0] = &e_ptr->maybe_flags1;
+		flags[1] = &e_ptr->maybe_flags2;
+		flags[2] = &e_ptr->maybe_flags3;
 	}
-
-	/* Check flags2 */
-	for (i = 0; i < 32; i++)
+	else
 	{
-		if (streq(what, k_info_flags2[i]))
-		{
-			if (rand)
-				e_ptr->maybe_flags2 |= (1L << i);
-			else
-				e_ptr->flags2 |= (1L << i);
-			return (0);
-		}
+		flags[0] = &e_ptr->flags1;
+		flags[1] = &e_ptr->flags2;
+		flags[2] = &e_ptr->flags3;
 	}
 
-	/* Check flags3 */
-	for (i = 0; i < 32; i++)
+	/* Check the flags */
+	f_ptr = flag_index_find(k_info_flag_index, k_info_flags, 3, what);
+
+	if (f_ptr)
 	{
-		if (streq(what, k_info_flags3[i]))
-		{
-			if (rand)
-				e_ptr->maybe_flags3 |= (1L << i);
-			else
-				e_ptr->flags3 |= (1L << i);
-			return (0);
-		}
+		(*flags[f_ptr->set]) |= (1L << f_ptr->bit);
+		return (0);
 	}
 
 	/* Oops */
@@ -2456,47 +2500,21 @@ errr init_e_info_txt(FILE * fp, char *buf)
  */
 static errr grab_one_basic_flag(monster_race * r_ptr, cptr what)
 {
-	int i;
-
-	/* Scan flags1 */
-	for (i = 0; i < 32; i++)
-	{
-		if (streq(what, r_info_flags1[i]))
-		{
-			r_ptr->flags1 |= (1L << i);
-			return (0);
-		}
-	}
+	u32b *flags[4];
+	flag_name *f_ptr;
 
-	/* Scan flags2 */
-	for (i = 0; i < 32; i++)
-	{
-		if (streq(what, r_info_flags2[i]))
-		{
-			r_ptr->flags2 |= (1L << i);
-			return (0);
-		}
-	}
-
-	/* Scan flags1 */
-	for (i = 0; i < 32; i++)
-	{
-		if (streq(what, r_info_flags3[i]))
-		{
-			r_ptr->flags3 |= (1L << i);
-			return (0);
-		}
-	}
+	flags[0] = &r_ptr->flags1;
+	flags[1] = &r_ptr->flags2;
+	flags[2] = &r_ptr->flags3;
+	flags[3] = &r_ptr->flags7;
 
+	/* Check the flags */
+	f_ptr = flag_index_find(r_info_basic_index, r_info_basic_flags, 4, what);
 
-	/* Scan flags7 */
-	for (i = 0; i < 32; i++)
+	if (f_ptr)
 	{
-		if (streq(what, r_info_flags7[i]))
-		{
-			r_ptr->flags7 |= (1L << i);
-			return (0);
-		}
+		(*flags[f_ptr->set]) |= (1L << f_ptr->bit);
+		return (0);
 	}
 
 	/* Oops */
@@ -2512,36 +2530,20 @@ static errr grab_one_basic_flag(monster_race * r_ptr, cptr what)
  */
 static errr grab_one_spell_flag(monster_race * r_ptr, cptr what)
 {
-	int i;
+	u32b *flags[3];
+	flag_name *f_ptr;
 
-	/* Scan flags4 */
-	for (i = 0; i < 32; i++)
-	{
-		if (streq(what, r_info_flags4[i]))
-		{
-			r_ptr->flags4 |= (1L << i);
-			return (0);
-		}
-	}
+	flags[0] = &r_ptr->flags4;
+	flags[1] = &r_ptr->flags5;
+	flags[2] = &r_ptr->flags6;
 
-	/* Scan flags5 */
-	for (i = 0; i < 32; i++)
-	{
-		if (streq(what, r_info_flags5[i]))
-		{
-			r_ptr->flags5 |= (1L << i);
-			return (0);
-		}
-	}
+	/* Check the flags */
+	f_ptr = flag_index_find(r_info_spell_index, r_info_spell_flags, 3, what);
 
-	/* Scan flags6 */
-	for (i = 0; i < 32; i++)
+	if (f_ptr)
 	{
-		if (streq(what, r_info_flags6[i]))
-		{
-			r_ptr->flags6 |= (1L << i);
-			return (0);
-		}
+		(*flags[f_ptr->set]) |= (1L << f_ptr->bit);
+		return (0);
 	}
 
 	/* Oops */
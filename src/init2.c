@@ -10,6 +10,16 @@
 
 #include "angband.h"
 
+#ifdef MAP_RAW_FILES
+# include <sys/mman.h>
+#endif
+
+#ifdef FORK_TEMPLATES
+# include <sys/wait.h>
+#endif
+
+#include <sys/time.h>
+
 
 /*
  * This file is used to initialize various variables and arrays for the
@@ -231,6 +241,11 @@ s16b error_line;
 u16b fake_name_size;
 u32b fake_text_size;
 
+/*
+ * Only build the binary image file (see "init_raw_parallel()")
+ */
+static bool init_raw_only = FALSE;
+
 
 /*
  * Standard error message text
@@ -247,6 +262,49 @@ static cptr err_str[8] = {
 };
 
 
+/*
+ * Hash the contents of the template file "name" (FNV-1a), so that an
+ * image file built from another version of it is not used.
+ *
+ * The file times would not do: they change when the game is unpacked or
+ * updated (on Termux, say) even if the contents do not, and every launch
+ * would parse all the files again.
+ *
+ * Returns zero (check nothing) if the file cannot be read.
+ */
+static u32b init_txt_hash(cptr name)
+{
+	char buf[1024];
+	byte data[16384];
+
+	u32b hash = 2166136261UL;
+	int fd, n, i;
+
+	/* Build the filename */
+	path_build(buf, 1024, ANGBAND_DIR_EDIT, name);
+
+	/* No file, no hash */
+	fd = fd_open(buf, O_RDONLY);
+	if (fd < 0) return (0L);
+
+	/* Read it a piece at a time */
+	while ((n = read(fd, data, sizeof(data))) > 0)
+	{
+		for (i = 0; i < n; i++) hash = (hash ^ data[i]) * 16777619UL;
+	}
+
+	fd_close(fd);
+
+	/* A read error */
+	if (n < 0) return (0L);
+
+	/* Zero means "no hash" */
+	if (!hash) hash = 1L;
+
+	return (hash);
+}
+
+
 #endif
 
 
@@ -254,6 +312,44 @@ static cptr err_str[8] = {
 /*** Initialize from binary image files ***/
 
 
+#ifdef MAP_RAW_FILES
+
+/*
+ * Map the rest of a binary image file (after its header) into memory.
+ *
+ * The "info" array and the "name" and "text" arrays follow the header
+ * in that order, and only hold offsets, so they can be used in place.
+ * The mapping is private, so the game may change the arrays (lore,
+ * artifact counts, and so on) without touching the file.
+ *
+ * Returns NULL (so the caller reads the file the old way) if the file
+ * cannot be mapped or is too short.
+ */
+static char *init_raw_map(int fd, header *head)
+{
+	struct stat st;
+	huge size;
+	char *map;
+
+	size = head->head_size + head->info_size + head->name_size +
+		head->text_size + head->text2_size + head->text3_size;
+
+	/* A short file would fault when used */
+	if (fstat(fd, &st) || ((huge) st.st_size < size))
+		return (NULL);
+
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+	if (map == MAP_FAILED)
+		return (NULL);
+
+	return (map + head->head_size);
+}
+
+#endif /* MAP_RAW_FILES */
+
+
+
 /*
  * Initialize the "f_info" array, by parsing a binary "image" file
  */
@@ -261,6 +357,10 @@ static errr init_f_info_raw(int fd)
 {
 	header test;
 
+#ifdef MAP_RAW_FILES
+	char *map;
+#endif
+
 
 	/* Read and Verify the header */
 	if (fd_read(fd, (char *) (&test), sizeof(header)) ||
@@ -271,7 +371,8 @@ static errr init_f_info_raw(int fd)
 		(test.info_num != f_head->info_num) ||
 		(test.info_len != f_head->info_len) ||
 		(test.head_size != f_head->head_size) ||
-		(test.info_size != f_head->info_size))
+		(test.info_size != f_head->info_size) ||
+		(f_head->txt_hash && (test.txt_hash != f_head->txt_hash)))
 	{
 		/* Error */
 		return (-1);
@@ -281,6 +382,26 @@ static errr init_f_info_raw(int fd)
 	/* Accept the header */
 	(*f_head) = test;
 
+#ifdef MAP_RAW_FILES
+
+	/* Use the file in place */
+	if ((map = init_raw_map(fd, f_head)) != NULL)
+	{
+		f_info = (feature_type *) map;
+		map += f_head->info_size;
+
+		f_name = map;
+		map += f_head->name_size;
+
+		f_text = map;
+
+		/* Success */
+		return (0);
+	}
+
+#endif /* MAP_RAW_FILES */
+
+
 
 	/* Allocate the "f_info" array */
 	C_MAKE(f_info, f_head->info_num, feature_type);
@@ -355,6 +476,9 @@ static errr init_f_info(void)
 
 #ifdef ALLOW_TEMPLATES
 
+	/* Hash the template file */
+	f_head->txt_hash = init_txt_hash("f_info.txt");
+
 	/*** Load the binary image file ***/
 
 	/* Build the filename */
@@ -377,8 +501,11 @@ static errr init_f_info(void)
 			return (0);
 
 		/* Information */
-		msg_print("Ignoring obsolete/defective 'f_info.raw' file.");
-		msg_print(NULL);
+		if (!init_raw_only)
+		{
+			msg_print("Ignoring obsolete/defective 'f_info.raw' file.");
+			msg_print(NULL);
+		}
 	}
 
 
@@ -414,6 +541,10 @@ static errr init_f_info(void)
 	/* Close it */
 	my_fclose(fp);
 
+	/* Leave the errors to the main game */
+	if (err && init_raw_only)
+		return (err);
+
 	/* Errors */
 	if (err)
 	{
@@ -481,6 +612,10 @@ static errr init_f_info(void)
 	fake_name_size = 0;
 	fake_text_size = 0;
 
+	/* The image file is all that was wanted */
+	if (init_raw_only)
+		return (0);
+
 #endif /* ALLOW_TEMPLATES */
 
 
@@ -519,6 +654,10 @@ static errr init_k_info_raw(int fd)
 {
 	header test;
 
+#ifdef MAP_RAW_FILES
+	char *map;
+#endif
+
 
 	/* Read and Verify the header */
 	if (fd_read(fd, (char *) (&test), sizeof(header)) ||
@@ -529,7 +668,8 @@ static errr init_k_info_raw(int fd)
 		(test.info_num != k_head->info_num) ||
 		(test.info_len != k_head->info_len) ||
 		(test.head_size != k_head->head_size) ||
-		(test.info_size != k_head->info_size))
+		(test.info_size != k_head->info_size) ||
+		(k_head->txt_hash && (test.txt_hash != k_head->txt_hash)))
 	{
 		/* Error */
 		return (-1);
@@ -539,6 +679,26 @@ static errr init_k_info_raw(int fd)
 	/* Accept the header */
 	(*k_head) = test;
 
+#ifdef MAP_RAW_FILES
+
+	/* Use the file in place */
+	if ((map = init_raw_map(fd, k_head)) != NULL)
+	{
+		k_info = (object_kind *) map;
+		map += k_head->info_size;
+
+		k_name = map;
+		map += k_head->name_size;
+
+		k_text = map;
+
+		/* Success */
+		return (0);
+	}
+
+#endif /* MAP_RAW_FILES */
+
+
 
 	/* Allocate the "k_info" array */
 	C_MAKE(k_info, k_head->info_num, object_kind);
@@ -613,6 +773,9 @@ static errr init_k_info(void)
 
 #ifdef ALLOW_TEMPLATES
 
+	/* Hash the template file */
+	k_head->txt_hash = init_txt_hash("k_info.txt");
+
 	/*** Load the binary image file ***/
 
 	/* Build the filename */
@@ -635,8 +798,11 @@ static errr init_k_info(void)
 			return (0);
 
 		/* Information */
-		msg_print("Ignoring obsolete/defective 'k_info.raw' file.");
-		msg_print(NULL);
+		if (!init_raw_only)
+		{
+			msg_print("Ignoring obsolete/defective 'k_info.raw' file.");
+			msg_print(NULL);
+		}
 	}
 
 
@@ -672,6 +838,10 @@ static errr init_k_info(void)
 	/* Close it */
 	my_fclose(fp);
 
+	/* Leave the errors to the main game */
+	if (err && init_raw_only)
+		return (err);
+
 	/* Errors */
 	if (err)
 	{
@@ -739,6 +909,10 @@ static errr init_k_info(void)
 	fake_name_size = 0;
 	fake_text_size = 0;
 
+	/* The image file is all that was wanted */
+	if (init_raw_only)
+		return (0);
+
 #endif /* ALLOW_TEMPLATES */
 
 
@@ -777,6 +951,10 @@ static errr init_a_info_raw(int fd)
 {
 	header test;
 
+#ifdef MAP_RAW_FILES
+	char *map;
+#endif
+
 
 	/* Read and Verify the header */
 	if (fd_read(fd, (char *) (&test), sizeof(header)) ||
@@ -787,7 +965,8 @@ static errr init_a_info_raw(int fd)
 		(test.info_num != a_head->info_num) ||
 		(test.info_len != a_head->info_len) ||
 		(test.head_size != a_head->head_size) ||
-		(test.info_size != a_head->info_size))
+		(test.info_size != a_head->info_size) ||
+		(a_head->txt_hash && (test.txt_hash != a_head->txt_hash)))
 	{
 		/* Error */
 		return (-1);
@@ -797,6 +976,26 @@ static errr init_a_info_raw(int fd)
 	/* Accept the header */
 	(*a_head) = test;
 
+#ifdef MAP_RAW_FILES
+
+	/* Use the file in place */
+	if ((map = init_raw_map(fd, a_head)) != NULL)
+	{
+		a_info = (artifact_type *) map;
+		map += a_head->info_size;
+
+		a_name = map;
+		map += a_head->name_size;
+
+		a_text = map;
+
+		/* Success */
+		return (0);
+	}
+
+#endif /* MAP_RAW_FILES */
+
+
 
 	/* Allocate the "a_info" array */
 	C_MAKE(a_info, a_head->info_num, artifact_type);
@@ -871,6 +1070,9 @@ static errr init_a_info(void)
 
 #ifdef ALLOW_TEMPLATES
 
+	/* Hash the template file */
+	a_head->txt_hash = init_txt_hash("a_info.txt");
+
 	/*** Load the binary image file ***/
 
 	/* Build the filename */
@@ -893,8 +1095,11 @@ static errr init_a_info(void)
 			return (0);
 
 		/* Information */
-		msg_print("Ignoring obsolete/defective 'a_info.raw' file.");
-		msg_print(NULL);
+		if (!init_raw_only)
+		{
+			msg_print("Ignoring obsolete/defective 'a_info.raw' file.");
+			msg_print(NULL);
+		}
 	}
 
 
@@ -930,6 +1135,10 @@ static errr init_a_info(void)
 	/* Close it */
 	my_fclose(fp);
 
+	/* Leave the errors to the main game */
+	if (err && init_raw_only)
+		return (err);
+
 	/* Errors */
 	if (err)
 	{
@@ -997,6 +1206,10 @@ static errr init_a_info(void)
 	fake_name_size = 0;
 	fake_text_size = 0;
 
+	/* The image file is all that was wanted */
+	if (init_raw_only)
+		return (0);
+
 #endif /* ALLOW_TEMPLATES */
 
 
@@ -1035,6 +1248,10 @@ static errr init_e_info_raw(int fd)
 {
 	header test;
 
+#ifdef MAP_RAW_FILES
+	char *map;
+#endif
+
 
 	/* Read and Verify the header */
 	if (fd_read(fd, (char *) (&test), sizeof(header)) ||
@@ -1045,7 +1262,8 @@ static errr init_e_info_raw(int fd)
 		(test.info_num != e_head->info_num) ||
 		(test.info_len != e_head->info_len) ||
 		(test.head_size != e_head->head_size) ||
-		(test.info_size != e_head->info_size))
+		(test.info_size != e_head->info_size) ||
+		(e_head->txt_hash && (test.txt_hash != e_head->txt_hash)))
 	{
 		/* Error */
 		return (-1);
@@ -1055,6 +1273,26 @@ static errr init_e_info_raw(int fd)
 	/* Accept the header */
 	(*e_head) = test;
 
+#ifdef MAP_RAW_FILES
+
+	/* Use the file in place */
+	if ((map = init_raw_map(fd, e_head)) != NULL)
+	{
+		e_info = (ego_item_type *) map;
+		map += e_head->info_size;
+
+		e_name = map;
+		map += e_head->name_size;
+
+		e_text = map;
+
+		/* Success */
+		return (0);
+	}
+
+#endif /* MAP_RAW_FILES */
+
+
 
 	/* Allocate the "e_info" array */
 	C_MAKE(e_info, e_head->info_num, ego_item_type);
@@ -1129,6 +1367,9 @@ static errr init_e_info(void)
 
 #ifdef ALLOW_TEMPLATES
 
+	/* Hash the template file */
+	e_head->txt_hash = init_txt_hash("e_info.txt");
+
 	/*** Load the binary image file ***/
 
 	/* Build the filename */
@@ -1151,8 +1392,11 @@ static errr init_e_info(void)
 			return (0);
 
 		/* Information */
-		msg_print("Ignoring obsolete/defective 'e_info.raw' file.");
-		msg_print(NULL);
+		if (!init_raw_only)
+		{
+			msg_print("Ignoring obsolete/defective 'e_info.raw' file.");
+			msg_print(NULL);
+		}
 	}
 
 
@@ -1188,6 +1432,10 @@ static errr init_e_info(void)
 	/* Close it */
 	my_fclose(fp);
 
+	/* Leave the errors to the main game */
+	if (err && init_raw_only)
+		return (err);
+
 	/* Errors */
 	if (err)
 	{
@@ -1255,6 +1503,10 @@ static errr init_e_info(void)
 	fake_name_size = 0;
 	fake_text_size = 0;
 
+	/* The image file is all that was wanted */
+	if (init_raw_only)
+		return (0);
+
 #endif /* ALLOW_TEMPLATES */
 
 
@@ -1293,6 +1545,10 @@ static errr init_r_info_raw(int fd)
 {
 	header test;
 
+#ifdef MAP_RAW_FILES
+	char *map;
+#endif
+
 
 	/* Read and Verify the header */
 	if (fd_read(fd, (char *) (&test), sizeof(header)) ||
@@ -1303,7 +1559,8 @@ static errr init_r_info_raw(int fd)
 		(test.info_num != r_head->info_num) ||
 		(test.info_len != r_head->info_len) ||
 		(test.head_size != r_head->head_size) ||
-		(test.info_size != r_head->info_size))
+		(test.info_size != r_head->info_size) ||
+		(r_head->txt_hash && (test.txt_hash != r_head->txt_hash)))
 	{
 		/* Error */
 		return (-1);
@@ -1313,6 +1570,29 @@ static errr init_r_info_raw(int fd)
 	/* Accept the header */
 	(*r_head) = test;
 
+#ifdef MAP_RAW_FILES
+
+	/* Use the file in place */
+	if ((map = init_raw_map(fd, r_head)) != NULL)
+	{
+		r_info = (monster_race *) map;
+		map += r_head->info_size;
+
+		r_name = map;
+		map += r_head->name_size;
+
+		r_text = map;
+		map += r_head->text_size;
+
+		sayings_text = map;
+
+		/* Success */
+		return (0);
+	}
+
+#endif /* MAP_RAW_FILES */
+
+
 	/* Allocate the "r_info" array */
 	C_MAKE(r_info, r_head->info_num, monster_race);
 
@@ -1392,6 +1672,9 @@ static errr init_r_info(void)
 
 #ifdef ALLOW_TEMPLATES
 
+	/* Hash the template file */
+	r_head->txt_hash = init_txt_hash("r_info.txt");
+
 	/*** Load the binary image file ***/
 
 	/* Build the filename */
@@ -1414,8 +1697,11 @@ static errr init_r_info(void)
 			return (0);
 
 		/* Information */
-		msg_print("Ignoring obsolete/defective 'r_info.raw' file.");
-		msg_print(NULL);
+		if (!init_raw_only)
+		{
+			msg_print("Ignoring obsolete/defective 'r_info.raw' file.");
+			msg_print(NULL);
+		}
 	}
 
 
@@ -1452,6 +1738,10 @@ static errr init_r_info(void)
 	/* Close it */
 	my_fclose(fp);
 
+	/* Leave the errors to the main game */
+	if (err && init_raw_only)
+		return (err);
+
 	/* Errors */
 	if (err)
 	{
@@ -1524,6 +1814,10 @@ static errr init_r_info(void)
 	fake_name_size = 0;
 	fake_text_size = 0;
 
+	/* The image file is all that was wanted */
+	if (init_raw_only)
+		return (0);
+
 #endif /* ALLOW_TEMPLATES */
 
 
@@ -1562,6 +1856,10 @@ static errr init_v_info_raw(int fd)
 {
 	header test;
 
+#ifdef MAP_RAW_FILES
+	char *map;
+#endif
+
 
 	/* Read and Verify the header */
 	if (fd_read(fd, (char *) (&test), sizeof(header)) ||
@@ -1572,7 +1870,8 @@ static errr init_v_info_raw(int fd)
 		(test.info_num != v_head->info_num) ||
 		(test.info_len != v_head->info_len) ||
 		(test.head_size != v_head->head_size) ||
-		(test.info_size != v_head->info_size))
+		(test.info_size != v_head->info_size) ||
+		(v_head->txt_hash && (test.txt_hash != v_head->txt_hash)))
 	{
 		/* Error */
 		return (-1);
@@ -1582,6 +1881,32 @@ static errr init_v_info_raw(int fd)
 	/* Accept the header */
 	(*v_head) = test;
 
+#ifdef MAP_RAW_FILES
+
+	/* Use the file in place */
+	if ((map = init_raw_map(fd, v_head)) != NULL)
+	{
+		v_info = (vault_type *) map;
+		map += v_head->info_size;
+
+		v_name = map;
+		map += v_head->name_size;
+
+		v_text = map;
+		map += v_head->text_size;
+
+		q_text = map;
+		map += v_head->text2_size;
+
+		vm_text = map;
+
+		/* Success */
+		return (0);
+	}
+
+#endif /* MAP_RAW_FILES */
+
+
 	/* Allocate the "v_info" array */
 	C_MAKE(v_info, v_head->info_num, vault_type);
 
@@ -1662,6 +1987,9 @@ static errr init_v_info(void)
 
 #ifdef ALLOW_TEMPLATES
 
+	/* Hash the template file */
+	v_head->txt_hash = init_txt_hash("v_info.txt");
+
 	/*** Load the binary image file ***/
 
 	/* Build the filename */
@@ -1684,8 +2012,11 @@ static errr init_v_info(void)
 			return (0);
 
 		/* Information */
-		msg_print("Ignoring obsolete/defective 'v_info.raw' file.");
-		msg_print(NULL);
+		if (!init_raw_only)
+		{
+			msg_print("Ignoring obsolete/defective 'v_info.raw' file.");
+			msg_print(NULL);
+		}
 	}
 
 
@@ -1725,6 +2056,10 @@ static errr init_v_info(void)
 	/* Close it */
 	my_fclose(fp);
 
+	/* Leave the errors to the main game */
+	if (err && init_raw_only)
+		return (err);
+
 	/* Errors */
 	if (err)
 	{
@@ -1798,6 +2133,10 @@ static errr init_v_info(void)
 	fake_name_size = 0;
 	fake_text_size = 0;
 
+	/* The image file is all that was wanted */
+	if (init_raw_only)
+		return (0);
+
 #endif /* ALLOW_TEMPLATES */
 
 
@@ -1845,23 +2184,33 @@ static errr init_other(void)
 	/* Initialize the "macro" package */
 	(void) macro_init();
 
+	/* Initialize the CLI command names */
+	(void) cli_init();
+
+	/* Index the recipes by their ingredients */
+	recipe_init();
+
+	/* Prepare the monster terrain effects */
+	mon_terrain_init();
+
 	/* Quark variables */
 	C_MAKE(quark__str, QUARK_MAX, cptr);
 
 	/* Message variables */
-	C_MAKE(message__ptr, MESSAGE_MAX, u16b);
-	C_MAKE(message__pty, MESSAGE_MAX, byte);
-	C_MAKE(message__buf, MESSAGE_BUF, char);
+	C_MAKE(message__list, MESSAGE_MAX, message_type);
 
 	/* Reset cache buffers. */
 	init_cache();
 
-	/* Hack -- No messages yet */
-	message__tail = MESSAGE_BUF;
-
 	/* Initialize tval priority table */
 	init_tval_order();
 
+	/* Work out the projection paths */
+	init_paths();
+
+	/* Index the simple kinds of damage */
+	init_gf_info();
+
     /* Initialize patrol system */
     init_patrol_system();
 
@@ -2151,11 +2500,79 @@ static errr init_alloc(void)
 
 
 
+/*
+ * The startup profile (see "--startup-profile"), if any
+ */
+static FILE *init_profile_fp = NULL;
+
+/*
+ * The phase being timed, and when it began
+ */
+static cptr init_profile_phase = NULL;
+static struct timeval init_profile_start;
+
+/*
+ * Total time of the phases so far (in microseconds)
+ */
+static long init_profile_total = 0L;
+
+
+/*
+ * Finish timing the current phase, and start timing "phase" (if any).
+ *
+ * The phases are the steps announced by "note()", and the report goes
+ * to "startup_profile.txt" in the current directory.
+ */
+static void init_profile_mark(cptr phase)
+{
+	struct timeval now;
+
+	if (!arg_startup_profile) return;
+
+	gettimeofday(&now, NULL);
+
+	/* Start the report */
+	if (!init_profile_fp)
+	{
+		init_profile_fp = fopen("startup_profile.txt", "w");
+		if (!init_profile_fp) return;
+	}
+
+	/* Report the last phase */
+	if (init_profile_phase)
+	{
+		long usec = (now.tv_sec - init_profile_start.tv_sec) * 1000000L +
+			(now.tv_usec - init_profile_start.tv_usec);
+
+		fprintf(init_profile_fp, "%-44s %8ld.%03ld ms\n",
+			init_profile_phase, usec / 1000L, usec % 1000L);
+
+		init_profile_total += usec;
+	}
+
+	init_profile_phase = phase;
+	init_profile_start = now;
+
+	/* Finish the report */
+	if (!phase)
+	{
+		fprintf(init_profile_fp, "%-44s %8ld.%03ld ms\n", "Total",
+			init_profile_total / 1000L, init_profile_total % 1000L);
+
+		fclose(init_profile_fp);
+		init_profile_fp = NULL;
+	}
+}
+
+
 /*
  * Hack -- take notes on line 23
  */
 static void note(cptr str)
 {
+	/* Time the steps */
+	init_profile_mark(str);
+
 	Term_erase(0, screen_y - 1, 255);
 	Term_putstr((screen_x - 80) / 2 + 20, screen_y - 1, -1, TERM_WHITE,
 		str);
@@ -2164,6 +2581,71 @@ static void note(cptr str)
 
 
 
+#if defined(ALLOW_TEMPLATES) && defined(FORK_TEMPLATES)
+
+/*
+ * A forked copy leaves quietly instead of quitting the game
+ */
+static void init_raw_quit(cptr str)
+{
+	/* Unused */
+	(void) str;
+
+	_exit(1);
+}
+
+
+/*
+ * Bring every binary image file up to date at once, with one forked copy
+ * of the game per file.
+ *
+ * The template files are independent of each other, and each one has its
+ * own image file, so each copy parses one of them and writes its image,
+ * and nothing else.  Once every copy is done, "init_angband()" loads the
+ * image files one by one as usual, so the result is the same as parsing
+ * the files in order.  A copy which fails just leaves its image file
+ * stale, and the error is found (and reported) again by the game itself.
+ *
+ * The spell lists ("init_s_info_txt()") have no image file, and are still
+ * parsed by "init_other()".
+ */
+static void init_raw_parallel(void)
+{
+	static errr (*const init[]) (void) =
+	{
+		init_f_info, init_k_info, init_a_info,
+		init_e_info, init_r_info, init_v_info
+	};
+
+	pid_t child[6];
+	int i;
+
+	/* Start the copies */
+	for (i = 0; i < 6; i++)
+	{
+		child[i] = fork();
+
+		/* Build one image file */
+		if (child[i] == 0)
+		{
+			init_raw_only = TRUE;
+			quit_aux = init_raw_quit;
+
+			_exit((*init[i]) () ? 1 : 0);
+		}
+	}
+
+	/* Wait for all of them */
+	for (i = 0; i < 6; i++)
+	{
+		if (child[i] > 0) (void) waitpid(child[i], NULL, 0);
+	}
+}
+
+#endif /* ALLOW_TEMPLATES && FORK_TEMPLATES */
+
+
+
 /*
  * Hack -- Explain a broken "lib" folder and quit (see below).
  *
@@ -2247,6 +2729,9 @@ void init_angband(void)
 
 	char buf[1024];
 
+	/* Count the game data on its own */
+	int tag = VIRT_TAG(MEM_INIT);
+
 
 	/*** Verify the "news" file ***/
 
@@ -2340,6 +2825,14 @@ void init_angband(void)
 
 	/*** Initialize some arrays ***/
 
+#if defined(ALLOW_TEMPLATES) && defined(FORK_TEMPLATES)
+
+	/* Bring the image files up to date */
+	note("[Initializing arrays... (templates)]");
+	init_raw_parallel();
+
+#endif
+
 	/* Initialize feature info */
 	note("[Initializing arrays... (features)]");
 	if (init_f_info())
@@ -2397,4 +2890,9 @@ void init_angband(void)
 
 	/* Done */
 	note("[Initialization complete]");
+
+	(void)VIRT_TAG(tag);
+
+	/* Finish the startup profile */
+	init_profile_mark(NULL);
 }
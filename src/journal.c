@@ -0,0 +1,455 @@
+/* File: journal.c */
+
+/*
+ * Keystroke journals (the "--journal" and "--play-journal" options)
+ *
+ * With "--journal", every answer the keyboard gives the game (through
+ * "journal_inkey()", which "inkey()" uses in place of "Term_inkey()")
+ * is written to "<savefile>.jnl", including the polls which found no
+ * key, since those decide whether running or resting is disturbed.  The
+ * state of the random number generators is written as the game seeds them,
+ * and a copy of the savefile as it was when the game started is kept in
+ * "<savefile>.jnl.sav".
+ *
+ * With "--play-journal <file>", the game runs without a display from a
+ * fresh copy of that savefile ("<file>.rpl"; a new character if there
+ * was none), takes the generator state from the journal, and is given
+ * the same answers, as fast as it can take them, so that a session can
+ * be watched again under a profiler.  Every JOURNAL_CHECK answers the
+ * journal holds the game turn and a digest of the generator state; if
+ * the replay does not match, it quits at once.  It also quits when the
+ * journal runs out.
+ *
+ * The journal starts with "KJNL", a version byte (1), and the length
+ * and letters of the name of the display module, which the replay takes
+ * as its own so that it reads the same macros and keymaps.  Then come
+ * answers, one byte each, with 0xFF as an escape:
+ *
+ *	b			the key "b" (not 0xFF)
+ *	0xFF 0x00		the key 0xFF
+ *	0xFF n			"n" polls which found no key (1 to 0xFC)
+ *	0xFF 0xFD place:2 value:4 state:4 * RAND_DEG div:4 * RAND_DIV_LEN
+ *				the generators were seeded
+ *	0xFF 0xFE turn:4 digest:4
+ *				a check
+ *
+ * Numbers are LSB first.  Levels which were written to their own files
+ * when the journal started are not copied, so a replay which needs one
+ * of them will not match.
+ */
+
+#include "angband.h"
+
+
+#define JNL_ESCAPE	0xFF
+#define JNL_KEY_FF	0x00
+#define JNL_NONE_MAX	0xFC
+#define JNL_SEED	0xFD
+#define JNL_CHECK	0xFE
+
+
+/*
+ * The journal, if there is one
+ */
+static FILE *jnl_fff = NULL;
+
+/*
+ * Playing it back (not writing it)
+ */
+static bool jnl_replay = FALSE;
+
+/*
+ * Answers given so far
+ */
+static u32b jnl_count = 0L;
+
+/*
+ * Polls which found no key, not yet written (or not yet given back)
+ */
+static int jnl_none = 0;
+
+/*
+ * When the replay started
+ */
+static u32b jnl_began;
+
+
+/*
+ * Copy a file (but not if the first one is missing)
+ *
+ * Returns TRUE on success.
+ */
+static bool journal_copy(cptr from, cptr to)
+{
+	FILE *in, *out;
+	char buf[4096];
+	size_t n;
+
+	/* Nothing to copy */
+	(void)fd_kill(to);
+	in = my_fopen(from, "rb");
+	if (!in) return (FALSE);
+
+	out = my_fopen(to, "wb");
+	if (!out)
+	{
+		my_fclose(in);
+		return (FALSE);
+	}
+
+	while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+	{
+		fwrite(buf, 1, n, out);
+	}
+
+	my_fclose(in);
+	my_fclose(out);
+
+	return (TRUE);
+}
+
+
+/*
+ * Write a number to the journal (LSB first)
+ */
+static void journal_put(u32b v, int n)
+{
+	while (n--)
+	{
+		putc((int)(v & 0xFF), jnl_fff);
+		v >>= 8;
+	}
+}
+
+
+/*
+ * Read a number from the journal (LSB first), or quit if it ends
+ */
+static u32b journal_get(int n)
+{
+	u32b v = 0L;
+	int i, c;
+
+	for (i = 0; i < n; i++)
+	{
+		c = getc(jnl_fff);
+		if (c == EOF) quit("The journal is cut short!");
+		v |= ((u32b)c) << (8 * i);
+	}
+
+	return (v);
+}
+
+
+/*
+ * A digest of the state of the random number generators
+ */
+static u32b journal_digest(void)
+{
+	u32b div[RAND_DIV_LEN];
+	u32b d = Rand_value ^ ((u32b)Rand_place << 16);
+	int i;
+
+	for (i = 0; i < RAND_DEG; i++)
+	{
+		d = (d << 5) ^ (d >> 27) ^ Rand_state[i];
+	}
+
+	Rand_div_save(div);
+
+	for (i = 0; i < RAND_DIV_LEN; i++)
+	{
+		d = (d << 5) ^ (d >> 27) ^ div[i];
+	}
+
+	return (d);
+}
+
+
+/*
+ * Write out the polls which found no key
+ */
+static void journal_put_none(void)
+{
+	while (jnl_none > 0)
+	{
+		int n = MIN(jnl_none, JNL_NONE_MAX);
+
+		putc(JNL_ESCAPE, jnl_fff);
+		putc(n, jnl_fff);
+		jnl_none -= n;
+	}
+}
+
+
+/*
+ * The replay no longer matches the journal
+ */
+static void journal_diverged(cptr what)
+{
+	quit_fmt("The replay diverged from the journal at answer %lu (turn %ld): %s.",
+	         (unsigned long)jnl_count, (long)turn, what);
+}
+
+
+/*
+ * Close the journal
+ */
+static void journal_close(void)
+{
+	if (!jnl_fff) return;
+
+	if (!jnl_replay) journal_put_none();
+
+	my_fclose(jnl_fff);
+	jnl_fff = NULL;
+}
+
+
+/*
+ * Start writing a journal of this session
+ */
+void journal_record(void)
+{
+	char path[1024];
+	char copy[1024];
+
+	strnfmt(path, sizeof(path), "%s.jnl", savefile);
+	strnfmt(copy, sizeof(copy), "%s.jnl.sav", savefile);
+
+	jnl_fff = my_fopen(path, "wb");
+	if (!jnl_fff) quit_fmt("Unable to write the journal '%s'!", path);
+
+	fputs("KJNL", jnl_fff);
+	putc(1, jnl_fff);
+	putc(strlen(ANGBAND_SYS), jnl_fff);
+	fputs(ANGBAND_SYS, jnl_fff);
+
+	/* Keep the savefile the session starts from */
+	(void)journal_copy(savefile, copy);
+
+	atexit(journal_close);
+}
+
+
+/*
+ * Start playing back the journal "path"
+ */
+void journal_play(cptr path)
+{
+	char head[5];
+	char sys[256];
+	char copy[1024];
+	int len;
+
+	jnl_fff = my_fopen(path, "rb");
+	if (!jnl_fff) quit_fmt("Unable to read the journal '%s'!", path);
+
+	if ((fread(head, 1, 5, jnl_fff) != 5) || strncmp(head, "KJNL", 4) ||
+	    (head[4] != 1))
+	{
+		quit_fmt("'%s' is not a journal!", path);
+	}
+
+	/* Pretend to be the display module it was kept with */
+	len = (int)journal_get(1);
+	if (fread(sys, 1, len, jnl_fff) != (size_t)len) quit("The journal is cut short!");
+	sys[len] = '\0';
+	ANGBAND_SYS = string_make(sys);
+
+	jnl_replay = TRUE;
+
+	/* Play from a copy of the savefile it started from */
+	strnfmt(copy, sizeof(copy), "%s.sav", path);
+	strnfmt(savefile, sizeof(savefile), "%s.rpl", path);
+	(void)journal_copy(copy, savefile);
+
+	jnl_began = msec_clock();
+
+	atexit(journal_close);
+}
+
+
+/*
+ * Note (or replace) the state the random number generators were seeded with
+ */
+void journal_seed(void)
+{
+	u32b div[RAND_DIV_LEN];
+	int i;
+
+	if (!jnl_fff) return;
+
+	/* Write it */
+	if (!jnl_replay)
+	{
+		journal_put_none();
+
+		putc(JNL_ESCAPE, jnl_fff);
+		putc(JNL_SEED, jnl_fff);
+		journal_put(Rand_place, 2);
+		journal_put(Rand_value, 4);
+		for (i = 0; i < RAND_DEG; i++) journal_put(Rand_state[i], 4);
+
+		Rand_div_save(div);
+		for (i = 0; i < RAND_DIV_LEN; i++) journal_put(div[i], 4);
+
+		return;
+	}
+
+	/* Read it */
+	if (jnl_none || (journal_get(1) != JNL_ESCAPE) ||
+	    (journal_get(1) != JNL_SEED))
+	{
+		journal_diverged("the game was seeded at another time");
+	}
+
+	Rand_quick = FALSE;
+	Rand_place = (u16b)journal_get(2);
+	Rand_value = journal_get(4);
+	for (i = 0; i < RAND_DEG; i++) Rand_state[i] = journal_get(4);
+
+	for (i = 0; i < RAND_DIV_LEN; i++) div[i] = journal_get(4);
+	Rand_div_load(div);
+}
+
+
+/*
+ * The replay has reached the end of the journal
+ */
+static void journal_done(void)
+{
+	quit_fmt("Replayed %lu answers over %ld game turns in %lu msec.",
+	         (unsigned long)jnl_count, (long)turn,
+	         (unsigned long)(msec_clock() - jnl_began));
+}
+
+
+/*
+ * Give back the next answer from the journal
+ */
+static errr journal_answer(char *ch, bool wait)
+{
+	int c;
+
+	/* Keys the game pushed back are in the journal too */
+	Term_flush();
+
+	/* Check */
+	if (!(jnl_count % JOURNAL_CHECK))
+	{
+		u32b when, digest;
+
+		/* All done */
+		if (!jnl_none)
+		{
+			c = getc(jnl_fff);
+			if (c == EOF) journal_done();
+			ungetc(c, jnl_fff);
+		}
+
+		if (jnl_none || (journal_get(1) != JNL_ESCAPE) ||
+		    (journal_get(1) != JNL_CHECK))
+		{
+			journal_diverged("a check is missing");
+		}
+
+		when = journal_get(4);
+		digest = journal_get(4);
+
+		if (when != (u32b)turn) journal_diverged("the game turn differs");
+		if (digest != journal_digest()) journal_diverged("the random numbers differ");
+	}
+
+	jnl_count++;
+
+	/* Still no key */
+	if (jnl_none)
+	{
+		if (wait) journal_diverged("the game waited for a key");
+		jnl_none--;
+		return (1);
+	}
+
+	c = getc(jnl_fff);
+
+	/* All done */
+	if (c == EOF)
+	{
+		jnl_count--;
+		journal_done();
+	}
+
+	/* A key */
+	if (c != JNL_ESCAPE)
+	{
+		*ch = (char)c;
+		return (0);
+	}
+
+	c = (int)journal_get(1);
+
+	if (c == JNL_KEY_FF)
+	{
+		*ch = (char)JNL_ESCAPE;
+		return (0);
+	}
+
+	if (c > JNL_NONE_MAX) journal_diverged("the game asked for a key too soon");
+
+	/* No key */
+	if (wait) journal_diverged("the game waited for a key");
+	jnl_none = c - 1;
+	return (1);
+}
+
+
+/*
+ * Ask the keyboard for a key, as "Term_inkey()" does, noting the answer
+ * in the journal (or taking it from there)
+ */
+errr journal_inkey(char *ch, bool wait, bool take)
+{
+	errr res;
+
+	if (!jnl_fff) return (Term_inkey(ch, wait, take));
+
+	if (jnl_replay) return (journal_answer(ch, wait));
+
+	res = Term_inkey(ch, wait, take);
+
+	/* Check */
+	if (!(jnl_count % JOURNAL_CHECK))
+	{
+		journal_put_none();
+
+		putc(JNL_ESCAPE, jnl_fff);
+		putc(JNL_CHECK, jnl_fff);
+		journal_put((u32b)turn, 4);
+		journal_put(journal_digest(), 4);
+	}
+
+	jnl_count++;
+
+	/* No key */
+	if (res)
+	{
+		jnl_none++;
+		return (res);
+	}
+
+	journal_put_none();
+
+	if ((byte)*ch == JNL_ESCAPE)
+	{
+		putc(JNL_ESCAPE, jnl_fff);
+		putc(JNL_KEY_FF, jnl_fff);
+	}
+	else
+	{
+		putc((byte)*ch, jnl_fff);
+	}
+
+	return (res);
+}
+
@@ -37,6 +37,14 @@ static u32b x_check = 0L;
 static bool sf_error = FALSE;
 
 
+/*
+ * The savefile being read, all in memory (see "sf_mem_read()")
+ */
+static byte *sf_mem = NULL;
+static u32b sf_mem_pos = 0L;
+static u32b sf_mem_len = 0L;
+
+
 
 /*
  * Hack -- Log information to a debug file.
@@ -91,7 +99,7 @@ static byte sf_get(void)
 	if (sf_error) return 0;
 
 	/* Get a character, decode the value */
-	tmp = getc(fff);
+	tmp = (sf_mem_pos < sf_mem_len) ? sf_mem[sf_mem_pos++] : EOF;
 
 	/* Check for EOF */
 	if (tmp == EOF)
@@ -142,6 +150,100 @@ static void rd_s32b(s32b * ip)
 	rd_u32b((u32b *) ip);
 }
 
+/*
+ * Decode a run of bytes from "src" into "dst".
+ *
+ * Every value is its byte xor'ed with the byte before it, so the loop
+ * has no dependency from one step to the next, and the compiler is free
+ * to do it a word (or a vector) at a time.
+ */
+static void sf_decode(byte *dst, const byte *src, u32b len)
+{
+	u32b v = 0L, x = 0L;
+	u32b i;
+
+	if (!len) return;
+
+	dst[0] = src[0] ^ xor_byte;
+	v += dst[0];
+	x += src[0];
+
+	for (i = 1; i < len; i++)
+	{
+		dst[i] = src[i] ^ src[i - 1];
+
+		/* Maintain the checksum info */
+		v += dst[i];
+		x += src[i];
+	}
+
+	xor_byte = src[len - 1];
+
+	v_check += v;
+	x_check += x;
+}
+
+
+/*
+ * Read a whole block of bytes at once
+ */
+static void rd_block(byte *buf, u32b len)
+{
+	/* Check for error */
+	if (sf_error) return;
+
+	if (len > sf_mem_len - sf_mem_pos)
+	{
+		note("Unexpected End of File encountered!");
+		sf_error = TRUE;
+		return;
+	}
+
+	sf_decode(buf, sf_mem + sf_mem_pos, len);
+	sf_mem_pos += len;
+}
+
+
+/*
+ * Read all of a savefile into memory, so that it can be decoded from
+ * there (see "sf_get()" and "rd_block()") instead of one "getc()" at a
+ * time.  Free it with "sf_mem_free()".
+ */
+static bool sf_mem_read(FILE *fp)
+{
+	long len;
+
+	/* Find the size */
+	if (fseek(fp, 0L, SEEK_END)) return (FALSE);
+	len = ftell(fp);
+	if ((len < 0) || fseek(fp, 0L, SEEK_SET)) return (FALSE);
+
+	sf_mem_len = (u32b) len;
+	sf_mem_pos = 0L;
+
+	/* Leave room for an empty file */
+	C_MAKE(sf_mem, sf_mem_len + 1, byte);
+
+	if (fread(sf_mem, 1, sf_mem_len, fp) != sf_mem_len)
+	{
+		C_KILL(sf_mem, sf_mem_len + 1, byte);
+		sf_mem = NULL;
+		return (FALSE);
+	}
+
+	return (TRUE);
+}
+
+
+/*
+ * Forget a savefile read by "sf_mem_read()"
+ */
+static void sf_mem_free(void)
+{
+	C_KILL(sf_mem, sf_mem_len + 1, byte);
+	sf_mem = NULL;
+}
+
 
 /*
  * Hack -- read a string
@@ -222,6 +324,9 @@ static void rd_item_body(object_type *o_ptr)
 	rd_byte(&o_ptr->name2);
 	rd_s16b(&o_ptr->timeout);
 
+	/* It may be recharging */
+	if (o_ptr->timeout > 0) object_charging_n++;
+
 	rd_s16b(&o_ptr->to_h);
 	rd_s16b(&o_ptr->to_d);
 	rd_s16b(&o_ptr->to_a);
@@ -273,7 +378,7 @@ static object_type *rd_item_aux(bool store)
 		/* Allocate dummy object to consume stream */
 		if (store)
 		{
-			MAKE(o_ptr, object_type);
+			o_ptr = object_alloc();
 		}
 		else
 		{
@@ -290,7 +395,7 @@ static object_type *rd_item_aux(bool store)
 
 	if (store)
 	{
-		MAKE(o_ptr, object_type);
+		o_ptr = object_alloc();
 	}
 	else
 	{
@@ -368,15 +473,15 @@ static object_type *rd_item_store(void)
 
 
 /*
- * Read a monster
+ * Read a monster (and its guard data into "guard", if it has any)
+ *
+ * Returns TRUE if it has guard data.
  */
-static void rd_monster(monster_type * m_ptr, monster_guard_data **guard_out)
+static bool rd_monster(monster_type * m_ptr, monster_guard_data *guard)
 {
 	object_type *o_ptr;
     byte has_guard;
 
-    *guard_out = NULL;
-
 	/* Read the monster race */
 	rd_s16b(&m_ptr->r_idx);
 
@@ -424,11 +529,23 @@ static void rd_monster(monster_type * m_ptr, monster_guard_data **guard_out)
 		m_ptr->smart_ai.patience_timer = 0;
 	}
 
+	/* Read the monster's inventory. */
+	while (1)
+	{
+		o_ptr = rd_item();
+
+		if (!o_ptr)
+			break;
+
+		monster_inven_carry(m_ptr, o_ptr);
+	}
+
     /* Read guard data */
     rd_byte(&has_guard);
     if (has_guard) {
         int i;
-        monster_guard_data *guard = ZNEW(monster_guard_data);
+
+        WIPE(guard, monster_guard_data);
 
         rd_s16b(&guard->home_y);
         rd_s16b(&guard->home_x);
@@ -446,19 +563,9 @@ static void rd_monster(monster_type * m_ptr, monster_guard_data **guard_out)
             rd_s16b(&guard->waypoints[i].x);
             rd_byte(&guard->waypoints[i].wait_turns);
         }
-        *guard_out = guard;
     }
 
-	/* Read the monster's inventory. */
-	while (1)
-	{
-		o_ptr = rd_item();
-
-		if (!o_ptr)
-			break;
-
-		monster_inven_carry(m_ptr, o_ptr);
-	}
+	return (has_guard ? TRUE : FALSE);
 }
 
 
@@ -729,6 +836,11 @@ static errr rd_extra(void)
 	byte tmp8u;
 	u16b tmp16u;
 
+	/* Old savefiles keep some scheduled events as counters */
+	s16b recall_left = 0;
+	s16b decipher_left = 0;
+	s16b decipher_idx = 0;
+
 	debug_log("rd_extra: start");
 
 	rd_string(op_ptr->full_name, 32);
@@ -846,7 +958,7 @@ static errr rd_extra(void)
 	rd_s16b(&p_ptr->shield);
 	rd_s16b(&p_ptr->blessed);
 	rd_s16b(&p_ptr->tim_invis);
-	rd_s16b(&p_ptr->word_recall);
+	rd_s16b(&recall_left);
 	rd_s16b(&p_ptr->see_infra);
 	rd_s16b(&p_ptr->tim_infra);
 	rd_s16b(&p_ptr->oppose_fire);
@@ -883,8 +995,12 @@ static errr rd_extra(void)
 	rd_byte(&p_ptr->maximize);
 	rd_byte(&p_ptr->preserve);
 
+	/* Shop maintenance owed (older savefiles owe none) */
+	for (i = 0; i < MAX_STORES; i++)
+		rd_byte(&store[i].maint_due);
+
 	/* Future use */
-	for (i = 0; i < 48; i++)
+	for (i = 0; i < 48 - MAX_STORES; i++)
 		rd_byte(&tmp8u);
 
 	/* Read puzzle state */
@@ -907,24 +1023,22 @@ static errr rd_extra(void)
 
 	if (sf_patch >= 3)
 	{
-		rd_s16b(&tome_decipher_turns);
+		rd_s16b(&decipher_left);
 		rd_s16b(&p_ptr->anti_magic);
 	}
 	else
 	{
-		tome_decipher_turns = 0;
 		p_ptr->anti_magic = 0;
 	}
 
 	if (sf_patch >= 4)
 	{
 		rd_u32b(&lore_known);
-		rd_s16b(&tome_decipher_idx);
+		rd_s16b(&decipher_idx);
 	}
 	else
 	{
 		lore_known = 0;
-		tome_decipher_idx = 0;
 	}
 	if (sf_patch >= 5)
 	{
@@ -987,6 +1101,49 @@ static errr rd_extra(void)
 	/* Current turn */
 	rd_s32b(&turn);
 
+	/* Forget the events of the last character */
+	event_wipe();
+
+	/* Scheduled events */
+	if (sf_patch >= 13)
+	{
+		s16b num;
+
+		/* Read the event count */
+		rd_s16b(&num);
+
+		/* Hack -- verify */
+		if ((num < 0) || (num > EVENT_MAX))
+		{
+			note(format("Too many (%d) scheduled events!", num));
+			return (26);
+		}
+
+		/* Read the events */
+		for (i = 0; i < num; i++)
+		{
+			s32b when;
+			s16b data;
+
+			rd_s32b(&when);
+			rd_byte(&tmp8u);
+			rd_s16b(&data);
+
+			(void)event_post(tmp8u, when, data);
+		}
+	}
+
+	/* Older savefiles count them down */
+	else
+	{
+		if (recall_left > 0)
+			(void)event_post(EVENT_RECALL, event_ticks(recall_left), 0);
+
+		if (decipher_left > 0)
+			(void)event_post(EVENT_DECIPHER, event_ticks(decipher_left),
+			                 decipher_idx);
+	}
+
 	/* Debug logging */
 	note(format("Loaded Turn: %ld", (long)turn));
 
@@ -1064,7 +1221,7 @@ static void rd_messages(void)
 	char buf[128];
 	byte p;
 
-	s16b num;
+	s16b num, n = 1;
 
 	/* Total */
 	rd_s16b(&num);
@@ -1076,11 +1233,148 @@ static void rd_messages(void)
 		rd_string(buf, 128);
 		rd_byte(&p);
 
+		/* How many times in a row */
+		if (sf_patch >= 14) rd_s16b(&n);
+
+		/* Paranoia */
+		if (n < 1) n = 1;
+
 		/* Save the message */
-		message_add(buf, p);
+		message_add_count(buf, p, n);
 	}
 }
 
+/*
+ * Read the packed grid layers of the dungeon (see "wr_grid_layer()")
+ *
+ * Unknown layers are skipped, and missing ones are left as they are.
+ */
+static errr rd_grid_layers(void)
+{
+	byte ver, num, layer;
+	u32b size, len;
+	byte *raw, *packed;
+	errr err = 0;
+	int i, y, x;
+
+	rd_byte(&ver);
+	rd_byte(&num);
+
+	if (ver > GRID_LAYER_VERSION)
+	{
+		note(format("Unknown grid layout %d!", ver));
+		return (164);
+	}
+
+	C_MAKE(raw, DUNGEON_HGT * DUNGEON_WID, byte);
+	C_MAKE(packed, PACK_BOUND(DUNGEON_HGT * DUNGEON_WID), byte);
+
+	for (i = 0; i < num; i++)
+	{
+		u32b n = 0;
+
+		rd_byte(&layer);
+		rd_u32b(&size);
+		rd_u32b(&len);
+
+		/* Verify the chunk */
+		if ((size != DUNGEON_HGT * DUNGEON_WID) ||
+			(len > PACK_BOUND(DUNGEON_HGT * DUNGEON_WID)))
+		{
+			note(format("Illegal grid layer %d!", layer));
+			err = 165;
+			break;
+		}
+
+		rd_block(packed, len);
+
+		if (sf_error || unpack_block(packed, len, raw, size))
+		{
+			note(format("Damaged grid layer %d!", layer));
+			err = 165;
+			break;
+		}
+
+		/* Apply the layer, a whole layer at a time */
+		switch (layer)
+		{
+			case GRID_LAYER_INFO_LO:
+			{
+				for (y = 0; y < DUNGEON_HGT; y++)
+					for (x = 0; x < DUNGEON_WID; x++, n++)
+						cave_info[y][x] = (cave_info[y][x] & 0xFF00) | raw[n];
+				break;
+			}
+
+			case GRID_LAYER_INFO_HI:
+			{
+				for (y = 0; y < DUNGEON_HGT; y++)
+					for (x = 0; x < DUNGEON_WID; x++, n++)
+						cave_info[y][x] = (cave_info[y][x] & 0x00FF) |
+							((u16b)raw[n] << 8);
+				break;
+			}
+
+			case GRID_LAYER_ELEV:
+			{
+				/* Cast the byte to a signed char so 255 becomes -1 again */
+				for (y = 0; y < DUNGEON_HGT; y++)
+				{
+					for (x = 0; x < DUNGEON_WID; x++, n++)
+					{
+						int elev = (int)((signed char)raw[n]);
+
+						if (elev > ELEV_MAX) elev = ELEV_MAX;
+						if (elev < ELEV_MIN) elev = ELEV_MIN;
+
+						cave_flow[y][x].elev = elev;
+					}
+				}
+
+				/* What "set_elevation()" would forget, once */
+				sight_cache_wipe();
+				map_info_forget_all();
+				break;
+			}
+
+			case GRID_LAYER_FUEL_LO:
+			{
+				for (y = 0; y < DUNGEON_HGT; y++)
+					for (x = 0; x < DUNGEON_WID; x++, n++)
+						cave[y][x].fuel = (cave[y][x].fuel & 0xFF00) | raw[n];
+				break;
+			}
+
+			case GRID_LAYER_FUEL_HI:
+			{
+				for (y = 0; y < DUNGEON_HGT; y++)
+					for (x = 0; x < DUNGEON_WID; x++, n++)
+						cave[y][x].fuel = (cave[y][x].fuel & 0x00FF) |
+							((u16b)raw[n] << 8);
+				break;
+			}
+
+			case GRID_LAYER_FEAT:
+			{
+				C_COPY(&cave_feat[0][0], raw, size, byte);
+				break;
+			}
+
+			case GRID_LAYER_SECTOR:
+			{
+				C_COPY(&cave_sector[0][0], raw, size, byte);
+				break;
+			}
+		}
+	}
+
+	C_KILL(raw, DUNGEON_HGT * DUNGEON_WID, byte);
+	C_KILL(packed, PACK_BOUND(DUNGEON_HGT * DUNGEON_WID), byte);
+
+	return (err);
+}
+
+
 /*
  * Read the dungeon
  *
@@ -1183,12 +1477,29 @@ static errr rd_dungeon(void)
 		return (1);
 	}
 
+	/* The whole map is read */
+	cave_hgt = DUNGEON_HGT;
+	cave_wid = DUNGEON_WID;
+
 
 
 	/*** Run length decoding ***/
 
+	/* The packed layout has no run-length count here */
+	rd_byte(&count);
+
+	if (!count)
+	{
+		errr err = rd_grid_layers();
+
+		if (err) return (err);
+	}
+
+	/* Older layout */
+	else
 	{
 		int cells_count, cells_total;
+		bool first = TRUE;
 		cells_total = DUNGEON_HGT * DUNGEON_WID;
 
 		debug_log("rd_dungeon: start RLE 1 (info)");
@@ -1199,8 +1510,9 @@ static errr rd_dungeon(void)
 		{
 			u16b tmp16u;
 
-			/* Grab RLE info */
-			rd_byte(&count);
+			/* Grab RLE info (the first count is already read) */
+			if (!first) rd_byte(&count);
+			first = FALSE;
 			rd_u16b(&tmp16u);
 
 			if (count == 0)
@@ -1341,6 +1653,88 @@ static errr rd_dungeon(void)
 	}
 
 
+	/*** Shifting maze walls ***/
+
+	if (sf_patch >= 11)
+	{
+		s16b num;
+
+		/* Read the wall count */
+		rd_s16b(&num);
+
+		/* Hack -- verify */
+		if ((num < 0) || (num > ACTIVE_WALL_MAX))
+		{
+			note(format("Too many (%d) shifting walls!", num));
+			return (163);
+		}
+
+		/* Read the walls */
+		active_wall_n = 0;
+		for (i = 0; i < num; i++)
+		{
+			s16b wy, wx;
+
+			rd_s16b(&wy);
+			rd_s16b(&wx);
+
+			/* Ignore walls at invalid locations */
+			if (!in_bounds(wy, wx)) continue;
+
+			active_wall_y[active_wall_n] = wy;
+			active_wall_x[active_wall_n] = wx;
+			active_wall_n++;
+		}
+	}
+
+	/* Older savefiles only have the "CAVE_ACTIVE" marks */
+	else
+	{
+		rebuild_active_walls();
+	}
+
+	/* Rebuild the dark sector table */
+	rebuild_dark_sectors();
+
+
+	/*** Destructible cover ***/
+
+	/* Older savefiles have none */
+	init_cover_system();
+
+	if (sf_patch >= 12)
+	{
+		s16b num;
+
+		/* Read the cover count */
+		rd_s16b(&num);
+
+		/* Hack -- verify */
+		if ((num < 0) || (num > COVER_FULL))
+		{
+			note(format("Too much (%d) cover!", num));
+			return (163);
+		}
+
+		/* Read the cover */
+		for (i = 0; i < num; i++)
+		{
+			s16b cy, cx, dur, max_dur;
+			byte type, feat;
+
+			rd_s16b(&cy);
+			rd_s16b(&cx);
+			rd_s16b(&dur);
+			rd_s16b(&max_dur);
+			rd_byte(&type);
+			rd_byte(&feat);
+
+			/* Ignore cover at invalid locations */
+			(void)cover_restore(cy, cx, type, dur, max_dur, feat);
+		}
+	}
+
+
 	/*** Player ***/
 
 	/* Save depth */
@@ -1462,25 +1856,34 @@ static errr rd_dungeon(void)
 		WIPE(n_ptr, monster_type);
 
 		/* Read the monster */
-        monster_guard_data *guard = NULL;
-		rd_monster(n_ptr, &guard);
+        monster_guard_data guard;
+		bool has_guard = rd_monster(n_ptr, &guard);
 
 		/* Place monster in dungeon */
         s16b m_idx = monster_place(n_ptr->fy, n_ptr->fx, n_ptr);
 		if (!m_idx)
 		{
 			note(format("Cannot place monster %d", i));
-            if (guard) KILL(guard, monster_guard_data);
 			/* return (162); */
 		}
-        else if (guard)
+        else if (has_guard)
         {
-            m_guard[m_idx] = guard;
+            monster_guard_data *g_ptr = alloc_guard_data(m_idx);
+
+            /* Keep it (unless there are too many guards) */
+            if (g_ptr)
+            {
+                COPY(g_ptr, &guard, monster_guard_data);
+                g_ptr->m_idx = m_idx;
+            }
         }
 	}
 
 	/*** Success ***/
 
+	/* Build the per-level grid indexes */
+	rebuild_level_indexes();
+
 	/* The dungeon is ready */
 	character_dungeon = TRUE;
 
@@ -1550,6 +1953,8 @@ static errr rd_savefile_new_aux(void)
 	u16b tmp16u;
 	u32b tmp32u;
 
+	bool sparse = FALSE;
+
 	/* Reset error flag */
 	sf_error = FALSE;
 
@@ -1612,6 +2017,13 @@ static errr rd_savefile_new_aux(void)
 	/* Monster Memory */
 	rd_u16b(&tmp16u);
 
+	/* Only the races with any lore were saved */
+	if (!tmp16u)
+	{
+		sparse = TRUE;
+		rd_u16b(&tmp16u);
+	}
+
 	/* Incompatible save files */
 	if (tmp16u > MAX_R_IDX)
 	{
@@ -1619,16 +2031,43 @@ static errr rd_savefile_new_aux(void)
 		return (21);
 	}
 
-	/* Read the available records */
-	for (i = 0; i < tmp16u; i++)
+	if (sparse)
 	{
-		monster_race *r_ptr;
+		u16b num, r_idx;
+
+		/* The rest have the usual monster limit */
+		for (i = 0; i < MAX_R_IDX; i++)
+		{
+			monster_race *r_ptr = &r_info[i];
+
+			r_ptr->max_num = (r_ptr->flags1 & (RF1_UNIQUE)) ? 1 : 100;
+		}
+
+		rd_u16b(&num);
+
+		for (i = 0; i < num; i++)
+		{
+			rd_u16b(&r_idx);
+
+			if (r_idx >= tmp16u)
+			{
+				note(format("Invalid monster race (%u)!", r_idx));
+				return (21);
+			}
 
-		/* Read the lore */
-		rd_lore(i);
+			/* Read the lore */
+			rd_lore(r_idx);
+		}
+	}
 
-		/* Access that monster */
-		r_ptr = &r_info[i];
+	/* Read the available records */
+	else
+	{
+		for (i = 0; i < tmp16u; i++)
+		{
+			/* Read the lore */
+			rd_lore(i);
+		}
 	}
 	if (arg_fiddle)
 		note("Loaded Monster Memory");
@@ -1738,6 +2177,10 @@ static errr rd_savefile_new_aux(void)
 
 		rd_spell(rspell);
 	}
+
+	/* A new spell list */
+	forget_dynamic_spell_costs();
+
 	if (arg_fiddle)
 		note("Loaded Random Spells");
 
@@ -1818,6 +2261,9 @@ static errr rd_savefile_new_aux(void)
 	/* Hack -- no ghosts */
 	r_info[MAX_R_IDX - 1].max_num = 0;
 
+	/* The uniques have been read */
+	mon_alloc_epoch++;
+
 	/* Check for errors */
 	if (sf_error) return (26);
 
@@ -1842,9 +2288,18 @@ errr rd_savefile_new(void)
 	if (!fff)
 		return (-1);
 
+	/* Read it all at once */
+	if (!sf_mem_read(fff))
+	{
+		my_fclose(fff);
+		return (-1);
+	}
+
 	/* Call the sub-function */
 	err = rd_savefile_new_aux();
 
+	sf_mem_free();
+
 	/* Check for errors */
 	if (ferror(fff))
 		err = -1;
@@ -1865,6 +2320,9 @@ bool load_dungeon(s16b tag)
 	char temp[128];
 	char path[1024];
 
+	byte *data;
+	u32b len, size;
+
 	/* Paranoia. */
 	if (tag > 999 || tag < 0)
 		return TRUE;
@@ -1872,26 +2330,60 @@ bool load_dungeon(s16b tag)
 	sprintf(temp, "%s.%d", op_ptr->base_name, tag);
 	path_build(path, 1024, ANGBAND_DIR_SAVE, temp);
 
+	/* Try the level cache first */
+	if (level_cache_take(tag, &data, &len, &size))
+	{
+		bool err;
+
+		sf_mem = data;
+		sf_mem_pos = 0L;
+		sf_mem_len = len;
+
+		xor_byte = 0;
+		v_check = 0L;
+		x_check = 0L;
+		sf_error = FALSE;
+
+		/* Read the dungeon. */
+		err = (rd_dungeon() || sf_error);
+
+		sf_mem = NULL;
+		C_KILL(data, size, byte);
+
+		/* Delete any copy on disk. */
+		if (!err) fd_kill(path);
+
+		return (err);
+	}
+
 	fff = my_fopen(path, "rb");
 
 	if (!fff)
 		return TRUE;
 
+	/* Read it all at once */
+	if (!sf_mem_read(fff))
+	{
+		my_fclose(fff);
+		return TRUE;
+	}
+
+	/* Close the file */
+	my_fclose(fff);
+
 	xor_byte = 0;
 	v_check = 0L;
 	x_check = 0L;
 	sf_error = FALSE;
 
 	/* Read the dungeon. */
-	if (rd_dungeon())
-		return TRUE;
-
-	/* Check for errors */
-	if (ferror(fff) || sf_error)
+	if (rd_dungeon() || sf_error)
+	{
+		sf_mem_free();
 		return TRUE;
+	}
 
-	/* Close the file */
-	my_fclose(fff);
+	sf_mem_free();
 
 	/* Delete the file. */
 	fd_kill(path);
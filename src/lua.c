@@ -1,41 +1,578 @@
 /* File: lua.c */
 
 /*
- * 
+ *
  * This file defines bindings for the lua extension language.
  *
  * Note that ALL public interface between Angband and Lua is done
- * through this file. 
+ * through this file.
  *
  * First written for Angband 2.1 aka "Combustible".
+ *
+ * At startup the game runs "init.luc" from the "lua" directory, or
+ * "init.lua" if there is no "init.luc".  Either may be a chunk which
+ * "luac" has precompiled ("luac -o init.luc init.lua"), which "lua_dofile()"
+ * loads as it is, without parsing it again.  A script may define any of
+ * these functions, which the game calls:
+ *
+ *	on_turn()		every game turn
+ *	on_level_gen()		when a new level is ready
+ *	on_monster_death(m_idx)	when a monster dies (before it drops anything)
+ *
+ * The functions are looked up once, after the script has run, so a hook
+ * which the script does not define costs nothing.  Each call of a hook may
+ * run SCRIPT_STEPS lines and calls (fewer are counted for a chunk which
+ * "luac -s" stripped of its line numbers); a call which runs longer is
+ * stopped with an error, and a hook which has failed SCRIPT_STRIKES times
+ * is no longer called.  In headless games, each call is logged as an event
+ * ("script_on_turn_us" and so on), so the metrics show what the hooks cost.
+ *
+ * The script may use these functions of the game:
+ *
+ *	msg(text)			print a message
+ *	player()			y, x, depth, hit points, max hit points
+ *	feat(y, x)			the feature of a grid (nil if off the map)
+ *	set_feat(y, x, feat)		change the feature of a grid
+ *	monster_at(y, x)		the monster in a grid (0 if none, -1 the player)
+ *	monster(m_idx)			r_idx, y, x, hit points, max hit points
+ *	race_name(r_idx)		the name of a monster race
+ *	object_at(y, x)			k_idx and number of the top object in a grid
+ *	kind_name(k_idx)		the name of an object kind
+ *
+ * and these, which do a whole region in one call (so that a script which
+ * builds a room, or looks over the monsters near the player, leaves the
+ * interpreter once and not once for each grid):
+ *
+ *	fill_feat(y1, x1, y2, x2, feat)	change every grid of a rectangle,
+ *					and return how many were on the map
+ *	region(y1, x1, y2, x2)		a table of the features of a rectangle,
+ *					row by row ("t[(y-y1)*w + (x-x1) + 1]",
+ *					nil if off the map), and "w" (nothing
+ *					if it is bigger than the map)
+ *	monsters_near(y, x, rad)	a table of the monsters within "rad"
+ *					of a grid (in no order), and how many
  */
 
 #include "angband.h"
 
 #include "lua/include/lua.h"
 #include "lua/include/lualib.h"
+#include "lua/include/lauxlib.h"
+#include "lua/include/luadebug.h"
+
+#include <sys/time.h>
 
 
 /*
- * Does nothing for now.
+ * The interpreter
  */
 
 static lua_State* __lua = NULL;
 
 
+/*
+ * A hook the script may define
+ */
+typedef struct script_hook script_hook;
+
+struct script_hook
+{
+	cptr name;		/* The function */
+	cptr metric;		/* Its event in the metrics */
+
+	int ref;		/* Reference to the function, or LUA_NOREF */
+	int strikes;		/* Calls which failed */
+};
+
+
+/*
+ * The hooks (in the order of the SCRIPT_ON_* constants)
+ */
+static script_hook script_hooks[SCRIPT_HOOKS] =
+{
+	{ "on_turn", "script_on_turn_us", LUA_NOREF, 0 },
+	{ "on_level_gen", "script_on_level_gen_us", LUA_NOREF, 0 },
+	{ "on_monster_death", "script_on_monster_death_us", LUA_NOREF, 0 },
+};
+
+
+/*
+ * Lines and calls the running hook may still run
+ */
+static long script_steps = 0;
+
+
+/*
+ * Get a clock in microseconds (it wraps)
+ */
+static u32b script_usec(void)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+
+	return ((u32b)now.tv_sec * 1000000UL + (u32b)now.tv_usec);
+}
+
+
+/*
+ * Count a line or a call of the running hook, and stop it if it has run
+ * too long
+ */
+static void script_count(lua_State *L, lua_Debug *ar)
+{
+	/* Unused */
+	(void)ar;
+
+	if (--script_steps == 0) lua_error(L, "the hook ran too long");
+}
+
+
+/*
+ * Show an error of the script
+ */
+static int script_alert(lua_State *L)
+{
+	cptr str = luaL_check_string(L, 1);
+
+	if (character_dungeon) msg_print(str);
+	else plog(str);
+
+	return 0;
+}
+
+
+/*
+ * Call hook "h", with "n" arguments pushed after its function
+ */
+static void script_call(int h, int n)
+{
+	script_hook *sh = &script_hooks[h];
+	u32b began;
+	int status;
+
+	/* Count its lines and calls */
+	script_steps = SCRIPT_STEPS;
+	lua_setlinehook(__lua, script_count);
+	lua_setcallhook(__lua, script_count);
+
+	began = script_usec();
+
+	status = lua_call(__lua, n, 0);
+
+	log_metric(sh->metric, (long)(script_usec() - began));
+
+	lua_setlinehook(__lua, NULL);
+	lua_setcallhook(__lua, NULL);
+
+	/* Forget whatever is left */
+	lua_settop(__lua, 0);
+
+	/* Failed */
+	if (status && (++sh->strikes >= SCRIPT_STRIKES))
+	{
+		msg_format("The script's %s() fails too often, and is no longer called.",
+		           sh->name);
+
+		lua_unref(__lua, sh->ref);
+		sh->ref = LUA_NOREF;
+	}
+}
+
+
+/*
+ * A game turn is over
+ */
+void script_on_turn(void)
+{
+	script_hook *sh = &script_hooks[SCRIPT_ON_TURN];
+
+	if (sh->ref == LUA_NOREF) return;
+
+	lua_getref(__lua, sh->ref);
+	script_call(SCRIPT_ON_TURN, 0);
+}
+
+
+/*
+ * A new level is ready
+ */
+void script_on_level_gen(void)
+{
+	script_hook *sh = &script_hooks[SCRIPT_ON_LEVEL_GEN];
+
+	if (sh->ref == LUA_NOREF) return;
+
+	lua_getref(__lua, sh->ref);
+	script_call(SCRIPT_ON_LEVEL_GEN, 0);
+}
+
+
+/*
+ * The monster "m_idx" has died
+ */
+void script_on_monster_death(int m_idx)
+{
+	script_hook *sh = &script_hooks[SCRIPT_ON_MONSTER_DEATH];
+
+	if (sh->ref == LUA_NOREF) return;
+
+	lua_getref(__lua, sh->ref);
+	lua_pushnumber(__lua, m_idx);
+	script_call(SCRIPT_ON_MONSTER_DEATH, 1);
+}
+
+
+/*
+ * Bytes the interpreter has taken (Lua counts them in kilobytes)
+ */
+long script_memory(void)
+{
+	if (!__lua) return (0L);
+
+	return ((long)lua_getgccount(__lua) * 1024L);
+}
+
+
+/*
+ * msg(text)
+ */
+static int script_msg(lua_State *L)
+{
+	msg_print(luaL_check_string(L, 1));
+
+	return 0;
+}
+
+
+/*
+ * player() -- y, x, depth, hit points, max hit points
+ */
+static int script_player(lua_State *L)
+{
+	lua_pushnumber(L, p_ptr->py);
+	lua_pushnumber(L, p_ptr->px);
+	lua_pushnumber(L, p_ptr->depth);
+	lua_pushnumber(L, p_ptr->chp);
+	lua_pushnumber(L, p_ptr->mhp);
+
+	return 5;
+}
+
+
+/*
+ * feat(y, x)
+ */
+static int script_feat(lua_State *L)
+{
+	int y = luaL_check_int(L, 1);
+	int x = luaL_check_int(L, 2);
+
+	if (!in_bounds(y, x)) return 0;
+
+	lua_pushnumber(L, cave_feat[y][x]);
+
+	return 1;
+}
+
+
+/*
+ * set_feat(y, x, feat)
+ */
+static int script_set_feat(lua_State *L)
+{
+	int y = luaL_check_int(L, 1);
+	int x = luaL_check_int(L, 2);
+	int feat = luaL_check_int(L, 3);
+
+	if (!in_bounds(y, x)) return 0;
+	if ((feat < 0) || (feat >= MAX_F_IDX)) return 0;
+
+	cave_set_feat(y, x, feat);
+
+	return 0;
+}
+
+
+/*
+ * monster_at(y, x)
+ */
+static int script_monster_at(lua_State *L)
+{
+	int y = luaL_check_int(L, 1);
+	int x = luaL_check_int(L, 2);
+
+	if (!in_bounds(y, x)) return 0;
+
+	lua_pushnumber(L, cave_m_idx[y][x]);
+
+	return 1;
+}
+
+
+/*
+ * monster(m_idx) -- r_idx, y, x, hit points, max hit points
+ */
+static int script_monster(lua_State *L)
+{
+	int m_idx = luaL_check_int(L, 1);
+	monster_type *m_ptr;
+
+	if ((m_idx <= 0) || (m_idx >= m_max)) return 0;
+
+	m_ptr = &m_list[m_idx];
+
+	/* Dead */
+	if (!m_ptr->r_idx) return 0;
+
+	lua_pushnumber(L, m_ptr->r_idx);
+	lua_pushnumber(L, m_ptr->fy);
+	lua_pushnumber(L, m_ptr->fx);
+	lua_pushnumber(L, m_ptr->hp);
+	lua_pushnumber(L, m_ptr->maxhp);
+
+	return 5;
+}
+
+
+/*
+ * race_name(r_idx)
+ */
+static int script_race_name(lua_State *L)
+{
+	int r_idx = luaL_check_int(L, 1);
+
+	if ((r_idx <= 0) || (r_idx >= MAX_R_IDX) || !r_info[r_idx].name) return 0;
+
+	lua_pushstring(L, r_name + r_info[r_idx].name);
+
+	return 1;
+}
+
+
+/*
+ * object_at(y, x) -- k_idx, number
+ */
+static int script_object_at(lua_State *L)
+{
+	int y = luaL_check_int(L, 1);
+	int x = luaL_check_int(L, 2);
+	object_type *o_ptr;
+
+	if (!in_bounds(y, x)) return 0;
+
+	o_ptr = cave_o_idx[y][x];
+	if (!o_ptr) return 0;
+
+	lua_pushnumber(L, o_ptr->k_idx);
+	lua_pushnumber(L, o_ptr->number);
+
+	return 2;
+}
+
+
+/*
+ * kind_name(k_idx)
+ */
+static int script_kind_name(lua_State *L)
+{
+	int k_idx = luaL_check_int(L, 1);
+
+	if ((k_idx <= 0) || (k_idx >= MAX_K_IDX) || !k_info[k_idx].name) return 0;
+
+	lua_pushstring(L, k_name + k_info[k_idx].name);
+
+	return 1;
+}
+
+
+/*
+ * Get the rectangle (y1,x1)-(y2,x2) from the first four arguments, with
+ * the corners in order
+ */
+static void script_rect(lua_State *L, int *y1, int *x1, int *y2, int *x2)
+{
+	int t;
+
+	*y1 = luaL_check_int(L, 1);
+	*x1 = luaL_check_int(L, 2);
+	*y2 = luaL_check_int(L, 3);
+	*x2 = luaL_check_int(L, 4);
+
+	if (*y1 > *y2) { t = *y1; *y1 = *y2; *y2 = t; }
+	if (*x1 > *x2) { t = *x1; *x1 = *x2; *x2 = t; }
+}
+
+
+/*
+ * fill_feat(y1, x1, y2, x2, feat)
+ */
+static int script_fill_feat(lua_State *L)
+{
+	int y1, x1, y2, x2, y, x;
+	int feat = luaL_check_int(L, 5);
+	int n = 0;
+
+	script_rect(L, &y1, &x1, &y2, &x2);
+
+	if ((feat < 0) || (feat >= MAX_F_IDX)) return 0;
+
+	/* Only the part on the map */
+	y1 = MAX(y1, 0);
+	x1 = MAX(x1, 0);
+	y2 = MIN(y2, DUNGEON_HGT - 1);
+	x2 = MIN(x2, DUNGEON_WID - 1);
+
+	for (y = y1; y <= y2; y++)
+	{
+		for (x = x1; x <= x2; x++)
+		{
+			cave_set_feat(y, x, feat);
+			n++;
+		}
+	}
+
+	lua_pushnumber(L, n);
+
+	return 1;
+}
+
+
+/*
+ * region(y1, x1, y2, x2) -- table, width
+ */
+static int script_region(lua_State *L)
+{
+	int y1, x1, y2, x2, y, x, w;
+	int ya, xa, yb, xb;
+
+	script_rect(L, &y1, &x1, &y2, &x2);
+
+	w = x2 - x1 + 1;
+
+	/* No bigger than the map */
+	if ((w > DUNGEON_WID) || (y2 - y1 >= DUNGEON_HGT)) return 0;
+
+	/* Only the part on the map */
+	ya = MAX(y1, 0);
+	xa = MAX(x1, 0);
+	yb = MIN(y2, DUNGEON_HGT - 1);
+	xb = MIN(x2, DUNGEON_WID - 1);
+
+	lua_newtable(L);
+
+	for (y = ya; y <= yb; y++)
+	{
+		for (x = xa; x <= xb; x++)
+		{
+			lua_pushnumber(L, cave_feat[y][x]);
+			lua_rawseti(L, -2, (y - y1) * w + (x - x1) + 1);
+		}
+	}
+
+	lua_pushnumber(L, w);
+
+	return 2;
+}
+
+
+/*
+ * monsters_near(y, x, rad) -- table, number
+ */
+static int script_monsters_near(lua_State *L)
+{
+	static s16b who[MAX_M_IDX];
+
+	int y = luaL_check_int(L, 1);
+	int x = luaL_check_int(L, 2);
+	int rad = luaL_check_int(L, 3);
+	int i, n;
+
+	if (!in_bounds(y, x) || (rad < 0)) return 0;
+
+	/* Use the bucket grid */
+	n = monster_near(y, x, rad, who, MAX_M_IDX);
+
+	lua_newtable(L);
+
+	for (i = 0; i < n; i++)
+	{
+		lua_pushnumber(L, who[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	lua_pushnumber(L, n);
+
+	return 2;
+}
+
+
 /*
  * Register the Angband->Lua public interface.
  */
 
 static void lua_anglibopen(lua_State* lua) {
-  /* We do nothing for now. */
+
+  /* Errors go to the message line */
+  lua_register(lua, LUA_ALERT, script_alert);
+
+  lua_register(lua, "msg", script_msg);
+  lua_register(lua, "player", script_player);
+  lua_register(lua, "feat", script_feat);
+  lua_register(lua, "set_feat", script_set_feat);
+  lua_register(lua, "monster_at", script_monster_at);
+  lua_register(lua, "monster", script_monster);
+  lua_register(lua, "race_name", script_race_name);
+  lua_register(lua, "object_at", script_object_at);
+  lua_register(lua, "kind_name", script_kind_name);
+  lua_register(lua, "fill_feat", script_fill_feat);
+  lua_register(lua, "region", script_region);
+  lua_register(lua, "monsters_near", script_monsters_near);
+}
+
+
+/*
+ * Run the script, if there is one, and find its hooks.
+ */
+
+static void script_load(lua_State* lua) {
+
+  char buf[1024];
+  FILE *fp;
+  int h;
+
+  /* A precompiled chunk, or the source */
+  path_build(buf, 1024, ANGBAND_DIR_LUA, "init.luc");
+  fp = my_fopen(buf, "rb");
+
+  if (!fp) {
+    path_build(buf, 1024, ANGBAND_DIR_LUA, "init.lua");
+    fp = my_fopen(buf, "rb");
+  }
+
+  /* No script */
+  if (!fp) return;
+  my_fclose(fp);
+
+  if (lua_dofile(lua, buf)) {
+    plog_fmt("Cannot run the script '%s'.", buf);
+    return;
+  }
+
+  /* Keep the functions it defined */
+  for (h = 0; h < SCRIPT_HOOKS; h++) {
+    lua_getglobal(lua, script_hooks[h].name);
+
+    if (lua_isfunction(lua, -1)) script_hooks[h].ref = lua_ref(lua, 1);
+    else lua_pop(lua, 1);
+  }
 }
 
 
 errr init_lua(void) {
 
-  /* 
-   * Start the interpreter. 
+  /*
+   * Start the interpreter.
    * The argument is the stack size, 0 means default.
    */
   __lua = lua_open(0);
@@ -48,5 +585,7 @@ errr init_lua(void) {
 
   lua_anglibopen(__lua);
 
+  script_load(__lua);
+
   return 0;
 }
@@ -228,6 +228,11 @@ static int can_fix_color = FALSE;
  */
 static int colortable[16];
 
+/*
+ * The color last given to "attrset()" (or -1)
+ */
+static int current_color = -1;
+
 #endif
 
 
@@ -755,7 +760,7 @@ static errr Term_wipe_gcu(int x, int y, int n)
 	move(y, x);
 
 	/* Clear to end of line */
-	if (x + n >= 80)
+	if (x + n >= Term->wid)
 	{
 		clrtoeol();
 	}
@@ -780,24 +785,20 @@ static errr Term_wipe_gcu(int x, int y, int n)
  */
 static errr Term_text_gcu(int x, int y, int n, byte a, cptr s)
 {
-	int i;
-
-	char text[81];
-
-	/* Obtain a copy of the text */
-	for (i = 0; i < n; i++) text[i] = s[i];
-	text[n] = 0;
-
-	/* Move the cursor and dump the string */
+	/* Move the cursor */
 	move(y, x);
 
 #ifdef A_COLOR
-	/* Set the color */
-	if (can_use_color) attrset(colortable[a & 0x0F]);
+	/* Set the color, if it changed */
+	if (can_use_color && (current_color != (a & 0x0F)))
+	{
+		current_color = (a & 0x0F);
+		attrset(colortable[current_color]);
+	}
 #endif
 
-	/* Add the text */
-	addstr(text);
+	/* Add the text (curses sends the changes at the next refresh) */
+	addnstr(s, n);
 
 	/* Success */
 	return (0);
@@ -619,6 +619,55 @@ errr load_HEX_font_sdl(font_data *fd, cptr filename, bool justmetrics)
 	return fail;
 }
 
+
+/*
+ * Turn a loaded font into a glyph atlas: the font drawn once in each of
+ * the 16 text colors, side by side (so the glyph for attr "a" and char
+ * "c" is at x = a * w, y = c * h).  Drawing a glyph is then one plain
+ * blit, instead of a palette change and a blit (see "SDL_DrawChar()").
+ *
+ * The background is keyed out exactly as in the 8-bit font.  Pure
+ * magenta is used as the key since no text color can be pure magenta.
+ */
+static errr SDL_PrecolorizeFont(font_data *fd)
+{
+	SDL_Surface *atlas;
+	SDL_Rect dr;
+	Uint32 key;
+	int a;
+
+	if (!fd->face || fd->precolorized) return -1;
+
+	atlas = SDL_CreateRGBSurface(SDL_SWSURFACE, 16 * fd->w, fd->face->h, 32,
+		0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+	if (!atlas) return -1;
+
+	key = SDL_MapRGB(atlas->format, 255, 0, 255);
+	SDL_FillRect(atlas, NULL, key);
+
+	/* Draw the font in each color */
+	for (a = 0; a < 16; a++)
+	{
+		SDL_SetColors(fd->face, &(color_data_sdl[a]), 0xff, 1);
+
+		dr.x = a * fd->w;
+		dr.y = 0;
+		dr.w = fd->w;
+		dr.h = fd->face->h;
+
+		SDL_BlitSurface(fd->face, NULL, atlas, &dr);
+	}
+
+	SDL_SetColorKey(atlas, SDL_SRCCOLORKEY | SDL_RLEACCEL, key);
+
+	/* Use the atlas from now on */
+	SDL_FreeSurface(fd->face);
+	fd->face = atlas;
+	fd->precolorized = 1;
+
+	return 0;
+}
+
 		
 
 
@@ -1256,7 +1305,7 @@ inline static errr SDL_DrawChar (SDL_Surface *f, Uint32 x, Uint32 y, font_data *
 
 	if (fd->precolorized)
 	{
-		sr.x = a * fd->w;
+		sr.x = (a & 0xf) * fd->w;
 	} else
 	{
 		/* XXX Force SDL, or whatever it wraps, to make the text the color we want
@@ -1396,6 +1445,8 @@ static errr Term_pict_sdl(int x, int y, int n,  const byte *ap, const char *cp)
 		{
 			Term_tile_sdl(x, y, *ap, *cp); /* draw a graphical tile */
 		} 
+
+		++x; ++ap; ++cp;
 	}
 
 	/* Success */
@@ -1937,6 +1988,9 @@ errr init_sdl(int oargc, char **oargv)
 		return -1;
 	}
 
+	/* Build the glyph atlas (or keep recoloring the plain font) */
+	(void)SDL_PrecolorizeFont(&screen_font);
+
 
 	path_build(path, 1023, ANGBAND_DIR_XTRA, tilebmpname);
 
@@ -0,0 +1,656 @@
+/* File: main-spc.c */
+
+/*
+ * Spectator streams and recordings of the main term
+ *
+ * A spectator stream ("--spectate") gives the term of a headless game
+ * hooks which write what "Term_fresh()" changes, and nothing else, to a
+ * file, a FIFO, or a Unix socket.  Any number of viewers can follow a
+ * file with "tail -f"; a socket or FIFO feeds one.
+ *
+ * A recording ("--record") wraps the hooks of the main term of whatever
+ * display module is in use, and writes the same changes to a file before
+ * passing them on.  It is written in large batches, rather than once per
+ * frame, so it costs next to nothing to leave on.  "--replay" plays a
+ * recording (or a saved stream) back, at the speed it was made.
+ *
+ * Both start with "KSPC", a version byte (2), and the width and height
+ * of the term.  Then come records, each an opcode byte and its operands
+ * (all bytes, except those of 'F'):
+ *
+ *	'K' a0 c0 a1 c1 ...	keyframe, every grid in row order
+ *	'T' x y n a c0..cn-1	text, "n" chars of attr "a" from (x,y)
+ *	'W' x y n		erase "n" grids from (x,y)
+ *	'E'			erase the whole term
+ *	'C' x y			the cursor is at (x,y)
+ *	'F' t0..t3 m0..m3	end of frame, with the game turn and the
+ *				milliseconds since the start (LSB first)
+ *
+ * A keyframe is sent every SPC_KEY_FRAMES frames, so a viewer joining
+ * late only has to wait for the next one.
+ *
+ * Writing never blocks the game.  If a reader falls behind, frames are
+ * dropped until it catches up, and then a keyframe is sent.  A reader
+ * which goes away is not an error ("main()" ignores SIGPIPE).
+ */
+
+#include "angband.h"
+
+
+#ifdef SET_UID
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#endif /* SET_UID */
+
+
+/*
+ * Frames between keyframes
+ */
+#define SPC_KEY_FRAMES	256
+
+/*
+ * Size of the buffer of a stream (a frame which does not fit becomes a
+ * keyframe)
+ */
+#define SPC_BUF_SIZE	65536
+
+/*
+ * A recording is written once this much is waiting, or once the oldest
+ * frame has waited this many milliseconds
+ */
+#define SPC_BATCH_SIZE	(SPC_BUF_SIZE / 2)
+#define SPC_BATCH_MSEC	1000
+
+
+/*
+ * An output stream.
+ *
+ * The buffer holds the complete frames which have not been written yet,
+ * up to "start", followed by the frame being built, up to "len".
+ */
+typedef struct spc_stream spc_stream;
+
+struct spc_stream
+{
+	int fd;			/* Where it goes */
+
+	bool batch;		/* Wait for a batch of frames */
+
+	byte buf[SPC_BUF_SIZE];
+	int start;
+	int len;
+
+	int frames;		/* Frames since the last keyframe */
+	bool need_key;		/* A keyframe is needed now */
+
+	u32b begun;		/* When the stream was opened */
+	u32b written;		/* When it was last written */
+};
+
+
+/*
+ * The spectator stream, and the recording
+ */
+static spc_stream spc_live;
+static spc_stream spc_rec;
+
+/*
+ * The hooks of the recorded term, which the recording hands things on to
+ */
+static errr (*rec_xtra_hook)(int n, int v);
+static errr (*rec_curs_hook)(int x, int y);
+static errr (*rec_wipe_hook)(int x, int y, int n);
+static errr (*rec_text_hook)(int x, int y, int n, byte a, const term_char *s);
+static errr (*rec_pict_hook)(int x, int y, int n, const byte *ap,
+	const term_char *cp);
+
+
+/*
+ * Add a byte to the frame being built
+ */
+static void spc_byte(spc_stream *sp, int b)
+{
+	/* Too much -- send a keyframe instead */
+	if (sp->len >= SPC_BUF_SIZE)
+	{
+		sp->need_key = TRUE;
+		return;
+	}
+
+	sp->buf[sp->len++] = (byte)(b);
+}
+
+
+/*
+ * Write as many of the complete frames as the reader takes right now
+ */
+static void spc_send(spc_stream *sp)
+{
+	int done = 0;
+
+	while (done < sp->start)
+	{
+		int n = write(sp->fd, sp->buf + done, sp->start - done);
+
+		/* Reader is full (or gone) */
+		if (n <= 0) break;
+
+		done += n;
+	}
+
+	/* Keep the rest */
+	memmove(sp->buf, sp->buf + done, sp->len - done);
+	sp->start -= done;
+	sp->len -= done;
+
+	sp->written = msec_clock();
+}
+
+
+/*
+ * Build a keyframe from the whole term, replacing the frame so far
+ */
+static void spc_keyframe(spc_stream *sp)
+{
+	term_win *scr = Term->scr;
+	int x, y;
+
+	sp->len = sp->start;
+	sp->need_key = FALSE;
+	sp->frames = 0;
+
+	spc_byte(sp, 'K');
+
+	for (y = 0; y < Term->hgt; y++)
+	{
+		for (x = 0; x < Term->wid; x++)
+		{
+			spc_byte(sp, scr->a[y][x]);
+			spc_byte(sp, (byte)(scr->c[y][x]));
+		}
+	}
+}
+
+
+/*
+ * Finish a frame, and send it (a recording may wait for more)
+ */
+static void spc_frame(spc_stream *sp)
+{
+	u32b now = msec_clock();
+	u32b msec = now - sp->begun;
+
+	/* Room for a keyframe and the end of frame */
+	int need = 1 + 2 * Term->wid * Term->hgt + 9;
+
+	/* Make room if the last frames are still waiting */
+	if (sp->start + need > SPC_BUF_SIZE) spc_send(sp);
+
+	/* Still behind -- drop this frame */
+	if (sp->start + need > SPC_BUF_SIZE)
+	{
+		sp->len = sp->start;
+		sp->need_key = TRUE;
+		return;
+	}
+
+	/* Time for a keyframe */
+	if (sp->need_key || (++sp->frames >= SPC_KEY_FRAMES)) spc_keyframe(sp);
+
+	/* End of frame */
+	spc_byte(sp, 'F');
+	spc_byte(sp, turn & 0xFF);
+	spc_byte(sp, (turn >> 8) & 0xFF);
+	spc_byte(sp, (turn >> 16) & 0xFF);
+	spc_byte(sp, (turn >> 24) & 0xFF);
+	spc_byte(sp, msec & 0xFF);
+	spc_byte(sp, (msec >> 8) & 0xFF);
+	spc_byte(sp, (msec >> 16) & 0xFF);
+	spc_byte(sp, (msec >> 24) & 0xFF);
+
+	/* The frame is complete */
+	sp->start = sp->len;
+
+	/* A recording waits for a batch */
+	if (sp->batch && (sp->start < SPC_BATCH_SIZE) &&
+	    (now - sp->written < SPC_BATCH_MSEC)) return;
+
+	spc_send(sp);
+}
+
+
+/*
+ * Note some text
+ */
+static void spc_text(spc_stream *sp, int x, int y, int n, byte a,
+	const term_char *s)
+{
+	int i;
+
+	spc_byte(sp, 'T');
+	spc_byte(sp, x);
+	spc_byte(sp, y);
+	spc_byte(sp, n);
+	spc_byte(sp, a);
+
+	for (i = 0; i < n; i++) spc_byte(sp, (byte)(s[i]));
+}
+
+
+/*
+ * Handle a "special request"
+ */
+static void spc_xtra(spc_stream *sp, int n)
+{
+	switch (n)
+	{
+		/* Send the frame */
+		case TERM_XTRA_FRESH: spc_frame(sp); break;
+
+		/* Clear the screen */
+		case TERM_XTRA_CLEAR: spc_byte(sp, 'E'); break;
+	}
+}
+
+
+/*
+ * Note the cursor
+ */
+static void spc_curs(spc_stream *sp, int x, int y)
+{
+	spc_byte(sp, 'C');
+	spc_byte(sp, x);
+	spc_byte(sp, y);
+}
+
+
+/*
+ * Note some erased characters
+ */
+static void spc_wipe(spc_stream *sp, int x, int y, int n)
+{
+	spc_byte(sp, 'W');
+	spc_byte(sp, x);
+	spc_byte(sp, y);
+	spc_byte(sp, n);
+}
+
+
+/*
+ * Note some "pictures" (as text, one grid at a time)
+ */
+static void spc_pict(spc_stream *sp, int x, int y, int n, const byte *ap,
+	const term_char *cp)
+{
+	int i;
+
+	for (i = 0; i < n; i++) spc_text(sp, x + i, y, 1, ap[i], &cp[i]);
+}
+
+
+/*
+ * Open a stream for the term "t": a Unix socket if "path" is one, else
+ * a file (or FIFO) to append to
+ */
+static errr spc_open(spc_stream *sp, term *t, cptr path, bool batch)
+{
+	int fd = -1;
+
+	byte head[7];
+
+#ifdef SET_UID
+
+	struct stat st;
+
+	if ((stat(path, &st) == 0) && S_ISSOCK(st.st_mode))
+	{
+		struct sockaddr_un addr;
+
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0) return (-1);
+
+		WIPE(&addr, struct sockaddr_un);
+		addr.sun_family = AF_UNIX;
+		strnfmt(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+
+		if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		{
+			close(fd);
+			return (-1);
+		}
+	}
+	else
+	{
+		/* Do not wait for a FIFO reader */
+		fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_NONBLOCK, 0644);
+		if (fd < 0) return (-1);
+	}
+
+	/* Never block the game */
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+#endif /* SET_UID */
+
+	if (fd < 0) return (-1);
+
+	WIPE(sp, spc_stream);
+	sp->fd = fd;
+	sp->batch = batch;
+	sp->need_key = TRUE;
+	sp->begun = sp->written = msec_clock();
+
+	/* Header */
+	head[0] = 'K';
+	head[1] = 'S';
+	head[2] = 'P';
+	head[3] = 'C';
+	head[4] = 2;
+	head[5] = t->wid;
+	head[6] = t->hgt;
+
+	if (write(fd, head, 7) < 7)
+	{
+		close(fd);
+		sp->fd = -1;
+		return (-1);
+	}
+
+	return (0);
+}
+
+
+/*
+ * Hooks for the spectator stream, which draws nothing itself
+ */
+static errr Term_xtra_spc(int n, int v)
+{
+	/* Unused */
+	(void)v;
+
+	spc_xtra(&spc_live, n);
+	return (0);
+}
+
+static errr Term_curs_spc(int x, int y)
+{
+	spc_curs(&spc_live, x, y);
+	return (0);
+}
+
+static errr Term_wipe_spc(int x, int y, int n)
+{
+	spc_wipe(&spc_live, x, y, n);
+	return (0);
+}
+
+static errr Term_text_spc(int x, int y, int n, byte a, const term_char *s)
+{
+	spc_text(&spc_live, x, y, n, a, s);
+	return (0);
+}
+
+static errr Term_pict_spc(int x, int y, int n, const byte *ap,
+	const term_char *cp)
+{
+	spc_pict(&spc_live, x, y, n, ap, cp);
+	return (0);
+}
+
+
+/*
+ * Stream the (headless) term "t" to "path"
+ */
+errr init_spc(term *t, cptr path)
+{
+	if (spc_open(&spc_live, t, path, FALSE))
+	{
+		plog_fmt("Cannot open spectator stream '%s'.", path);
+		return (-1);
+	}
+
+	/* Hooks */
+	t->xtra_hook = Term_xtra_spc;
+	t->curs_hook = Term_curs_spc;
+	t->wipe_hook = Term_wipe_spc;
+	t->text_hook = Term_text_spc;
+	t->pict_hook = Term_pict_spc;
+
+	return (0);
+}
+
+
+/*
+ * Hooks for the recording, which hand everything on
+ */
+static errr Term_xtra_rec(int n, int v)
+{
+	spc_xtra(&spc_rec, n);
+	return ((*rec_xtra_hook)(n, v));
+}
+
+static errr Term_curs_rec(int x, int y)
+{
+	spc_curs(&spc_rec, x, y);
+	return ((*rec_curs_hook)(x, y));
+}
+
+static errr Term_wipe_rec(int x, int y, int n)
+{
+	spc_wipe(&spc_rec, x, y, n);
+	return ((*rec_wipe_hook)(x, y, n));
+}
+
+static errr Term_text_rec(int x, int y, int n, byte a, const term_char *s)
+{
+	spc_text(&spc_rec, x, y, n, a, s);
+	return ((*rec_text_hook)(x, y, n, a, s));
+}
+
+static errr Term_pict_rec(int x, int y, int n, const byte *ap,
+	const term_char *cp)
+{
+	spc_pict(&spc_rec, x, y, n, ap, cp);
+	return ((*rec_pict_hook)(x, y, n, ap, cp));
+}
+
+
+/*
+ * Write out the rest of the recording at exit (the signal handlers get
+ * here too, through "quit()")
+ */
+static void spc_rec_close(void)
+{
+	if (spc_rec.fd < 0) return;
+
+	spc_send(&spc_rec);
+
+	close(spc_rec.fd);
+	spc_rec.fd = -1;
+}
+
+
+/*
+ * Record the term "t" into "path"
+ */
+errr init_rec(term *t, cptr path)
+{
+	if (spc_open(&spc_rec, t, path, TRUE))
+	{
+		plog_fmt("Cannot open recording '%s'.", path);
+		return (-1);
+	}
+
+	/* Write the rest at exit */
+	atexit(spc_rec_close);
+
+	/* Wrap the hooks */
+	rec_xtra_hook = t->xtra_hook;
+	rec_curs_hook = t->curs_hook;
+	rec_wipe_hook = t->wipe_hook;
+	rec_text_hook = t->text_hook;
+	rec_pict_hook = t->pict_hook;
+
+	t->xtra_hook = Term_xtra_rec;
+	t->curs_hook = Term_curs_rec;
+	t->wipe_hook = Term_wipe_rec;
+	t->text_hook = Term_text_rec;
+	if (t->pict_hook) t->pict_hook = Term_pict_rec;
+
+	return (0);
+}
+
+
+/*
+ * Extract a number from a recording (LSB first)
+ */
+static u32b spc_u32b(const byte *p)
+{
+	return ((u32b)p[0] | ((u32b)p[1] << 8) |
+	        ((u32b)p[2] << 16) | ((u32b)p[3] << 24));
+}
+
+
+/*
+ * Play the recording "path" on the active term, and quit.
+ *
+ * Pauses longer than a second are cut short.  Escape (or 'q') stops.
+ */
+void spc_replay(cptr path)
+{
+	FILE *fff;
+
+	byte *buf;
+	long size, i;
+
+	int wid, hgt;
+
+	u32b last = 0;
+
+	char ch;
+
+
+	/* Read it all */
+	fff = my_fopen(path, "rb");
+	if (!fff) quit_fmt("Cannot open recording '%s'.", path);
+
+	fseek(fff, 0L, SEEK_END);
+	size = ftell(fff);
+	fseek(fff, 0L, SEEK_SET);
+
+	if (size < 7) quit_fmt("'%s' is not a recording.", path);
+
+	C_MAKE(buf, size, byte);
+
+	if ((fread(buf, 1, size, fff) != (size_t)size) ||
+	    strncmp((char*)buf, "KSPC", 4) || (buf[4] != 2))
+	{
+		quit_fmt("'%s' is not a recording.", path);
+	}
+
+	my_fclose(fff);
+
+	wid = buf[5];
+	hgt = buf[6];
+
+	Term_clear();
+
+	for (i = 7; i < size; )
+	{
+		int op = buf[i++];
+
+		/* Truncated (the game was killed) */
+		if ((op == 'K') && (i + 2 * wid * hgt > size)) break;
+		if ((op == 'T') && ((i + 4 > size) || (i + 4 + buf[i + 2] > size))) break;
+		if ((op == 'W') && (i + 3 > size)) break;
+		if ((op == 'C') && (i + 2 > size)) break;
+		if ((op == 'F') && (i + 8 > size)) break;
+
+		switch (op)
+		{
+			case 'K':
+			{
+				int x, y;
+
+				for (y = 0; y < hgt; y++)
+				{
+					for (x = 0; x < wid; x++)
+					{
+						Term_queue_char(x, y, buf[i], buf[i + 1]);
+						i += 2;
+					}
+				}
+
+				break;
+			}
+
+			case 'T':
+			{
+				Term_queue_chars(buf[i], buf[i + 1], buf[i + 2], buf[i + 3],
+				                 (cptr)(buf + i + 4));
+				i += 4 + buf[i + 2];
+				break;
+			}
+
+			case 'W':
+			{
+				Term_erase(buf[i], buf[i + 1], buf[i + 2]);
+				i += 3;
+				break;
+			}
+
+			case 'E':
+			{
+				Term_clear();
+				break;
+			}
+
+			case 'C':
+			{
+				Term_gotoxy(buf[i], buf[i + 1]);
+				i += 2;
+				break;
+			}
+
+			case 'F':
+			{
+				u32b msec = spc_u32b(buf + i + 4);
+				long d = (long)(msec - last);
+
+				i += 8;
+
+				/* Wait as long as the game did, within reason */
+				if (last && (d > 0)) Term_xtra(TERM_XTRA_DELAY, MIN(d, 1000));
+				last = msec;
+
+				Term_fresh();
+
+				/* Stop on request */
+				if ((0 == Term_inkey(&ch, FALSE, TRUE)) &&
+				    ((ch == ESCAPE) || (ch == 'q')))
+				{
+					i = size;
+				}
+
+				break;
+			}
+
+			/* Broken */
+			default:
+			{
+				i = size;
+				break;
+			}
+		}
+	}
+
+	C_KILL(buf, size, byte);
+
+	/* Wait for a key */
+	Term_putstr(0, hgt - 1, -1, TERM_WHITE, "[End of recording -- press any key]");
+	Term_fresh();
+	(void)Term_inkey(&ch, TRUE, TRUE);
+
+	quit(NULL);
+}
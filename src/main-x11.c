@@ -49,6 +49,11 @@
 #include <X11/Xutil.h>
 #include <X11/keysym.h>
 #include <X11/keysymdef.h>
+#ifdef USE_XSHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+#endif /* USE_XSHM */
 #endif /* __MAKEDEPEND__ */
 
 
@@ -1725,6 +1730,24 @@ struct term_data
 
 #endif
 
+	/* The client-side framebuffer, if any (see "fb_init()") */
+	XImage *fb;
+
+	/* The glyph masks (one byte per pixel, "wid * hgt" per char) */
+	byte *glyphs;
+
+	/* The dirty rectangle of the framebuffer, in pixels */
+	int fb_x1, fb_y1, fb_x2, fb_y2;
+
+#ifdef USE_XSHM
+
+	/* The shared memory segment behind the framebuffer */
+	XShmSegmentInfo shm;
+
+	bool use_shm;
+
+#endif /* USE_XSHM */
+
 };
 
 
@@ -1739,6 +1762,418 @@ struct term_data
 static term_data data[MAX_TERM_DATA];
 
 
+/*
+ * Draw into client-side framebuffers (the "-b" option)
+ *
+ * Instead of one request per text run, every term keeps an "XImage" of
+ * its window, the hooks below draw into it from a cache of glyph masks,
+ * and only the rectangle which changed is sent to the server, once per
+ * "Term_fresh()".  This is much faster over a remote display.  With the
+ * MIT-SHM extension (see "USE_XSHM") a local server reads the image
+ * straight out of shared memory.
+ */
+static bool fb_mode = FALSE;
+
+
+#ifdef USE_XSHM
+
+/*
+ * Set if attaching a shared memory segment failed
+ */
+static bool fb_shm_failed;
+
+/*
+ * Catch the error a remote server gives for "XShmAttach()"
+ */
+static int fb_shm_error(Display *dpy, XErrorEvent *ev)
+{
+	/* Unused */
+	(void)dpy;
+	(void)ev;
+
+	fb_shm_failed = TRUE;
+
+	return (0);
+}
+
+
+/*
+ * Try to create a framebuffer in shared memory
+ */
+static XImage *fb_make_shm(term_data *td, int w, int h)
+{
+	Display *dpy = Metadpy->dpy;
+	XImage *img;
+	int (*old_handler)(Display *, XErrorEvent *);
+
+	if (!XShmQueryExtension(dpy)) return (NULL);
+
+	img = XShmCreateImage(dpy, DefaultVisualOfScreen(Metadpy->screen),
+	                      Metadpy->depth, ZPixmap, NULL, &td->shm, w, h);
+	if (!img) return (NULL);
+
+	td->shm.shmid = shmget(IPC_PRIVATE, img->bytes_per_line * h,
+	                       IPC_CREAT | 0600);
+	if (td->shm.shmid < 0)
+	{
+		XDestroyImage(img);
+		return (NULL);
+	}
+
+	td->shm.shmaddr = img->data = shmat(td->shm.shmid, NULL, 0);
+	td->shm.readOnly = False;
+
+	/* Attach, and wait to hear if it worked */
+	fb_shm_failed = (img->data == (char*)(-1));
+	if (!fb_shm_failed)
+	{
+		old_handler = XSetErrorHandler(fb_shm_error);
+		XShmAttach(dpy, &td->shm);
+		XSync(dpy, False);
+		XSetErrorHandler(old_handler);
+	}
+
+	/* The segment goes away once both sides are done with it */
+	shmctl(td->shm.shmid, IPC_RMID, NULL);
+
+	if (fb_shm_failed)
+	{
+		if (img->data != (char*)(-1)) shmdt(img->data);
+		img->data = NULL;
+		XDestroyImage(img);
+		return (NULL);
+	}
+
+	td->use_shm = TRUE;
+
+	return (img);
+}
+
+#endif /* USE_XSHM */
+
+
+/*
+ * Note that a rectangle (in pixels) of a framebuffer has changed
+ */
+static void fb_dirty(term_data *td, int x, int y, int w, int h)
+{
+	if (x < td->fb_x1) td->fb_x1 = x;
+	if (y < td->fb_y1) td->fb_y1 = y;
+	if (x + w > td->fb_x2) td->fb_x2 = x + w;
+	if (y + h > td->fb_y2) td->fb_y2 = y + h;
+}
+
+
+/*
+ * Send the dirty rectangle of a framebuffer to its window
+ */
+static void fb_flush(term_data *td)
+{
+	int w, h;
+
+	/* Clip to the image */
+	if (td->fb_x1 < 0) td->fb_x1 = 0;
+	if (td->fb_y1 < 0) td->fb_y1 = 0;
+	if (td->fb_x2 > td->fb->width) td->fb_x2 = td->fb->width;
+	if (td->fb_y2 > td->fb->height) td->fb_y2 = td->fb->height;
+
+	w = td->fb_x2 - td->fb_x1;
+	h = td->fb_y2 - td->fb_y1;
+
+	/* Something changed */
+	if ((w > 0) && (h > 0))
+	{
+#ifdef USE_XSHM
+		if (td->use_shm)
+		{
+			XShmPutImage(Metadpy->dpy, td->inner->win, clr[0]->gc, td->fb,
+			             td->fb_x1, td->fb_y1, td->fb_x1, td->fb_y1,
+			             w, h, False);
+		}
+		else
+#endif /* USE_XSHM */
+		{
+			XPutImage(Metadpy->dpy, td->inner->win, clr[0]->gc, td->fb,
+			          td->fb_x1, td->fb_y1, td->fb_x1, td->fb_y1, w, h);
+		}
+	}
+
+	/* Nothing is dirty */
+	td->fb_x1 = td->fb->width;
+	td->fb_y1 = td->fb->height;
+	td->fb_x2 = 0;
+	td->fb_y2 = 0;
+}
+
+
+/*
+ * Fill a rectangle (in pixels) of a framebuffer
+ */
+static void fb_fill(term_data *td, int x, int y, int w, int h, Pixell p)
+{
+	XImage *img = td->fb;
+	int i, j;
+
+	/* Clip to the image */
+	if (x + w > img->width) w = img->width - x;
+	if (y + h > img->height) h = img->height - y;
+	if ((w <= 0) || (h <= 0)) return;
+
+	for (j = y; j < y + h; j++)
+	{
+		/* Common case -- 32 bits per pixel */
+		if (img->bits_per_pixel == 32)
+		{
+			u32b *row = (u32b*)(img->data + j * img->bytes_per_line) + x;
+
+			for (i = 0; i < w; i++) row[i] = p;
+		}
+		else
+		{
+			for (i = x; i < x + w; i++) XPutPixel(img, i, j, p);
+		}
+	}
+
+	fb_dirty(td, x, y, w, h);
+}
+
+
+/*
+ * Draw some text into a framebuffer
+ */
+static void fb_text(term_data *td, int x, int y, int n, byte a, cptr s)
+{
+	XImage *img = td->fb;
+	int wid = td->fnt->wid;
+	int hgt = td->fnt->hgt;
+	Pixell fg = clr[a]->fg;
+	Pixell bg = clr[a]->bg;
+	int k, i, j;
+
+	x *= wid;
+	y *= hgt;
+
+	/* Clip to the image */
+	if (y + hgt > img->height) return;
+	if (x + n * wid > img->width) n = (img->width - x) / wid;
+	if (n <= 0) return;
+
+	for (k = 0; k < n; k++)
+	{
+		byte *g = td->glyphs + (byte)(s[k]) * wid * hgt;
+		int px = x + k * wid;
+
+		for (j = 0; j < hgt; j++, g += wid)
+		{
+			/* Common case -- 32 bits per pixel */
+			if (img->bits_per_pixel == 32)
+			{
+				u32b *row = (u32b*)(img->data + (y + j) * img->bytes_per_line) + px;
+
+				for (i = 0; i < wid; i++) row[i] = (g[i] ? fg : bg);
+			}
+			else
+			{
+				for (i = 0; i < wid; i++)
+				{
+					XPutPixel(img, px + i, y + j, (g[i] ? fg : bg));
+				}
+			}
+		}
+	}
+
+	fb_dirty(td, x, y, n * wid, hgt);
+}
+
+
+/*
+ * Hilite a grid of a framebuffer (as the "xor" color does)
+ */
+static void fb_curs(term_data *td, int x, int y)
+{
+	XImage *img = td->fb;
+	int wid = td->fnt->wid;
+	int hgt = td->fnt->hgt;
+	Pixell mask = (xor->bg ^ xor->fg);
+	int i, j;
+
+	x *= wid;
+	y *= hgt;
+
+	/* Clip to the image */
+	if ((x + wid > img->width) || (y + hgt > img->height)) return;
+
+	for (j = y; j < y + hgt; j++)
+	{
+		for (i = x; i < x + wid; i++)
+		{
+			XPutPixel(img, i, j, XGetPixel(img, i, j) ^ mask);
+		}
+	}
+
+	fb_dirty(td, x, y, wid, hgt);
+}
+
+
+#ifdef USE_GRAPHICS
+
+/*
+ * Draw a graphical tile into a framebuffer
+ */
+static void fb_pict(term_data *td, int x, int y, byte a, char c)
+{
+	XImage *img = td->fb;
+	int wid = td->fnt->wid;
+	int hgt = td->fnt->hgt;
+	int sx = (c & 0x7F) * wid + 1;
+	int sy = (a & 0x7F) * hgt + 1;
+	int i, j;
+
+	x *= wid;
+	y *= hgt;
+
+	/* Clip to the image and the tiles */
+	if ((x + wid > img->width) || (y + hgt > img->height)) return;
+	if ((sx + wid > td->tiles->width) || (sy + hgt > td->tiles->height)) return;
+
+	for (j = 0; j < hgt; j++)
+	{
+		for (i = 0; i < wid; i++)
+		{
+			XPutPixel(img, x + i, y + j, XGetPixel(td->tiles, sx + i, sy + j));
+		}
+	}
+
+	fb_dirty(td, x, y, wid, hgt);
+}
+
+#endif /* USE_GRAPHICS */
+
+
+/*
+ * Build the glyph masks of a term, by drawing its font into a pixmap
+ * once and reading it back.
+ */
+static bool fb_make_glyphs(term_data *td)
+{
+	Display *dpy = Metadpy->dpy;
+	infofnt *ifnt = td->fnt;
+	Pixmap pix;
+	XImage *img;
+	GC gc;
+	XGCValues gcv;
+	int i, x, y;
+
+	pix = XCreatePixmap(dpy, td->inner->win, 256 * ifnt->wid, ifnt->hgt,
+	                    Metadpy->depth);
+
+	gcv.foreground = Metadpy->black;
+	gcv.background = Metadpy->black;
+	gcv.font = ifnt->info->fid;
+	gcv.graphics_exposures = False;
+	gc = XCreateGC(dpy, pix, GCForeground | GCBackground | GCFont |
+	               GCGraphicsExposures, &gcv);
+
+	/* Start out blank */
+	XFillRectangle(dpy, pix, gc, 0, 0, 256 * ifnt->wid, ifnt->hgt);
+
+	/* Draw every character, in its own cell */
+	XSetForeground(dpy, gc, Metadpy->white);
+	for (i = 0; i < 256; i++)
+	{
+		char c = (char)i;
+
+		XDrawImageString(dpy, pix, gc, i * ifnt->wid + ifnt->off, ifnt->asc,
+		                 &c, 1);
+	}
+
+	img = XGetImage(dpy, pix, 0, 0, 256 * ifnt->wid, ifnt->hgt, AllPlanes,
+	                ZPixmap);
+
+	XFreeGC(dpy, gc);
+	XFreePixmap(dpy, pix);
+
+	if (!img) return (FALSE);
+
+	/* Anything not black is ink */
+	C_MAKE(td->glyphs, 256 * ifnt->wid * ifnt->hgt, byte);
+	for (i = 0; i < 256; i++)
+	{
+		byte *g = td->glyphs + i * ifnt->wid * ifnt->hgt;
+
+		for (y = 0; y < ifnt->hgt; y++)
+		{
+			for (x = 0; x < ifnt->wid; x++)
+			{
+				*g++ = (XGetPixel(img, i * ifnt->wid + x, y) != Metadpy->black);
+			}
+		}
+	}
+
+	XDestroyImage(img);
+
+	return (TRUE);
+}
+
+
+/*
+ * Give a term a framebuffer the size of its inner window.
+ *
+ * On failure the term just draws straight to the window.
+ */
+static void fb_init(term_data *td)
+{
+	int w = td->inner->w;
+	int h = td->inner->h;
+	XImage *img = NULL;
+
+#ifdef USE_XSHM
+
+	/* Try shared memory first */
+	img = fb_make_shm(td, w, h);
+
+#endif /* USE_XSHM */
+
+	/* Use a plain image */
+	if (!img)
+	{
+		img = XCreateImage(Metadpy->dpy, DefaultVisualOfScreen(Metadpy->screen),
+		                   Metadpy->depth, ZPixmap, 0, NULL, w, h, 32, 0);
+		if (!img) return;
+
+		/* Freed by "XDestroyImage()" */
+		img->data = malloc(img->bytes_per_line * h);
+		if (!img->data)
+		{
+			XDestroyImage(img);
+			return;
+		}
+	}
+
+	td->fb = img;
+
+	if (!fb_make_glyphs(td))
+	{
+#ifdef USE_XSHM
+		if (td->use_shm)
+		{
+			XShmDetach(Metadpy->dpy, &td->shm);
+			shmdt(td->shm.shmaddr);
+			img->data = NULL;
+			td->use_shm = FALSE;
+		}
+#endif /* USE_XSHM */
+
+		XDestroyImage(img);
+		td->fb = NULL;
+		return;
+	}
+
+	/* Start out blank */
+	fb_fill(td, 0, 0, w, h, Metadpy->bg);
+}
+
+
 /*
  * Process a keypress event
  *
@@ -2005,6 +2440,14 @@ static errr CheckEvent(bool wait)
 			/* Ignore "extra" exposes */
 			if (xev->xexpose.count) break;
 
+			/* The framebuffer still holds everything */
+			if (td->fb && (iwin == td->inner))
+			{
+				fb_dirty(td, 0, 0, td->fb->width, td->fb->height);
+				fb_flush(td);
+				break;
+			}
+
 			/* Clear the window */
 			Infowin_wipe();
 
@@ -2173,6 +2616,8 @@ static errr Term_xtra_x11_react(void)
  */
 static errr Term_xtra_x11(int n, int v)
 {
+	term_data *td = (term_data*)(Term->data);
+
 	/* Handle a subset of the legal requests */
 	switch (n)
 	{
@@ -2180,7 +2625,12 @@ static errr Term_xtra_x11(int n, int v)
 		case TERM_XTRA_NOISE: Metadpy_do_beep(); return (0);
 
 		/* Flush the output XXX XXX XXX */
-		case TERM_XTRA_FRESH: Metadpy_update(1, 0, 0); return (0);
+		case TERM_XTRA_FRESH:
+		{
+			if (td->fb) fb_flush(td);
+			Metadpy_update(1, 0, 0);
+			return (0);
+		}
 
 		/* Process random events XXX XXX XXX */
 		case TERM_XTRA_BORED: return (CheckEvent(0));
@@ -2195,7 +2645,12 @@ static errr Term_xtra_x11(int n, int v)
 		case TERM_XTRA_LEVEL: return (Term_xtra_x11_level(v));
 
 		/* Clear the screen */
-		case TERM_XTRA_CLEAR: Infowin_wipe(); return (0);
+		case TERM_XTRA_CLEAR:
+		{
+			if (td->fb) fb_fill(td, 0, 0, td->fb->width, td->fb->height, Metadpy->bg);
+			else Infowin_wipe();
+			return (0);
+		}
 
 		/* Delay for some milliseconds */
 		case TERM_XTRA_DELAY: usleep(1000 * v); return (0);
@@ -2214,6 +2669,15 @@ static errr Term_xtra_x11(int n, int v)
  */
 static errr Term_curs_x11(int x, int y)
 {
+	term_data *td = (term_data*)(Term->data);
+
+	/* Hilite the framebuffer */
+	if (td->fb)
+	{
+		fb_curs(td, x, y);
+		return (0);
+	}
+
 	/* Draw the cursor */
 	Infoclr_set(xor);
 
@@ -2230,6 +2694,16 @@ static errr Term_curs_x11(int x, int y)
  */
 static errr Term_wipe_x11(int x, int y, int n)
 {
+	term_data *td = (term_data*)(Term->data);
+
+	/* Erase the framebuffer */
+	if (td->fb)
+	{
+		fb_fill(td, x * td->fnt->wid, y * td->fnt->hgt,
+		        n * td->fnt->wid, td->fnt->hgt, clr[0]->fg);
+		return (0);
+	}
+
 	/* Erase (use black) */
 	Infoclr_set(clr[0]);
 
@@ -2246,6 +2720,15 @@ static errr Term_wipe_x11(int x, int y, int n)
  */
 static errr Term_text_x11(int x, int y, int n, byte a, cptr s)
 {
+	term_data *td = (term_data*)(Term->data);
+
+	/* Draw into the framebuffer */
+	if (td->fb)
+	{
+		fb_text(td, x, y, n, a, s);
+		return (0);
+	}
+
 	/* Draw the text in Xor */
 	Infoclr_set(clr[a]);
 
@@ -2271,6 +2754,13 @@ static errr Term_pict_x11(int x, int y, int n, const byte *ap, const char *cp)
 
 	term_data *td = (term_data*)(Term->data);
 
+	/* Draw into the framebuffer */
+	if (td->fb)
+	{
+		for (i = 0; i < n; ++i) fb_pict(td, x + i, y, ap[i], cp[i]);
+		return (0);
+	}
+
 	y *= Infofnt->hgt;
 	x *= Infofnt->wid;
 
@@ -2346,6 +2836,9 @@ static errr term_data_init(term_data *td, bool fixed, cptr name, cptr font, int
 	Infowin_set_mask(ExposureMask);
 	Infowin_map();
 
+	/* Draw into a client-side framebuffer */
+	if (fb_mode) fb_init(td);
+
 	/* No graphics yet */
 	/*td->tiles = NULL;*/
 
@@ -2434,6 +2927,12 @@ errr init_x11(int argc, char *argv[])
 			continue;
 		}
 
+		if (prefix(argv[i], "-b"))
+		{
+			fb_mode = TRUE;
+			continue;
+		}
+
 		plog_fmt("Ignoring option: %s", argv[i]);
 	}
 
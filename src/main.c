@@ -11,6 +11,10 @@
 
 #include "angband.h"
 
+#ifdef SET_UID
+# include <signal.h>
+#endif /* SET_UID */
+
 
 /*
  * Some machines have a "main()" function in their "main-xxx.c" file,
@@ -244,6 +248,42 @@ static errr Term_wipe_headless(int x, int y, int n) { return 0; }
 static errr Term_text_headless(int x, int y, int n, byte a, const term_char *s) { return 0; }
 static errr Term_pict_headless(int x, int y, int n, const byte *ap, const term_char *cp, const byte *tap, const term_char *tcp) { return 0; }
 
+/*
+ * Where to stream the headless screen, if anywhere (see "main-spc.c")
+ */
+static cptr spectate_path = NULL;
+
+/*
+ * Where to record the main term, and what to play back (see "main-spc.c")
+ */
+static cptr record_path = NULL;
+static cptr replay_path = NULL;
+
+/*
+ * Whether to keep a keystroke journal, and which one to play back
+ * (see "journal.c")
+ */
+static bool journal_keep = FALSE;
+static cptr journal_path = NULL;
+
+/*
+ * How many headless games to soak test, and how many at a time
+ * (see "soak.c")
+ */
+static int soak_games = 0;
+static int soak_jobs = 0;
+
+/*
+ * Whether to write the spoiler files and quit (see "wizard1.c")
+ */
+static bool spoilers = FALSE;
+
+/*
+ * Game turns between two writes of the sampling profiler, if it runs
+ * (see "prof.c")
+ */
+static s32b prof_every = 0;
+
 static errr init_headless(void)
 {
 	term *t = ZNEW(term);
@@ -256,6 +296,14 @@ static errr init_headless(void)
 	t->wipe_hook = Term_wipe_headless;
 	t->text_hook = Term_text_headless;
 	t->pict_hook = (void*)Term_pict_headless;
+
+	/* Stream the screen to spectators */
+	if (spectate_path)
+	{
+		extern errr init_spc(term *t, cptr path);
+		if (init_spc(t, spectate_path)) quit("Unable to start the spectator stream!");
+	}
+
 	Term_activate(t);
 	angband_term[0] = t;
 	return 0;
@@ -281,6 +329,13 @@ int main(int argc, char *argv[])
 
 	cptr mstr = NULL;
 
+	cptr bench_name = NULL;
+
+	bool fuzz = FALSE;
+	long fuzz_slow = 0;
+
+	bool bot = FALSE;
+
 	bool args = TRUE;
 
 
@@ -382,12 +437,123 @@ int main(int argc, char *argv[])
 			arg_headless = TRUE;
 			continue;
 		}
+		if (streq(argv[i], "--fast"))
+		{
+			arg_headless = TRUE;
+			arg_fast = TRUE;
+			continue;
+		}
 		if (streq(argv[i], "--turns") && (i + 1 < argc))
 		{
 			arg_headless_turns = atoi(argv[i+1]);
 			i++;
 			continue;
 		}
+		if (streq(argv[i], "--metrics-bin"))
+		{
+			arg_metrics_binary = TRUE;
+			continue;
+		}
+		if (streq(argv[i], "--metrics-rss") && (i + 1 < argc))
+		{
+			arg_metrics_rss_msec = atoi(argv[i+1]);
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--startup-profile"))
+		{
+			arg_startup_profile = TRUE;
+			continue;
+		}
+		if (streq(argv[i], "--seed") && (i + 1 < argc))
+		{
+			arg_seed = (u32b)atol(argv[i+1]);
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--bench") && (i + 1 < argc))
+		{
+			bench_name = argv[i+1];
+			new_game = TRUE;
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--fuzz"))
+		{
+			fuzz = TRUE;
+			new_game = TRUE;
+			continue;
+		}
+		if (streq(argv[i], "--bot"))
+		{
+			bot = TRUE;
+			new_game = TRUE;
+			continue;
+		}
+		if (streq(argv[i], "--fuzz-slow") && (i + 1 < argc))
+		{
+			fuzz_slow = atol(argv[i+1]);
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--spectate") && (i + 1 < argc))
+		{
+			arg_headless = TRUE;
+			spectate_path = argv[i+1];
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--record") && (i + 1 < argc))
+		{
+			record_path = argv[i+1];
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--replay") && (i + 1 < argc))
+		{
+			replay_path = argv[i+1];
+			i++;
+			continue;
+		}
+
+		if (streq(argv[i], "--soak") && (i + 1 < argc))
+		{
+			arg_headless = TRUE;
+			arg_fast = TRUE;
+			new_game = TRUE;
+			soak_games = atoi(argv[i+1]);
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--jobs") && (i + 1 < argc))
+		{
+			soak_jobs = atoi(argv[i+1]);
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--profile") && (i + 1 < argc))
+		{
+			prof_every = atol(argv[i+1]);
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--journal"))
+		{
+			journal_keep = TRUE;
+			continue;
+		}
+		if (streq(argv[i], "--play-journal") && (i + 1 < argc))
+		{
+			journal_path = argv[i+1];
+			i++;
+			continue;
+		}
+		if (streq(argv[i], "--spoilers"))
+		{
+			arg_headless = TRUE;
+			spoilers = TRUE;
+			continue;
+		}
 
 		/* Require proper options */
 		if (argv[i][0] != '-') goto usage;
@@ -521,6 +687,27 @@ int main(int argc, char *argv[])
 				puts("  -u<who>  Use your <who> savefile");
 				puts("  -m<sys>  Force 'main-<sys>.c' usage");
 				puts("  -d<def>  Define a 'lib' dir sub-path");
+				puts("  --startup-profile  Time each startup step");
+				puts("  --fast             Play headless, drawing nothing");
+				puts("  --metrics-bin      Write headless metrics in binary");
+				puts("  --metrics-rss <ms> Sample memory use every <ms> msec");
+				puts("  --spectate <file>  Play headless, streaming the screen");
+				puts("  --bench <name>     Run a headless benchmark, one of:");
+				bench_list();
+				puts("  --seed <n>         Seed the game with <n>");
+				puts("  --fuzz             Play headless, aiming at less played code");
+				puts("  --fuzz-slow <ms>   Note fuzzed game turns of <ms> or more");
+				puts("  --bot              Play headless, with a bot watching the game");
+				puts("  --record <file>    Record the screen into <file>");
+				puts("  --replay <file>    Play back a recording");
+				puts("  --journal          Keep a journal of the keys typed");
+				puts("  --play-journal <file> Play back a journal, headless");
+				puts("  --soak <n>         Soak test <n> headless games");
+				puts("  --jobs <n>         Run <n> soak test games at a time");
+				puts("  --profile <n>      Sample the game, writing every <n> turns");
+#ifdef ALLOW_SPOILERS
+				puts("  --spoilers         Write every spoiler file, and quit");
+#endif /* ALLOW_SPOILERS */
 
 				/* Actually abort the process */
 				quit(NULL);
@@ -528,6 +715,9 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	/* Spectators watch */
+	if (spectate_path) arg_fast = FALSE;
+
 	/* Hack -- Forget standard args */
 	if (args)
 	{
@@ -536,11 +726,22 @@ int main(int argc, char *argv[])
 	}
 
 
+	/* Choose the benchmark */
+	if (bench_name && !bench_init(bench_name))
+	{
+		quit_fmt("There is no benchmark '%s'.", bench_name);
+	}
+
+	/* Fuzz the game */
+	if (fuzz) fuzz_init(fuzz_slow);
+
+	/* Let the example bot play */
+	if (bot) observe_start(observe_wanderer);
+
 	/* Process the player name */
 	process_player_name(TRUE);
 
 
-
 	/* Install "quit" hook */
 	quit_aux = quit_hook;
 
@@ -715,7 +916,7 @@ int main(int argc, char *argv[])
 	/* Grab privs (dropped above for X11) */
 	safe_setuid_grab();
 
-	if (arg_headless)
+	if (arg_headless || journal_path)
 	{
 		init_headless();
 		ANGBAND_SYS = "headless";
@@ -725,6 +926,17 @@ int main(int argc, char *argv[])
 	/* Make sure we have a display! */
 	if (!done) quit("Unable to prepare any 'display module'!");
 
+	/* Keep (or play back) a keystroke journal */
+	if (journal_path) journal_play(journal_path);
+	else if (journal_keep) journal_record();
+
+	/* Record the main term */
+	if (record_path)
+	{
+		extern errr init_rec(term *t, cptr path);
+		if (init_rec(Term, record_path)) quit("Unable to start the recording!");
+	}
+
 	/* Calculate screen geometry */
 	SCREEN_HGT = screen_y - 2;
 	SCREEN_WID = screen_x - (COL_MAP + 1);
@@ -746,9 +958,36 @@ int main(int argc, char *argv[])
 	/* Catch nasty signals */
 	signals_init();
 
+#ifdef SET_UID
+	/* Spectators may come and go (see "main-spc.c") */
+	if (spectate_path) (void)signal(SIGPIPE, SIG_IGN);
+#endif /* SET_UID */
+
+	/* Play back a recording instead */
+	if (replay_path)
+	{
+		extern void spc_replay(cptr path);
+		spc_replay(replay_path);
+	}
+
 	/* Initialize */
 	init_angband();
 
+#ifdef ALLOW_SPOILERS
+	/* Write the spoilers instead */
+	if (spoilers)
+	{
+		spoil_all();
+		quit(NULL);
+	}
+#endif /* ALLOW_SPOILERS */
+
+	/* Fork into many games (only they come back) */
+	if (soak_games > 0) soak_run(soak_games, soak_jobs);
+
+	/* Sample the game (after forking, which stops the timer) */
+	if (prof_every > 0) prof_start(prof_every);
+
 	/* Wait for response */
 	pause_line(screen_y-1);
 
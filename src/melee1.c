@@ -125,6 +125,93 @@ static cptr desc_disgust[] = {
 };
 
 
+/*
+ * The "power" of each blow effect (see "check_hit()")
+ */
+static byte blow_power[RBE_MAX] =
+{
+	0,
+	60,		/* RBE_HURT */
+	5,		/* RBE_POISON */
+	20,		/* RBE_UN_BONUS */
+	15,		/* RBE_UN_POWER */
+	5,		/* RBE_EAT_GOLD */
+	5,		/* RBE_EAT_ITEM */
+	5,		/* RBE_EAT_FOOD */
+	5,		/* RBE_EAT_LITE */
+	0,		/* RBE_ACID */
+	10,		/* RBE_ELEC */
+	10,		/* RBE_FIRE */
+	10,		/* RBE_COLD */
+	2,		/* RBE_BLIND */
+	10,		/* RBE_CONFUSE */
+	10,		/* RBE_TERRIFY */
+	2,		/* RBE_PARALYZE */
+	0,		/* RBE_LOSE_STR */
+	0,		/* RBE_LOSE_INT */
+	0,		/* RBE_LOSE_WIS */
+	0,		/* RBE_LOSE_DEX */
+	0,		/* RBE_LOSE_CON */
+	0,		/* RBE_LOSE_CHR */
+	2,		/* RBE_LOSE_ALL */
+	60,		/* RBE_SHATTER */
+	5,		/* RBE_EXP_10 */
+	5,		/* RBE_EXP_20 */
+	5,		/* RBE_EXP_40 */
+	5,		/* RBE_EXP_80 */
+	60,		/* RBE_INSANITY */
+};
+
+
+/*
+ * A blow method: what it is called, and whether it cuts and stuns
+ */
+typedef struct blow_method_type blow_method_type;
+
+struct blow_method_type
+{
+	cptr act;		/* Message, if any (some vary, see below) */
+	byte cut;		/* It can cut */
+	byte stun;		/* It can stun */
+};
+
+
+/*
+ * The blow methods
+ */
+static blow_method_type blow_method[RBM_MAX] =
+{
+	{ NULL, 0, 0 },
+	{ "hits you.", 1, 1 },	/* RBM_HIT */
+	{ "touches you.", 0, 0 },	/* RBM_TOUCH */
+	{ "punches you.", 0, 1 },	/* RBM_PUNCH */
+	{ "kicks you.", 0, 1 },	/* RBM_KICK */
+	{ "claws you.", 1, 0 },	/* RBM_CLAW */
+	{ "bites you.", 1, 0 },	/* RBM_BITE */
+	{ "stings you.", 0, 0 },	/* RBM_STING */
+	{ "speaks in riddles.", 0, 0 },	/* RBM_RIDDLE */
+	{ "butts you.", 0, 1 },	/* RBM_BUTT */
+	{ "crushes you.", 0, 1 },	/* RBM_CRUSH */
+	{ "engulfs you.", 0, 0 },	/* RBM_ENGULF */
+	{ "XXX2's you.", 0, 0 },	/* RBM_XXX2 */
+	{ "crawls on you.", 0, 0 },	/* RBM_CRAWL */
+	{ "drools on you.", 0, 0 },	/* RBM_DROOL */
+	{ "spits on you.", 0, 0 },	/* RBM_SPIT */
+	{ "XXX3's on you.", 0, 0 },	/* RBM_XXX3 */
+	{ "gazes at you.", 0, 0 },	/* RBM_GAZE */
+	{ "wails at you.", 0, 0 },	/* RBM_WAIL */
+	{ "releases spores at you.", 0, 0 },	/* RBM_SPORE */
+	{ "projects XXX4's at you.", 0, 0 },	/* RBM_XXX4 */
+	{ "begs you for money.", 0, 0 },	/* RBM_BEG */
+	{ NULL, 0, 0 },	/* RBM_INSULT */
+	{ NULL, 0, 0 },	/* RBM_XXX5 */
+	{ "shouts: ``Halt, Halt!''.", 0, 0 },	/* RBM_HALT */
+	{ NULL, 0, 0 },	/* RBM_DISGUST */
+	{ "projects strange thoughts into your head!", 0, 0 },	/* RBM_PROJECT */
+	{ "explodes!", 0, 0 },	/* RBM_EXPLODE */
+};
+
+
 
 /*
  * Select a monster ``saying''.
@@ -370,9 +457,9 @@ bool make_attack_normal(int m_idx)
 		take_hit(5000, m_name); /* Massive damage */
 
 		/* Cancel Recall */
-		if (p_ptr->word_recall)
+		if (event_when(EVENT_RECALL))
 		{
-			p_ptr->word_recall = 0;
+			event_cancel(EVENT_RECALL);
 			msg_print("The tension leaves the air...");
 		}
 		return (TRUE);
@@ -476,96 +563,7 @@ bool make_attack_normal(int m_idx)
 
 
 		/* Extract the attack "power" */
-		switch (effect)
-		{
-			case RBE_HURT:
-				power = 60;
-				break;
-			case RBE_POISON:
-				power = 5;
-				break;
-			case RBE_UN_BONUS:
-				power = 20;
-				break;
-			case RBE_UN_POWER:
-				power = 15;
-				break;
-			case RBE_EAT_GOLD:
-				power = 5;
-				break;
-			case RBE_EAT_ITEM:
-				power = 5;
-				break;
-			case RBE_EAT_FOOD:
-				power = 5;
-				break;
-			case RBE_EAT_LITE:
-				power = 5;
-				break;
-			case RBE_ACID:
-				power = 0;
-				break;
-			case RBE_ELEC:
-				power = 10;
-				break;
-			case RBE_FIRE:
-				power = 10;
-				break;
-			case RBE_COLD:
-				power = 10;
-				break;
-			case RBE_BLIND:
-				power = 2;
-				break;
-			case RBE_CONFUSE:
-				power = 10;
-				break;
-			case RBE_TERRIFY:
-				power = 10;
-				break;
-			case RBE_PARALYZE:
-				power = 2;
-				break;
-			case RBE_LOSE_STR:
-				power = 0;
-				break;
-			case RBE_LOSE_DEX:
-				power = 0;
-				break;
-			case RBE_LOSE_CON:
-				power = 0;
-				break;
-			case RBE_LOSE_INT:
-				power = 0;
-				break;
-			case RBE_LOSE_WIS:
-				power = 0;
-				break;
-			case RBE_LOSE_CHR:
-				power = 0;
-				break;
-			case RBE_LOSE_ALL:
-				power = 2;
-				break;
-			case RBE_SHATTER:
-				power = 60;
-				break;
-			case RBE_EXP_10:
-				power = 5;
-				break;
-			case RBE_EXP_20:
-				power = 5;
-				break;
-			case RBE_EXP_40:
-				power = 5;
-				break;
-			case RBE_EXP_80:
-				power = 5;
-				break;
-			case RBE_INSANITY:
-				power = 60;
-				break;
-		}
+		power = blow_power[effect];
 
 
 		/* Heavy Metal Interaction */
@@ -604,7 +602,7 @@ bool make_attack_normal(int m_idx)
 			}
 
 			/* Always disturbing */
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 
 
 			/* Hack -- Apply "protection from evil" */
@@ -623,145 +621,14 @@ bool make_attack_normal(int m_idx)
 				/* Hack -- Next attack */
 				continue;
 			}
-			/* Assume no cut or stun */
-			do_cut = do_stun = 0;
-
 			/* Describe the attack method */
+			act = blow_method[method].act;
+			do_cut = blow_method[method].cut;
+			do_stun = blow_method[method].stun;
+
+			/* Some vary, or do more */
 			switch (method)
 			{
-				case RBM_HIT:
-				{
-					act = "hits you.";
-					do_cut = do_stun = 1;
-					break;
-				}
-
-				case RBM_TOUCH:
-				{
-					act = "touches you.";
-					break;
-				}
-
-				case RBM_PUNCH:
-				{
-					act = "punches you.";
-					do_stun = 1;
-					break;
-				}
-
-				case RBM_KICK:
-				{
-					act = "kicks you.";
-					do_stun = 1;
-					break;
-				}
-
-				case RBM_CLAW:
-				{
-					act = "claws you.";
-					do_cut = 1;
-					break;
-				}
-
-				case RBM_BITE:
-				{
-					act = "bites you.";
-					do_cut = 1;
-					break;
-				}
-
-				case RBM_STING:
-				{
-					act = "stings you.";
-					break;
-				}
-
-				case RBM_RIDDLE:
-				{
-					act = "speaks in riddles.";
-					break;
-				}
-
-				case RBM_BUTT:
-				{
-					act = "butts you.";
-					do_stun = 1;
-					break;
-				}
-
-				case RBM_CRUSH:
-				{
-					act = "crushes you.";
-					do_stun = 1;
-					break;
-				}
-
-				case RBM_ENGULF:
-				{
-					act = "engulfs you.";
-					break;
-				}
-
-				case RBM_XXX2:
-				{
-					act = "XXX2's you.";
-					break;
-				}
-
-				case RBM_CRAWL:
-				{
-					act = "crawls on you.";
-					break;
-				}
-
-				case RBM_DROOL:
-				{
-					act = "drools on you.";
-					break;
-				}
-
-				case RBM_SPIT:
-				{
-					act = "spits on you.";
-					break;
-				}
-
-				case RBM_XXX3:
-				{
-					act = "XXX3's on you.";
-					break;
-				}
-
-				case RBM_GAZE:
-				{
-					act = "gazes at you.";
-					break;
-				}
-
-				case RBM_WAIL:
-				{
-					act = "wails at you.";
-					break;
-				}
-
-				case RBM_SPORE:
-				{
-					act = "releases spores at you.";
-					break;
-				}
-
-				case RBM_XXX4:
-				{
-					act = "projects XXX4's at you.";
-					break;
-				}
-
-				case RBM_BEG:
-				{
-					act = "begs you for money.";
-					break;
-				}
-
 				case RBM_INSULT:
 				{
 					act = desc_insult[rand_int(8)];
@@ -774,27 +641,11 @@ bool make_attack_normal(int m_idx)
 					break;
 				}
 
-				case RBM_PROJECT:
-				{
-					act = "projects strange thoughts into your head!";
-					break;
-				}
-
-				case RBM_HALT:
-				{
-					act = "shouts: ``Halt, Halt!''.";
-					break;
-				}
-
 				case RBM_EXPLODE:
 				{
-					act = "explodes!";
-
 					do_explosion = TRUE;
-
 					break;
 				}
-
 			}
 
 			/* Message */
@@ -1748,7 +1599,7 @@ bool make_attack_normal(int m_idx)
 					if (m_ptr->ml)
 					{
 						/* Disturbing */
-						disturb(1, 0);
+						disturb(1, DISTURB_MONSTER);
 
 						/* Message */
 						msg_format("%^s misses you.", m_name);
@@ -10,6 +10,8 @@
 
 #include "angband.h"
 
+#include <sys/time.h>
+
 
 
 #ifdef DRS_SMART_OPTIONS
@@ -433,10 +435,12 @@ static void remove_bad_spells(int m_idx, u32b * f4p, u32b * f5p,
 static void find_target_nearest(monster_type * m_ptr, monster_race * r_ptr,
 	int *ry, int *rx)
 {
-	int i, j;
+	int i, j, k, n;
 	int sx = m_ptr->fx;
 	int sy = m_ptr->fy;
 
+	s16b who[MAX_M_IDX];
+
 	monster_type *o_m_ptr;
 	monster_race *o_r_ptr;
 	monster_type *min_m_ptr = NULL;
@@ -493,13 +497,18 @@ static void find_target_nearest(monster_type * m_ptr, monster_race * r_ptr,
 		return;
 	}
 
-	/* Process the monsters, backwards */
-	for (i = m_max - 1; i >= 1; i--)
+	/* Only monsters closer than "aaf" can be chosen */
+	if (min_dist <= 0) return;
+
+	/* Collect the nearby monsters */
+	n = monster_near(sy, sx, min_dist - 1, who, MAX_M_IDX);
+
+	/* Process the monsters */
+	for (k = 0; k < n; k++)
 	{
-		o_m_ptr = &m_list[i];
+		i = who[k];
 
-		if (!o_m_ptr->r_idx)
-			continue;
+		o_m_ptr = &m_list[i];
 
 		o_r_ptr = &r_info[o_m_ptr->r_idx];
 
@@ -509,7 +518,9 @@ static void find_target_nearest(monster_type * m_ptr, monster_race * r_ptr,
 		{
 			j = distance(o_m_ptr->fy, o_m_ptr->fx, sy, sx);
 
-			if (j < min_dist)
+			/* Closest wins, ties go to the highest index */
+			if ((j < min_dist) ||
+			    ((j == min_dist) && min_m_ptr && (o_m_ptr > min_m_ptr)))
 			{
 				min_dist = j;
 				min_m_ptr = o_m_ptr;
@@ -609,7 +620,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 		{
 			if (!direct)
 				break;
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			msg_format("%^s makes a high pitched shriek.", m_name);
 			aggravate_monsters(m_idx);
 			break;
@@ -636,7 +647,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_ARROW_1 */
 		case 96 + 4:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s makes a strange noise.", m_name);
 			else
@@ -648,7 +659,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_ARROW_2 */
 		case 96 + 5:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s makes a strange noise.", m_name);
 			else
@@ -660,7 +671,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_ARROW_3 */
 		case 96 + 6:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s makes a strange noise.", m_name);
 			else
@@ -672,7 +683,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_ARROW_4 */
 		case 96 + 7:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s makes a strange noise.", m_name);
 			else
@@ -684,7 +695,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_ACID */
 		case 96 + 8:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -698,7 +709,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_ELEC */
 		case 96 + 9:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -712,7 +723,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_FIRE */
 		case 96 + 10:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -726,7 +737,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_COLD */
 		case 96 + 11:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -740,7 +751,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_POIS */
 		case 96 + 12:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -754,7 +765,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_NETH */
 		case 96 + 13:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -768,7 +779,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_LITE */
 		case 96 + 14:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -782,7 +793,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_DARK */
 		case 96 + 15:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -796,7 +807,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_CONF */
 		case 96 + 16:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -810,7 +821,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_SOUN */
 		case 96 + 17:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -824,7 +835,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_CHAO */
 		case 96 + 18:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -838,7 +849,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_DISE */
 		case 96 + 19:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -852,7 +863,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_NEXU */
 		case 96 + 20:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -866,7 +877,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_TIME */
 		case 96 + 21:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -879,7 +890,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_INER */
 		case 96 + 22:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -892,7 +903,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_GRAV */
 		case 96 + 23:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -905,7 +916,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_SHAR */
 		case 96 + 24:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -919,7 +930,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_PLAS */
 		case 96 + 25:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -932,7 +943,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_WALL */
 		case 96 + 26:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s breathes.", m_name);
 			else
@@ -952,7 +963,7 @@ static void cast_inate_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF4_BR_QUAKE */
 		case 96 + 28:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			msg_format("%^s warps space-time!", m_name);
 			breath(m_idx, py, px, GF_QUAKE,
 				((m_ptr->hp / 6) > 200 ? 200 : (m_ptr->hp / 6)));
@@ -997,7 +1008,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BA_ACID */
 		case 128 + 0:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1010,7 +1021,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BA_ELEC */
 		case 128 + 1:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1023,7 +1034,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BA_FIRE */
 		case 128 + 2:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1036,7 +1047,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BA_COLD */
 		case 128 + 3:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1049,7 +1060,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BA_POIS */
 		case 128 + 4:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1062,7 +1073,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BA_NETH */
 		case 128 + 5:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1076,7 +1087,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BA_WATE */
 		case 128 + 6:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1089,7 +1100,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BA_MANA */
 		case 128 + 7:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles powerfully.", m_name);
 			else
@@ -1101,7 +1112,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BA_DARK */
 		case 128 + 8:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles powerfully.", m_name);
 			else
@@ -1122,7 +1133,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 				int r1;
 
 				/* Disturb if legal */
-				disturb(1, 0);
+				disturb(1, DISTURB_MONSTER);
 
 				/* Basic message */
 				msg_format("%^s draws psychic energy from you!", m_name);
@@ -1176,7 +1187,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_MIND_BLAST */
 		case 128 + 10:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("You feel an intense psychic disturbance.",
 					m_name);
@@ -1190,7 +1201,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BRAIN_SMASH */
 		case 128 + 11:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("You feel an intense psychic disturbance.",
 					m_name);
@@ -1203,7 +1214,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_CAUSE_1 */
 		case 128 + 12:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("Something mumbles.", m_name);
 			else
@@ -1216,7 +1227,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 
 		case 128 + 13:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("Something mumbles.", m_name);
 			else
@@ -1229,7 +1240,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 
 		case 128 + 14:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("Something mumbles loudly.", m_name);
 			else
@@ -1241,7 +1252,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_CAUSE_4 */
 		case 128 + 15:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("Something screams the word 'DIE!'.", m_name);
 			else
@@ -1254,7 +1265,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BO_ACID */
 		case 128 + 16:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1267,7 +1278,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BO_ELEC */
 		case 128 + 17:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1280,7 +1291,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BO_FIRE */
 		case 128 + 18:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1293,7 +1304,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BO_COLD */
 		case 128 + 19:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1313,7 +1324,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BO_NETH */
 		case 128 + 21:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1327,7 +1338,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BO_WATE */
 		case 128 + 22:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1339,7 +1350,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BO_MANA */
 		case 128 + 23:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1351,7 +1362,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BO_PLAS */
 		case 128 + 24:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1363,7 +1374,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BO_ICEE */
 		case 128 + 25:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1376,7 +1387,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_MISSILE */
 		case 128 + 26:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1388,7 +1399,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_SCARE */
 		case 128 + 27:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 
 			if (blind)
 				msg_format("%^s mumbles, and you hear scary noises.",
@@ -1404,7 +1415,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_BLIND */
 		case 128 + 28:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
@@ -1418,7 +1429,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_CONF */
 		case 128 + 29:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles, and you hear puzzling noises.",
 					m_name);
@@ -1432,7 +1443,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_SLOW */
 		case 128 + 30:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			msg_format("%^s drains power from muscles!", m_name);
 			bolt(m_idx, py, px, GF_SLOW, 5);
 			update_smart_learn(m_idx, DRS_FREE);
@@ -1442,7 +1453,7 @@ static void cast_normal_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF5_HOLD */
 		case 128 + 31:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1478,7 +1489,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_HASTE */
 		case 160 + 0:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 			{
 				msg_format("%^s mumbles.", m_name);
@@ -1514,7 +1525,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_HEAL */
 		case 160 + 2:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 
 			/* Message */
 			if (blind)
@@ -1587,7 +1598,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_BLINK */
 		case 160 + 4:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			msg_format("%^s blinks away.", m_name);
 			teleport_away(m_idx, 10);
 			break;
@@ -1596,7 +1607,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_TPORT */
 		case 160 + 5:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			msg_format("%^s teleports away.", m_name);
 			teleport_away(m_idx, MAX_SIGHT * 2 + 5);
 			break;
@@ -1619,7 +1630,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 		{
 			if (!direct)
 				break;
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			msg_format("%^s commands you to return.", m_name);
 			teleport_player_to(m_ptr->fy, m_ptr->fx);
 			break;
@@ -1630,7 +1641,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 		{
 			if (!direct)
 				break;
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			msg_format("%^s teleports you away.", m_name);
 			teleport_player(100);
 			break;
@@ -1641,7 +1652,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 		{
 			if (!direct)
 				break;
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles strangely.", m_name);
 			else
@@ -1673,7 +1684,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 		{
 			if (!direct)
 				break;
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1687,7 +1698,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 		{
 			if (!direct)
 				break;
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles, and then cackles evilly.",
 					m_name);
@@ -1703,7 +1714,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 		{
 			if (!direct)
 				break;
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			msg_format("%^s tries to blank your mind.", m_name);
 
 			if (rand_int(100) < p_ptr->skill_sav)
@@ -1720,7 +1731,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_XXX6X6 */
 		case 160 + 15:
 		{
-		  disturb(1, 0);
+		  disturb(1, DISTURB_MONSTER);
 
 		  if (blind) {
 		    msg_format("%^s mumbles in the kobold tongue.", m_name);
@@ -1748,7 +1759,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_KOBOLD */
 		case 160 + 16:
 		{
-		  disturb(1, 0);
+		  disturb(1, DISTURB_MONSTER);
 
 		  if (blind) {
 		    msg_format("%^s mumbles in the kobold tongue.", m_name);
@@ -1774,7 +1785,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_GOOD_UNIQUE */
 		case 160 + 17:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s chants in a strong, clear voice.", m_name);
 			else
@@ -1801,7 +1812,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_MONSTER */
 		case 160 + 18:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1821,7 +1832,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_MONSTERS */
 		case 160 + 19:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1841,7 +1852,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_ANT */
 		case 160 + 20:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1862,7 +1873,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_SPIDER */
 		case 160 + 21:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1884,7 +1895,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_HOUND */
 		case 160 + 22:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1905,7 +1916,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_HYDRA */
 		case 160 + 23:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1926,7 +1937,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_ANGEL */
 		case 160 + 24:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1947,7 +1958,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_DEMON */
 		case 160 + 25:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1969,7 +1980,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_UNDEAD */
 		case 160 + 26:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -1992,7 +2003,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_DRAGON */
 		case 160 + 27:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -2014,7 +2025,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_HI_UNDEAD */
 		case 160 + 28:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -2039,7 +2050,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_HI_DRAGON */
 		case 160 + 29:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -2064,7 +2075,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_WRAITH */
 		case 160 + 30:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -2099,7 +2110,7 @@ static void cast_bizarre_spell(int m_idx, int thrown_spell, bool direct, int py,
 			/* RF6_S_UNIQUE */
 		case 160 + 31:
 		{
-			disturb(1, 0);
+			disturb(1, DISTURB_MONSTER);
 			if (blind)
 				msg_format("%^s mumbles.", m_name);
 			else
@@ -2202,9 +2213,6 @@ bool make_attack_spell(int m_idx)
 	monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
 	char m_name[80];
-	char m_poss[80];
-
-	char ddesc[80];
 
 
 
@@ -2222,9 +2230,6 @@ bool make_attack_spell(int m_idx)
 	/* Assume "projectable" */
 	bool direct = TRUE;
 
-	/* Flag to check wheather it's OK to shoot */
-	bool clear_shot;
-
 	/* General targetting code. */
 	find_target_nearest(m_ptr, r_ptr, &py, &px);
 
@@ -2258,11 +2263,6 @@ bool make_attack_spell(int m_idx)
 			direct = FALSE;
 	}
 
-	clear_shot = target_clear(m_ptr, py, px);
-
-	/* Get the monster name (or "it") */
-	monster_desc(m_name, m_ptr, 0x00);
-
 	/* ``Smart'' monsters speak insults. */
 	if (direct && m_ptr->ml && magik(20) && monsters_speak)
 	{
@@ -2270,6 +2270,9 @@ bool make_attack_spell(int m_idx)
 
 		if (insult)
 		{
+			/* Get the monster name (or "it"), only when it is used */
+			monster_desc(m_name, m_ptr, 0x00);
+
 			msg_format("%^s %s", m_name, insult);
 		}
 	}
@@ -2395,18 +2398,12 @@ bool make_attack_spell(int m_idx)
 		return (FALSE);
 
 
-	/* Get the monster possessive ("his"/"her"/"its") */
-	monster_desc(m_poss, m_ptr, 0x22);
-
-	/* Hack -- Get the "died from" name */
-	monster_desc(ddesc, m_ptr, 0x88);
-
-
 	/* Choose a spell to cast */
 	thrown_spell = spell[rand_int(num)];
 
-	if (!clear_shot && thrown_spell < 32 * 5 &&
-		!(r_ptr->flags2 & RF2_STUPID)) return FALSE;
+	/* Only now see whether a bolt or breath would hit a friend */
+	if (thrown_spell < 32 * 5 && !(r_ptr->flags2 & RF2_STUPID) &&
+		!target_clear(m_ptr, py, px)) return FALSE;
 
 	/* Deduct costs */
 	if (thrown_spell < 128)
@@ -2515,8 +2512,8 @@ static int mon_will_run(int m_idx)
 	if (m_ptr->monfear)
 		return (TRUE);
 
-	/* Flee if HP is below 30% */
-	if (m_ptr->hp <= m_ptr->maxhp * 3 / 10)
+	/* Flee if HP is below 30% (paranoia -- some monsters have no hit points) */
+	if ((m_ptr->maxhp > 0) && (m_ptr->hp <= m_ptr->maxhp * 3 / 10))
 	{
 		int pct = (m_ptr->hp * 100) / m_ptr->maxhp;
 		int chance_to_flee = 100 - (pct * 50 / 30);
@@ -2621,10 +2618,10 @@ static bool get_moves_aux(int m_idx, int *yp, int *xp)
 	x1 = m_ptr->fx;
 
 	/* The player is not currently near the monster grid */
-	if (cave_when[y1][x1] < cave_when[py][px])
+	if (cave_flow[y1][x1].when < cave_flow[py][px].when)
 	{
 		/* The player has never been near the monster grid */
-		if (cave_when[y1][x1] == 0)
+		if (cave_flow[y1][x1].when == 0)
 			return (FALSE);
 
 		/* The monster is not allowed to track the player */
@@ -2633,9 +2630,9 @@ static bool get_moves_aux(int m_idx, int *yp, int *xp)
 	}
 
 	/* Monster is too far away to notice the player */
-	if (cave_cost[y1][x1] > MONSTER_FLOW_DEPTH)
+	if (cave_flow[y1][x1].cost > MONSTER_FLOW_DEPTH)
 		return (FALSE);
-	if (cave_cost[y1][x1] > r_ptr->aaf)
+	if (cave_flow[y1][x1].cost > r_ptr->aaf)
 		return (FALSE);
 
 	/* Hack -- Player can see us, run towards him */
@@ -2650,20 +2647,20 @@ static bool get_moves_aux(int m_idx, int *yp, int *xp)
 		x = x1 + ddx_ddd[i];
 
 		/* Ignore illegal locations */
-		if (cave_when[y][x] == 0)
+		if (cave_flow[y][x].when == 0)
 			continue;
 
 		/* Ignore ancient locations */
-		if (cave_when[y][x] < when)
+		if (cave_flow[y][x].when < when)
 			continue;
 
 		/* Ignore distant locations */
-		if (cave_cost[y][x] > cost)
+		if (cave_flow[y][x].cost > cost)
 			continue;
 
 		/* Save the cost and time */
-		when = cave_when[y][x];
-		cost = cave_cost[y][x];
+		when = cave_flow[y][x].when;
+		cost = cave_flow[y][x].cost;
 
 		/* Hack -- Save the "twiddled" location */
 		(*yp) = py + 16 * ddy_ddd[i];
@@ -2682,25 +2679,13 @@ static bool get_moves_aux(int m_idx, int *yp, int *xp)
 
 
 /*
- * Choose "logical" directions for monster movement
- *
- * We store the directions in a special "mm" array
+ * Choose the grid a monster is heading for (the first stage of
+ * "get_moves()"): the player, a monster it hunts, or, for a pet, the
+ * player or an enemy near the player.
  */
-void get_moves(int m_idx, int mm[5])
+static void get_moves_target(monster_type *m_ptr, monster_race *r_ptr,
+	int *py, int *px)
 {
-	int py;
-	int px;
-
-	monster_type *m_ptr = &m_list[m_idx];
-	monster_race *r_ptr = &r_info[m_ptr->r_idx];
-
-	int y, ay, x, ax;
-
-	int move_val = 0;
-
-	int y2;
-	int x2;
-
 	/* Pet AI: Reactive Guard / Tether Logic */
 	if (m_ptr->is_pet)
 	{
@@ -2725,8 +2710,8 @@ void get_moves(int m_idx, int mm[5])
 				{
 					/* Enemy found! */
 					found_hostile = TRUE;
-					py = y_adj;
-					px = x_adj;
+					*py = y_adj;
+					*px = x_adj;
 					break;
 				}
 			}
@@ -2739,30 +2724,30 @@ void get_moves(int m_idx, int mm[5])
 		else if (dist_to_player > MAX_GUARD_DIST)
 		{
 			/* Tether: Too far, return to player */
-			py = p_ptr->py;
-			px = p_ptr->px;
+			*py = p_ptr->py;
+			*px = p_ptr->px;
 		}
 		else if (p_ptr->last_attacked_turn < turn - 1)
 		{
 			/* Passive: Stay near player */
-			py = p_ptr->py;
-			px = p_ptr->px;
+			*py = p_ptr->py;
+			*px = p_ptr->px;
 		}
 		else
 		{
 			/* Reactive: Find target */
-			find_target_nearest(m_ptr, r_ptr, &py, &px);
+			find_target_nearest(m_ptr, r_ptr, py, px);
 
 			/* Validate target */
 			{
-				int dist_target_player = distance(py, px, p_ptr->py, p_ptr->px);
-				int dist_target_pet = distance(py, px, m_ptr->fy, m_ptr->fx);
+				int dist_target_player = distance(*py, *px, p_ptr->py, p_ptr->px);
+				int dist_target_pet = distance(*py, *px, m_ptr->fy, m_ptr->fx);
 
 				/* If target is too far from player and not adjacent (self-defense), ignore it */
 				if (dist_target_player > MAX_GUARD_DIST && dist_target_pet > 1)
 				{
-					py = p_ptr->py;
-					px = p_ptr->px;
+					*py = p_ptr->py;
+					*px = p_ptr->px;
 				}
 			}
 		}
@@ -2770,40 +2755,62 @@ void get_moves(int m_idx, int mm[5])
 	else
 	{
 		/* Standard targeting */
-		find_target_nearest(m_ptr, r_ptr, &py, &px);
+		find_target_nearest(m_ptr, r_ptr, py, px);
 	}
 
-	y2 = py;
-	x2 = px;
+}
+
+
+/*
+ * Find a better way towards the player than a straight line (the second
+ * stage of "get_moves()"), by the sound of the player or, for a smart
+ * monster which heard the player, by the scent trail.  A monster the
+ * player can see (or which is heading elsewhere) goes straight there.
+ */
+static void get_moves_route(int m_idx, int py, int px, int *yp, int *xp)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+
+	int ty, tx;
+
+	/* Only the player is followed, and only out of sight */
+	if ((py != p_ptr->py) || (px != p_ptr->px)) return;
+	if (player_has_los_bold(m_ptr->fy, m_ptr->fx)) return;
 
 #ifdef MONSTER_FLOW
 	/* Flow towards the player */
-	if (flow_by_sound && py == p_ptr->py && px == p_ptr->px)
-	{
-		/* Flow towards the player */
-		(void) get_moves_aux(m_idx, &y2, &x2);
-	}
+	if (flow_by_sound && get_moves_aux(m_idx, yp, xp)) return;
 #endif
 
-	/* Extract the "pseudo-direction" */
-	y = m_ptr->fy - y2;
-	x = m_ptr->fx - x2;
-
+	/* Smart monsters which heard the player follow the scent trail */
+	if (m_ptr->is_pet || (m_ptr->smart_ai.state != STATE_TRACK_SCENT)) return;
 
-	/* Apply fear */
-	/* Pets aren't scared of the player, but will run away. */
-
-	if (!m_ptr->is_pet && mon_will_run(m_idx))
+	if (scent_track(m_ptr->fy, m_ptr->fx, &ty, &tx))
 	{
-		/* This is not a very "smart" method XXX XXX */
-		y = (-y);
-		x = (-x);
+		/* Head for the fresher step, and remember it */
+		*yp = ty;
+		*xp = tx;
+		m_ptr->smart_ai.target_y = ty;
+		m_ptr->smart_ai.target_x = tx;
 	}
-	else if (m_ptr->is_pet && m_ptr->monfear)
+	else if (!scent_track(m_ptr->smart_ai.target_y,
+	                      m_ptr->smart_ai.target_x, &ty, &tx))
 	{
-		y = (-y);
-		x = (-x);
+		/* The trail has gone cold */
+		m_ptr->smart_ai.state = STATE_WANDER;
 	}
+}
+
+
+/*
+ * Sort the directions from the "pseudo-direction" (y, x), best first
+ * (the last stage of "get_moves()")
+ */
+static void get_moves_dir(int y, int x, int mm[5])
+{
+	int ay, ax;
+
+	int move_val = 0;
 
 	/* Extract the "absolute distances" */
 	ax = ABS(x);
@@ -2996,6 +3003,67 @@ void get_moves(int m_idx, int mm[5])
 }
 
 
+/*
+ * Choose "logical" directions for monster movement
+ *
+ * We store the directions in a special "mm" array.  In headless games,
+ * the first two stages (the target and the route) are timed on their
+ * own, as well as the whole.
+ */
+void get_moves(int m_idx, int mm[5])
+{
+	int py;
+	int px;
+
+	monster_type *m_ptr = &m_list[m_idx];
+	monster_race *r_ptr = &r_info[m_ptr->r_idx];
+
+	int y, x;
+
+	int y2;
+	int x2;
+
+	metric_start(METRIC_T_GET_MOVES);
+
+	/* Where to go */
+	metric_start(METRIC_T_GET_MOVES_TARGET);
+	get_moves_target(m_ptr, r_ptr, &py, &px);
+	metric_stop(METRIC_T_GET_MOVES_TARGET);
+
+	y2 = py;
+	x2 = px;
+
+	/* How to get there */
+	metric_start(METRIC_T_GET_MOVES_ROUTE);
+	get_moves_route(m_idx, py, px, &y2, &x2);
+	metric_stop(METRIC_T_GET_MOVES_ROUTE);
+
+	/* Extract the "pseudo-direction" */
+	y = m_ptr->fy - y2;
+	x = m_ptr->fx - x2;
+
+
+	/* Apply fear */
+	/* Pets aren't scared of the player, but will run away. */
+
+	if (!m_ptr->is_pet && mon_will_run(m_idx))
+	{
+		/* This is not a very "smart" method XXX XXX */
+		y = (-y);
+		x = (-x);
+	}
+	else if (m_ptr->is_pet && m_ptr->monfear)
+	{
+		y = (-y);
+		x = (-x);
+	}
+
+	get_moves_dir(y, x, mm);
+
+	metric_stop(METRIC_T_GET_MOVES);
+}
+
+
 
 /*
  * Hack -- compare the "strength" of two monsters XXX XXX XXX
@@ -3095,6 +3163,57 @@ static void punish_monster(monster_type * m_ptr)
 }
 
 
+/*
+ * Can a monster of race "r_ptr" walk onto the open floor grid (y,x)?
+ *
+ * This is the deep water, lava and aquatic check of "process_monster()"
+ * (smart monsters also keep off hazards), shared with the dormant step.
+ */
+static bool monster_floor_allows(monster_race *r_ptr, int y, int x)
+{
+	int f = cave_feat[y][x];
+
+	/* Smart monsters avoid hazards */
+	if ((r_ptr->flags2 & RF2_SMART) && !(r_ptr->flags2 & RF2_FLY))
+	{
+		if (f == FEAT_SHAL_LAVA || f == FEAT_DEEP_LAVA || f == FEAT_ACID || f == FEAT_ICE || f == FEAT_OIL || f == FEAT_OIL_BURNING)
+		{
+			return (FALSE);
+		}
+	}
+
+	/* handle deep water -KMW- */
+	if (f == FEAT_DEEP_WATER &&
+		!(r_ptr->flags2 & RF2_SWIM) &&
+		!(r_ptr->flags2 & RF2_PASS_WALL) &&
+		!(r_ptr->flags2 & RF2_FLY) &&
+		!(r_ptr->flags2 & RF2_AQUATIC))
+		return (FALSE);
+
+	/* handle deep lava -KMW- */
+	else if ((f == FEAT_DEEP_LAVA) &&
+		((!(r_ptr->flags2 & (RF2_DEEPLAVA))) &&
+			(!(r_ptr->flags2 & (RF2_PASS_WALL))) &&
+			(!(r_ptr->flags2 & (RF2_FLY)))))
+		return (FALSE);
+
+	/* handle shallow lava -KMW- */
+	else if ((f == FEAT_SHAL_LAVA) &&
+		((!(r_ptr->flags3 & (RF3_IM_FIRE))) &&
+			(!(r_ptr->flags2 & (RF2_PASS_WALL))) &&
+			(!(r_ptr->flags2 & (RF2_FLY)))))
+		return (FALSE);
+
+	/* handle aquatic monsters -KMW- */
+	else if (r_ptr->flags2 & RF2_AQUATIC &&
+		(f != FEAT_DEEP_WATER) &&
+		(f != FEAT_SHAL_WATER))
+		return (FALSE);
+
+	return (TRUE);
+}
+
+
 static void process_monster(int m_idx)
 {
 	monster_type *m_ptr = &m_list[m_idx];
@@ -3123,6 +3242,9 @@ static void process_monster(int m_idx)
 	/* Process terrain hazard effects at the start of the monster's turn */
 	mon_process_terrain(m_idx, m_ptr->fy, m_ptr->fx);
 
+	/* Drowned, or the like */
+	if (!m_ptr->r_idx) return;
+
 	bool did_open_door;
 	bool did_bash_door;
 	bool did_take_item;
@@ -3342,7 +3464,8 @@ static void process_monster(int m_idx)
 
 
 	/* Attempt to "mutiply" if able and allowed */
-	if ((r_ptr->flags2 & (RF2_MULTIPLY)) && (num_repro < MAX_REPRO))
+	if ((r_ptr->flags2 & (RF2_MULTIPLY)) && (num_repro < MAX_REPRO) &&
+	    monster_may_multiply(m_idx))
 	{
 		int k, y, x;
 
@@ -3515,6 +3638,9 @@ static void process_monster(int m_idx)
 		ny = oy + ddy[d];
 		nx = ox + ddx[d];
 
+		/* Stay in the dungeon */
+		if (!in_bounds(ny, nx)) continue;
+
 		/* Elevation check for all moves. */
 		if (!elev_allows_move(oy, ox, ny, nx, (r_ptr->flags2 & RF2_FLY) || (r_ptr->flags2 & RF2_PASS_WALL))) {
 			continue;
@@ -3534,7 +3660,9 @@ static void process_monster(int m_idx)
 
 
 			/* Ambush Logic: Guard Posts should utilize high ground */
-			if (m_guard[m_idx] && m_guard[m_idx]->guard_post_type == GUARD_POST_HIGHGROUND) {
+			monster_guard_data *guard = get_guard_data(m_idx);
+
+			if (guard && guard->guard_post_type == GUARD_POST_HIGHGROUND) {
 				/* Check if trying to jump down (unsafe descent) */
 				if (get_elevation(oy, ox) > get_elevation(ny, nx)) {
 					int feat = cave_feat[ny][nx];
@@ -3555,43 +3683,8 @@ static void process_monster(int m_idx)
 				}
 			}
 
-			/* Smart monsters avoid hazards */
-			if ((r_ptr->flags2 & RF2_SMART) && !(r_ptr->flags2 & RF2_FLY))
-			{
-				int f = cave_feat[ny][nx];
-				if (f == FEAT_SHAL_LAVA || f == FEAT_DEEP_LAVA || f == FEAT_ACID || f == FEAT_ICE || f == FEAT_OIL || f == FEAT_OIL_BURNING)
-				{
-					do_move = FALSE;
-				}
-			}
-
-			/* handle deep water -KMW- */
-			if (cave_feat[ny][nx] == FEAT_DEEP_WATER &&
-				!(r_ptr->flags2 & RF2_SWIM) &&
-				!(r_ptr->flags2 & RF2_PASS_WALL) &&
-				!(r_ptr->flags2 & RF2_FLY) &&
-				!(r_ptr->flags2 & RF2_AQUATIC))
-				do_move = FALSE;
-
-			/* handle deep lava -KMW- */
-			else if ((cave_feat[ny][nx] == FEAT_DEEP_LAVA) &&
-				((!(r_ptr->flags2 & (RF2_DEEPLAVA))) &&
-					(!(r_ptr->flags2 & (RF2_PASS_WALL))) &&
-					(!(r_ptr->flags2 & (RF2_FLY)))))
-				do_move = FALSE;
-
-			/* handle shallow lava -KMW- */
-			else if ((cave_feat[ny][nx] == FEAT_SHAL_LAVA) &&
-				((!(r_ptr->flags3 & (RF3_IM_FIRE))) &&
-					(!(r_ptr->flags2 & (RF2_PASS_WALL))) &&
-					(!(r_ptr->flags2 & (RF2_FLY)))))
-				do_move = FALSE;
-
-			/* handle aquatic monsters -KMW- */
-			else if (r_ptr->flags2 & RF2_AQUATIC &&
-				(cave_feat[ny][nx] != FEAT_DEEP_WATER) &&
-				(cave_feat[ny][nx] != FEAT_SHAL_WATER))
-				do_move = FALSE;
+			/* Water, lava and hazards */
+			if (!monster_floor_allows(r_ptr, ny, nx)) do_move = FALSE;
 		}
 
 		/* Aquatic monsters never move through solid terrain. */
@@ -3732,7 +3825,7 @@ static void process_monster(int m_idx)
 
 					/* Disturb (sometimes) */
 					if (disturb_minor)
-						disturb(0, 0);
+						disturb(0, DISTURB_MONSTER);
 
 					/* The door was bashed open */
 					did_bash_door = TRUE;
@@ -3880,7 +3973,7 @@ static void process_monster(int m_idx)
 		if (do_move && (cave_m_idx[ny][nx] > 0))
 		{
 			monster_type *n_ptr = &m_list[cave_m_idx[ny][nx]];
-			bool fear = FALSE, award_exp;
+			bool fear = FALSE, award_exp, show;
 			int dam, tmp_i;
 			char m_name[80];
 			char n_name[80];
@@ -3918,34 +4011,39 @@ static void process_monster(int m_idx)
 
 				do_move = FALSE;
 
-				for (tmp_i = 0; tmp_i < 4; tmp_i++)
-				{
-					if (!(r_ptr->blow[tmp_i].method))
-						break;
-
-					dam =
-						damroll(r_ptr->blow[tmp_i].d_dice,
-						r_ptr->blow[tmp_i].d_side);
+				/* The player gets the experience for a pet's kills */
+				award_exp = m_ptr->is_pet;
 
-					/* Acquire the monster names */
-					/* Assume names are always known */
+				/* Say so, if the player would hear of it */
+				show = (show_pet_messages && (hidden_pet_messages || m_ptr->ml) &&
+					(cave_feat[p_ptr->py][p_ptr->px] == FEAT_FLOOR));
 
+				/* Acquire the monster names */
+				/* Assume names are always known */
+				if (show)
+				{
 					if (m_ptr->is_pet)
 					{
 						monster_desc(m_name, m_ptr, 0x80);
 						monster_desc(n_name, n_ptr, 0x88);
-						award_exp = TRUE;
 					}
 					else
 					{
 						monster_desc(m_name, m_ptr, 0x88);
 						monster_desc(n_name, n_ptr, 0x80);
-						award_exp = FALSE;
 					}
+				}
 
-					if (show_pet_messages && (hidden_pet_messages || m_ptr->ml) &&
-					    (cave_feat[p_ptr->py][p_ptr->px] == FEAT_FLOOR))
-						msg_format("%^s hits %^s.", m_name, n_name);
+				for (tmp_i = 0; tmp_i < 4; tmp_i++)
+				{
+					if (!(r_ptr->blow[tmp_i].method))
+						break;
+
+					dam =
+						damroll(r_ptr->blow[tmp_i].d_dice,
+						r_ptr->blow[tmp_i].d_side);
+
+					if (show) msg_format("%^s hits %^s.", m_name, n_name);
 
 					if (mon_take_hit(cave_m_idx[ny][nx], dam, &fear,
 							" is killed.", award_exp, TRUE))
@@ -4003,13 +4101,16 @@ static void process_monster(int m_idx)
 
 			mon_process_terrain(m_idx, ny, nx);
 
+			/* Drowned, or the like */
+			if (!m_ptr->r_idx) return;
+
 			/* Possible disturb */
 			if (m_ptr->ml && (disturb_move ||
 					((m_ptr->mflag & (MFLAG_VIEW)) && disturb_near)) &&
 				!m_ptr->is_pet)
 			{
 				/* Disturb */
-				disturb(0, 0);
+				disturb(0, DISTURB_MONSTER);
 			}
 
 
@@ -4210,6 +4311,159 @@ static void process_monster(int m_idx)
 
 
 
+/*
+ * Determine if a monster is far enough away to be "dormant".
+ *
+ * Dormant monsters are awake, but so far from the player that they can
+ * neither notice nor affect anything he cares about, so they only get a
+ * cheap step towards him instead of the full AI.  Pets, guards (which
+ * run their own patrol logic) and monsters hunting pets always get the
+ * full AI, and a monster is promoted back as soon as it comes within
+ * range.
+ *
+ * So does any monster whose turn does more than move: one with a timer
+ * to run down (sleep, stun, confusion, fear), a breeder, an aquatic one,
+ * or one standing on terrain which hurts it.
+ */
+static bool monster_dormant(int m_idx)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+	monster_race *r_ptr = &r_info[m_ptr->r_idx];
+
+	if (m_ptr->cdis <= MONSTER_DORMANT_DIST) return (FALSE);
+	if (m_ptr->cdis <= r_ptr->aaf) return (FALSE);
+
+	if (m_ptr->is_pet) return (FALSE);
+	if (p_ptr->number_pets) return (FALSE);
+
+	if (m_guard_idx[m_idx]) return (FALSE);
+
+	/* Asleep, stunned, confused or afraid (the timers run in the full AI) */
+	if (m_ptr->csleep || m_ptr->stunned || m_ptr->confused ||
+		m_ptr->monfear)
+		return (FALSE);
+
+	/* Calming down */
+	if (m_ptr->mflag & (MFLAG_RETALIATE)) return (FALSE);
+
+	/* Breeders breed, and aquatic monsters dry out, in the full AI */
+	if (r_ptr->flags2 & (RF2_MULTIPLY | RF2_AQUATIC)) return (FALSE);
+
+	/* Standing on something which hurts (see "mon_process_terrain()") */
+	if (mon_terrain(m_ptr, cave_feat[m_ptr->fy][m_ptr->fx]) & (MTERR_MOVE))
+		return (FALSE);
+
+	return (TRUE);
+}
+
+
+/*
+ * Give a dormant monster its turn: a single step towards the player.
+ */
+static void process_monster_dormant(int m_idx)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+	monster_race *r_ptr = &r_info[m_ptr->r_idx];
+
+	int i, dir, dy, dx, y, x;
+
+	int sy[3], sx[3];
+
+	/* Some monsters never move */
+	if (r_ptr->flags1 & (RF1_NEVER_MOVE)) return;
+
+	/* Head for the player */
+	dir = motion_dir(m_ptr->fy, m_ptr->fx, p_ptr->py, p_ptr->px);
+	if (!dir || (dir == 5)) return;
+
+	dy = ddy[dir];
+	dx = ddx[dir];
+
+	/* The direct step */
+	sy[0] = dy;
+	sx[0] = dx;
+
+	/* The two steps next to it */
+	if (dy && dx)
+	{
+		sy[1] = dy; sx[1] = 0;
+		sy[2] = 0; sx[2] = dx;
+	}
+	else if (dy)
+	{
+		sy[1] = dy; sx[1] = 1;
+		sy[2] = dy; sx[2] = -1;
+	}
+	else
+	{
+		sy[1] = 1; sx[1] = dx;
+		sy[2] = -1; sx[2] = dx;
+	}
+
+	/* Take the first step which is open */
+	for (i = 0; i < 3; i++)
+	{
+		y = m_ptr->fy + sy[i];
+		x = m_ptr->fx + sx[i];
+
+		if (!in_bounds_fully(y, x)) continue;
+		if (cave_feat[y][x] == FEAT_UNSEEN) continue;
+		if (!cave_floor_bold(y, x) || is_sanctum_wall(y, x)) continue;
+		if (!monster_floor_allows(r_ptr, y, x)) continue;
+		if (cave_m_idx[y][x] != 0) continue;
+		if (!elev_allows_move(m_ptr->fy, m_ptr->fx, y, x, FALSE)) continue;
+
+		/* A cliff too high, or a fall which killed it */
+		if (!monster_check_cliff_move(m_idx, y, x))
+		{
+			if (!m_ptr->r_idx) return;
+			continue;
+		}
+
+		monster_swap(m_ptr->fy, m_ptr->fx, y, x);
+
+		/* Brambles, oil and the like */
+		mon_process_terrain(m_idx, y, x);
+
+		return;
+	}
+}
+
+
+/*
+ * Process a monster which is allowed to act, using the cheap tier for
+ * far away monsters.  Headless runs also time each tier.
+ */
+static void process_monster_tier(int m_idx)
+{
+	bool dormant = monster_dormant(m_idx);
+	struct timeval tv_start, tv_end;
+
+	if (arg_headless) gettimeofday(&tv_start, NULL);
+
+	if (dormant) process_monster_dormant(m_idx);
+	else process_monster(m_idx);
+
+	if (arg_headless)
+	{
+		gettimeofday(&tv_end, NULL);
+
+		if (dormant)
+		{
+			mon_tier_dormant_us += (tv_end.tv_sec - tv_start.tv_sec) * 1000000L +
+				(tv_end.tv_usec - tv_start.tv_usec);
+			mon_tier_dormant_n++;
+		}
+		else
+		{
+			mon_tier_full_us += (tv_end.tv_sec - tv_start.tv_sec) * 1000000L +
+				(tv_end.tv_usec - tv_start.tv_usec);
+			mon_tier_full_n++;
+		}
+	}
+}
+
+
 /*
  * Process all the "live" monsters, once per game turn.
  *
@@ -4237,6 +4491,11 @@ static void process_monster(int m_idx)
  * Note the special "MFLAG_NICE" flag, which prevents "nasty" monsters from
  * using any of their spell attacks until the player gets a turn.  This flag
  * is optimized via the "repair_mflag_nice" flag.
+ *
+ * Note that monsters cannot "think" apart from acting.  Each monster draws
+ * from the one game RNG and sees the moves, deaths and breeding of the ones
+ * processed before it, so the turn stays serial, and cheap far-away turns
+ * come from "process_monster_dormant()" instead.
  */
 void process_monsters(void)
 {
@@ -4325,8 +4584,8 @@ void process_monsters(void)
 		/* Decrement magnetism */
 		if (m_ptr->magnetized > 0) m_ptr->magnetized--;
 
-		/* Magnetism Trap Check */
-		if (TRUE) {
+		/* Magnetism Trap Check (only metal monsters care) */
+		if (magnet_trap_n && (r_ptr->flags7 & RF7_METAL)) {
 			int dy, dx;
 			bool near_magnet = FALSE;
 			/* Check current and adjacent */
@@ -4338,13 +4597,13 @@ void process_monsters(void)
 					}
 				}
 			}
-			if (near_magnet && (r_ptr->flags7 & RF7_METAL)) {
+			if (near_magnet) {
 				m_ptr->magnetized = 10;
 			}
 		}
 
 		/* Gravity Trap Pull */
-		if (TRUE) {
+		if (gravity_trap_n) {
 			int dy, dx, gy = 0, gx = 0;
 			int min_dist = 999;
 			/* Scan radius 3 */
@@ -4415,7 +4674,7 @@ void process_monsters(void)
 		/* Ancient forgetting logic */
 		if ((r_ptr->flags7 & RF7_ANCIENT) && (m_ptr->mflag & MFLAG_ANCIENT_ENRAGED))
 		{
-			if (los(fy, fx, p_ptr->py, p_ptr->px))
+			if (los(m_ptr->fy, m_ptr->fx, p_ptr->py, p_ptr->px))
 			{
 				m_ptr->mana = 0;
 			}
@@ -4457,7 +4716,7 @@ void process_monsters(void)
 		if (m_ptr->cdis <= r_ptr->aaf || m_ptr->is_pet || m_ptr->csleep == 0)
 		{
 			/* Process the monster */
-			process_monster(i);
+			process_monster_tier(i);
 
 			/* Continue */
 			continue;
@@ -4471,7 +4730,7 @@ void process_monsters(void)
 		if (player_has_los_bold(fy, fx))
 		{
 			/* Process the monster */
-			process_monster(i);
+			process_monster_tier(i);
 
 			/* Continue */
 			continue;
@@ -4486,12 +4745,12 @@ void process_monsters(void)
 			int px = p_ptr->px;
 
 			/* Check the flow (normal aaf is about 20) */
-			if ((cave_when[fy][fx] == cave_when[py][px]) &&
-				(cave_cost[fy][fx] < MONSTER_FLOW_DEPTH) &&
-				(cave_cost[fy][fx] < r_ptr->aaf))
+			if ((cave_flow[fy][fx].when == cave_flow[py][px].when) &&
+				(cave_flow[fy][fx].cost < MONSTER_FLOW_DEPTH) &&
+				(cave_flow[fy][fx].cost < r_ptr->aaf))
 			{
 				/* Process the monster */
-				process_monster(i);
+				process_monster_tier(i);
 
 				/* Continue */
 				continue;
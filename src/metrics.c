@@ -0,0 +1,708 @@
+/* File: metrics.c */
+
+/*
+ * Metrics for headless games
+ *
+ * Every "log_metric()" event goes to one sink, opened the first time it
+ * is needed and kept open, with a large buffer which is written out
+ * every METRIC_FLUSH_MSEC milliseconds and at exit.  The resident set
+ * size is sampled every "arg_metrics_rss_msec" milliseconds, not once
+ * per event.
+ *
+ * The sink is "kamband_stats.csv", as it always was, or, with the
+ * "--metrics-bin" option, "kamband_stats.bin" (see below).  The names
+ * of all these files may be given a prefix (see "metric_prefix()").
+ *
+ * Each kind of event also gets a histogram of its values in memory,
+ * with power-of-two buckets, which is written at exit: to the end of
+ * the binary sink, or to "kamband_hist.csv" as the count, total, least,
+ * greatest, and (upper bounds of) the median, 90th and 99th percentile.
+ *
+ * The binary sink starts with "KMET" and a version byte (1).  Then come
+ * records, each an opcode byte and its operands (LSB first):
+ *
+ *	'N' id len c0..clen-1	the name of event "id" (first use only)
+ *	'R' id turn:4 value:4 mem_kb:4 depth:2 x:2 y:2 elev:1
+ *	'H' id count:4 total:4 min:4 max:4 b0:4 .. b31:4
+ *
+ * Bucket 0 counts values of zero (or less), and bucket "n" values from
+ * 2^(n-1) to 2^n-1.
+ *
+ * The memory live under each tag (see "z-virt.h") is logged with each
+ * level, as "mem_<tag>_kb", with the most ever live as "mem_peak_kb".
+ *
+ * The hot paths of a game turn are timed with "metric_start()" and
+ * "metric_stop()", in microseconds of a monotonic clock, and each turn
+ * "metric_turn()" logs how long each of them took as an event of its
+ * own ("process_world_us" and so on).  The timers are inclusive, so
+ * "process_world_us" counts "process_dread_us" as well, and a timer
+ * which is started again before it stops (as "project()" may be) only
+ * counts the outermost call.  The sampling profiler (see "prof.c") uses
+ * the same timers.
+ *
+ * The stages of level generation are timed with "metric_stage()", each
+ * logged as an event of its own ("gen_rooms_us" and so on) as soon as
+ * the next stage starts, so the memory logged with it is the memory at
+ * the end of that stage.
+ */
+
+#include "angband.h"
+
+#include <time.h>
+#include <sys/time.h>
+
+#if defined(__linux__) || defined(__linux) || defined(linux) || defined(__gnu_linux__)
+#include <unistd.h>
+#else
+#include <sys/resource.h>
+#endif
+
+
+/*
+ * One kind of event
+ */
+typedef struct metric_type metric_type;
+
+struct metric_type
+{
+	cptr name;
+
+	u32b count;
+	u32b total;
+	long min;
+	long max;
+
+	u32b bucket[METRIC_BUCKETS];
+};
+
+
+/*
+ * The kinds of event seen so far
+ */
+static metric_type metric_types[METRIC_MAX_EVENTS];
+static int metric_num = 0;
+
+/*
+ * The sink, and its buffer
+ */
+static FILE *metric_fff = NULL;
+static char metric_buf[65536];
+
+/*
+ * Put in front of the names of the files
+ */
+static char metric_pfx[128] = "";
+
+/*
+ * The sink could not be opened
+ */
+static bool metric_failed = FALSE;
+
+/*
+ * When the sink was last written
+ */
+static u32b metric_flushed;
+
+/*
+ * The last sample of the resident set size, and when it was taken
+ */
+static long metric_rss = 0;
+static u32b metric_rss_when;
+static bool metric_rss_known = FALSE;
+
+
+/*
+ * The level generation stage running now, and when it started
+ */
+static cptr metric_stage_name = NULL;
+static u32b metric_stage_began;
+
+
+/*
+ * One hot-path timer
+ */
+typedef struct metric_timer metric_timer;
+
+struct metric_timer
+{
+	cptr name;
+
+	int depth;		/* Calls still running */
+	u32b began;		/* When the outermost one started */
+
+	u32b total;		/* Microseconds this turn */
+	bool used;		/* Started this turn */
+};
+
+
+/*
+ * The hot-path timers (in the order of the METRIC_T_* constants)
+ */
+static metric_timer metric_timers[METRIC_TIMERS] =
+{
+	{ "process_world_us" },
+	{ "process_environment_us" },
+	{ "process_active_terrain_us" },
+	{ "process_dread_us" },
+	{ "process_monsters_us" },
+	{ "update_view_us" },
+	{ "update_lite_us" },
+	{ "update_flow_us" },
+	{ "update_monsters_us" },
+	{ "project_us" },
+	{ "handle_stuff_us" },
+	{ "get_moves_us" },
+	{ "get_moves_target_us" },
+	{ "get_moves_route_us" },
+	{ "process_terrain_us" },
+};
+
+
+/*
+ * Get the resident set size, in kilobytes
+ */
+long get_current_rss_kb(void)
+{
+#if defined(__linux__) || defined(__linux) || defined(linux) || defined(__gnu_linux__)
+	FILE* fp = fopen("/proc/self/statm", "r");
+	long rss = 0;
+	if (fp)
+	{
+		long dummy;
+		if (fscanf(fp, "%ld %ld", &dummy, &rss) == 2)
+		{
+			rss *= (sysconf(_SC_PAGESIZE) / 1024);
+		}
+		fclose(fp);
+	}
+	return rss;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+#endif
+}
+
+
+/*
+ * Write a number to the binary sink (LSB first)
+ */
+static void metric_put(long v, int n)
+{
+	while (n--)
+	{
+		putc((int)(v & 0xFF), metric_fff);
+		v >>= 8;
+	}
+}
+
+
+/*
+ * Find the bucket of a value
+ */
+static int metric_bucket(long v)
+{
+	int b = 0;
+
+	while ((v > 0) && (b < METRIC_BUCKETS - 1))
+	{
+		v >>= 1;
+		b++;
+	}
+
+	return (b);
+}
+
+
+/*
+ * Estimate (from above) the value below which "pct" percent of the
+ * events of a kind fall
+ */
+static long metric_percentile(metric_type *mt, int pct)
+{
+	u32b want = (mt->count * (u32b)pct + 99) / 100;
+	u32b seen = 0;
+	int b;
+
+	for (b = 0; b < METRIC_BUCKETS; b++)
+	{
+		seen += mt->bucket[b];
+		if (seen >= want) break;
+	}
+
+	if (b == 0) return (0);
+
+	/* Never more than the greatest */
+	return (MIN((1L << b) - 1, mt->max));
+}
+
+
+/*
+ * Write the histograms and close the sink
+ */
+static void metric_close(void)
+{
+	FILE *fff;
+	char name[256];
+	int i, b;
+
+	if (!metric_fff) return;
+
+	/* Binary -- at the end of the sink */
+	if (arg_metrics_binary)
+	{
+		for (i = 0; i < metric_num; i++)
+		{
+			metric_type *mt = &metric_types[i];
+
+			putc('H', metric_fff);
+			metric_put(i, 1);
+			metric_put(mt->count, 4);
+			metric_put(mt->total, 4);
+			metric_put(mt->min, 4);
+			metric_put(mt->max, 4);
+
+			for (b = 0; b < METRIC_BUCKETS; b++) metric_put(mt->bucket[b], 4);
+		}
+	}
+
+	fclose(metric_fff);
+	metric_fff = NULL;
+
+	if (arg_metrics_binary) return;
+
+	/* Text -- in a file of their own */
+	strnfmt(name, sizeof(name), "%skamband_hist.csv", metric_pfx);
+	fff = fopen(name, "w");
+	if (!fff) return;
+
+	fprintf(fff, "event_type,count,total,min,max,p50,p90,p99\n");
+
+	for (i = 0; i < metric_num; i++)
+	{
+		metric_type *mt = &metric_types[i];
+
+		fprintf(fff, "%s,%lu,%lu,%ld,%ld,%ld,%ld,%ld\n", mt->name,
+		        (unsigned long)mt->count, (unsigned long)mt->total,
+		        mt->min, mt->max, metric_percentile(mt, 50),
+		        metric_percentile(mt, 90), metric_percentile(mt, 99));
+	}
+
+	fclose(fff);
+}
+
+
+/*
+ * Open the sink, appending to what is there
+ */
+static bool metric_open(void)
+{
+	char name[256];
+
+	if (metric_fff) return (TRUE);
+	if (metric_failed) return (FALSE);
+
+	strnfmt(name, sizeof(name), "%skamband_stats.%s", metric_pfx,
+	        arg_metrics_binary ? "bin" : "csv");
+
+	metric_fff = fopen(name, arg_metrics_binary ? "ab" : "a");
+
+	if (!metric_fff)
+	{
+		metric_failed = TRUE;
+		return (FALSE);
+	}
+
+	setvbuf(metric_fff, metric_buf, _IOFBF, sizeof(metric_buf));
+
+	/* A new file needs a header */
+	fseek(metric_fff, 0, SEEK_END);
+	if (ftell(metric_fff) == 0)
+	{
+		if (arg_metrics_binary)
+		{
+			fputs("KMET", metric_fff);
+			putc(1, metric_fff);
+		}
+		else
+		{
+			fprintf(metric_fff, "turn,event_type,duration_ms,mem_kb,depth,x,y,elevation\n");
+		}
+	}
+
+	metric_flushed = msec_clock();
+
+	/* Write the rest at exit (the signal handlers get here too) */
+	atexit(metric_close);
+
+	return (TRUE);
+}
+
+
+/*
+ * Put "prefix" in front of the names of the files (before they are opened)
+ */
+void metric_prefix(cptr prefix)
+{
+	strnfmt(metric_pfx, sizeof(metric_pfx), "%s", prefix);
+}
+
+
+/*
+ * Find (or add) a kind of event
+ */
+static int metric_find(cptr name)
+{
+	int i;
+
+	for (i = 0; i < metric_num; i++)
+	{
+		if (streq(metric_types[i].name, name)) return (i);
+	}
+
+	/* Too many */
+	if (metric_num >= METRIC_MAX_EVENTS) return (-1);
+
+	metric_types[i].name = string_make(name);
+	metric_types[i].min = 0x7FFFFFFFL;
+	metric_types[i].max = 0;
+	metric_num++;
+
+	/* Name it */
+	if (arg_metrics_binary)
+	{
+		int len = strlen(name);
+
+		if (len > 255) len = 255;
+
+		putc('N', metric_fff);
+		metric_put(i, 1);
+		metric_put(len, 1);
+		fwrite(name, 1, len, metric_fff);
+	}
+
+	return (i);
+}
+
+
+/*
+ * Note an event of a headless game
+ */
+void log_metric(const char *event_type, long duration_ms)
+{
+	metric_type *mt;
+	u32b now;
+	int i, elev;
+
+	if (!arg_headless) return;
+
+	if (!metric_open()) return;
+
+	i = metric_find(event_type);
+	if (i < 0) return;
+
+	now = msec_clock();
+
+	/* Sample the memory now and then */
+	if (!metric_rss_known || (now - metric_rss_when >= (u32b)arg_metrics_rss_msec))
+	{
+		metric_rss = get_current_rss_kb();
+		metric_rss_when = now;
+		metric_rss_known = TRUE;
+	}
+
+	/* Histogram */
+	mt = &metric_types[i];
+	mt->count++;
+	mt->total += duration_ms;
+	if (duration_ms < mt->min) mt->min = duration_ms;
+	if (duration_ms > mt->max) mt->max = duration_ms;
+	mt->bucket[metric_bucket(duration_ms)]++;
+
+	elev = get_elevation(p_ptr->py, p_ptr->px);
+
+	/* The event */
+	if (arg_metrics_binary)
+	{
+		putc('R', metric_fff);
+		metric_put(i, 1);
+		metric_put((long)turn, 4);
+		metric_put(duration_ms, 4);
+		metric_put(metric_rss, 4);
+		metric_put(p_ptr->depth, 2);
+		metric_put(p_ptr->px, 2);
+		metric_put(p_ptr->py, 2);
+		metric_put(elev, 1);
+	}
+	else
+	{
+		fprintf(metric_fff, "%ld,%s,%ld,%ld,%d,%d,%d,%d\n",
+		        (long)turn, event_type, duration_ms, metric_rss,
+		        (int)p_ptr->depth, (int)p_ptr->px, (int)p_ptr->py, elev);
+	}
+
+	/* Write it out now and then */
+	if (now - metric_flushed >= METRIC_FLUSH_MSEC)
+	{
+		fflush(metric_fff);
+		metric_flushed = now;
+	}
+}
+
+
+/*
+ * The name of the file "name", with the prefix
+ */
+void metric_path(char *buf, size_t max, cptr name)
+{
+	strnfmt(buf, max, "%s%s", metric_pfx, name);
+}
+
+
+/*
+ * Add a part to the memory census
+ */
+static void census_part(census_type *c_ptr, cptr name, long bytes,
+	long used, long max)
+{
+	c_ptr->name = name;
+	c_ptr->bytes = bytes;
+	c_ptr->used = used;
+	c_ptr->max = max;
+}
+
+
+/*
+ * Take a census of the memory, by the part of the game holding it
+ *
+ * Fills "c_ptr" with the CENSUS_PARTS parts, and returns how many are
+ * "full" (a pool with CENSUS_PRESSURE percent of its slots taken).  The
+ * arrays of the level are counted whole, whatever the size of the level.
+ * The monster pool counts "m_max", which only grows on a level, so it is
+ * the most monsters there have been; the objects are those on the floor.
+ */
+int memory_census(census_type *c_ptr)
+{
+	object_type *o_ptr;
+	s32b live, slabs;
+	long objects = 0L;
+	long quark_bytes = (long)QUARK_MAX * (long)sizeof(cptr);
+	int i, full = 0;
+
+	for (o_ptr = o_list; o_ptr != NULL; o_ptr = o_ptr->next_global) objects++;
+
+	object_pool_stats(&live, &slabs);
+
+#ifdef VIRT_TRACK
+
+	/* The text of the quarks */
+	quark_bytes += (long)virt_counts[MEM_QUARK].bytes;
+
+#endif /* VIRT_TRACK */
+
+	census_part(&c_ptr[0], "grid",
+		(long)(sizeof(game_ptr->flow) + sizeof(game_ptr->grid) +
+		sizeof(game_ptr->info) + sizeof(game_ptr->sector) +
+		sizeof(game_ptr->feat) + sizeof(game_ptr->light) +
+		sizeof(game_ptr->elev_walk) + sizeof(game_ptr->o_idx) +
+		sizeof(game_ptr->m_idx)), 0L, 0L);
+
+	census_part(&c_ptr[1], "objects",
+		(long)slabs * OBJECT_SLAB * (long)sizeof(object_type),
+		objects, (long)MAX_O_IDX);
+
+	census_part(&c_ptr[2], "monsters",
+		(long)(sizeof(game_ptr->monsters) + sizeof(game_ptr->mon_free) +
+		sizeof(game_ptr->mon_gen)), (long)m_max, (long)MAX_M_IDX);
+
+	census_part(&c_ptr[3], "guards",
+		(long)(sizeof(game_ptr->guards) + sizeof(game_ptr->guard_idx)),
+		(long)m_guard_max, (long)MAX_GUARDS);
+
+	census_part(&c_ptr[4], "cover", (long)sizeof(game_ptr->cover),
+		(long)cave_cover_n, (long)COVER_SLOTS);
+
+	census_part(&c_ptr[5], "messages",
+		(long)MESSAGE_MAX * (long)sizeof(message_type), 0L, 0L);
+
+	census_part(&c_ptr[6], "quarks", quark_bytes, (long)quark__num,
+		(long)QUARK_MAX);
+
+	census_part(&c_ptr[7], "alloc",
+		(long)(alloc_kind_size + alloc_race_size) * (long)sizeof(alloc_entry),
+		0L, 0L);
+
+	census_part(&c_ptr[8], "lua", script_memory(), 0L, 0L);
+
+	/* Count the full pools */
+	for (i = 0; i < CENSUS_PARTS; i++)
+	{
+		if (!c_ptr[i].max) continue;
+
+		if (c_ptr[i].used * 100 >= c_ptr[i].max * CENSUS_PRESSURE) full++;
+	}
+
+	return (full);
+}
+
+
+/*
+ * Log the memory live under each tag, and the most ever live, and the
+ * census of the level
+ */
+void metric_memory(void)
+{
+	census_type census[CENSUS_PARTS];
+	char name[40];
+	int i, full;
+
+#ifdef VIRT_TRACK
+
+	for (i = 0; i < MEM_TAGS; i++)
+	{
+		strnfmt(name, sizeof(name), "mem_%s_kb", mem_tag_names[i]);
+		log_metric(name, (long)(virt_counts[i].bytes / 1024));
+	}
+
+	log_metric("mem_peak_kb", (long)(virt_total.peak / 1024));
+
+#endif /* VIRT_TRACK */
+
+	full = memory_census(census);
+
+	for (i = 0; i < CENSUS_PARTS; i++)
+	{
+		census_type *c_ptr = &census[i];
+
+		strnfmt(name, sizeof(name), "census_%s_kb", c_ptr->name);
+		log_metric(name, c_ptr->bytes / 1024);
+
+		if (!c_ptr->max) continue;
+
+		/* How full the pool is, in percent */
+		strnfmt(name, sizeof(name), "census_%s_pct", c_ptr->name);
+		log_metric(name, c_ptr->used * 100 / c_ptr->max);
+	}
+
+	/* The pools which are nearly full */
+	log_metric("census_full_pools", (long)full);
+}
+
+
+/*
+ * Microseconds since some fixed time, which never goes backwards if the
+ * system can help it
+ */
+static u32b metric_usec(void)
+{
+#ifdef CLOCK_MONOTONIC
+
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+	{
+		return ((u32b)ts.tv_sec * 1000000UL + (u32b)(ts.tv_nsec / 1000));
+	}
+
+#endif /* CLOCK_MONOTONIC */
+
+	{
+		struct timeval tv;
+
+		gettimeofday(&tv, NULL);
+		return ((u32b)tv.tv_sec * 1000000UL + (u32b)tv.tv_usec);
+	}
+}
+
+
+/*
+ * Start the hot-path timer "t"
+ */
+void metric_start(int t)
+{
+	metric_timer *mt = &metric_timers[t];
+
+	/* The sampling profiler keeps a stack of them */
+	prof_push(t);
+
+	if (!arg_headless) return;
+
+	if (mt->depth++) return;
+
+	mt->began = metric_usec();
+	mt->used = TRUE;
+}
+
+
+/*
+ * Stop the hot-path timer "t"
+ */
+void metric_stop(int t)
+{
+	metric_timer *mt = &metric_timers[t];
+
+	prof_pop();
+
+	if (!arg_headless) return;
+
+	/* Paranoia */
+	if (!mt->depth) return;
+
+	if (--mt->depth) return;
+
+	mt->total += metric_usec() - mt->began;
+}
+
+
+/*
+ * The name of the hot-path timer "t"
+ */
+cptr metric_timer_name(int t)
+{
+	return (metric_timers[t].name);
+}
+
+
+/*
+ * Log the hot-path timers for this game turn, and start them again
+ */
+void metric_turn(void)
+{
+	int t;
+
+	if (!arg_headless) return;
+
+	for (t = 0; t < METRIC_TIMERS; t++)
+	{
+		metric_timer *mt = &metric_timers[t];
+
+		if (!mt->used) continue;
+
+		log_metric(mt->name, (long)mt->total);
+
+		mt->total = 0;
+		mt->used = (mt->depth > 0);
+	}
+}
+
+
+/*
+ * Log the level generation stage which is running, if any, and start
+ * the stage "name" (or none, if "name" is NULL)
+ */
+void metric_stage(cptr name)
+{
+	u32b now;
+
+	if (!arg_headless) return;
+
+	now = metric_usec();
+
+	if (metric_stage_name)
+	{
+		log_metric(metric_stage_name, (long)(now - metric_stage_began));
+	}
+
+	metric_stage_name = name;
+	metric_stage_began = now;
+}
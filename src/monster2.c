@@ -13,6 +13,187 @@
 static bool hack_ood_summon = FALSE;
 
 
+/*
+ * The monster bucket grid.
+ *
+ * Every live monster is linked into the bucket of the block it stands
+ * in, so that "who is near this grid?" only looks at nearby blocks
+ * instead of the whole "m_list[]".  See "monster_near()".
+ *
+ * Each bucket also counts the breeders in it (see "monster_may_multiply()").
+ */
+static s16b mon_bucket_head[MON_BUCKET_ROWS][MON_BUCKET_COLS];
+static s16b mon_bucket_repro[MON_BUCKET_ROWS][MON_BUCKET_COLS];
+static s16b mon_bucket_next[MAX_M_IDX];
+static s16b mon_bucket_prev[MAX_M_IDX];
+static s16b mon_bucket_cell[MAX_M_IDX];
+
+
+/*
+ * Unlink a monster from its bucket
+ */
+static void mon_bucket_remove(int m_idx)
+{
+	int cell = mon_bucket_cell[m_idx];
+	int prev = mon_bucket_prev[m_idx];
+	int next = mon_bucket_next[m_idx];
+
+	/* Not in any bucket */
+	if (cell < 0) return;
+
+	if (prev) mon_bucket_next[prev] = next;
+	else mon_bucket_head[cell / MON_BUCKET_COLS][cell % MON_BUCKET_COLS] = next;
+
+	if (next) mon_bucket_prev[next] = prev;
+
+	if (r_info[m_list[m_idx].r_idx].flags2 & (RF2_MULTIPLY))
+		mon_bucket_repro[cell / MON_BUCKET_COLS][cell % MON_BUCKET_COLS]--;
+
+	mon_bucket_cell[m_idx] = -1;
+}
+
+
+/*
+ * Link a monster into the bucket of its current location
+ */
+static void mon_bucket_add(int m_idx)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+
+	int by = m_ptr->fy / BLOCK_HGT;
+	int bx = m_ptr->fx / BLOCK_WID;
+
+	int head = mon_bucket_head[by][bx];
+
+	mon_bucket_cell[m_idx] = by * MON_BUCKET_COLS + bx;
+	mon_bucket_prev[m_idx] = 0;
+	mon_bucket_next[m_idx] = head;
+
+	if (head) mon_bucket_prev[head] = m_idx;
+
+	mon_bucket_head[by][bx] = m_idx;
+
+	if (r_info[m_ptr->r_idx].flags2 & (RF2_MULTIPLY)) mon_bucket_repro[by][bx]++;
+}
+
+
+/*
+ * Move a monster to the bucket of its (new) location, if needed
+ */
+static void mon_bucket_move(int m_idx)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+
+	int cell = (m_ptr->fy / BLOCK_HGT) * MON_BUCKET_COLS +
+	           (m_ptr->fx / BLOCK_WID);
+
+	/* Same block */
+	if (cell == mon_bucket_cell[m_idx]) return;
+
+	mon_bucket_remove(m_idx);
+	mon_bucket_add(m_idx);
+}
+
+
+/*
+ * Rebuild the bucket grid from scratch (after generation or loading)
+ */
+void rebuild_monster_buckets(void)
+{
+	int i;
+
+	/* Empty every bucket */
+	(void)C_WIPE(&mon_bucket_head[0][0], MON_BUCKET_ROWS * MON_BUCKET_COLS, s16b);
+	(void)C_WIPE(&mon_bucket_repro[0][0], MON_BUCKET_ROWS * MON_BUCKET_COLS, s16b);
+
+	for (i = 0; i < MAX_M_IDX; i++) mon_bucket_cell[i] = -1;
+
+	/* Link every live monster */
+	for (i = 1; i < m_max; i++)
+	{
+		if (!m_list[i].r_idx) continue;
+
+		mon_bucket_add(i);
+	}
+}
+
+
+/*
+ * Is there room in its block for a breeder to multiply?
+ *
+ * Besides the "num_repro" cap on the whole level, each block of the bucket
+ * grid holds at most MAX_REPRO_BLOCK breeders, or MAX_REPRO_FAR out of the
+ * player's sight, so that a far-off colony stays a small one (and cheap)
+ * until the player comes near, instead of filling the level.
+ */
+bool monster_may_multiply(int m_idx)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+
+	int n = mon_bucket_repro[m_ptr->fy / BLOCK_HGT][m_ptr->fx / BLOCK_WID];
+
+	if (n >= MAX_REPRO_BLOCK) return (FALSE);
+
+	if ((m_ptr->cdis > MAX_SIGHT) && (n >= MAX_REPRO_FAR)) return (FALSE);
+
+	return (TRUE);
+}
+
+
+/*
+ * Collect the live monsters within "distance()" "rad" of (y,x).
+ *
+ * Up to "max" indexes are stored in "who", in decreasing index order
+ * within each bucket (the order of the buckets is unspecified).
+ * Returns the number of monsters found.
+ *
+ * Note the optimized "inline" version of the "distance()" function,
+ * which first drops the monsters outside the bounding square (the
+ * distance is never less than the larger of "dy" and "dx").
+ */
+int monster_near(int y, int x, int rad, s16b *who, int max)
+{
+	int by, bx, by1, bx1, by2, bx2;
+	int num = 0;
+
+	/* Blocks touched by the bounding square */
+	by1 = MAX(y - rad, 0) / BLOCK_HGT;
+	bx1 = MAX(x - rad, 0) / BLOCK_WID;
+	by2 = MIN(y + rad, DUNGEON_HGT - 1) / BLOCK_HGT;
+	bx2 = MIN(x + rad, DUNGEON_WID - 1) / BLOCK_WID;
+
+	for (by = by1; by <= by2; by++)
+	{
+		for (bx = bx1; bx <= bx2; bx++)
+		{
+			int i;
+
+			for (i = mon_bucket_head[by][bx]; i; i = mon_bucket_next[i])
+			{
+				monster_type *m_ptr = &m_list[i];
+				int dy, dx;
+
+				dy = (y > m_ptr->fy) ? (y - m_ptr->fy) : (m_ptr->fy - y);
+				if (dy > rad) continue;
+
+				dx = (x > m_ptr->fx) ? (x - m_ptr->fx) : (m_ptr->fx - x);
+				if (dx > rad) continue;
+
+				/* Approximate distance */
+				if (((dy > dx) ? (dy + (dx >> 1)) : (dx + (dy >> 1))) > rad)
+					continue;
+
+				if (num >= max) return (num);
+
+				who[num++] = i;
+			}
+		}
+	}
+
+	return (num);
+}
+
+
 /*
  * Delete a monster by index.
  *
@@ -38,6 +219,9 @@ void delete_monster_idx(int i)
 	/* Hack -- Reduce the racial counter */
 	r_ptr->cur_num--;
 
+	/* A unique may be legal again */
+	if (r_ptr->flags1 & (RF1_UNIQUE)) mon_alloc_epoch++;
+
 	/* Hack -- count the number of "reproducers" */
 	if (r_ptr->flags2 & (RF2_MULTIPLY))
 		num_repro--;
@@ -59,6 +243,9 @@ void delete_monster_idx(int i)
 	/* Monster is gone */
 	cave_m_idx[y][x] = 0;
 
+	/* Forget its bucket */
+	mon_bucket_remove(i);
+
 
 	/* Delete objects */
 	o_ptr = m_ptr->inventory;
@@ -85,6 +272,12 @@ void delete_monster_idx(int i)
 	/* Wipe the Monster */
 	WIPE(m_ptr, monster_type);
 
+	/* Old handles are stale */
+	m_gen[i]++;
+
+	/* Keep the slot for the next monster */
+	m_free[m_free_n++] = i;
+
 	/* Count monsters */
 	m_cnt--;
 
@@ -133,6 +326,9 @@ static void compact_monsters_aux(int i1, int i2)
 	/* Update the cave */
 	cave_m_idx[y][x] = i2;
 
+	/* Update the bucket grid */
+	mon_bucket_remove(i1);
+
 	/* Hack -- Update the target */
 	if (p_ptr->target_who == i1)
 		p_ptr->target_who = i2;
@@ -144,8 +340,18 @@ static void compact_monsters_aux(int i1, int i2)
 	/* Hack -- move monster */
 	COPY(&m_list[i2], &m_list[i1], monster_type);
 
+	/* Old handles to either slot are stale */
+	m_gen[i1]++;
+	m_gen[i2]++;
+
+	/* Move its guard data along */
+	move_guard_data(i1, i2);
+
 	/* Hack -- wipe hole */
 	WIPE(&m_list[i1], monster_type);
+
+	/* Relink under the new index */
+	mon_bucket_add(i2);
 }
 
 
@@ -250,6 +456,9 @@ void compact_monsters(int size)
 		/* Compress "m_max" */
 		m_max--;
 	}
+
+	/* No holes are left */
+	m_free_n = 0;
 }
 
 
@@ -281,16 +490,31 @@ void wipe_m_list(void)
 		/* Hack -- Reduce the racial counter */
 		r_ptr->cur_num--;
 
+		/* A unique may be legal again */
+		if (r_ptr->flags1 & (RF1_UNIQUE)) mon_alloc_epoch++;
+
 		/* Monster is gone */
 		cave_m_idx[m_ptr->fy][m_ptr->fx] = 0;
 
 		/* Wipe the Monster */
 		WIPE(m_ptr, monster_type);
+
+		/* Old handles are stale */
+		m_gen[i]++;
 	}
 
 	/* Reset "m_max" */
 	m_max = 1;
 
+	/* No holes */
+	m_free_n = 0;
+
+	/* Forget the guard data */
+	init_patrol_system();
+
+	/* Empty the bucket grid */
+	rebuild_monster_buckets();
+
 	/* Reset "m_cnt" */
 	m_cnt = 0;
 
@@ -308,6 +532,9 @@ void wipe_m_list(void)
 /*
  * Acquires and returns the index of a "free" monster.
  *
+ * The slots of dead monsters are used first (the last to die first), so
+ * that "m_max" only grows when every slot below it is in use.
+ *
  * This routine should almost never fail, but it *can* happen.
  */
 s16b m_pop(void)
@@ -315,39 +542,33 @@ s16b m_pop(void)
 	int i;
 
 
-	/* Normal allocation */
-	if (m_max < MAX_M_IDX)
+	/* Recycle dead monsters */
+	if (m_free_n)
 	{
-		/* Access the next hole */
-		i = m_max;
-
-		/* Expand the array */
-		m_max++;
+		/* Access the last hole */
+		i = m_free[--m_free_n];
 
 		/* Count monsters */
 		m_cnt++;
 
-		/* Return the index */
+		/* Use this monster */
 		return (i);
 	}
 
 
-	/* Recycle dead monsters */
-	for (i = 1; i < m_max; i++)
+	/* Normal allocation */
+	if (m_max < MAX_M_IDX)
 	{
-		monster_type *m_ptr;
-
-		/* Acquire monster */
-		m_ptr = &m_list[i];
+		/* Access the next hole */
+		i = m_max;
 
-		/* Skip live monsters */
-		if (m_ptr->r_idx)
-			continue;
+		/* Expand the array */
+		m_max++;
 
 		/* Count monsters */
 		m_cnt++;
 
-		/* Use this monster */
+		/* Return the index */
 		return (i);
 	}
 
@@ -361,6 +582,38 @@ s16b m_pop(void)
 }
 
 
+/*
+ * A handle on the monster "m_idx", which "m_handle_idx()" takes back
+ * to "m_idx" for as long as that monster lives in that slot.
+ *
+ * Something which must remember a monster from one game turn to the
+ * next, without being told when it dies or moves (by "compact_monsters()"),
+ * can keep a handle, and check it cheaply when it needs the monster.
+ */
+u32b m_handle(int m_idx)
+{
+	return (((u32b)m_gen[m_idx] << 16) | (u32b)m_idx);
+}
+
+
+/*
+ * The monster named by the handle "h", or zero if it is gone
+ */
+int m_handle_idx(u32b h)
+{
+	int m_idx = (int)(h & 0xFFFF);
+
+	/* Paranoia */
+	if (!m_idx || (m_idx >= m_max)) return (0);
+
+	/* Dead, or moved, or another monster */
+	if ((u16b)(h >> 16) != m_gen[m_idx]) return (0);
+	if (!m_list[m_idx].r_idx) return (0);
+
+	return (m_idx);
+}
+
+
 /*
  * Apply a "monster restriction function" to the "monster allocation table"
  */
@@ -390,12 +643,44 @@ errr get_mon_num_prep(void)
 		}
 	}
 
+	/* Forget the cached totals */
+	mon_alloc_epoch++;
+
 	/* Success */
 	return (0);
 }
 
 
 
+/*
+ * The cached totals of the monster allocation table
+ */
+static alloc_cache mon_alloc_cache;
+
+
+/*
+ * Find the entry of a cached allocation table holding "value", which
+ * must be less than the total.
+ *
+ * This is the first entry whose running total exceeds "value", which
+ * is the entry a linear walk subtracting each "prob3" would stop at.
+ */
+int alloc_cache_find(alloc_cache *c_ptr, long value)
+{
+	int lo = 0, hi = c_ptr->num - 1;
+
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+
+		if (c_ptr->cum[mid] > value) hi = mid;
+		else lo = mid + 1;
+	}
+
+	return (lo);
+}
+
+
 /*
  * Choose a monster race that seems "appropriate" to the given level
  *
@@ -417,6 +702,9 @@ errr get_mon_num_prep(void)
  *
  * Note that if no monsters are "appropriate", then this function will
  * fail, and return zero, but this should *almost* never happen.
+ *
+ * The legal part of the table is summed up once for each level and set
+ * of restrictions, so that consecutive picks are binary searches.
  */
 s16b get_mon_num(int level)
 {
@@ -424,12 +712,16 @@ s16b get_mon_num(int level)
 
 	int r_idx;
 
-	long value, total;
+	long total;
+
+	u32b flags;
 
 	monster_race *r_ptr;
 
 	alloc_entry *table = alloc_race_table;
 
+	alloc_cache *c_ptr = &mon_alloc_cache;
+
 
 	/* Boost the level */
 	if (level > 0)
@@ -456,81 +748,105 @@ s16b get_mon_num(int level)
 	}
 
 
-	/* Reset total */
-	total = 0L;
+	/* Current restrictions */
+	flags = 0L;
+	if (unfair_monsters) flags |= (ALLOC_CACHE_UNFAIR);
+	if (hack_ood_summon) flags |= (ALLOC_CACHE_OOD);
+	if (p_ptr->is_evil) flags |= (ALLOC_CACHE_EVIL);
+	if (p_ptr->inside_special == SPECIAL_WILD) flags |= (ALLOC_CACHE_WILD);
 
-	/* Process probabilities */
-	for (i = 0; i < alloc_race_size; i++)
+	/* Reuse the totals if nothing has changed */
+	if (c_ptr->valid && (c_ptr->level == level) &&
+		(c_ptr->depth == p_ptr->depth) && (c_ptr->flags == flags) &&
+		(c_ptr->epoch == mon_alloc_epoch))
 	{
-		/* Monsters are sorted by depth */
-		if (table[i].level > level)
-			break;
-
-		/* Default */
-		table[i].prob3 = 0;
+		alloc_cache_hits++;
+	}
 
-		/* Hack -- No town monsters in dungeon */
-		if ((level > 0) && (table[i].level <= 0) &&
-			p_ptr->inside_special != SPECIAL_WILD)
-			continue;
+	else
+	{
+		alloc_cache_misses++;
 
-		/* Access the "r_idx" of the chosen monster */
-		r_idx = table[i].index;
+		if (!c_ptr->cum) C_MAKE(c_ptr->cum, alloc_race_size, long);
 
-		/* Access the actual race */
-		r_ptr = &r_info[r_idx];
+		/* Reset total */
+		total = 0L;
 
-		/* Don't ever summon unfair monsters. */
-		if (!unfair_monsters && r_ptr->flags7 & RF7_UNFAIR)
+		/* Process probabilities */
+		for (i = 0; i < alloc_race_size; i++)
 		{
-			continue;
-		}
+			/* Monsters are sorted by depth */
+			if (table[i].level > level)
+				break;
 
-		/* Hack -- "unique" monsters must be "unique" */
-		if ((r_ptr->flags1 & (RF1_UNIQUE)) &&
-			(r_ptr->cur_num >= r_ptr->max_num))
-		{
-			continue;
-		}
+			/* Default */
+			table[i].prob3 = 0;
+			c_ptr->cum[i] = total;
 
-		/* Depth Monsters never appear out of depth */
-		if (!hack_ood_summon && (r_ptr->flags1 & (RF1_FORCE_DEPTH)) &&
-			(r_ptr->level > p_ptr->depth))
-		{
-			continue;
-		}
+			/* Hack -- No town monsters in dungeon */
+			if ((level > 0) && (table[i].level <= 0) &&
+				p_ptr->inside_special != SPECIAL_WILD)
+				continue;
 
-		/* Don't generate inappropriate monsters. */
-		if (!p_ptr->is_evil && r_ptr->flags3 & (RF3_STAR_GOOD))
-		{
-			continue;
-		}
+			/* Access the "r_idx" of the chosen monster */
+			r_idx = table[i].index;
 
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
+			/* Access the actual race */
+			r_ptr = &r_info[r_idx];
 
-		/* Total */
-		total += table[i].prob3;
+			/* Don't ever summon unfair monsters. */
+			if (!unfair_monsters && r_ptr->flags7 & RF7_UNFAIR)
+			{
+				continue;
+			}
+
+			/* Hack -- "unique" monsters must be "unique" */
+			if ((r_ptr->flags1 & (RF1_UNIQUE)) &&
+				(r_ptr->cur_num >= r_ptr->max_num))
+			{
+				continue;
+			}
+
+			/* Depth Monsters never appear out of depth */
+			if (!hack_ood_summon && (r_ptr->flags1 & (RF1_FORCE_DEPTH)) &&
+				(r_ptr->level > p_ptr->depth))
+			{
+				continue;
+			}
+
+			/* Don't generate inappropriate monsters. */
+			if (!p_ptr->is_evil && r_ptr->flags3 & (RF3_STAR_GOOD))
+			{
+				continue;
+			}
+
+			/* Accept */
+			table[i].prob3 = table[i].prob2;
+
+			/* Total */
+			total += table[i].prob3;
+			c_ptr->cum[i] = total;
+		}
+
+		/* Remember the totals */
+		c_ptr->num = i;
+		c_ptr->level = level;
+		c_ptr->depth = p_ptr->depth;
+		c_ptr->flags = flags;
+		c_ptr->epoch = mon_alloc_epoch;
+		c_ptr->valid = TRUE;
 	}
 
+	/* Total */
+	total = (c_ptr->num ? c_ptr->cum[c_ptr->num - 1] : 0L);
+
 	/* No legal monsters */
 	if (total <= 0)
 		return (0);
 
 
 	/* Pick a monster */
-	value = rand_int(total);
-
-	/* Find the monster */
-	for (i = 0; i < alloc_race_size; i++)
-	{
-		/* Found the entry */
-		if (value < table[i].prob3)
-			break;
-
-		/* Decrement */
-		value = value - table[i].prob3;
-	}
+	i = alloc_cache_find(c_ptr, rand_int(total));
 
 
 	/* Power boost */
@@ -543,18 +859,7 @@ s16b get_mon_num(int level)
 		j = i;
 
 		/* Pick a monster */
-		value = rand_int(total);
-
-		/* Find the monster */
-		for (i = 0; i < alloc_race_size; i++)
-		{
-			/* Found the entry */
-			if (value < table[i].prob3)
-				break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = alloc_cache_find(c_ptr, rand_int(total));
 
 		/* Keep the "best" one */
 		if (table[i].level < table[j].level)
@@ -568,18 +873,7 @@ s16b get_mon_num(int level)
 		j = i;
 
 		/* Pick a monster */
-		value = rand_int(total);
-
-		/* Find the monster */
-		for (i = 0; i < alloc_race_size; i++)
-		{
-			/* Found the entry */
-			if (value < table[i].prob3)
-				break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = alloc_cache_find(c_ptr, rand_int(total));
 
 		/* Keep the "best" one */
 		if (table[i].level < table[j].level)
@@ -1107,6 +1401,21 @@ void update_mon(int m_idx, bool full)
 	}
 
 
+	/*
+	 * Out of sight and mind, and it was already: nothing changes (this
+	 * is most monsters on a crowded level, so leave the race alone)
+	 *
+	 * The buckets ("monster_near()") are no use here: this is one given
+	 * monster, and "update_monsters()" must still reach those which were
+	 * seen and have since gone beyond MAX_SIGHT, to forget them.
+	 */
+	if ((d > MAX_SIGHT) && !m_ptr->ml &&
+		!(m_ptr->mflag & (MFLAG_MARK | MFLAG_VIEW)))
+	{
+		return;
+	}
+
+
 	/* Handle aquatic monsters in deep water. */
 	if (r_ptr->flags2 & RF2_AQUATIC && d > 4 &&
 		cave_feat[fy][fx] == FEAT_DEEP_WATER)
@@ -1256,7 +1565,7 @@ void update_mon(int m_idx, bool full)
 
 			/* Disturb on appearance */
 			if (disturb_move && !m_ptr->is_pet)
-				disturb(1, 0);
+				disturb(1, DISTURB_MONSTER);
 		}
 	}
 
@@ -1278,7 +1587,7 @@ void update_mon(int m_idx, bool full)
 
 			/* Disturb on disappearance */
 			if (disturb_move && !m_ptr->is_pet)
-				disturb(1, 0);
+				disturb(1, DISTURB_MONSTER);
 		}
 	}
 
@@ -1294,7 +1603,7 @@ void update_mon(int m_idx, bool full)
 
 			/* Disturb on appearance */
 			if (disturb_near && !m_ptr->is_pet)
-				disturb(1, 0);
+				disturb(1, DISTURB_MONSTER);
 		}
 	}
 
@@ -1309,7 +1618,7 @@ void update_mon(int m_idx, bool full)
 
 			/* Disturb on disappearance */
 			if (disturb_near && !m_ptr->is_pet)
-				disturb(1, 0);
+				disturb(1, DISTURB_MONSTER);
 		}
 	}
 }
@@ -1339,6 +1648,111 @@ void update_monsters(bool full)
 }
 
 
+/*
+ * Terrain effects of each feature ("MTERR_*")
+ */
+static u16b mon_terrain_feat[256];
+
+/*
+ * Terrain effects each monster race is open to
+ */
+static u16b mon_terrain_race[MAX_R_IDX];
+
+
+/*
+ * Work out which terrain effects apply to which features and races.
+ *
+ * Race flags never change after "r_info" is parsed, so the hazard code
+ * only has to look at the flags when a monster stands somewhere which
+ * can actually hurt it.
+ */
+void mon_terrain_init(void)
+{
+	int i;
+
+	/* Features */
+	for (i = 0; i < 256; i++)
+	{
+		u16b f = 0;
+
+		switch (i)
+		{
+			case FEAT_OIL: f = MTERR_OIL; break;
+			case FEAT_BRAMBLE: f = MTERR_BRAMBLE; break;
+			case FEAT_SWAMP: f = MTERR_SWAMP; break;
+			case FEAT_DEEP_WATER: f = (MTERR_DROWN | MTERR_WADE); break;
+			case FEAT_ICE: f = MTERR_ICE; break;
+			case FEAT_DEEP_LAVA: f = MTERR_LAVA; break;
+		}
+
+		/* Only water is safe for fish */
+		if ((i == FEAT_SHAL_WATER) || (i == FEAT_DEEP_WATER))
+			f |= MTERR_DOUSE;
+		else
+			f |= MTERR_DRY;
+
+		if ((i == FEAT_ICE) || (i == FEAT_WALL_ICE)) f |= MTERR_DOUSE;
+
+		if ((i == FEAT_SHAL_LAVA) || (i == FEAT_DEEP_LAVA)) f |= MTERR_MELT;
+
+		/* Ladders, stairs and ramps */
+		if ((i == FEAT_LADDER) || (i == FEAT_STAIRS) ||
+		    (i == FEAT_RAMP) || (i == FEAT_ESCAPE_PIT))
+			f |= MTERR_ACCESS;
+
+		mon_terrain_feat[i] = f;
+	}
+
+	/* Races */
+	for (i = 0; i < MAX_R_IDX; i++)
+	{
+		monster_race *r_ptr = &r_info[i];
+		u16b r = 0;
+
+		/* Flying monsters ignore ground hazards */
+		if (!(r_ptr->flags2 & (RF2_FLY)))
+		{
+			/* Ice rolls for everyone, even the cold immune */
+			r |= (MTERR_OIL | MTERR_BRAMBLE | MTERR_SWAMP | MTERR_ICE);
+
+			if (!(r_ptr->flags2 & (RF2_SMART | RF2_AQUATIC)))
+				r |= MTERR_DROWN;
+			if (!(r_ptr->flags2 & (RF2_AQUATIC | RF2_SWIM)))
+				r |= MTERR_WADE;
+			if (!(r_ptr->flags3 & (RF3_IM_FIRE)) &&
+			    !(r_ptr->flags2 & (RF2_DEEPLAVA)))
+				r |= MTERR_LAVA;
+		}
+
+		/* Fish out of water */
+		if ((r_ptr->flags2 & (RF2_AQUATIC)) &&
+		    !(r_ptr->flags7 & (RF7_AMPHIBIOUS)))
+			r |= MTERR_DRY;
+
+		/* Fire creatures */
+		if ((r_ptr->flags7 & (RF7_FIRE_EVENT)) ||
+		    (r_ptr->flags4 & (RF4_BR_FIRE)))
+			r |= MTERR_DOUSE;
+
+		/* Cold creatures */
+		if ((r_ptr->flags4 & (RF4_BR_COLD)) ||
+		    (r_ptr->flags3 & (RF3_IM_COLD)))
+			r |= MTERR_MELT;
+
+		mon_terrain_race[i] = r;
+	}
+}
+
+
+/*
+ * Terrain effects a feature has on a monster
+ */
+u16b mon_terrain(monster_type *m_ptr, int feat)
+{
+	return (mon_terrain_feat[feat] & mon_terrain_race[m_ptr->r_idx]);
+}
+
+
 /*
  * Check if a monster can move between elevations and apply falling damage.
  * Returns TRUE if the move is allowed.
@@ -1358,9 +1772,8 @@ bool monster_check_cliff_move(int m_idx, int ny, int nx)
 	if (r_ptr->flags2 & (RF2_FLY)) return TRUE;
 
 	/* Check for access points (Ladders, Stairs, Ramps) */
-	int feat = cave_feat[ny][nx];
-	bool has_access = (feat == FEAT_LADDER || feat == FEAT_STAIRS ||
-	                   feat == FEAT_RAMP || feat == FEAT_ESCAPE_PIT);
+	bool has_access = (mon_terrain_feat[cave_feat[ny][nx]] & MTERR_ACCESS) ?
+		TRUE : FALSE;
 
 	/* Rule 1: Moving UP is impossible without access */
 	if (new_elev > old_elev && !has_access)
@@ -1410,8 +1823,8 @@ void mon_process_terrain(int m_idx, int y, int x)
 	monster_race *r_ptr = &r_info[m_ptr->r_idx];
 	int feat = cave_feat[y][x];
 
-	/* Flying monsters ignore ground hazards */
-	if (r_ptr->flags2 & RF2_FLY) return;
+	/* Nothing here can hurt this monster (usually) */
+	if (!(mon_terrain(m_ptr, feat) & MTERR_MOVE)) return;
 
 	/* Handle Oil */
 	if (feat == FEAT_OIL)
@@ -1486,7 +1899,7 @@ void mon_process_terrain(int m_idx, int y, int x)
 	{
 		/* Smart monsters, aquatic monsters, and fliers avoid drowning */
 		bool is_dumb = !(r_ptr->flags2 & RF2_SMART);
-		bool aquatic = (r_ptr->flags2 & RF2_AQUATIC);
+		bool aquatic = (r_ptr->flags2 & RF2_AQUATIC) ? TRUE : FALSE;
 
 		if (is_dumb && !aquatic)
 		{
@@ -1569,6 +1982,9 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		m_ptr->fy = y2;
 		m_ptr->fx = x2;
 
+		/* Follow it in the bucket grid */
+		mon_bucket_move(m1);
+
 		/* Update monster */
 		update_mon(m1, TRUE);
 	}
@@ -1580,6 +1996,9 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		p_ptr->py = y2;
 		p_ptr->px = x2;
 
+		/* Leave a scent */
+		scent_stamp(y2, x2);
+
 		/* Check for new panel (redraw map) */
 		verify_panel();
 
@@ -1606,6 +2025,9 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		m_ptr->fy = y1;
 		m_ptr->fx = x1;
 
+		/* Follow it in the bucket grid */
+		mon_bucket_move(m2);
+
 		/* Update monster */
 		update_mon(m2, TRUE);
 	}
@@ -1697,6 +2119,10 @@ s16b monster_place(int y, int x, monster_type * n_ptr)
 		m_ptr->fy = y;
 		m_ptr->fx = x;
 
+		/* Enter the bucket grid */
+		mon_bucket_cell[m_idx] = -1;
+		mon_bucket_add(m_idx);
+
 		/* Update the monster */
 		update_mon(m_idx, TRUE);
 
@@ -1713,6 +2139,9 @@ s16b monster_place(int y, int x, monster_type * n_ptr)
 
 		/* Count racial occurances */
 		r_ptr->cur_num++;
+
+		/* A unique may no longer be legal */
+		if (r_ptr->flags1 & (RF1_UNIQUE)) mon_alloc_epoch++;
 	}
 
 	/* Result */
@@ -1756,12 +2185,14 @@ void maintain_pet_limit(void)
 		monster_type *m_ptr = &m_list[farthest_idx];
 		char m_name[80];
 
-		/* Get the monster name */
-		monster_desc(m_name, m_ptr, 0);
-
 		/* Message */
 		if (character_dungeon)
+		{
+			/* Get the monster name */
+			monster_desc(m_name, m_ptr, 0);
+
 			msg_format("The %s leaves to aid other explorers.", m_name);
+		}
 
 		/* Remove the monster */
 		delete_monster_idx(farthest_idx);
@@ -2079,6 +2510,10 @@ static bool place_monster_group(int y, int x, int r_idx, int flags)
 			int mx = hx + ddx_ddd[i];
 			int my = hy + ddy_ddd[i];
 
+			/* Paranoia -- stay on the map */
+			if (!in_bounds(my, mx))
+				continue;
+
 			/* Walls and Monsters block flow */
 			if (!cave_empty_bold(my, mx))
 				continue;
@@ -2438,6 +2873,36 @@ bool place_monster(int y, int x, int flags)
 
 
 
+/*
+ * Add some random variation on monster generation for fun.
+ *
+ * Returns the allocation flags to hand to "place_monster()".
+ */
+int alloc_monster_flags(int flags)
+{
+	int rnd = randint(100);
+
+	/* Generate a horde of monsters
+	 * Only if not in the town. */
+	if (monster_level > 0)
+	{
+		if (rnd < 3)
+			flags |= MON_ALLOC_HORDE;
+		else if (rnd < 6)
+			flags |= MON_ALLOC_PIT;
+		else if (rnd < 9)
+			flags |= MON_ALLOC_GROUP;
+	}
+
+	if (cheat_hear && flags & MON_ALLOC_AQUATIC)
+	{
+		msg_print("Aquatic Monster.");
+	}
+
+	return (flags);
+}
+
+
 /*
  * Attempt to allocate a random monster in the dungeon.
  *
@@ -2455,8 +2920,6 @@ bool alloc_monster(int dis, int flags)
 	int y, x;
 	int i;
 
-	int rnd = randint(100);
-
 	/* Check that the buffers do not overflow. We need to leave a bit
 	 * of a buffer so that other generation logic does not trigger the
 	 * hard error when checking `m_max >= MAX_M_IDX`. */
@@ -2465,25 +2928,7 @@ bool alloc_monster(int dis, int flags)
 	  return FALSE;
 	}
 
-
-	/* Add some random variation on monster generation for fun. */
-
-	/* Generate a horde of monsters
-	 * Only if not in the town. */
-	if (monster_level > 0)
-	{
-		if (rnd < 3)
-			flags |= MON_ALLOC_HORDE;
-		else if (rnd < 6)
-			flags |= MON_ALLOC_PIT;
-		else if (rnd < 9)
-			flags |= MON_ALLOC_GROUP;
-	}
-
-	if (cheat_hear && flags & MON_ALLOC_AQUATIC)
-	{
-		msg_print("Aquatic Monster.");
-	}
+	flags = alloc_monster_flags(flags);
 
 	/* Find a legal, distant, unoccupied, space */
 	for (i = 0; i < 10000; i++)
@@ -545,6 +545,13 @@ static cptr get_syllable_cons()
 	}
 }
 
+/*
+ * Bumped when the flavors (and random artifact names) may have changed,
+ * so that "object_desc()" forgets the names it remembers
+ */
+static u32b desc_cache_epoch = 1L;
+
+
 /*
  * Prepare the "variable" part of the "k_info" array.
  *
@@ -585,6 +592,9 @@ void flavor_init(void)
 	cptr temp_adj;
 
 
+	/* Forget the old names */
+	desc_cache_epoch++;
+
 	/* Hack -- Use the "simple" RNG */
 	Rand_quick = TRUE;
 
@@ -884,6 +894,9 @@ void reset_visuals(bool prefs)
 		f_ptr->z_char = f_ptr->f_char;
 	}
 
+	/* The map must look different now */
+	map_info_forget_all();
+
 	/* Extract some info about objects */
 	for (i = 0; i < MAX_K_IDX; i++)
 	{
@@ -1327,7 +1340,7 @@ cptr object_desc_slot_name(int i)
  *   3 -- The Cloak of Death [1,+3] (+2 to Stealth) {nifty}
  *
  */
-void object_desc(char *buf, object_type * o_ptr, int pref, int mode)
+static void object_desc_aux(char *buf, object_type * o_ptr, int pref, int mode)
 {
 	cptr basenm, modstr, art_name, mat_name;
 	int power, indexx;
@@ -2466,6 +2479,80 @@ void object_desc(char *buf, object_type * o_ptr, int pref, int mode)
 }
 
 
+/*
+ * A remembered object name
+ */
+typedef struct desc_cache desc_cache;
+
+struct desc_cache
+{
+	object_type *o_ptr;	/* The object */
+	object_type obj;	/* The object, as it was when it was named */
+
+	u32b epoch;	/* The flavors it was named with */
+
+	byte pref;	/* The "pref" it was named with */
+	byte mode;	/* The "mode" it was named with */
+
+	bool aware;	/* Its kind was "aware" */
+	bool tried;	/* Its kind was "tried" */
+
+	char name[80];	/* The name */
+};
+
+static desc_cache desc_cache_info[OBJECT_DESC_CACHE];
+
+
+/*
+ * Describe an object (see "object_desc_aux()")
+ *
+ * Inventory, store, and target displays name the same objects over and
+ * over, so the names are remembered, in a small table keyed on where the
+ * object is.  A name is only used again if the object is bit for bit as
+ * it was, its kind is still as "aware" and "tried", and the flavors are
+ * the same.  Hallucinations (which are random), and the "object_desc_mode"
+ * names (which depend on the shop or the slot), are never remembered.
+ */
+void object_desc(char *buf, object_type * o_ptr, int pref, int mode)
+{
+	desc_cache *c_ptr;
+	object_kind *k_ptr;
+
+	/* Not worth remembering */
+	if (!o_ptr || p_ptr->image || object_desc_mode)
+	{
+		object_desc_aux(buf, o_ptr, pref, mode);
+		return;
+	}
+
+	c_ptr = &desc_cache_info[((huge)o_ptr / sizeof(object_type)) %
+		OBJECT_DESC_CACHE];
+	k_ptr = &k_info[o_ptr->k_idx];
+
+	/* Named already */
+	if ((c_ptr->o_ptr == o_ptr) && (c_ptr->epoch == desc_cache_epoch) &&
+		(c_ptr->pref == pref) && (c_ptr->mode == mode) &&
+		(c_ptr->aware == k_ptr->aware) && (c_ptr->tried == k_ptr->tried) &&
+		!memcmp(&c_ptr->obj, o_ptr, sizeof(object_type)))
+	{
+		strcpy(buf, c_ptr->name);
+		return;
+	}
+
+	object_desc_aux(buf, o_ptr, pref, mode);
+
+	/* Remember it */
+	c_ptr->o_ptr = o_ptr;
+	COPY(&c_ptr->obj, o_ptr, object_type);
+	c_ptr->epoch = desc_cache_epoch;
+	c_ptr->pref = pref;
+	c_ptr->mode = mode;
+	c_ptr->aware = k_ptr->aware;
+	c_ptr->tried = k_ptr->tried;
+	strcpy(c_ptr->name, buf);
+}
+
+
 /*
  * Hack -- describe an item currently in a store's inventory
  * This allows an item to *look* like the player is "aware" of it
@@ -4263,6 +4350,8 @@ object_type *get_item(cptr prompt, cptr str, int y, int x, int mode)
 	    foo = rand_int((mode & USE_INVEN ? size_main : 0) +
 			   (mode & USE_FLOOR ? size_aux : 0));
 
+	    i = 0;
+
 	    if (foo < size_main) {
 	      ret = stack;
 
@@ -11,6 +11,131 @@
 #include "angband.h"
 
 
+/**************************** Object memory. ***/
+
+/*
+ * Objects come from slabs of OBJECT_SLAB objects, which are never given
+ * back; a deleted object goes on a free list (through "next_global") and
+ * is the next one handed out.  Deleting an object is then one store, not
+ * a call to "free()", so clearing a level costs little more than walking
+ * its objects, and the objects of a level sit close together in memory.
+ */
+static object_type *object_free_list = NULL;
+
+/*
+ * A slab (and the one made before it)
+ */
+typedef struct object_slab_type object_slab_type;
+
+struct object_slab_type
+{
+	object_type obj[OBJECT_SLAB];
+	object_slab_type *next;
+};
+
+static object_slab_type *object_slab_list = NULL;
+
+/*
+ * Slabs made, and objects handed out and not yet deleted
+ */
+static s32b object_slabs = 0;
+static s32b object_live = 0;
+
+
+/*
+ * Make a new slab, and put its objects on the free list
+ */
+static void object_slab(void)
+{
+	object_slab_type *slab;
+	int i;
+	int tag = VIRT_TAG(MEM_OBJECT);
+
+	MAKE(slab, object_slab_type);
+
+	(void)VIRT_TAG(tag);
+
+	slab->next = object_slab_list;
+	object_slab_list = slab;
+
+	for (i = OBJECT_SLAB - 1; i >= 0; i--)
+	{
+		slab->obj[i].next_global = object_free_list;
+		object_free_list = &slab->obj[i];
+	}
+
+	object_slabs++;
+}
+
+
+/*
+ * Get a blank object (as "MAKE()" would), not yet in any list
+ */
+object_type *object_alloc(void)
+{
+	object_type *o_ptr;
+
+	if (!object_free_list) object_slab();
+
+	o_ptr = object_free_list;
+	object_free_list = o_ptr->next_global;
+
+	WIPE(o_ptr, object_type);
+
+	object_live++;
+
+	return (o_ptr);
+}
+
+
+/*
+ * Give back an object (as "KILL()" would), which must be in no list
+ */
+void object_free(object_type *o_ptr)
+{
+	/* Forget it, so that a stale pointer finds nothing */
+	WIPE(o_ptr, object_type);
+
+	o_ptr->next_global = object_free_list;
+	object_free_list = o_ptr;
+
+	object_live--;
+}
+
+
+/*
+ * Objects handed out and not yet given back, and slabs made
+ */
+void object_pool_stats(s32b *live, s32b *slabs)
+{
+	*live = object_live;
+	*slabs = object_slabs;
+}
+
+
+/*
+ * Note the inscriptions ("quarks") which objects use, in "used"
+ *
+ * Every object there is, wherever it may be, came from a slab; those on
+ * the free list were wiped, and have none.
+ */
+void object_pool_notes(bool *used)
+{
+	object_slab_type *slab;
+	int i;
+
+	for (slab = object_slab_list; slab; slab = slab->next)
+	{
+		for (i = 0; i < OBJECT_SLAB; i++)
+		{
+			s16b note = slab->obj[i].note;
+
+			if ((note > 0) && (note < QUARK_MAX)) used[note] = TRUE;
+		}
+	}
+}
+
+
 /**************************** Removal functions. ***/
 
 /* Origin for object generation during level creation */
@@ -210,7 +335,7 @@ object_type *object_unabsorb(object_type * o_ptr, int num)
 
 		int wgt_one = o_ptr->weight / o_ptr->number;
 
-		MAKE(nw, object_type);
+		nw = object_alloc();
 		COPY(nw, o_ptr, object_type);
 
 		nw->in_list = nw->in_global = FALSE;
@@ -285,7 +410,7 @@ void remove_object(object_type * o_ptr)
 	}
 
 	/* Delete the object. */
-	KILL(o_ptr, object_type);
+	object_free(o_ptr);
 }
 
 
@@ -582,6 +707,11 @@ static bool stop_sorting_objects_store(object_type * o_ptr, object_type * i_ptr)
 
 /* 
  * Insert an object ``o_ptr'' to a global list ``stack''.
+ *
+ * Stores and the home look for a stack to merge with, and (with
+ * "sort_items") for the place the object sorts to, in the same walk
+ * down the stock.  Only objects of the same kind can merge, so the
+ * similarity test is only made for those.
  */
 void insert_to_global_list(object_type * o_ptr, object_type ** stack,
 	byte world)
@@ -589,46 +719,45 @@ void insert_to_global_list(object_type * o_ptr, object_type ** stack,
 	object_type *insert_root = NULL;
 	object_type *iter;
 
+	bool merge = FALSE;
+	bool place = FALSE;
 
-	/* Normal stores do special stuff */
-	if ((world == WORLD_STORE) && store_combine_flag)
+
+	/* Stores and the home merge stacks, and maybe sort */
+	if ((world == WORLD_STORE) || (world == WORLD_HOME))
+	{
+		merge = store_combine_flag;
+		place = sort_items;
+	}
+
+	for (iter = (*stack); (merge || place) && (iter != NULL);
+		iter = iter->next_global)
 	{
 		/* Try to merge two objects together, if possible. */
-		for (iter = (*stack); iter != NULL; iter = iter->next_global)
+		if (merge && (iter->k_idx == o_ptr->k_idx) && (iter->world == world))
 		{
-			/* Don't combine worlds */
-			if (iter->world != world) continue;
-	
-			/* Compare the objects */
-			if (store_object_similar(iter, o_ptr))
+			/* Normal stores do special stuff */
+			if (world == WORLD_STORE)
 			{
-				/* Combine them. */
-				store_object_absorb(iter, o_ptr);
-	
-				/* Delete the object. */
-				remove_object(o_ptr);
+				if (store_object_similar(iter, o_ptr))
+				{
+					/* Combine them. */
+					store_object_absorb(iter, o_ptr);
 
-				/* Done */
-				return;
+					/* Delete the object. */
+					remove_object(o_ptr);
+
+					/* Done */
+					return;
+				}
 			}
-		}
-	}
 
-	/* The "home" acts like the player */
-	else if ((world == WORLD_HOME) && store_combine_flag)
-	{
-		/* Try to merge two objects together, if possible. */
-		for (iter = (*stack); iter != NULL; iter = iter->next_global)
-		{
-			/* Don't combine worlds */
-			if (iter->world != world) continue;
-	
-			/* Compare the objects */
-			if (object_similar(iter, o_ptr))
+			/* The "home" acts like the player */
+			else if (object_similar(iter, o_ptr))
 			{
 				/* Combine them. */
 				object_absorb(iter, o_ptr);
-	
+
 				/* Delete the object. */
 				remove_object(o_ptr);
 
@@ -636,42 +765,23 @@ void insert_to_global_list(object_type * o_ptr, object_type ** stack,
 				return;
 			}
 		}
-	}
-
 
-	/* Ugly hack beyond all hacks -- sort store items if required. */
-	if (sort_items)
-	{
-		/* Normal stores do special stuff */
-		if (world == WORLD_STORE)
+		/* Ugly hack beyond all hacks -- sort store items if required. */
+		if (place)
 		{
-			object_type *iter;
-	
-			for (iter = (*stack); iter != NULL; iter = iter->next_global)
+			/* Normal stores do special stuff */
+			if (world == WORLD_STORE)
 			{
-				if (stop_sorting_objects_store(o_ptr, iter))
-				{
-					break;
-				}
-	
-				insert_root = iter;
+				if (stop_sorting_objects_store(o_ptr, iter)) place = FALSE;
 			}
-		}
 
-		/* The "home" acts like the player */
-		else if (world == WORLD_HOME)
-		{
-			object_type *iter;
-	
-			for (iter = (*stack); iter != NULL; iter = iter->next_global)
+			/* The "home" acts like the player */
+			else
 			{
-				if (stop_sorting_objects(o_ptr, iter))
-				{
-					break;
-				}
-	
-				insert_root = iter;
+				if (stop_sorting_objects(o_ptr, iter)) place = FALSE;
 			}
+
+			if (place) insert_root = iter;
 		}
 	}
 
@@ -694,9 +804,7 @@ void insert_to_global_list(object_type * o_ptr, object_type ** stack,
  */
 object_type *new_object(void)
 {
-	object_type *ret;
-
-	MAKE(ret, object_type);
+	object_type *ret = object_alloc();
 
 	insert_to_global_list(ret, &(o_list), WORLD_MAIN);
 
@@ -710,6 +818,10 @@ object_type *new_object(void)
  * This function returns TRUE if the object was inserted, and
  * FALSE if the object was absorbed and then deleted.
  *
+ * As with "insert_to_global_list()", the stack to merge with and (with
+ * "sort_items") the place the object sorts to are found in one walk,
+ * and only objects of the same kind are tested for similarity.
+ *
  * Do not use this function unless you really need to. The ones below
  * are much nicer and safer.
  */
@@ -718,20 +830,19 @@ bool insert_to_stack(object_type * o_ptr, object_type ** stack)
 	object_type *insert_root = NULL;
 	object_type *iter;
 
+	bool place = sort_items;
+
 	/* Oops -- Object is in a stack. */
 	if (o_ptr->stack != STACK_NONE)
 	{
 		remove_from_stack(o_ptr);
 	}
 
-	/* Try to merge two objects together, if possible. */
 	for (iter = (*stack); iter != NULL; iter = iter->next)
 	{
-		/* Don't combine worlds */
-		if (iter->world != o_ptr->world) continue;
-
-		/* Compare the objects */
-		if (object_similar(iter, o_ptr))
+		/* Try to merge two objects together, if possible. */
+		if ((iter->k_idx == o_ptr->k_idx) && (iter->world == o_ptr->world) &&
+			object_similar(iter, o_ptr))
 		{
 			/* Combine them. */
 			object_absorb(iter, o_ptr);
@@ -742,19 +853,12 @@ bool insert_to_stack(object_type * o_ptr, object_type ** stack)
 			/* Done */
 			return FALSE;
 		}
-	}
 
-	/* Try to sort the items. */
-	if (sort_items)
-	{
-		for (iter = (*stack); iter != NULL; iter = iter->next)
+		/* Try to sort the items. */
+		if (place)
 		{
-			if (stop_sorting_objects(o_ptr, iter))
-			{
-				break;
-			}
-
-			insert_root = iter;
+			if (stop_sorting_objects(o_ptr, iter)) place = FALSE;
+			else insert_root = iter;
 		}
 	}
 
@@ -891,6 +995,9 @@ bool inven_carry(object_type * o_ptr)
 	{
 		o_ptr->stack = STACK_INVEN;
 
+		/* Something new to sense */
+		inven_unsensed = TRUE;
+
 		/* Add the weight */
 		p_ptr->total_weight += o_ptr->weight;
 
@@ -912,8 +1019,13 @@ bool inven_carry(object_type * o_ptr)
 	return ret;
 }
 
-/* 
+/*
  * Give the object to the monster's inventory stack.
+ *
+ * A monster's inventory is an object stack like any other, so the
+ * objects merge, sort and move between stacks just as the floor and
+ * the pack do.  The objects come from the slabs above, not from the
+ * heap, and few monsters carry anything at all.
  */
 bool monster_inven_carry(monster_type * m_ptr, object_type * o_ptr)
 {
@@ -933,6 +1045,14 @@ bool monster_inven_carry(monster_type * m_ptr, object_type * o_ptr)
 /***************************/
 
 
+/*
+ * The cached totals of the object allocation table, and the number of
+ * times the restriction function has been applied
+ */
+static alloc_cache obj_alloc_cache;
+static u32b obj_alloc_epoch = 1;
+
+
 /*
  * Apply a "object restriction function" to the "object allocation table"
  */
@@ -961,6 +1081,9 @@ errr get_obj_num_prep(void)
 		}
 	}
 
+	/* Forget the cached totals */
+	obj_alloc_epoch++;
+
 	/* Success */
 	return (0);
 }
@@ -981,6 +1104,9 @@ errr get_obj_num_prep(void)
  *
  * Note that if no objects are "appropriate", then this function will
  * fail, and return zero, but this should *almost* never happen.
+ *
+ * The legal part of the table is summed up once for each level and set
+ * of restrictions, so that consecutive picks are binary searches.
  */
 s16b get_obj_num(int level)
 {
@@ -988,12 +1114,16 @@ s16b get_obj_num(int level)
 
 	int k_idx;
 
-	long value, total;
+	long total;
+
+	u32b flags;
 
 	object_kind *k_ptr;
 
 	alloc_entry *table = alloc_kind_table;
 
+	alloc_cache *c_ptr = &obj_alloc_cache;
+
 
 	/* Boost level */
 	if (level > 0)
@@ -1007,54 +1137,72 @@ s16b get_obj_num(int level)
 	}
 
 
-	/* Reset total */
-	total = 0L;
+	/* Current restrictions */
+	flags = (opening_chest ? ALLOC_CACHE_CHEST : 0L);
 
-	/* Process probabilities */
-	for (i = 0; i < alloc_kind_size; i++)
+	/* Reuse the totals if nothing has changed */
+	if (c_ptr->valid && (c_ptr->level == level) &&
+		(c_ptr->flags == flags) && (c_ptr->epoch == obj_alloc_epoch))
 	{
-		/* Objects are sorted by depth */
-		if (table[i].level > level)
-			break;
+		alloc_cache_hits++;
+	}
 
-		/* Default */
-		table[i].prob3 = 0;
+	else
+	{
+		alloc_cache_misses++;
 
-		/* Access the index */
-		k_idx = table[i].index;
+		if (!c_ptr->cum) C_MAKE(c_ptr->cum, alloc_kind_size, long);
 
-		/* Access the actual kind */
-		k_ptr = &k_info[k_idx];
+		/* Reset total */
+		total = 0L;
 
-		/* Hack -- prevent embedded chests */
-		if (opening_chest && (k_ptr->tval == TV_CHEST))
-			continue;
+		/* Process probabilities */
+		for (i = 0; i < alloc_kind_size; i++)
+		{
+			/* Objects are sorted by depth */
+			if (table[i].level > level)
+				break;
+
+			/* Default */
+			table[i].prob3 = 0;
+			c_ptr->cum[i] = total;
+
+			/* Access the index */
+			k_idx = table[i].index;
+
+			/* Access the actual kind */
+			k_ptr = &k_info[k_idx];
+
+			/* Hack -- prevent embedded chests */
+			if (opening_chest && (k_ptr->tval == TV_CHEST))
+				continue;
+
+			/* Accept */
+			table[i].prob3 = table[i].prob2;
 
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
+			/* Total */
+			total += table[i].prob3;
+			c_ptr->cum[i] = total;
+		}
 
-		/* Total */
-		total += table[i].prob3;
+		/* Remember the totals */
+		c_ptr->num = i;
+		c_ptr->level = level;
+		c_ptr->flags = flags;
+		c_ptr->epoch = obj_alloc_epoch;
+		c_ptr->valid = TRUE;
 	}
 
+	/* Total */
+	total = (c_ptr->num ? c_ptr->cum[c_ptr->num - 1] : 0L);
+
 	/* No legal objects */
 	if (total <= 0)
 		return (0);
 
 
 	/* Pick an object */
-	value = rand_int(total);
-
-	/* Find the object */
-	for (i = 0; i < alloc_kind_size; i++)
-	{
-		/* Found the entry */
-		if (value < table[i].prob3)
-			break;
-
-		/* Decrement */
-		value = value - table[i].prob3;
-	}
+	i = alloc_cache_find(c_ptr, rand_int(total));
 
 
 	/* Power boost */
@@ -1067,18 +1215,7 @@ s16b get_obj_num(int level)
 		j = i;
 
 		/* Pick a object */
-		value = rand_int(total);
-
-		/* Find the monster */
-		for (i = 0; i < alloc_kind_size; i++)
-		{
-			/* Found the entry */
-			if (value < table[i].prob3)
-				break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = alloc_cache_find(c_ptr, rand_int(total));
 
 		/* Keep the "best" one */
 		if (table[i].level < table[j].level)
@@ -1092,18 +1229,7 @@ s16b get_obj_num(int level)
 		j = i;
 
 		/* Pick a object */
-		value = rand_int(total);
-
-		/* Find the object */
-		for (i = 0; i < alloc_kind_size; i++)
-		{
-			/* Found the entry */
-			if (value < table[i].prob3)
-				break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = alloc_cache_find(c_ptr, rand_int(total));
 
 		/* Keep the "best" one */
 		if (table[i].level < table[j].level)
@@ -2034,6 +2160,92 @@ static void object_mention(object_type * o_ptr)
 
 
 
+/*
+ * The artifacts and ego-items which might be made of each "tval"
+ *
+ * "make_artifact()" and "make_ego_item()" try up to 2000 random entries
+ * of the whole table, and most of them can never fit the object.  Each
+ * "tval" gets a bitmap of the entries which might, made the first time
+ * it is needed, so that a try which could not fit costs one test and
+ * does not look at the entry at all, and a "tval" which nothing fits is
+ * not tried.  The draws are the same as before, so are the odds.
+ *
+ * The depth and rarity rolls are loose, so they are still made at each
+ * try, and are not part of the bitmaps.
+ */
+typedef struct obj_cand_type obj_cand_type;
+
+struct obj_cand_type
+{
+	u32b *mask;		/* Entries which might fit, one bit each */
+	int num;		/* Number of them */
+};
+
+static obj_cand_type art_cand[256];
+static obj_cand_type ego_cand[256];
+
+
+/*
+ * Whether artifact "i" might be made of an object of "tval"
+ *
+ * "Special" artifacts replace the object, so they fit any of them.
+ */
+static bool art_cand_fits(int i, int tval)
+{
+	artifact_type *a_ptr = &a_info[i];
+
+	if (!a_ptr->name) return (FALSE);
+
+	if (a_ptr->flags3 & (TR3_SPECIAL)) return (TRUE);
+
+	return (a_ptr->tval == tval);
+}
+
+
+/*
+ * Whether ego-item "i" might be made of an object of "tval" by chance
+ *
+ * An ego-item of "tval" zero fits anything.
+ */
+static bool ego_cand_fits(int i, int tval)
+{
+	ego_item_type *e_ptr = &e_info[i];
+
+	if (!e_ptr->name) return (FALSE);
+
+	if (e_ptr->flags2 & (TR2_SPECIAL_GEN)) return (FALSE);
+
+	return (!e_ptr->tval || (e_ptr->tval == tval));
+}
+
+
+/*
+ * The entries of "table" (of "max" entries) which might be made of an
+ * object of "tval", according to "fits"
+ */
+static obj_cand_type *obj_cand_get(obj_cand_type *table, int tval, int max,
+	bool (*fits)(int i, int tval))
+{
+	obj_cand_type *c_ptr = &table[tval];
+	int i;
+
+	/* Already made */
+	if (c_ptr->mask) return (c_ptr);
+
+	C_MAKE(c_ptr->mask, (max + 31) / 32, u32b);
+
+	for (i = 0; i < max; i++)
+	{
+		if (!(*fits)(i, tval)) continue;
+
+		c_ptr->mask[i / 32] |= (1L << (i % 32));
+		c_ptr->num++;
+	}
+
+	return (c_ptr);
+}
+
+
 /*
  * The core of artifact creation. This allows to create specific
  * artifacts.
@@ -2172,6 +2384,17 @@ bool make_artifact(object_type * o_ptr, byte depth)
 {
 	int i, foo;
 
+	obj_cand_type *c_ptr = obj_cand_get(art_cand, o_ptr->tval, MAX_A_IDX,
+		art_cand_fits);
+
+	/* Paranoia -- no "plural" artifacts */
+	if (o_ptr->number != 1)
+		return (FALSE);
+
+	/* Nothing could fit */
+	if (!c_ptr->num)
+		return (FALSE);
+
 	/* Check the artifact list.
 	 *
 	 * (See ``make_ego_item'' for rationale.
@@ -2179,6 +2402,11 @@ bool make_artifact(object_type * o_ptr, byte depth)
 	for (foo = 0; foo < 2000; foo++)
 	{
 		i = rand_int(MAX_A_IDX);
+
+		/* Could never fit */
+		if (!(c_ptr->mask[i / 32] & (1L << (i % 32))))
+			continue;
+
 		if (make_artifact_named(o_ptr, i, depth, FALSE))
 			return TRUE;
 	}
@@ -2336,10 +2564,17 @@ bool make_ego_item(object_type * o_ptr, byte depth)
 {
 	int i, foo;
 
+	obj_cand_type *c_ptr = obj_cand_get(ego_cand, o_ptr->tval, MAX_E_IDX,
+		ego_cand_fits);
+
 	/* Paranoia -- no "plural" ego items */
 	if (o_ptr->number != 1)
 		return (FALSE);
 
+	/* Nothing could fit */
+	if (!c_ptr->num)
+		return (FALSE);
+
 	/* Check the ego-item list 
 	 *
 	 * Note: We really need to check the list randomly, even though it's
@@ -2350,6 +2585,10 @@ bool make_ego_item(object_type * o_ptr, byte depth)
 	{
 		i = rand_int(MAX_E_IDX);
 
+		/* Could never fit */
+		if (!(c_ptr->mask[i / 32] & (1L << (i % 32))))
+			continue;
+
 		if (make_ego_item_named(o_ptr, i, depth, FALSE))
 			return TRUE;
 	}
@@ -3134,14 +3373,14 @@ void drop_near(object_type * j_ptr, bool do_dam, int y, int x)
 			if (!in_bounds_fully(ty, tx))
 				continue;
 
-			/* Require line of sight */
-			if (!los(y, x, ty, tx))
-				continue;
-
 			/* Require floor space (or shallow terrain) -KMW- */
 			if (!cave_floor_bold(ty, tx))
 				continue;
 
+			/* Require line of sight (the dearer test, so last) */
+			if (!los(y, x, ty, tx))
+				continue;
+
 			flag = TRUE;
 			break;
 		}
@@ -4084,6 +4323,9 @@ void link_insert_glob(object_type *a, object_type *b, object_type *c)
 	c->next_global = b;
 
 	c->in_global = TRUE;
+
+	/* It may be recharging */
+	if (c->timeout > 0) object_charging_n++;
 }
 
 void link_remove_glob(object_type *a)
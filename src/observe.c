@@ -0,0 +1,451 @@
+/* File: observe.c */
+
+/*
+ * The observer of a headless game
+ *
+ * A bot which plays a headless game in the same program need not scrape
+ * the screen: "observe_get()" hands it a snapshot of what the player can
+ * know (the map as remembered, the visible monsters, the pack and the
+ * equipment, and the status of the side panel), and "observe_start()"
+ * lets it pick the commands (see "--bot" in "main.c").  The snapshot is
+ * only read, never written, by the bot.
+ *
+ * The snapshot is kept up to date a bit at a time.  "lite_spot()" notes
+ * each grid whose look changes, and a redraw of the whole map notes every
+ * grid; only the rows with a noted grid are read again.  The monsters,
+ * objects and status are compared with what was there before.  Each part
+ * has a version which is bumped when it changes (see "observe_type").
+ *
+ * None of this costs anything while no observer is running, and the
+ * observer draws on none of the game's random numbers.
+ */
+
+#include "angband.h"
+
+
+/*
+ * Whether there is an observer (see "lite_spot()")
+ */
+bool observe_on = FALSE;
+
+
+/*
+ * The snapshot
+ */
+static observe_type observe_snap;
+
+/*
+ * Rows with a grid which may have changed, and the span of such grids
+ */
+static byte observe_dirty[DUNGEON_HGT];
+static s16b observe_dirty_x1[DUNGEON_HGT];
+static s16b observe_dirty_x2[DUNGEON_HGT];
+static bool observe_dirty_any = FALSE;
+
+/*
+ * The bot choosing the commands, if any
+ */
+static observe_hook_type observe_hook = NULL;
+
+
+/*
+ * Note that the look of grid (y,x) may have changed
+ */
+void observe_note_spot(int y, int x)
+{
+	if (!observe_dirty[y])
+	{
+		observe_dirty[y] = TRUE;
+		observe_dirty_x1[y] = observe_dirty_x2[y] = x;
+	}
+	else if (x < observe_dirty_x1[y])
+	{
+		observe_dirty_x1[y] = x;
+	}
+	else if (x > observe_dirty_x2[y])
+	{
+		observe_dirty_x2[y] = x;
+	}
+
+	observe_dirty_any = TRUE;
+}
+
+
+/*
+ * Note that the whole map may have changed
+ */
+void observe_note_map(void)
+{
+	int y;
+
+	if (!observe_on) return;
+
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		observe_dirty[y] = TRUE;
+		observe_dirty_x1[y] = 0;
+		observe_dirty_x2[y] = DUNGEON_WID - 1;
+	}
+
+	observe_dirty_any = TRUE;
+}
+
+
+/*
+ * Read the noted grids of the map again
+ */
+static bool observe_read_map(void)
+{
+	observe_type *o_ptr = &observe_snap;
+
+	bool changed = FALSE;
+	int y, x;
+
+	if (!observe_dirty_any) return (FALSE);
+
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		bool row = FALSE;
+
+		if (!observe_dirty[y]) continue;
+
+		observe_dirty[y] = FALSE;
+
+		for (x = observe_dirty_x1[y]; x <= observe_dirty_x2[y]; x++)
+		{
+			byte feat = FEAT_NONE;
+			byte info = 0;
+
+			/* The player remembers it, or sees it */
+			if (in_bounds(y, x) &&
+				((cave_info[y][x] & (CAVE_MARK)) || player_can_see_bold(y, x)))
+			{
+				feat = f_info[cave_feat[y][x]].mimic;
+				info = OBS_KNOWN;
+
+				if (cave_floor_bold(y, x)) info |= OBS_PASS;
+			}
+
+			if ((o_ptr->feat[y][x] == feat) && (o_ptr->info[y][x] == info))
+				continue;
+
+			o_ptr->feat[y][x] = feat;
+			o_ptr->info[y][x] = info;
+			row = TRUE;
+		}
+
+		if (row)
+		{
+			if (!changed) o_ptr->map_version++;
+			o_ptr->row_version[y] = o_ptr->map_version;
+			changed = TRUE;
+		}
+	}
+
+	observe_dirty_any = FALSE;
+
+	return (changed);
+}
+
+
+/*
+ * Read the status again
+ */
+static bool observe_read_status(void)
+{
+	observe_status st;
+	int i;
+
+	WIPE(&st, observe_status);
+
+	st.depth = p_ptr->depth;
+	st.py = p_ptr->py;
+	st.px = p_ptr->px;
+	st.lev = p_ptr->lev;
+	st.exp = p_ptr->exp;
+	st.au = p_ptr->au;
+	st.chp = p_ptr->chp;
+	st.mhp = p_ptr->mhp;
+	st.csp = p_ptr->csp;
+	st.msp = p_ptr->msp;
+	st.csane = p_ptr->csane;
+	st.msane = p_ptr->msane;
+	st.ac = p_ptr->dis_ac + p_ptr->dis_to_a;
+	st.speed = p_ptr->pspeed - 110;
+	st.food = p_ptr->food;
+
+	for (i = 0; i < 6; i++) st.stat_use[i] = p_ptr->stat_use[i];
+
+	st.blind = p_ptr->blind;
+	st.confused = p_ptr->confused;
+	st.afraid = p_ptr->afraid;
+	st.poisoned = p_ptr->poisoned;
+	st.paralyzed = p_ptr->paralyzed;
+	st.image = p_ptr->image;
+	st.cut = p_ptr->cut;
+	st.stun = p_ptr->stun;
+	st.disturb_why = disturb_why;
+
+	if (!memcmp(&st, &observe_snap.status, sizeof(observe_status)))
+		return (FALSE);
+
+	observe_snap.status = st;
+	observe_snap.status_version++;
+
+	return (TRUE);
+}
+
+
+/*
+ * Read the visible monsters again
+ */
+static bool observe_read_monsters(void)
+{
+	observe_type *o_ptr = &observe_snap;
+	observe_monster mon;
+	bool changed = FALSE;
+	int i, n = 0;
+
+	for (i = 1; (i < m_max) && (n < OBSERVE_MONSTERS); i++)
+	{
+		monster_type *m_ptr = &m_list[i];
+
+		if (!m_ptr->r_idx) continue;
+		if (!m_ptr->ml) continue;
+
+		WIPE(&mon, observe_monster);
+
+		mon.m_idx = i;
+		mon.r_idx = m_ptr->r_idx;
+		mon.y = m_ptr->fy;
+		mon.x = m_ptr->fx;
+		mon.hp = m_ptr->hp;
+		mon.maxhp = m_ptr->maxhp;
+		mon.is_pet = m_ptr->is_pet ? TRUE : FALSE;
+
+		if ((n >= o_ptr->monster_num) ||
+			memcmp(&mon, &o_ptr->monster[n], sizeof(observe_monster)))
+		{
+			o_ptr->monster[n] = mon;
+			changed = TRUE;
+		}
+
+		n++;
+	}
+
+	if (n != o_ptr->monster_num) changed = TRUE;
+
+	o_ptr->monster_num = n;
+
+	if (changed) o_ptr->monster_version++;
+
+	return (changed);
+}
+
+
+/*
+ * Describe an object for the observer
+ */
+static void observe_item_aux(observe_item *i_ptr, object_type *o_ptr)
+{
+	WIPE(i_ptr, observe_item);
+
+	if (!o_ptr) return;
+
+	i_ptr->k_idx = o_ptr->k_idx;
+	i_ptr->tval = o_ptr->tval;
+	i_ptr->sval = o_ptr->sval;
+	i_ptr->number = o_ptr->number;
+	i_ptr->aware = object_aware_p(o_ptr) ? TRUE : FALSE;
+}
+
+
+/*
+ * Read the pack and the equipment again
+ */
+static bool observe_read_items(void)
+{
+	observe_type *o_ptr = &observe_snap;
+	observe_item item;
+	object_type *j_ptr;
+	bool changed = FALSE;
+	int i, n = 0;
+
+	for (j_ptr = inventory; j_ptr && (n < OBSERVE_ITEMS); j_ptr = j_ptr->next)
+	{
+		observe_item_aux(&item, j_ptr);
+
+		if ((n >= o_ptr->item_num) ||
+			memcmp(&item, &o_ptr->item[n], sizeof(observe_item)))
+		{
+			o_ptr->item[n] = item;
+			changed = TRUE;
+		}
+
+		n++;
+	}
+
+	if (n != o_ptr->item_num) changed = TRUE;
+
+	o_ptr->item_num = n;
+
+	for (i = 0; i < EQUIP_MAX; i++)
+	{
+		observe_item_aux(&item, equipment[i]);
+
+		if (memcmp(&item, &o_ptr->equip[i], sizeof(observe_item)))
+		{
+			o_ptr->equip[i] = item;
+			changed = TRUE;
+		}
+	}
+
+	if (changed) o_ptr->item_version++;
+
+	return (changed);
+}
+
+
+/*
+ * Bring the snapshot up to date, and return it
+ *
+ * Returns NULL if no observer is running.
+ */
+const observe_type *observe_get(void)
+{
+	observe_type *o_ptr = &observe_snap;
+
+	bool changed = FALSE;
+
+	if (!observe_on) return (NULL);
+
+	if (observe_read_map()) changed = TRUE;
+	if (observe_read_status()) changed = TRUE;
+	if (observe_read_monsters()) changed = TRUE;
+	if (observe_read_items()) changed = TRUE;
+
+	if (changed) o_ptr->version++;
+
+	o_ptr->turn = turn;
+
+	return (o_ptr);
+}
+
+
+/*
+ * Start observing the game, with the bot "hook" picking the commands of
+ * a headless game (or none, to only keep the snapshot)
+ */
+void observe_start(observe_hook_type hook)
+{
+	WIPE(&observe_snap, observe_type);
+
+	observe_snap.layout = OBSERVE_LAYOUT;
+
+	observe_hook = hook;
+	observe_on = TRUE;
+
+	/* Read the whole map the first time */
+	observe_note_map();
+}
+
+
+/*
+ * Let the bot pick the next command of a headless game
+ *
+ * Returns FALSE if there is no bot, or it has nothing to say (and the game
+ * picks a command as it would without it).
+ */
+bool observe_command(void)
+{
+	const observe_type *o_ptr;
+	char cmd = 0;
+	int dir = 0;
+
+	if (!observe_hook) return (FALSE);
+
+	/* Not during the birth of the character */
+	if (!character_generated) return (FALSE);
+
+	o_ptr = observe_get();
+
+	if (!(*observe_hook)(o_ptr, &cmd, &dir)) return (FALSE);
+
+	p_ptr->command_cmd = cmd;
+	p_ptr->command_dir = dir;
+
+	return (TRUE);
+}
+
+
+/*
+ * A small bot which only looks at the snapshot: it fights a visible
+ * monster next to the player, and otherwise wanders over the grids it
+ * knows it can walk through, keeping on in one direction for a while
+ *
+ * It is the "--bot" of "main.c", and an example for others to follow.
+ */
+bool observe_wanderer(const observe_type *o_ptr, char *cmd, int *dir)
+{
+	static int last_dir = 0;
+	static s32b last_turn = -1;
+	static int stuck = 0;
+
+	const observe_status *s_ptr = &o_ptr->status;
+
+	bool keep = FALSE;
+	int i, n = 0;
+	int ok[8];
+
+	/* The last command took no time (a cliff, say), so try another */
+	if (o_ptr->turn == last_turn) stuck++;
+	else stuck = 0;
+
+	last_turn = o_ptr->turn;
+
+	/* Let the game pick, if nothing works */
+	if (stuck > 8) return (FALSE);
+
+	/* Fight */
+	for (i = 0; i < o_ptr->monster_num; i++)
+	{
+		const observe_monster *m_ptr = &o_ptr->monster[i];
+
+		int dy = m_ptr->y - s_ptr->py;
+		int dx = m_ptr->x - s_ptr->px;
+
+		if (m_ptr->is_pet) continue;
+		if ((ABS(dy) > 1) || (ABS(dx) > 1)) continue;
+
+		*cmd = ';';
+		*dir = 5 + dx - 3 * dy;
+		return (TRUE);
+	}
+
+	/* The directions it may walk in */
+	for (i = 0; i < 8; i++)
+	{
+		int y = s_ptr->py + ddy_ddd[i];
+		int x = s_ptr->px + ddx_ddd[i];
+
+		if (!in_bounds(y, x)) continue;
+		if (!(o_ptr->info[y][x] & (OBS_PASS))) continue;
+
+		if (ddd[i] == last_dir) keep = TRUE;
+
+		ok[n++] = ddd[i];
+	}
+
+	/* Nowhere to go */
+	if (!n) return (FALSE);
+
+	/* Turn when it must, and now and then (by the game turn, so that the
+	 * bot takes none of the game's random numbers) */
+	if (!keep || stuck || !((o_ptr->turn / 10) % 16))
+		last_dir = ok[(o_ptr->turn / 10 + stuck) % n];
+
+	*cmd = ';';
+	*dir = last_dir;
+
+	return (TRUE);
+}
@@ -37,7 +37,7 @@ static void monster_find_cover(int m_idx, int *cy, int *cx) {
     int px = p_ptr->px;
     int dy, dx;
     int best_cover = -1;
-    int best_dist = 999;
+    int best_dist = 0;
 
     *cy = m_ptr->fy;
     *cx = m_ptr->fx;
@@ -53,53 +53,114 @@ static void monster_find_cover(int m_idx, int *cy, int *cx) {
             if (cave_m_idx[ny][nx] != 0 && cave_m_idx[ny][nx] != m_idx) continue;
 
             int cover = get_cover_vs_direction(ny, nx, py, px);
-            int d = distance(ny, nx, py, px);
+
+            /* Worse than the best so far */
+            if (cover < best_cover) continue;
+
+            /* Distance from where the monster is now */
+            int d = distance(ny, nx, m_ptr->fy, m_ptr->fx);
 
             if (cover > best_cover) {
                 best_cover = cover;
                 best_dist = d;
                 *cy = ny;
                 *cx = nx;
-            } else if (cover == best_cover) {
+            } else if (d < best_dist) {
                 /* Prefer closer cover? Or farther? Probably safer to be somewhat distant but close enough to act. */
                 /* Let's prefer closer to current position */
-                int d_curr = distance(ny, nx, m_ptr->fy, m_ptr->fx);
-                int d_best_curr = distance(*cy, *cx, m_ptr->fy, m_ptr->fx);
-                if (d_curr < d_best_curr) {
-                    *cy = ny;
-                    *cx = nx;
-                }
+                best_dist = d;
+                *cy = ny;
+                *cx = nx;
             }
         }
     }
 }
 
 /*
- * Initialize patrol system
+ * Take one step toward a target grid.
+ *
+ * Uses the shared flow fields (see "sector_step()"), so every guard heading
+ * for the same post, waypoint or alert point shares a single search, even
+ * from the far side of the level, and falls back to a greedy step when
+ * nothing leads there.
  */
-void init_patrol_system(void)
+static bool patrol_step_toward(int m_idx, int ty, int tx)
 {
-    int i;
-    for (i = 0; i < MAX_M_IDX; i++) {
-        m_guard[i] = NULL;
+    monster_type *m_ptr = &m_list[m_idx];
+    int ny, nx;
+
+    if (sector_step(m_ptr->fy, m_ptr->fx, ty, tx, &ny, &nx)) {
+        monster_swap(m_ptr->fy, m_ptr->fx, ny, nx);
+        return TRUE;
+    }
+
+    /* Simple move toward */
+    {
+        int dy = (ty > m_ptr->fy) ? 1 : ((ty < m_ptr->fy) ? -1 : 0);
+        int dx = (tx > m_ptr->fx) ? 1 : ((tx < m_ptr->fx) ? -1 : 0);
+
+        if (cave_floor_bold(m_ptr->fy + dy, m_ptr->fx + dx)) {
+            monster_swap(m_ptr->fy, m_ptr->fx, m_ptr->fy + dy, m_ptr->fx + dx);
+            return TRUE;
+        }
     }
+
+    return FALSE;
+}
+
+/*
+ * The guard data is kept without holes in "m_guard_list[1..m_guard_max-1]",
+ * each entry knowing its monster, and "m_guard_idx[]" gives the entry of
+ * each monster (or zero for none).  Freeing an entry moves the last one
+ * into the hole, so an entry may move whenever guard data is freed.
+ */
+
+
+/*
+ * Initialize patrol system (forget all the guard data)
+ */
+void init_patrol_system(void)
+{
+    C_WIPE(m_guard_idx, MAX_M_IDX, s16b);
+    m_guard_max = 1;
+}
+
+/*
+ * Guard data of a monster, or NULL if it has none
+ */
+monster_guard_data *get_guard_data(int m_idx)
+{
+    int g = m_guard_idx[m_idx];
+
+    if (!g) return NULL;
+
+    return &m_guard_list[g];
 }
 
 /*
  * Allocate guard data for a monster
+ *
+ * Returns NULL if there is no room for more guards.
  */
 monster_guard_data *alloc_guard_data(int m_idx)
 {
-    if (m_guard[m_idx] == NULL) {
-        m_guard[m_idx] = ZNEW(monster_guard_data);
-        /* Initialize defaults */
-        m_guard[m_idx]->guard_state = GUARD_STATE_PATROL;
-        m_guard[m_idx]->patrol_type = PATROL_TYPE_RANDOM;
-        m_guard[m_idx]->num_waypoints = 0;
-        m_guard[m_idx]->current_waypoint = 0;
-        m_guard[m_idx]->chase_timer = 0;
-    }
-    return m_guard[m_idx];
+    monster_guard_data *guard;
+
+    if (m_guard_idx[m_idx]) return &m_guard_list[m_guard_idx[m_idx]];
+
+    /* Too many guards */
+    if (m_guard_max >= MAX_GUARDS) return NULL;
+
+    m_guard_idx[m_idx] = m_guard_max;
+    guard = &m_guard_list[m_guard_max++];
+
+    /* Initialize defaults */
+    WIPE(guard, monster_guard_data);
+    guard->m_idx = m_idx;
+    guard->guard_state = GUARD_STATE_PATROL;
+    guard->patrol_type = PATROL_TYPE_RANDOM;
+
+    return guard;
 }
 
 /*
@@ -107,9 +168,33 @@ monster_guard_data *alloc_guard_data(int m_idx)
  */
 void free_guard_data(int m_idx)
 {
-    if (m_guard[m_idx] != NULL) {
-        KILL(m_guard[m_idx], monster_guard_data);
+    int g = m_guard_idx[m_idx];
+
+    if (!g) return;
+
+    m_guard_idx[m_idx] = 0;
+    m_guard_max--;
+
+    /* Move the last entry into the hole */
+    if (g != m_guard_max) {
+        COPY(&m_guard_list[g], &m_guard_list[m_guard_max], monster_guard_data);
+        m_guard_idx[m_guard_list[g].m_idx] = g;
     }
+
+    WIPE(&m_guard_list[m_guard_max], monster_guard_data);
+}
+
+/*
+ * The monster "i1" is now the monster "i2" (see "compact_monsters_aux()")
+ */
+void move_guard_data(int i1, int i2)
+{
+    int g = m_guard_idx[i1];
+
+    m_guard_idx[i2] = g;
+    m_guard_idx[i1] = 0;
+
+    if (g) m_guard_list[g].m_idx = i2;
 }
 
 /*
@@ -121,6 +206,9 @@ void setup_monster_patrol(int m_idx, int type)
     monster_guard_data *guard = alloc_guard_data(m_idx);
     int i;
 
+    /* Too many guards */
+    if (!guard) return;
+
     guard->patrol_type = type;
     guard->home_y = m_ptr->fy;
     guard->home_x = m_ptr->fx;
@@ -175,6 +263,9 @@ void setup_guard_post(int m_idx, int post_type, int y, int x)
     monster_guard_data *guard = alloc_guard_data(m_idx);
     int dy, dx;
 
+    /* Too many guards */
+    if (!guard) return;
+
     guard->guard_post_type = post_type;
     guard->home_y = y;
     guard->home_x = x;
@@ -310,35 +401,38 @@ static void advance_patrol_waypoint(monster_guard_data *guard)
  */
 void alert_nearby_guards(int y, int x, int radius)
 {
-    int m_idx;
+    s16b who[MAX_M_IDX];
+    int i, n;
 
-    for (m_idx = 1; m_idx < m_max; m_idx++) {
-        monster_type *m_ptr = &m_list[m_idx];
-        monster_guard_data *guard = m_guard[m_idx];
+    /* Only the monsters within the radius (see "monster_near()") */
+    n = monster_near(y, x, radius, who, MAX_M_IDX);
 
-        if (!m_ptr->r_idx) continue;
-        if (guard == NULL) continue; /* Not a guard */
+    for (i = 0; i < n; i++) {
+        monster_guard_data *guard = get_guard_data(who[i]);
+        monster_type *m_ptr = &m_list[who[i]];
 
-        /* Check distance */
-        if (distance(y, x, m_ptr->fy, m_ptr->fx) > radius) continue;
+        /* Only guards */
+        if (guard == NULL) continue;
+
+        /* Only guards not already roused (most of them, once a fight starts) */
+        if (guard->guard_state != GUARD_STATE_PATROL &&
+            guard->guard_state != GUARD_STATE_GUARD &&
+            guard->guard_state != GUARD_STATE_SLEEP) continue;
 
         /* Same "faction" - smart monsters alert each other */
         monster_race *r_ptr = &r_info[m_ptr->r_idx];
         if (!(r_ptr->flags2 & RF2_SMART) && !(r_ptr->flags1 & RF1_FRIENDS)) continue;
 
         /* Alert this guard */
-        if (guard->guard_state == GUARD_STATE_PATROL ||
-            guard->guard_state == GUARD_STATE_GUARD ||
-            guard->guard_state == GUARD_STATE_SLEEP) {
+        guard->guard_state = GUARD_STATE_ALERT;
+        guard->alert_y = y;
+        guard->alert_x = x;
 
-            guard->guard_state = GUARD_STATE_ALERT;
-            guard->alert_y = y;
-            guard->alert_x = x;
+        fuzz_hit(FUZZ_PATROL);
 
-            /* Visual feedback for close alerts */
-            if (player_has_los_bold(m_ptr->fy, m_ptr->fx)) {
-                msg_print("A nearby guard is alerted!");
-            }
+        /* Visual feedback for close alerts */
+        if (player_has_los_bold(m_ptr->fy, m_ptr->fx)) {
+            msg_print("A nearby guard is alerted!");
         }
     }
 }
@@ -351,7 +445,7 @@ bool execute_patrol_behavior(int m_idx)
 {
     monster_type *m_ptr = &m_list[m_idx];
     monster_race *r_ptr = &r_info[m_ptr->r_idx];
-    monster_guard_data *guard = m_guard[m_idx];
+    monster_guard_data *guard = get_guard_data(m_idx);
 
     if (guard == NULL) return FALSE; /* Not a patrol/guard monster */
 
@@ -402,15 +496,7 @@ bool execute_patrol_behavior(int m_idx)
                 return FALSE; /* Chase */
             } else {
                 /* Move toward alert spot */
-
-                /* Simple move toward */
-                int dy = (ty > m_ptr->fy) ? 1 : ((ty < m_ptr->fy) ? -1 : 0);
-                int dx = (tx > m_ptr->fx) ? 1 : ((tx < m_ptr->fx) ? -1 : 0);
-
-                if (cave_floor_bold(m_ptr->fy + dy, m_ptr->fx + dx)) {
-                    monster_swap(m_ptr->fy, m_ptr->fx, m_ptr->fy + dy, m_ptr->fx + dx);
-                    moved = TRUE;
-                }
+                moved = patrol_step_toward(m_idx, ty, tx);
             }
             break;
 
@@ -500,13 +586,7 @@ bool execute_patrol_behavior(int m_idx)
                 }
             } else {
                 /* Move toward post */
-                int dy = (ty > m_ptr->fy) ? 1 : ((ty < m_ptr->fy) ? -1 : 0);
-                int dx = (tx > m_ptr->fx) ? 1 : ((tx < m_ptr->fx) ? -1 : 0);
-
-                if (cave_floor_bold(m_ptr->fy + dy, m_ptr->fx + dx)) {
-                    monster_swap(m_ptr->fy, m_ptr->fx, m_ptr->fy + dy, m_ptr->fx + dx);
-                    moved = TRUE;
-                }
+                moved = patrol_step_toward(m_idx, ty, tx);
             }
             break;
 
@@ -546,13 +626,7 @@ bool execute_patrol_behavior(int m_idx)
                     }
                 } else {
                     /* Move toward waypoint */
-                    int dy = (wp->y > m_ptr->fy) ? 1 : ((wp->y < m_ptr->fy) ? -1 : 0);
-                    int dx = (wp->x > m_ptr->fx) ? 1 : ((wp->x < m_ptr->fx) ? -1 : 0);
-
-                    if (cave_floor_bold(m_ptr->fy + dy, m_ptr->fx + dx)) {
-                        monster_swap(m_ptr->fy, m_ptr->fx, m_ptr->fy + dy, m_ptr->fx + dx);
-                        moved = TRUE;
-                    }
+                    moved = patrol_step_toward(m_idx, wp->y, wp->x);
                 }
             }
             break;
@@ -566,7 +640,7 @@ bool execute_patrol_behavior(int m_idx)
  */
 bool monster_is_guarding(int m_idx)
 {
-    monster_guard_data *guard = m_guard[m_idx];
+    monster_guard_data *guard = get_guard_data(m_idx);
     if (guard == NULL) return FALSE;
 
     return (guard->guard_state == GUARD_STATE_GUARD ||
@@ -578,7 +652,7 @@ bool monster_is_guarding(int m_idx)
  */
 void monster_spotted_target(int m_idx, int ty, int tx)
 {
-    monster_guard_data *guard = m_guard[m_idx];
+    monster_guard_data *guard = get_guard_data(m_idx);
     if (guard == NULL) return;
 
     guard->guard_state = GUARD_STATE_CHASE;
@@ -619,6 +693,9 @@ void setup_squad_patrol(int *m_idx_list, int num_monsters, int center_y, int cen
     for (i = 0; i < num_monsters; i++) {
         monster_guard_data *guard = alloc_guard_data(m_idx_list[i]);
 
+        /* Too many guards */
+        if (!guard) continue;
+
         guard->patrol_type = PATROL_TYPE_CIRCUIT;
         guard->num_waypoints = num_waypoints;
         guard->home_y = center_y;
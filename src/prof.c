@@ -0,0 +1,380 @@
+/* File: prof.c */
+
+/*
+ * A sampling profiler (the "--profile" option, and the debug command 'Z')
+ *
+ * While it runs, "metric_start()" and "metric_stop()" keep a stack of the
+ * hot-path timers which are running (see "metrics.c"), and a SIGPROF timer
+ * looks at that stack every PROF_USEC microseconds of processor time.  The
+ * signal handler only packs the stack into one number and puts it in a
+ * ring, which the game empties every game turn (so no locks are needed:
+ * the handler only moves the head, and the game only moves the tail).
+ * A sample which finds the ring full is lost, and counted.
+ *
+ * The samples are added up by stack, and written out (every "n" game
+ * turns with "--profile <n>", or when the debug command 'Z' stops the
+ * profiler) to "kamband_prof.folded", as "folded stacks":
+ *
+ *	turns_1000-2000;process_monsters;project 35
+ *
+ * one line for each stack, which the usual flame graph scripts take as
+ * they are.  Time spent outside every timer shows as "other".  Stacks
+ * deeper than PROF_DEPTH keep their outermost timers (there is room for
+ * eight timers of four bits in a sample, so METRIC_TIMERS must stay
+ * below 16).
+ */
+
+#include "angband.h"
+
+
+#ifdef SET_UID
+
+#include <signal.h>
+#include <sys/time.h>
+
+
+/*
+ * One stack and its samples
+ */
+typedef struct prof_type prof_type;
+
+struct prof_type
+{
+	u32b key;		/* Timers, four bits each (plus one), outermost first */
+	u32b count;		/* Samples */
+};
+
+
+/*
+ * Profiling
+ */
+static bool prof_on = FALSE;
+
+/*
+ * Game turns between two writes, or zero for "only when stopped"
+ */
+static s32b prof_every = 0;
+
+/*
+ * The first game turn of these samples
+ */
+static s32b prof_first = 0;
+
+/*
+ * The timers running now, outermost first
+ */
+static volatile byte prof_stack[PROF_DEPTH];
+static volatile int prof_depth = 0;
+
+/*
+ * The ring of samples (the handler moves the head, the game the tail)
+ */
+static volatile u32b prof_ring[PROF_RING];
+static volatile u32b prof_head = 0;
+static volatile u32b prof_tail = 0;
+static volatile u32b prof_lost = 0;
+
+/*
+ * The samples, added up by stack
+ */
+static prof_type prof_stacks[PROF_STACKS];
+static u32b prof_samples = 0;
+
+/*
+ * The file, once opened
+ */
+static FILE *prof_fff = NULL;
+
+
+/*
+ * Take a sample
+ */
+static void prof_signal(int sig)
+{
+	u32b key = 0;
+	u32b head = prof_head;
+	int i, n = prof_depth;
+
+	/* Unused */
+	(void)sig;
+
+	if (n > PROF_DEPTH) n = PROF_DEPTH;
+
+	for (i = 0; i < n; i++) key = (key << 4) | (u32b)(prof_stack[i] + 1);
+
+	/* Full */
+	if (head - prof_tail >= PROF_RING)
+	{
+		prof_lost++;
+		return;
+	}
+
+	prof_ring[head % PROF_RING] = key;
+	prof_head = head + 1;
+}
+
+
+/*
+ * Add the samples in the ring to the stacks
+ */
+static void prof_drain(void)
+{
+	u32b head = prof_head;
+
+	while (prof_tail != head)
+	{
+		u32b key = prof_ring[prof_tail % PROF_RING];
+		int i = (int)((key * 2654435761UL) % PROF_STACKS);
+		int k;
+
+		prof_tail++;
+
+		/* Find the stack, or an empty slot */
+		for (k = 0; k < PROF_STACKS; k++)
+		{
+			prof_type *s_ptr = &prof_stacks[i];
+
+			if (!s_ptr->count || (s_ptr->key == key)) break;
+
+			i = (i + 1) % PROF_STACKS;
+		}
+
+		/* Too many stacks */
+		if (k == PROF_STACKS)
+		{
+			prof_lost++;
+			continue;
+		}
+
+		prof_stacks[i].key = key;
+		prof_stacks[i].count++;
+		prof_samples++;
+	}
+}
+
+
+/*
+ * Write out (and forget) the samples so far
+ *
+ * Returns the number of samples written.
+ */
+static u32b prof_write(void)
+{
+	u32b n;
+	int i, j;
+
+	prof_drain();
+	n = prof_samples;
+
+	if (!prof_fff)
+	{
+		char path[1024];
+
+		metric_path(path, sizeof(path), "kamband_prof.folded");
+		prof_fff = fopen(path, "w");
+	}
+
+	for (i = 0; prof_fff && (i < PROF_STACKS); i++)
+	{
+		prof_type *s_ptr = &prof_stacks[i];
+
+		if (!s_ptr->count) continue;
+
+		fprintf(prof_fff, "turns_%ld-%ld", (long)prof_first, (long)turn);
+
+		/* No timer running */
+		if (!s_ptr->key) fprintf(prof_fff, ";other");
+
+		/* Outermost first */
+		for (j = PROF_DEPTH - 1; j >= 0; j--)
+		{
+			int t = (int)((s_ptr->key >> (4 * j)) & 0x0F);
+			cptr name;
+
+			if (!t) continue;
+
+			/* Drop the "_us" */
+			name = metric_timer_name(t - 1);
+			fprintf(prof_fff, ";%.*s", (int)strlen(name) - 3, name);
+		}
+
+		fprintf(prof_fff, " %lu\n", (unsigned long)s_ptr->count);
+	}
+
+	if (prof_fff) fflush(prof_fff);
+
+	/* Forget them */
+	C_WIPE(prof_stacks, PROF_STACKS, prof_type);
+	prof_samples = 0;
+	prof_first = turn;
+
+	return (n);
+}
+
+
+/*
+ * Set the SIGPROF timer going (or stop it, if "usec" is zero)
+ */
+static void prof_timer(long usec)
+{
+	struct itimerval it;
+
+	it.it_interval.tv_sec = usec / 1000000L;
+	it.it_interval.tv_usec = usec % 1000000L;
+	it.it_value = it.it_interval;
+
+	(void)setitimer(ITIMER_PROF, &it, NULL);
+}
+
+
+/*
+ * Start the profiler, writing the samples every "every" game turns (or
+ * only when it is stopped, if zero)
+ */
+void prof_start(s32b every)
+{
+	if (prof_on) return;
+
+	prof_every = every;
+	prof_first = turn;
+	prof_depth = 0;
+	prof_tail = prof_head;
+
+	(void)signal(SIGPROF, prof_signal);
+	prof_timer(PROF_USEC);
+
+	prof_on = TRUE;
+
+	/* Write the last of them at exit */
+	if (every) atexit(prof_stop_quietly);
+}
+
+
+/*
+ * Stop the profiler, and write out the samples
+ *
+ * Returns the number of samples written.
+ */
+u32b prof_stop(void)
+{
+	if (!prof_on) return (0);
+
+	prof_timer(0);
+	(void)signal(SIGPROF, SIG_IGN);
+
+	prof_on = FALSE;
+
+	return (prof_write());
+}
+
+
+/*
+ * Stop the profiler, as an exit handler
+ */
+void prof_stop_quietly(void)
+{
+	(void)prof_stop();
+}
+
+
+/*
+ * Is the profiler running?
+ */
+bool prof_running(void)
+{
+	return (prof_on);
+}
+
+
+/*
+ * Samples lost so far (the ring or the stacks were full)
+ */
+u32b prof_lost_samples(void)
+{
+	return (prof_lost);
+}
+
+
+/*
+ * The hot-path timer "t" has started
+ */
+void prof_push(int t)
+{
+	if (!prof_on) return;
+
+	/* Deep stacks keep their outermost timers */
+	if (prof_depth < PROF_DEPTH) prof_stack[prof_depth] = (byte)t;
+
+	prof_depth++;
+}
+
+
+/*
+ * The innermost hot-path timer has stopped
+ */
+void prof_pop(void)
+{
+	if (!prof_on) return;
+
+	/* Paranoia -- started while it ran */
+	if (prof_depth > 0) prof_depth--;
+}
+
+
+/*
+ * A game turn is over
+ */
+void prof_turn(void)
+{
+	if (!prof_on) return;
+
+	prof_drain();
+
+	if (prof_every && (turn - prof_first >= prof_every)) (void)prof_write();
+}
+
+
+#else /* SET_UID */
+
+
+void prof_start(s32b every)
+{
+	/* Unused */
+	(void)every;
+}
+
+u32b prof_stop(void)
+{
+	return (0);
+}
+
+void prof_stop_quietly(void)
+{
+}
+
+bool prof_running(void)
+{
+	return (FALSE);
+}
+
+u32b prof_lost_samples(void)
+{
+	return (0);
+}
+
+void prof_push(int t)
+{
+	/* Unused */
+	(void)t;
+}
+
+void prof_pop(void)
+{
+}
+
+void prof_turn(void)
+{
+}
+
+
+#endif /* SET_UID */
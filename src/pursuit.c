@@ -13,6 +13,16 @@ static int ambush_r_idx[MAX_AMBUSH];
 static int ambush_hp[MAX_AMBUSH];
 static int ambush_maxhp[MAX_AMBUSH];
 
+/* Refreshes of the screen a breathing wall shows for */
+#define BREATHE_LIFE 2
+
+/*
+ * Followers which have arrived on the new level, but are not yet placed
+ * (see "process_pursuit()")
+ */
+static bool pursuit_arrived = FALSE;
+static bool ambush_arrived = FALSE;
+
 static s32b level_start_turn = 0;
 
 /* Smart triggers state */
@@ -72,6 +82,7 @@ void prepare_staircase_pursuit(void)
     monster_race *r_ptr;
 
     pursuit_r_idx = 0;
+    pursuit_arrived = FALSE;
 
     for (d = 0; d < 8; d++)
     {
@@ -98,31 +109,40 @@ void prepare_staircase_pursuit(void)
     }
 }
 
-void execute_staircase_pursuit(void)
+/*
+ * Place a follower near the player, as it was when it left.
+ * Returns TRUE if there was room.
+ */
+static bool place_follower(int r_idx, int hp, int maxhp)
 {
-    if (pursuit_r_idx > 0)
+    int y, x, d;
+
+    for (d = 1; d < 10; d++)
     {
-        int y, x, d;
-        for (d = 1; d < 10; d++)
+        scatter(&y, &x, p_ptr->py, p_ptr->px, d, 0);
+        if (cave_empty_bold(y, x))
         {
-            scatter(&y, &x, p_ptr->py, p_ptr->px, d, 0);
-            if (cave_empty_bold(y, x))
+            if (place_monster_aux(y, x, r_idx, 0))
             {
-                if (place_monster_aux(y, x, pursuit_r_idx, 0))
+                int m_idx = cave_m_idx[y][x];
+                if (m_idx > 0)
                 {
-                    int m_idx = cave_m_idx[y][x];
-                    if (m_idx > 0)
-                    {
-                        m_list[m_idx].hp = pursuit_hp;
-                        m_list[m_idx].maxhp = pursuit_maxhp;
-                        msg_print("You feel you are being pursued!");
-                    }
+                    m_list[m_idx].hp = hp;
+                    m_list[m_idx].maxhp = maxhp;
+                    return (TRUE);
                 }
-                break;
             }
+            break;
         }
-        pursuit_r_idx = 0;
     }
+
+    return (FALSE);
+}
+
+void execute_staircase_pursuit(void)
+{
+    /* Place it when the monsters first move */
+    if (pursuit_r_idx > 0) pursuit_arrived = TRUE;
 }
 
 void prepare_recall_ambush(void)
@@ -130,6 +150,7 @@ void prepare_recall_ambush(void)
     int d, y, x, m_idx;
 
     ambush_count = 0;
+    ambush_arrived = FALSE;
 
     for (d = 0; d < 8; d++)
     {
@@ -154,9 +175,30 @@ void prepare_recall_ambush(void)
 }
 
 void execute_recall_ambush(void)
+{
+    /* Place them when the monsters first move */
+    if (ambush_count > 0 && !p_ptr->depth) ambush_arrived = TRUE;
+
+    /* Clear ambush if not in town (shouldn't happen with recall logic but safe) */
+    if (p_ptr->depth != 0) ambush_count = 0;
+}
+
+void process_pursuit(void)
 {
     int i;
-    if (ambush_count > 0 && !p_ptr->depth)
+
+    if (pursuit_arrived)
+    {
+        if (place_follower(pursuit_r_idx, pursuit_hp, pursuit_maxhp))
+        {
+            msg_print("You feel you are being pursued!");
+        }
+
+        pursuit_r_idx = 0;
+        pursuit_arrived = FALSE;
+    }
+
+    if (ambush_arrived)
     {
         /* Randomize location in town */
         teleport_player(200);
@@ -164,29 +206,12 @@ void execute_recall_ambush(void)
 
         for (i = 0; i < ambush_count; i++)
         {
-            int y, x, d;
-            for (d = 1; d < 10; d++)
-            {
-                scatter(&y, &x, p_ptr->py, p_ptr->px, d, 0);
-                if (cave_empty_bold(y, x))
-                {
-                    if (place_monster_aux(y, x, ambush_r_idx[i], 0))
-                    {
-                        int m_idx = cave_m_idx[y][x];
-                        if (m_idx > 0)
-                        {
-                            m_list[m_idx].hp = ambush_hp[i];
-                            m_list[m_idx].maxhp = ambush_maxhp[i];
-                        }
-                    }
-                    break;
-                }
-            }
+            (void)place_follower(ambush_r_idx[i], ambush_hp[i], ambush_maxhp[i]);
         }
+
         ambush_count = 0;
+        ambush_arrived = FALSE;
     }
-    /* Clear ambush if not in town (shouldn't happen with recall logic but safe) */
-    if (p_ptr->depth != 0) ambush_count = 0;
 }
 
 void reset_dread(void)
@@ -262,7 +287,7 @@ void process_breathing_walls(void)
     int i;
     if (p_ptr->depth < 50) return;
 
-    /* Visual effect only */
+    /* Visual effect only (it never touches the map) */
     for (i = 0; i < 10; i++)
     {
         int y = rand_int(DUNGEON_HGT);
@@ -274,7 +299,7 @@ void process_breathing_walls(void)
         if (cave_feat[y][x] >= FEAT_WALL_EXTRA && cave_feat[y][x] <= FEAT_WALL_SOLID)
         {
             char c = (rand_int(2) == 0) ? '%' : '#';
-            print_rel(c, TERM_SLATE, y, x);
+            print_fx(c, TERM_SLATE, y, x, BREATHE_LIFE);
         }
     }
 }
@@ -12,7 +12,7 @@
 void prepare_staircase_pursuit(void);
 
 /*
- * Spawn the pursuing monster on the new level.
+ * Note that the pursuing monster has reached the new level.
  * Called after level generation.
  */
 void execute_staircase_pursuit(void);
@@ -24,11 +24,18 @@ void execute_staircase_pursuit(void);
 void prepare_recall_ambush(void);
 
 /*
- * Spawn the ambushers in town.
+ * Note that the ambushers have reached the town.
  * Called after level (town) generation.
  */
 void execute_recall_ambush(void);
 
+/*
+ * Place the followers which have reached this level, if any.
+ * Called before the monsters move, so that a level change does not
+ * pay for them up front.
+ */
+void process_pursuit(void);
+
 /*
  * Reset dread timers.
  * Called at level generation.
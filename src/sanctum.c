@@ -25,35 +25,68 @@ void reset_puzzle_state(void)
     p_ptr->puzzle_next = 0;
 }
 
+/*
+ * Add a sanctum door to the door list (see "rebuild_level_indexes()")
+ *
+ * The generation places the doors straight into "cave_feat[][]", and
+ * nothing else makes them, so the list is only built when the level is
+ * ready.  If there are too many, the list notes it, and the doors are
+ * looked for over the whole level instead.
+ */
+void sanctum_door_add(int y, int x)
+{
+    if (sanctum_door_n >= SANCTUM_DOOR_MAX) {
+        sanctum_door_full = TRUE;
+        return;
+    }
+
+    sanctum_door_y[sanctum_door_n] = y;
+    sanctum_door_x[sanctum_door_n] = x;
+    sanctum_door_n++;
+}
+
+/*
+ * Open a sanctum door, if the grid still holds one
+ */
+static bool open_sanctum_door_grid(int y, int x)
+{
+    if (cave_feat[y][x] != FEAT_SANCTUM_DOOR) return (FALSE);
+
+    cave_set_feat(y, x, FEAT_FLOOR);
+    note_spot(y, x);
+    lite_spot(y, x);
+
+    return (TRUE);
+}
+
 /*
  * Open the Sanctum Door
  */
 static void open_sanctum_door(void)
 {
-    int y, x;
+    int i, y, x;
     bool opened = FALSE;
 
-    /* Find the sanctum door(s) and open them */
-    /* Since we don't store the door location, scan the level?
-       Or just scan near the player since they must be at the puzzle.
-       Scanning the whole level is safe enough for 66x198 or similar sizes. */
-
-    for (y = 0; y < DUNGEON_HGT; y++) {
-        for (x = 0; x < DUNGEON_WID; x++) {
-            if (cave_feat[y][x] == FEAT_SANCTUM_DOOR || cave_feat[y][x] == FEAT_SANCTUM_WALL) {
-                /* Only open if it looks like a door (connected to floor on both sides?)
-                   For now, just convert all Sanctum Doors to floor.
-                   We rely on the generation to place FEAT_SANCTUM_DOOR specifically. */
-                if (cave_feat[y][x] == FEAT_SANCTUM_DOOR) {
-                    cave_set_feat(y, x, FEAT_FLOOR);
-                    note_spot(y, x);
-                    lite_spot(y, x);
-                    opened = TRUE;
-                }
+    /* Open all the sanctum doors of the level (in map order) */
+    if (!sanctum_door_full) {
+        for (i = 0; i < sanctum_door_n; i++) {
+            if (open_sanctum_door_grid(sanctum_door_y[i], sanctum_door_x[i]))
+                opened = TRUE;
+        }
+    }
+
+    /* Paranoia -- too many to list */
+    else {
+        for (y = 0; y < DUNGEON_HGT; y++) {
+            for (x = 0; x < DUNGEON_WID; x++) {
+                if (open_sanctum_door_grid(y, x)) opened = TRUE;
             }
         }
     }
 
+    /* Opened doors are gone for good */
+    if (opened && !sanctum_door_full) sanctum_door_n = 0;
+
     if (opened) {
         msg_print("The sanctum seal fades away!");
     }
@@ -67,6 +100,8 @@ void interaction_rune(int y, int x)
     int rune_id = cave_feat[y][x] - FEAT_RUNE_A;
     if (rune_id < 0 || rune_id > 4) return;
 
+    fuzz_hit(FUZZ_SANCTUM);
+
     /* Check if correct next rune */
     if (rune_id == p_ptr->puzzle_solution[p_ptr->puzzle_next]) {
         msg_print("The rune glows brightly.");
@@ -171,6 +206,8 @@ static void build_flow_conduit(int y, int x)
  */
 void interaction_lever(int y, int x)
 {
+    fuzz_hit(FUZZ_SANCTUM);
+
     /* Toggle lever state */
     if (cave_feat[y][x] == FEAT_LEVER_LEFT) {
         p_ptr->puzzle_attempt[0] = !p_ptr->puzzle_attempt[0];
@@ -252,6 +289,8 @@ static bool check_mirror_beam(int y, int x) {
 
 void interaction_plate(int y, int x)
 {
+    fuzz_hit(FUZZ_SANCTUM);
+
     msg_print("You step on the pressure plate. A beam of light shoots forth!");
 
     /* Check if beam hits crystal */
@@ -421,6 +460,8 @@ void build_folly_vault(int y, int x)
  */
 void interaction_idol(int y, int x)
 {
+    fuzz_hit(FUZZ_SANCTUM);
+
     if (p_ptr->au >= 5000) {
         if (get_check("Offer 5000 gold for a hint? ")) {
             int rune_idx = p_ptr->puzzle_solution[p_ptr->puzzle_next];
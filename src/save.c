@@ -10,6 +10,10 @@
 
 #include "angband.h"
 
+#ifdef SAVE_BACKGROUND
+# include <sys/wait.h>
+#endif
+
 
 #ifdef FUTURE_SAVEFILES
 
@@ -393,6 +397,38 @@ static byte xor_byte; /* Simple encryption */
 static u32b v_stamp = 0L; /* A simple "checksum" on the actual values */
 static u32b x_stamp = 0L; /* A simple "checksum" on the encoded bytes */
 
+static byte *sf_mem = NULL; /* Current memory "file", if any */
+static u32b sf_mem_len = 0L; /* Bytes written to it */
+static u32b sf_mem_size = 0L; /* Bytes allocated for it */
+
+
+
+/*
+ * Make room for "n" more bytes in the memory "file"
+ */
+static void sf_mem_room(u32b n)
+{
+	byte *buf;
+	u32b size = sf_mem_size;
+	int tag;
+
+	if (sf_mem_len + n <= sf_mem_size) return;
+
+	/* Grow by doubling */
+	if (size < 65536L) size = 65536L;
+	while (size < sf_mem_len + n) size *= 2;
+
+	tag = VIRT_TAG(MEM_LEVEL);
+	C_MAKE(buf, size, byte);
+	(void)VIRT_TAG(tag);
+
+	if (sf_mem) (void)C_COPY(buf, sf_mem, sf_mem_len, byte);
+	C_KILL(sf_mem, sf_mem_size, byte);
+
+	sf_mem = buf;
+	sf_mem_size = size;
+}
+
 
 
 /*
@@ -403,7 +439,16 @@ static void sf_put(byte v)
 {
 	/* Encode the value, write a character */
 	xor_byte ^= v;
-	(void) putc((int) xor_byte, fff);
+
+	if (sf_mem)
+	{
+		sf_mem_room(1);
+		sf_mem[sf_mem_len++] = xor_byte;
+	}
+	else
+	{
+		(void) putc((int) xor_byte, fff);
+	}
 
 	/* Maintain the checksum info */
 	v_stamp += v;
@@ -449,6 +494,34 @@ static void wr_string(cptr str)
 	wr_byte(*str);
 }
 
+/*
+ * Write a whole block of bytes at once (the block is encoded in place)
+ */
+static void wr_block(byte *buf, u32b len)
+{
+	u32b i;
+
+	for (i = 0; i < len; i++)
+	{
+		/* Encode the value */
+		v_stamp += buf[i];
+		xor_byte ^= buf[i];
+		buf[i] = xor_byte;
+		x_stamp += xor_byte;
+	}
+
+	if (sf_mem)
+	{
+		sf_mem_room(len);
+		(void)C_COPY(sf_mem + sf_mem_len, buf, len, byte);
+		sf_mem_len += len;
+	}
+	else
+	{
+		(void) fwrite(buf, 1, len, fff);
+	}
+}
+
 
 /*
  * These functions write info in larger logical records
@@ -517,6 +590,7 @@ static void wr_monster(int m_idx)
 {
 	monster_type *m_ptr = &m_list[m_idx];
 	object_type *o_ptr;
+    monster_guard_data *guard;
     int i;
 
 	wr_s16b(m_ptr->r_idx);
@@ -556,23 +630,24 @@ static void wr_monster(int m_idx)
 	wr_s16b(0);
 
     /* Write guard data */
-    if (m_guard[m_idx]) {
+    guard = get_guard_data(m_idx);
+    if (guard) {
         wr_byte(1);
-        wr_s16b(m_guard[m_idx]->home_y);
-        wr_s16b(m_guard[m_idx]->home_x);
-        wr_s16b(m_guard[m_idx]->alert_y);
-        wr_s16b(m_guard[m_idx]->alert_x);
-        wr_s16b(m_guard[m_idx]->chase_timer);
-        wr_byte(m_guard[m_idx]->guard_state);
-        wr_byte(m_guard[m_idx]->patrol_type);
-        wr_byte(m_guard[m_idx]->current_waypoint);
-        wr_byte(m_guard[m_idx]->num_waypoints);
-        wr_byte(m_guard[m_idx]->guard_post_type);
+        wr_s16b(guard->home_y);
+        wr_s16b(guard->home_x);
+        wr_s16b(guard->alert_y);
+        wr_s16b(guard->alert_x);
+        wr_s16b(guard->chase_timer);
+        wr_byte(guard->guard_state);
+        wr_byte(guard->patrol_type);
+        wr_byte(guard->current_waypoint);
+        wr_byte(guard->num_waypoints);
+        wr_byte(guard->guard_post_type);
 
         for (i = 0; i < PATROL_MAX_WAYPOINTS; i++) {
-            wr_s16b(m_guard[m_idx]->waypoints[i].y);
-            wr_s16b(m_guard[m_idx]->waypoints[i].x);
-            wr_byte(m_guard[m_idx]->waypoints[i].wait_turns);
+            wr_s16b(guard->waypoints[i].y);
+            wr_s16b(guard->waypoints[i].x);
+            wr_byte(guard->waypoints[i].wait_turns);
         }
     } else {
         wr_byte(0);
@@ -635,6 +710,36 @@ static void wr_lore(int r_idx)
 }
 
 
+/*
+ * Does a race have anything worth saving?  Everything else is what the
+ * loader will assume anyway (no lore, and the usual monster limit).
+ */
+static bool lore_touched(int r_idx)
+{
+	monster_race *r_ptr = &r_info[r_idx];
+
+	if (r_ptr->r_sights || r_ptr->r_deaths) return (TRUE);
+	if (r_ptr->r_pkills || r_ptr->r_tkills) return (TRUE);
+	if (r_ptr->r_wake || r_ptr->r_ignore) return (TRUE);
+	if (r_ptr->r_xtra1 || r_ptr->r_xtra2) return (TRUE);
+	if (r_ptr->r_drop_gold || r_ptr->r_drop_item) return (TRUE);
+	if (r_ptr->r_cast_inate || r_ptr->r_cast_spell) return (TRUE);
+
+	if (r_ptr->r_blows[0] || r_ptr->r_blows[1] ||
+		r_ptr->r_blows[2] || r_ptr->r_blows[3]) return (TRUE);
+
+	if (r_ptr->r_flags1 || r_ptr->r_flags2 || r_ptr->r_flags3 ||
+		r_ptr->r_flags4 || r_ptr->r_flags5 || r_ptr->r_flags6 ||
+		r_ptr->r_flags7) return (TRUE);
+
+	/* Dead uniques, mostly */
+	if (r_ptr->max_num != ((r_ptr->flags1 & (RF1_UNIQUE)) ? 1 : 100))
+		return (TRUE);
+
+	return (FALSE);
+}
+
+
 /*
  * Write an "xtra" record
  */
@@ -933,7 +1038,7 @@ static void wr_extra(void)
 	wr_s16b(p_ptr->shield);
 	wr_s16b(p_ptr->blessed);
 	wr_s16b(p_ptr->tim_invis);
-	wr_s16b(p_ptr->word_recall);
+	wr_s16b(0);	/* Word of recall (now an event) */
 	wr_s16b(p_ptr->see_infra);
 	wr_s16b(p_ptr->tim_infra);
 	wr_s16b(p_ptr->oppose_fire);
@@ -954,9 +1059,13 @@ static void wr_extra(void)
 	wr_byte(p_ptr->maximize);
 	wr_byte(p_ptr->preserve);
 
+	/* Shop maintenance owed */
+	for (i = 0; i < MAX_STORES; i++)
+		wr_byte(store[i].maint_due);
+
 	/* Future use */
-	for (i = 0; i < 12; i++)
-		wr_u32b(0L);
+	for (i = 0; i < 48 - MAX_STORES; i++)
+		wr_byte(0);
 
     /* Write puzzle state */
     for (i = 0; i < 8; i++) wr_byte(p_ptr->puzzle_solution[i]);
@@ -964,10 +1073,10 @@ static void wr_extra(void)
     wr_byte(p_ptr->puzzle_next);
 
     /* Write extra state */
-    wr_s16b(tome_decipher_turns);
+    wr_s16b(0);	/* Tome decipher timer (now an event) */
     wr_s16b(p_ptr->anti_magic);
     wr_u32b(lore_known);
-    wr_s16b(tome_decipher_idx);
+    wr_s16b(0);	/* Tome being deciphered (now an event) */
     wr_s16b(p_ptr->scroll_delay);
     wr_byte(p_ptr->scroll_pending_effect);
     wr_byte(p_ptr->anchored);
@@ -999,21 +1108,106 @@ static void wr_extra(void)
 
 	/* Current turn */
 	wr_s32b(turn);
+
+	/* Scheduled events */
+	wr_s16b(event_count());
+	for (i = 0; i < event_count(); i++)
+	{
+		event_type *e_ptr = event_at(i);
+
+		wr_s32b(e_ptr->turn);
+		wr_byte(e_ptr->kind);
+		wr_s16b(e_ptr->data);
+	}
 }
 
 
 
 /*
- * Write the current dungeon
+ * Write one grid layer of the dungeon as a packed chunk.
+ *
+ * A chunk is the layer number, the unpacked and packed sizes, and the
+ * packed bytes, which are written in one go instead of a byte at a time.
  */
-static void wr_dungeon(void)
+static void wr_grid_layer(int layer, byte *raw, byte *packed)
 {
-	int i, y, x;
+	int y, x;
+	u32b n = 0;
+	u32b len;
 
-	byte tmp8u;
+	/* Extract the layer, a whole layer at a time */
+	switch (layer)
+	{
+		case GRID_LAYER_INFO_LO:
+		{
+			for (y = 0; y < DUNGEON_HGT; y++)
+				for (x = 0; x < DUNGEON_WID; x++)
+					raw[n++] = (byte)(cave_info[y][x] & 0xFF);
+			break;
+		}
+
+		case GRID_LAYER_INFO_HI:
+		{
+			for (y = 0; y < DUNGEON_HGT; y++)
+				for (x = 0; x < DUNGEON_WID; x++)
+					raw[n++] = (byte)(cave_info[y][x] >> 8);
+			break;
+		}
+
+		case GRID_LAYER_ELEV:
+		{
+			for (y = 0; y < DUNGEON_HGT; y++)
+				for (x = 0; x < DUNGEON_WID; x++)
+					raw[n++] = (byte)cave_flow[y][x].elev;
+			break;
+		}
+
+		case GRID_LAYER_FUEL_LO:
+		{
+			for (y = 0; y < DUNGEON_HGT; y++)
+				for (x = 0; x < DUNGEON_WID; x++)
+					raw[n++] = (byte)(cave[y][x].fuel & 0xFF);
+			break;
+		}
+
+		case GRID_LAYER_FUEL_HI:
+		{
+			for (y = 0; y < DUNGEON_HGT; y++)
+				for (x = 0; x < DUNGEON_WID; x++)
+					raw[n++] = (byte)(cave[y][x].fuel >> 8);
+			break;
+		}
+
+		case GRID_LAYER_FEAT:
+		{
+			n = DUNGEON_HGT * DUNGEON_WID;
+			C_COPY(raw, &cave_feat[0][0], n, byte);
+			break;
+		}
+
+		case GRID_LAYER_SECTOR:
+		{
+			n = DUNGEON_HGT * DUNGEON_WID;
+			C_COPY(raw, &cave_sector[0][0], n, byte);
+			break;
+		}
+	}
+
+	len = pack_block(raw, n, packed);
+
+	wr_byte((byte)layer);
+	wr_u32b(n);
+	wr_u32b(len);
+	wr_block(packed, len);
+}
 
-	byte count;
-	byte prev_char;
+
+/*
+ * Write the current dungeon
+ */
+static void wr_dungeon(void)
+{
+	int i;
 
 	object_type *o_ptr;
 
@@ -1040,214 +1234,56 @@ static void wr_dungeon(void)
 	wr_s16b(DUNGEON_WID);
 
 
-	/*** Simple "Run-Length-Encoding" of cave ***/
-
-	/* Note that this will induce two wasted bytes */
-	{
-		u16b prev_info = 0;
-		u16b tmp16u;
-		count = 0;
-
-		/* Dump the cave */
-		for (y = 0; y < DUNGEON_HGT; y++)
-		{
-			for (x = 0; x < DUNGEON_WID; x++)
-			{
-				/* Extract a u16b */
-				tmp16u = cave_info[y][x];
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp16u != prev_info) || (count == MAX_UCHAR))
-			{
-				if (count)
-				{
-					wr_byte((byte) count);
-					wr_u16b(prev_info);
-				}
-				prev_info = tmp16u;
-				count = 1;
-			}
-
-			/* Continue the run */
-			else
-			{
-				count++;
-			}
-		}
-	}
+	/*** Grid layers ***/
 
-	/* Flush the data (if any) */
-	if (count)
 	{
-		wr_byte((byte) count);
-		wr_u16b(prev_info);
-	}
-	}
+		byte *raw, *packed;
 
-	/*** Simple "Run-Length-Encoding" of elevation ***/
+		C_MAKE(raw, DUNGEON_HGT * DUNGEON_WID, byte);
+		C_MAKE(packed, PACK_BOUND(DUNGEON_HGT * DUNGEON_WID), byte);
 
-	/* Reset counters */
-	count = 0;
-	prev_char = 0;
+		/* Flag the layout (never a run-length count) */
+		wr_byte(0);
+		wr_byte(GRID_LAYER_VERSION);
+		wr_byte(GRID_LAYER_MAX);
 
-	/* Dump the elevation data */
-	for (y = 0; y < DUNGEON_HGT; y++)
-	{
-		for (x = 0; x < DUNGEON_WID; x++)
+		for (i = 1; i <= GRID_LAYER_MAX; i++)
 		{
-			/* Extract the elevation byte */
-			tmp8u = (byte)get_elevation(y, x);
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == MAX_UCHAR))
-			{
-				if (count)
-				{
-					wr_byte((byte) count);
-					wr_byte((byte) prev_char);
-				}
-				prev_char = tmp8u;
-				count = 1;
-			}
-			/* Continue the run */
-			else
-			{
-				count++;
-			}
+			wr_grid_layer(i, raw, packed);
 		}
-	}
 
-	/* Flush the data (if any) */
-	if (count)
-	{
-		wr_byte((byte) count);
-		wr_byte((byte) prev_char);
+		C_KILL(raw, DUNGEON_HGT * DUNGEON_WID, byte);
+		C_KILL(packed, PACK_BOUND(DUNGEON_HGT * DUNGEON_WID), byte);
 	}
 
 
-	/*** Simple "Run-Length-Encoding" of cave fire life ***/
-
-	/* Note that this will induce two wasted bytes */
-	count = 0;
-	prev_char = 0;
-
-	/* Dump the cave */
-	for (y = 0; y < DUNGEON_HGT; y++)
-	{
-		for (x = 0; x < DUNGEON_WID; x++)
-		{
-			/* Extract a byte */
-			tmp8u = (byte)cave[y][x].fuel;
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == MAX_UCHAR))
-			{
-				if (count)
-				{
-					wr_byte((byte) count);
-					wr_byte((byte) prev_char);
-				}
-				prev_char = tmp8u;
-				count = 1;
-			}
+	/*** Shifting maze walls ***/
 
-			/* Continue the run */
-			else
-			{
-				count++;
-			}
-		}
-	}
+	wr_s16b(active_wall_n);
 
-	/* Flush the data (if any) */
-	if (count)
+	for (i = 0; i < active_wall_n; i++)
 	{
-		wr_byte((byte) count);
-		wr_byte((byte) prev_char);
+		wr_s16b(active_wall_y[i]);
+		wr_s16b(active_wall_x[i]);
 	}
 
 
-	/*** Simple "Run-Length-Encoding" of cave ***/
+	/*** Destructible cover ***/
 
-	/* Note that this will induce two wasted bytes */
-	count = 0;
-	prev_char = 0;
+	wr_s16b(cover_count());
 
-	/* Dump the cave */
-	for (y = 0; y < DUNGEON_HGT; y++)
+	for (i = 0; i < COVER_SLOTS; i++)
 	{
-		for (x = 0; x < DUNGEON_WID; x++)
-		{
-			/* Extract a byte */
-			tmp8u = cave_feat[y][x];
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == MAX_UCHAR))
-			{
-				if (count)
-				{
-					wr_byte((byte) count);
-					wr_byte((byte) prev_char);
-				}
-				prev_char = tmp8u;
-				count = 1;
-			}
+		cover_data *cv_ptr = cover_at_slot(i);
 
-			/* Continue the run */
-			else
-			{
-				count++;
-			}
-		}
-	}
+		if (!cv_ptr) continue;
 
-	/* Flush the data (if any) */
-	if (count)
-	{
-		wr_byte((byte) count);
-		wr_byte((byte) prev_char);
-	}
-
-
-	/*** Simple "Run-Length-Encoding" of cave sector ***/
-
-	/* Note that this will induce two wasted bytes */
-	count = 0;
-	prev_char = 0;
-
-	/* Dump the cave */
-	for (y = 0; y < DUNGEON_HGT; y++)
-	{
-		for (x = 0; x < DUNGEON_WID; x++)
-		{
-			/* Extract a byte */
-			tmp8u = cave_sector[y][x];
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == MAX_UCHAR))
-			{
-				if (count)
-				{
-					wr_byte((byte) count);
-					wr_byte((byte) prev_char);
-				}
-				prev_char = tmp8u;
-				count = 1;
-			}
-
-			/* Continue the run */
-			else
-			{
-				count++;
-			}
-		}
-	}
-
-	/* Flush the data (if any) */
-	if (count)
-	{
-		wr_byte((byte) count);
-		wr_byte((byte) prev_char);
+		wr_s16b((s16b)((cv_ptr->grid - 1) / DUNGEON_WID));
+		wr_s16b((s16b)((cv_ptr->grid - 1) % DUNGEON_WID));
+		wr_s16b(cv_ptr->durability);
+		wr_s16b(cv_ptr->max_durability);
+		wr_byte(cv_ptr->cover_type);
+		wr_byte(cv_ptr->terrain_feat);
 	}
 
 
@@ -1430,16 +1466,30 @@ static bool wr_savefile_new(void)
 	/* Dump the messages (oldest first!) */
 	for (i = tmp16u - 1; i >= 0; i--)
 	{
-		wr_string(message_str(i));
+		wr_string(message_text(i));
 		wr_byte(message_prior(i));
+		wr_s16b(message_count(i));
 	}
 
 
-	/* Dump the monster lore */
+	/* Dump the monster lore (only the races which have any) */
+	wr_u16b(0);
+
 	tmp16u = MAX_R_IDX;
 	wr_u16b(tmp16u);
-	for (i = 0; i < tmp16u; i++)
+
+	for (tmp16u = 0, i = 0; i < MAX_R_IDX; i++)
+		if (lore_touched(i)) tmp16u++;
+
+	wr_u16b(tmp16u);
+
+	for (i = 0; i < MAX_R_IDX; i++)
+	{
+		if (!lore_touched(i)) continue;
+
+		wr_u16b((u16b) i);
 		wr_lore(i);
+	}
 
 
 	/* Dump the object memory */
@@ -1590,6 +1640,81 @@ static bool wr_savefile_new(void)
 }
 
 
+/*
+ * Check a savefile just written by "wr_savefile_new()", without decoding
+ * anything but the checksums.
+ *
+ * Every byte after the four header bytes is its value xor'ed with the
+ * byte before it, so the "value" checksum is the sum of the xors of
+ * neighbouring bytes, and the "encoded" one is the sum of the bytes
+ * themselves.  The two checksums are the last eight bytes of the file,
+ * and the "encoded" one counts the "value" one.
+ */
+static bool savefile_verify(cptr name)
+{
+	FILE *fp;
+
+	byte buf[4096];
+
+	/* The last nine bytes read (the ninth pairs up with the eighth) */
+	byte tail[9];
+
+	u32b v = 0L, x = 0L;
+	u32b v_saved, x_saved;
+	u32b len = 0L;
+
+	int i, n, prev = -1;
+
+
+	fp = my_fopen(name, "rb");
+	if (!fp) return (FALSE);
+
+	while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+	{
+		for (i = 0; i < n; i++, len++)
+		{
+			byte c = buf[i];
+
+			/* Skip the header */
+			if (len >= 4)
+			{
+				v += c ^ prev;
+				x += c;
+			}
+
+			prev = c;
+
+			(void)memmove(tail, tail + 1, 8);
+			tail[8] = c;
+		}
+	}
+
+	if (ferror(fp)) len = 0L;
+
+	my_fclose(fp);
+
+	/* Too short to hold anything */
+	if (len < 4 + 8 + 1) return (FALSE);
+
+	/* Take the checksums out of the sums */
+	for (i = 1; i < 9; i++)
+	{
+		v -= tail[i] ^ tail[i - 1];
+		if (i >= 5) x -= tail[i];
+	}
+
+	/* Decode the checksums */
+	v_saved = x_saved = 0L;
+	for (i = 4; i > 0; i--)
+	{
+		v_saved = (v_saved << 8) | (byte)(tail[i] ^ tail[i - 1]);
+		x_saved = (x_saved << 8) | (byte)(tail[i + 4] ^ tail[i + 3]);
+	}
+
+	return ((v == v_saved) && (x == x_saved));
+}
+
+
 /*
  * Medium level player saver
  *
@@ -1635,6 +1760,10 @@ static bool save_player_aux(char *name)
 				ok = FALSE;
 		}
 
+		/* Make sure it reads back */
+		if (ok && !savefile_verify(name))
+			ok = FALSE;
+
 		/* Remove "broken" files */
 		if (!ok)
 			fd_kill(name);
@@ -1654,6 +1783,119 @@ static bool save_player_aux(char *name)
 
 
 
+#ifdef SAVE_BACKGROUND
+
+/*
+ * The process writing a background save, if any
+ */
+static pid_t save_child = 0;
+
+/*
+ * Only report a failure of the background save (for autosaves)
+ */
+static bool save_child_quiet = FALSE;
+
+#endif
+
+
+/*
+ * Check on a background save, waiting for it to finish if "wait" is set,
+ * and report how it went.
+ *
+ * Returns TRUE while the save is still being written.
+ */
+bool save_background_check(bool wait)
+{
+#ifdef SAVE_BACKGROUND
+
+	int status;
+	pid_t pid;
+
+	/* Nothing to check */
+	if (save_child <= 0) return (FALSE);
+
+	pid = waitpid(save_child, &status, (wait ? 0 : WNOHANG));
+
+	/* Still writing */
+	if (pid == 0) return (TRUE);
+
+	save_child = 0;
+
+	/* Success */
+	if ((pid > 0) && WIFEXITED(status) && (WEXITSTATUS(status) == 0))
+	{
+		/* The copy kept its own count */
+		sf_saves++;
+
+		/* Hack -- Pretend the character was loaded */
+		character_loaded = TRUE;
+		character_saved = TRUE;
+
+		if (!save_child_quiet) msg_print("Game saved.");
+	}
+
+	/* Failure */
+	else
+	{
+		msg_print("Background save failed!");
+	}
+
+#endif /* SAVE_BACKGROUND */
+
+	return (FALSE);
+}
+
+
+/*
+ * Attempt to save the player in the background.
+ *
+ * A forked copy of the game writes the savefile (through "save_player()",
+ * so the usual write-then-rename keeps it safe) while play goes on, and
+ * "save_background_check()" reports the result.  Machines which cannot
+ * fork save in the foreground.
+ *
+ * Returns FALSE if the save failed at once, and sets "*background" if
+ * it is still being written.  A "quiet" save only reports failure.
+ */
+bool save_player_background(bool *background, bool quiet)
+{
+#ifdef SAVE_BACKGROUND
+
+	pid_t pid;
+
+	/* One save at a time */
+	(void)save_background_check(TRUE);
+
+	/* Forget unused inscriptions here, not just in the copy */
+	quark_collect();
+
+	pid = fork();
+
+	/* The copy writes the file and leaves without any cleanup */
+	if (pid == 0)
+	{
+		_exit(save_player() ? 0 : 1);
+	}
+
+	/* Play goes on */
+	if (pid > 0)
+	{
+		save_child = pid;
+		save_child_quiet = quiet;
+		(*background) = TRUE;
+		return (TRUE);
+	}
+
+	/* No fork, save in the foreground */
+
+#endif /* SAVE_BACKGROUND */
+
+	(*background) = FALSE;
+
+	return (save_player());
+}
+
+
 /*
  * Attempt to save the player in a savefile
  */
@@ -1664,6 +1906,15 @@ bool save_player(void)
 	char safe[1024];
 
 
+	/* Let a background save finish first */
+	(void)save_background_check(TRUE);
+
+	/* The temporary dungeons go with the savefile */
+	level_cache_flush();
+
+	/* Forget unused inscriptions */
+	quark_collect();
+
 #ifdef SET_UID
 
 # ifdef SECURE
@@ -2039,21 +2290,52 @@ bool load_player(void)
 
 
 /*
- * Attempt to save a temporary dungeon.
+ * Recently left levels
  */
-bool save_dungeon(s16b tag)
+static level_cache level_caches[LEVEL_CACHE_MAX];
+
+/*
+ * Use counter, for least-recently-used replacement
+ */
+static u32b level_cache_clock = 0L;
+
+
+/*
+ * Build the name of the file of a temporary dungeon
+ */
+static void level_cache_path(char *path, s16b tag)
 {
 	char temp[128];
+
+	sprintf(temp, "%s.%d", op_ptr->base_name, tag);
+	path_build(path, 1024, ANGBAND_DIR_SAVE, temp);
+}
+
+
+/*
+ * Forget a cached level
+ */
+static void level_cache_wipe(level_cache *l_ptr)
+{
+	C_KILL(l_ptr->data, l_ptr->size, byte);
+	l_ptr->len = l_ptr->size = 0L;
+}
+
+
+/*
+ * Write the data of a file of a temporary dungeon
+ *
+ * Returns TRUE on failure.
+ */
+static bool level_cache_write(s16b tag, byte *data, u32b len)
+{
 	char path[1024];
 	int fd = -1;
 	int mode = 0644;
+	FILE *fp;
+	bool err;
 
-	/* Paranoia */
-	if (tag > 999 || tag < 0)
-		return TRUE;
-
-	sprintf(temp, "%s.%d", op_ptr->base_name, tag);
-	path_build(path, 1024, ANGBAND_DIR_SAVE, temp);
+	level_cache_path(path, tag);
 
 	/* File type is "SAVE" */
 	FILE_TYPE(FILE_TYPE_SAVE);
@@ -2072,29 +2354,173 @@ bool save_dungeon(s16b tag)
 	fd_close(fd);
 
 	/* Open the savefile */
-	fff = my_fopen(path, "wb");
+	fp = my_fopen(path, "wb");
 
 	/* Successful open */
-	if (!fff)
+	if (!fp)
 		return TRUE;
 
+	err = (fwrite(data, 1, len, fp) != len);
+
+	/* Attempt to close it */
+	if (my_fclose(fp))
+		err = TRUE;
+
+	if (err)
+		fd_kill(path);
+
+	return (err);
+}
+
+
+/*
+ * Write every cached level to its file, keeping it in memory too.
+ *
+ * The files must be there whenever the savefile is, since the player
+ * may quit (or crash) while a level is only cached.
+ */
+void level_cache_flush(void)
+{
+	int i;
+
+	for (i = 0; i < LEVEL_CACHE_MAX; i++)
+	{
+		level_cache *l_ptr = &level_caches[i];
+
+		if (!l_ptr->data) continue;
+
+		(void)level_cache_write(l_ptr->tag, l_ptr->data, l_ptr->len);
+	}
+}
+
+
+/*
+ * Take a cached level out of the cache, handing its data to the caller
+ * (who must free it with C_KILL() using "*size").
+ *
+ * Returns FALSE if the level is not cached.
+ */
+bool level_cache_take(s16b tag, byte **data, u32b *len, u32b *size)
+{
+	int i;
+
+	for (i = 0; i < LEVEL_CACHE_MAX; i++)
+	{
+		level_cache *l_ptr = &level_caches[i];
+
+		if (!l_ptr->data || (l_ptr->tag != tag)) continue;
+
+		(*data) = l_ptr->data;
+		(*len) = l_ptr->len;
+		(*size) = l_ptr->size;
+
+		l_ptr->data = NULL;
+		l_ptr->len = l_ptr->size = 0L;
+
+		return (TRUE);
+	}
+
+	return (FALSE);
+}
+
+
+/*
+ * Attempt to save a temporary dungeon.
+ *
+ * The level is encoded in memory and kept in the level cache; only the
+ * levels which no longer fit in LEVEL_CACHE_BUDGET are written to their
+ * files, least recently left first.
+ *
+ * Returns TRUE on failure.
+ */
+bool save_dungeon(s16b tag)
+{
+	char path[1024];
+	int i, slot = -1;
+	u32b total = 0L;
+	bool err = FALSE;
+
+	/* Paranoia */
+	if (tag > 999 || tag < 0)
+		return TRUE;
+
+	level_cache_path(path, tag);
+
+	/* Delete the old file. */
+	fd_kill(path);
+
+	/* Forget the old copy */
+	for (i = 0; i < LEVEL_CACHE_MAX; i++)
+	{
+		if (level_caches[i].data && (level_caches[i].tag == tag))
+			level_cache_wipe(&level_caches[i]);
+	}
+
+	/* Write the level into memory */
+	sf_mem_len = sf_mem_size = 0L;
+	sf_mem_room(1);
+
 	xor_byte = 0;
 
-	/* Write the savefile */
 	wr_dungeon();
 
-	if (ferror(fff) || (fflush(fff) == EOF))
+	/* Too big to keep */
+	if (sf_mem_len > LEVEL_CACHE_BUDGET)
 	{
-		fd_kill(path);
-		return TRUE;
+		err = level_cache_write(tag, sf_mem, sf_mem_len);
+
+		C_KILL(sf_mem, sf_mem_size, byte);
+		sf_mem_len = sf_mem_size = 0L;
+
+		return (err);
 	}
 
-	/* Attempt to close it */
-	if (my_fclose(fff))
+	/* Make room, writing out the least recently left levels */
+	while (TRUE)
 	{
-		fd_kill(path);
-		return TRUE;
+		int oldest = -1;
+
+		total = sf_mem_len;
+		slot = -1;
+
+		for (i = 0; i < LEVEL_CACHE_MAX; i++)
+		{
+			level_cache *l_ptr = &level_caches[i];
+
+			if (!l_ptr->data)
+			{
+				slot = i;
+				continue;
+			}
+
+			total += l_ptr->len;
+
+			if ((oldest < 0) || (l_ptr->used < level_caches[oldest].used))
+				oldest = i;
+		}
+
+		/* It fits */
+		if ((slot >= 0) && (total <= LEVEL_CACHE_BUDGET)) break;
+
+		/* Evict */
+		if (level_cache_write(level_caches[oldest].tag,
+			level_caches[oldest].data, level_caches[oldest].len))
+		{
+			err = TRUE;
+		}
+
+		level_cache_wipe(&level_caches[oldest]);
 	}
 
-	return FALSE;
+	/* Keep it */
+	level_caches[slot].data = sf_mem;
+	level_caches[slot].len = sf_mem_len;
+	level_caches[slot].size = sf_mem_size;
+	level_caches[slot].tag = tag;
+	level_caches[slot].used = ++level_cache_clock;
+
+	sf_mem = NULL;
+	sf_mem_len = sf_mem_size = 0L;
+
+	return (err);
 }
@@ -0,0 +1,392 @@
+/* File: soak.c */
+
+/*
+ * Soak tests (the "--soak" option)
+ *
+ * Once the game is initialized, it forks into many headless games, a
+ * few at a time (one per processor, unless "--jobs" says otherwise),
+ * each with a seed of its own ("--seed", or 1, plus its number) and its
+ * own metrics files ("soak_<n>_kamband_stats.csv" and so on), and
+ * watches over them.  Each game notes its game turn in a page shared
+ * with the parent, and a game whose turn has not moved for SOAK_HANG_MSEC
+ * is taken to be hung and killed.  What a game writes to "stderr" goes
+ * to "soak_<n>.err", which is kept if the game did not end well, so the
+ * crashes can be looked into.
+ *
+ * Each game gets one line of "kamband_soak.csv" (its number, seed, how
+ * it ended, its last game turn, and how long it ran), and the metrics
+ * histograms of all of them are added up in "kamband_soak_hist.csv"
+ * (the count, total, least and greatest of each kind of event, and the
+ * worst 99th percentile of any game).
+ */
+
+#include "angband.h"
+
+
+#ifdef SET_UID
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <signal.h>
+
+
+/*
+ * One game
+ */
+typedef struct soak_type soak_type;
+
+struct soak_type
+{
+	pid_t pid;		/* Process, or 0 */
+
+	u32b seed;		/* Seed */
+
+	u32b seen;		/* Last game turn seen */
+	u32b moved;		/* When it last moved */
+	u32b began;		/* When it started */
+
+	bool killed;		/* Killed as hung */
+};
+
+
+/*
+ * Where this game notes its turn (in a child)
+ */
+static volatile u32b *soak_beat = NULL;
+
+
+/*
+ * The added up histograms
+ */
+typedef struct soak_hist soak_hist;
+
+struct soak_hist
+{
+	char name[80];
+
+	u32b count;
+	u32b total;
+	long min;
+	long max;
+	long p99;
+};
+
+static soak_hist soak_hists[METRIC_MAX_EVENTS];
+static int soak_hist_num = 0;
+
+
+/*
+ * Add the histograms of game "n" to the total
+ */
+static void soak_add_hist(int n)
+{
+	FILE *fff;
+	char path[256];
+	char buf[1024];
+
+	strnfmt(path, sizeof(path), "soak_%d_kamband_hist.csv", n);
+
+	fff = fopen(path, "r");
+	if (!fff) return;
+
+	while (fgets(buf, sizeof(buf), fff))
+	{
+		char name[80];
+		unsigned long count, total;
+		long min, max, p50, p90, p99;
+		int i;
+
+		if (sscanf(buf, "%79[^,],%lu,%lu,%ld,%ld,%ld,%ld,%ld", name, &count,
+		           &total, &min, &max, &p50, &p90, &p99) != 8)
+		{
+			continue;
+		}
+
+		for (i = 0; i < soak_hist_num; i++)
+		{
+			if (streq(soak_hists[i].name, name)) break;
+		}
+
+		if (i == soak_hist_num)
+		{
+			if (soak_hist_num >= METRIC_MAX_EVENTS) continue;
+
+			strcpy(soak_hists[i].name, name);
+			soak_hists[i].min = min;
+			soak_hist_num++;
+		}
+
+		soak_hists[i].count += count;
+		soak_hists[i].total += total;
+		if (min < soak_hists[i].min) soak_hists[i].min = min;
+		if (max > soak_hists[i].max) soak_hists[i].max = max;
+		if (p99 > soak_hists[i].p99) soak_hists[i].p99 = p99;
+	}
+
+	fclose(fff);
+}
+
+
+/*
+ * Write out the added up histograms
+ */
+static void soak_write_hist(void)
+{
+	FILE *fff;
+	int i;
+
+	fff = fopen("kamband_soak_hist.csv", "w");
+	if (!fff) return;
+
+	fprintf(fff, "event_type,count,total,min,max,worst_p99\n");
+
+	for (i = 0; i < soak_hist_num; i++)
+	{
+		soak_hist *h_ptr = &soak_hists[i];
+
+		fprintf(fff, "%s,%lu,%lu,%ld,%ld,%ld\n", h_ptr->name,
+		        (unsigned long)h_ptr->count, (unsigned long)h_ptr->total,
+		        h_ptr->min, h_ptr->max, h_ptr->p99);
+	}
+
+	fclose(fff);
+}
+
+
+/*
+ * Become game "n" (in the child)
+ */
+static void soak_child(int n, soak_type *s_ptr, volatile u32b *beat)
+{
+	char buf[256];
+	char path[1024];
+	int fd;
+
+	soak_beat = beat;
+
+	/* Its own seed */
+	arg_seed = s_ptr->seed;
+
+	/* Its own files */
+	strnfmt(buf, sizeof(buf), "soak_%d_", n);
+	metric_prefix(buf);
+
+	strnfmt(path, sizeof(path), "%s.soak%d", savefile, n);
+	strcpy(savefile, path);
+
+	strnfmt(buf, sizeof(buf), "%ssoak%d", op_ptr->base_name, n);
+	strnfmt(op_ptr->base_name, sizeof(op_ptr->base_name), "%s", buf);
+
+	/* Keep what it says about itself */
+	strnfmt(buf, sizeof(buf), "soak_%d.err", n);
+	fd = open(buf, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd >= 0)
+	{
+		(void)dup2(fd, 2);
+		(void)close(fd);
+	}
+
+	/* But not what it says to the "screen" */
+	fd = open("/dev/null", O_WRONLY);
+	if (fd >= 0)
+	{
+		(void)dup2(fd, 1);
+		(void)close(fd);
+	}
+}
+
+
+/*
+ * Note how game "n" ended
+ */
+static void soak_done(FILE *fff, int n, soak_type *s_ptr, int status,
+                      u32b now, int *bad)
+{
+	char how[40];
+	char path[256];
+
+	if (s_ptr->killed)
+	{
+		strcpy(how, "hang");
+	}
+	else if (WIFSIGNALED(status))
+	{
+		strnfmt(how, sizeof(how), "signal %d", WTERMSIG(status));
+	}
+	else if (WIFEXITED(status) && WEXITSTATUS(status))
+	{
+		strnfmt(how, sizeof(how), "exit %d", WEXITSTATUS(status));
+	}
+	else
+	{
+		strcpy(how, "ok");
+	}
+
+	strnfmt(path, sizeof(path), "soak_%d.err", n);
+
+	/* Only keep the trouble */
+	if (streq(how, "ok")) (void)remove(path);
+	else (*bad)++;
+
+	if (fff)
+	{
+		fprintf(fff, "%d,%lu,%s,%lu,%.3f\n", n, (unsigned long)s_ptr->seed,
+		        how, (unsigned long)s_ptr->seen,
+		        (now - s_ptr->began) / 1000.0);
+		fflush(fff);
+	}
+
+	printf("soak %d (seed %lu): %s at turn %lu\n", n,
+	       (unsigned long)s_ptr->seed, how, (unsigned long)s_ptr->seen);
+	fflush(stdout);
+
+	soak_add_hist(n);
+
+	s_ptr->pid = 0;
+}
+
+
+/*
+ * Run "games" headless games, "jobs" at a time, and quit.
+ *
+ * Returns only in the games, which go on as usual.
+ */
+void soak_run(int games, int jobs)
+{
+	soak_type *soak;
+	volatile u32b *beat;
+	FILE *fff;
+	int next = 0, running = 0, bad = 0;
+	int i, status;
+	pid_t pid;
+
+	if (jobs <= 0) jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (jobs <= 0) jobs = 1;
+
+	/* A game must end */
+	if (arg_headless_turns <= 0) arg_headless_turns = SOAK_TURNS;
+
+	C_MAKE(soak, games, soak_type);
+
+	/* The turns, shared with the games */
+	beat = (volatile u32b *)mmap(NULL, games * sizeof(u32b),
+	                             PROT_READ | PROT_WRITE,
+	                             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (beat == (volatile u32b *)MAP_FAILED) quit("Unable to share memory!");
+
+	fff = fopen("kamband_soak.csv", "w");
+	if (fff) fprintf(fff, "game,seed,result,turns,seconds\n");
+
+	/* Flush before forking, or the games repeat it */
+	if (fff) fflush(fff);
+	fflush(stdout);
+
+	while ((next < games) || running)
+	{
+		u32b now = msec_clock();
+
+		/* Start games */
+		while ((next < games) && (running < jobs))
+		{
+			soak_type *s_ptr = &soak[next];
+
+			s_ptr->seed = (arg_seed ? arg_seed : 1) + next;
+			s_ptr->began = s_ptr->moved = now;
+			beat[next] = 0;
+
+			pid = fork();
+
+			/* Play */
+			if (pid == 0)
+			{
+				soak_child(next, s_ptr, &beat[next]);
+				if (fff) fclose(fff);
+				return;
+			}
+
+			if (pid < 0) quit("Unable to start a game!");
+
+			s_ptr->pid = pid;
+			next++;
+			running++;
+		}
+
+		/* Collect games */
+		while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+		{
+			for (i = 0; i < next; i++)
+			{
+				if (soak[i].pid != pid) continue;
+
+				soak[i].seen = beat[i];
+				soak_done(fff, i, &soak[i], status, now, &bad);
+				running--;
+				break;
+			}
+		}
+
+		/* Watch the games */
+		for (i = 0; i < next; i++)
+		{
+			soak_type *s_ptr = &soak[i];
+
+			if (!s_ptr->pid || s_ptr->killed) continue;
+
+			if (beat[i] != s_ptr->seen)
+			{
+				s_ptr->seen = beat[i];
+				s_ptr->moved = now;
+			}
+
+			/* Hung */
+			else if (now - s_ptr->moved >= SOAK_HANG_MSEC)
+			{
+				s_ptr->killed = TRUE;
+				(void)kill(s_ptr->pid, SIGKILL);
+			}
+		}
+
+		usleep(SOAK_POLL_MSEC * 1000);
+	}
+
+	if (fff) fclose(fff);
+
+	soak_write_hist();
+
+	printf("%d games, %d ended badly.\n", games, bad);
+
+	(void)munmap((void *)beat, games * sizeof(u32b));
+	C_KILL(soak, games, soak_type);
+
+	quit(NULL);
+}
+
+
+/*
+ * Note the game turn for the watchdog (in a game of a soak test)
+ */
+void soak_turn(void)
+{
+	if (soak_beat) *soak_beat = (u32b)turn;
+}
+
+
+#else /* SET_UID */
+
+
+void soak_run(int games, int jobs)
+{
+	/* Unused */
+	(void)games;
+	(void)jobs;
+
+	quit("Soak tests need fork().");
+}
+
+
+void soak_turn(void)
+{
+}
+
+
+#endif /* SET_UID */
@@ -65,6 +65,62 @@ s16b poly_r_idx(int r_idx)
 }
 
 
+/*
+ * Can a monster be teleported to "y,x"? (see "teleport_away()")
+ */
+static bool teleport_away_okay(int y, int x)
+{
+	/* Require "empty" floor space */
+	if (!cave_empty_bold(y, x))
+		return (FALSE);
+
+	/* Avoid hazards */
+	if (!is_safe_teleport_dest(y, x))
+		return (FALSE);
+
+	/* Hack -- no teleport onto glyph of warding */
+	if (cave_feat[y][x] == FEAT_GLYPH)
+		return (FALSE);
+
+	return (TRUE);
+}
+
+
+/*
+ * Can the player be teleported to "y,x"? (see "teleport_player()")
+ */
+static bool teleport_player_okay(int y, int x)
+{
+	/* Avoid sanctum walls explicitly */
+	if (is_sanctum_wall(y, x))
+		return (FALSE);
+
+	/* Require "naked" floor space */
+	if (!cave_naked_bold(y, x))
+		return (FALSE);
+
+	/* Avoid hazards */
+	if (!is_safe_teleport_dest(y, x))
+		return (FALSE);
+
+	/* No teleporting into vaults and such */
+	if ((p_ptr->inside_special == 0) && (cave_info[y][x] & (CAVE_ICKY)))
+		return (FALSE);
+
+	return (TRUE);
+}
+
+
+/*
+ * Can the player be teleported to "y,x", as a last resort?
+ */
+static bool teleport_player_fallback_okay(int y, int x)
+{
+	return (cave_empty_bold(y, x) && is_safe_teleport_dest(y, x) &&
+	        !is_sanctum_wall(y, x));
+}
+
+
 /*
  * Teleport a monster, normally up to "dis" grids away.
  *
@@ -121,16 +177,8 @@ void teleport_away(int m_idx, int dis)
 			if (!in_bounds_fully(ny, nx))
 				continue;
 
-			/* Require "empty" floor space */
-			if (!cave_empty_bold(ny, nx))
-				continue;
-
-			/* Avoid hazards */
-			if (!is_safe_teleport_dest(ny, nx))
-				continue;
-
-			/* Hack -- no teleport onto glyph of warding */
-			if (cave_feat[ny][nx] == FEAT_GLYPH)
+			/* Ignore unsuitable locations */
+			if (!teleport_away_okay(ny, nx))
 				continue;
 
 			/* No teleporting into vaults and such */
@@ -143,6 +191,24 @@ void teleport_away(int m_idx, int dis)
 			break;
 		}
 
+		/* Few (or no) good grids -- look at all of them */
+		if (look)
+		{
+			if (pick_floor_grid(oy, ox, min, dis, teleport_away_okay,
+			                    &ny, &nx) ||
+			    pick_floor_grid(oy, ox, 0, dis, teleport_away_okay,
+			                    &ny, &nx))
+			{
+				look = FALSE;
+			}
+
+			/* Nowhere to go */
+			else
+			{
+				return;
+			}
+		}
+
 		/* Increase the maximum distance */
 		/* dis = dis * 2; */
 
@@ -216,16 +282,8 @@ void teleport_away_to(int m_idx, int y, int x)
 			if (!in_bounds_fully(ny, nx))
 				continue;
 
-			/* Require "empty" floor space */
-			if (!cave_empty_bold(ny, nx))
-				continue;
-
-			/* Avoid hazards */
-			if (!is_safe_teleport_dest(ny, nx))
-				continue;
-
-			/* Hack -- no teleport onto glyph of warding */
-			if (cave_feat[ny][nx] == FEAT_GLYPH)
+			/* Ignore unsuitable locations */
+			if (!teleport_away_okay(ny, nx))
 				continue;
 
 			/* No teleporting into vaults and such */
@@ -238,9 +296,29 @@ void teleport_away_to(int m_idx, int y, int x)
 			break;
 		}
 
+		/* Few (or no) good grids this close -- look at all of them */
+		if (look)
+		{
+			if (pick_floor_grid(y, x, 0, (iter / 10) + 1, teleport_away_okay,
+			                    &ny, &nx))
+			{
+				look = FALSE;
+			}
+
+			/* Try further away */
+			else
+			{
+				iter += 9;
+			}
+		}
+
 		iter++;
 	}
 
+	/* Nowhere to go */
+	if (look)
+		return;
+
 	/* Sound */
 	sound(SOUND_TPOTHER);
 
@@ -296,22 +374,10 @@ void teleport_player(int dis)
 			if (!in_bounds_fully(y, x))
 				continue;
 
-            /* Avoid sanctum walls explicitly */
-            if (is_sanctum_wall(y, x)) continue;
-
-			/* Require "naked" floor space */
-			if (!cave_naked_bold(y, x))
+			/* Ignore unsuitable locations */
+			if (!teleport_player_okay(y, x))
 				continue;
 
-			/* Avoid hazards */
-			if (!is_safe_teleport_dest(y, x))
-				continue;
-
-			/* No teleporting into vaults and such */
-			if (p_ptr->inside_special == 0)
-				if (cave_info[y][x] & (CAVE_ICKY))
-					continue;
-
 			/* This grid looks good */
 			look = FALSE;
 
@@ -319,6 +385,13 @@ void teleport_player(int dis)
 			break;
 		}
 
+		/* Few (or no) good grids -- look at all of them */
+		if (look && !attempts &&
+		    pick_floor_grid(py, px, min, dis, teleport_player_okay, &y, &x))
+		{
+			look = FALSE;
+		}
+
 		/* Increase the maximum distance */
 		dis = dis * 2;
 
@@ -327,29 +400,24 @@ void teleport_player(int dis)
 
 		attempts++;
 
-		/* Fallback logic: radial search */
-		if (attempts > 10)
+		/* Fallback logic: the nearest empty grids */
+		if (look && (attempts > 10))
 		{
-			int rad, check_y, check_x;
-			for (rad = 1; rad < 200; rad++)
+			int rad;
+
+			for (rad = 1; rad < 400; rad *= 2)
 			{
-				for (i = 0; i < 500; i++)
+				if (pick_floor_grid(py, px, 0, MIN(rad, 200),
+				                    teleport_player_fallback_okay, &y, &x))
 				{
-					check_y = rand_spread(py, rad);
-					check_x = rand_spread(px, rad);
-					if (in_bounds_fully(check_y, check_x) &&
-					    cave_empty_bold(check_y, check_x) &&
-					    is_safe_teleport_dest(check_y, check_x) &&
-					    !is_sanctum_wall(check_y, check_x))
-					{
-						y = check_y;
-						x = check_x;
-						look = FALSE;
-						break;
-					}
+					look = FALSE;
+					break;
 				}
-				if (!look) break;
 			}
+
+			/* Nowhere to go */
+			if (look)
+				return;
 		}
 	}
 
@@ -809,7 +877,7 @@ void take_hit(int dam, cptr kb_str)
 
 
 	/* Disturb */
-	disturb(1, 0);
+	disturb(1, DISTURB_DAMAGE);
 
 	/* Mega-Hack -- Apply "invulnerability" */
 	if (p_ptr->invuln && (dam < 9000))
@@ -830,6 +898,10 @@ void take_hit(int dam, cptr kb_str)
 	/* Window stuff */
 	p_ptr->window |= (PW_SPELL | PW_PLAYER);
 
+	/* Benchmarks (and fuzzing) keep the player alive */
+	if ((p_ptr->chp < 0) && (bench_running() || fuzz_running()))
+		p_ptr->chp = p_ptr->mhp;
+
 	/* Dead player */
 	if (p_ptr->chp < 0)
 	{
@@ -879,7 +951,7 @@ void take_sanity_hit(int dam, cptr killer)
 	if (p_ptr->is_dead)
 		return;
 
-	disturb(1, 0);
+	disturb(1, DISTURB_DAMAGE);
 
 	p_ptr->csane -= dam;
 
@@ -918,22 +990,7 @@ void take_sanity_hit(int dam, cptr killer)
  */
 bool hates_acid(object_type * o_ptr)
 {
-	/* Analyze the type */
-	switch (o_ptr->stuff)
-	{
-		case STUFF_ETHER:
-		case STUFF_PAPER:
-		case STUFF_EARTH:
-		case STUFF_CLOTH:
-		case STUFF_LEATHER:
-		case STUFF_FLESH:
-		case STUFF_IRON:
-		case STUFF_AMBER:
-		case STUFF_SULFUR:
-			return TRUE;
-	}
-
-	return FALSE;
+	return ((materials[o_ptr->stuff].hates & HATES_ACID) ? TRUE : FALSE);
 }
 
 
@@ -942,20 +999,7 @@ bool hates_acid(object_type * o_ptr)
  */
 bool hates_elec(object_type * o_ptr)
 {
-	switch (o_ptr->stuff)
-	{
-		case STUFF_ETHER:
-		case STUFF_FLESH:
-		case STUFF_CRYSTAL:
-		case STUFF_AMBER:
-		case STUFF_SULFUR:
-		case STUFF_WOOD:
-		{
-			return (TRUE);
-		}
-	}
-
-	return (FALSE);
+	return ((materials[o_ptr->stuff].hates & HATES_ELEC) ? TRUE : FALSE);
 }
 
 
@@ -964,21 +1008,7 @@ bool hates_elec(object_type * o_ptr)
  */
 bool hates_fire(object_type * o_ptr)
 {
-	/* Analyze the type */
-	switch (o_ptr->stuff)
-	{
-		case STUFF_ETHER:
-		case STUFF_PAPER:
-		case STUFF_CLOTH:
-		case STUFF_LEATHER:
-		case STUFF_FLESH:
-		case STUFF_WOOD:
-		case STUFF_AMBER:
-		case STUFF_SULFUR:
-			return TRUE;
-	}
-
-	return (FALSE);
+	return ((materials[o_ptr->stuff].hates & HATES_FIRE) ? TRUE : FALSE);
 }
 
 
@@ -987,15 +1017,7 @@ bool hates_fire(object_type * o_ptr)
  */
 bool hates_cold(object_type * o_ptr)
 {
-	switch (o_ptr->stuff)
-	{
-		case STUFF_ETHER:
-		case STUFF_LEATHER:
-		case STUFF_FLESH:
-			return (TRUE);
-	}
-
-	return (FALSE);
+	return ((materials[o_ptr->stuff].hates & HATES_COLD) ? TRUE : FALSE);
 }
 
 /*
@@ -1003,30 +1025,7 @@ bool hates_cold(object_type * o_ptr)
  */
 bool hates_plasma(object_type * o_ptr)
 {
-	switch (o_ptr->stuff)
-	{
-		case STUFF_ETHER:
-		case STUFF_PAPER:
-		case STUFF_EARTH:
-		case STUFF_CLOTH:
-		case STUFF_LEATHER:
-		case STUFF_FLESH:
-		case STUFF_WOOD:
-		case STUFF_GLASS:
-		case STUFF_IRON:
-		case STUFF_FLINT:
-		case STUFF_GRAPHITE:
-		case STUFF_EBONY:
-		case STUFF_AMBER:
-		case STUFF_SULFUR:
-		case STUFF_COPPER:
-		case STUFF_SILVER:
-		case STUFF_GOLD:
-
-			return TRUE;
-	}
-
-	return FALSE;
+	return ((materials[o_ptr->stuff].hates & HATES_PLASMA) ? TRUE : FALSE);
 }
 
 /*
@@ -1034,26 +1033,7 @@ bool hates_plasma(object_type * o_ptr)
  */
 bool hates_meteor(object_type * o_ptr)
 {
-	switch (o_ptr->stuff)
-	{
-		case STUFF_ETHER:
-		case STUFF_PAPER:
-		case STUFF_EARTH:
-		case STUFF_CLOTH:
-		case STUFF_LEATHER:
-		case STUFF_FLESH:
-		case STUFF_WOOD:
-		case STUFF_GLASS:
-		case STUFF_GRAPHITE:
-		case STUFF_EBONY:
-		case STUFF_AMBER:
-		case STUFF_SULFUR:
-		case STUFF_COPPER:
-
-			return TRUE;
-	}
-
-	return FALSE;
+	return ((materials[o_ptr->stuff].hates & HATES_METEOR) ? TRUE : FALSE);
 }
 
 /*
@@ -1061,24 +1041,7 @@ bool hates_meteor(object_type * o_ptr)
  */
 bool hates_shards(object_type * o_ptr)
 {
-	switch (o_ptr->stuff)
-	{
-		case STUFF_ETHER:
-		case STUFF_PAPER:
-		case STUFF_EARTH:
-		case STUFF_CLOTH:
-		case STUFF_LEATHER:
-		case STUFF_FLESH:
-		case STUFF_WOOD:
-		case STUFF_GLASS:
-		case STUFF_GRAPHITE:
-		case STUFF_AMBER:
-		case STUFF_SULFUR:
-
-			return TRUE;
-	}
-
-	return FALSE;
+	return ((materials[o_ptr->stuff].hates & HATES_SHARDS) ? TRUE : FALSE);
 }
 
 /*
@@ -1086,26 +1049,7 @@ bool hates_shards(object_type * o_ptr)
  */
 bool hates_sound(object_type * o_ptr)
 {
-	switch (o_ptr->stuff)
-	{
-		case STUFF_ETHER:
-		case STUFF_EARTH:
-		case STUFF_GLASS:
-		case STUFF_CRYSTAL:
-		case STUFF_GRAPHITE:
-		case STUFF_AMBER:
-		case STUFF_SULFUR:
-		case STUFF_RUBY:
-		case STUFF_SAPPHIRE:
-		case STUFF_EMERALD:
-		case STUFF_OPAL:
-		case STUFF_GARNET:
-		case STUFF_QUARTZ:
-
-			return TRUE;
-	}
-
-	return FALSE;
+	return ((materials[o_ptr->stuff].hates & HATES_SOUND) ? TRUE : FALSE);
 }
 
 /*
@@ -1113,21 +1057,7 @@ bool hates_sound(object_type * o_ptr)
  */
 bool hates_impact(object_type * o_ptr)
 {
-	switch (o_ptr->stuff)
-	{
-		case STUFF_ETHER:
-		case STUFF_PAPER:
-		case STUFF_EARTH:
-		case STUFF_WOOD:
-		case STUFF_GLASS:
-		case STUFF_CRYSTAL:
-		case STUFF_SULFUR:
-		case STUFF_AMBER:
-
-			return TRUE;
-	}
-
-	return FALSE;
+	return ((materials[o_ptr->stuff].hates & HATES_IMPACT) ? TRUE : FALSE);
 }
 
 
@@ -1136,6 +1066,24 @@ bool hates_impact(object_type * o_ptr)
  */
 typedef bool(*inven_func) (object_type *);
 
+/*
+ * Is the object kept from harm (it is worn, and "protect_equipment" is on)?
+ */
+static bool inven_damage_protected(object_type *o_ptr)
+{
+	int i;
+
+	if (!protect_equipment) return (FALSE);
+
+	for (i = 0; i < EQUIP_MAX; i++)
+	{
+		if (equipment[i] == o_ptr) return (TRUE);
+	}
+
+	return (FALSE);
+}
+
+
 /*
  * Loops through the whole inventory, and damages those items that
  * match the given funciton.
@@ -1145,45 +1093,51 @@ void inven_damage(inven_func typ, int dam, cptr verb)
 	object_type *o_ptr = inventory;
 	object_type *o_nxt;
 
+	/* Nothing to do */
+	if (dam <= 0) return;
+
 	/* Scan through the slots. */
 	while (o_ptr != NULL)
 	{
-
 		/* Pre-load next object. */
 		o_nxt = o_ptr->next;
 
-		/* Skip non-objects */
-		if (!o_ptr->k_idx)
+		/* Give this item slot a shot at death */
+		if (o_ptr->k_idx && (*typ) (o_ptr) && !inven_damage_protected(o_ptr))
 		{
-			o_ptr = o_nxt;
-			continue;
+			/* Damage it. */
+			object_take_hit(o_ptr, dam, verb);
 		}
 
-		/* Give this item slot a shot at death */
-		if ((*typ) (o_ptr))
-		{
+		o_ptr = o_nxt;
+	}
+}
 
-			if (protect_equipment)
-			{
-				bool skip = FALSE;
-				int i;
 
-				for (i = 0; i < EQUIP_MAX; i++)
-				{
-					if (equipment[i] == o_ptr)
-						skip = TRUE;
-				}
+/*
+ * As "inven_damage()", for the elements "hates" (HATES_*): the items
+ * hit are those of a material one of them damages (see "materials[]").
+ */
+void inven_damage_hates(u16b hates, int dam, cptr verb)
+{
+	object_type *o_ptr = inventory;
+	object_type *o_nxt;
 
-				if (skip)
-				{
-					o_ptr = o_nxt;
-					continue;
-				}
-			}
+	/* Nothing to do */
+	if (dam <= 0) return;
 
+	/* Scan through the slots. */
+	while (o_ptr != NULL)
+	{
+		/* Pre-load next object. */
+		o_nxt = o_ptr->next;
+
+		/* Made of something it damages */
+		if (o_ptr->k_idx && (materials[o_ptr->stuff].hates & hates) &&
+			!inven_damage_protected(o_ptr))
+		{
 			/* Damage it. */
 			object_take_hit(o_ptr, dam, verb);
-
 		}
 
 		o_ptr = o_nxt;
@@ -1215,7 +1169,7 @@ void acid_dam(int dam, cptr kb_str)
 	take_hit(dam, kb_str);
 
 	/* Inventory damage */
-	inven_damage(hates_acid, dam, "melted");
+	inven_damage_hates(HATES_ACID, dam, "melted");
 }
 
 
@@ -1238,7 +1192,7 @@ void elec_dam(int dam, cptr kb_str)
 	take_hit(dam, kb_str);
 
 	/* Inventory damage */
-	inven_damage(hates_elec, dam, NULL);
+	inven_damage_hates(HATES_ELEC, dam, NULL);
 }
 
 
@@ -1263,7 +1217,7 @@ void fire_dam(int dam, cptr kb_str)
 	take_hit(dam, kb_str);
 
 	/* Inventory damage */
-	inven_damage(hates_fire, dam, "burned");
+	inven_damage_hates(HATES_FIRE, dam, "burned");
 }
 
 
@@ -1286,7 +1240,7 @@ void cold_dam(int dam, cptr kb_str)
 	take_hit(dam, kb_str);
 
 	/* Inventory damage */
-	inven_damage(hates_cold, dam, NULL);
+	inven_damage_hates(HATES_COLD, dam, NULL);
 }
 
 
@@ -2030,6 +1984,115 @@ static int project_m_x;
 static int project_m_y;
 
 
+/*
+ * A grid affected by the project_aux_foo fns.
+ * x, y are points on the map, r is the ``radius'' -- i.e. power
+ */
+typedef struct proj_grid_type proj_grid_type;
+
+struct proj_grid_type
+{
+	s16b y, x;
+	s16b dam;
+	byte r;
+
+	byte typ;	/* Type (see "project_finalize()") */
+};
+
+/*
+ * The list of grids affected by the project_aux_foo fns.
+ *
+ * It starts with PROJECT_GRIDS_MIN grids, and doubles when it must, up
+ * to enough grids to cover the whole level. If there are nested
+ * ``project'' calls, the list of grids will be shared between them.
+ */
+static proj_grid_type *proj_grids = NULL;
+static int proj_grids_size = 0;
+
+static int max_project_grid = 0;
+
+/*
+ * The grids already in the list for this ``project'' call are the ones
+ * marked with the current "stamp" (which is never zero).
+ */
+static byte *proj_seen = NULL;
+static byte proj_stamp = 0;
+
+
+static int project_grids_begin(void);
+static bool project_grid(int y, int x, int r, int dam);
+static bool project_finalize(int start, int who, int dam, int typ_inp,
+	u32b flg);
+
+
+/*
+ * Spread "typ" from the grid (y, x) through the connected grids of
+ * "feat1" or "feat2" (ice, or water), one less damage for each step.
+ *
+ * The grids are found breadth first, using the list of projected grids
+ * as the queue, and marked with "CAVE_TEMP" so that they are only taken
+ * once (and so that hitting them does not start another spread), and
+ * then all affected at once, as a nested "project()" would.
+ *
+ * Returns TRUE if the effect was "obvious".
+ */
+static bool project_spread(int y, int x, int dam, int typ, int feat1,
+	int feat2)
+{
+	int start, stop;
+	int i, d;
+	bool obvious;
+
+	if (dam <= 0) return (FALSE);
+
+	start = project_grids_begin();
+
+	/* Take the first grid */
+	if (!project_grid(y, x, 0, dam)) return (FALSE);
+	cave_info[y][x] |= (CAVE_TEMP);
+
+	/* Take each grid's neighbours, in turn */
+	for (i = start; i < max_project_grid; i++)
+	{
+		int cy = proj_grids[i].y;
+		int cx = proj_grids[i].x;
+		int cdam = proj_grids[i].dam - 1;
+
+		/* Spent */
+		if (cdam <= 0) continue;
+
+		for (d = 0; d < 8; d++)
+		{
+			int ny = cy + ddy_ddd[d];
+			int nx = cx + ddx_ddd[d];
+
+			if (!in_bounds(ny, nx)) continue;
+			if ((cave_feat[ny][nx] != feat1) && (cave_feat[ny][nx] != feat2))
+				continue;
+			if (cave_info[ny][nx] & (CAVE_TEMP)) continue;
+
+			/* No more room */
+			if (!project_grid(ny, nx, 0, cdam)) break;
+
+			cave_info[ny][nx] |= (CAVE_TEMP);
+		}
+	}
+
+	/* Affect them all (this forgets the grids, but does not erase them) */
+	stop = max_project_grid;
+	obvious = project_finalize(start, -1, dam, typ,
+		PROJECT_KILL | PROJECT_ITEM | PROJECT_GRID);
+
+	/* Forget the marks */
+	for (i = start; i < stop; i++)
+	{
+		cave_info[proj_grids[i].y][proj_grids[i].x] &= ~(CAVE_TEMP);
+	}
+
+	return (obvious);
+}
+
+
 /*
  * We are called from "project()" to "damage" terrain features
  *
@@ -2046,88 +2109,6 @@ static int project_m_y;
  *
  * Perhaps we should affect doors and/or walls. XXX XXX
  */
-static void project_ice_spread(int y, int x, int dam, int typ) {
-    if (dam <= 0) return;
-    if (!in_bounds(y, x)) return;
-    if (cave_feat[y][x] != FEAT_ICE && cave_feat[y][x] != FEAT_WALL_ICE) return;
-    /* Use CAVE_TEMP to avoid loops */
-    if (cave_info[y][x] & CAVE_TEMP) return;
-
-    cave_info[y][x] |= CAVE_TEMP;
-
-    /* Hit grid */
-    project(-1, 0, y, x, dam, typ, PROJECT_KILL | PROJECT_ITEM | PROJECT_GRID);
-
-    /* Recurse */
-    project_ice_spread(y+1, x, dam-1, typ);
-    project_ice_spread(y-1, x, dam-1, typ);
-    project_ice_spread(y, x+1, dam-1, typ);
-    project_ice_spread(y, x-1, dam-1, typ);
-    project_ice_spread(y+1, x+1, dam-1, typ);
-    project_ice_spread(y-1, x-1, dam-1, typ);
-    project_ice_spread(y+1, x-1, dam-1, typ);
-    project_ice_spread(y-1, x+1, dam-1, typ);
-}
-
-static void project_ice_clear(int y, int x) {
-    if (!in_bounds(y, x)) return;
-    if (cave_feat[y][x] != FEAT_ICE && cave_feat[y][x] != FEAT_WALL_ICE) return;
-    if (!(cave_info[y][x] & CAVE_TEMP)) return;
-
-    cave_info[y][x] &= ~(CAVE_TEMP);
-
-    /* Recurse */
-    project_ice_clear(y+1, x);
-    project_ice_clear(y-1, x);
-    project_ice_clear(y, x+1);
-    project_ice_clear(y, x-1);
-    project_ice_clear(y+1, x+1);
-    project_ice_clear(y-1, x-1);
-    project_ice_clear(y+1, x-1);
-    project_ice_clear(y-1, x+1);
-}
-
-static void project_water_spread(int y, int x, int dam, int typ) {
-    if (dam <= 0) return;
-    if (!in_bounds(y, x)) return;
-    if (cave_feat[y][x] != FEAT_SHAL_WATER && cave_feat[y][x] != FEAT_DEEP_WATER) return;
-    /* Use CAVE_TEMP to avoid loops */
-    if (cave_info[y][x] & CAVE_TEMP) return;
-
-    cave_info[y][x] |= CAVE_TEMP;
-
-    /* Hit grid */
-    project(-1, 0, y, x, dam, typ, PROJECT_KILL | PROJECT_ITEM | PROJECT_GRID);
-
-    /* Recurse */
-    project_water_spread(y+1, x, dam-1, typ);
-    project_water_spread(y-1, x, dam-1, typ);
-    project_water_spread(y, x+1, dam-1, typ);
-    project_water_spread(y, x-1, dam-1, typ);
-    project_water_spread(y+1, x+1, dam-1, typ);
-    project_water_spread(y-1, x-1, dam-1, typ);
-    project_water_spread(y+1, x-1, dam-1, typ);
-    project_water_spread(y-1, x+1, dam-1, typ);
-}
-
-static void project_water_clear(int y, int x) {
-    if (!in_bounds(y, x)) return;
-    if (cave_feat[y][x] != FEAT_SHAL_WATER && cave_feat[y][x] != FEAT_DEEP_WATER) return;
-    if (!(cave_info[y][x] & CAVE_TEMP)) return;
-
-    cave_info[y][x] &= ~(CAVE_TEMP);
-
-    /* Recurse */
-    project_water_clear(y+1, x);
-    project_water_clear(y-1, x);
-    project_water_clear(y, x+1);
-    project_water_clear(y, x-1);
-    project_water_clear(y+1, x+1);
-    project_water_clear(y-1, x-1);
-    project_water_clear(y+1, x-1);
-    project_water_clear(y-1, x+1);
-}
-
 static bool project_f(int who, int r, int y, int x, int dam, int typ)
 {
 	bool obvious = FALSE;
@@ -2142,15 +2123,21 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ)
 	{
 		case GF_PSIONIC_SPARK:
 		{
-			if ((cave_feat[y][x] == FEAT_ICE || cave_feat[y][x] == FEAT_WALL_ICE) && !(cave_info[y][x] & CAVE_TEMP)) {
-				/* Start propagation */
-				project_ice_spread(y, x, dam, typ);
-				project_ice_clear(y, x);
-			}
-			if ((cave_feat[y][x] == FEAT_SHAL_WATER || cave_feat[y][x] == FEAT_DEEP_WATER) && !(cave_info[y][x] & CAVE_TEMP)) {
-				/* Start propagation */
-				project_water_spread(y, x, dam, typ);
-				project_water_clear(y, x);
+			/* Start propagation (unless this grid is part of one) */
+			if (!(cave_info[y][x] & (CAVE_TEMP)))
+			{
+				if ((cave_feat[y][x] == FEAT_ICE) || (cave_feat[y][x] == FEAT_WALL_ICE))
+				{
+					if (project_spread(y, x, dam, typ, FEAT_ICE, FEAT_WALL_ICE))
+						obvious = TRUE;
+				}
+				else if ((cave_feat[y][x] == FEAT_SHAL_WATER) ||
+				         (cave_feat[y][x] == FEAT_DEEP_WATER))
+				{
+					if (project_spread(y, x, dam, typ, FEAT_SHAL_WATER,
+					                   FEAT_DEEP_WATER))
+						obvious = TRUE;
+				}
 			}
 
 			/* Melt ice, burn oil */
@@ -2240,15 +2227,21 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ)
 				cave_info[y][x] |= CAVE_TEMP;
 				obvious = TRUE;
 			}
-			if ((cave_feat[y][x] == FEAT_ICE || cave_feat[y][x] == FEAT_WALL_ICE) && !(cave_info[y][x] & CAVE_TEMP)) {
-				/* Start propagation */
-				project_ice_spread(y, x, dam, typ);
-				project_ice_clear(y, x);
-			}
-			if ((cave_feat[y][x] == FEAT_SHAL_WATER || cave_feat[y][x] == FEAT_DEEP_WATER) && !(cave_info[y][x] & CAVE_TEMP)) {
-				/* Start propagation */
-				project_water_spread(y, x, dam, typ);
-				project_water_clear(y, x);
+			/* Start propagation (unless this grid is part of one) */
+			if (!(cave_info[y][x] & (CAVE_TEMP)))
+			{
+				if ((cave_feat[y][x] == FEAT_ICE) || (cave_feat[y][x] == FEAT_WALL_ICE))
+				{
+					if (project_spread(y, x, dam, typ, FEAT_ICE, FEAT_WALL_ICE))
+						obvious = TRUE;
+				}
+				else if ((cave_feat[y][x] == FEAT_SHAL_WATER) ||
+				         (cave_feat[y][x] == FEAT_DEEP_WATER))
+				{
+					if (project_spread(y, x, dam, typ, FEAT_SHAL_WATER,
+					                   FEAT_DEEP_WATER))
+						obvious = TRUE;
+				}
 			}
 			break;
 		}
@@ -3834,6 +3827,84 @@ case GF_TELEKINESIS:
 /* Hack to allow deflected projectiles to be attributed to the original attacker */
 static int forced_projectile_source_idx = 0;
 
+/*
+ * How the simple kinds of damage affect monsters and the player
+ */
+typedef struct gf_info_type gf_info_type;
+
+struct gf_info_type
+{
+	byte typ;		/* Damage type (GF_*) */
+
+	bool m_simple;		/* Monsters are affected as below */
+	u32b m_res;		/* Monster resists (RF3_*) */
+	byte m_res_div;		/* Damage divisor of the resistance */
+	cptr m_res_note;	/* Message of the resistance */
+	u32b m_hurt;		/* Monster is hurt (RF3_*) */
+	byte m_hurt_mul;	/* Damage multiplier of the vulnerability */
+	cptr m_hurt_note;	/* Message of the vulnerability */
+
+	cptr p_fuzzy;		/* Message to a blind player */
+	void (*p_hook)(int dam, cptr kb_str);	/* Hurts the player, if simple */
+	byte p_div;		/* Damage divisor for the player */
+};
+
+
+/*
+ * The simple kinds of damage (the others are handled by "project_m()"
+ * and "project_p()" one by one)
+ */
+static gf_info_type gf_info[] =
+{
+	{ GF_MISSILE, TRUE, 0L, 0, NULL, 0L, 0, NULL,
+	  "You are hit by something!", take_hit, 1 },
+	{ GF_ARROW, TRUE, 0L, 0, NULL, 0L, 0, NULL,
+	  "You are hit by something sharp!", take_hit, 1 },
+	{ GF_ACID, TRUE, RF3_IM_ACID, 9, " resists a lot.", 0L, 0, NULL,
+	  "You are hit by acid!", acid_dam, 1 },
+	{ GF_ELEC, TRUE, RF3_IM_ELEC, 9, " resists a lot.", 0L, 0, NULL,
+	  "You are hit by lightning!", elec_dam, 1 },
+	{ GF_FIRE, FALSE, 0L, 0, NULL, 0L, 0, NULL,
+	  "You are hit by fire!", fire_dam, 1 },
+	{ GF_COLD, TRUE, RF3_IM_COLD, 9, " resists a lot.", RF3_HURT_COLD, 2, " is hit hard!",
+	  "You are hit by cold!", cold_dam, 1 },
+	{ GF_POIS, TRUE, RF3_IM_POIS, 9, " resists a lot.", 0L, 0, NULL,
+	  NULL, NULL, 0 },
+	{ GF_HOLY_ORB, TRUE, 0L, 0, NULL, RF3_EVIL, 2, " is hit hard.",
+	  "You are hit by something!", take_hit, 2 },
+	{ GF_PROT_EVIL, TRUE, 0L, 0, NULL, RF3_EVIL, 2, " is hit hard.",
+	  NULL, NULL, 0 },
+	{ 0, FALSE, 0L, 0, NULL, 0L, 0, NULL, NULL, NULL, 0 }
+};
+
+/*
+ * Each damage type's entry in "gf_info[]", plus one, or zero
+ */
+static byte gf_info_idx[256];
+
+
+/*
+ * Index the simple kinds of damage (at startup)
+ */
+void init_gf_info(void)
+{
+	int i;
+
+	for (i = 0; gf_info[i].typ; i++) gf_info_idx[gf_info[i].typ] = i + 1;
+}
+
+
+/*
+ * The entry in "gf_info[]" of "typ", or NULL
+ */
+static gf_info_type *gf_info_of(int typ)
+{
+	int i = gf_info_idx[typ & 0xFF];
+
+	return (i ? &gf_info[i - 1] : NULL);
+}
+
+
 /*
  * Helper function for "project()" below.
  *
@@ -3891,6 +3962,8 @@ static bool project_m(int who, int r, int y, int x, int dam, int typ)
 {
 	int tmp;
 
+	gf_info_type *gf_ptr = gf_info_of(typ);
+
 	if (forced_projectile_source_idx) who = forced_projectile_source_idx;
 
 	monster_type *m_ptr;
@@ -4013,57 +4086,43 @@ static bool project_m(int who, int r, int y, int x, int dam, int typ)
 
 
 
-	/* Analyze the damage type */
-	switch (typ)
+	/* Simple damage */
+	if (gf_ptr && gf_ptr->m_simple)
 	{
+		if (seen)
+			obvious = TRUE;
 
-	case GF_NOTHING:
-	  {
-	    dam = 0;
-
-	    if (seen)
-	      obvious = TRUE;
-	    break;
-	  }
-	    
-			/* Magic Missile -- pure damage */
-		case GF_MISSILE:
+		/* Resistance */
+		if (r_ptr->flags3 & gf_ptr->m_res)
 		{
+			note = gf_ptr->m_res_note;
+			dam /= gf_ptr->m_res_div;
 			if (seen)
-				obvious = TRUE;
-			break;
+				r_ptr->r_flags3 |= gf_ptr->m_res;
 		}
 
-			/* Acid */
-		case GF_ACID:
+		/* Vulnerability */
+		if (r_ptr->flags3 & gf_ptr->m_hurt)
 		{
+			note = gf_ptr->m_hurt_note;
+			dam *= gf_ptr->m_hurt_mul;
 			if (seen)
-				obvious = TRUE;
-			if (r_ptr->flags3 & (RF3_IM_ACID))
-			{
-				note = " resists a lot.";
-				dam /= 9;
-				if (seen)
-					r_ptr->r_flags3 |= (RF3_IM_ACID);
-			}
-			break;
+				r_ptr->r_flags3 |= gf_ptr->m_hurt;
 		}
+	}
 
+	/* Analyze the damage type */
+	else switch (typ)
+	{
 
-			/* Electricity */
-		case GF_ELEC:
-		{
-			if (seen)
-				obvious = TRUE;
-			if (r_ptr->flags3 & (RF3_IM_ELEC))
-			{
-				note = " resists a lot.";
-				dam /= 9;
-				if (seen)
-					r_ptr->r_flags3 |= (RF3_IM_ELEC);
-			}
-			break;
-		}
+	case GF_NOTHING:
+	  {
+	    dam = 0;
+
+	    if (seen)
+	      obvious = TRUE;
+	    break;
+	  }
 
 			/* Fire damage */
 		case GF_FIRE:
@@ -4116,68 +4175,6 @@ static bool project_m(int who, int r, int y, int x, int dam, int typ)
 			break;
 		}
 
-			/* Cold */
-		case GF_COLD:
-		{
-			if (seen)
-				obvious = TRUE;
-			if (r_ptr->flags3 & (RF3_IM_COLD))
-			{
-				note = " resists a lot.";
-				dam /= 9;
-				if (seen)
-					r_ptr->r_flags3 |= (RF3_IM_COLD);
-			}
-
-			if (r_ptr->flags3 & RF3_HURT_COLD)
-			{
-				note = " is hit hard!";
-				dam *= 2;
-				if (seen)
-					r_ptr->r_flags3 |= RF3_HURT_COLD;
-			}
-			break;
-		}
-
-			/* Poison */
-		case GF_POIS:
-		{
-			if (seen)
-				obvious = TRUE;
-			if (r_ptr->flags3 & (RF3_IM_POIS))
-			{
-				note = " resists a lot.";
-				dam /= 9;
-				if (seen)
-					r_ptr->r_flags3 |= (RF3_IM_POIS);
-			}
-			break;
-		}
-
-			/* Holy Orb -- hurts Evil */
-		case GF_HOLY_ORB:
-		case GF_PROT_EVIL:
-		{
-			if (seen)
-				obvious = TRUE;
-			if (r_ptr->flags3 & (RF3_EVIL))
-			{
-				dam *= 2;
-				note = " is hit hard.";
-				if (seen)
-					r_ptr->r_flags3 |= (RF3_EVIL);
-			}
-			break;
-		}
-
-			/* Arrow -- XXX no defense */
-		case GF_ARROW:
-		{
-			if (seen)
-				obvious = TRUE;
-			break;
-		}
-
 			/* Plasma -- XXX perhaps check ELEC or FIRE */
 		case GF_PLASMA:
 		{
@@ -5898,6 +5895,8 @@ static bool project_p(int who, int r, int y, int x, int dam, int typ)
 {
 	int k = 0;
 
+	gf_info_type *gf_ptr = gf_info_of(typ);
+
 	/* Hack -- assume obvious */
 	bool obvious = TRUE;
 
@@ -6047,8 +6046,17 @@ static bool project_p(int who, int r, int y, int x, int dam, int typ)
 	}
 
 
+	/* Simple damage */
+	if (gf_ptr && gf_ptr->p_hook)
+	{
+		if (fuzzy)
+			msg_print(gf_ptr->p_fuzzy);
+		dam /= gf_ptr->p_div;
+		(*gf_ptr->p_hook)(dam, killer);
+	}
+
 	/* Analyze the damage */
-	switch (typ)
+	else switch (typ)
 	{
 
 	case GF_NOTHING:
@@ -6060,43 +6068,6 @@ static bool project_p(int who, int r, int y, int x, int dam, int typ)
 	  }
 
 
-			/* Standard damage -- hurts inventory too */
-		case GF_ACID:
-		{
-			if (fuzzy)
-				msg_print("You are hit by acid!");
-			acid_dam(dam, killer);
-			break;
-		}
-
-			/* Standard damage -- hurts inventory too */
-		case GF_FIRE:
-		{
-			if (fuzzy)
-				msg_print("You are hit by fire!");
-			fire_dam(dam, killer);
-
-			break;
-		}
-
-			/* Standard damage -- hurts inventory too */
-		case GF_COLD:
-		{
-			if (fuzzy)
-				msg_print("You are hit by cold!");
-			cold_dam(dam, killer);
-			break;
-		}
-
-			/* Standard damage -- hurts inventory too */
-		case GF_ELEC:
-		{
-			if (fuzzy)
-				msg_print("You are hit by lightning!");
-			elec_dam(dam, killer);
-			break;
-		}
-
 			/* Standard damage -- also poisons player */
 		case GF_POIS:
 		{
@@ -6114,34 +6085,6 @@ static bool project_p(int who, int r, int y, int x, int dam, int typ)
 			break;
 		}
 
-			/* Standard damage */
-		case GF_MISSILE:
-		{
-			if (fuzzy)
-				msg_print("You are hit by something!");
-			take_hit(dam, killer);
-			break;
-		}
-
-			/* Holy Orb -- Player only takes partial damage */
-		case GF_HOLY_ORB:
-		{
-			if (fuzzy)
-				msg_print("You are hit by something!");
-			dam /= 2;
-			take_hit(dam, killer);
-			break;
-		}
-
-			/* Arrow -- XXX no dodging */
-		case GF_ARROW:
-		{
-			if (fuzzy)
-				msg_print("You are hit by something sharp!");
-			take_hit(dam, killer);
-			break;
-		}
-
 			/* Plasma -- XXX No resist */
 		case GF_PLASMA:
 		{
@@ -6678,14 +6621,14 @@ static bool project_p(int who, int r, int y, int x, int dam, int typ)
                 break;
             }
 
-			if (p_ptr->word_recall == 0)
+			if (!event_when(EVENT_RECALL))
 			{
-				p_ptr->word_recall = dam;
+				(void)event_post(EVENT_RECALL, event_ticks(dam), 0);
 				mprint(MSG_BONUS, "The air about you becomes charged...");
 			}
 			else
 			{
-				p_ptr->word_recall = 0;
+				event_cancel(EVENT_RECALL);
 				msg_print("A tension leaves the air around you...");
 			}
 			break;
@@ -7669,7 +7612,7 @@ static bool project_p(int who, int r, int y, int x, int dam, int typ)
 
 
 	/* Disturb */
-	disturb(1, 0);
+	disturb(1, DISTURB_DAMAGE);
 
 
 	/* Return "Anything seen?" */
@@ -7707,70 +7650,143 @@ static char bolt_char(int y, int x, int ny, int nx)
 
 
 /*
- * The list of grids affected by the project_aux_foo fns.
- * x, y are points on the map, r is the ``radius'' -- i.e. power
- *
- * There are just enough grids to cover the whole level. If there are
- * nested ``project'' calls, the array of grids will be shared between them.
+ * Start gathering the grids of a new ``project'' call, returning where
+ * they will start in the list.
  */
-static s16b cave_proj_x[MAX_PROJECT_GRIDS];
-static s16b cave_proj_y[MAX_PROJECT_GRIDS];
-static byte cave_proj_r[MAX_PROJECT_GRIDS];
-static s16b cave_proj_dam[MAX_PROJECT_GRIDS];
+static int project_grids_begin(void)
+{
+	/* Make the marks */
+	if (!proj_seen)
+	{
+		int tag = VIRT_TAG(MEM_SCRATCH);
+
+		C_MAKE(proj_seen, MAX_PROJECT_GRIDS, byte);
+
+		(void)VIRT_TAG(tag);
+	}
+
+	/* A new stamp (forget the old marks when they run out) */
+	if (++proj_stamp == 0)
+	{
+		C_WIPE(proj_seen, MAX_PROJECT_GRIDS, byte);
+		proj_stamp = 1;
+	}
 
-static s16b max_project_grid = 0;
+	return (max_project_grid);
+}
 
 
-/* 
- * Add a new grid to the array.
+/*
+ * Make room for one more grid in the list.
  */
-static bool project_grid(int y, int x, int r, int dam)
+static bool project_grids_grow(void)
 {
-	if (max_project_grid < MAX_PROJECT_GRIDS)
-	{
-		cave_proj_y[max_project_grid] = y;
-		cave_proj_x[max_project_grid] = x;
-		cave_proj_r[max_project_grid] = r;
-		cave_proj_dam[max_project_grid] = dam;
-		max_project_grid++;
-		return TRUE;
+	proj_grid_type *old = proj_grids;
+	int size = proj_grids_size ? 2 * proj_grids_size : PROJECT_GRIDS_MIN;
+	int tag;
 
-	}
-	else
+	/* Already covers the whole level */
+	if (proj_grids_size >= MAX_PROJECT_GRIDS) return (FALSE);
+
+	if (size > MAX_PROJECT_GRIDS) size = MAX_PROJECT_GRIDS;
+
+	tag = VIRT_TAG(MEM_SCRATCH);
+
+	C_MAKE(proj_grids, size, proj_grid_type);
+
+	(void)VIRT_TAG(tag);
+
+	/* Keep the grids of any outer ``project'' calls */
+	if (old)
 	{
-		return FALSE;
+		C_COPY(proj_grids, old, max_project_grid, proj_grid_type);
+		C_FREE(old, proj_grids_size, proj_grid_type);
 	}
+
+	proj_grids_size = size;
+
+	return (TRUE);
 }
 
 
 /*
- * Draw some visual effects for spells.
+ * Add a new grid to the array (unless it is there already).
  */
+static bool project_grid(int y, int x, int r, int dam)
+{
+	proj_grid_type *g_ptr;
+	byte *seen = &proj_seen[y * DUNGEON_WID + x];
 
-static void draw_spell_effects(int y, int x, int y2, int x2, int typ,
-	int rad)
+	/* Only once */
+	if (*seen == proj_stamp) return (TRUE);
+
+	if ((max_project_grid >= proj_grids_size) && !project_grids_grow())
+		return (FALSE);
+
+	*seen = proj_stamp;
+
+	g_ptr = &proj_grids[max_project_grid++];
+	g_ptr->y = y;
+	g_ptr->x = x;
+	g_ptr->r = r;
+	g_ptr->dam = dam;
+
+	return (TRUE);
+}
+
+
+/*
+ * Draw the visual effect of a spell on one grid, without showing it yet.
+ *
+ * Returns TRUE if anything was drawn.
+ */
+static bool draw_spell_grid(int y, int x, int y2, int x2, int typ)
 {
 	if (!p_ptr->blind && player_has_los_bold(y, x))
 	{
-
 		/* Draw */
 		print_rel(bolt_char(y, x, y2, x2), spell_color(typ), y, x);
-		Term_fresh();
-		Term_xtra(TERM_XTRA_DELAY,
-			op_ptr->delay_factor * op_ptr->delay_factor / (rad + 1));
+		return (TRUE);
 	}
+
+	return (FALSE);
+}
+
+
+/*
+ * Show what has been drawn, for a while.
+ */
+static void draw_spell_flush(int rad)
+{
+	Term_fresh();
+	Term_xtra(TERM_XTRA_DELAY,
+		op_ptr->delay_factor * op_ptr->delay_factor / (rad + 1));
+}
+
+
+/*
+ * Draw some visual effects for spells.
+ */
+
+static void draw_spell_effects(int y, int x, int y2, int x2, int typ,
+	int rad)
+{
+	if (draw_spell_grid(y, x, y2, x2, typ)) draw_spell_flush(rad);
 }
 
 /*
  * Affect all the projected grids.
  * Returns TRUE is any grid was affected.
+ *
+ * The damage and type of each grid are settled first, and then the
+ * features of all the grids are affected, then the objects, then the
+ * monsters, and then the player.
  */
-static bool project_finalize(s16b start, int who, int dam, int typ_inp,
+static bool project_finalize(int start, int who, int dam, int typ_inp,
 	u32b flg)
 {
-	int i;
-	int r, x, y, typ = typ_inp;
-	int current_dam = dam;
+	int i, stop;
+	int x, y;
 	bool ret = FALSE;
 
 	/* Mega-Hack */
@@ -7787,40 +7803,62 @@ static bool project_finalize(s16b start, int who, int dam, int typ_inp,
 		telekinesis_fetched = FALSE;
 	}
 
-	for (i = start; i < max_project_grid; i++)
+	/* Nested ``project'' calls only add grids past these */
+	stop = max_project_grid;
+
+	for (i = start; i < stop; i++)
 	{
-		y = cave_proj_y[i];
-		x = cave_proj_x[i];
-		r = cave_proj_r[i];
-		if (cave_proj_dam[i] > -1) current_dam = cave_proj_dam[i];
-		else current_dam = dam;
+		proj_grid_type *g_ptr = &proj_grids[i];
+
+		if (g_ptr->dam < 0) g_ptr->dam = dam;
 
 		/* Mega-hack: Handle the ``RANDOM'' attack type. */
 		if (typ_inp == GF_RANDOM)
+			g_ptr->typ = rand_range(GF_ARROW, GF_EARTHQUAKE);
+		else
+			g_ptr->typ = typ_inp;
+	}
+
+	/* Affect features (copying each grid, as the list may move) */
+	if (flg & PROJECT_GRID)
+	{
+		for (i = start; i < stop; i++)
 		{
-			typ = rand_range(GF_ARROW, GF_EARTHQUAKE);
+			proj_grid_type g = proj_grids[i];
+
+			if (project_f(who, g.r, g.y, g.x, g.dam, g.typ))
+				ret = TRUE;
 		}
+	}
 
-		/* Affect features. */
-		if (flg & PROJECT_GRID)
+	/* Affect items */
+	if (flg & PROJECT_ITEM)
+	{
+		for (i = start; i < stop; i++)
 		{
-			if (project_f(who, r, y, x, current_dam, typ))
+			proj_grid_type g = proj_grids[i];
+
+			if (project_o(who, g.r, g.y, g.x, g.dam, g.typ))
 				ret = TRUE;
 		}
+	}
 
-		/* Affect items */
-		if (flg & PROJECT_ITEM)
+	/* Affect monsters, then the player */
+	if (flg & PROJECT_KILL)
+	{
+		for (i = start; i < stop; i++)
 		{
-			if (project_o(who, r, y, x, current_dam, typ))
+			proj_grid_type g = proj_grids[i];
+
+			if (project_m(who, g.r, g.y, g.x, g.dam, g.typ))
 				ret = TRUE;
 		}
 
-		/* Affect monsters */
-		if (flg & PROJECT_KILL)
+		for (i = start; i < stop; i++)
 		{
-			if (project_m(who, r, y, x, current_dam, typ))
-				ret = TRUE;
-			if (project_p(who, r, y, x, current_dam, typ))
+			proj_grid_type g = proj_grids[i];
+
+			if (project_p(who, g.r, g.y, g.x, g.dam, g.typ))
 				ret = TRUE;
 		}
 	}
@@ -7872,6 +7910,7 @@ static void project_bolt_beam_ball_aux(int who, int rad, int y, int x,
 	int current_dam = dam;
 	int bounces = 0;
 	int y_old, x_old;
+	bool drawn = FALSE;
 
 	/* Start at player */
 	if (who == -1)
@@ -8084,10 +8123,14 @@ static void project_bolt_beam_ball_aux(int who, int rad, int y, int x,
 				project_grid(y, x, dist, current_dam);
 
 				/* Draw spell effects */
-				draw_spell_effects(y, x, y, x, typ, dist);
+				if (draw_spell_grid(y, x, y, x, typ)) drawn = TRUE;
 			}
 		}
 
+		/* Show the whole ring at once */
+		if (drawn) draw_spell_flush(dist);
+		drawn = FALSE;
+
 		prt_map();
 	}
 }
@@ -8165,6 +8208,8 @@ static void project_blast_aux(int y1, int x1, int rad, int typ, u32b flg)
 	/* Special effects */
 	for (i = 1; i <= rad; i++)
 	{
+		bool drawn = FALSE;
+
 		for (j = 0; j < 5; j++)
 		{
 			while (TRUE)
@@ -8176,9 +8221,12 @@ static void project_blast_aux(int y1, int x1, int rad, int typ, u32b flg)
 					break;
 			}
 
-			/* Show spell effect */
-			draw_spell_effects(y, x, y, x, typ, 1);
+			/* Draw spell effect */
+			if (draw_spell_grid(y, x, y, x, typ)) drawn = TRUE;
 		}
+
+		/* Show them */
+		if (drawn) draw_spell_flush(1);
 	}
 
 	prt_map();
@@ -8194,6 +8242,7 @@ static void project_meteor_shower_aux(int typ)
 	int x, y;
 	int i;
 	int num = rand_range(1000, 3000);
+	bool drawn = FALSE;
 
 	for (i = 0; i < num; i++)
 	{
@@ -8201,9 +8250,14 @@ static void project_meteor_shower_aux(int typ)
 		x = rand_range(1, DUNGEON_WID - 1);
 
 		project_grid(y, x, 0, -1);
-		draw_spell_effects(y, x, y, x, typ, 4);
-		Term_fresh();
-		lite_spot(y, x);
+		if (draw_spell_grid(y, x, y, x, typ)) drawn = TRUE;
+	}
+
+	/* Show them all at once, then put the map back */
+	if (drawn)
+	{
+		draw_spell_flush(4);
+		prt_map();
 	}
 }
 
@@ -8401,9 +8455,15 @@ bool project(int who, int rad, int y, int x, int dam, int typ, u32b flg)
 {
 	/* Mega-Hack -- Starting number of grids. This allows nested ``project''
 	 * calls. */
-	s16b start_grids = max_project_grid;
+	int start_grids;
 	bool ret = FALSE;
 
+	metric_start(METRIC_T_PROJECT);
+
+	start_grids = project_grids_begin();
+
+	fuzz_project(typ);
+
 	/* Hack -- only one type of area effect for now. */
 	if (flg & PROJECT_VIEWABLE)
 	{
@@ -8451,6 +8511,8 @@ bool project(int who, int rad, int y, int x, int dam, int typ, u32b flg)
 
 	ret = project_finalize(start_grids, who, dam, typ, flg);
 
+	metric_stop(METRIC_T_PROJECT);
+
 	return ret;
 }
 
@@ -732,7 +732,7 @@ void self_knowledge(void)
 	{
 		info[i++] = "You can learn some new powers.";
 	}
-	if (p_ptr->word_recall)
+	if (event_when(EVENT_RECALL))
 	{
 		info[i++] = "You will soon be recalled.";
 	}
@@ -1164,6 +1164,9 @@ bool lose_all_info(void)
 		o_ptr->ident &= ~(IDENT_SENSE);
 	}
 
+	/* Everything may be sensed again */
+	inven_unsensed = TRUE;
+
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
 
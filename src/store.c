@@ -504,7 +504,7 @@ static void store_maint_any(int which)
 			/* Remove this item */
 			remove_from_global_list(o_ptr, &(st_ptr->stock));
 
-			KILL(o_ptr, object_type);
+			object_free(o_ptr);
 		}
 
 		/* Next item */
@@ -526,7 +526,7 @@ static void store_maint_any(int which)
 			/* Remove this item */
 			remove_from_global_list(o_ptr, &(st_ptr->stock));
 
-			KILL(o_ptr, object_type);
+			object_free(o_ptr);
 		}
 
 		/* Next item */
@@ -547,7 +547,7 @@ static void store_maint_any(int which)
 			continue;
 
 		/* Now create the item */
-		MAKE(o_ptr, object_type);
+		o_ptr = object_alloc();
 		object_prep(o_ptr, k_idx);
 		o_ptr->number = i_val;
 		o_ptr->weight *= i_val;
@@ -573,7 +573,7 @@ static void store_maint_any(int which)
 		/* Remove worthless items */
 		if (object_value(o_ptr) <= 0)
 		{
-			KILL(o_ptr, object_type);
+			object_free(o_ptr);
 		}
 
 		/* Add to store */
@@ -613,7 +613,7 @@ static void store_maint_bm(void)
 			/* Remove this item */
 			remove_from_global_list(o_ptr, &(st_ptr->stock));
 
-			KILL(o_ptr, object_type);
+			object_free(o_ptr);
 		}
 
 		/* Next item */
@@ -635,7 +635,7 @@ static void store_maint_bm(void)
 			/* Remove this item */
 			remove_from_global_list(o_ptr, &(st_ptr->stock));
 
-			KILL(o_ptr, object_type);
+			object_free(o_ptr);
 		}
 
 		/* Next item */
@@ -672,7 +672,7 @@ static void store_maint_bm(void)
 		}
 
 		/* Set it up */
-		MAKE(o_ptr, object_type);
+		o_ptr = object_alloc();
 		object_prep(o_ptr, k_idx);
 
 		/* The item is "known" */
@@ -682,7 +682,7 @@ static void store_maint_bm(void)
 		if (object_value(o_ptr) <= 100)
 		{
 
-			KILL(o_ptr, object_type);
+			object_free(o_ptr);
 			continue;
 		}
 
@@ -702,7 +702,7 @@ static void store_maint_bm(void)
 		if (object_value(o_ptr) <= 100)
 		{
 
-			KILL(o_ptr, object_type);
+			object_free(o_ptr);
 			continue;
 		}
 
@@ -730,6 +730,40 @@ void store_maint(int which)
 }
 
 
+/*
+ * Owe every shop (except home) a maintenance round, to be made when the
+ * shop is next entered (see "store_catch_up()")
+ *
+ * No more than STORE_MAINT_MAX rounds are owed, which turns the stock
+ * over just as thoroughly as a new shop gets at birth.
+ */
+void store_maint_owe(void)
+{
+	int n;
+
+	for (n = 0; n < MAX_STORES - 1; n++)
+	{
+		if (store[n].maint_due < STORE_MAINT_MAX)
+			store[n].maint_due++;
+	}
+}
+
+
+/*
+ * Make the maintenance rounds a shop is owed
+ */
+void store_catch_up(int which)
+{
+	store_type *st_ptr = &store[which];
+
+	while (st_ptr->maint_due)
+	{
+		store_maint(which);
+		st_ptr->maint_due--;
+	}
+}
+
+
 /*
  * Determine the price of an item (qty one) in a store.
  *
@@ -925,6 +959,9 @@ void store_combine(store_type *st_ptr)
 		{
 			tmp = iter2->next_global;
 
+			/* Only objects of one kind can be combined */
+			if (tmp->k_idx != iter1->k_idx) continue;
+
 			if (p_ptr->s_idx == ST_INFO_HOME)
 			{
 				/* Don't combine worlds ??? */
@@ -1387,6 +1424,9 @@ void store_init(int which)
 	st_ptr->good_buy = 0;
 	st_ptr->bad_buy = 0;
 
+	/* Nothing owed */
+	st_ptr->maint_due = 0;
+
 	/* Nothing in stock */
 	st_ptr->stock = NULL;
 }
@@ -2899,6 +2939,11 @@ void do_cmd_store_aux(int which)
 		return;
 	}
 
+	fuzz_hit(FUZZ_STORE);
+
+	/* Restock while the player was away */
+	store_catch_up(which);
+
 	/* Generate a shop vault. */
 	if (vault_shops)
 	{
@@ -2863,6 +2863,7 @@ cptr mutation_names[MAX_MUTS][3] = {
  * Cost factor.
  * AC factor.
  * Rarity.
+ * Which elements damage it (HATES_*).
  *
  * The factors are ignored unless the object has a different material
  * than it's object kind. 
@@ -2878,203 +2879,247 @@ material materials[STUFF_MAX] = {
 			1,
 			1,
 			1,
-		7},
+		7,
+		HATES_ACID | HATES_ELEC | HATES_FIRE |
+		HATES_COLD | HATES_PLASMA | HATES_METEOR |
+		HATES_SHARDS | HATES_SOUND | HATES_IMPACT},
 
 	{"paper", "paper",
 			2,
 			2,
 			2,
 			1,
-		4},
+		4,
+		HATES_ACID | HATES_FIRE | HATES_PLASMA |
+		HATES_METEOR | HATES_SHARDS | HATES_IMPACT},
 
 	{"earthen", "earth",
 			3,
 			6,
 			1,
 			1,
-		2},
+		2,
+		HATES_ACID | HATES_PLASMA | HATES_METEOR |
+		HATES_SHARDS | HATES_SOUND | HATES_IMPACT},
 
 	{"cloth", "cloth",
 			2,
 			2,
 			10,
 			1,
-		5},
+		5,
+		HATES_ACID | HATES_FIRE | HATES_PLASMA |
+		HATES_METEOR | HATES_SHARDS},
 
 	{"leather", "leather",
 			5,
 			3,
 			14,
 			5,
-		5},
+		5,
+		HATES_ACID | HATES_FIRE | HATES_COLD |
+		HATES_PLASMA | HATES_METEOR | HATES_SHARDS},
 
 	{"organic", "organic material",
 			12,
 			12,
 			5,
 			8,
-		5},
+		5,
+		HATES_ACID | HATES_ELEC | HATES_FIRE |
+		HATES_COLD | HATES_PLASMA | HATES_METEOR |
+		HATES_SHARDS},
 
 	{"wooden", "wood",
 			13,
 			10,
 			8,
 			10,
-		4},
+		4,
+		HATES_ELEC | HATES_FIRE | HATES_PLASMA |
+		HATES_METEOR | HATES_SHARDS | HATES_IMPACT},
 
 	{"glass", "glass",
 			2,
 			13,
 			25,
 			12,
-		3},
+		3,
+		HATES_PLASMA | HATES_METEOR | HATES_SHARDS |
+		HATES_SOUND | HATES_IMPACT},
 
 	{"iron", "iron",
 			20,
 			20,
 			5,
 			15,
-		2},
+		2,
+		HATES_ACID | HATES_PLASMA},
 
 	{"steel", "steel",
 			25,
 			15,
 			10,
 			15,
-		3},
+		3,
+		0},
 
 	{"crystal", "crystal",
 			35,
 			13,
 			50,
 			12,
-		10},
+		10,
+		HATES_ELEC | HATES_SOUND | HATES_IMPACT},
 
 	{"obsidian", "obsidian",
 			44,
 			30,
 			44,
 			20,
-		12},
+		12,
+		0},
 
 	{"flint", "flint",
 			28,
 			23,
 			3,
 			18,
-		2},
+		2,
+		HATES_PLASMA},
 
 	{"graphite", "graphite",
 			15,
 			10,
 			1,
 			13,
-		3},
+		3,
+		HATES_PLASMA | HATES_METEOR | HATES_SHARDS |
+		HATES_SOUND},
 
 	{"ebon", "ebony",
 			20,
 			15,
 			40,
 			18,
-		6},
+		6,
+		HATES_PLASMA | HATES_METEOR},
 
 	{"amber", "amber",
 			14,
 			14,
 			50,
 			9,
-		11},
+		11,
+		HATES_ACID | HATES_ELEC | HATES_FIRE |
+		HATES_PLASMA | HATES_METEOR | HATES_SHARDS |
+		HATES_SOUND | HATES_IMPACT},
 
 	{"sulfurous", "sulfur",
 			3,
 			5,
 			1,
 			5,
-		4},
+		4,
+		HATES_ACID | HATES_ELEC | HATES_FIRE |
+		HATES_PLASMA | HATES_METEOR | HATES_SHARDS |
+		HATES_SOUND | HATES_IMPACT},
 
 	{"copper", "copper",
 			16,
 			12,
 			27,
 			12,
-		4},
+		4,
+		HATES_PLASMA | HATES_METEOR},
 
 	{"silver", "silver",
 			17,
 			14,
 			52,
 			12,
-		7},
+		7,
+		HATES_PLASMA},
 
 	{"golden", "gold",
 			15,
 			23,
 			65,
 			12,
-		11},
+		11,
+		HATES_PLASMA},
 
 	{"mithril", "mithril",
 			63,
 			15,
 			131,
 			40,
-		31},
+		31,
+		0},
 
 	{"ruby", "rubies",
 			31,
 			31,
 			81,
 			28,
-		26},
+		26,
+		HATES_SOUND},
 
 	{"sapphire", "sapphires",
 			33,
 			31,
 			74,
 			27,
-		21},
+		21,
+		HATES_SOUND},
 
 	{"emerald", "emeralds",
 			34,
 			31,
 			68,
 			27,
-		20},
+		20,
+		HATES_SOUND},
 
 	{"adamantium", "adamantite",
 			48,
 			35,
 			48,
 			35,
-		24},
+		24,
+		0},
 
 	{"opal", "opals",
 			25,
 			18,
 			57,
 			25,
-		20},
+		20,
+		HATES_SOUND},
 
 	{"garnet", "garnets",
 			22,
 			14,
 			58,
 			19,
-		20},
+		20,
+		HATES_SOUND},
 
 	{"quartz", "quartz",
 			32,
 			21,
 			22,
 			18,
-		16},
+		16,
+		HATES_SOUND},
 
 	{"diamond", "diamonds",
 			85,
 			30,
 			231,
 			55,
-		42}
+		42,
+		0}
 };
 
 
@@ -3560,7 +3605,7 @@ cptr option_text[OPT_MAX] = {
 	"center_running", /* OPT_center_running */
 	"hidden_pet_messages", /* OPT_hidden_pet_messages */
 	"almost_center_player", /* OPT_almost_center_player */
-	NULL,
+	"autosave_game", /* OPT_autosave_game */
 	NULL,
 	NULL
 };
@@ -3657,7 +3702,7 @@ cptr option_desc[OPT_MAX] = {
 	"Keep player centered while running (slow)", /* OPT_center_running */
 	"Show messages when hidden pets fight", /* OPT_hidden_pet_messages */
 	"Keep the view closer to centered", /* OPT_almost_center_player */
-	NULL,
+	"Save the game in the background every so often", /* OPT_autosave_game */
 	NULL,
 	NULL
 };
@@ -3757,7 +3802,7 @@ bool option_norm[OPT_MAX] = {
 	FALSE, /* OPT_center_running */
 	TRUE, /* OPT_hidden_pet_messages */
 	FALSE, /* OPT_almost_center_player */
-	FALSE,
+	FALSE, /* OPT_autosave_game */
 	FALSE,
 	FALSE
 };
@@ -3869,7 +3914,7 @@ byte option_page[5][22] = {
 			OPT_center_running,
 			OPT_sort_items,
 			OPT_almost_center_player,
-			255,
+			OPT_autosave_game,
 		255},
 
 	/*** Kamband ***/
@@ -4033,3 +4078,15 @@ cptr unstable_scroll_names[15] = {
 	"Tablet of Dysnomia",
 	"Scroll of Limbo"
 };
+
+/*
+ * Names of the memory tags (see "MEM_OTHER" and so on)
+ */
+cptr mem_tag_names[MEM_TAGS] = {
+	"other",
+	"init",
+	"object",
+	"quark",
+	"level",
+	"scratch"
+};
@@ -91,6 +91,17 @@ typedef struct player_class player_class;
 typedef struct player_other player_other;
 typedef struct player_type player_type;
 typedef struct cover_data cover_data;
+typedef struct event_type event_type;
+typedef struct message_type message_type;
+typedef struct dark_sector dark_sector;
+typedef struct flow_field flow_field;
+typedef struct sight_cache sight_cache;
+typedef struct wild_tile wild_tile;
+typedef struct town_layout town_layout;
+typedef struct vault_raster vault_raster;
+typedef struct alloc_cache alloc_cache;
+typedef struct level_cache level_cache;
+typedef struct flag_name flag_name;
 
 
 
@@ -147,6 +158,8 @@ struct header
 
 	u32b text2_size; /* Size of the second text array */
 	u32b text3_size; /* Size of the third text array */
+
+	u32b txt_hash; /* Hash of the template file, or zero */
 };
 
 
@@ -452,17 +465,149 @@ struct dungeon_info
 	u32b flags;
 };
 
+/*
+ * A remembered message (see "message_add()")
+ */
+struct message_type
+{
+	s32b turn;		/* Game turn it was last given */
+	s16b count;		/* Times given in a row */
+	byte prior;		/* Priority (and color) */
+	char text[MESSAGE_LEN];	/* Text */
+};
+
 /*
  * Cover durability tracking (for destructible cover)
  */
 struct cover_data
 {
+    s32b grid;              /* Grid number plus one, or zero (see "cover.c") */
     s16b durability;        /* Current HP of cover object */
     s16b max_durability;    /* Maximum HP */
     byte cover_type;        /* COVER_LIGHT/MEDIUM/HEAVY when intact */
     byte terrain_feat;      /* Original feature type */
 };
 
+/*
+ * A scheduled event (see "event.c")
+ */
+struct event_type
+{
+	s32b turn;		/* Game turn it is due on */
+	u32b seq;		/* Order of posting (ties) */
+	byte kind;		/* EVENT_* */
+	s16b data;		/* Depends on the kind */
+};
+
+/*
+ * Bounding box of a "dark maze" sector (see "cave.c")
+ */
+struct dark_sector
+{
+	s16b y1, x1;		/* Top left grid */
+	s16b y2, x2;		/* Bottom right grid */
+};
+
+/*
+ * A cached distance map towards one source grid (see "flow.c")
+ */
+struct flow_field
+{
+	s16b src_y, src_x;	/* Source grid (centre of the window) */
+	u32b used;		/* Last use (zero if the slot is free) */
+	bool dirty;		/* Terrain in the window has changed */
+	byte cost[FLOW_FIELD_SIZE][FLOW_FIELD_SIZE];	/* Steps to the source */
+};
+
+/*
+ * A remembered line of sight between two grids (see "cave.c")
+ */
+struct sight_cache
+{
+	s16b y1, x1;		/* Source grid */
+	s16b y2, x2;		/* Target grid */
+	u32b epoch;		/* Terrain epoch of the results */
+	byte flags;		/* SIGHT_* results */
+};
+
+/*
+ * The raw heights of a wilderness tile (see "terrain_gen()")
+ */
+struct wild_tile
+{
+	s16b wild_x, wild_y;	/* Location on the global map */
+	u32b seed;		/* Value of "seed_wild" */
+	u32b used;		/* Last use (zero if the slot is free) */
+	byte height[DUNGEON_HGT][DUNGEON_WID];	/* Raw heights (not the edges) */
+};
+
+/*
+ * A town level (the town or the arena) as first built, before its light
+ * and residents (see "town_layout_save()")
+ */
+struct town_layout
+{
+	u32b seed;		/* Value of "seed_wild" (the town only) */
+	s16b town;		/* Vault of the level */
+	s16b vy, vx;		/* Centre of the town vault */
+	byte feat[DUNGEON_HGT][DUNGEON_WID];	/* Features */
+	u16b info[DUNGEON_HGT][DUNGEON_WID];	/* CAVE_ROOM and CAVE_ICKY */
+};
+
+/*
+ * A vault decoded from its "v_info" text (see "build_vault()")
+ */
+struct vault_raster
+{
+	byte *feat;		/* Fixed feature of each grid */
+	byte *info;		/* VAULT_GRID_* flags of each grid */
+	char *glyph;		/* Feature glyph of each grid */
+
+	s16b place_num;		/* Number of monster/object grids */
+	s16b *place_grid;	/* Monster/object grids */
+	char *place_glyph;	/* Monster/object glyphs */
+};
+
+/*
+ * The legal part of an allocation table, summed up for a given level
+ * and set of restrictions (see "get_mon_num()" and "get_obj_num()")
+ */
+struct alloc_cache
+{
+	long *cum;		/* Running total of "prob3" per entry */
+	int num;		/* Number of entries at or below the level */
+	bool valid;		/* The totals can be used */
+
+	int level;		/* Level of the totals */
+	int depth;		/* Dungeon depth of the totals */
+	u32b flags;		/* ALLOC_CACHE_* restrictions of the totals */
+	u32b epoch;		/* Allocation epoch of the totals */
+};
+
+/*
+ * A recently left level, kept in memory exactly as it would be written
+ * to its file (see "save_dungeon()")
+ */
+struct level_cache
+{
+	byte *data;		/* The encoded level, or NULL if unused */
+	u32b len;		/* Bytes used */
+	u32b size;		/* Bytes allocated */
+
+	s16b tag;		/* Tag of the level */
+	u32b used;		/* Use counter, for least-recently-used replacement */
+};
+
+/*
+ * One entry of a sorted index of flag names (see "init1.c")
+ */
+struct flag_name
+{
+	cptr name;		/* Name of the flag */
+	byte set;		/* Table holding the flag */
+	byte bit;		/* Bit of the flag in that table */
+};
+
 /*
  * Information about "cave grids"
  */
@@ -470,6 +615,23 @@ typedef struct {
 	u16b fuel;
 } cave_type;
 
+/*
+ * The fields of a grid which the flow reads together (see "update_flow()"),
+ * packed so that looking at a neighbour costs one load, not three
+ */
+typedef struct {
+	s8b elev;	/* Elevation level */
+	byte pass;	/* Neighbours the flow may lead to (see "elev_pass_grid()") */
+
+#ifdef MONSTER_FLOW
+
+	byte cost;	/* Flow "cost" value */
+	byte when;	/* Flow "when" stamp */
+
+#endif /* MONSTER_FLOW */
+
+} flow_grid;
+
 /*
  * Information about "vault generation"
  */
@@ -615,6 +777,7 @@ typedef struct monster_guard_data monster_guard_data;
 
 struct monster_guard_data
 {
+    s16b m_idx;             /* Monster it belongs to */
     s16b home_y;            /* Guard post / patrol start Y */
     s16b home_x;            /* Guard post / patrol start X */
     s16b alert_y;           /* Last known target Y */
@@ -638,6 +801,12 @@ struct monster_guard_data
  */
 struct monster_type
 {
+	/*
+	 * Fields looked at every game turn, for every monster, by
+	 * "process_monsters()" and "update_mon()" (kept together at the
+	 * front so that those loops touch as little memory as they can)
+	 */
+
 	s16b r_idx;	/* Monster race index */
 
 	s16b fy; /* Y location on map */
@@ -648,44 +817,39 @@ struct monster_type
 
 	s16b csleep; /* Inactive counter */
 
-	byte mspeed; /* Monster "speed" */
-	byte energy; /* Monster "energy" */
+	s16b mflag;	/* Extra monster flags */
 
-	byte stunned; /* Monster is stunned */
-	byte confused; /* Monster is confused */
-	byte monfear; /* Monster is afraid */
 	s16b magnetized; /* Monster is magnetized */
-	byte is_pet; /* Is monster "friendly"? */
-        byte fate; /* Monster's fate indicator. */
+	s16b life_counter; /* Counter for timed life (e.g. max generation breeder) */
 
-	/* random_name_idx gets set the first time ``monster_desc'' gets called. */
-	s16b random_name_idx; /* The index of the random monster name. */
+	s16b mana;
+	s16b max_mana;
 
-	byte cdis; /* Current dis from player */
+	byte mspeed; /* Monster "speed" */
+	byte energy; /* Monster "energy" */
 
-	s16b mflag;	/* Extra monster flags */
+	byte cdis; /* Current dis from player */
 
 	bool ml; /* Monster is "visible" */
 
-	object_type *inventory;	/* Objects being held (if any) */
-
-	byte ty; /* Y location of target */
-	byte tx; /* X location of target */
+	byte is_pet; /* Is monster "friendly"? */
 
-	s16b target_idx; /* Target monster index (or 0 for player) */
+	byte stunned; /* Monster is stunned */
+	byte confused; /* Monster is confused */
+	byte monfear; /* Monster is afraid */
 
-	smart_ai_meta_t smart_ai; /* New smart AI state and memory */
+	byte fate; /* Monster's fate indicator. */
 
 	byte t_dur;	/* How long are we tracking */
 
-	byte t_bit;	/* Up to eight bit flags */
 
-	s16b mana;
-	s16b max_mana;
-	s16b ammo;
+	/*
+	 * Everything else
+	 */
 
-	byte generation; /* Breeding generation */
-	s16b life_counter; /* Counter for timed life (e.g. max generation breeder) */
+	object_type *inventory;	/* Objects being held (if any) */
+
+	smart_ai_meta_t smart_ai; /* New smart AI state and memory */
 
 #ifdef DRS_SMART_OPTIONS
 
@@ -693,6 +857,19 @@ struct monster_type
 
 #endif
 
+	/* random_name_idx gets set the first time ``monster_desc'' gets called. */
+	s16b random_name_idx; /* The index of the random monster name. */
+
+	s16b target_idx; /* Target monster index (or 0 for player) */
+
+	s16b ammo;
+
+	byte ty; /* Y location of target */
+	byte tx; /* X location of target */
+
+	byte t_bit;	/* Up to eight bit flags */
+
+	byte generation; /* Breeding generation */
 };
 
 
@@ -936,6 +1113,8 @@ struct material
 	byte cost_factor;
 	byte ac_factor;
 	byte rarity;
+
+	u16b hates;	/* Elements which damage it (HATES_*) */
 };
 
 
@@ -970,7 +1149,7 @@ struct owner_type
 struct store_type
 {
 	byte owner;	/* Owner index */
-	byte extra;	/* Unused for now */
+	byte maint_due;	/* Maintenance rounds owed (see "store_maint_owe()") */
 
 	s16b insult_cur; /* Insult counter */
 
@@ -1221,7 +1400,6 @@ struct player_type
 	u32b mutations2; /* Mutation flags 2 */
 	u32b mutations3; /* Mutation flags 3 */
 
-	s16b word_recall; /* Word of recall counter */
 	s16b scroll_delay; /* Unstable scroll delay */
 	s16b echo_timer; /* Echo Location timer */
 	byte scroll_pending_effect; /* Pending effect ID */
@@ -1446,3 +1624,180 @@ struct player_type
 
 	s16b pspeed; /* Current speed */
 };
+
+
+/*
+ * The state of one game: the grids, and the monsters and objects on
+ * them.  The engine reaches it through "game_ptr", under the old names
+ * ("cave_feat[y][x]", "m_list[i]" and so on, see "externs.h").
+ */
+typedef struct game_type game_type;
+
+struct game_type
+{
+	s16b obj_max;	/* Number of allocated objects */
+	s16b obj_cnt;	/* Number of live objects */
+
+	s16b mon_max;	/* Number of allocated monsters */
+	s16b mon_cnt;	/* Number of live monsters */
+
+	s16b hgt;	/* Rows in use by the level (the rest is rock) */
+	s16b wid;	/* Columns in use by the level (the rest is rock) */
+
+	object_type *objects;	/* The linked list of dungeon objects */
+
+	monster_type monsters[MAX_M_IDX];	/* The dungeon monsters */
+	s16b mon_free[MAX_M_IDX];	/* Dead monsters below "mon_max" */
+	s16b mon_free_num;		/* Dead monsters in "mon_free" */
+	u16b mon_gen[MAX_M_IDX];	/* Times each monster slot has changed hands */
+	monster_guard_data guards[MAX_GUARDS];	/* Guard data, without holes */
+	s16b guard_max;				/* Guard data in use, plus one */
+	s16b guard_idx[MAX_M_IDX];		/* Each monster's guard data, or zero */
+
+	flow_grid flow[DUNGEON_HGT][DUNGEON_WID];	/* Elevation and flow */
+
+	cave_type grid[DUNGEON_HGT][DUNGEON_WID];	/* Grids */
+	u16b info[DUNGEON_HGT][DUNGEON_WID];	/* Info flags */
+	byte sector[DUNGEON_HGT][DUNGEON_WID];	/* Sector types */
+	byte feat[DUNGEON_HGT][DUNGEON_WID];	/* Feature codes */
+	byte light[DUNGEON_HGT][DUNGEON_WID];	/* Burning grids lighting each grid */
+	byte elev_walk[DUNGEON_HGT][DUNGEON_WID];	/* Neighbours a walker may step to */
+	cover_data cover[COVER_SLOTS];	/* Destructible cover, hashed by grid */
+	s16b cover_num;			/* Cover slots in use */
+
+	/*
+	 * The object in each grid (a pointer into "objects"), and the
+	 * monster (positive) or player (negative) in each grid, or zero
+	 * for nobody; this replicates what is in the monster list and
+	 * the player structure, but gives it out much faster
+	 */
+	object_type *o_idx[DUNGEON_HGT][DUNGEON_WID];
+	s16b m_idx[DUNGEON_HGT][DUNGEON_WID];
+};
+
+
+/*
+ * One part of the memory census (see "memory_census()")
+ *
+ * A part which is a pool of slots has a "max", and "used" is how many of
+ * them the level has taken; the other parts have none.
+ */
+typedef struct census_type census_type;
+
+struct census_type
+{
+	cptr name;	/* The part */
+
+	long bytes;	/* Bytes it holds */
+
+	long used;	/* Slots taken */
+	long max;	/* Slots there are, or zero */
+};
+
+
+/*
+ * A visible monster, as an observer sees it (see "observe.c")
+ */
+typedef struct observe_monster observe_monster;
+
+struct observe_monster
+{
+	s16b m_idx;	/* Index in "m_list" */
+	s16b r_idx;	/* Race */
+
+	s16b y, x;	/* Location */
+
+	s16b hp;	/* Hit points */
+	s16b maxhp;	/* Max hit points */
+
+	bool is_pet;	/* On the player's side */
+};
+
+
+/*
+ * An object the player carries, as an observer sees it
+ */
+typedef struct observe_item observe_item;
+
+struct observe_item
+{
+	s16b k_idx;	/* Kind ("k_info" index) */
+
+	byte tval;	/* Item type */
+	byte sval;	/* Item sub-type */
+
+	byte number;	/* Number in the stack */
+	bool aware;	/* The player knows what the kind is */
+};
+
+
+/*
+ * The status of the player, as the "prt_*()" functions show it
+ */
+typedef struct observe_status observe_status;
+
+struct observe_status
+{
+	s16b depth;
+	s16b py, px;
+	s16b lev;
+	s32b exp;
+	s32b au;
+	s16b chp, mhp;
+	s16b csp, msp;
+	s16b csane, msane;
+	s16b ac;
+	s16b speed;		/* Zero is normal speed */
+	s16b food;
+	s16b stat_use[6];
+	s16b blind, confused, afraid, poisoned, paralyzed, image;
+	s16b cut, stun;
+	u16b disturb_why;	/* Why the player was last disturbed (DISTURB_*) */
+};
+
+
+/*
+ * What an observer of the game sees (see "observe.c")
+ *
+ * Each part has a version, bumped whenever that part changes, and
+ * "version" is bumped with any of them, so a reader can skip what it has
+ * seen already.  The map keeps a version for each row as well.
+ */
+typedef struct observe_type observe_type;
+
+struct observe_type
+{
+	u16b layout;		/* OBSERVE_LAYOUT of the program which filled it */
+
+	u32b version;		/* Bumped when anything changes */
+	u32b status_version;	/* ... the status */
+	u32b monster_version;	/* ... the visible monsters */
+	u32b item_version;	/* ... the pack or the equipment */
+	u32b map_version;	/* ... the map */
+
+	s32b turn;		/* Game turn of the snapshot */
+
+	observe_status status;	/* The status */
+
+	/* The visible monsters */
+	s16b monster_num;
+	observe_monster monster[OBSERVE_MONSTERS];
+
+	/* The pack, and then the equipment (a zero "k_idx" is an empty slot) */
+	s16b item_num;
+	observe_item item[OBSERVE_ITEMS];
+	observe_item equip[EQUIP_MAX];
+
+	/* The map the player remembers */
+	byte feat[DUNGEON_HGT][DUNGEON_WID];	/* Feature, or FEAT_NONE */
+	byte info[DUNGEON_HGT][DUNGEON_WID];	/* OBS_* flags */
+	u32b row_version[DUNGEON_HGT];		/* Version of each row */
+};
+
+
+/*
+ * A bot which picks the commands of a headless game from what it observes
+ * (see "observe_start()"); it returns FALSE to leave the choice to the game
+ */
+typedef bool (*observe_hook_type)(const observe_type *o_ptr, char *cmd,
+	int *dir);
@@ -17,52 +17,6 @@
 #include <unistd.h>
 #endif
 
-long get_current_rss_kb(void)
-{
-#if defined(__linux__) || defined(__linux) || defined(linux) || defined(__gnu_linux__)
-	FILE* fp = fopen("/proc/self/statm", "r");
-	long rss = 0;
-	if (fp)
-	{
-		long dummy;
-		if (fscanf(fp, "%ld %ld", &dummy, &rss) == 2)
-		{
-			rss *= (sysconf(_SC_PAGESIZE) / 1024);
-		}
-		fclose(fp);
-	}
-	return rss;
-#else
-	struct rusage usage;
-	getrusage(RUSAGE_SELF, &usage);
-	return usage.ru_maxrss;
-#endif
-}
-
-void log_metric(const char *event_type, long duration_ms)
-{
-	if (!arg_headless) return;
-
-	FILE *f = fopen("kamband_stats.csv", "a");
-	if (!f) return;
-
-	fseek(f, 0, SEEK_END);
-	if (ftell(f) == 0)
-	{
-		fprintf(f, "turn,event_type,duration_ms,mem_kb,depth,x,y,elevation\n");
-	}
-
-	long mem_kb = get_current_rss_kb();
-	int elev = get_elevation(p_ptr->py, p_ptr->px);
-
-	fprintf(f, "%ld,%s,%ld,%ld,%d,%d,%d,%d\n",
-			(long)turn, event_type, duration_ms, mem_kb,
-			(int)p_ptr->depth, (int)p_ptr->px, (int)p_ptr->py, elev);
-	fclose(f);
-}
-
-
-
 #ifndef HAS_MEMSET
 
 /*
@@ -1213,12 +1167,127 @@ void ascii_to_text(char *buf, cptr str)
 static bool macro__use[256];
 
 
+/*
+ * The macro patterns, as a tree of the keys they are made of
+ *
+ * Each node is the pattern spelled by the keys on the way down from the
+ * root (node zero, the empty pattern), and knows the macro whose pattern
+ * it is (if any), and the first macro whose pattern starts with it.
+ * Macros are never removed, and new ones take the next index, so the
+ * "first" macro of a node is the one which made the node.
+ *
+ * The names of the CLI commands are kept in a tree of the same kind
+ * (see "cli_init()").
+ */
+typedef struct macro_node macro_node;
+
+struct macro_node
+{
+	u32b child;	/* First longer pattern (or zero) */
+	u32b next;	/* Next pattern of this length, same but the last key */
+	s16b macro;	/* The macro with this pattern (or -1) */
+	s16b first;	/* The first macro which starts with this pattern */
+	byte key;	/* The last key of this pattern */
+};
+
+static macro_node *macro__node;
+static u32b macro__node_num;
+static u32b macro__node_max;
+
+static macro_node *cli__node;
+static u32b cli__node_num;
+static u32b cli__node_max;
+
+
+/*
+ * Find the node of the given pattern in "tree" (or zero, if nothing
+ * starts with it, or if the pattern is the empty one)
+ */
+static u32b key_tree_find(const macro_node *tree, cptr pat)
+{
+	u32b n = 0;
+
+	for (; *pat; pat++)
+	{
+		for (n = tree[n].child; n; n = tree[n].next)
+		{
+			if (tree[n].key == (byte)(*pat)) break;
+		}
+
+		if (!n) return (0);
+	}
+
+	return (n);
+}
+
+
+/*
+ * Add the pattern of entry "k" to the tree "*tp", which has "*np" of
+ * "*mp" nodes in use
+ */
+static void key_tree_add(macro_node **tp, u32b *np, u32b *mp, cptr pat,
+	sint k)
+{
+	u32b n = 0, c;
+
+	/* The first entry which starts with the empty pattern */
+	if ((*tp)[0].first < 0) (*tp)[0].first = k;
+
+	for (; *pat; pat++)
+	{
+		macro_node *tree = *tp;
+
+		for (c = tree[n].child; c; c = tree[c].next)
+		{
+			if (tree[c].key == (byte)(*pat)) break;
+		}
+
+		/* A new pattern */
+		if (!c)
+		{
+			/* Make room */
+			if (*np == *mp)
+			{
+				C_MAKE(tree, (*mp) * 2, macro_node);
+				C_COPY(tree, *tp, *mp, macro_node);
+				C_KILL(*tp, *mp, macro_node);
+				*tp = tree;
+				(*mp) *= 2;
+			}
+
+			c = (*np)++;
+
+			tree[c].key = (byte)(*pat);
+			tree[c].macro = -1;
+			tree[c].first = k;
+			tree[c].child = 0;
+			tree[c].next = tree[n].child;
+			tree[n].child = c;
+		}
+
+		n = c;
+	}
+
+	(*tp)[n].macro = k;
+}
+
+
+/*
+ * Find the node of the given pattern (or zero, if no macro starts with it,
+ * or if the pattern is the empty one)
+ */
+static u32b macro_node_find(cptr pat)
+{
+	return (key_tree_find(macro__node, pat));
+}
+
+
 /*
  * Find the macro (if any) which exactly matches the given pattern
  */
 sint macro_find_exact(cptr pat)
 {
-	int i;
+	u32b n;
 
 	/* Nothing possible */
 	if (!macro__use[(byte) (pat[0])])
@@ -1226,19 +1295,11 @@ sint macro_find_exact(cptr pat)
 		return (-1);
 	}
 
-	/* Scan the macros */
-	for (i = 0; i < macro__num; ++i)
-	{
-		/* Skip macros which do not match the pattern */
-		if (!streq(macro__pat[i], pat))
-			continue;
+	/* Find the pattern */
+	n = macro_node_find(pat);
+	if (!n && pat[0]) return (-1);
 
-		/* Found one */
-		return (i);
-	}
-
-	/* No matches */
-	return (-1);
+	return (macro__node[n].macro);
 }
 
 
@@ -1247,7 +1308,7 @@ sint macro_find_exact(cptr pat)
  */
 static sint macro_find_check(cptr pat)
 {
-	int i;
+	u32b n;
 
 	/* Nothing possible */
 	if (!macro__use[(byte) (pat[0])])
@@ -1255,19 +1316,11 @@ static sint macro_find_check(cptr pat)
 		return (-1);
 	}
 
-	/* Scan the macros */
-	for (i = 0; i < macro__num; ++i)
-	{
-		/* Skip macros which do not contain the pattern */
-		if (!prefix(macro__pat[i], pat))
-			continue;
+	/* Find the pattern */
+	n = macro_node_find(pat);
+	if (!n && pat[0]) return (-1);
 
-		/* Found one */
-		return (i);
-	}
-
-	/* Nothing */
-	return (-1);
+	return (macro__node[n].first);
 }
 
 
@@ -1276,7 +1329,8 @@ static sint macro_find_check(cptr pat)
  */
 static sint macro_find_maybe(cptr pat)
 {
-	int i;
+	u32b n;
+	sint k = -1;
 
 	/* Nothing possible */
 	if (!macro__use[(byte) (pat[0])])
@@ -1284,23 +1338,18 @@ static sint macro_find_maybe(cptr pat)
 		return (-1);
 	}
 
-	/* Scan the macros */
-	for (i = 0; i < macro__num; ++i)
-	{
-		/* Skip macros which do not contain the pattern */
-		if (!prefix(macro__pat[i], pat))
-			continue;
-
-		/* Skip macros which exactly match the pattern XXX XXX */
-		if (streq(macro__pat[i], pat))
-			continue;
+	/* Find the pattern */
+	n = macro_node_find(pat);
+	if (!n && pat[0]) return (-1);
 
-		/* Found one */
-		return (i);
+	/* The first of the longer patterns */
+	for (n = macro__node[n].child; n; n = macro__node[n].next)
+	{
+		if ((k < 0) || (macro__node[n].first < k)) k = macro__node[n].first;
 	}
 
 	/* Nothing */
-	return (-1);
+	return (k);
 }
 
 
@@ -1309,7 +1358,8 @@ static sint macro_find_maybe(cptr pat)
  */
 static sint macro_find_ready(cptr pat)
 {
-	int i, t, n = -1, s = -1;
+	u32b n = 0;
+	sint k;
 
 	/* Nothing possible */
 	if (!macro__use[(byte) (pat[0])])
@@ -1317,27 +1367,33 @@ static sint macro_find_ready(cptr pat)
 		return (-1);
 	}
 
-	/* Scan the macros */
-	for (i = 0; i < macro__num; ++i)
+	/* The empty pattern */
+	k = macro__node[0].macro;
+
+	/* Follow the pattern down, noting the macros on the way */
+	for (; *pat; pat++)
 	{
-		/* Skip macros which are not contained by the pattern */
-		if (!prefix(pat, macro__pat[i]))
-			continue;
+		for (n = macro__node[n].child; n; n = macro__node[n].next)
+		{
+			if (macro__node[n].key == (byte)(*pat)) break;
+		}
 
-		/* Obtain the length of this macro */
-		t = strlen(macro__pat[i]);
+		if (!n) break;
 
-		/* Only track the "longest" pattern */
-		if ((n >= 0) && (s > t))
-			continue;
-
-		/* Track the entry */
-		n = i;
-		s = t;
+		if (macro__node[n].macro >= 0) k = macro__node[n].macro;
 	}
 
 	/* Result */
-	return (n);
+	return (k);
+}
+
+
+/*
+ * Add the pattern of macro "k" to the tree
+ */
+static void macro_node_add(cptr pat, sint k)
+{
+	key_tree_add(&macro__node, &macro__node_num, &macro__node_max, pat, k);
 }
 
 
@@ -1383,6 +1439,9 @@ errr macro_add(cptr pat, cptr act)
 
 		/* Save the pattern */
 		macro__pat[n] = string_make(pat);
+
+		/* Find it quickly */
+		macro_node_add(pat, n);
 	}
 
 	/* Save the action */
@@ -1407,11 +1466,76 @@ errr macro_init(void)
 	/* Macro actions */
 	C_MAKE(macro__act, MACRO_MAX, cptr);
 
+	/* The tree of patterns, with just the empty one */
+	macro__node_max = MACRO_MAX * 4;
+	C_MAKE(macro__node, macro__node_max, macro_node);
+	macro__node_num = 1;
+	macro__node[0].macro = -1;
+	macro__node[0].first = -1;
+
 	/* Success */
 	return (0);
 }
 
 
+/*
+ * Initialize the tree of CLI command names
+ *
+ * Name "k" is "comm1" (if "k" is even) or "comm2" of "cli_info[k / 2]".
+ * The names go in from the end of the table, so that a name found in
+ * the tree is its first use in the table, and the "first" name under a
+ * node is the last of the table which starts with it.
+ */
+errr cli_init(void)
+{
+	int i;
+
+	cli__node_max = MAX_COMMANDS * 8;
+	C_MAKE(cli__node, cli__node_max, macro_node);
+	cli__node_num = 1;
+	cli__node[0].macro = -1;
+	cli__node[0].first = -1;
+
+	for (i = MAX_COMMANDS - 1; i >= 0; i--)
+	{
+		if (!cli_info[i].comm1) continue;
+
+		key_tree_add(&cli__node, &cli__node_num, &cli__node_max,
+			cli_info[i].comm1, i * 2);
+
+		if (!cli_info[i].comm2) continue;
+
+		key_tree_add(&cli__node, &cli__node_num, &cli__node_max,
+			cli_info[i].comm2, i * 2 + 1);
+	}
+
+	/* Success */
+	return (0);
+}
+
+
+/*
+ * The name of CLI command name "k" (see "cli_init()")
+ */
+static cptr cli_name(sint k)
+{
+	return ((k & 1) ? cli_info[k / 2].comm2 : cli_info[k / 2].comm1);
+}
+
+
+/*
+ * Find the CLI command called "name" (or NULL)
+ */
+cli_comm *cli_find(cptr name)
+{
+	u32b n = key_tree_find(cli__node, name);
+
+	if (!n || (cli__node[n].macro < 0)) return (NULL);
+
+	return (&cli_info[cli__node[n].macro / 2]);
+}
+
+
 /*
  * Flush all pending input.
  *
@@ -1473,7 +1597,7 @@ static char inkey_aux(void)
 
 
 	/* Wait for a keypress */
-	(void) (Term_inkey(&ch, TRUE, TRUE));
+	(void) (journal_inkey(&ch, TRUE, TRUE));
 
 
 	/* End "macro action" */
@@ -1517,7 +1641,7 @@ static char inkey_aux(void)
 			break;
 
 		/* Check for (and remove) a pending key */
-		if (0 == Term_inkey(&ch, FALSE, TRUE))
+		if (0 == journal_inkey(&ch, FALSE, TRUE))
 		{
 			/* Append the key */
 			buf[p++] = ch;
@@ -1558,7 +1682,7 @@ static char inkey_aux(void)
 		}
 
 		/* Wait for (and remove) a pending key */
-		(void) Term_inkey(&ch, TRUE, TRUE);
+		(void) journal_inkey(&ch, TRUE, TRUE);
 
 		/* Return the key */
 		return (ch);
@@ -1785,18 +1909,21 @@ char inkey(void)
 	{
 		/* Hack -- Handle "inkey_scan" */
 		if (!inkey_base && inkey_scan &&
-			(0 != Term_inkey(&kk, FALSE, FALSE)))
+			(0 != journal_inkey(&kk, FALSE, FALSE)))
 		{
 			break;
 		}
 
 
 		/* Hack -- Flush output once when no key ready */
-		if (!done && (0 != Term_inkey(&kk, FALSE, FALSE)))
+		if (!done && (0 != journal_inkey(&kk, FALSE, FALSE)))
 		{
 			/* Hack -- activate proper term */
 			Term_activate(old);
 
+			/* Catch up with held back subwindows */
+			window_stuff_flush();
+
 			/* Flush output */
 			Term_fresh();
 
@@ -1809,6 +1936,9 @@ char inkey(void)
 			/* Mega-Hack -- reset signal counter */
 			signal_count = 0;
 
+			/* Prepare nearby wilderness, until a key comes */
+			while ((0 != journal_inkey(&kk, FALSE, FALSE)) && wild_prefetch()) ;
+
 			/* Only once */
 			done = TRUE;
 		}
@@ -1823,7 +1953,7 @@ char inkey(void)
 			if (!inkey_scan)
 			{
 				/* Wait for (and remove) a pending key */
-				if (0 == Term_inkey(&ch, TRUE, TRUE))
+				if (0 == journal_inkey(&ch, TRUE, TRUE))
 				{
 					/* Done */
 					break;
@@ -1837,7 +1967,7 @@ char inkey(void)
 			while (TRUE)
 			{
 				/* Check for (and remove) a pending key */
-				if (0 == Term_inkey(&ch, FALSE, TRUE))
+				if (0 == journal_inkey(&ch, FALSE, TRUE))
 				{
 					/* Done */
 					break;
@@ -1937,6 +2067,51 @@ char inkey(void)
 }
 
 
+/*
+ * Flush the screen, but no more than FRESH_MAX_FPS times a second.
+ *
+ * This is for the refreshes done every game turn (see "fresh_before"
+ * and "fresh_after"), so that running and resting go as fast as the
+ * game can, not as fast as the terminal can draw.  Nothing is left on
+ * screen for long, since "inkey()" always flushes before waiting.
+ */
+void fresh_limited(void)
+{
+	static struct timeval last;
+	struct timeval now;
+	long usec;
+
+	/* Nobody is watching (see "--fast") */
+	if (arg_fast) return;
+
+	gettimeofday(&now, NULL);
+
+	usec = (now.tv_sec - last.tv_sec) * 1000000L +
+		(now.tv_usec - last.tv_usec);
+
+	/* Too soon */
+	if ((usec >= 0) && (usec < 1000000L / FRESH_MAX_FPS)) return;
+
+	last = now;
+
+	Term_fresh();
+}
+
+
+/*
+ * Get a clock in milliseconds, for timing short gaps (it wraps, but
+ * unsigned differences come out right across the wrap)
+ */
+u32b msec_clock(void)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+
+	return ((u32b)now.tv_sec * 1000L + (u32b)(now.tv_usec / 1000));
+}
+
+
 /*
  * Flush the screen, make a noise
  */
@@ -1982,38 +2157,144 @@ void sound(int val)
  * index, which should greatly reduce the need for inscription space.
  *
  * Note that "quark zero" is NULL and should not be "dereferenced".
+ *
+ * The quarks are found through a hash table of QUARK_HASH slots (with
+ * linear probing), so adding one costs no more than hashing it.  Quarks
+ * which no object uses any more are freed by "quark_collect()" (when the
+ * game is saved, or when there is no room for another), and their
+ * indexes are used again.
+ */
+
+/*
+ * The hash table (quark indexes, zero for none)
+ */
+static s16b quark__hash[QUARK_HASH];
+
+/*
+ * Indexes below "quark__num" which were freed
  */
+static s16b quark__free[QUARK_MAX];
+static int quark__free_num = 0;
+
+
+/*
+ * The first slot to look in for a string
+ */
+static int quark_hash(cptr str)
+{
+	u32b h = 5381;
+
+	while (*str) h = (h * 33) ^ (byte)(*str++);
+
+	return ((int)(h & (QUARK_HASH - 1)));
+}
+
+
+/*
+ * Find the slot a string has (or would have) in the hash table
+ */
+static int quark_slot(cptr str)
+{
+	int k = quark_hash(str);
+
+	while (quark__hash[k] && !streq(quark__str[quark__hash[k]], str))
+	{
+		k = (k + 1) & (QUARK_HASH - 1);
+	}
+
+	return (k);
+}
+
 
 /*
  * Add a new "quark" to the set of quarks.
  */
 s16b quark_add(cptr str)
 {
-	int i;
+	int i, k, tag;
 
 	/* Look for an existing quark */
-	for (i = 1; i < quark__num; i++)
+	k = quark_slot(str);
+	if (quark__hash[k]) return (quark__hash[k]);
+
+	/* Make room, if needed */
+	if (!quark__free_num && (quark__num == QUARK_MAX))
+	{
+		quark_collect();
+		k = quark_slot(str);
+	}
+
+	/* Use a freed index */
+	if (quark__free_num)
 	{
-		/* Check for equality */
-		if (streq(quark__str[i], str))
-			return (i);
+		i = quark__free[--quark__free_num];
 	}
 
 	/* Paranoia -- Require room */
-	if (quark__num == QUARK_MAX)
+	else if (quark__num == QUARK_MAX)
+	{
 		return (0);
+	}
 
 	/* New maximal quark */
-	quark__num = i + 1;
+	else
+	{
+		if (!quark__num) quark__num = 1;
+		i = quark__num++;
+	}
 
 	/* Add a new quark */
+	tag = VIRT_TAG(MEM_QUARK);
 	quark__str[i] = string_make(str);
+	(void)VIRT_TAG(tag);
+
+	quark__hash[k] = i;
 
 	/* Return the index */
 	return (i);
 }
 
 
+/*
+ * Free the quarks which no object uses
+ */
+void quark_collect(void)
+{
+	bool used[QUARK_MAX];
+	int i;
+
+	C_WIPE(used, QUARK_MAX, bool);
+
+	/* Look at every object */
+	object_pool_notes(used);
+
+	C_WIPE(quark__hash, QUARK_HASH, s16b);
+	quark__free_num = 0;
+
+	for (i = 1; i < quark__num; i++)
+	{
+		/* Free it */
+		if (quark__str[i] && !used[i])
+		{
+			string_free(quark__str[i]);
+			quark__str[i] = NULL;
+		}
+
+		/* Rehash it */
+		if (quark__str[i])
+		{
+			quark__hash[quark_slot(quark__str[i])] = i;
+		}
+
+		/* Use it again */
+		else
+		{
+			quark__free[quark__free_num++] = i;
+		}
+	}
+}
+
+
 /*
  * This function looks up a quark
  */
@@ -2036,24 +2317,23 @@ cptr quark_str(s16b i)
 
 
 /*
- * Second try for the "message" handling routines.
+ * Third try for the "message" handling routines.
  *
  * Each call to "message_add(s)" will add a new "most recent" message
  * to the "message recall list", using the contents of the string "s".
  *
- * The messages will be stored in such a way as to maximize "efficiency",
- * that is, we attempt to maximize the number of sequential messages that
- * can be retrieved, given a limited amount of storage space.
+ * The messages are kept as fixed records (see "message_type") in a ring
+ * of MESSAGE_MAX (a power of two), and the "message__count" message ever
+ * added goes in record "message__count % MESSAGE_MAX", over the oldest.
+ * The text of a message is cut to MESSAGE_LEN - 1 characters, which is
+ * all the savefile ever kept anyway.
  *
- * We keep a buffer of chars to hold the "text" of the messages, not
- * necessarily in "order", and an array of offsets into that buffer,
- * representing the actual messages.  This is made more complicated
- * by the fact that both the array of indexes, and the buffer itself,
- * are both treated as "circular arrays" for efficiency purposes, but
- * the strings may not be "broken" across the ends of the array.
+ * A message which is the same as the one before it is not added again;
+ * the earlier one counts it instead (and shows it as "(xN)"), so that a
+ * long fight repeating the same few messages costs no copying at all.
  *
- * The "message_add()" function is rather "complex", because it must be
- * extremely efficient, both in space and time, for use with the Borg.
+ * Anything which shows the messages may remember "message__stamp", which
+ * changes whenever they do, to notice when there is nothing new.
  */
 
 
@@ -2063,77 +2343,90 @@ cptr quark_str(s16b i)
  */
 s16b message_num(void)
 {
-	int last, next, n;
+	if (message__count > MESSAGE_MAX) return (MESSAGE_MAX);
 
-	/* Extract the indexes */
-	last = message__last;
-	next = message__next;
+	return ((s16b)message__count);
+}
 
-	/* Handle "wrap" */
-	if (next < last)
-		next += MESSAGE_MAX;
 
-	/* Extract the space */
-	n = (next - last);
+/*
+ * The record of a saved message, or NULL if it is forgotten
+ */
+static message_type *message_get(s16b age)
+{
+	/* Forgotten */
+	if ((age < 0) || (age >= message_num())) return (NULL);
 
-	/* Return the result */
-	return (n);
+	return (&message__list[(message__count - 1 - age) & (MESSAGE_MAX - 1)]);
 }
 
 
-
 /*
- * Recall the "text" of a saved message
+ * Recall the "text" of a saved message (valid until the next call)
  */
 cptr message_str(s16b age)
 {
-	s16b x;
-	s16b o;
-	cptr s;
+	static char buf[MESSAGE_LEN + 16];
+
+	message_type *m_ptr = message_get(age);
 
 	/* Forgotten messages have no text */
-	if ((age < 0) || (age >= message_num()))
-		return ("");
+	if (!m_ptr) return ("");
 
-	/* Acquire the "logical" index */
-	x = (message__next + MESSAGE_MAX - (age + 1)) % MESSAGE_MAX;
+	/* Just once */
+	if (m_ptr->count < 2) return (m_ptr->text);
 
-	/* Get the "offset" for the message */
-	o = message__ptr[x];
+	/* Repeated */
+	strnfmt(buf, sizeof(buf), "%s (x%d)", m_ptr->text, m_ptr->count);
 
-	/* Access the message text */
-	s = &message__buf[o];
+	return (buf);
+}
 
-	/* Return the message text */
-	return (s);
+/*
+ * Recall the "text" of a saved message, without the count
+ */
+cptr message_text(s16b age)
+{
+	message_type *m_ptr = message_get(age);
+
+	/* Forgotten messages have no text */
+	if (!m_ptr) return ("");
+
+	return (m_ptr->text);
 }
 
 /*
- * Recall the priority of a saved message
+ * Recall how many times a saved message was given in a row
  */
-byte message_prior(s16b age)
+s16b message_count(s16b age)
 {
-	s16b x;
+	message_type *m_ptr = message_get(age);
 
 	/* Forgotten */
-	if ((age < 0) || (age >= message_num()))
-		return MSG_NORMAL;
-
-	/* Index */
-	x = (message__next + MESSAGE_MAX - (age + 1)) % MESSAGE_MAX;
+	if (!m_ptr) return (0);
 
-	return message__pty[x];
+	return (m_ptr->count);
 }
 
 /*
- * Add a new message, with great efficiency
+ * Recall the priority of a saved message
  */
-void message_add(cptr str, byte prior)
+byte message_prior(s16b age)
 {
-	int i, k, x, n;
+	message_type *m_ptr = message_get(age);
 
+	/* Forgotten */
+	if (!m_ptr) return MSG_NORMAL;
 
-	/*** Step 1 -- Analyze the message ***/
+	return m_ptr->prior;
+}
+
+/*
+ * Add a new message, given "n" times in a row, with great efficiency
+ */
+void message_add_count(cptr str, byte prior, s16b n)
+{
+	message_type *m_ptr;
 
 	/* Hack -- Ignore "non-messages" */
 	if (!str)
@@ -2143,181 +2436,39 @@ void message_add(cptr str, byte prior)
 	if (prior == MSG_TEMP)
 		return;
 
+	/* Note the change */
+	message__stamp++;
 
-	/* Message length */
-	n = strlen(str);
-
-	/* Important Hack -- Ignore "long" messages */
-	if (n >= MESSAGE_BUF / 4)
-		return;
-
-
-	/*** Step 2 -- Attempt to optimize ***/
-
-	/* Limit number of messages to check */
-	k = message_num() / 4;
+	/* The same as the last one */
+	m_ptr = message_get(0);
 
-	/* Limit number of messages to check */
-	if (k > MESSAGE_MAX / 32)
-		k = MESSAGE_MAX / 32;
-
-	/* Check the last few messages (if any to count) */
-	for (i = message__next; k; k--)
+	if (m_ptr && (m_ptr->prior == prior) && (m_ptr->count <= MAX_SHORT - n) &&
+	    !strncmp(m_ptr->text, str, MESSAGE_LEN))
 	{
-		u16b q;
-
-		cptr old;
-
-		/* Back up and wrap if needed */
-		if (i-- == 0)
-			i = MESSAGE_MAX - 1;
-
-		/* Stop before oldest message */
-		if (i == message__last)
-			break;
-
-		/* Extract "distance" from "head" */
-		q = (message__head + MESSAGE_BUF - message__ptr[i]) % MESSAGE_BUF;
-
-		/* Do not optimize over large distance */
-		if (q > MESSAGE_BUF / 2)
-			continue;
-
-		/* Access the old string */
-		old = &message__buf[message__ptr[i]];
-
-		/* Compare */
-		if (!streq(old, str))
-			continue;
-
-		/* Get the next message index, advance */
-		x = message__next++;
-
-		/* Handle wrap */
-		if (message__next == MESSAGE_MAX)
-			message__next = 0;
-
-		/* Kill last message if needed */
-		if (message__next == message__last)
-			message__last++;
-
-		/* Handle wrap */
-		if (message__last == MESSAGE_MAX)
-			message__last = 0;
+		/* Count it */
+		m_ptr->count += n;
+		m_ptr->turn = turn;
 
-		/* Assign the starting address */
-		message__ptr[x] = message__ptr[i];
-		message__pty[x] = message__pty[i];
-
-		/* Success */
 		return;
 	}
 
+	/* Take the oldest record */
+	m_ptr = &message__list[message__count & (MESSAGE_MAX - 1)];
+	message__count++;
 
-	/*** Step 3 -- Ensure space before end of buffer ***/
-
-	/* Kill messages and Wrap if needed */
-	if (message__head + n + 1 >= MESSAGE_BUF)
-	{
-		/* Kill all "dead" messages */
-		for (i = message__last; TRUE; i++)
-		{
-			/* Wrap if needed */
-			if (i == MESSAGE_MAX)
-				i = 0;
-
-			/* Stop before the new message */
-			if (i == message__next)
-				break;
-
-			/* Kill "dead" messages */
-			if (message__ptr[i] >= message__head)
-			{
-				/* Track oldest message */
-				message__last = i + 1;
-			}
-		}
-
-		/* Wrap "tail" if needed */
-		if (message__tail >= message__head)
-			message__tail = 0;
-
-		/* Start over */
-		message__head = 0;
-	}
-
-
-	/*** Step 4 -- Ensure space before next message ***/
-
-	/* Kill messages if needed */
-	if (message__head + n + 1 > message__tail)
-	{
-		/* Grab new "tail" */
-		message__tail = message__head + n + 1;
-
-		/* Advance tail while possible past first "nul" */
-		while (message__buf[message__tail - 1])
-			message__tail++;
-
-		/* Kill all "dead" messages */
-		for (i = message__last; TRUE; i++)
-		{
-			/* Wrap if needed */
-			if (i == MESSAGE_MAX)
-				i = 0;
-
-			/* Stop before the new message */
-			if (i == message__next)
-				break;
-
-			/* Kill "dead" messages */
-			if ((message__ptr[i] >= message__head) &&
-				(message__ptr[i] < message__tail))
-			{
-				/* Track oldest message */
-				message__last = i + 1;
-			}
-		}
-	}
-
-
-	/*** Step 5 -- Grab a new message index ***/
-
-	/* Get the next message index, advance */
-	x = message__next++;
-
-	/* Handle wrap */
-	if (message__next == MESSAGE_MAX)
-		message__next = 0;
-
-	/* Kill last message if needed */
-	if (message__next == message__last)
-		message__last++;
-
-	/* Handle wrap */
-	if (message__last == MESSAGE_MAX)
-		message__last = 0;
-
-
-
-	/*** Step 6 -- Insert the message text ***/
-
-	/* Assign the starting address */
-	message__ptr[x] = message__head;
-	message__pty[x] = prior;
-
-	/* Append the new part of the message */
-	for (i = 0; i < n; i++)
-	{
-		/* Copy the message */
-		message__buf[message__head + i] = str[i];
-	}
-
-	/* Terminate */
-	message__buf[message__head + i] = '\0';
+	/* Keep the message */
+	strnfmt(m_ptr->text, MESSAGE_LEN, "%s", str);
+	m_ptr->prior = prior;
+	m_ptr->count = n;
+	m_ptr->turn = turn;
+}
 
-	/* Advance the "head" pointer */
-	message__head += n + 1;
+/*
+ * Add a new message
+ */
+void message_add(cptr str, byte prior)
+{
+	message_add_count(str, prior, 1);
 }
 
 
@@ -2391,7 +2542,7 @@ void msg_print(cptr msg)
 void mprint(byte priority, cptr msg)
 {
 	static int p = 0;
-	if (arg_headless && msg) { printf("%s\n", msg); }
+	if (arg_headless && !arg_fast && msg) { printf("%s\n", msg); }
 
 
 	int n;
@@ -2439,6 +2590,10 @@ void mprint(byte priority, cptr msg)
 	if (character_generated)
 		message_add(msg, priority);
 
+	/* Nobody is watching (see "--fast") */
+	if (arg_fast)
+		return;
+
 
 	/* Copy it */
 	strcpy(buf, msg);
@@ -2806,22 +2961,15 @@ void clear_from(int row)
 
 static int complete_command(char *buf, int clen, int mlen)
 {
-	int i;
+	u32b n;
 
-	for (i = 0; i < MAX_COMMANDS && cli_info[i].comm1; i++)
-	{
-		if (cli_info[i].comm2)
-		{
-			if (!strncmp(buf, cli_info[i].comm2, clen))
-			{
-				strncpy(buf, cli_info[i].comm2, mlen);
-			}
-		}
+	buf[clen] = '\0';
 
-		if (!strncmp(buf, cli_info[i].comm1, clen))
-		{
-			strncpy(buf, cli_info[i].comm1, mlen);
-		}
+	n = key_tree_find(cli__node, buf);
+
+	if (n)
+	{
+		strncpy(buf, cli_name(cli__node[n].first), mlen);
 	}
 
 	return strlen(buf) + 1;
@@ -3230,6 +3378,15 @@ void request_command(bool shopping)
 
 	if (arg_headless)
 	{
+		/* A bot plays (see "observe.c") */
+		if (observe_command()) return;
+
+		/* Benchmarks play a script */
+		if (bench_command()) return;
+
+		/* Guided fuzzing */
+		if (fuzz_command()) return;
+
 		p_ptr->command_cmd = get_fuzz_command();
 		p_ptr->command_dir = 0;
 		return;
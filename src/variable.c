@@ -54,6 +54,11 @@ bool arg_fiddle; /* Command arg -- Request fiddle mode */
 bool arg_wizard; /* Command arg -- Request wizard mode */
 bool arg_headless; /* Command arg -- Request headless mode */
 int arg_headless_turns; /* Command arg -- Number of turns to run in headless mode */
+bool arg_fast; /* Command arg -- Nobody watches the headless game */
+bool arg_startup_profile; /* Command arg -- Report the time of each startup step */
+bool arg_metrics_binary; /* Command arg -- Write metrics in the binary format */
+int arg_metrics_rss_msec = METRIC_RSS_MSEC; /* Command arg -- How often to sample memory use */
+u32b arg_seed; /* Command arg -- Seed the game with this, if not zero */
 bool arg_sound;	/* Command arg -- Request special sounds */
 bool arg_graphics; /* Command arg -- Request graphics mode */
 bool arg_force_original; /* Command arg -- Request original keyset */
@@ -86,6 +91,8 @@ s32b turn; /* Current game turn */
 s32b old_turn; /* Hack -- Level feeling counter */
 
 s32b old_resting_turn; /* Hack -- Resting turn counter */
+u16b disturb_why;	/* Reasons for the last disturbances */
+s32b disturb_turn;	/* Game turn of "disturb_why" */
 
 bool use_sound;	/* The "sound" mode is enabled */
 bool use_graphics; /* The "graphics" mode is enabled */
@@ -103,6 +110,8 @@ s16b coin_type;	/* Hack -- force coin type */
 
 bool opening_chest;	/* Hack -- prevent chest generation */
 
+bool hold_stuff;	/* Hack -- let "handle_stuff()" wait (see "process_world()") */
+
 bool shimmer_monsters; /* Hack -- optimize multi-hued monsters */
 bool shimmer_objects; /* Hack -- optimize multi-hued objects */
 
@@ -111,12 +120,6 @@ bool repair_mflag_nice;	/* Hack -- repair monster flags (nice) */
 bool repair_mflag_show;	/* Hack -- repair monster flags (show) */
 bool repair_mflag_mark;	/* Hack -- repair monster flags (mark) */
 
-s16b o_max = 1;	/* Number of allocated objects */
-s16b o_cnt = 0;	/* Number of live objects */
-
-s16b m_max = 1;	/* Number of allocated monsters */
-s16b m_cnt = 0;	/* Number of live monsters */
-
 s16b m_pet_num = 0;	/* Number of pets that are active at this time */
 
 s16b m_generators = 0; /* Number of monster generators */
@@ -155,9 +158,7 @@ int crushing_cy; /* Crushing trap center Y */
 int crushing_cx; /* Crushing trap center X */
 int crushing_dist; /* Crushing trap current distance */
 
-s16b tome_decipher_turns = 0; /* Turns until tome is deciphered */
 u32b lore_known = 0; /* Bitfield of known lore */
-s16b tome_decipher_idx = 0; /* Index of lore being deciphered */
 
 /*
  * Player info
@@ -194,72 +195,139 @@ s16b temp_n;
 s16b temp_y[TEMP_MAX];
 s16b temp_x[TEMP_MAX];
 
+/*
+ * Array of "environment-active" grids (burning oil, etc)
+ */
+s32b env_active_n;
+s16b env_active_y[ENV_ACTIVE_MAX];
+s16b env_active_x[ENV_ACTIVE_MAX];
 
 /*
- * Number of active macros.
+ * Array of grids with notable features (doors, stairs, traps, etc)
  */
-s16b macro__num;
+s32b note_grid_n;
+s16b note_grid_y[NOTE_GRID_MAX];
+s16b note_grid_x[NOTE_GRID_MAX];
 
 /*
- * Array of macro patterns [MACRO_MAX]
+ * Array of shifting maze walls ("CAVE_ACTIVE" grids)
  */
-cptr *macro__pat;
+s16b active_wall_n;
+s16b active_wall_y[ACTIVE_WALL_MAX];
+s16b active_wall_x[ACTIVE_WALL_MAX];
 
 /*
- * Array of macro actions [MACRO_MAX]
+ * Array of rolling boulders ("FEAT_BOULDER_N" to "FEAT_BOULDER_W" grids)
  */
-cptr *macro__act;
+s16b boulder_n;
+s16b boulder_y[BOULDER_MAX];
+s16b boulder_x[BOULDER_MAX];
 
 /*
- * Array of macro types [MACRO_MAX]
+ * Array of sealed sanctum doors ("FEAT_SANCTUM_DOOR" grids), and whether
+ * there were more of them than it holds
  */
-bool *macro__cmd;
+s16b sanctum_door_n;
+s16b sanctum_door_y[SANCTUM_DOOR_MAX];
+s16b sanctum_door_x[SANCTUM_DOOR_MAX];
+bool sanctum_door_full;
 
 /*
- * The number of quarks
+ * Array of dark maze sectors
  */
-s16b quark__num;
+s16b dark_sector_n;
+dark_sector dark_sectors[DARK_SECTOR_MAX];
 
 /*
- * The pointers to the quarks [QUARK_MAX]
+ * Terrain epoch, bumped whenever a grid changes in a way which might
+ * affect line of sight or projection (see "los()")
  */
-cptr *quark__str;
+u32b terrain_epoch = 1;
+
+/*
+ * Number of magnetism and gravity traps on the level
+ */
+s32b magnet_trap_n;
+s32b gravity_trap_n;
+
+/*
+ * Number of objects (in "o_list" and the home) which may be recharging,
+ * at least as many as are (the world tick only looks at them if any are)
+ */
+s32b object_charging_n;
+
+/*
+ * Time (in microseconds) and turns spent on monsters, by tier
+ */
+u32b mon_tier_full_us;
+u32b mon_tier_full_n;
+u32b mon_tier_dormant_us;
+u32b mon_tier_dormant_n;
+
+/*
+ * Line of sight cache statistics
+ */
+u32b sight_cache_hits;
+u32b sight_cache_misses;
 
+/*
+ * Bumped whenever the set of legal monsters may change for reasons
+ * other than the level (hooks, uniques coming and going)
+ */
+u32b mon_alloc_epoch = 1;
 
 /*
- * The next "free" index to use
+ * Allocation table cache statistics
  */
-u16b message__next;
+u32b alloc_cache_hits;
+u32b alloc_cache_misses;
+
 
 /*
- * The index of the oldest message (none yet)
+ * Number of active macros.
  */
-u16b message__last;
+s16b macro__num;
 
 /*
- * The next "free" offset
+ * Array of macro patterns [MACRO_MAX]
  */
-u16b message__head;
+cptr *macro__pat;
 
 /*
- * The offset to the oldest used char (none yet)
+ * Array of macro actions [MACRO_MAX]
  */
-u16b message__tail;
+cptr *macro__act;
 
 /*
- * The array of offsets, by index [MESSAGE_MAX]
+ * Array of macro types [MACRO_MAX]
  */
-u16b *message__ptr;
+bool *macro__cmd;
 
 /*
- * An array of message priorities, corresponds to ``message__ptr''
+ * The number of quarks
  */
-byte *message__pty;
+s16b quark__num;
 
 /*
- * The array of chars, by offset [MESSAGE_BUF]
+ * The pointers to the quarks [QUARK_MAX]
  */
-char *message__buf;
+cptr *quark__str;
+
+
+/*
+ * Count of messages ever added (the next goes at this, in the ring)
+ */
+u32b message__count;
+
+/*
+ * Count of changes to the messages (to notice new ones cheaply)
+ */
+u32b message__stamp;
+
+/*
+ * The ring of messages [MESSAGE_MAX]
+ */
+message_type *message__list;
 
 
 /*
@@ -338,85 +406,17 @@ char angband_sound_name[SOUND_MAX][16] = {
 };
 
 
-#ifdef MONSTER_FLOW
-
-/*
- * The array of cave grid flow "cost" values
- */
-s16b cave_cost[DUNGEON_HGT][DUNGEON_WID];
-
-/*
- * The array of cave grid flow "when" stamps
- */
-s16b cave_when[DUNGEON_HGT][DUNGEON_WID];
-
-#endif /* MONSTER_FLOW */
-
-/*
- * The array of cave grids
- */
-cave_type cave[DUNGEON_HGT][DUNGEON_WID];
-
-/*
- * The array of cave grid elevation levels
- */
-s16b cave_elev[DUNGEON_HGT][DUNGEON_WID];
-
 /*
- * The array of cave grid info flags
+ * The grids and the monster and object lists of the game, kept here
+ * unless another game is switched to (see "game_switch()")
  */
-u16b cave_info[DUNGEON_HGT][DUNGEON_WID];
+static game_type game_body = { 1, 0, 1, 0, DUNGEON_HGT, DUNGEON_WID };
 
 /*
- * The array of cave grid sector types
+ * The current game
  */
-byte cave_sector[DUNGEON_HGT][DUNGEON_WID];
+game_type *game_ptr = &game_body;
 
-/*
- * The array of cave grid feature codes
- */
-byte cave_feat[DUNGEON_HGT][DUNGEON_WID];
-
-/*
- * The array of cave cover data
- */
-cover_data *cave_cover[DUNGEON_HGT][DUNGEON_WID];
-
-
-/*
- * The array of cave grid object indexes
- *
- * This array gives a pointer to the object in the o_list.
- */
-object_type *cave_o_idx[DUNGEON_HGT][DUNGEON_WID];
-
-/*
- * The array of cave grid monster indexes
- *
- * Note that this array yields the index of the monster or player in a grid,
- * where negative numbers are used to represent the player, positive numbers
- * are used to represent a monster, and zero is used to indicate "nobody".
- * This array replicates the information contained in the monster list and
- * the player structure, but provides extremely fast determination of which,
- * if any, monster or player is in any given grid.
- */
-s16b cave_m_idx[DUNGEON_HGT][DUNGEON_WID];
-
-
-/*
- * The linked list of dungeon objects
- */
-object_type *o_list = NULL;
-
-/*
- * The array of dungeon monsters
- */
-monster_type m_list[MAX_M_IDX];
-
-/*
- * The array of guard data
- */
-monster_guard_data *m_guard[MAX_M_IDX];
 
 /*
  * The array of monster generators
@@ -489,6 +489,11 @@ object_type *inventory = NULL;
  */
 object_type *equipment[EQUIP_MAX];
 
+/*
+ * The inventory may hold something yet to be sensed (see "sense_inventory()")
+ */
+bool inven_unsensed = TRUE;
+
 
 /*
  * The size of "alloc_kind_table" (at most MAX_K_IDX * 4)
@@ -19,6 +19,48 @@
  */
 static FILE *fff = NULL;
 
+/*
+ * The CSV file being written alongside it, if any (see "spoil_all()")
+ */
+static FILE *spoil_csv = NULL;
+
+/*
+ * Making every spoiler file at once (so there is nobody to tell)
+ */
+static bool spoil_batch = FALSE;
+
+
+/*
+ * Say how making a spoiler file went
+ */
+static void spoil_note(cptr msg)
+{
+	if (spoil_batch)
+	{
+		printf("%s\n", msg);
+		return;
+	}
+
+	msg_print(msg);
+}
+
+
+/*
+ * Write a string to the CSV file, quoted
+ */
+static void spoil_csv_str(cptr str)
+{
+	putc('"', spoil_csv);
+
+	for (; *str; str++)
+	{
+		if (*str == '"') putc('"', spoil_csv);
+		putc(*str, spoil_csv);
+	}
+
+	putc('"', spoil_csv);
+}
+
 
 
 /*
@@ -252,6 +294,8 @@ static void spoil_obj_desc(cptr fname)
 	int i, k, s, t, n = 0;
 
 	u16b who[200];
+	int lev[200];
+	s32b val[200];
 
 	char buf[1024];
 
@@ -271,7 +315,7 @@ static void spoil_obj_desc(cptr fname)
 	/* Oops */
 	if (!fff)
 	{
-		msg_print("Cannot create spoiler file.");
+		spoil_note("Cannot create spoiler file.");
 		return;
 	}
 
@@ -292,30 +336,32 @@ static void spoil_obj_desc(cptr fname)
 		/* Write out the group title */
 		if (group_item[i].name)
 		{
-			/* Hack -- bubble-sort by cost and then level */
-			for (s = 0; s < n - 1; s++)
+			/* Get the level and cost of each kind, once */
+			for (s = 0; s < n; s++)
 			{
-				for (t = 0; t < n - 1; t++)
-				{
-					int i1 = t;
-					int i2 = t + 1;
-
-					int e1;
-					int e2;
+				kind_info(NULL, NULL, NULL, &lev[s], &val[s], who[s]);
+			}
 
-					s32b t1;
-					s32b t2;
+			/* Hack -- insertion-sort by cost and then level */
+			for (s = 1; s < n; s++)
+			{
+				u16b k_idx = who[s];
+				int e = lev[s];
+				s32b v = val[s];
 
-					kind_info(NULL, NULL, NULL, &e1, &t1, who[i1]);
-					kind_info(NULL, NULL, NULL, &e2, &t2, who[i2]);
+				for (t = s; t > 0; t--)
+				{
+					if ((val[t - 1] < v) || ((val[t - 1] == v) && (lev[t - 1] <= e)))
+						break;
 
-					if ((t1 > t2) || ((t1 == t2) && (e1 > e2)))
-					{
-						int tmp = who[i1];
-						who[i1] = who[i2];
-						who[i2] = tmp;
-					}
+					who[t] = who[t - 1];
+					lev[t] = lev[t - 1];
+					val[t] = val[t - 1];
 				}
+
+				who[t] = k_idx;
+				lev[t] = e;
+				val[t] = v;
 			}
 
 			/* Spoil each item */
@@ -330,6 +376,18 @@ static void spoil_obj_desc(cptr fname)
 				/* Dump it */
 				fprintf(fff, "     %-45s%8s%7s%5d%9ld\n", buf, dam, wgt, e,
 					(long) (v));
+
+				/* Dump it for tools */
+				if (spoil_csv)
+				{
+					object_kind *k_ptr = &k_info[who[s]];
+
+					fprintf(spoil_csv, "%d,%d,%d,", who[s], k_ptr->tval,
+						k_ptr->sval);
+					spoil_csv_str(buf);
+					fprintf(spoil_csv, ",%s,%d,%d,%ld\n", dam,
+						k_ptr->weight, e, (long) (v));
+				}
 			}
 
 			/* Start a new set */
@@ -365,12 +423,12 @@ static void spoil_obj_desc(cptr fname)
 	/* Check for errors */
 	if (ferror(fff) || my_fclose(fff))
 	{
-		msg_print("Cannot close spoiler file.");
+		spoil_note("Cannot close spoiler file.");
 		return;
 	}
 
 	/* Message */
-	msg_print("Successfully created a spoiler file.");
+	spoil_note("Successfully created a spoiler file.");
 }
 
 
@@ -1226,7 +1284,7 @@ static void spoil_artifact(cptr fname)
 	/* Oops */
 	if (!fff)
 	{
-		msg_print("Cannot create spoiler file.");
+		spoil_note("Cannot create spoiler file.");
 		return;
 	}
 
@@ -1274,12 +1332,12 @@ static void spoil_artifact(cptr fname)
 	/* Check for errors */
 	if (ferror(fff) || my_fclose(fff))
 	{
-		msg_print("Cannot close spoiler file.");
+		spoil_note("Cannot close spoiler file.");
 		return;
 	}
 
 	/* Message */
-	msg_print("Successfully created a spoiler file.");
+	spoil_note("Successfully created a spoiler file.");
 }
 
 
@@ -1318,7 +1376,7 @@ static void spoil_mon_desc(cptr fname)
 	/* Oops */
 	if (!fff)
 	{
-		msg_print("Cannot create spoiler file.");
+		spoil_note("Cannot create spoiler file.");
 		return;
 	}
 
@@ -1407,6 +1465,22 @@ static void spoil_mon_desc(cptr fname)
 		/* Dump the info */
 		fprintf(fff, "%-40.40s%4s%4s%6s%8s%4s  %11.11s\n", nam, lev, rar,
 			spd, hp, ac, exp);
+
+		/* Dump it for tools */
+		if (spoil_csv)
+		{
+			fprintf(spoil_csv, "%d,", who[i]);
+			spoil_csv_str(name);
+			fprintf(spoil_csv, ",%d,%d,%d,%d,%d,%s,%d,%ld,",
+				(r_ptr->flags1 & (RF1_UNIQUE)) ? 1 : 0,
+				(r_ptr->flags1 & (RF1_QUESTOR)) ? 1 : 0, r_ptr->level,
+				r_ptr->rarity, r_ptr->speed - 110, hp, r_ptr->ac,
+				(long) (r_ptr->mexp));
+			fprintf(spoil_csv, "%s,", attr_to_text(r_ptr->d_attr));
+			sprintf(buf, "%c", r_ptr->d_char);
+			spoil_csv_str(buf);
+			fprintf(spoil_csv, "\n");
+		}
 	}
 
 	/* End it */
@@ -1416,12 +1490,12 @@ static void spoil_mon_desc(cptr fname)
 	/* Check for errors */
 	if (ferror(fff) || my_fclose(fff))
 	{
-		msg_print("Cannot close spoiler file.");
+		spoil_note("Cannot close spoiler file.");
 		return;
 	}
 
 	/* Worked */
-	msg_print("Successfully created a spoiler file.");
+	spoil_note("Successfully created a spoiler file.");
 }
 
 
@@ -1542,7 +1616,7 @@ static void spoil_mon_info(cptr fname)
 	/* Oops */
 	if (!fff)
 	{
-		msg_print("Cannot create spoiler file.");
+		spoil_note("Cannot create spoiler file.");
 		return;
 	}
 
@@ -2598,11 +2672,11 @@ static void spoil_mon_info(cptr fname)
 	/* Check for errors */
 	if (ferror(fff) || my_fclose(fff))
 	{
-		msg_print("Cannot close spoiler file.");
+		spoil_note("Cannot close spoiler file.");
 		return;
 	}
 
-	msg_print("Successfully created a spoiler file.");
+	spoil_note("Successfully created a spoiler file.");
 }
 
 
@@ -2610,6 +2684,70 @@ static void spoil_mon_info(cptr fname)
 
 
 
+/*
+ * Start the CSV file "fname" (in the "user" directory) with "header"
+ */
+static void spoil_csv_open(cptr fname, cptr header)
+{
+	char buf[1024];
+
+	path_build(buf, 1024, ANGBAND_DIR_USER, fname);
+
+	spoil_csv = my_fopen(buf, "w");
+
+	if (!spoil_csv)
+	{
+		spoil_note("Cannot create CSV file.");
+		return;
+	}
+
+	fprintf(spoil_csv, "%s\n", header);
+}
+
+
+/*
+ * Finish the CSV file
+ */
+static void spoil_csv_close(void)
+{
+	if (!spoil_csv) return;
+
+	if (ferror(spoil_csv) || my_fclose(spoil_csv))
+		spoil_note("Cannot close CSV file.");
+
+	spoil_csv = NULL;
+}
+
+
+/*
+ * Create every spoiler file, without asking (the "--spoilers" option)
+ *
+ * The brief object and monster lists are also written as CSV files
+ * ("obj-desc.csv" and "mon-desc.csv"), with a line for each kind or race
+ * and the numbers as numbers, for tools to read.
+ */
+void spoil_all(void)
+{
+	spoil_batch = TRUE;
+
+	spoil_csv_open("obj-desc.csv",
+		"k_idx,tval,sval,name,dam_ac,weight,level,cost");
+	spoil_obj_desc("obj-desc.spo");
+	spoil_csv_close();
+
+	spoil_artifact("artifact.spo");
+
+	spoil_csv_open("mon-desc.csv",
+		"r_idx,name,unique,quest,level,rarity,speed,hp,ac,exp,attr,char");
+	spoil_mon_desc("mon-desc.spo");
+	spoil_csv_close();
+
+	spoil_mon_info("mon-info.spo");
+
+	spoil_batch = FALSE;
+}
+
+
 /*
  * Forward declare
  */
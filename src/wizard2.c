@@ -1329,6 +1329,126 @@ static void do_cmd_wiz_unhide(int d)
 }
 
 
+/*
+ * Show the census of the memory (see "memory_census()")
+ *
+ * A pool which is nearly full is marked with a "!".
+ */
+static void do_cmd_wiz_census(void)
+{
+	census_type census[CENSUS_PARTS];
+	long total = 0L;
+	int i, full;
+
+	full = memory_census(census);
+
+	screen_save();
+	Term_clear();
+
+	prt(format("%-10s %12s %8s %8s", "Part", "Bytes", "Used", "Slots"), 1, 0);
+
+	for (i = 0; i < CENSUS_PARTS; i++)
+	{
+		census_type *c_ptr = &census[i];
+
+		total += c_ptr->bytes;
+
+		if (!c_ptr->max)
+		{
+			prt(format("%-10s %12ld", c_ptr->name, c_ptr->bytes), 3 + i, 0);
+			continue;
+		}
+
+		prt(format("%-10s %12ld %8ld %8ld %s", c_ptr->name, c_ptr->bytes,
+			c_ptr->used, c_ptr->max,
+			(c_ptr->used * 100 >= c_ptr->max * CENSUS_PRESSURE) ? "!" : ""),
+			3 + i, 0);
+	}
+
+	prt(format("%-10s %12ld", "total", total), 4 + CENSUS_PARTS, 0);
+
+	prt(format("Resident: %ld kB.  Pools nearly full: %d.",
+		get_current_rss_kb(), full), 6 + CENSUS_PARTS, 0);
+
+	prt("[Press any key to continue]", 8 + CENSUS_PARTS, 0);
+	(void)inkey();
+
+	screen_load();
+}
+
+
+/*
+ * Show the memory live under each tag (see "z-virt.h"), and then the
+ * census
+ */
+static void do_cmd_wiz_memory(void)
+{
+#ifdef VIRT_TRACK
+
+	s32b live, slabs;
+	int i;
+
+	screen_save();
+	Term_clear();
+
+	prt(format("%-10s %12s %8s %12s %10s", "Tag", "Live bytes", "Blocks",
+		"Peak bytes", "Made"), 1, 0);
+
+	for (i = 0; i < MEM_TAGS; i++)
+	{
+		virt_count *v_ptr = &virt_counts[i];
+
+		prt(format("%-10s %12lu %8lu %12lu %10lu", mem_tag_names[i],
+			(unsigned long)v_ptr->bytes, (unsigned long)v_ptr->live,
+			(unsigned long)v_ptr->peak, (unsigned long)v_ptr->made), 3 + i, 0);
+	}
+
+	prt(format("%-10s %12lu %8lu %12lu %10lu", "total",
+		(unsigned long)virt_total.bytes, (unsigned long)virt_total.live,
+		(unsigned long)virt_total.peak, (unsigned long)virt_total.made),
+		4 + MEM_TAGS, 0);
+
+	object_pool_stats(&live, &slabs);
+
+	prt(format("Objects: %ld in use, %ld slabs of %d.", (long)live,
+		(long)slabs, OBJECT_SLAB), 6 + MEM_TAGS, 0);
+
+	prt("[Press any key to continue]", 8 + MEM_TAGS, 0);
+	(void)inkey();
+
+	screen_load();
+
+#endif /* VIRT_TRACK */
+
+	do_cmd_wiz_census();
+}
+
+
+/*
+ * Start the sampling profiler, or stop it and write out the samples
+ * (see "prof.c")
+ */
+static void do_cmd_wiz_profile(void)
+{
+	u32b n;
+
+	if (!prof_running())
+	{
+		prof_start(0);
+
+		if (prof_running()) msg_print("The profiler is running.");
+		else msg_print("There is no profiler on this system.");
+
+		return;
+	}
+
+	n = prof_stop();
+
+	msg_format("Wrote %lu samples (%lu lost) to kamband_prof.folded.",
+		(unsigned long)n, (unsigned long)prof_lost_samples());
+}
+
+
 
 #ifdef ALLOW_SPOILERS
 
@@ -1356,7 +1476,6 @@ void do_cmd_debug(void)
 {
 	int py = p_ptr->py;
 	int px = p_ptr->px;
-	int x, y; /* -KMW- */
 	char tmp_str[80]; /* -KMW- */
 
 	char cmd;
@@ -1571,13 +1690,7 @@ void do_cmd_debug(void)
 			/* Make every dungeon square "known" to test streamers -KMW- */
 		case 'r':
 		{
-			for (y = 0; y < DUNGEON_HGT; y++)
-			{
-				for (x = 0; x < DUNGEON_WID; x++)
-				{
-					cave_info[y][x] |= (CAVE_GLOW | CAVE_MARK);
-				}
-			}
+			cave_info_set_all(CAVE_GLOW | CAVE_MARK);
 			wiz_lite();
 			break;
 		}
@@ -1725,6 +1838,20 @@ void do_cmd_debug(void)
 			transmute_spell(TRUE);
 			break;
 		}
+
+			/* Memory */
+		case 'K':
+		{
+			do_cmd_wiz_memory();
+			break;
+		}
+
+			/* Sampling profiler */
+		case 'Z':
+		{
+			do_cmd_wiz_profile();
+			break;
+		}
 			/* Hack */
 		case '_':
 		{
@@ -353,7 +353,7 @@ static void prt_sp(void)
  */
 static void prt_sane(void)
 {
-	char tmp[5];
+	char tmp[32];
 	byte color;
 	int perc;
 
@@ -1118,9 +1118,20 @@ static void fix_player(void)
 
 
 
+/*
+ * What each window showed when messages were last drawn in it (the
+ * message count plus one, and the window size), or zero if unknown
+ */
+static u32b window_message_stamp[8];
+static int window_message_size[8];
+
+
 /*
  * Hack -- display recent messages in sub-windows
  *
+ * Windows which show nothing but messages are skipped when no message
+ * has arrived since they were drawn.
+ *
  * XXX XXX XXX Adjust for width and split messages
  */
 static void fix_message(void)
@@ -1148,6 +1159,19 @@ static void fix_message(void)
 		/* Get size */
 		Term_get_size(&w, &h);
 
+		/* Nothing new */
+		if ((op_ptr->window_flag[j] == PW_MESSAGE) &&
+			(window_message_stamp[j] == message__stamp + 1) &&
+			(window_message_size[j] == w * 256 + h))
+		{
+			Term_activate(old);
+			continue;
+		}
+
+		/* Remember what is shown */
+		window_message_stamp[j] = message__stamp + 1;
+		window_message_size[j] = w * 256 + h;
+
 		/* Dump messages */
 		for (i = 0; i < h; i++)
 		{
@@ -1217,12 +1241,55 @@ static void fix_overhead(void)
 }
 
 
+/*
+ * What each window showed when monster recall was last drawn in it (a
+ * stamp of the race and what is known about it, and the window size)
+ */
+static u32b window_monster_stamp[8];
+static int window_monster_size[8];
+
+
+/*
+ * Stamp the recall of a monster race, so that unchanged lore need not
+ * be described again.  Never zero.
+ */
+static u32b monster_recall_stamp(int r_idx)
+{
+	monster_race *r_ptr = &r_info[r_idx];
+
+	/* Everything roff_aux() takes from the memory, from r_sights on */
+	byte *lore = (byte *) &r_ptr->r_sights;
+	byte *end = (byte *) (&r_ptr->r_flags7 + 1);
+
+	u32b stamp = 2166136261UL;
+
+	/* The race, and what else changes the description */
+	stamp = (stamp ^ r_idx) * 16777619UL;
+	stamp = (stamp ^ p_ptr->lev) * 16777619UL;
+	stamp = (stamp ^ (cheat_know ? 1 : 0)) * 16777619UL;
+	stamp = (stamp ^ r_ptr->max_num) * 16777619UL;
+	stamp = (stamp ^ r_ptr->x_attr) * 16777619UL;
+	stamp = (stamp ^ (byte) r_ptr->x_char) * 16777619UL;
+
+	/* The remembered facts */
+	while (lore < end) stamp = (stamp ^ *lore++) * 16777619UL;
+
+	return (stamp ? stamp : 1);
+}
+
+
 /*
  * Hack -- display monster recall in sub-windows
  */
 static void fix_monster(void)
 {
-	int j;
+	int j, w, h;
+
+	u32b stamp = 0;
+
+	/* Stamp the recall once for all windows */
+	if (p_ptr->monster_race_idx)
+		stamp = monster_recall_stamp(p_ptr->monster_race_idx);
 
 	/* Scan windows */
 	for (j = 0; j < 8; j++)
@@ -1240,6 +1307,22 @@ static void fix_monster(void)
 		/* Activate */
 		Term_activate(angband_term[j]);
 
+		/* Get size */
+		Term_get_size(&w, &h);
+
+		/* Nothing new */
+		if ((op_ptr->window_flag[j] == PW_MONSTER) &&
+			(window_monster_stamp[j] == stamp) &&
+			(window_monster_size[j] == w * 256 + h))
+		{
+			Term_activate(old);
+			continue;
+		}
+
+		/* Remember what is shown */
+		window_monster_stamp[j] = stamp;
+		window_monster_size[j] = w * 256 + h;
+
 		/* Display monster race info */
 		if (p_ptr->monster_race_idx)
 			display_roff(p_ptr->monster_race_idx);
@@ -4423,20 +4506,26 @@ void update_stuff(void)
 	if (p_ptr->update & (PU_VIEW))
 	{
 		p_ptr->update &= ~(PU_VIEW);
+		metric_start(METRIC_T_UPDATE_VIEW);
 		update_view();
+		metric_stop(METRIC_T_UPDATE_VIEW);
 	}
 
 	if (p_ptr->update & (PU_LITE))
 	{
 		p_ptr->update &= ~(PU_LITE);
+		metric_start(METRIC_T_UPDATE_LITE);
 		update_lite();
+		metric_stop(METRIC_T_UPDATE_LITE);
 	}
 
 
 	if (p_ptr->update & (PU_FLOW))
 	{
 		p_ptr->update &= ~(PU_FLOW);
+		metric_start(METRIC_T_UPDATE_FLOW);
 		update_flow();
+		metric_stop(METRIC_T_UPDATE_FLOW);
 	}
 
 
@@ -4444,13 +4533,17 @@ void update_stuff(void)
 	{
 		p_ptr->update &= ~(PU_DISTANCE);
 		p_ptr->update &= ~(PU_MONSTERS);
+		metric_start(METRIC_T_UPDATE_MONSTERS);
 		update_monsters(TRUE);
+		metric_stop(METRIC_T_UPDATE_MONSTERS);
 	}
 
 	if (p_ptr->update & (PU_MONSTERS))
 	{
 		p_ptr->update &= ~(PU_MONSTERS);
+		metric_start(METRIC_T_UPDATE_MONSTERS);
 		update_monsters(FALSE);
+		metric_stop(METRIC_T_UPDATE_MONSTERS);
 	}
 }
 
@@ -4465,6 +4558,11 @@ void redraw_stuff(void)
 		return;
 
 
+	/* The whole map may have changed (see "observe.c") */
+	if (p_ptr->redraw & (PR_MAP))
+		observe_note_map();
+
+
 	/* Character is not ready yet, no screen updates */
 	if (!character_generated)
 		return;
@@ -4475,6 +4573,13 @@ void redraw_stuff(void)
 		return;
 
 
+	/* Nobody is watching (see "--fast") */
+	if (arg_fast)
+	{
+		p_ptr->redraw = 0L;
+		return;
+	}
+
 
 	/* Hack -- clear the screen */
 	if (p_ptr->redraw & (PR_WIPE))
@@ -4658,6 +4763,59 @@ void redraw_stuff(void)
 	}
 }
 
+/*
+ * When each kind of subwindow was last drawn (see "msec_clock()")
+ */
+static u32b window_drawn[32];
+
+/*
+ * Kinds of subwindow held back by the rate limit
+ */
+static u32b window_held = 0L;
+
+/*
+ * Ignore the rate limit
+ */
+static bool window_hurry = FALSE;
+
+/*
+ * The window flags seen last time
+ */
+static u32b window_flag_seen[8];
+
+
+/*
+ * Is it too soon to draw the subwindows showing "flag" again?
+ *
+ * Combat and running set the inventory, character and recall flags
+ * nearly every game turn, so those windows are drawn at most
+ * WINDOW_MAX_FPS times a second.  Anything held back stays in
+ * "p_ptr->window" for a later call, and "window_stuff_flush()" catches
+ * up before the game waits for a key.
+ */
+static bool window_too_soon(u32b flag)
+{
+	u32b now = msec_clock();
+	int n = 0;
+
+	/* Find the bit */
+	while (!(flag & (1L << n))) n++;
+
+	/* Hold it back */
+	if (!window_hurry && (now - window_drawn[n] < 1000L / WINDOW_MAX_FPS))
+	{
+		window_held |= flag;
+		return (TRUE);
+	}
+
+	/* Draw it now */
+	window_drawn[n] = now;
+	window_held &= ~flag;
+
+	return (FALSE);
+}
+
+
 /*
  * Handle "p_ptr->window"
  */
@@ -4672,6 +4830,13 @@ void window_stuff(void)
 	if (!p_ptr->window)
 		return;
 
+	/* Nobody is watching (see "--fast") */
+	if (arg_fast)
+	{
+		p_ptr->window = 0L;
+		return;
+	}
+
 	/* Scan windows */
 	for (j = 0; j < 8; j++)
 	{
@@ -4681,6 +4846,15 @@ void window_stuff(void)
 			/* Build the mask */
 			mask |= op_ptr->window_flag[j];
 		}
+
+		/* Forget what a window showed if its contents are changed */
+		if (op_ptr->window_flag[j] != window_flag_seen[j])
+		{
+			window_flag_seen[j] = op_ptr->window_flag[j];
+			window_message_stamp[j] = 0;
+			window_monster_stamp[j] = 0;
+			window_monster_size[j] = 0;
+		}
 	}
 
 	/* Apply usable flags */
@@ -4692,28 +4866,28 @@ void window_stuff(void)
 
 
 	/* Display inventory */
-	if (p_ptr->window & (PW_INVEN))
+	if ((p_ptr->window & (PW_INVEN)) && !window_too_soon(PW_INVEN))
 	{
 		p_ptr->window &= ~(PW_INVEN);
 		fix_inven();
 	}
 
 	/* Display equipment */
-	if (p_ptr->window & (PW_EQUIP))
+	if ((p_ptr->window & (PW_EQUIP)) && !window_too_soon(PW_EQUIP))
 	{
 		p_ptr->window &= ~(PW_EQUIP);
 		fix_equip();
 	}
 
 	/* Display pflags */
-	if (p_ptr->window & (PW_SPELL))
+	if ((p_ptr->window & (PW_SPELL)) && !window_too_soon(PW_SPELL))
 	{
 		p_ptr->window &= ~(PW_SPELL);
 		fix_pflags();
 	}
 
 	/* Display player */
-	if (p_ptr->window & (PW_PLAYER))
+	if ((p_ptr->window & (PW_PLAYER)) && !window_too_soon(PW_PLAYER))
 	{
 		p_ptr->window &= ~(PW_PLAYER);
 		fix_player();
@@ -4727,14 +4901,14 @@ void window_stuff(void)
 	}
 
 	/* Display overhead view */
-	if (p_ptr->window & (PW_OVERHEAD))
+	if ((p_ptr->window & (PW_OVERHEAD)) && !window_too_soon(PW_OVERHEAD))
 	{
 		p_ptr->window &= ~(PW_OVERHEAD);
 		fix_overhead();
 	}
 
 	/* Display monster recall */
-	if (p_ptr->window & (PW_MONSTER))
+	if ((p_ptr->window & (PW_MONSTER)) && !window_too_soon(PW_MONSTER))
 	{
 		p_ptr->window &= ~(PW_MONSTER);
 		fix_monster();
@@ -4749,11 +4923,42 @@ void window_stuff(void)
 }
 
 
+/*
+ * Draw any subwindows held back by the rate limit (see "inkey()")
+ */
+void window_stuff_flush(void)
+{
+	u32b other;
+
+	/* Nothing held back */
+	if (!(p_ptr->window & window_held))
+		return;
+
+	/* Only do the held back windows */
+	other = (p_ptr->window & ~(window_held));
+	p_ptr->window &= window_held;
+
+	/* Draw them now */
+	window_hurry = TRUE;
+	window_stuff();
+	window_hurry = FALSE;
+
+	/* Leave the rest for later */
+	p_ptr->window |= other;
+}
+
+
 /*
  * Handle "p_ptr->update" and "p_ptr->redraw" and "p_ptr->window"
  */
 void handle_stuff(void)
 {
+	/* Hack -- wait for the rest of the batch */
+	if (hold_stuff)
+		return;
+
+	metric_start(METRIC_T_HANDLE_STUFF);
+
 	/* Update stuff */
 	if (p_ptr->update)
 		update_stuff();
@@ -4765,4 +4970,6 @@ void handle_stuff(void)
 	/* Window stuff */
 	if (p_ptr->window)
 		window_stuff();
+
+	metric_stop(METRIC_T_HANDLE_STUFF);
 }
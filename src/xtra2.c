@@ -62,7 +62,7 @@ bool set_blind(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Forget stuff */
 	p_ptr->update |= (PU_UN_VIEW | PU_UN_LITE);
@@ -129,7 +129,7 @@ bool set_confused(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Redraw the "confused" */
 	p_ptr->redraw |= (PR_CONFUSED);
@@ -181,7 +181,7 @@ bool set_poisoned(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Redraw the "poisoned" */
 	p_ptr->redraw |= (PR_POISONED);
@@ -321,7 +321,7 @@ bool set_shape(byte shape, int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Handle stuff */
 	p_ptr->update |= (PU_BONUS | PU_MANA | PU_SPELLS | PU_HP | PU_SANITY);
@@ -335,11 +335,19 @@ bool set_shape(byte shape, int v)
 
 /*
  * Set "p_ptr->grace", notice observable changes
+ *
+ * The bonuses only depend on the standing it gives (see
+ * "interpret_grace()"), so they are recalculated only when that changes,
+ * not every time the grace drifts (as it does every 50 game turns).
  */
 void set_grace(s32b v)
 {
+	int old = interpret_grace();
+
 	p_ptr->grace = v;
-	p_ptr->update |= PU_BONUS;
+
+	if (interpret_grace() != old) p_ptr->update |= PU_BONUS;
+
 	handle_stuff();
 }
 
@@ -382,7 +390,7 @@ bool set_afraid(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Redraw the "afraid" */
 	p_ptr->redraw |= (PR_AFRAID);
@@ -434,7 +442,7 @@ bool set_paralyzed(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Redraw the state */
 	p_ptr->redraw |= (PR_STATE);
@@ -488,7 +496,7 @@ bool set_image(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Redraw map */
 	p_ptr->redraw |= (PR_MAP);
@@ -546,7 +554,7 @@ bool set_fast(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -598,7 +606,7 @@ bool set_slow(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -650,7 +658,7 @@ bool set_shield(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -703,7 +711,7 @@ bool set_blessed(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -755,7 +763,7 @@ bool set_hero(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -807,7 +815,7 @@ bool set_shero(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -859,7 +867,7 @@ bool set_protevil(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Handle stuff */
 	handle_stuff();
@@ -908,7 +916,7 @@ bool set_invuln(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -960,7 +968,7 @@ bool set_tim_invis(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -1015,7 +1023,7 @@ bool set_tim_infra(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -1070,7 +1078,7 @@ bool set_oppose_acid(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Handle stuff */
 	handle_stuff();
@@ -1119,7 +1127,7 @@ bool set_oppose_elec(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Handle stuff */
 	handle_stuff();
@@ -1168,7 +1176,7 @@ bool set_oppose_fire(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Handle stuff */
 	handle_stuff();
@@ -1217,7 +1225,7 @@ bool set_oppose_cold(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Handle stuff */
 	handle_stuff();
@@ -1266,7 +1274,7 @@ bool set_oppose_pois(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Handle stuff */
 	handle_stuff();
@@ -1381,7 +1389,7 @@ bool set_stun(int v)
 			{
 				msg_print("You are no longer stunned.");
 				if (disturb_state)
-					disturb(0, 0);
+					disturb(0, DISTURB_STATUS);
 				break;
 			}
 		}
@@ -1399,7 +1407,7 @@ bool set_stun(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -1596,7 +1604,7 @@ bool set_cut(int v)
 			{
 				msg_print("You are no longer bleeding.");
 				if (disturb_state)
-					disturb(0, 0);
+					disturb(0, DISTURB_STATUS);
 				break;
 			}
 		}
@@ -1614,7 +1622,7 @@ bool set_cut(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -1834,7 +1842,7 @@ bool set_food(int v)
 
 	/* Disturb */
 	if (disturb_state)
-		disturb(0, 0);
+		disturb(0, DISTURB_STATUS);
 
 	/* Recalculate bonuses */
 	p_ptr->update |= (PU_BONUS);
@@ -2150,6 +2158,9 @@ void monster_death(int m_idx)
 	object_type *o_ptr;
 	object_type *q_ptr;
 
+	/* Let the script look at the monster */
+	script_on_monster_death(m_idx);
+
 	/* Get the location */
 	y = m_ptr->fy;
 	x = m_ptr->fx;
@@ -2397,16 +2408,18 @@ bool mon_take_hit(int m_idx, int dam, bool * fear, cptr note,
 		/* 50% chance to alert nearby monsters */
 		if (!m_ptr->is_pet && (rand_int(100) < 50))
 		{
-			int i;
-			for (i = 1; i < m_max; i++)
-			{
-				monster_type *other = &m_list[i];
+			s16b who[MAX_M_IDX];
+			int i, n;
 
-				/* Skip dead monsters */
-				if (!other->r_idx) continue;
+			/* Only the monsters within reach */
+			n = monster_near(m_ptr->fy, m_ptr->fx, 5, who, MAX_M_IDX);
+
+			for (i = 0; i < n; i++)
+			{
+				monster_type *other = &m_list[who[i]];
 
 				/* Skip self */
-				if (i == m_idx) continue;
+				if (who[i] == m_idx) continue;
 
 				/* Skip pets */
 				if (other->is_pet) continue;
@@ -2414,14 +2427,10 @@ bool mon_take_hit(int m_idx, int dam, bool * fear, cptr note,
 				/* Skip if already awake */
 				if (!other->csleep) continue;
 
-				/* Check distance */
-				if (distance(m_ptr->fy, m_ptr->fx, other->fy, other->fx) <= 5)
+				/* Check LOS */
+				if (los(m_ptr->fy, m_ptr->fx, other->fy, other->fx))
 				{
-					/* Check LOS */
-					if (los(m_ptr->fy, m_ptr->fx, other->fy, other->fx))
-					{
-						other->csleep = 0;
-					}
+					other->csleep = 0;
 				}
 			}
 		}
@@ -2633,8 +2642,13 @@ bool mon_take_hit(int m_idx, int dam, bool * fear, cptr note,
 
 		/* When the player kills a Unique, it stays dead */
 		if (r_ptr->flags1 & (RF1_UNIQUE))
+		{
 			r_ptr->max_num = 0;
 
+			/* The unique is no longer legal */
+			mon_alloc_epoch++;
+		}
+
 		/* Recall even invisible uniques or winners */
 		if (m_ptr->ml || (r_ptr->flags1 & (RF1_UNIQUE)))
 		{
@@ -2830,6 +2844,9 @@ void verify_panel(void)
 	int py = p_ptr->py;
 	int px = p_ptr->px;
 
+	int old_wy = p_ptr->wy;
+	int old_wx = p_ptr->wx;
+
 	int i;
 
 	bool scroll = FALSE;
@@ -2934,8 +2951,12 @@ void verify_panel(void)
 		/* Update stuff */
 		p_ptr->update |= (PU_MONSTERS);
 
-		/* Redraw map */
-		p_ptr->redraw |= (PR_MAP);
+		/* Scroll the map, or redraw it if it is not on the screen as it was */
+		if ((p_ptr->redraw & (PR_MAP)) ||
+			!prt_map_scroll(p_ptr->wy - old_wy, p_ptr->wx - old_wx))
+		{
+			p_ptr->redraw |= (PR_MAP);
+		}
 
 		/* Window stuff */
 		p_ptr->window |= (PW_OVERHEAD);
@@ -2997,60 +3018,126 @@ cptr look_mon_desc(int m_idx)
 
 
 /*
- * Angband sorting algorithm -- quick sort in place
+ * Sorting helper -- is "a" strictly before "b"?
+ */
+static bool ang_sort_less(vptr u, vptr v, int a, int b)
+{
+	return (!(*ang_sort_comp) (u, v, b, a));
+}
+
+
+/*
+ * Sorting helper -- sift the element at "i" down the heap "p" to "q"
+ */
+static void ang_sort_sift(vptr u, vptr v, int p, int q, int i)
+{
+	while (TRUE)
+	{
+		int c = p + 2 * (i - p) + 1;
+
+		/* No children */
+		if (c > q) return;
+
+		/* The larger child */
+		if ((c < q) && ang_sort_less(u, v, c, c + 1)) c++;
+
+		/* In place */
+		if (!ang_sort_less(u, v, i, c)) return;
+
+		(*ang_sort_swap) (u, v, i, c);
+		i = c;
+	}
+}
+
+
+/*
+ * Angband sorting algorithm -- introspective sort in place
+ *
+ * A quick sort, with the median of three as the pivot, which turns to a
+ * heap sort once it has split a range "depth" times (so that no input
+ * is quadratic), and leaves each short range to an insertion sort.
  *
  * Note that the details of the data we are sorting is hidden,
  * and we rely on the "ang_sort_comp()" and "ang_sort_swap()"
  * function hooks to interact with the data, which is given as
  * two pointers, and which may have any user-defined form.
  */
-void ang_sort_aux(vptr u, vptr v, int p, int q)
+void ang_sort_aux(vptr u, vptr v, int p, int q, int depth)
 {
-	int z, a, b;
+	int i, j, m;
 
-	/* Done sort */
-	if (p >= q)
-		return;
+	while (q - p >= ANG_SORT_SHORT)
+	{
+		/* Too deep -- heap sort */
+		if (depth-- <= 0)
+		{
+			for (i = p + (q - p - 1) / 2; i >= p; i--)
+				ang_sort_sift(u, v, p, q, i);
 
-	/* Pivot */
-	z = p;
+			for (i = q; i > p; i--)
+			{
+				(*ang_sort_swap) (u, v, p, i);
+				ang_sort_sift(u, v, p, i - 1, p);
+			}
 
-	/* Begin */
-	a = p;
-	b = q;
+			return;
+		}
 
-	/* Partition */
-	while (TRUE)
-	{
-		/* Slide i2 */
-		while (!(*ang_sort_comp) (u, v, b, z))
-			b--;
+		/* Order the first, middle, and last */
+		m = p + (q - p) / 2;
+		if (ang_sort_less(u, v, m, p)) (*ang_sort_swap) (u, v, m, p);
+		if (ang_sort_less(u, v, q, m)) (*ang_sort_swap) (u, v, q, m);
+		if (ang_sort_less(u, v, m, p)) (*ang_sort_swap) (u, v, m, p);
 
-		/* Slide i1 */
-		while (!(*ang_sort_comp) (u, v, z, a))
-			a++;
+		/* The median is the pivot, kept at "p" */
+		(*ang_sort_swap) (u, v, p, m);
 
-		/* Done partition */
-		if (a >= b)
-			break;
+		/* Partition (equal elements stop both sides) */
+		i = p;
+		j = q + 1;
+
+		while (TRUE)
+		{
+			while (ang_sort_less(u, v, ++i, p))
+				if (i == q) break;
 
-		/* Swap */
-		(*ang_sort_swap) (u, v, a, b);
+			while (ang_sort_less(u, v, p, --j))
+				/* Nothing */ ;
 
-		/* Advance */
-		a++, b--;
-	}
+			if (i >= j) break;
 
-	/* Recurse left side */
-	ang_sort_aux(u, v, p, b);
+			(*ang_sort_swap) (u, v, i, j);
+		}
+
+		/* Put the pivot between the sides */
+		(*ang_sort_swap) (u, v, p, j);
+
+		/* Recurse on the smaller side, and loop on the larger */
+		if (j - p < q - j)
+		{
+			ang_sort_aux(u, v, p, j - 1, depth);
+			p = j + 1;
+		}
+		else
+		{
+			ang_sort_aux(u, v, j + 1, q, depth);
+			q = j - 1;
+		}
+	}
 
-	/* Recurse right side */
-	ang_sort_aux(u, v, b + 1, q);
+	/* Insertion sort */
+	for (i = p + 1; i <= q; i++)
+	{
+		for (j = i; (j > p) && ang_sort_less(u, v, j, j - 1); j--)
+		{
+			(*ang_sort_swap) (u, v, j, j - 1);
+		}
+	}
 }
 
 
 /*
- * Angband sorting algorithm -- quick sort in place
+ * Angband sorting algorithm -- introspective sort in place
  *
  * Note that the details of the data we are sorting is hidden,
  * and we rely on the "ang_sort_comp()" and "ang_sort_swap()"
@@ -3059,8 +3146,13 @@ void ang_sort_aux(vptr u, vptr v, int p, int q)
  */
 void ang_sort(vptr u, vptr v, int n)
 {
+	int depth = 0, k;
+
+	/* Allow twice the splits a perfect quick sort would need */
+	for (k = n; k > 1; k >>= 1) depth += 2;
+
 	/* Sort the array */
-	ang_sort_aux(u, v, 0, n - 1);
+	ang_sort_aux(u, v, 0, n - 1, depth);
 }
 
 
@@ -3251,75 +3343,6 @@ bool target_okay(void)
 
 
 
-/*
- * Sorting hook -- comp function -- by "distance to player"
- *
- * We use "u" and "v" to point to arrays of "x" and "y" positions,
- * and sort the arrays by double-distance to the player.
- */
-static bool ang_sort_comp_distance(vptr u, vptr v, int a, int b)
-{
-	int py = p_ptr->py;
-	int px = p_ptr->px;
-
-	s16b *x = (s16b *) (u);
-	s16b *y = (s16b *) (v);
-
-	int da, db, kx, ky;
-
-	/* Absolute distance components */
-	kx = x[a];
-	kx -= px;
-	kx = ABS(kx);
-	ky = y[a];
-	ky -= py;
-	ky = ABS(ky);
-
-	/* Approximate Double Distance to the first point */
-	da = ((kx > ky) ? (kx + kx + ky) : (ky + ky + kx));
-
-	/* Absolute distance components */
-	kx = x[b];
-	kx -= px;
-	kx = ABS(kx);
-	ky = y[b];
-	ky -= py;
-	ky = ABS(ky);
-
-	/* Approximate Double Distance to the first point */
-	db = ((kx > ky) ? (kx + kx + ky) : (ky + ky + kx));
-
-	/* Compare the distances */
-	return (da <= db);
-}
-
-
-/*
- * Sorting hook -- swap function -- by "distance to player"
- *
- * We use "u" and "v" to point to arrays of "x" and "y" positions,
- * and sort the arrays by distance to the player.
- */
-static void ang_sort_swap_distance(vptr u, vptr v, int a, int b)
-{
-	s16b *x = (s16b *) (u);
-	s16b *y = (s16b *) (v);
-
-	s16b temp;
-
-	/* Swap "x" */
-	temp = x[a];
-	x[a] = x[b];
-	x[b] = temp;
-
-	/* Swap "y" */
-	temp = y[a];
-	y[a] = y[b];
-	y[b] = temp;
-}
-
-
-
 /*
  * Hack -- help "select" a location (see below)
  */
@@ -3415,119 +3438,200 @@ static bool target_set_accept(int y, int x)
 	}
 
 	/* Interesting memorized features */
-	if (cave_info[y][x] & (CAVE_MARK))
+	if ((cave_info[y][x] & (CAVE_MARK)) && feat_notable(cave_feat[y][x]))
+		return (TRUE);
+
+	/* Nope */
+	return (FALSE);
+}
+
+
+/*
+ * Sort the "temp" array by distance to the player, then by row, then by
+ * column (so that grids as far away come in the order of a scan).
+ *
+ * The distance, row, and column of each grid are packed into one key,
+ * and the keys are put in order a byte at a time (a radix sort, which
+ * skips the bytes which are the same in every key).  The grids are read
+ * back out of the keys.
+ */
+static void temp_sort_distance(void)
+{
+	static u32b key[TEMP_MAX];
+	static u32b tmp[TEMP_MAX];
+
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+
+	u32b *from = key, *to = tmp, *swap;
+	int count[256];
+	int i, shift;
+
+	for (i = 0; i < temp_n; i++)
 	{
-		/* Notice glyphs */
-		if (cave_feat[y][x] == FEAT_GLYPH)
-			return (TRUE);
+		int kx = ABS(temp_x[i] - px);
+		int ky = ABS(temp_y[i] - py);
 
-		/* Notice doors */
-		if (cave_feat[y][x] == FEAT_OPEN)
-			return (TRUE);
-		if (cave_feat[y][x] == FEAT_BROKEN)
-			return (TRUE);
+		/* Approximate Double Distance */
+		u32b d = ((kx > ky) ? (kx + kx + ky) : (ky + ky + kx));
 
-		/* Notice stairs */
-		if (cave_feat[y][x] == FEAT_LESS)
-			return (TRUE);
-		if (cave_feat[y][x] == FEAT_MORE)
-			return (TRUE);
+		key[i] = (d << 18) | ((u32b)temp_y[i] << 9) | (u32b)temp_x[i];
+	}
 
-		/* Notice shops */
-		if ((cave_feat[y][x] >= FEAT_SHOP_HEAD &&
-				cave_feat[y][x] <= FEAT_SHOP_TAIL) ||
-			cave_feat[y][x] == FEAT_STORE_EXIT) return (TRUE);
+	for (shift = 0; shift < 32; shift += 8)
+	{
+		int total = 0;
 
-		/* Notice shafts. */
-		if (cave_feat[y][x] == FEAT_SHAFT)
-			return (TRUE);
+		for (i = 0; i < 256; i++) count[i] = 0;
 
-		/* Notice buildings -KMW- */
-		if ((cave_feat[y][x] >= FEAT_BLDG_HEAD) &&
-			(cave_feat[y][x] <= FEAT_BLDG_TAIL)) return (TRUE);
+		for (i = 0; i < temp_n; i++) count[(from[i] >> shift) & 0xFF]++;
 
-		/* Notice traps */
-		if ((cave_feat[y][x] >= FEAT_TRAP_HEAD) &&
-			(cave_feat[y][x] <= FEAT_TRAP_TAIL)) return (TRUE);
+		/* Every key has this byte */
+		if (!temp_n || (count[(from[0] >> shift) & 0xFF] == temp_n)) continue;
 
-		/* Notice doors */
-		if ((cave_feat[y][x] >= FEAT_DOOR_HEAD) &&
-			(cave_feat[y][x] <= FEAT_DOOR_TAIL)) return (TRUE);
+		/* Where each byte starts */
+		for (i = 0; i < 256; i++)
+		{
+			int n = count[i];
 
-		/* Notice rubble */
-		if (cave_feat[y][x] == FEAT_RUBBLE)
-			return (TRUE);
+			count[i] = total;
+			total += n;
+		}
 
-		/* Notice veins with treasure */
-		if (cave_feat[y][x] == FEAT_MAGMA_K)
-			return (TRUE);
-		if (cave_feat[y][x] == FEAT_QUARTZ_K)
-			return (TRUE);
+		for (i = 0; i < temp_n; i++) to[count[(from[i] >> shift) & 0xFF]++] = from[i];
 
-		/* Notice altars. */
-		if (cave_feat[y][x] >= FEAT_ALTAR_HEAD &&
-			cave_feat[y][x] <= FEAT_ALTAR_TAIL) return TRUE;
+		swap = from;
+		from = to;
+		to = swap;
+	}
 
+	for (i = 0; i < temp_n; i++)
+	{
+		temp_y[i] = (s16b)((from[i] >> 9) & 0x1FF);
+		temp_x[i] = (s16b)(from[i] & 0x1FF);
 	}
+}
 
-	/* Nope */
-	return (FALSE);
+
+/*
+ * Add the grid "y,x" to the "temp" array, if "target_set" would stop there
+ *
+ * Grids in the array are marked with CAVE_TEMP, so that a grid reached
+ * twice (a monster standing on an object) is only added once.
+ */
+static void target_set_consider(int y, int x, int mode)
+{
+	/* On the current panel */
+	if (!panel_contains(y, x))
+		return;
+
+	/* Already there */
+	if (cave_info[y][x] & (CAVE_TEMP))
+		return;
+
+	/* Require line of sight, unless "look" is "expanded" */
+	if (!expand_look && !player_has_los_bold(y, x))
+		return;
+
+	/* Require "interesting" contents */
+	if (!target_set_accept(y, x))
+		return;
+
+	/* Special mode */
+	if (mode & (TARGET_KILL))
+	{
+		/* Must contain a monster */
+		if (!(cave_m_idx[y][x] > 0))
+			return;
+
+		/* Must be a targettable monster */
+		if (!target_able(cave_m_idx[y][x]))
+			return;
+	}
+
+	/* Save the location */
+	if (temp_n < TEMP_MAX)
+	{
+		cave_info[y][x] |= (CAVE_TEMP);
+		temp_x[temp_n] = x;
+		temp_y[temp_n] = y;
+		temp_n++;
+	}
 }
 
 
 /*
  * Prepare the "temp" array for "target_set"
  *
- * Return the number of target_able monsters in the set.
+ * Only the grids which can be interesting are looked at: the player,
+ * the visible monsters, the memorized objects on the floor, and the
+ * grids of the notable-feature list (see "note_grid_add()").
  */
 static void target_set_prepare(int mode)
 {
-	int y, x;
+	object_type *o_ptr;
+	int i;
 
 	/* Reset "temp" array */
 	temp_n = 0;
 
-	/* Scan the current panel */
-	for (y = p_ptr->wy; y < p_ptr->wy + SCREEN_HGT; y++)
+	/* The player */
+	target_set_consider(p_ptr->py, p_ptr->px, mode);
+
+	/* Visible monsters */
+	for (i = 1; i < m_max; i++)
 	{
-		for (x = p_ptr->wx; x < p_ptr->wx + SCREEN_WID; x++)
-		{
-			/* Require line of sight, unless "look" is "expanded" */
-			if (!expand_look && !player_has_los_bold(y, x))
-				continue;
+		monster_type *m_ptr = &m_list[i];
 
-			/* Require "interesting" contents */
-			if (!target_set_accept(y, x))
-				continue;
+		/* Skip dead or unseen monsters */
+		if (!m_ptr->r_idx || !m_ptr->ml)
+			continue;
 
-			/* Special mode */
-			if (mode & (TARGET_KILL))
-			{
-				/* Must contain a monster */
-				if (!(cave_m_idx[y][x] > 0))
-					continue;
+		target_set_consider(m_ptr->fy, m_ptr->fx, mode);
+	}
 
-				/* Must be a targettable monster */
-				if (!target_able(cave_m_idx[y][x]))
-					continue;
-			}
+	/* Memorized objects */
+	for (o_ptr = o_list; o_ptr != NULL; o_ptr = o_ptr->next_global)
+	{
+		/* Skip dead and held objects */
+		if (!o_ptr->k_idx || (o_ptr->stack != STACK_FLOOR))
+			continue;
 
-			/* Save the location */
-			if (temp_n < TEMP_MAX)
-			{
-				temp_x[temp_n] = x;
-				temp_y[temp_n] = y;
-				temp_n++;
-			}
+		/* Skip unknown objects */
+		if (!o_ptr->marked)
+			continue;
+
+		target_set_consider(o_ptr->iy, o_ptr->ix, mode);
+	}
+
+	/* Notable features */
+	for (i = 0; i < note_grid_n; )
+	{
+		int y = note_grid_y[i];
+		int x = note_grid_x[i];
+
+		/* No longer notable -- forget it */
+		if (!feat_notable(cave_feat[y][x]))
+		{
+			cave_info[y][x] &= ~(CAVE_NOTE);
+			note_grid_n--;
+			note_grid_y[i] = note_grid_y[note_grid_n];
+			note_grid_x[i] = note_grid_x[note_grid_n];
+			continue;
 		}
+
+		target_set_consider(y, x, mode);
+		i++;
 	}
 
-	/* Set the sort hooks */
-	ang_sort_comp = ang_sort_comp_distance;
-	ang_sort_swap = ang_sort_swap_distance;
+	/* Forget the marks */
+	for (i = 0; i < temp_n; i++)
+	{
+		cave_info[temp_y[i]][temp_x[i]] &= ~(CAVE_TEMP);
+	}
 
 	/* Sort the positions */
-	ang_sort(temp_x, temp_y, temp_n);
+	temp_sort_distance();
 }
 
 
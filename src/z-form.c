@@ -16,6 +16,18 @@
 #include "z-virt.h"
 
 
+/*
+ * Hack -- compilers from before C99 may lack "va_copy()"
+ */
+#ifndef va_copy
+# ifdef __va_copy
+#  define va_copy(D, S)	__va_copy(D, S)
+# else
+#  define va_copy(D, S)	memcpy(&(D), &(S), sizeof(va_list))
+# endif
+#endif
+
+
 /*
  * Here is some information about the routines in this file.
  *
@@ -143,6 +155,11 @@
  * For example: "format("%^-.*s", i, txt)" will produce a string containing
  * the first "i" characters of "txt", left justified, with the first non-space
  * character capitilized, if reasonable.
+ *
+ * The commonest sequences, "%d", "%i", "%u", "%c" and "%s" with nothing
+ * but a "^" before them (or an "l" before the "d", "i" or "u"), are
+ * written straight into the buffer, without "sprintf()".  Only the rest
+ * are subject to the limitations above.
  */
 
 
@@ -182,6 +199,66 @@ static uint vstrnfmt_aux_dflt(char *buf, uint max, cptr fmt, vptr arg)
 static vstrnfmt_aux_func vstrnfmt_aux = vstrnfmt_aux_dflt;
 
 
+/*
+ * Append the string "str" to "buf" (which holds "n" chars, out of "max"),
+ * capitalizing its first non-space char if "cap" is set
+ *
+ * Returns the new length.
+ */
+static uint vstrnfmt_str(char *buf, uint n, uint max, cptr str, bool cap)
+{
+	for (; *str; str++)
+	{
+		/* Check total length */
+		if (n == max - 1)
+			break;
+
+		/* Save the character */
+		buf[n] = *str;
+
+		/* Capitalize the first non-space, if possible */
+		if (cap && !isspace(*str))
+		{
+			if (islower(*str))
+				buf[n] = toupper(*str);
+
+			cap = FALSE;
+		}
+
+		n++;
+	}
+
+	return (n);
+}
+
+
+/*
+ * Append the number "v" (in decimal, after a "-" if "neg" is set) to
+ * "buf" (which holds "n" chars, out of "max")
+ *
+ * Returns the new length.
+ */
+static uint vstrnfmt_num(char *buf, uint n, uint max, unsigned long v, bool neg)
+{
+	char tmp[32];
+	int i = 31;
+
+	tmp[i] = '\0';
+
+	do
+	{
+		tmp[--i] = (char)('0' + (v % 10));
+		v /= 10;
+	}
+	while (v);
+
+	if (neg)
+		tmp[--i] = '-';
+
+	return (vstrnfmt_str(buf, n, max, tmp + i, FALSE));
+}
+
+
 
 /*
  * Basic "vararg" format function.
@@ -344,6 +421,106 @@ uint vstrnfmt(char *buf, uint max, cptr fmt, va_list vp)
 		}
 
 
+		/* Fast path -- "%d", "%ld", "%u", "%lu", "%c", "%s", "%^s", etc */
+		if ((*s == 'd') || (*s == 'i') || (*s == 'u') || (*s == 'c') ||
+		    (*s == 's') || (*s == 'l') || (*s == '^'))
+		{
+			cptr t = s;
+
+			/* Capitalize, or not */
+			bool cap = FALSE;
+
+			/* Assume no "long" argument */
+			do_long = FALSE;
+
+			if (*t == '^')
+			{
+				cap = TRUE;
+				t++;
+			}
+
+			if (*t == 'l')
+			{
+				do_long = TRUE;
+				t++;
+			}
+
+			/* Signed Integers */
+			if ((*t == 'd') || (*t == 'i'))
+			{
+				long arg;
+
+				/* Access next argument */
+				if (do_long)
+					arg = va_arg(vp, long);
+				else
+					arg = va_arg(vp, int);
+
+				/* Append it (hack -- the "- 1" keeps LONG_MIN legal) */
+				if (arg < 0)
+					n = vstrnfmt_num(buf, n, max,
+					                 (unsigned long)(-(arg + 1)) + 1, TRUE);
+				else
+					n = vstrnfmt_num(buf, n, max, (unsigned long)arg, FALSE);
+
+				s = t + 1;
+				continue;
+			}
+
+			/* Unsigned Integers */
+			if (*t == 'u')
+			{
+				unsigned long arg;
+
+				/* Access next argument */
+				if (do_long)
+					arg = va_arg(vp, unsigned long);
+				else
+					arg = va_arg(vp, unsigned int);
+
+				/* Append it */
+				n = vstrnfmt_num(buf, n, max, arg, FALSE);
+
+				s = t + 1;
+				continue;
+			}
+
+			/* Simple Character */
+			if ((*t == 'c') && !do_long)
+			{
+				char tmp[2];
+
+				/* Access next argument */
+				tmp[0] = (char)va_arg(vp, int);
+				tmp[1] = '\0';
+
+				/* Append it */
+				n = vstrnfmt_str(buf, n, max, tmp, cap);
+
+				s = t + 1;
+				continue;
+			}
+
+			/* String */
+			if ((*t == 's') && !do_long)
+			{
+				cptr arg;
+
+				/* Access next argument */
+				arg = va_arg(vp, cptr);
+
+				/* Hack -- convert NULL to EMPTY */
+				if (arg)
+					n = vstrnfmt_str(buf, n, max, arg, cap);
+
+				s = t + 1;
+				continue;
+			}
+
+			/* Anything else takes the long way */
+		}
+
+
 		/* Begin the "aux" string */
 		q = 0;
 
@@ -685,9 +862,12 @@ char *vformat(cptr fmt, va_list vp)
 	while (1)
 	{
 		uint len;
+		va_list vq;
 
-		/* Build the string */
-		len = vstrnfmt(format_buf, format_len, fmt, vp);
+		/* Build the string (from the first argument, every time) */
+		va_copy(vq, vp);
+		len = vstrnfmt(format_buf, format_len, fmt, vq);
+		va_end(vq);
 
 		/* Success */
 		if (len < format_len - 1)
@@ -0,0 +1,244 @@
+/* File: z-pack.c */
+
+/* Purpose: Block compression for savefiles */
+
+#include "z-pack.h"
+
+#include "z-virt.h"
+
+
+/*
+ * Format of a sequence:
+ *
+ *   token   -- literal count in the high four bits, copy length minus
+ *              PACK_MIN_MATCH in the low four bits
+ *   [count] -- if a field of the token is 15, extra bytes follow which
+ *              are added to it, until one of them is less than 255
+ *   literal bytes
+ *   offset  -- two bytes, low byte first
+ *   [count] -- extra copy length, as above
+ *
+ * The last sequence stops after its literal bytes.
+ */
+
+
+/*
+ * Shortest copy worth encoding
+ */
+#define PACK_MIN_MATCH	4
+
+/*
+ * Longest offset which fits in a sequence
+ */
+#define PACK_MAX_OFFSET	65535
+
+/*
+ * Size of the table of recent positions
+ */
+#define PACK_HASH_BITS	12
+
+
+/*
+ * Most recent position (plus one) of each hashed group of four bytes
+ */
+static u32b pack_hash[1 << PACK_HASH_BITS];
+
+
+/*
+ * Read four bytes as a number
+ */
+static u32b pack_read32(const byte *p)
+{
+	return ((u32b)p[0] | ((u32b)p[1] << 8) | ((u32b)p[2] << 16) |
+		((u32b)p[3] << 24));
+}
+
+
+/*
+ * Hash four bytes into the table
+ */
+static int pack_hash_index(u32b v)
+{
+	return ((int)(((v * 2654435761UL) & 0xFFFFFFFFUL) >> (32 - PACK_HASH_BITS)));
+}
+
+
+/*
+ * Write the extra bytes of a long count
+ */
+static byte *pack_count(byte *dst, u32b n)
+{
+	while (n >= 255)
+	{
+		*dst++ = 255;
+		n -= 255;
+	}
+
+	*dst++ = (byte)n;
+
+	return (dst);
+}
+
+
+/*
+ * Write one sequence (a "len" of zero means no copy)
+ */
+static byte *pack_sequence(byte *dst, const byte *lit, u32b num, u32b off,
+	u32b len)
+{
+	u32b n = (len ? len - PACK_MIN_MATCH : 0);
+
+	*dst++ = (byte)(((num < 15) ? num : 15) << 4 | ((n < 15) ? n : 15));
+
+	if (num >= 15) dst = pack_count(dst, num - 15);
+
+	/* Copy the literal bytes */
+	(void)C_COPY(dst, lit, num, byte);
+	dst += num;
+
+	if (!len) return (dst);
+
+	*dst++ = (byte)(off & 0xFF);
+	*dst++ = (byte)(off >> 8);
+
+	if (n >= 15) dst = pack_count(dst, n - 15);
+
+	return (dst);
+}
+
+
+/*
+ * Pack "len" bytes from "src" into "dst", which must have room for
+ * PACK_BOUND(len) bytes.
+ *
+ * Returns the packed size.
+ */
+u32b pack_block(const byte *src, u32b len, byte *dst)
+{
+	u32b i = 0, anchor = 0;
+	byte *out = dst;
+
+	/* Forget earlier blocks */
+	(void)C_WIPE(pack_hash, 1 << PACK_HASH_BITS, u32b);
+
+	while (i + PACK_MIN_MATCH <= len)
+	{
+		u32b v = pack_read32(src + i);
+		int h = pack_hash_index(v);
+		u32b ref = pack_hash[h];
+
+		pack_hash[h] = i + 1;
+
+		/* Look for a copy of earlier bytes */
+		if (ref && (i - (ref - 1) <= PACK_MAX_OFFSET) &&
+			(pack_read32(src + ref - 1) == v))
+		{
+			u32b m = ref - 1;
+			u32b n = PACK_MIN_MATCH;
+
+			/* Extend it as far as possible */
+			while ((i + n < len) && (src[m + n] == src[i + n])) n++;
+
+			out = pack_sequence(out, src + anchor, i - anchor, i - m, n);
+
+			i += n;
+			anchor = i;
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	/* The rest are literal bytes */
+	out = pack_sequence(out, src + anchor, len - anchor, 0, 0);
+
+	return ((u32b)(out - dst));
+}
+
+
+/*
+ * Read the extra bytes of a long count
+ */
+static bool unpack_count(const byte **src, const byte *end, u32b *n)
+{
+	byte b;
+
+	do
+	{
+		if (*src >= end) return (FALSE);
+
+		b = *(*src)++;
+		*n += b;
+	}
+	while (b == 255);
+
+	return (TRUE);
+}
+
+
+/*
+ * Unpack "len" bytes from "src" into exactly "size" bytes at "dst".
+ *
+ * Returns -1 if the packed data is damaged.
+ */
+errr unpack_block(const byte *src, u32b len, byte *dst, u32b size)
+{
+	const byte *end = src + len;
+	u32b o = 0;
+
+	while (src < end)
+	{
+		byte t = *src++;
+		u32b n = t >> 4;
+		u32b off;
+
+		/* Literal bytes */
+		if ((n == 15) && !unpack_count(&src, end, &n)) return (-1);
+
+		if ((n > (u32b)(end - src)) || (n > size - o)) return (-1);
+
+		(void)C_COPY(dst + o, src, n, byte);
+		o += n;
+		src += n;
+
+		/* The last sequence */
+		if (src == end) break;
+
+		/* Copy of earlier bytes */
+		if (end - src < 2) return (-1);
+
+		off = (u32b)src[0] | ((u32b)src[1] << 8);
+		src += 2;
+
+		n = (t & 0x0F);
+		if ((n == 15) && !unpack_count(&src, end, &n)) return (-1);
+		n += PACK_MIN_MATCH;
+
+		if (!off || (off > o) || (n > size - o)) return (-1);
+
+		/* A run of one byte */
+		if (off == 1)
+		{
+			(void)memset(dst + o, dst[o - 1], n);
+			o += n;
+		}
+
+		/* Copy forwards, so that short offsets repeat */
+		else
+		{
+			/* Each pass may copy everything written so far */
+			while (n > 0)
+			{
+				u32b m = (n < off) ? n : off;
+
+				(void)C_COPY(dst + o, dst + o - off, m, byte);
+				o += m;
+				n -= m;
+				off += m;
+			}
+		}
+	}
+
+	return ((o == size) ? 0 : -1);
+}
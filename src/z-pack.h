@@ -0,0 +1,36 @@
+/* File: z-pack.h */
+
+#ifndef INCLUDED_Z_PACK_H
+#define INCLUDED_Z_PACK_H
+
+#include "h-basic.h"
+
+
+/*
+ * A small block compressor, used to pack the grid layers of savefiles.
+ *
+ * The packed form is a list of "sequences", each a run of literal bytes
+ * followed by a copy of earlier output (an offset back and a length).
+ * Long runs of one feature pack into a copy at offset one, and rows
+ * which look like the row above pack into copies at the map width.
+ */
+
+
+/**** Available constants ****/
+
+
+/*
+ * Largest possible packed size of "N" bytes
+ */
+#define PACK_BOUND(N) \
+	((N) + ((N) / 255) + 16)
+
+
+/**** Available Functions ****/
+
+
+extern u32b pack_block(const byte *src, u32b len, byte *dst);
+extern errr unpack_block(const byte *src, u32b len, byte *dst, u32b size);
+
+
+#endif
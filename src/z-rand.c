@@ -42,6 +42,14 @@
  * automatically used instead of the "complex" RNG, and when you are
  * done, you de-activate it via "Rand_quick = FALSE" or choose a new
  * seed via "Rand_value = seed".
+ *
+ * There are also "streams", each of which is a generator of its own
+ * ("xoshiro128**", which is fast, and has a period of 2^128 - 1), so that
+ * a part of the game can draw as many numbers as it likes without moving
+ * the others.  A stream is seeded from a number, or split off another
+ * stream (which then jumps 2^64 numbers ahead, so the two never overlap),
+ * and gives numbers from 0 to m-1 without bias.  While "Rand_stream"
+ * points at a stream, "rand_int()" and friends draw from it instead.
  */
 
 
@@ -75,6 +83,12 @@ u16b Rand_place;
 u32b Rand_state[RAND_DEG];
 
 
+/*
+ * The stream "rand_int()" draws from, if any
+ */
+rand_stream *Rand_stream = NULL;
+
+
 /* Period parameters */
 #define N 624
 #define M 397
@@ -101,14 +115,14 @@ static void init_genrand(unsigned long s)
     }
 }
 
-/* generates a random number on [0,0xffffffff]-interval */
-static unsigned long genrand_int32(void)
+/* generates the next N words of the table */
+static void genrand_refill(void)
 {
     unsigned long y;
     static unsigned long mag01[2]={0x0UL, MATRIX_A};
     /* mag01[x] = x * MATRIX_A  for x=0,1 */
 
-    if (mti >= N) { /* generate N words at one time */
+    { /* generate N words at one time */
         int kk;
 
         if (mti == N+1)   /* if init_genrand() has not been called, */
@@ -127,14 +141,25 @@ static unsigned long genrand_int32(void)
 
         mti = 0;
     }
+}
+
+/* Tempering */
+#define GENRAND_TEMPER(Y) \
+    ((Y) ^= ((Y) >> 11), \
+     (Y) ^= ((Y) << 7) & 0x9d2c5680UL, \
+     (Y) ^= ((Y) << 15) & 0xefc60000UL, \
+     (Y) ^= ((Y) >> 18))
+
+/* generates a random number on [0,0xffffffff]-interval */
+static unsigned long genrand_int32(void)
+{
+    unsigned long y;
+
+    if (mti >= N) genrand_refill();
 
     y = mt[mti++];
 
-    /* Tempering */
-    y ^= (y >> 11);
-    y ^= (y << 7) & 0x9d2c5680UL;
-    y ^= (y << 15) & 0xefc60000UL;
-    y ^= (y >> 18);
+    GENRAND_TEMPER(y);
 
     return y;
 }
@@ -143,6 +168,29 @@ void Rand_srand(u32b seed) {
 	init_genrand((unsigned long)seed);
 }
 
+/*
+ * Copy out the state of the generator behind "Rand_div()", the table
+ * and then the index (RAND_DIV_LEN numbers)
+ */
+void Rand_div_save(u32b *state)
+{
+	int i;
+
+	for (i = 0; i < N; i++) state[i] = (u32b)mt[i];
+	state[N] = (u32b)mti;
+}
+
+/*
+ * Restore a state saved by "Rand_div_save()"
+ */
+void Rand_div_load(const u32b *state)
+{
+	int i;
+
+	for (i = 0; i < N; i++) mt[i] = (unsigned long)state[i];
+	mti = (int)state[N];
+}
+
 
 /*
  * Initialize the "complex" RNG using a new seed
@@ -177,6 +225,137 @@ void Rand_state_init(u32b seed)
 }
 
 
+/*
+ * Scramble a number (so that close seeds give unrelated streams)
+ */
+static u32b Rand_mix(u32b x)
+{
+	x ^= x >> 16;
+	x = (x * 0x7feb352dUL) & 0xFFFFFFFFUL;
+	x ^= x >> 15;
+	x = (x * 0x846ca68bUL) & 0xFFFFFFFFUL;
+	x ^= x >> 16;
+
+	return (x);
+}
+
+
+/*
+ * Seed the stream "rs"
+ */
+void Rand_stream_seed(rand_stream *rs, u32b seed)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		seed = (seed + 0x9e3779b9UL) & 0xFFFFFFFFUL;
+		rs->s[i] = Rand_mix(seed);
+	}
+
+	/* Paranoia -- the one state it must not be in */
+	if (!(rs->s[0] | rs->s[1] | rs->s[2] | rs->s[3])) rs->s[0] = 1;
+}
+
+
+/*
+ * Rotate a 32 bit number left
+ */
+#define ROTL32(X, K) \
+	((((X) << (K)) | ((X) >> (32 - (K)))) & 0xFFFFFFFFUL)
+
+
+/*
+ * The next number (32 bits) of the stream "rs"
+ */
+u32b Rand_stream_next(rand_stream *rs)
+{
+	u32b *s = rs->s;
+	u32b r = (ROTL32((s[1] * 5) & 0xFFFFFFFFUL, 7) * 9) & 0xFFFFFFFFUL;
+	u32b t = (s[1] << 9) & 0xFFFFFFFFUL;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+
+	s[2] ^= t;
+	s[3] = ROTL32(s[3], 11);
+
+	return (r);
+}
+
+
+/*
+ * A number from 0 to m-1 of the stream "rs"
+ *
+ * The numbers below "2^32 mod m" are thrown back (rarely more than one
+ * of them), so that each result is as likely as any other.
+ */
+u32b Rand_stream_int(rand_stream *rs, u32b m)
+{
+	u32b least, r;
+
+	if (m <= 1) return (0);
+
+	/* That is, (2^32 - m) mod m */
+	least = ((0xFFFFFFFFUL - m) + 1) % m;
+
+	do
+	{
+		r = Rand_stream_next(rs);
+	}
+	while (r < least);
+
+	return (r % m);
+}
+
+
+/*
+ * Move the stream "rs" 2^64 numbers ahead
+ */
+void Rand_stream_jump(rand_stream *rs)
+{
+	static const u32b jump[4] =
+	{
+		0x8764000bUL, 0xf542d2d3UL, 0x6fa035c3UL, 0x77f2db5bUL
+	};
+
+	u32b s[4] = { 0, 0, 0, 0 };
+	int i, b, k;
+
+	for (i = 0; i < 4; i++)
+	{
+		for (b = 0; b < 32; b++)
+		{
+			if (jump[i] & (1UL << b))
+			{
+				for (k = 0; k < 4; k++) s[k] ^= rs->s[k];
+			}
+
+			(void)Rand_stream_next(rs);
+		}
+	}
+
+	for (k = 0; k < 4; k++) rs->s[k] = s[k];
+}
+
+
+/*
+ * Split the stream "child" off the stream "rs"
+ *
+ * The child takes the numbers "rs" would have given, and "rs" jumps past
+ * them, so two splits, or a split and its parent, never give the same
+ * numbers.
+ */
+void Rand_stream_split(rand_stream *rs, rand_stream *child)
+{
+	*child = *rs;
+
+	Rand_stream_jump(rs);
+}
+
+
 /*
  * Extract a "random" number from 0 to m-1, via "modulus"
  *
@@ -240,6 +419,9 @@ s32b Rand_div(s32b m)
 {
     if (m <= 1) return 0;
 
+    /* Use a stream */
+    if (Rand_stream) return (s32b)Rand_stream_int(Rand_stream, (u32b)m);
+
     /* Use standard library rand() with proper range */
     /* This avoids the infinite loop issue entirely */
     return genrand_int32() % m;
@@ -247,6 +429,58 @@ s32b Rand_div(s32b m)
 
 
 
+/*
+ * Fill "out" with "n" "random" numbers from 0 to m-1
+ *
+ * This gives just what "n" calls of "Rand_div()" would, but takes the
+ * numbers straight from the table of the generator, a stretch at a time.
+ */
+void Rand_div_fill(s32b *out, int n, s32b m)
+{
+	int i, k;
+
+	/* Hack -- simple case (nothing is drawn) */
+	if (m <= 1)
+	{
+		for (i = 0; i < n; i++) out[i] = 0;
+		return;
+	}
+
+	/* Use a stream */
+	if (Rand_stream)
+	{
+		for (i = 0; i < n; i++)
+		{
+			out[i] = (s32b)Rand_stream_int(Rand_stream, (u32b)m);
+		}
+
+		return;
+	}
+
+	while (n > 0)
+	{
+		if (mti >= N) genrand_refill();
+
+		/* The rest of the table, or as many as wanted */
+		k = MIN(n, N - mti);
+
+		for (i = 0; i < k; i++)
+		{
+			unsigned long y = mt[mti + i];
+
+			GENRAND_TEMPER(y);
+
+			out[i] = (s32b)(y % (unsigned long)m);
+		}
+
+		mti += k;
+		out += k;
+		n -= k;
+	}
+}
+
+
+
 /*
  * The number of entries in the "randnor_table"
  */
@@ -370,9 +604,26 @@ s16b randnor(int mean, int stand)
  */
 s16b damroll(int num, int sides)
 {
-	int i, sum = 0;
-	for (i = 0; i < num; i++)
-		sum += randint(sides);
+	s32b roll[64];
+	int i, k, sum = 0;
+
+	/* Hack -- nothing to roll */
+	if (sides <= 1)
+		return (MAX(num, 0));
+
+	/* Roll the dice, up to 64 at a time */
+	while (num > 0)
+	{
+		k = MIN(num, 64);
+
+		Rand_div_fill(roll, k, sides);
+
+		for (i = 0; i < k; i++)
+			sum += roll[i] + 1;
+
+		num -= k;
+	}
+
 	return (sum);
 }
 
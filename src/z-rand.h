@@ -24,6 +24,27 @@
  */
 #define RAND_DEG 63
 
+/*
+ * Size of the saved state of "Rand_div()" (see "Rand_div_save()")
+ */
+#define RAND_DIV_LEN 625
+
+
+
+
+/**** Available types ****/
+
+
+/*
+ * An independent stream of random numbers (see "Rand_stream_seed()")
+ */
+typedef struct rand_stream rand_stream;
+
+struct rand_stream
+{
+	u32b s[4];
+};
+
 
 
 
@@ -79,6 +100,7 @@ extern bool Rand_quick;
 extern u32b Rand_value;
 extern u16b Rand_place;
 extern u32b Rand_state[RAND_DEG];
+extern rand_stream *Rand_stream;
 
 
 /**** Available Functions ****/
@@ -87,6 +109,14 @@ extern u32b Rand_state[RAND_DEG];
 extern void Rand_state_init(u32b seed);
 extern s32b Rand_mod(s32b m);
 extern s32b Rand_div(s32b m);
+extern void Rand_div_fill(s32b *out, int n, s32b m);
+extern void Rand_div_save(u32b *state);
+extern void Rand_div_load(const u32b *state);
+extern void Rand_stream_seed(rand_stream *rs, u32b seed);
+extern u32b Rand_stream_next(rand_stream *rs);
+extern u32b Rand_stream_int(rand_stream *rs, u32b m);
+extern void Rand_stream_jump(rand_stream *rs);
+extern void Rand_stream_split(rand_stream *rs, rand_stream *child);
 extern s16b randnor(int mean, int stand);
 extern s16b damroll(int num, int sides);
 extern s16b maxroll(int num, int sides);
@@ -539,6 +539,250 @@ void Term_queue_chars(int x, int y, int n, byte a, cptr s)
 
 
 
+/*
+ * Move the contents of the rectangle of "w" by "h" grids at (x,y) in the
+ * requested image by "dx" columns and "dy" rows, as when a view of a map
+ * scrolls
+ *
+ * The grids the move uncovers keep what they held, for the caller to
+ * draw over.  Cosmetic glyphs in the rectangle move too (those which
+ * leave it are forgotten).
+ */
+errr Term_scroll(int x, int y, int w, int h, int dx, int dy)
+{
+	term_win *scr = Term->scr;
+
+	int j, n, i;
+
+	/* Verify the rectangle */
+	if ((x < 0) || (y < 0) || (w < 1) || (h < 1)) return (-1);
+	if ((x + w > Term->wid) || (y + h > Term->hgt)) return (-1);
+
+	/* Nothing stays in the rectangle */
+	if ((ABS(dx) >= w) || (ABS(dy) >= h)) return (1);
+
+	/* Grids of each row which stay in the rectangle */
+	n = w - ABS(dx);
+
+	/* Move the rows, taking each from the row it is moving from */
+	for (i = 0; i < h - ABS(dy); i++)
+	{
+		int from, to;
+
+		/* Moving down, start at the bottom */
+		j = (dy > 0) ? (h - 1 - i) : i;
+
+		to = y + j;
+		from = to - dy;
+
+		(void)memmove(&scr->a[to][x + MAX(dx, 0)],
+			&scr->a[from][x + MAX(-dx, 0)], n * sizeof(byte));
+		(void)memmove(&scr->c[to][x + MAX(dx, 0)],
+			&scr->c[from][x + MAX(-dx, 0)], n * sizeof(term_char));
+	}
+
+	/* Move the cosmetic glyphs */
+	for (i = Term->fx_num - 1; i >= 0; i--)
+	{
+		term_fx *fx_ptr = &Term->fx[i];
+
+		int fx = fx_ptr->x;
+		int fy = fx_ptr->y;
+
+		if ((fx < x) || (fx >= x + w) || (fy < y) || (fy >= y + h)) continue;
+
+		fx += dx;
+		fy += dy;
+
+		/* Forget it (the grid it was over is redrawn anyway) */
+		if ((fx < x) || (fx >= x + w) || (fy < y) || (fy >= y + h))
+		{
+			Term->fx[i] = Term->fx[--Term->fx_num];
+			continue;
+		}
+
+		fx_ptr->x = fx;
+		fx_ptr->y = fy;
+	}
+
+	/* The whole rectangle has changed */
+	for (j = y; j < y + h; j++)
+	{
+		if (x < Term->x1[j])
+			Term->x1[j] = x;
+		if (x + w - 1 > Term->x2[j])
+			Term->x2[j] = x + w - 1;
+	}
+
+	if (y < Term->y1)
+		Term->y1 = y;
+	if (y + h - 1 > Term->y2)
+		Term->y2 = y + h - 1;
+
+	/* Success */
+	return (0);
+}
+
+
+
+/*** Cosmetic glyphs ***/
+
+
+/*
+ * A cosmetic glyph ("Term_fx()") is shown over a grid for a few calls
+ * of "Term_fresh()", and then the grid shows what it holds again.  It is
+ * only put into the requested image while the screen is refreshed, so
+ * nothing which reads the screen ("Term_what()", "Term_save()") ever
+ * sees it, and whatever is drawn in the grid meanwhile is kept under it.
+ * Drawing one costs no output until the next refresh, where it goes out
+ * with everything else.
+ */
+
+
+/*
+ * Note that the grid (x,y) must be looked at by the next refresh
+ */
+static void Term_fx_touch(int x, int y)
+{
+	if (y < Term->y1)
+		Term->y1 = y;
+	if (y > Term->y2)
+		Term->y2 = y;
+
+	if (x < Term->x1[y])
+		Term->x1[y] = x;
+	if (x > Term->x2[y])
+		Term->x2[y] = x;
+}
+
+
+/*
+ * Show the attr/char (a,c) over the grid (x,y) for the next "life"
+ * refreshes, instead of (not as well as) any glyph shown there already
+ *
+ * Returns 1 if too many glyphs are being shown.
+ */
+errr Term_fx(int x, int y, byte a, term_char c, int life)
+{
+	term_fx *fx_ptr = NULL;
+	int i;
+
+	/* Verify location */
+	if ((x < 0) || (x >= Term->wid)) return (-1);
+	if ((y < 0) || (y >= Term->hgt)) return (-1);
+
+	/* Bound the life */
+	if (life < 1) life = 1;
+	if (life > 255) life = 255;
+
+	/* Replace the glyph over this grid */
+	for (i = 0; i < Term->fx_num; i++)
+	{
+		if ((Term->fx[i].x == x) && (Term->fx[i].y == y))
+		{
+			fx_ptr = &Term->fx[i];
+			break;
+		}
+	}
+
+	/* Or take a new one */
+	if (!fx_ptr)
+	{
+		if (Term->fx_num >= TERM_FX_MAX) return (1);
+
+		fx_ptr = &Term->fx[Term->fx_num++];
+
+		fx_ptr->x = x;
+		fx_ptr->y = y;
+	}
+
+	fx_ptr->a = a;
+	fx_ptr->c = c;
+	fx_ptr->life = life;
+
+	Term_fx_touch(x, y);
+
+	/* Success */
+	return (0);
+}
+
+
+/*
+ * Put the cosmetic glyphs into the requested image, for a refresh
+ */
+static void Term_fx_show(void)
+{
+	int i;
+
+	for (i = 0; i < Term->fx_num; i++)
+	{
+		term_fx *fx_ptr = &Term->fx[i];
+
+		int x = fx_ptr->x;
+		int y = fx_ptr->y;
+
+		/* Keep what the grid holds */
+		fx_ptr->hold_a = Term->scr->a[y][x];
+		fx_ptr->hold_c = Term->scr->c[y][x];
+
+		Term->scr->a[y][x] = fx_ptr->a;
+		Term->scr->c[y][x] = fx_ptr->c;
+
+		Term_fx_touch(x, y);
+	}
+}
+
+
+/*
+ * Take the cosmetic glyphs out of the requested image after a refresh,
+ * and forget those which have been shown for long enough
+ *
+ * Each grid is looked at again by the next refresh, which shows the
+ * glyph again if it is still alive (costing nothing) or puts back what
+ * the grid holds.
+ */
+static void Term_fx_hide(void)
+{
+	int i;
+
+	for (i = Term->fx_num - 1; i >= 0; i--)
+	{
+		term_fx *fx_ptr = &Term->fx[i];
+
+		int x = fx_ptr->x;
+		int y = fx_ptr->y;
+
+		Term->scr->a[y][x] = fx_ptr->hold_a;
+		Term->scr->c[y][x] = fx_ptr->hold_c;
+
+		Term_fx_touch(x, y);
+
+		/* Forget it */
+		if (!--fx_ptr->life)
+		{
+			Term->fx[i] = Term->fx[--Term->fx_num];
+		}
+	}
+}
+
+
+/*
+ * Forget every cosmetic glyph (when the screen is cleared or saved)
+ */
+static void Term_fx_wipe(void)
+{
+	int i;
+
+	for (i = 0; i < Term->fx_num; i++)
+	{
+		Term_fx_touch(Term->fx[i].x, Term->fx[i].y);
+	}
+
+	Term->fx_num = 0;
+}
+
+
+
 /*** Refresh routines ***/
 
 
@@ -802,6 +1046,9 @@ static void Term_fresh_row_text(int y)
 	/* Pending attr */
 	byte fa = Term->attr_blank;
 
+	/* Unchanged grids (in the pending attr) after the pending chars */
+	int fg = 0;
+
 	byte oa;
 	char oc;
 
@@ -823,6 +1070,16 @@ static void Term_fresh_row_text(int y)
 		/* Handle unchanged grids */
 		if ((na == oa) && (nc == oc))
 		{
+			/* Hack -- Bridge short gaps (see "TERM_FRESH_GAP") */
+			if (fn && (na == fa) && (fg < TERM_FRESH_GAP))
+			{
+				fg++;
+				continue;
+			}
+
+			/* Forget the gap */
+			fg = 0;
+
 			/* Flush */
 			if (fn)
 			{
@@ -851,6 +1108,14 @@ static void Term_fresh_row_text(int y)
 		old_aa[x] = na;
 		old_cc[x] = nc;
 
+		/* Redraw the bridged gap along with the pending chars */
+		if (fg)
+		{
+			if (na == fa)
+				fn += fg;
+			fg = 0;
+		}
+
 		/* Notice new color */
 		if (fa != na)
 		{
@@ -1032,6 +1297,11 @@ errr Term_fresh(void)
 		return (1);
 
 
+	/* Show the cosmetic glyphs */
+	if (Term->fx_num)
+		Term_fx_show();
+
+
 	/* Trivial Refresh */
 	if ((Term->y1 > Term->y2) && (scr->cu == old->cu) &&
 		(scr->cv == old->cv) && (scr->cx == old->cx) &&
@@ -1211,6 +1481,11 @@ errr Term_fresh(void)
 	}
 
 
+	/* Put back what the grids under the cosmetic glyphs hold */
+	if (Term->fx_num)
+		Term_fx_hide();
+
+
 	/* Cursor update -- Show new Cursor */
 	if (Term->soft_cursor)
 	{
@@ -1583,6 +1858,9 @@ errr Term_clear(void)
 	byte a = Term->attr_blank;
 	char c = Term->char_blank;
 
+	/* Forget the cosmetic glyphs */
+	Term_fx_wipe();
+
 	/* Cursor usable */
 	Term->scr->cu = 0;
 
@@ -1913,6 +2191,9 @@ errr Term_save(void)
 	int w = Term->wid;
 	int h = Term->hgt;
 
+	/* Forget the cosmetic glyphs */
+	Term_fx_wipe();
+
 	/* Create */
 	if (!Term->mem)
 	{
@@ -2046,6 +2327,10 @@ errr Term_resize(int w, int h)
 		return (1);
 
 
+	/* Forget the cosmetic glyphs (the whole window is redrawn) */
+	Term->fx_num = 0;
+
+
 	/* Minimum dimensions */
 	wid = MIN(Term->wid, w);
 	hgt = MIN(Term->hgt, h);
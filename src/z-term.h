@@ -54,6 +54,32 @@ struct term_win
 
 
 
+/*
+ * Most cosmetic glyphs a term shows at once (see "Term_fx()")
+ */
+#define TERM_FX_MAX	128
+
+
+/*
+ * A cosmetic glyph shown over one grid (see "Term_fx()")
+ */
+typedef struct term_fx term_fx;
+
+struct term_fx
+{
+	byte x, y;	/* The grid */
+
+	byte a;		/* What to show there */
+	term_char c;
+
+	byte life;	/* Refreshes left to show it for */
+
+	byte hold_a;	/* What the grid really holds, while shown */
+	term_char hold_c;
+};
+
+
+
 /*
  * An actual "term" structure
  *
@@ -123,6 +149,9 @@ struct term_win
  *	- Temporary screen image
  *	- Memorized screen image
  *
+ *	- Cosmetic glyphs, shown over the requested image
+ *	- Number of cosmetic glyphs
+ *
  *
  *	- Hook for init-ing the term
  *	- Hook for nuke-ing the term
@@ -184,6 +213,9 @@ struct term
 	term_win *tmp;
 	term_win *mem;
 
+	term_fx fx[TERM_FX_MAX];
+	int fx_num;
+
 	void (*init_hook) (term * t);
 	void (*nuke_hook) (term * t);
 
@@ -242,6 +274,16 @@ struct term
 #define TERM_XTRA_DELAY 13 /* Delay some milliseconds (optional) */
 
 
+/*
+ * Definitions for "Term_fresh_row_text()"
+ *
+ * A run of unchanged grids this short, in the attr of the changed grids
+ * on either side, is redrawn along with them, so that they go out in a
+ * single "Term_text()" call instead of two calls and a cursor move.
+ */
+#define TERM_FRESH_GAP	4
+
+
 /**** Available Variables ****/
 
 extern term *Term;
@@ -254,6 +296,8 @@ extern errr Term_xtra(int n, int v);
 
 extern void Term_queue_char(int x, int y, byte a, term_char c);
 extern void Term_queue_chars(int x, int y, int n, byte a, cptr s);
+extern errr Term_fx(int x, int y, byte a, term_char c, int life);
+extern errr Term_scroll(int x, int y, int w, int h, int dx, int dy);
 
 extern errr Term_fresh(void);
 extern errr Term_set_cursor(int v);
@@ -27,6 +27,65 @@ static long virt_size = 0;
 #endif
 
 
+#ifdef VIRT_TRACK
+
+/*
+ * Room kept in front of each block for its tag and length (enough to
+ * keep the block itself aligned)
+ */
+#define VIRT_HEAD	16
+
+/*
+ * The counts for each tag, and for all of them
+ */
+virt_count virt_counts[VIRT_TAGS];
+virt_count virt_total;
+
+/*
+ * The current tag
+ */
+static int virt_tag = 0;
+
+
+/*
+ * Set the current tag, returning the old one
+ */
+int virt_tag_set(int tag)
+{
+	int old = virt_tag;
+
+	/* Paranoia */
+	if ((tag < 0) || (tag >= VIRT_TAGS)) tag = 0;
+
+	virt_tag = tag;
+
+	return (old);
+}
+
+
+/*
+ * Count a block of "len" bytes made (or, with "n" of -1, freed)
+ */
+static void virt_count_block(virt_count *vc, huge len, int n)
+{
+	if (n > 0)
+	{
+		vc->bytes += len;
+		vc->live++;
+		vc->made++;
+
+		if (vc->bytes > vc->peak) vc->peak = vc->bytes;
+	}
+	else
+	{
+		vc->bytes -= len;
+		vc->live--;
+	}
+}
+
+#endif /* VIRT_TRACK */
+
+
 /*
  * Optional auxiliary "rnfree" function
  */
@@ -41,6 +100,23 @@ vptr rnfree(vptr p, huge len)
 	if (len == 0)
 		return (NULL);
 
+#ifdef VIRT_TRACK
+
+	/* Nothing was allocated */
+	if (!p)
+		return (NULL);
+
+	/* Find the real block, and count it */
+	p = (vptr)((char *)p - VIRT_HEAD);
+	len = ((huge *)p)[0];
+
+	virt_count_block(&virt_counts[((huge *)p)[1]], len, -1);
+	virt_count_block(&virt_total, len, -1);
+
+	len += VIRT_HEAD;
+
+#endif
+
 #ifdef VERBOSE_RALLOC
 
 	/* Decrease memory count */
@@ -125,6 +201,13 @@ vptr ralloc(huge len)
 		plog(buf);
 	}
 
+#endif
+
+#ifdef VIRT_TRACK
+
+	/* Make room for the tag */
+	len += VIRT_HEAD;
+
 #endif
 
 	/* Use the aux function if set */
@@ -139,6 +222,24 @@ vptr ralloc(huge len)
 	if (!mem)
 		mem = rpanic(len);
 
+#ifdef VIRT_TRACK
+
+	/* Note the length and tag, and count the block */
+	if (mem)
+	{
+		len -= VIRT_HEAD;
+
+		((huge *)mem)[0] = len;
+		((huge *)mem)[1] = (huge)virt_tag;
+
+		virt_count_block(&virt_counts[virt_tag], len, 1);
+		virt_count_block(&virt_total, len, 1);
+
+		mem = (vptr)((char *)mem + VIRT_HEAD);
+	}
+
+#endif
+
 	/* Return the memory, if any */
 	return (mem);
 }
@@ -194,3 +295,98 @@ errr string_free(cptr str)
 	/* Success */
 	return (0);
 }
+
+
+
+/*
+ * Take "len" wiped bytes from the arena "a"
+ */
+vptr virt_arena_alloc(virt_arena *a, huge len)
+{
+	virt_chunk *c = a->chunk;
+	char *mem;
+
+	/* Keep everything aligned */
+	len = (len + 15) & ~((huge)15);
+
+	/* Make a new chunk */
+	if (!c || (c->used + len > c->size))
+	{
+		huge size = (len > VIRT_ARENA_CHUNK) ? len : VIRT_ARENA_CHUNK;
+
+#ifdef VIRT_TRACK
+		int tag = virt_tag_set(a->tag);
+#endif
+
+		c = (virt_chunk *)ralloc(sizeof(virt_chunk) + size);
+
+#ifdef VIRT_TRACK
+		(void)virt_tag_set(tag);
+#endif
+
+		c->next = a->chunk;
+		c->size = size;
+		c->used = 0;
+		a->chunk = c;
+	}
+
+	mem = (char *)(c + 1) + c->used;
+	c->used += len;
+
+	return ((vptr)memset(mem, 0, (size_t)len));
+}
+
+
+/*
+ * Note how much of the arena "a" is in use
+ */
+virt_mark virt_arena_mark(virt_arena *a)
+{
+	virt_mark m;
+
+	m.chunk = a->chunk;
+	m.used = (a->chunk ? a->chunk->used : 0);
+
+	return (m);
+}
+
+
+/*
+ * Give back everything taken from the arena "a" since "m"
+ *
+ * Chunks made since are freed, except that the oldest chunk of all is
+ * kept (emptied), so that an arena used over and over makes none.
+ */
+void virt_arena_release(virt_arena *a, virt_mark m)
+{
+	while (a->chunk && (a->chunk != m.chunk))
+	{
+		virt_chunk *c = a->chunk;
+
+		/* Keep the last one */
+		if (!m.chunk && !c->next)
+		{
+			c->used = 0;
+			return;
+		}
+
+		a->chunk = c->next;
+		rnfree(c, sizeof(virt_chunk) + c->size);
+	}
+
+	if (a->chunk) a->chunk->used = m.used;
+}
+
+
+/*
+ * Give back everything taken from the arena "a"
+ */
+void virt_arena_reset(virt_arena *a)
+{
+	virt_mark m;
+
+	m.chunk = NULL;
+	m.used = 0;
+
+	virt_arena_release(a, m);
+}
@@ -39,9 +39,39 @@
  *
  * Note that it is assumed that "memset()" will function correctly,
  * in particular, that it returns its first argument.
+ *
+ * With VIRT_TRACK defined, every block remembers the "tag" which was
+ * current when it was allocated (see "VIRT_TAG()"), and the bytes and
+ * blocks live under each tag, and the most bytes ever live under it,
+ * are kept in "virt_counts[]" (and for all tags, in "virt_total").
+ * Without it, the tags cost nothing.
+ *
+ * An "arena" hands out memory for things which all go away together
+ * (the scratch space of the level generator, say).  Taking memory from
+ * it is a pointer bump; "virt_arena_mark()" notes how much is in use,
+ * and "virt_arena_release()" gives back everything taken since, at once.
+ * The memory itself comes from "ralloc()" in chunks of VIRT_ARENA_CHUNK
+ * bytes (or more, for a bigger request), and the oldest chunk is kept
+ * for the next use.
  */
 
 
+/*
+ * OPTION: Keep count of the memory allocated under each tag
+ */
+#define VIRT_TRACK
+
+/*
+ * Number of tags (tag zero is for everything not tagged)
+ */
+#define VIRT_TAGS	16
+
+/*
+ * Bytes in a chunk of an arena
+ */
+#define VIRT_ARENA_CHUNK	262144L
+
+
 
 /**** Available macros ****/
 
@@ -137,8 +167,89 @@
 
 
 
+/* Take a wiped thing of type T from arena A, assign to pointer P */
+#define ARENA_MAKE(A,P,T) \
+	((P)=(T*)(virt_arena_alloc(A,SIZE(T))))
+
+/* Take a wiped array of type T[N] from arena A, assign to pointer P */
+#define C_ARENA_MAKE(A,P,N,T) \
+	((P)=(T*)(virt_arena_alloc(A,C_SIZE(N,T))))
+
+/* Make "T" the current tag, and return the old one */
+#ifdef VIRT_TRACK
+#define VIRT_TAG(T) \
+	(virt_tag_set(T))
+#else
+#define VIRT_TAG(T) \
+	((void)(T), 0)
+#endif
+
+
+
+/**** Available types ****/
+
+
+/*
+ * The memory live under one tag
+ */
+typedef struct virt_count virt_count;
+
+struct virt_count
+{
+	huge bytes;	/* Bytes live */
+	huge peak;	/* Most bytes ever live */
+	long live;	/* Blocks live */
+	long made;	/* Blocks ever allocated */
+};
+
+
+
+/*
+ * A chunk of an arena (its bytes follow it)
+ */
+typedef struct virt_chunk virt_chunk;
+
+struct virt_chunk
+{
+	virt_chunk *next;	/* The chunk made before it */
+	huge size;		/* Bytes in it */
+	huge used;		/* Bytes handed out */
+	huge pad;		/* Keep the bytes aligned */
+};
+
+/*
+ * An arena (all zero is an empty one)
+ */
+typedef struct virt_arena virt_arena;
+
+struct virt_arena
+{
+	virt_chunk *chunk;	/* The newest chunk */
+	int tag;		/* Tag for its chunks */
+};
+
+/*
+ * How much of an arena was in use (see "virt_arena_mark()")
+ */
+typedef struct virt_mark virt_mark;
+
+struct virt_mark
+{
+	virt_chunk *chunk;	/* The newest chunk then */
+	huge used;		/* Bytes handed out from it then */
+};
+
+
 /**** Available variables ****/
 
+#ifdef VIRT_TRACK
+
+/* The counts for each tag, and for all of them */
+extern virt_count virt_counts[VIRT_TAGS];
+extern virt_count virt_total;
+
+#endif
+
 /* Replacement hook for "rnfree()" */
 extern vptr(*rnfree_aux) (vptr, huge);
 
@@ -166,6 +277,25 @@ extern cptr string_make(cptr str);
 /* Free a string allocated with "string_make()" */
 extern errr string_free(cptr str);
 
+/* Take 'len' wiped bytes from an arena */
+extern vptr virt_arena_alloc(virt_arena *a, huge len);
+
+/* Note how much of an arena is in use */
+extern virt_mark virt_arena_mark(virt_arena *a);
+
+/* Give back everything taken from an arena since "m" */
+extern void virt_arena_release(virt_arena *a, virt_mark m);
+
+/* Give back everything taken from an arena */
+extern void virt_arena_reset(virt_arena *a);
+
+#ifdef VIRT_TRACK
+
+/* Set the current tag, returning the old one */
+extern int virt_tag_set(int tag);
+
+#endif
+
 
 
 